@@ -0,0 +1,1214 @@
+// tmsaio.hpp
+// Matthew Johnson
+// 10/17/2026
+// asynchronous bulk I/O for TMSArray files: io_uring through raw
+//  syscalls, thread-pool pread/pwrite fallback, optional O_DIRECT (Linux)
+
+#pragma once
+// for single inclusion
+
+#include "tmsarray.hpp"
+// For class template TMSArray
+
+#include "tmsserial.hpp"
+// For TMSFileHeader
+// For tms_make_header
+// For tms_check_header
+// For tms_bswap
+// For TMSFd
+// For tms_throw_errno
+
+#include "tmscrc32.hpp"
+// For tms_crc32c
+
+#include <cstddef>
+// For std::size_t
+
+#include <cstdint>
+// For std::uint64_t
+
+#include <cstring>
+// For std::memcpy
+// For std::memset
+
+#include <cerrno>
+// For errno
+// For EINTR
+// For EAGAIN
+// For EBUSY
+// For ENODATA
+
+#include <string>
+// For std::string
+
+#include <stdexcept>
+// For std::runtime_error
+// For std::invalid_argument
+
+#include <system_error>
+// For std::system_error
+// For std::generic_category
+
+#include <exception>
+// For std::exception_ptr
+// For std::make_exception_ptr
+// For std::current_exception
+
+#include <functional>
+// For std::function
+
+#include <memory>
+// For std::shared_ptr
+// For std::make_shared
+// For std::unique_ptr
+
+#include <atomic>
+// For std::atomic
+
+#include <algorithm>
+// For std::min
+// For std::max
+
+#include <type_traits>
+// For std::is_trivially_copyable
+
+#include <deque>
+// For std::deque
+
+#include <thread>
+// For std::thread
+
+#include <mutex>
+// For std::mutex
+// For std::unique_lock
+
+#include <chrono>
+// For std::chrono::milliseconds
+
+#include <condition_variable>
+// For std::condition_variable
+
+#include <future>
+// For std::future
+// For std::promise
+
+#include <linux/io_uring.h>
+// For struct io_uring_params
+// For struct io_uring_sqe
+// For struct io_uring_cqe
+// For IORING_OP_READ
+// For IORING_OP_WRITE
+
+#include <sys/syscall.h>
+// For __NR_io_uring_setup
+// For __NR_io_uring_enter
+
+#include <fcntl.h>
+// For open
+// For O_DIRECT
+
+#include <unistd.h>
+// For syscall
+// For close
+// For pread
+// For pwrite
+// For ftruncate
+
+#include <sys/mman.h>
+// For mmap
+// For munmap
+
+#include <sys/stat.h>
+// For fstat
+
+
+
+// Default number of chunk transfers in flight
+constexpr std::size_t TMS_AIO_DEPTH = 32;
+
+// Default largest single transfer; requests are split into chunks
+constexpr std::size_t TMS_AIO_CHUNK_BYTES = std::size_t(1) << 20;
+
+// O_DIRECT alignment of file offsets, lengths and memory
+constexpr std::size_t TMS_AIO_ALIGN = 4096;
+
+
+// TMSAioBackend
+// How TMSAsyncIo performs transfers
+enum TMSAioBackend
+{
+    TMS_AIO_AUTO,               // io_uring if the kernel allows it
+    TMS_AIO_URING,
+    TMS_AIO_THREADS             // one pread/pwrite thread per queue slot
+};
+
+
+// tms_aio_name
+// Printable name of a backend
+inline const char * tms_aio_name(TMSAioBackend backend) noexcept
+{
+    switch (backend)
+    {
+    case TMS_AIO_URING:   return "io_uring";
+    case TMS_AIO_THREADS: return "threads";
+    default:              return "auto";
+    }
+}
+
+
+
+// *********************************************************************
+// class TMSIoUring - Class definition
+// *********************************************************************
+
+
+// class TMSIoUring
+// Minimal io_uring: one submission and one completion ring, set up
+//  and driven with the raw syscalls (no liburing). Single-threaded:
+//  one thread pushes, enters and reaps.
+// Invariants:
+//     _fd is the ring; the _sq* and _cq* pointers point into its
+//      mappings; at most entries() submissions are unreaped.
+class TMSIoUring
+{
+
+public:
+
+    using size_type = std::size_t;
+
+
+// ***** TMSIoUring: ctors, dctor *****
+public:
+
+
+    // Ctor from ring size
+    // Strong Guarantee
+    // Pre:
+    //      entries > 0
+    // Post:
+    //      Ring of at least entries slots set up and mapped. Throws
+    //      std::system_error if io_uring is unavailable (ENOSYS, or EPERM
+    //      under a seccomp filter), std::runtime_error if the kernel
+    //      lacks IORING_OP_READ/WRITE (before 5.6).
+    explicit TMSIoUring(unsigned entries)
+        :_fd(-1),
+         _sqMap(MAP_FAILED), _sqMapLen(0),
+         _cqMap(MAP_FAILED), _cqMapLen(0),
+         _sqes(static_cast<io_uring_sqe *>(MAP_FAILED)), _sqesLen(0)
+    {
+        io_uring_params p;
+        std::memset(&p, 0, sizeof p);
+        _fd = int(::syscall(__NR_io_uring_setup, entries, &p));
+        if (_fd < 0)
+            tms_throw_errno("io_uring_setup");
+        try
+        {
+            // RW_CUR_POS came with the READ and WRITE opcodes
+            if (!(p.features & IORING_FEAT_RW_CUR_POS))
+                throw std::runtime_error("io_uring: kernel lacks read/write ops");
+            _entries = p.sq_entries;
+            _sqMapLen = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+            _cqMapLen = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+            const bool single = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+            if (single)
+                _sqMapLen = _cqMapLen = std::max(_sqMapLen, _cqMapLen);
+            _sqMap = ::mmap(nullptr, _sqMapLen, PROT_READ | PROT_WRITE,
+                            MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQ_RING);
+            if (_sqMap == MAP_FAILED)
+                tms_throw_errno("io_uring: mmap");
+            if (single)
+                _cqMapLen = 0;      // shares _sqMap
+            else
+            {
+                _cqMap = ::mmap(nullptr, _cqMapLen, PROT_READ | PROT_WRITE,
+                                MAP_SHARED | MAP_POPULATE, _fd,
+                                IORING_OFF_CQ_RING);
+                if (_cqMap == MAP_FAILED)
+                    tms_throw_errno("io_uring: mmap");
+            }
+            _sqesLen = p.sq_entries * sizeof(io_uring_sqe);
+            _sqes = static_cast<io_uring_sqe *>(::mmap(nullptr, _sqesLen,
+                PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd,
+                IORING_OFF_SQES));
+            if (_sqes == MAP_FAILED)
+                tms_throw_errno("io_uring: mmap");
+
+            char * sq = static_cast<char *>(_sqMap);
+            char * cq = single ? sq : static_cast<char *>(_cqMap);
+            _sqHead = reinterpret_cast<unsigned *>(sq + p.sq_off.head);
+            _sqTail = reinterpret_cast<unsigned *>(sq + p.sq_off.tail);
+            _sqMask = *reinterpret_cast<unsigned *>(sq + p.sq_off.ring_mask);
+            _sqArray = reinterpret_cast<unsigned *>(sq + p.sq_off.array);
+            _cqHead = reinterpret_cast<unsigned *>(cq + p.cq_off.head);
+            _cqTail = reinterpret_cast<unsigned *>(cq + p.cq_off.tail);
+            _cqMask = *reinterpret_cast<unsigned *>(cq + p.cq_off.ring_mask);
+            _cqes = reinterpret_cast<io_uring_cqe *>(cq + p.cq_off.cqes);
+        }
+        catch (...)
+        {
+            release();
+            throw;
+        }
+    }
+
+
+    // No copying: owns the ring
+    TMSIoUring(const TMSIoUring &) = delete;
+    TMSIoUring & operator=(const TMSIoUring &) = delete;
+
+
+    // Dctor
+    // No-Throw Guarantee
+    ~TMSIoUring()
+    {
+        release();
+    }
+
+
+// ***** TMSIoUring: general public functions *****
+public:
+
+
+    // entries
+    // No-Throw Guarantee
+    // Submission ring size
+    size_type entries() const noexcept
+    {
+        return _entries;
+    }
+
+
+    // push
+    // No-Throw Guarantee
+    // Pre:
+    //      Fewer than entries() submissions unreaped
+    // Post:
+    //      A read (write false) or write of n bytes at buf, file offset
+    //      off, queued for the next enter(); user comes back with its
+    //      completion
+    void push(bool write, int fd, void * buf, unsigned n, std::uint64_t off,
+              std::uint64_t user) noexcept
+    {
+        const unsigned tail = *_sqTail;
+        const unsigned idx = tail & _sqMask;
+        io_uring_sqe & sqe = _sqes[idx];
+        std::memset(&sqe, 0, sizeof sqe);
+        sqe.opcode = write ? IORING_OP_WRITE : IORING_OP_READ;
+        sqe.fd = fd;
+        sqe.addr = std::uint64_t(reinterpret_cast<std::uintptr_t>(buf));
+        sqe.len = n;
+        sqe.off = off;
+        sqe.user_data = user;
+        _sqArray[idx] = idx;
+        __atomic_store_n(_sqTail, tail + 1, __ATOMIC_RELEASE);
+    }
+
+
+    // enter
+    // No-Throw Guarantee
+    // Submits up to submit queued entries and, with wait, blocks for at
+    //  least one completion. Returns the number submitted, or -errno
+    //  (EINTR, EAGAIN and EBUSY are transient).
+    long enter(unsigned submit, bool wait) noexcept
+    {
+        const long r = ::syscall(__NR_io_uring_enter, _fd, submit,
+                                 wait ? 1u : 0u,
+                                 wait ? IORING_ENTER_GETEVENTS : 0u,
+                                 nullptr, 0);
+        return r < 0 ? -long(errno) : r;
+    }
+
+
+    // unpush
+    // Takes back every entry pushed but not yet consumed by the kernel,
+    //  calling f(user) for each
+    template <typename Func>
+    void unpush(Func && f)
+    {
+        const unsigned head = __atomic_load_n(_sqHead, __ATOMIC_ACQUIRE);
+        const unsigned tail = *_sqTail;
+        for (unsigned t = head; t != tail; ++t)
+            f(std::uint64_t(_sqes[_sqArray[t & _sqMask]].user_data));
+        __atomic_store_n(_sqTail, head, __ATOMIC_RELEASE);
+    }
+
+
+    // reap
+    // Calls f(user, res) for every completion posted, in order; res is
+    //  the byte count or -errno
+    template <typename Func>
+    size_type reap(Func && f)
+    {
+        unsigned head = *_cqHead;
+        const unsigned tail = __atomic_load_n(_cqTail, __ATOMIC_ACQUIRE);
+        size_type count = 0;
+        for (; head != tail; ++head, ++count)
+        {
+            const io_uring_cqe & cqe = _cqes[head & _cqMask];
+            f(std::uint64_t(cqe.user_data), int(cqe.res));
+        }
+        __atomic_store_n(_cqHead, head, __ATOMIC_RELEASE);
+        return count;
+    }
+
+
+// ***** TMSIoUring: private helper functions *****
+private:
+
+
+    void release() noexcept
+    {
+        if (_sqes != MAP_FAILED)
+            ::munmap(_sqes, _sqesLen);
+        if (_cqMap != MAP_FAILED)
+            ::munmap(_cqMap, _cqMapLen);
+        if (_sqMap != MAP_FAILED)
+            ::munmap(_sqMap, _sqMapLen);
+        if (_fd >= 0)
+            ::close(_fd);
+    }
+
+
+// ***** TMSIoUring: data members *****
+private:
+
+    int             _fd;
+    unsigned        _entries = 0;
+    void *          _sqMap;
+    size_type       _sqMapLen;
+    void *          _cqMap;         // MAP_FAILED when sharing _sqMap
+    size_type       _cqMapLen;
+    io_uring_sqe *  _sqes;
+    size_type       _sqesLen;
+    unsigned *      _sqHead = nullptr;
+    unsigned *      _sqTail = nullptr;
+    unsigned        _sqMask = 0;
+    unsigned *      _sqArray = nullptr;
+    unsigned *      _cqHead = nullptr;
+    unsigned *      _cqTail = nullptr;
+    unsigned        _cqMask = 0;
+    io_uring_cqe *  _cqes = nullptr;
+
+}; // end of class
+
+
+
+// *********************************************************************
+// class TMSAsyncIo - Class definition
+// *********************************************************************
+
+
+// class TMSAsyncIo
+// Asynchronous pread/pwrite engine. A request is split into chunks of
+//  at most chunk_bytes(); up to depth() chunks are in flight at once,
+//  across all requests. With io_uring one thread submits and reaps for
+//  the whole queue; the fallback runs depth() threads doing blocking
+//  pread/pwrite. Either way completion is reported once per request:
+//  by a callback, called on an I/O thread with 0 or an errno (ENODATA
+//  for end of file), or by a future, which rethrows std::system_error.
+//  Should io_uring_enter itself fail (other than EINTR, EAGAIN or
+//  EBUSY), the ring is abandoned: requests not yet submitted fail with
+//  that errno, those in flight fail with it once the kernel finishes
+//  them, and every later request fails the same way.
+//
+// Direct requests are for descriptors opened with O_DIRECT. They go
+//  through depth() page-aligned bounce buffers, so the caller's memory
+//  needs no alignment; reads may start and end anywhere, writes must
+//  start at a multiple of TMS_AIO_ALIGN and have a last partial block
+//  zero-padded (truncate the file afterwards).
+// Invariants:
+//     _outstanding requests are unfinished; their unstarted chunks are
+//      in _pending. _backend is TMS_AIO_URING iff _ring is set.
+class TMSAsyncIo
+{
+
+public:
+
+    using size_type = std::size_t;
+
+    using Callback  = std::function<void(int)>;
+
+
+// ***** TMSAsyncIo: ctors, dctor *****
+public:
+
+
+    // Ctor
+    // Strong Guarantee
+    // Pre:
+    //      depth > 0; chunkBytes > 0
+    // Post:
+    //      Engine running. chunkBytes is rounded up to a multiple of
+    //      TMS_AIO_ALIGN. TMS_AIO_AUTO uses io_uring when it can be set
+    //      up and threads otherwise; TMS_AIO_URING throws
+    //      std::system_error or std::runtime_error when it cannot.
+    explicit TMSAsyncIo(size_type depth = TMS_AIO_DEPTH,
+                        size_type chunkBytes = TMS_AIO_CHUNK_BYTES,
+                        TMSAioBackend backend = TMS_AIO_AUTO)
+        :_depth(depth),
+         _chunk((chunkBytes + TMS_AIO_ALIGN - 1) / TMS_AIO_ALIGN * TMS_AIO_ALIGN),
+         _backend(TMS_AIO_THREADS),
+         _bounce(nullptr),
+         _stop(false),
+         _outstanding(0)
+    {
+        if (_depth == 0 || _chunk == 0)
+            throw std::invalid_argument("TMSAsyncIo: depth and chunk must be > 0");
+        if (backend != TMS_AIO_THREADS)
+        {
+            try
+            {
+                _ring.reset(new TMSIoUring(unsigned(_depth)));
+                _backend = TMS_AIO_URING;
+            }
+            catch (...)
+            {
+                if (backend == TMS_AIO_URING)
+                    throw;
+            }
+        }
+        try
+        {
+            if (_ring)
+                _threads.emplace_back([this]{ ringLoop(); });
+            else
+                for (size_type t = 0; t < _depth; ++t)
+                    _threads.emplace_back([this, t]{ workerLoop(t); });
+        }
+        catch (...)
+        {
+            shutdown();
+            throw;
+        }
+    }
+
+
+    // No copying: owns threads and a ring
+    TMSAsyncIo(const TMSAsyncIo &) = delete;
+    TMSAsyncIo & operator=(const TMSAsyncIo &) = delete;
+
+
+    // Dctor
+    // No-Throw Guarantee
+    // Pre: None
+    // Post:
+    //      Every request finished and its callback run; threads joined
+    ~TMSAsyncIo()
+    {
+        wait();
+        shutdown();
+    }
+
+
+// ***** TMSAsyncIo: general public functions *****
+public:
+
+
+    // backend
+    // No-Throw Guarantee
+    // TMS_AIO_URING or TMS_AIO_THREADS
+    TMSAioBackend backend() const noexcept
+    {
+        return _backend;
+    }
+
+
+    // depth
+    // No-Throw Guarantee
+    size_type depth() const noexcept
+    {
+        return _depth;
+    }
+
+
+    // chunk_bytes
+    // No-Throw Guarantee
+    size_type chunk_bytes() const noexcept
+    {
+        return _chunk;
+    }
+
+
+    // read (callback)
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      [buf, buf + n) stays valid, and untouched, until done runs; fd
+    //      stays open; done does not throw or call wait()
+    // Post:
+    //      Read of n bytes at file offset off queued; done(0) or
+    //      done(errno) runs on an I/O thread when every chunk has
+    //      finished (at once, on this thread, when n == 0)
+    void read(int fd, void * buf, size_type n, std::uint64_t off,
+              Callback done, bool direct = false)
+    {
+        submit(false, fd, static_cast<char *>(buf), n, off,
+               std::move(done), direct);
+    }
+
+
+    // write (callback)
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      As for read; for direct writes off % TMS_AIO_ALIGN == 0
+    // Post:
+    //      Write of n bytes queued, reported like read. Throws
+    //      std::invalid_argument for a misaligned direct write.
+    void write(int fd, const void * buf, size_type n, std::uint64_t off,
+               Callback done, bool direct = false)
+    {
+        if (direct && off % TMS_AIO_ALIGN != 0)
+            throw std::invalid_argument(
+                "TMSAsyncIo: direct write offset must be aligned");
+        submit(true, fd, const_cast<char *>(static_cast<const char *>(buf)),
+               n, off, std::move(done), direct);
+    }
+
+
+    // read (future)
+    // As read with a callback; the future rethrows std::system_error
+    std::future<void> read(int fd, void * buf, size_type n,
+                           std::uint64_t off, bool direct = false)
+    {
+        std::shared_ptr<std::promise<void>> p =
+            std::make_shared<std::promise<void>>();
+        std::future<void> result = p->get_future();
+        read(fd, buf, n, off, promiseCallback(p, "TMSAsyncIo: read"), direct);
+        return result;
+    }
+
+
+    // write (future)
+    // As write with a callback; the future rethrows std::system_error
+    std::future<void> write(int fd, const void * buf, size_type n,
+                            std::uint64_t off, bool direct = false)
+    {
+        std::shared_ptr<std::promise<void>> p =
+            std::make_shared<std::promise<void>>();
+        std::future<void> result = p->get_future();
+        write(fd, buf, n, off, promiseCallback(p, "TMSAsyncIo: write"),
+              direct);
+        return result;
+    }
+
+
+    // wait
+    // No-Throw Guarantee
+    // Pre:
+    //      Not called from a callback
+    // Post:
+    //      Every request submitted before the call has finished
+    void wait() noexcept
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _idle.wait(lock, [this]{ return _outstanding == 0; });
+    }
+
+
+// ***** TMSAsyncIo: private types *****
+private:
+
+
+    // One request: the caller's transfer and how many chunks remain
+    struct Request
+    {
+        Callback                done;
+        std::atomic<size_type>  left;
+        std::atomic<int>        err;
+    };
+
+
+    // One chunk of a request. A direct chunk moves the aligned window
+    //  [off, off + len) through a bounce buffer; the caller's bytes are
+    //  [skip, skip + want) of it. Otherwise len == want, skip == 0.
+    struct Chunk
+    {
+        Request *      req;
+        int            fd;
+        bool           write;
+        bool           direct;
+        char *         user;
+        std::uint64_t  off;
+        size_type      len;
+        size_type      skip;
+        size_type      want;
+        size_type      done;        // bytes transferred so far
+        size_type      slot;        // bounce buffer, direct only
+    };
+
+
+// ***** TMSAsyncIo: private helper functions *****
+private:
+
+
+    // promiseCallback
+    // Callback that fulfils p
+    static Callback promiseCallback(std::shared_ptr<std::promise<void>> p,
+                                    const char * what)
+    {
+        return [p, what](int err)
+        {
+            if (err == 0)
+                p->set_value();
+            else
+                p->set_exception(std::make_exception_ptr(
+                    std::system_error(err, std::generic_category(), what)));
+        };
+    }
+
+
+    // submit
+    // Splits a request into chunks and queues them
+    void submit(bool write, int fd, char * buf, size_type n,
+                std::uint64_t off, Callback done, bool direct)
+    {
+        if (n == 0)
+        {
+            done(0);
+            return;
+        }
+        if (direct)
+            allocateBounce();
+
+        std::unique_ptr<Request> req(new Request);
+        req->done = std::move(done);
+        req->err = 0;
+        std::deque<Chunk *> chunks;
+        try
+        {
+            for (std::uint64_t pos = off, end = off + n; pos < end; )
+            {
+                Chunk * c = new Chunk();
+                chunks.push_back(c);
+                c->req = req.get();
+                c->fd = fd;
+                c->write = write;
+                c->direct = direct;
+                c->user = buf + (pos - off);
+                if (direct)
+                {
+                    // Stay inside one chunk-aligned block of the file, so
+                    //  the aligned window fits a bounce buffer
+                    const std::uint64_t last = std::min(end,
+                        pos / _chunk * _chunk + _chunk);
+                    c->off = pos / TMS_AIO_ALIGN * TMS_AIO_ALIGN;
+                    c->skip = size_type(pos - c->off);
+                    c->want = size_type(last - pos);
+                    c->len = (c->skip + c->want + TMS_AIO_ALIGN - 1)
+                             / TMS_AIO_ALIGN * TMS_AIO_ALIGN;
+                }
+                else
+                {
+                    c->off = pos;
+                    c->skip = 0;
+                    c->want = c->len = size_type(std::min(
+                        std::uint64_t(_chunk), end - pos));
+                }
+                pos += c->want;
+            }
+            req->left = chunks.size();
+            std::unique_lock<std::mutex> lock(_mutex);
+            _pending.insert(_pending.end(), chunks.begin(), chunks.end());
+            ++_outstanding;
+        }
+        catch (...)
+        {
+            for (Chunk * c : chunks)
+                delete c;
+            throw;
+        }
+        req.release();
+        _work.notify_all();
+    }
+
+
+    // allocateBounce
+    // Maps the direct-I/O bounce buffers on first use
+    void allocateBounce()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        if (_bounce != nullptr)
+            return;
+        void * p = ::mmap(nullptr, _depth * _chunk, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED)
+            tms_throw_errno("TMSAsyncIo: bounce buffers");
+        _bounce = static_cast<char *>(p);
+    }
+
+
+    // buffer
+    // Memory a chunk's next transfer uses
+    char * buffer(Chunk & c) const noexcept
+    {
+        return (c.direct ? _bounce + c.slot * _chunk : c.user) + c.done;
+    }
+
+
+    // start
+    // Prepares a chunk for its first transfer: a direct write is copied
+    //  into its bounce buffer and padded with zeros
+    void start(Chunk & c) const noexcept
+    {
+        c.done = 0;
+        if (c.direct && c.write)
+        {
+            char * b = _bounce + c.slot * _chunk;
+            std::memcpy(b, c.user, c.want);
+            std::memset(b + c.want, 0, c.len - c.want);
+        }
+    }
+
+
+    // progress
+    // Accounts for one transfer result (bytes or -errno). Returns true
+    //  when the chunk has finished, recording any error in its request.
+    bool progress(Chunk & c, long res) noexcept
+    {
+        if (res == -EINTR || res == -EAGAIN)
+            return false;
+        int err = 0;
+        if (res < 0)
+            err = int(-res);
+        else if (res == 0)
+            err = ENODATA;
+        else
+        {
+            c.done += size_type(res);
+            // A direct read past end of file is short, but complete once
+            //  the caller's bytes are in
+            if (c.done < c.len && !(c.direct && !c.write
+                                    && c.done >= c.skip + c.want))
+                return false;
+            if (c.direct && !c.write)
+                std::memcpy(c.user, _bounce + c.slot * _chunk + c.skip, c.want);
+        }
+        if (err != 0)
+        {
+            int none = 0;
+            c.req->err.compare_exchange_strong(none, err);
+        }
+        return true;
+    }
+
+
+    // abandon
+    // Records err in a chunk's request, which then counts as finished
+    void abandon(Chunk & c, int err) noexcept
+    {
+        int none = 0;
+        c.req->err.compare_exchange_strong(none, err);
+    }
+
+
+    // finish
+    // Frees a finished chunk; the last one of a request calls back
+    void finish(Chunk * c) noexcept
+    {
+        Request * req = c->req;
+        delete c;
+        if (--req->left != 0)
+            return;
+        req->done(req->err.load());
+        delete req;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            --_outstanding;
+        }
+        _idle.notify_all();
+    }
+
+
+    // ringLoop
+    // io_uring thread: keeps up to depth chunks submitted and reaps
+    //  their completions. After a non-transient enter failure (broken)
+    //  nothing more is submitted: unconsumed entries are taken back and
+    //  failed, in-flight chunks are failed as they complete, and new
+    //  chunks are failed as they arrive.
+    void ringLoop() noexcept
+    {
+        TMSArray<size_type> freeSlots(_depth);
+        for (size_type s = 0; s < _depth; ++s)
+            freeSlots[s] = _depth - 1 - s;
+        size_type inflight = 0;
+        unsigned queued = 0;          // pushed, not yet entered
+        int broken = 0;               // errno of the failed enter
+        auto done = [&](Chunk * c)
+        {
+            --inflight;
+            if (c->direct)
+                freeSlots.push_back(c->slot);
+            finish(c);
+        };
+        for (;;)
+        {
+            TMSArray<Chunk *> fresh;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                if (inflight == 0 && queued == 0)
+                    _work.wait(lock, [this]{ return _stop || !_pending.empty(); });
+                if (inflight == 0 && queued == 0 && _pending.empty())
+                    return;
+                while (!_pending.empty() && inflight + fresh.size() < _depth)
+                {
+                    fresh.push_back(_pending.front());
+                    _pending.pop_front();
+                }
+            }
+            for (Chunk * c : fresh)
+            {
+                if (broken != 0)
+                {
+                    abandon(*c, broken);
+                    finish(c);
+                    continue;
+                }
+                if (c->direct)
+                {
+                    c->slot = freeSlots[freeSlots.size() - 1];
+                    freeSlots.resize(freeSlots.size() - 1);
+                }
+                start(*c);
+                pushChunk(*c);
+                ++queued;
+                ++inflight;
+            }
+            if (inflight == 0)
+                continue;
+
+            const long r = _ring->enter(broken != 0 ? 0 : queued, true);
+            if (r >= 0)
+                queued -= unsigned(r);
+            else if (r != -EINTR && r != -EAGAIN && r != -EBUSY)
+            {
+                if (broken == 0)
+                {
+                    broken = int(-r);
+                    _ring->unpush([&](std::uint64_t user)
+                    {
+                        Chunk * c = reinterpret_cast<Chunk *>(std::uintptr_t(user));
+                        abandon(*c, broken);
+                        done(c);
+                    });
+                    queued = 0;
+                }
+                // Cannot wait in the kernel: poll for the completions of
+                //  what it already took
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            _ring->reap([&](std::uint64_t user, int res)
+            {
+                Chunk * c = reinterpret_cast<Chunk *>(std::uintptr_t(user));
+                if (!progress(*c, res))
+                {
+                    if (broken != 0)
+                        abandon(*c, broken);
+                    else
+                    {
+                        pushChunk(*c);  // short transfer: the rest
+                        ++queued;
+                        return;
+                    }
+                }
+                done(c);
+            });
+        }
+    }
+
+
+    // pushChunk
+    // Queues a chunk's next transfer on the ring
+    void pushChunk(Chunk & c) noexcept
+    {
+        _ring->push(c.write, c.fd, buffer(c), unsigned(c.len - c.done),
+                    c.off + c.done, std::uint64_t(reinterpret_cast<std::uintptr_t>(&c)));
+    }
+
+
+    // workerLoop
+    // Fallback thread: blocking transfers, one chunk at a time; slot is
+    //  this thread's bounce buffer
+    void workerLoop(size_type slot) noexcept
+    {
+        for (;;)
+        {
+            Chunk * c;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _work.wait(lock, [this]{ return _stop || !_pending.empty(); });
+                if (_pending.empty())
+                    return;
+                c = _pending.front();
+                _pending.pop_front();
+            }
+            c->slot = slot;
+            start(*c);
+            for (;;)
+            {
+                const ssize_t got = c->write
+                    ? ::pwrite(c->fd, buffer(*c), c->len - c->done,
+                               off_t(c->off + c->done))
+                    : ::pread(c->fd, buffer(*c), c->len - c->done,
+                              off_t(c->off + c->done));
+                if (progress(*c, got < 0 ? -long(errno) : long(got)))
+                    break;
+            }
+            finish(c);
+        }
+    }
+
+
+    // shutdown
+    // Stops and joins the threads, unmaps the bounce buffers
+    void shutdown() noexcept
+    {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _work.notify_all();
+        for (std::thread & t : _threads)
+            t.join();
+        _threads.clear();
+        if (_bounce != nullptr)
+            ::munmap(_bounce, _depth * _chunk);
+        _bounce = nullptr;
+    }
+
+
+// ***** TMSAsyncIo: data members *****
+private:
+
+    size_type                     _depth;
+    size_type                     _chunk;
+    TMSAioBackend                 _backend;
+    std::unique_ptr<TMSIoUring>   _ring;
+    char *                        _bounce;        // _depth * _chunk bytes
+    std::mutex                    _mutex;
+    std::condition_variable       _work;          // _pending or _stop
+    std::condition_variable       _idle;          // _outstanding == 0
+    std::deque<Chunk *>           _pending;
+    bool                          _stop;
+    size_type                     _outstanding;
+    std::deque<std::thread>       _threads;
+
+}; // end of class
+
+
+
+// *********************************************************************
+// Asynchronous load and save
+// *********************************************************************
+
+
+// TMSAsyncLoad
+// Shared state of one tms_async_load
+template <typename T>
+struct TMSAsyncLoad
+{
+    TMSFd               file;
+    std::string         path;
+    std::uint64_t       fileSize;
+    TMSArray<T> *       out;
+    bool                verify;
+    bool                direct;
+    TMSFileHeader       header;
+    std::promise<void>  done;
+
+    TMSAsyncLoad(int fd, const std::string & p)
+        :file(fd), path(p)
+    {}
+};
+
+
+// tms_async_load
+// Basic Guarantee
+// Exception-Neutral
+// Pre:
+//      T trivially copyable; out is not used until the future is ready
+// Post:
+//      Opens path at once (throwing std::system_error if it cannot) and
+//      returns a future. The header, then the data straight into out,
+//      are read through io without blocking the caller; when the data
+//      is in, it is checked with verify and converted if the file has
+//      the other byte order, on the I/O thread. The future rethrows
+//      std::system_error on I/O errors and std::runtime_error if the
+//      file is not a matching TMSArray file or is corrupt; out is then
+//      unspecified. With direct the file is read with O_DIRECT.
+template <typename T>
+std::future<void> tms_async_load(TMSAsyncIo & io, const std::string & path,
+                                 TMSArray<T> & out, bool verify = true,
+                                 bool direct = false)
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "tms_async_load reads raw bytes");
+    const int fd = ::open(path.c_str(),
+                          O_RDONLY | O_CLOEXEC | (direct ? O_DIRECT : 0));
+    if (fd < 0)
+        tms_throw_errno(path + ": open");
+    std::shared_ptr<TMSAsyncLoad<T>> st;
+    try
+    {
+        st = std::make_shared<TMSAsyncLoad<T>>(fd, path);
+    }
+    catch (...)
+    {
+        ::close(fd);
+        throw;
+    }
+    struct stat sb;
+    if (::fstat(fd, &sb) != 0)
+        tms_throw_errno(path + ": stat");
+    if (std::uint64_t(sb.st_size) < sizeof(TMSFileHeader))
+        throw std::runtime_error(path + ": not a TMSArray file");
+    st->fileSize = std::uint64_t(sb.st_size);
+    st->out = &out;
+    st->verify = verify;
+    st->direct = direct;
+    std::future<void> result = st->done.get_future();
+
+    io.read(fd, &st->header, sizeof st->header, 0, [st, &io](int err)
+    {
+        try
+        {
+            if (err != 0)
+                throw std::system_error(err, std::generic_category(),
+                                        st->path + ": read");
+            const bool swapped = tms_check_header<T>(st->header, st->fileSize,
+                                                     st->path);
+            const std::size_t n = std::size_t(st->header.count);
+            st->out->resize(n);
+            io.read(st->file.fd, st->out->begin(), n * sizeof(T),
+                    st->header.data_offset, [st, swapped, n](int err2)
+            {
+                try
+                {
+                    if (err2 != 0)
+                        throw std::system_error(err2, std::generic_category(),
+                                                st->path + ": read");
+                    if (st->verify && tms_crc32c(st->out->begin(), n * sizeof(T))
+                                      != st->header.data_crc)
+                        throw std::runtime_error(st->path
+                                                 + ": data checksum mismatch");
+                    if (swapped)
+                        tms_bswap(st->out->begin(), sizeof(T), n);
+                    st->done.set_value();
+                }
+                catch (...)
+                {
+                    st->done.set_exception(std::current_exception());
+                }
+            }, st->direct);
+        }
+        catch (...)
+        {
+            st->done.set_exception(std::current_exception());
+        }
+    }, direct);
+    return result;
+}
+
+
+// TMSAsyncSave
+// Shared state of one tms_async_save
+struct TMSAsyncSave
+{
+    TMSFd                    file;
+    std::string              path;
+    std::uint64_t            fileSize;
+    bool                     direct;
+    TMSArray<unsigned char>  head;      // header, padding, data prefix
+    std::atomic<int>         left;
+    std::atomic<int>         err;
+    std::promise<void>       done;
+
+    TMSAsyncSave(int fd, const std::string & p)
+        :file(fd), path(p), fileSize(0), direct(false), left(0), err(0)
+    {}
+
+    // Records one write's result; the last one fulfils done
+    void finished(int e) noexcept
+    {
+        if (e != 0)
+        {
+            int none = 0;
+            err.compare_exchange_strong(none, e);
+        }
+        if (--left != 0)
+            return;
+        if (err == 0 && direct
+            && ::ftruncate(file.fd, off_t(fileSize)) != 0)
+            err = errno;
+        if (err == 0)
+            done.set_value();
+        else
+            done.set_exception(std::make_exception_ptr(std::system_error(
+                err, std::generic_category(), path + ": write")));
+    }
+};
+
+
+// tms_async_save
+// Basic Guarantee (the file may be partly written if a write fails)
+// Exception-Neutral
+// Pre:
+//      T trivially copyable; arr is neither modified nor destroyed until
+//      the future is ready
+// Post:
+//      Creates path at once (throwing std::system_error if it cannot),
+//      computes the header and its data checksum on this thread, and
+//      writes the tms_save layout through io. The future rethrows
+//      std::system_error on I/O errors. With direct the file is
+//      written with O_DIRECT: the first block is staged with the header
+//      and the file is truncated to size at the end.
+template <typename T>
+std::future<void> tms_async_save(TMSAsyncIo & io, const TMSArray<T> & arr,
+                                 const std::string & path, bool direct = false)
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "tms_async_save writes raw bytes");
+    const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC
+                                        | (direct ? O_DIRECT : 0), 0644);
+    if (fd < 0)
+        tms_throw_errno(path + ": open");
+    std::shared_ptr<TMSAsyncSave> st;
+    try
+    {
+        st = std::make_shared<TMSAsyncSave>(fd, path);
+    }
+    catch (...)
+    {
+        ::close(fd);
+        throw;
+    }
+    const TMSFileHeader h = tms_make_header(arr.begin(), arr.size());
+    const std::size_t bytes = arr.size() * sizeof(T);
+    const std::size_t offset = std::size_t(h.data_offset);
+    st->fileSize = offset + bytes;
+    st->direct = direct;
+
+    // Non-direct: header and padding, then the data in place. Direct:
+    //  the first aligned block staged whole, then the data after it.
+    const std::size_t headLen = direct ? std::min(std::size_t(st->fileSize),
+                                                  TMS_AIO_ALIGN)
+                                       : offset;
+    st->head.resize(headLen);
+    std::memset(st->head.begin(), 0, headLen);
+    std::memcpy(st->head.begin(), &h, sizeof h);
+    const std::size_t prefix = headLen - offset;
+    if (prefix > 0)
+        std::memcpy(st->head.begin() + offset, arr.begin(), prefix);
+    const std::size_t rest = bytes - prefix;
+    st->left = rest > 0 ? 2 : 1;
+    std::future<void> result = st->done.get_future();
+
+    io.write(fd, st->head.begin(), headLen, 0,
+             [st](int err) { st->finished(err); }, direct);
+    if (rest > 0)
+        io.write(fd, reinterpret_cast<const char *>(arr.begin()) + prefix,
+                 rest, offset + prefix, [st](int err) { st->finished(err); },
+                 direct);
+    return result;
+}
+
@@ -0,0 +1,142 @@
+// tmsaio_bench.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Benchmark: startup load of many TMSArray dumps. Blocking tms_load of
+//  each file in turn, against tms_async_load of all of them at once
+//  through TMSAsyncIo with the thread fallback and io_uring at several
+//  queue depths, buffered and O_DIRECT. "Cold" runs evict the files
+//  from the page cache first (posix_fadvise DONTNEED, no root needed);
+//  "warm" runs read them from the cache.
+// Usage: tmsaio_bench [files=256] [mb_per_file=4] [dir=/tmp/tmsaio_bench]
+// Requires tmsaio.hpp, tmsserial.hpp, tmscrc32.hpp, tmssimd.hpp,
+//  tmsarray.hpp, tmsbench.hpp
+
+#include "tmsaio.hpp"
+#include "tmsbench.hpp"
+
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::uint64_t;
+#include <cstdlib>
+using std::system;
+#include <algorithm>
+using std::min;
+#include <future>
+using std::future;
+#include <iostream>
+using std::cout;
+#include <string>
+using std::string;
+using std::to_string;
+#include <fcntl.h>           // For posix_fadvise
+
+
+using Dumps = TMSArray<TMSArray<uint64_t>>;
+
+
+// evict
+// Drops the files' pages from the page cache
+void evict(const TMSArray<string> & paths)
+{
+    for (const string & p : paths)
+    {
+        TMSFd f(::open(p.c_str(), O_RDONLY));
+        if (f.fd >= 0)
+            ::posix_fadvise(f.fd, 0, 0, POSIX_FADV_DONTNEED);
+    }
+}
+
+
+// loadAll
+// Every file through io at once; waits for all
+void loadAll(TMSAsyncIo & io, const TMSArray<string> & paths, bool direct)
+{
+    Dumps out(paths.size());
+    TMSArray<future<void>> done(paths.size());
+    for (size_t k = 0; k < paths.size(); ++k)
+        done[k] = tms_async_load(io, paths[k], out[k], true, direct);
+    for (future<void> & f : done)
+        f.get();
+    tms_sink(out[paths.size() - 1][0]);
+}
+
+
+int main(int argc, char * argv[])
+{
+    const size_t files = tms_arg(argc, argv, 1, 256);
+    const size_t mb = tms_arg(argc, argv, 2, 4);
+    const string dir = argc > 3 ? argv[3] : "/tmp/tmsaio_bench";
+    const size_t per = mb * (size_t(1) << 20) / sizeof(uint64_t);
+    const size_t bytes = files * per * sizeof(uint64_t);
+    if (system(("rm -rf " + dir + " && mkdir -p " + dir).c_str()) != 0)
+        return 1;
+
+    TMSArray<string> paths(files);
+    {
+        TMSArray<uint64_t> arr(per);
+        for (size_t k = 0; k < files; ++k)
+        {
+            for (size_t i = 0; i < per; ++i)
+                arr[i] = i * 0x9E3779B97F4A7C15ull + k;
+            paths[k] = dir + "/dump" + to_string(k) + ".tms";
+            tms_save(arr, paths[k]);
+        }
+    }
+    ::sync();
+    cout << files << " files of " << mb << " MB, default backend "
+         << tms_aio_name(TMSAsyncIo(1).backend()) << "\n";
+
+    // Best of 3, evicting the files before each when cold
+    auto run = [&](const string & label, bool cold, auto && load)
+    {
+        double best = 1e30;
+        for (int r = 0; r < 3; ++r)
+        {
+            if (cold)
+                evict(paths);
+            best = min(best, tms_time_best(1, load));
+        }
+        tms_report(label, best, bytes);
+    };
+    auto blocking = [&]
+    {
+        Dumps out(files);
+        for (size_t k = 0; k < files; ++k)
+            tms_load(paths[k], out[k], true);
+        tms_sink(out[files - 1][0]);
+    };
+    auto async = [&](TMSAioBackend b, size_t depth, bool direct)
+    {
+        return [&paths, b, depth, direct]
+        {
+            TMSAsyncIo io(depth, TMS_AIO_CHUNK_BYTES, b);
+            loadAll(io, paths, direct);
+        };
+    };
+
+    for (bool cold : { false, true })
+    {
+        const string tag = cold ? "cold " : "warm ";
+        cout << "\n";
+        run(tag + "blocking tms_load loop", cold, blocking);
+        for (size_t depth : { 8, 32 })
+            run(tag + "threads  depth " + to_string(depth), cold,
+                async(TMS_AIO_THREADS, depth, false));
+        if (TMSAsyncIo(1).backend() == TMS_AIO_URING)
+            for (size_t depth : { 1, 8, 32, 128 })
+                run(tag + "io_uring depth " + to_string(depth), cold,
+                    async(TMS_AIO_URING, depth, false));
+    }
+
+    // O_DIRECT bypasses the page cache: always from the device
+    cout << "\n";
+    run("O_DIRECT threads  depth 32", false, async(TMS_AIO_THREADS, 32, true));
+    if (TMSAsyncIo(1).backend() == TMS_AIO_URING)
+        for (size_t depth : { 8, 32, 128 })
+            run("O_DIRECT io_uring depth " + to_string(depth), false,
+                async(TMS_AIO_URING, depth, true));
+
+    return system(("rm -rf " + dir).c_str()) == 0 ? 0 : 1;
+}
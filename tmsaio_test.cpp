@@ -0,0 +1,441 @@
+// tmsaio_test.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Test program for class TMSAsyncIo, tms_async_load, tms_async_save
+// Uses the "doctest" unit-testing framework, version 2
+// Requires doctest.h, tmsaio.hpp, tmsserial.hpp, tmscrc32.hpp,
+//  tmssimd.hpp, tmsarray.hpp
+
+// Includes for code to be tested
+#include "tmsaio.hpp"        // For class TMSAsyncIo, tms_async_load, ...
+#include "tmsaio.hpp"        // Double-inclusion check, for testing only
+
+// Includes for the "doctest" unit-testing framework
+#define DOCTEST_CONFIG_IMPLEMENT
+                             // We write our own main
+#define DOCTEST_CONFIG_SUPER_FAST_ASSERTS
+                             // Reduce compile time
+#include "doctest.h"         // For doctest
+
+// Includes for all test programs
+#include <iostream>
+using std::cout;
+using std::endl;
+using std::cin;
+#include <string>
+using std::string;
+
+// Additional includes for this test program
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::int64_t;
+using std::uint32_t;
+using std::uint64_t;
+#include <cstdio>
+using std::remove;
+#include <algorithm>
+using std::equal;
+#include <atomic>
+using std::atomic;
+#include <future>
+using std::future;
+#include <stdexcept>
+using std::runtime_error;
+using std::invalid_argument;
+#include <system_error>
+using std::system_error;
+#include <unistd.h>          // For getpid, pwrite, readlink, dup2
+
+// Printable name for this test suite
+const string test_suite_name =
+    "class TMSAsyncIo, tms_async_load and tms_async_save";
+
+
+// *********************************************************************
+// Helper Functions for This Test Program
+// *********************************************************************
+
+
+// tempPath
+// A per-process scratch file name under /tmp, removed first
+string tempPath(const string & tag)
+{
+    string path = "/tmp/tmsaio_test_" + std::to_string(getpid()) + "_" + tag;
+    remove(path.c_str());
+    return path;
+}
+
+
+// backends
+// The backends this machine can run: threads always, io_uring if the
+//  kernel allows it
+TMSArray<TMSAioBackend> backends()
+{
+    TMSArray<TMSAioBackend> result;
+    result.push_back(TMS_AIO_THREADS);
+    if (TMSAsyncIo(1, 4096).backend() == TMS_AIO_URING)
+        result.push_back(TMS_AIO_URING);
+    return result;
+}
+
+
+// ringFd
+// This process's io_uring descriptor, or -1
+int ringFd()
+{
+    for (int fd = 0; fd < 1024; ++fd)
+    {
+        char link[256];
+        const string proc = "/proc/self/fd/" + std::to_string(fd);
+        const ssize_t n = ::readlink(proc.c_str(), link, sizeof link);
+        if (n > 0 && string(link, size_t(n)) == "anon_inode:[io_uring]")
+            return fd;
+    }
+    return -1;
+}
+
+
+// pattern
+// Byte i of the test file
+unsigned char pattern(size_t i)
+{
+    return (unsigned char)(i * 131 + (i >> 12) * 7);
+}
+
+
+// makeFile
+// n pattern bytes at path; returns an open read-write descriptor
+int makeFile(const string & path, size_t n, int flags = 0)
+{
+    TMSArray<unsigned char> bytes(n);
+    for (size_t i = 0; i < n; ++i)
+        bytes[i] = pattern(i);
+    {
+        TMSFd out(::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644));
+        REQUIRE( out.fd >= 0 );
+        REQUIRE( ::pwrite(out.fd, bytes.begin(), n, 0) == ssize_t(n) );
+    }
+    return ::open(path.c_str(), O_RDWR | flags);
+}
+
+
+// fillRandom
+// Pseudo-random values from seed
+template <typename T>
+void fillRandom(TMSArray<T> & arr, uint64_t seed)
+{
+    uint64_t x = seed;
+    for (T & v : arr)
+    {
+        x = x * 6364136223846793005ull + 1442695040888963407ull;
+        v = T(x >> 29);
+    }
+}
+
+
+// *********************************************************************
+// Test Cases
+// *********************************************************************
+
+
+TEST_CASE( "Backends and geometry" )
+{
+    TMSAsyncIo threads(4, 5000, TMS_AIO_THREADS);
+    REQUIRE( threads.backend() == TMS_AIO_THREADS );
+    REQUIRE( threads.depth() == 4 );
+    REQUIRE( threads.chunk_bytes() == 8192 );
+    REQUIRE( string(tms_aio_name(TMS_AIO_URING)) == "io_uring" );
+    REQUIRE_THROWS_AS( TMSAsyncIo(0, 4096), invalid_argument );
+    TMSAsyncIo any;
+    REQUIRE( any.backend() != TMS_AIO_AUTO );
+    cout << "    (default backend here: " << tms_aio_name(any.backend())
+         << ")" << endl;
+}
+
+
+TEST_CASE( "Reads and writes split into chunks" )
+{
+    for (TMSAioBackend b : backends())
+    {
+        const string path = tempPath("rw");
+        const size_t n = 1000000;
+        TMSFd file(makeFile(path, n));
+        REQUIRE( file.fd >= 0 );
+        TMSAsyncIo io(3, 16384, b);
+
+        // Many reads at once, odd offsets and sizes
+        TMSArray<TMSArray<unsigned char>> bufs(40);
+        TMSArray<future<void>> done(40);
+        for (size_t k = 0; k < 40; ++k)
+        {
+            const size_t off = k * 24999 + k;
+            bufs[k].resize(20000 + 97 * k);
+            done[k] = io.read(file.fd, bufs[k].begin(), bufs[k].size(), off);
+        }
+        for (size_t k = 0; k < 40; ++k)
+        {
+            done[k].get();
+            const size_t off = k * 24999 + k;
+            for (size_t i = 0; i < bufs[k].size(); ++i)
+                REQUIRE( bufs[k][i] == pattern(off + i) );
+        }
+
+        // Write a range, read it back through a callback
+        TMSArray<unsigned char> src(100000);
+        for (size_t i = 0; i < src.size(); ++i)
+            src[i] = (unsigned char)(255 - i % 251);
+        io.write(file.fd, src.begin(), src.size(), 12345).get();
+        TMSArray<unsigned char> back(src.size());
+        atomic<int> result(-1);
+        io.read(file.fd, back.begin(), back.size(), 12345,
+                [&](int err) { result = err; });
+        io.wait();
+        REQUIRE( result == 0 );
+        REQUIRE( equal(src.begin(), src.end(), back.begin()) );
+
+        // Zero bytes completes at once
+        result = -1;
+        io.read(file.fd, back.begin(), 0, 0, [&](int err) { result = err; });
+        REQUIRE( result == 0 );
+        remove(path.c_str());
+    }
+}
+
+
+TEST_CASE( "Errors reach the future or callback" )
+{
+    for (TMSAioBackend b : backends())
+    {
+        const string path = tempPath("err");
+        TMSFd file(makeFile(path, 10000));
+        TMSAsyncIo io(2, 4096, b);
+        TMSArray<unsigned char> buf(20000);
+
+        // Past end of file
+        future<void> f = io.read(file.fd, buf.begin(), 20000, 0);
+        REQUIRE_THROWS_AS( f.get(), system_error );
+        atomic<int> result(-1);
+        io.read(file.fd, buf.begin(), 100, 9990, [&](int err) { result = err; });
+        io.wait();
+        REQUIRE( result == ENODATA );
+
+        // Bad descriptor
+        io.read(-1, buf.begin(), 100, 0, [&](int err) { result = err; });
+        io.wait();
+        REQUIRE( result == EBADF );
+        REQUIRE_THROWS_AS( io.write(file.fd, buf.begin(), 10, 100, true),
+                           invalid_argument );
+        remove(path.c_str());
+    }
+}
+
+
+TEST_CASE( "A failing io_uring_enter fails requests, not the process" )
+{
+    TMSArray<TMSAioBackend> bs = backends();
+    if (bs[bs.size() - 1] != TMS_AIO_URING)
+        return;
+    const string path = tempPath("broken");
+    TMSFd file(makeFile(path, 100000));
+    TMSAsyncIo io(4, 4096, TMS_AIO_URING);
+    TMSArray<unsigned char> buf(100000);
+    io.read(file.fd, buf.begin(), 100000, 0).get();
+    REQUIRE( buf[99999] == pattern(99999) );
+
+    // The ring's descriptor now names /dev/null: io_uring_enter fails
+    //  with EOPNOTSUPP from here on
+    const int ring = ringFd();
+    REQUIRE( ring >= 0 );
+    TMSFd null(::open("/dev/null", O_RDONLY));
+    REQUIRE( ::dup2(null.fd, ring) == ring );
+
+    future<void> f = io.read(file.fd, buf.begin(), 100000, 0);
+    REQUIRE_THROWS_AS( f.get(), system_error );
+    atomic<int> result(-1);
+    io.write(file.fd, buf.begin(), 10, 0, [&](int err) { result = err; });
+    io.wait();
+    REQUIRE( result == EOPNOTSUPP );
+    remove(path.c_str());
+}
+
+
+TEST_CASE( "Direct I/O through bounce buffers" )
+{
+    for (TMSAioBackend b : backends())
+    {
+        const string path = tempPath("direct");
+        const size_t n = 300000;            // not a multiple of 4096
+        TMSFd file(makeFile(path, n, O_DIRECT));
+        REQUIRE( file.fd >= 0 );
+        TMSAsyncIo io(4, 8192, b);
+
+        // Unaligned offsets, lengths and memory, up to end of file
+        for (size_t off : { size_t(0), size_t(1), size_t(4095), size_t(77777),
+                            size_t(n - 5000) })
+        {
+            const size_t len = std::min(size_t(50001), n - off);
+            TMSArray<unsigned char> buf(len + 1);
+            io.read(file.fd, buf.begin() + 1, len, off, true).get();
+            for (size_t i = 0; i < len; ++i)
+                REQUIRE( buf[i + 1] == pattern(off + i) );
+        }
+
+        // Aligned write with a zero-padded tail
+        TMSArray<unsigned char> src(10000);
+        for (size_t i = 0; i < src.size(); ++i)
+            src[i] = (unsigned char)i;
+        io.write(file.fd, src.begin(), src.size(), 8192, true).get();
+        TMSArray<unsigned char> back(12288);
+        io.read(file.fd, back.begin(), back.size(), 8192, true).get();
+        REQUIRE( equal(src.begin(), src.end(), back.begin()) );
+        for (size_t i = src.size(); i < back.size(); ++i)
+            REQUIRE( back[i] == 0 );
+        remove(path.c_str());
+    }
+}
+
+
+TEST_CASE( "Async save and load round trip" )
+{
+    for (TMSAioBackend b : backends())
+        for (bool direct : { false, true })
+        {
+            TMSAsyncIo io(8, 65536, b);
+            const size_t files = 12;
+            TMSArray<TMSArray<int64_t>> data(files);
+            TMSArray<future<void>> done(files);
+            for (size_t k = 0; k < files; ++k)
+            {
+                data[k].resize(k * k * 3000 + k);   // 0 .. 3 MB
+                fillRandom(data[k], k + 1);
+                done[k] = tms_async_save(io, data[k],
+                                         tempPath("f" + std::to_string(k)),
+                                         direct);
+            }
+            for (future<void> & f : done)
+                f.get();
+
+            // The files are ordinary tms_save files
+            for (size_t k = 0; k < files; ++k)
+            {
+                const string path = "/tmp/tmsaio_test_"
+                                    + std::to_string(getpid()) + "_f"
+                                    + std::to_string(k);
+                TMSArray<int64_t> check;
+                tms_load(path, check, true);
+                REQUIRE( check.size() == data[k].size() );
+                REQUIRE( equal(check.begin(), check.end(), data[k].begin()) );
+                remove(path.c_str());
+            }
+        }
+}
+
+
+TEST_CASE( "Many files loaded at once" )
+{
+    for (TMSAioBackend b : backends())
+        for (bool direct : { false, true })
+        {
+            const size_t files = 30;
+            TMSArray<TMSArray<uint32_t>> data(files);
+            TMSArray<string> paths(files);
+            for (size_t k = 0; k < files; ++k)
+            {
+                data[k].resize(k * 7001);
+                fillRandom(data[k], 100 + k);
+                paths[k] = tempPath("many" + std::to_string(k));
+                tms_save(data[k], paths[k]);
+            }
+
+            TMSAsyncIo io(16, 32768, b);
+            TMSArray<TMSArray<uint32_t>> loaded(files);
+            TMSArray<future<void>> done(files);
+            for (size_t k = 0; k < files; ++k)
+                done[k] = tms_async_load(io, paths[k], loaded[k], true, direct);
+            for (size_t k = 0; k < files; ++k)
+            {
+                done[k].get();
+                REQUIRE( loaded[k].size() == data[k].size() );
+                REQUIRE( equal(data[k].begin(), data[k].end(),
+                               loaded[k].begin()) );
+                remove(paths[k].c_str());
+            }
+        }
+}
+
+
+TEST_CASE( "Load reports bad files through the future" )
+{
+    TMSAsyncIo io(4, 4096);
+    const string path = tempPath("bad");
+    TMSArray<uint32_t> out;
+    REQUIRE_THROWS_AS( tms_async_load(io, path, out), system_error );
+
+    TMSArray<float> ta(5000);
+    fillRandom(ta, 1);
+    tms_save(ta, path);
+    future<void> f = tms_async_load(io, path, out);
+    REQUIRE_THROWS_AS( f.get(), runtime_error );
+
+    TMSArray<uint32_t> tb(5000);
+    fillRandom(tb, 2);
+    tms_save(tb, path);
+    {
+        TMSFd file(::open(path.c_str(), O_WRONLY));
+        const unsigned char junk = 0x5A;
+        REQUIRE( ::pwrite(file.fd, &junk, 1, 1000) == 1 );
+    }
+    f = tms_async_load(io, path, out);
+    REQUIRE_THROWS_AS( f.get(), runtime_error );
+    f = tms_async_load(io, path, out, false);
+    f.get();
+    REQUIRE( out.size() == 5000 );
+    remove(path.c_str());
+}
+
+
+// *********************************************************************
+// Main Program
+// *********************************************************************
+
+
+// userPause
+// Wait for user to press ENTER: read all chars through first newline.
+void userPause()
+{
+    std::cout.flush();
+    while (std::cin.get() != '\n') ;
+}
+
+
+// Main program
+// Run all tests. Prompt for ENTER before exiting.
+int main(int argc,
+         char *argv[])
+{
+    doctest::Context dtcontext;
+                             // Primary doctest object
+    int dtresult;            // doctest return code; for return by main
+
+    // Handle command line
+    dtcontext.applyCommandLine(argc, argv);
+    dtresult = 0;            // doctest flags no command-line errors
+                             //  (strange but true)
+
+    if (!dtresult)           // Continue only if no command-line error
+    {
+        // Run test suites
+        cout << "BEGIN tests for " << test_suite_name << "\n" << endl;
+        dtresult = dtcontext.run();
+        cout << "END tests for " << test_suite_name << "\n" << endl;
+    }
+
+    // Wait for user
+    std::cout << "Press ENTER to quit ";
+    userPause();
+
+    // Program return value is return code from doctest
+    return dtresult;
+}
@@ -15,6 +15,8 @@
 // For std::swap
 // For std::rotate
 
+#include "tmssimd.hpp"
+// For tms_search
 
 
 // *********************************************************************
@@ -357,6 +359,83 @@ public:
 
     }
 
+
+// ***** TMSArray: search functions *****
+public:
+
+
+    // find - non-const & const
+    // No-Throw Guarantee (Basic if value_type == throws)
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns iterator to first element == item, or end() if none
+    //      32/64-bit arithmetic types are searched with SIMD kernels
+    iterator find(const value_type & item)
+    {
+        return begin() + tms_search<false>(begin(), size(), item, TMS_CMP_EQ);
+    }
+    const_iterator find(const value_type & item) const
+    {
+        return begin() + tms_search<false>(begin(), size(), item, TMS_CMP_EQ);
+    }
+
+
+    // count
+    // No-Throw Guarantee (Basic if value_type == throws)
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns number of elements == item
+    size_type count(const value_type & item) const
+    {
+        return tms_search<true>(begin(), size(), item, TMS_CMP_EQ);
+    }
+
+
+    // contains
+    // No-Throw Guarantee (Basic if value_type == throws)
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns true if some element == item
+    bool contains(const value_type & item) const
+    {
+        return find(item) != end();
+    }
+
+
+    // find_if_less - non-const & const
+    // No-Throw Guarantee (Basic if value_type < throws)
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns iterator to first element < bound, or end() if none
+    iterator find_if_less(const value_type & bound)
+    {
+        return begin() + tms_search<false>(begin(), size(), bound, TMS_CMP_LT);
+    }
+    const_iterator find_if_less(const value_type & bound) const
+    {
+        return begin() + tms_search<false>(begin(), size(), bound, TMS_CMP_LT);
+    }
+
+
+    // find_if_greater - non-const & const
+    // No-Throw Guarantee (Basic if value_type < throws)
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns iterator to first element > bound, or end() if none
+    iterator find_if_greater(const value_type & bound)
+    {
+        return begin() + tms_search<false>(begin(), size(), bound, TMS_CMP_GT);
+    }
+    const_iterator find_if_greater(const value_type & bound) const
+    {
+        return begin() + tms_search<false>(begin(), size(), bound, TMS_CMP_GT);
+    }
+
 // ***** TMSArray: data members *****
 private:
 
@@ -364,4 +443,8 @@ private:
     size_type    _size;     
     value_type * _data;     
 
-}; // end of class
\ No newline at end of file
+}; // end of class
+
+
+// Bit-packed specialization: TMSArray<bool>
+#include "tmsbitarray.hpp"
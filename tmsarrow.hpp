@@ -0,0 +1,1629 @@
+// tmsarrow.hpp
+// Matthew Johnson
+// 10/17/2026
+// Apache Arrow IPC file format read/write for primitive TMSArray columns,
+//  without the Arrow library; zero-copy mmap views on import (POSIX)
+
+#pragma once
+// for single inclusion
+
+#include "tmsarray.hpp"
+// For class template TMSArray
+// For TMSArray<bool>
+
+#include "tmsserial.hpp"
+// For class template TMSArrayView
+// For TMSFd
+// For tms_throw_errno
+// For tms_pwritev_all
+
+#include <cstddef>
+// For std::size_t
+
+#include <cstdint>
+// For std::int16_t
+// For std::int32_t
+// For std::int64_t
+// For std::uint8_t
+// For std::uint16_t
+// For std::uint32_t
+// For std::uint64_t
+
+#include <cstring>
+// For std::memcpy
+// For std::memcmp
+
+#include <algorithm>
+// For std::max
+// For std::min
+
+#include <string>
+// For std::string
+// For std::to_string
+
+#include <stdexcept>
+// For std::runtime_error
+// For std::invalid_argument
+
+#include <type_traits>
+// For std::is_integral
+// For std::is_signed
+// For std::is_same
+
+#include <utility>
+// For std::move
+
+#include <fcntl.h>
+// For open
+
+#include <unistd.h>
+// For close
+
+#include <sys/mman.h>
+// For mmap
+// For munmap
+
+#include <sys/stat.h>
+// For fstat
+
+#include <sys/uio.h>
+// For struct iovec
+
+
+// Arrow buffers and bitmaps are read and written in host order, and
+//  validity bitmaps are TMSArray<bool> words taken as bytes
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
+              "tmsarrow.hpp supports little-endian hosts only");
+
+
+
+// *********************************************************************
+// Flatbuffers
+// *********************************************************************
+
+
+// Arrow metadata is flatbuffers (Schema.fbs, Message.fbs, File.fbs).
+//  TMSFlatBuilder and TMSFlatTable are the small subset needed here:
+//  tables of scalars and offsets, strings, and vectors of structs and
+//  of offsets.
+
+
+// class TMSFlatBuilder
+// Builds one flatbuffer back to front, as the flatbuffers library does:
+//  children are created before the tables that refer to them, and an
+//  offset is the distance of an object from the end of the buffer.
+// Invariants:
+//     _buf[_head, _buf.size()) holds the bytes built so far.
+class TMSFlatBuilder
+{
+
+public:
+
+    using offset = std::uint32_t;
+
+
+// ***** TMSFlatBuilder: ctors *****
+public:
+
+
+    // Default ctor
+    // Strong Guarantee
+    TMSFlatBuilder()
+        :_buf(256, '\0'),
+         _head(256),
+         _minAlign(1),
+         _tableStart(0)
+    {}
+
+
+// ***** TMSFlatBuilder: general public functions *****
+public:
+
+
+    // size
+    // No-Throw Guarantee
+    // Bytes built so far; also the offset of the last object created
+    offset size() const noexcept
+    {
+        return offset(_buf.size() - _head);
+    }
+
+
+    // data
+    // No-Throw Guarantee
+    // The finished buffer, size() bytes
+    const char * data() const noexcept
+    {
+        return _buf.data() + _head;
+    }
+
+
+    // create_string
+    // Strong Guarantee
+    offset create_string(const std::string & s)
+    {
+        prealign(s.size() + 1, 4);
+        pad(1);
+        prepend(s.data(), s.size());
+        return push<std::uint32_t>(std::uint32_t(s.size()));
+    }
+
+
+    // create_struct_vector
+    // Strong Guarantee
+    // Pre:
+    //      data holds count structs of elemSize bytes, alignment align
+    offset create_struct_vector(const void * data, std::size_t elemSize,
+                                std::size_t count, std::size_t align)
+    {
+        prealign(elemSize * count, 4);
+        prealign(elemSize * count, align);
+        prepend(data, elemSize * count);
+        return push<std::uint32_t>(std::uint32_t(count));
+    }
+
+
+    // create_offset_vector
+    // Strong Guarantee
+    offset create_offset_vector(const offset * offs, std::size_t count)
+    {
+        prealign(4 * count, 4);
+        for (std::size_t i = count; i-- > 0; )
+            push_offset(offs[i]);
+        return push<std::uint32_t>(std::uint32_t(count));
+    }
+
+
+    // start_table
+    // No-Throw Guarantee
+    // Pre:
+    //      No table is being built; every object the table refers to
+    //      has been created
+    void start_table() noexcept
+    {
+        _fieldCount = 0;
+        _tableStart = size();
+    }
+
+
+    // add
+    // Strong Guarantee
+    // Pre:
+    //      start_table called; each id at most once, below 16
+    template <typename S>
+    void add(int id, S value)
+    {
+        push<S>(value);
+        _fields[_fieldCount++] = Field{ id, size() };
+    }
+
+
+    // add_offset
+    // Strong Guarantee
+    void add_offset(int id, offset target)
+    {
+        push_offset(target);
+        _fields[_fieldCount++] = Field{ id, size() };
+    }
+
+
+    // end_table
+    // Strong Guarantee
+    // Post:
+    //      Table and its vtable written; returns the table's offset
+    offset end_table()
+    {
+        push<std::int32_t>(0);
+        const offset table = size();
+        int slots = 0;
+        std::uint16_t entry[16] = {};
+        for (int f = 0; f < _fieldCount; ++f)
+        {
+            entry[_fields[f].id] = std::uint16_t(table - _fields[f].at);
+            slots = std::max(slots, _fields[f].id + 1);
+        }
+        for (int s = slots; s-- > 0; )
+            push<std::uint16_t>(entry[s]);
+        push<std::uint16_t>(std::uint16_t(table - _tableStart));
+        push<std::uint16_t>(std::uint16_t(4 + 2 * slots));
+        const std::int32_t soff = std::int32_t(size() - table);
+        std::memcpy(&_buf[_buf.size() - table], &soff, 4);
+        return table;
+    }
+
+
+    // finish
+    // Strong Guarantee
+    // Post:
+    //      root is the root table; size() is a multiple of the largest
+    //      alignment used
+    void finish(offset root)
+    {
+        prealign(4, _minAlign);
+        push_offset(root);
+    }
+
+
+// ***** TMSFlatBuilder: private helper functions *****
+private:
+
+
+    void reserve(std::size_t n)
+    {
+        if (_head >= n)
+            return;
+        const std::size_t used = size();
+        const std::size_t cap = std::max(2 * _buf.size(), used + n);
+        std::string grown(cap, '\0');
+        std::memcpy(&grown[cap - used], _buf.data() + _head, used);
+        _buf.swap(grown);
+        _head = cap - used;
+    }
+
+
+    void prepend(const void * p, std::size_t n)
+    {
+        if (n == 0)
+            return;
+        reserve(n);
+        _head -= n;
+        std::memcpy(&_buf[_head], p, n);
+    }
+
+
+    void pad(std::size_t n)
+    {
+        reserve(n);
+        _head -= n;
+        std::memset(&_buf[_head], 0, n);
+    }
+
+
+    // prealign
+    // Pads so that after len more bytes, size() is a multiple of align
+    void prealign(std::size_t len, std::size_t align)
+    {
+        _minAlign = std::max(_minAlign, align);
+        pad((align - (size() + len) % align) % align);
+    }
+
+
+    template <typename S>
+    offset push(S value)
+    {
+        prealign(0, sizeof(S));
+        prepend(&value, sizeof(S));
+        return size();
+    }
+
+
+    void push_offset(offset target)
+    {
+        prealign(0, 4);
+        push<std::uint32_t>(size() + 4 - target);
+    }
+
+
+// ***** TMSFlatBuilder: data members *****
+private:
+
+    struct Field
+    {
+        int    id;
+        offset at;
+    };
+
+    std::string  _buf;
+    std::size_t  _head;
+    std::size_t  _minAlign;
+    offset       _tableStart;
+    Field        _fields[16];
+    int          _fieldCount = 0;
+
+}; // end of class
+
+
+// class TMSFlatTable
+// Bounds-checked read access to one table of a flatbuffer; anything out
+//  of range throws std::runtime_error naming what.
+// Invariants:
+//     [_buf, _buf + _len) is the whole flatbuffer; _pos is the table,
+//      _vt its vtable of _vtLen bytes, both in range.
+class TMSFlatTable
+{
+
+// ***** TMSFlatTable: ctors *****
+public:
+
+
+    // Ctor: root table
+    // Strong Guarantee
+    TMSFlatTable(const unsigned char * buf, std::size_t len,
+                 const std::string & what)
+        :_buf(buf),
+         _len(len),
+         _what(what)
+    {
+        check(0, 4);
+        locate(get<std::uint32_t>(0));
+    }
+
+
+// ***** TMSFlatTable: general public functions *****
+public:
+
+
+    // has
+    // No-Throw Guarantee
+    bool has(int id) const noexcept
+    {
+        return field(id) != 0;
+    }
+
+
+    // scalar
+    // Field id, or def if absent
+    template <typename S>
+    S scalar(int id, S def) const
+    {
+        const std::size_t p = field(id);
+        if (p == 0)
+            return def;
+        check(p, sizeof(S));
+        return get<S>(p);
+    }
+
+
+    // table
+    // Field id, which must be present
+    TMSFlatTable table(int id) const
+    {
+        return TMSFlatTable(*this, target(required(id)));
+    }
+
+
+    // string
+    // Field id, or "" if absent
+    std::string string(int id) const
+    {
+        const std::size_t p = field(id);
+        if (p == 0)
+            return std::string();
+        const std::size_t s = target(p);
+        check(s, 4);
+        const std::uint32_t n = get<std::uint32_t>(s);
+        check(s + 4, n);
+        return std::string(reinterpret_cast<const char *>(_buf + s + 4), n);
+    }
+
+
+    // vector
+    // Field id as count elements of elemSize bytes starting at the
+    //  returned position; count 0 if absent
+    std::size_t vector(int id, std::size_t elemSize, std::size_t & count) const
+    {
+        count = 0;
+        const std::size_t p = field(id);
+        if (p == 0)
+            return 0;
+        const std::size_t v = target(p);
+        check(v, 4);
+        count = get<std::uint32_t>(v);
+        if (count > (_len - v - 4) / elemSize)
+            fail();
+        return v + 4;
+    }
+
+
+    // element
+    // Table at index i of a vector of offsets that starts at pos
+    TMSFlatTable element(std::size_t pos, std::size_t i) const
+    {
+        return TMSFlatTable(*this, target(pos + 4 * i));
+    }
+
+
+    // get
+    // Raw little-endian value at pos; pos must have been range-checked
+    template <typename S>
+    S get(std::size_t pos) const noexcept
+    {
+        S v;
+        std::memcpy(&v, _buf + pos, sizeof(S));
+        return v;
+    }
+
+
+// ***** TMSFlatTable: private helper functions *****
+private:
+
+
+    TMSFlatTable(const TMSFlatTable & from, std::size_t pos)
+        :_buf(from._buf),
+         _len(from._len),
+         _what(from._what)
+    {
+        locate(pos);
+    }
+
+
+    [[noreturn]] void fail() const
+    {
+        throw std::runtime_error(_what + ": bad Arrow metadata");
+    }
+
+
+    void check(std::size_t pos, std::size_t n) const
+    {
+        if (pos > _len || n > _len - pos)
+            fail();
+    }
+
+
+    void locate(std::size_t pos)
+    {
+        check(pos, 4);
+        const std::int64_t vt = std::int64_t(pos) - get<std::int32_t>(pos);
+        if (vt < 0 || std::uint64_t(vt) > _len)
+            fail();
+        _pos = pos;
+        _vt = std::size_t(vt);
+        check(_vt, 4);
+        _vtLen = get<std::uint16_t>(_vt);
+        check(_vt, _vtLen);
+    }
+
+
+    std::size_t field(int id) const noexcept
+    {
+        const std::size_t slot = 4 + 2 * std::size_t(id);
+        if (slot + 2 > _vtLen)
+            return 0;
+        const std::uint16_t off = get<std::uint16_t>(_vt + slot);
+        return off == 0 ? 0 : _pos + off;
+    }
+
+
+    std::size_t required(int id) const
+    {
+        const std::size_t p = field(id);
+        if (p == 0)
+            fail();
+        return p;
+    }
+
+
+    std::size_t target(std::size_t p) const
+    {
+        check(p, 4);
+        const std::size_t t = p + get<std::uint32_t>(p);
+        check(t, 0);
+        return t;
+    }
+
+
+// ***** TMSFlatTable: data members *****
+private:
+
+    const unsigned char * _buf;
+    std::size_t           _len;
+    std::string           _what;
+    std::size_t           _pos;
+    std::size_t           _vt;
+    std::size_t           _vtLen;
+
+}; // end of class
+
+
+
+// *********************************************************************
+// Arrow types
+// *********************************************************************
+
+
+// File layout: "ARROW1" and 2 bytes of padding; the schema message;
+//  one message per record batch, each metadata then body; the
+//  end-of-stream marker; the footer (schema again and the position of
+//  every batch); the footer's length; "ARROW1". A message is 0xFFFFFFFF,
+//  the metadata length, the metadata flatbuffer padded to 8 bytes, then
+//  the body. In a body each column has a validity bitmap (bit i of byte
+//  i / 8 set when row i is not null; empty when there are no nulls) and
+//  a values buffer.
+
+constexpr char        TMS_ARROW_MAGIC[6] = { 'A', 'R', 'R', 'O', 'W', '1' };
+constexpr std::size_t TMS_ARROW_ALIGN    = 64;
+
+// Type union (Schema.fbs)
+constexpr std::uint8_t TMS_ARROW_INT   = 2;
+constexpr std::uint8_t TMS_ARROW_FLOAT = 3;
+constexpr std::uint8_t TMS_ARROW_BOOL  = 6;
+
+
+// TMSArrowType
+// A column type: union tag, bit width, signedness
+struct TMSArrowType
+{
+    std::uint8_t tag;
+    unsigned     bits;
+    bool         isSigned;
+
+    bool operator==(const TMSArrowType & other) const noexcept
+    {
+        return tag == other.tag && bits == other.bits
+               && isSigned == other.isSigned;
+    }
+};
+
+
+// tms_arrow_type
+// Arrow type of TMSArray<T> columns: Int, FloatingPoint or Bool
+template <typename T>
+TMSArrowType tms_arrow_type() noexcept
+{
+    static_assert(std::is_integral<T>::value || std::is_same<T, float>::value
+                  || std::is_same<T, double>::value,
+                  "Arrow columns are integers, float, double or bool");
+    if (std::is_same<T, bool>::value)
+        return TMSArrowType{ TMS_ARROW_BOOL, 1, false };
+    if (std::is_integral<T>::value)
+        return TMSArrowType{ TMS_ARROW_INT, unsigned(8 * sizeof(T)),
+                             std::is_signed<T>::value };
+    return TMSArrowType{ TMS_ARROW_FLOAT, unsigned(8 * sizeof(T)), true };
+}
+
+
+// tms_arrow_type_name
+// For messages, e.g. "int32", "uint8", "double", "bool"
+inline std::string tms_arrow_type_name(const TMSArrowType & t)
+{
+    if (t.tag == TMS_ARROW_BOOL)
+        return "bool";
+    if (t.tag == TMS_ARROW_FLOAT)
+        return t.bits == 64 ? "double" : t.bits == 32 ? "float" : "halffloat";
+    if (t.tag == TMS_ARROW_INT)
+        return (t.isSigned ? "int" : "uint") + std::to_string(t.bits);
+    return "type " + std::to_string(t.tag);
+}
+
+
+// tms_arrow_bits_set
+// Sets n bits of dst from bit at on
+inline void tms_arrow_bits_set(std::uint64_t * dst, std::size_t at,
+                               std::size_t n) noexcept
+{
+    for (; n > 0 && at % 64 != 0; ++at, --n)
+        dst[at / 64] |= std::uint64_t(1) << (at % 64);
+    for (; n >= 64; at += 64, n -= 64)
+        dst[at / 64] = ~std::uint64_t(0);
+    for (; n > 0; ++at, --n)
+        dst[at / 64] |= std::uint64_t(1) << (at % 64);
+}
+
+
+// tms_arrow_bits_copy
+// ORs n bits of the Arrow bitmap src into dst from bit at on; dst holds
+//  zeros there beforehand. A byte at a time, whole words when at is a
+//  multiple of 64.
+inline void tms_arrow_bits_copy(const unsigned char * src, std::size_t n,
+                                std::uint64_t * dst, std::size_t at) noexcept
+{
+    std::size_t i = 0;
+    if (at % 64 == 0)
+        for (; i + 64 <= n; i += 64)
+            std::memcpy(dst + (at + i) / 64, src + i / 8, 8);
+    for (; i < n; i += 8)
+    {
+        std::uint64_t b = src[i / 8];
+        if (n - i < 8)
+            b &= (std::uint64_t(1) << (n - i)) - 1;
+        const std::size_t bit = at + i;
+        dst[bit / 64] |= b << (bit % 64);
+        if (bit % 64 > 56 && (b >> (64 - bit % 64)) != 0)
+            dst[bit / 64 + 1] |= b >> (64 - bit % 64);
+    }
+}
+
+
+
+// *********************************************************************
+// class TMSArrowBatch - Class definition
+// *********************************************************************
+
+
+// class TMSArrowBatch
+// The columns of one record batch, by reference: a batch refers to its
+//  TMSArrays, which must outlive it and stay unchanged until it has
+//  been written.
+// Invariants:
+//     Every column has size() rows; names are distinct.
+class TMSArrowBatch
+{
+
+public:
+
+    using size_type = std::size_t;
+
+
+// ***** TMSArrowBatch: general public functions *****
+public:
+
+
+    // add
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      values and *valid outlive this batch's write
+    // Post:
+    //      Column name appended; rows where *valid is false are null.
+    //      Throws std::invalid_argument if the name is taken or the
+    //      row count differs from earlier columns or from values.
+    template <typename T>
+    void add(const std::string & name, const TMSArray<T> & values,
+             const TMSArray<bool> * valid = nullptr)
+    {
+        if (!_columns.empty() && values.size() != _rows)
+            throw std::invalid_argument("TMSArrowBatch: column " + name
+                                        + " has a different row count");
+        if (valid != nullptr && valid->size() != values.size())
+            throw std::invalid_argument("TMSArrowBatch: validity of " + name
+                                        + " has a different size");
+        for (const Column & c : _columns)
+            if (c.name == name)
+                throw std::invalid_argument("TMSArrowBatch: duplicate column "
+                                            + name);
+        Column c;
+        c.name = name;
+        c.type = tms_arrow_type<T>();
+        c.data = dataOf(values);
+        c.bytes = std::is_same<T, bool>::value ? (values.size() + 7) / 8
+                                               : values.size() * sizeof(T);
+        c.valid = valid == nullptr ? nullptr : valid->words();
+        c.nulls = valid == nullptr ? 0 : valid->size() - valid->count();
+        _columns.push_back(c);
+        _rows = values.size();
+    }
+
+
+    // rows
+    // No-Throw Guarantee
+    size_type rows() const noexcept
+    {
+        return _rows;
+    }
+
+
+    // columns
+    // No-Throw Guarantee
+    size_type columns() const noexcept
+    {
+        return _columns.size();
+    }
+
+
+// ***** TMSArrowBatch: private types and helpers *****
+private:
+
+    friend class TMSArrowWriter;
+
+    struct Column
+    {
+        std::string           name;
+        TMSArrowType          type;
+        const void *          data;
+        std::size_t           bytes;
+        const std::uint64_t * valid;
+        std::size_t           nulls;
+    };
+
+
+    template <typename T>
+    static const void * dataOf(const TMSArray<T> & values) noexcept
+    {
+        return values.begin();
+    }
+
+    static const void * dataOf(const TMSArray<bool> & values) noexcept
+    {
+        return values.words();
+    }
+
+
+// ***** TMSArrowBatch: data members *****
+private:
+
+    TMSArray<Column> _columns;
+    size_type        _rows = 0;
+
+}; // end of class
+
+
+
+// *********************************************************************
+// class TMSArrowWriter - Class definition
+// *********************************************************************
+
+
+// class TMSArrowWriter
+// Writes an Arrow IPC file one record batch at a time, straight to the
+//  file; the first batch fixes the schema (every column nullable).
+//  Each batch body starts at a multiple of TMS_ARROW_ALIGN in the file
+//  and each buffer is padded to one, so every buffer can be mapped.
+// Invariants:
+//     _fd open until close(); _offset is the end of what is written;
+//      _blocks has one entry per batch written.
+class TMSArrowWriter
+{
+
+public:
+
+    using size_type = std::size_t;
+
+
+// ***** TMSArrowWriter: ctors, dctor *****
+public:
+
+
+    // Ctor from path
+    // Strong Guarantee
+    // Pre: None
+    // Post:
+    //      path created (or truncated), holding the leading magic.
+    //      Throws std::system_error if it cannot be.
+    explicit TMSArrowWriter(const std::string & path)
+        :_path(path),
+         _fd(::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                    0644)),
+         _offset(0),
+         _haveSchema(false)
+    {
+        if (_fd < 0)
+            tms_throw_errno(path + ": open");
+        std::string head(TMS_ARROW_MAGIC, sizeof TMS_ARROW_MAGIC);
+        head.append(2, '\0');
+        try
+        {
+            writeBytes(head);
+        }
+        catch (...)
+        {
+            ::close(_fd);
+            throw;
+        }
+    }
+
+
+    // No copying: owns the file
+    TMSArrowWriter(const TMSArrowWriter &) = delete;
+    TMSArrowWriter & operator=(const TMSArrowWriter &) = delete;
+
+
+    // Dctor
+    // No-Throw Guarantee
+    // Pre: None
+    // Post:
+    //      Closed as by close(); errors ignored (the file may then be
+    //      unreadable)
+    ~TMSArrowWriter()
+    {
+        try
+        {
+            close();
+        }
+        catch (...)
+        {}
+        if (_fd >= 0)
+            ::close(_fd);
+    }
+
+
+// ***** TMSArrowWriter: general public functions *****
+public:
+
+
+    // write
+    // Basic Guarantee (a failed write leaves the file unusable)
+    // Exception-Neutral
+    // Pre:
+    //      Not closed
+    // Post:
+    //      batch appended: metadata, then its buffers in one pwritev per
+    //      up to 512 buffers. Throws std::invalid_argument if the
+    //      column names or types differ from the first batch's,
+    //      std::runtime_error after close(), std::system_error on I/O
+    //      errors.
+    void write(const TMSArrowBatch & batch)
+    {
+        if (_fd < 0)
+            throw std::runtime_error(_path + ": file already closed");
+        if (!_haveSchema)
+        {
+            _names.resize(0);
+            _types.resize(0);
+            for (const TMSArrowBatch::Column & c : batch._columns)
+            {
+                _names.push_back(c.name);
+                _types.push_back(c.type);
+            }
+            writeMessage(schemaMessage(), 8);
+            _haveSchema = true;
+        }
+        else
+        {
+            bool same = batch.columns() == _names.size();
+            for (size_type i = 0; same && i < _names.size(); ++i)
+                same = batch._columns[i].name == _names[i]
+                       && batch._columns[i].type == _types[i];
+            if (!same)
+                throw std::invalid_argument(_path + ": batch does not match "
+                                            "the schema");
+        }
+
+        // Buffers: validity then values for each column
+        const size_type ncols = batch.columns();
+        TMSArray<std::int64_t> nodes(2 * ncols);
+        TMSArray<std::int64_t> buffers(4 * ncols);
+        TMSArray<const void *> src(2 * ncols);
+        std::uint64_t body = 0;
+        for (size_type i = 0; i < ncols; ++i)
+        {
+            const TMSArrowBatch::Column & c = batch._columns[i];
+            nodes[2 * i] = std::int64_t(batch.rows());
+            nodes[2 * i + 1] = std::int64_t(c.nulls);
+            const std::uint64_t vbytes = c.nulls > 0 ? (batch.rows() + 7) / 8 : 0;
+            buffers[4 * i] = std::int64_t(body);
+            buffers[4 * i + 1] = std::int64_t(vbytes);
+            src[2 * i] = c.valid;
+            body += padded(vbytes);
+            buffers[4 * i + 2] = std::int64_t(body);
+            buffers[4 * i + 3] = std::int64_t(c.bytes);
+            src[2 * i + 1] = c.data;
+            body += padded(c.bytes);
+        }
+
+        TMSFlatBuilder fb;
+        const auto nodeVec = fb.create_struct_vector(nodes.begin(), 16, ncols, 8);
+        const auto bufVec = fb.create_struct_vector(buffers.begin(), 16,
+                                                    2 * ncols, 8);
+        fb.start_table();                               // RecordBatch
+        fb.add<std::int64_t>(0, std::int64_t(batch.rows()));
+        fb.add_offset(1, nodeVec);
+        fb.add_offset(2, bufVec);
+        const auto rb = fb.end_table();
+        const std::uint64_t at = _offset;
+        const std::uint64_t meta = writeMessage(message(fb, 3, rb, body),
+                                                TMS_ARROW_ALIGN);
+
+        static const char zeros[TMS_ARROW_ALIGN] = {};
+        TMSArray<struct iovec> iov;
+        for (size_type b = 0; b < 2 * ncols; ++b)
+        {
+            const std::size_t n = std::size_t(buffers[2 * b + 1]);
+            if (n > 0)
+                iov.push_back(iovec{ const_cast<void *>(src[b]), n });
+            if (padded(n) > n)
+                iov.push_back(iovec{ const_cast<char *>(zeros), padded(n) - n });
+            if (iov.size() >= 510 || (b + 1 == 2 * ncols && !iov.empty()))
+            {
+                std::uint64_t len = 0;
+                for (const struct iovec & v : iov)
+                    len += v.iov_len;
+                tms_pwritev_all(_fd, iov.begin(), int(iov.size()), _offset,
+                                _path);
+                _offset += len;
+                iov.resize(0);
+            }
+        }
+        _blocks.push_back(Block{ std::int64_t(at), std::int32_t(meta), 0,
+                                 std::int64_t(body) });
+    }
+
+
+    // batches
+    // No-Throw Guarantee
+    size_type batches() const noexcept
+    {
+        return _blocks.size();
+    }
+
+
+    // close
+    // Basic Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      End-of-stream marker, footer and trailing magic written, file
+    //      closed; does nothing if already closed. A file with no
+    //      batches gets an empty schema. Throws std::system_error on
+    //      I/O errors.
+    void close()
+    {
+        if (_fd < 0)
+            return;
+        if (!_haveSchema)
+        {
+            writeMessage(schemaMessage(), 8);
+            _haveSchema = true;
+        }
+        std::string tail;
+        tail.append(4, '\xFF');
+        tail.append(4, '\0');
+
+        TMSFlatBuilder fb;
+        const auto blocks = fb.create_struct_vector(_blocks.begin(),
+                                                    sizeof(Block),
+                                                    _blocks.size(), 8);
+        const auto dicts = fb.create_struct_vector(nullptr, sizeof(Block), 0, 8);
+        const auto schema = schemaTable(fb);
+        fb.start_table();                               // Footer
+        fb.add<std::int16_t>(0, 4);                     // V5
+        fb.add_offset(1, schema);
+        fb.add_offset(2, dicts);
+        fb.add_offset(3, blocks);
+        fb.finish(fb.end_table());
+        tail.append(fb.data(), fb.size());
+        const std::int32_t len = std::int32_t(fb.size());
+        tail.append(reinterpret_cast<const char *>(&len), 4);
+        tail.append(TMS_ARROW_MAGIC, sizeof TMS_ARROW_MAGIC);
+        writeBytes(tail);
+
+        const int fd = _fd;
+        _fd = -1;
+        if (::close(fd) != 0)
+            tms_throw_errno(_path + ": close");
+    }
+
+
+// ***** TMSArrowWriter: private types *****
+private:
+
+
+    // Block (File.fbs): where one batch is
+    struct Block
+    {
+        std::int64_t offset;
+        std::int32_t metaDataLength;
+        std::int32_t pad;
+        std::int64_t bodyLength;
+    };
+
+
+// ***** TMSArrowWriter: private helper functions *****
+private:
+
+
+    static std::uint64_t padded(std::uint64_t n) noexcept
+    {
+        return (n + TMS_ARROW_ALIGN - 1) / TMS_ARROW_ALIGN * TMS_ARROW_ALIGN;
+    }
+
+
+    void writeBytes(const std::string & bytes)
+    {
+        struct iovec iov;
+        iov.iov_base = const_cast<char *>(bytes.data());
+        iov.iov_len = bytes.size();
+        tms_pwritev_all(_fd, &iov, 1, _offset, _path);
+        _offset += bytes.size();
+    }
+
+
+    // schemaTable
+    // Schema: one nullable Field per column
+    TMSFlatBuilder::offset schemaTable(TMSFlatBuilder & fb) const
+    {
+        TMSArray<TMSFlatBuilder::offset> fields(_names.size());
+        for (size_type i = 0; i < _names.size(); ++i)
+        {
+            const TMSArrowType & t = _types[i];
+            const auto name = fb.create_string(_names[i]);
+            const auto children = fb.create_offset_vector(nullptr, 0);
+            fb.start_table();
+            if (t.tag == TMS_ARROW_INT)
+            {
+                fb.add<std::int32_t>(0, std::int32_t(t.bits));
+                fb.add<std::uint8_t>(1, t.isSigned);
+            }
+            else if (t.tag == TMS_ARROW_FLOAT)
+                fb.add<std::int16_t>(0, t.bits == 64 ? 2 : 1);
+            const auto type = fb.end_table();
+            fb.start_table();
+            fb.add_offset(0, name);
+            fb.add<std::uint8_t>(1, 1);                 // nullable
+            fb.add<std::uint8_t>(2, t.tag);
+            fb.add_offset(3, type);
+            fb.add_offset(5, children);
+            fields[i] = fb.end_table();
+        }
+        const auto vec = fb.create_offset_vector(fields.begin(), fields.size());
+        fb.start_table();
+        fb.add<std::int16_t>(0, 0);                     // little-endian
+        fb.add_offset(1, vec);
+        return fb.end_table();
+    }
+
+
+    std::string schemaMessage() const
+    {
+        TMSFlatBuilder fb;
+        return message(fb, 1, schemaTable(fb), 0);
+    }
+
+
+    // message
+    // Finishes fb with a Message of the given header
+    static std::string message(TMSFlatBuilder & fb, std::uint8_t kind,
+                               TMSFlatBuilder::offset header,
+                               std::uint64_t bodyLength)
+    {
+        fb.start_table();
+        fb.add<std::int64_t>(3, std::int64_t(bodyLength));
+        fb.add_offset(2, header);
+        fb.add<std::int16_t>(0, 4);                     // V5
+        fb.add<std::uint8_t>(1, kind);
+        fb.finish(fb.end_table());
+        return std::string(fb.data(), fb.size());
+    }
+
+
+    // writeMessage
+    // Continuation marker, length and metadata, padded so that the body
+    //  that follows starts at a multiple of align; returns the bytes
+    //  written (the block's metaDataLength)
+    std::uint64_t writeMessage(const std::string & meta, std::size_t align)
+    {
+        std::uint64_t len = meta.size();
+        len += (align - (_offset + 8 + len) % align) % align;
+        std::string out;
+        out.append(4, '\xFF');
+        const std::int32_t len32 = std::int32_t(len);
+        out.append(reinterpret_cast<const char *>(&len32), 4);
+        out += meta;
+        out.append(std::size_t(len - meta.size()), '\0');
+        writeBytes(out);
+        return out.size();
+    }
+
+
+// ***** TMSArrowWriter: data members *****
+private:
+
+    std::string            _path;
+    int                    _fd;             // -1 once closed
+    std::uint64_t          _offset;
+    bool                   _haveSchema;
+    TMSArray<std::string>  _names;
+    TMSArray<TMSArrowType> _types;
+    TMSArray<Block>        _blocks;
+
+}; // end of class
+
+
+
+// *********************************************************************
+// class TMSArrowReader - Class definition
+// *********************************************************************
+
+
+// class TMSArrowReader
+// Reads Arrow IPC files: the footer, schema and every batch's metadata
+//  are parsed on opening, from a read-only mapping of the file. Int,
+//  FloatingPoint and Bool columns can be copied out with load, and all
+//  but Bool mapped without copying with view. Columns of other flat
+//  types are listed but not readable; files with nested or
+//  dictionary-encoded columns, or compressed bodies, are rejected.
+// Invariants:
+//     _map, _mapLen map the file (nullptr, 0 when moved from);
+//      _chunks[b * columns() + c] locates column c of batch b.
+class TMSArrowReader
+{
+
+public:
+
+    using size_type = std::size_t;
+
+
+// ***** TMSArrowReader: ctors, dctor *****
+public:
+
+
+    // Ctor from path
+    // Strong Guarantee
+    // Pre: None
+    // Post:
+    //      File at path opened and its metadata read. Throws
+    //      std::system_error on I/O errors, std::runtime_error if it is
+    //      not an Arrow file or uses what is not supported.
+    explicit TMSArrowReader(const std::string & path)
+        :_path(path),
+         _map(nullptr),
+         _mapLen(0)
+    {
+        TMSFd file(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+        if (file.fd < 0)
+            tms_throw_errno(path + ": open");
+        struct stat st;
+        if (::fstat(file.fd, &st) != 0)
+            tms_throw_errno(path + ": stat");
+        if (st.st_size < 18)
+            throw std::runtime_error(path + ": not an Arrow file");
+        void * map = ::mmap(nullptr, std::size_t(st.st_size), PROT_READ,
+                            MAP_PRIVATE, file.fd, 0);
+        if (map == MAP_FAILED)
+            tms_throw_errno(path + ": mmap");
+        _map = map;
+        _mapLen = std::size_t(st.st_size);
+        try
+        {
+            readFooter();
+        }
+        catch (...)
+        {
+            ::munmap(_map, _mapLen);
+            throw;
+        }
+    }
+
+
+    // No copying: owns its mapping
+    TMSArrowReader(const TMSArrowReader &) = delete;
+    TMSArrowReader & operator=(const TMSArrowReader &) = delete;
+
+
+    // Move ctor
+    // No-Throw Guarantee
+    TMSArrowReader(TMSArrowReader && other) noexcept
+        :_path(std::move(other._path)),
+         _map(other._map),
+         _mapLen(other._mapLen)
+    {
+        _columns.swap(other._columns);
+        _lengths.swap(other._lengths);
+        _chunks.swap(other._chunks);
+        other._map = nullptr;
+        other._mapLen = 0;
+    }
+
+
+    // Dctor
+    // No-Throw Guarantee
+    ~TMSArrowReader()
+    {
+        if (_map != nullptr)
+            ::munmap(_map, _mapLen);
+    }
+
+
+// ***** TMSArrowReader: general public functions *****
+public:
+
+
+    // columns, batches
+    // No-Throw Guarantee
+    size_type columns() const noexcept
+    {
+        return _columns.size();
+    }
+
+    size_type batches() const noexcept
+    {
+        return _lengths.size();
+    }
+
+
+    // name
+    // No-Throw Guarantee
+    // Pre:
+    //      c < columns()
+    const std::string & name(size_type c) const noexcept
+    {
+        return _columns[c].name;
+    }
+
+
+    // type
+    // No-Throw Guarantee
+    // Pre:
+    //      c < columns()
+    const TMSArrowType & type(size_type c) const noexcept
+    {
+        return _columns[c].type;
+    }
+
+
+    // column
+    // Strong Guarantee
+    // Index of the column called name; throws std::runtime_error if none
+    size_type column(const std::string & name) const
+    {
+        for (size_type c = 0; c < _columns.size(); ++c)
+            if (_columns[c].name == name)
+                return c;
+        throw std::runtime_error(_path + ": no column named '" + name + "'");
+    }
+
+
+    // rows
+    // No-Throw Guarantee
+    // Pre:
+    //      b < batches()
+    // Post:
+    //      rows(b) is the length of batch b; rows() is the total
+    size_type rows(size_type b) const noexcept
+    {
+        return size_type(_lengths[b]);
+    }
+
+    size_type rows() const noexcept
+    {
+        size_type total = 0;
+        for (std::uint64_t n : _lengths)
+            total += size_type(n);
+        return total;
+    }
+
+
+    // null_count
+    // No-Throw Guarantee
+    // Pre:
+    //      b < batches(), c < columns()
+    size_type null_count(size_type b, size_type c) const noexcept
+    {
+        return size_type(chunk(b, c).nulls);
+    }
+
+
+    // view
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      b < batches(), c < columns()
+    // Post:
+    //      Read-only mmap view of column c of batch b, independent of
+    //      this reader's lifetime. Values in null rows are unspecified.
+    //      Throws std::runtime_error if the column's type is not T's or
+    //      its buffer is not aligned for T in the file.
+    template <typename T>
+    TMSArrayView<T> view(size_type b, size_type c) const
+    {
+        static_assert(!std::is_same<T, bool>::value,
+                      "Bool columns are bit-packed; use load");
+        const Chunk & k = checked<T>(b, c);
+        return TMSArrayView<T>::map_range(_path, k.dataOff,
+                                          size_type(_lengths[b]));
+    }
+
+
+    // load
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      b < batches(), c < columns()
+    // Post:
+    //      out holds column c of batch b; *valid, when given, its
+    //      validity (true where not null). Throws as view, except for
+    //      alignment.
+    template <typename T>
+    void load(size_type b, size_type c, TMSArray<T> & out,
+              TMSArray<bool> * valid = nullptr) const
+    {
+        gather(b, b + 1, c, out, valid);
+    }
+
+
+    // load_column
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      c < columns()
+    // Post:
+    //      out holds column c of every batch, in order; *valid, when
+    //      given, its validity. Throws as load.
+    template <typename T>
+    void load_column(size_type c, TMSArray<T> & out,
+                     TMSArray<bool> * valid = nullptr) const
+    {
+        gather(0, batches(), c, out, valid);
+    }
+
+
+// ***** TMSArrowReader: private types *****
+private:
+
+
+    struct Column
+    {
+        std::string  name;
+        TMSArrowType type;
+        bool         readable;      // Int, FloatingPoint or Bool
+        unsigned     buffers;       // in each batch body
+    };
+
+
+    struct Chunk
+    {
+        std::uint64_t nulls;
+        std::uint64_t validOff;     // absolute; validLen 0 if absent
+        std::uint64_t validLen;
+        std::uint64_t dataOff;
+        std::uint64_t dataLen;
+    };
+
+
+// ***** TMSArrowReader: private helper functions *****
+private:
+
+
+    const unsigned char * base() const noexcept
+    {
+        return static_cast<const unsigned char *>(_map);
+    }
+
+
+    [[noreturn]] void bad(const std::string & what) const
+    {
+        throw std::runtime_error(_path + ": " + what);
+    }
+
+
+    const Chunk & chunk(size_type b, size_type c) const noexcept
+    {
+        return _chunks[b * _columns.size() + c];
+    }
+
+
+    // checked
+    // Chunk (b, c) after checking T against the column type
+    template <typename T>
+    const Chunk & checked(size_type b, size_type c) const
+    {
+        const Column & col = _columns[c];
+        if (!col.readable || !(col.type == tms_arrow_type<T>()))
+            bad("column " + col.name + " is "
+                + tms_arrow_type_name(col.type) + ", not "
+                + tms_arrow_type_name(tms_arrow_type<T>()));
+        const Chunk & k = chunk(b, c);
+        const std::uint64_t n = _lengths[b];
+        // Division, not n * sizeof(T): n comes from the file
+        const bool shortData = std::is_same<T, bool>::value
+                               ? k.dataLen < (n + 7) / 8
+                               : n > k.dataLen / sizeof(T);
+        if (shortData || (k.nulls > 0 && k.validLen < (n + 7) / 8))
+            bad("column " + col.name + ": buffer too short");
+        return k;
+    }
+
+
+    // gather
+    // Batches [first, last) of column c into out and *valid
+    template <typename T>
+    void gather(size_type first, size_type last, size_type c,
+                TMSArray<T> & out, TMSArray<bool> * valid) const
+    {
+        size_type total = 0;
+        for (size_type b = first; b < last; ++b)
+        {
+            checked<T>(b, c);
+            if (_lengths[b] > size_type(-1) - total)
+                bad("row count overflow");
+            total += size_type(_lengths[b]);
+        }
+        TMSArray<T> values(total);
+        TMSArray<bool> flags;
+        if (valid != nullptr)
+            flags.resize(total);
+        size_type at = 0;
+        for (size_type b = first; b < last; ++b)
+        {
+            const Chunk & k = chunk(b, c);
+            const size_type n = size_type(_lengths[b]);
+            copyValues(base() + k.dataOff, n, values, at);
+            if (valid != nullptr)
+            {
+                if (k.nulls > 0)
+                    tms_arrow_bits_copy(base() + k.validOff, n, flags.words(),
+                                        at);
+                else
+                    tms_arrow_bits_set(flags.words(), at, n);
+            }
+            at += n;
+        }
+        out.swap(values);
+        if (valid != nullptr)
+            valid->swap(flags);
+    }
+
+
+    template <typename T>
+    static void copyValues(const unsigned char * src, size_type n,
+                           TMSArray<T> & out, size_type at) noexcept
+    {
+        std::memcpy(out.begin() + at, src, n * sizeof(T));
+    }
+
+    static void copyValues(const unsigned char * src, size_type n,
+                           TMSArray<bool> & out, size_type at) noexcept
+    {
+        tms_arrow_bits_copy(src, n, out.words(), at);
+    }
+
+
+    // readFooter
+    // Footer, schema, then each batch's RecordBatch metadata
+    void readFooter()
+    {
+        const unsigned char * p = base();
+        const std::uint64_t n = _mapLen;
+        if (std::memcmp(p, TMS_ARROW_MAGIC, 6) != 0
+            || std::memcmp(p + n - 6, TMS_ARROW_MAGIC, 6) != 0)
+            bad("not an Arrow file");
+        std::int32_t footLen;
+        std::memcpy(&footLen, p + n - 10, 4);
+        if (footLen <= 0 || std::uint64_t(footLen) > n - 18)
+            bad("bad footer length");
+        const TMSFlatTable footer(p + n - 10 - footLen, std::size_t(footLen),
+                                  _path);
+
+        const TMSFlatTable schema = footer.table(1);
+        if (schema.scalar<std::int16_t>(0, 0) != 0)
+            bad("big-endian data is not supported");
+        std::size_t count;
+        const std::size_t fields = schema.vector(1, 4, count);
+        for (std::size_t i = 0; i < count; ++i)
+            _columns.push_back(readField(schema.element(fields, i)));
+        std::size_t dictCount;
+        footer.vector(2, 24, dictCount);
+        if (dictCount > 0)
+            bad("dictionary batches are not supported");
+
+        std::size_t blockCount;
+        const std::size_t blocks = footer.vector(3, 24, blockCount);
+        const unsigned char * fp = p + n - 10 - footLen;
+        for (std::size_t i = 0; i < blockCount; ++i)
+        {
+            std::int64_t off, body;
+            std::int32_t meta;
+            std::memcpy(&off, fp + blocks + 24 * i, 8);
+            std::memcpy(&meta, fp + blocks + 24 * i + 8, 4);
+            std::memcpy(&body, fp + blocks + 24 * i + 16, 8);
+            readBatch(std::uint64_t(off), std::uint64_t(meta),
+                      std::uint64_t(body));
+        }
+    }
+
+
+    // readField
+    // A Field table: name and type, and how many buffers it has
+    Column readField(const TMSFlatTable & f) const
+    {
+        Column col;
+        col.name = f.string(0);
+        const std::uint8_t tag = f.scalar<std::uint8_t>(2, 0);
+        col.type = TMSArrowType{ tag, 0, false };
+        col.readable = false;
+        if (f.has(4))
+            bad("column " + col.name + " is dictionary-encoded");
+        std::size_t children;
+        f.vector(5, 4, children);
+        switch (tag)
+        {
+        case 1:                                         // Null
+            col.buffers = 0;
+            break;
+        case TMS_ARROW_INT:
+        {
+            const TMSFlatTable t = f.table(3);
+            col.type.bits = unsigned(t.scalar<std::int32_t>(0, 0));
+            col.type.isSigned = t.scalar<std::uint8_t>(1, 0) != 0;
+            col.readable = col.type.bits == 8 || col.type.bits == 16
+                           || col.type.bits == 32 || col.type.bits == 64;
+            col.buffers = 2;
+            break;
+        }
+        case TMS_ARROW_FLOAT:
+        {
+            const int precision = f.table(3).scalar<std::int16_t>(0, 0);
+            col.type.bits = precision == 2 ? 64 : precision == 1 ? 32 : 16;
+            col.type.isSigned = true;
+            col.readable = precision != 0;
+            col.buffers = 2;
+            break;
+        }
+        case TMS_ARROW_BOOL:
+            col.type.bits = 1;
+            col.readable = true;
+            col.buffers = 2;
+            break;
+        case 7: case 8: case 9: case 10: case 11: case 15: case 18:
+            col.buffers = 2;                            // fixed width
+            break;
+        case 4: case 5: case 19: case 20:
+            col.buffers = 3;                            // offsets, data
+            break;
+        default:
+            bad("column " + col.name + " has a nested or unsupported type");
+        }
+        if (children > 0)
+            bad("column " + col.name + " has children");
+        return col;
+    }
+
+
+    // readBatch
+    // The RecordBatch message at off: its nodes and buffers
+    void readBatch(std::uint64_t off, std::uint64_t meta, std::uint64_t body)
+    {
+        const unsigned char * p = base();
+        const std::uint64_t n = _mapLen;
+        if (off > n || meta < 8 || meta > n - off || body > n - off - meta)
+            bad("batch out of range");
+        std::uint64_t skip = 4;
+        std::int32_t len;
+        std::memcpy(&len, p + off, 4);
+        if (len == -1)                                  // continuation
+        {
+            std::memcpy(&len, p + off + 4, 4);
+            skip = 8;
+        }
+        if (len < 0 || std::uint64_t(len) > meta - skip)
+            bad("bad message length");
+        const TMSFlatTable msg(p + off + skip, std::size_t(len), _path);
+        if (msg.scalar<std::uint8_t>(1, 0) != 3)
+            bad("block is not a record batch");
+        const TMSFlatTable rb = msg.table(2);
+        if (rb.has(3))
+            bad("compressed record batches are not supported");
+        const std::int64_t rows = rb.scalar<std::int64_t>(0, 0);
+        std::size_t nodeCount, bufCount;
+        const std::size_t nodes = rb.vector(1, 16, nodeCount);
+        const std::size_t bufs = rb.vector(2, 16, bufCount);
+        if (rows < 0 || nodeCount != _columns.size())
+            bad("record batch does not match the schema");
+        // Every column needs at least a bit per row in the body
+        if (!_columns.empty() && std::uint64_t(rows) > body * 8)
+            bad("record batch row count exceeds its body");
+
+        const std::uint64_t bodyStart = off + meta;
+        std::size_t next = 0;
+        for (std::size_t c = 0; c < _columns.size(); ++c)
+        {
+            Chunk k = Chunk{ 0, 0, 0, 0, 0 };
+            const std::int64_t length = rb.get<std::int64_t>(nodes + 16 * c);
+            const std::int64_t nulls = rb.get<std::int64_t>(nodes + 16 * c + 8);
+            if (length != rows || nulls < 0 || nulls > rows)
+                bad("record batch does not match the schema");
+            k.nulls = std::uint64_t(nulls);
+            if (next + _columns[c].buffers > bufCount)
+                bad("record batch does not match the schema");
+            std::uint64_t where[3][2] = {};
+            for (unsigned j = 0; j < _columns[c].buffers; ++j, ++next)
+            {
+                const std::int64_t bo = rb.get<std::int64_t>(bufs + 16 * next);
+                const std::int64_t bl = rb.get<std::int64_t>(bufs + 16 * next + 8);
+                if (bo < 0 || bl < 0 || std::uint64_t(bo) > body
+                    || std::uint64_t(bl) > body - std::uint64_t(bo))
+                    bad("buffer out of range");
+                where[j][0] = bodyStart + std::uint64_t(bo);
+                where[j][1] = std::uint64_t(bl);
+            }
+            k.validOff = where[0][0];
+            k.validLen = where[0][1];
+            k.dataOff = where[1][0];
+            k.dataLen = where[1][1];
+            _chunks.push_back(k);
+        }
+        _lengths.push_back(std::uint64_t(rows));
+    }
+
+
+// ***** TMSArrowReader: data members *****
+private:
+
+    std::string             _path;
+    void *                  _map;
+    size_type               _mapLen;
+    TMSArray<Column>        _columns;
+    TMSArray<std::uint64_t> _lengths;       // rows in each batch
+    TMSArray<Chunk>         _chunks;
+
+}; // end of class
+
@@ -0,0 +1,151 @@
+// tmsarrow_bench.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Benchmark: Arrow IPC export of three TMSArray columns (int64, double,
+//  float with a validity bitmap) in record batches of several sizes;
+//  import by load (copy) and by zero-copy view; tms_save/tms_load of
+//  the same columns as the baseline.
+// Usage: tmsarrow_bench [rows=8388608] [dir=/tmp]
+// Requires tmsarrow.hpp, tmsserial.hpp, tmscrc32.hpp, tmssimd.hpp,
+//  tmsarray.hpp, tmsbench.hpp
+
+#include "tmsarrow.hpp"
+#include "tmsbench.hpp"
+
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::int64_t;
+using std::uint64_t;
+#include <cstdio>
+using std::remove;
+#include <algorithm>
+using std::min;
+#include <iostream>
+using std::cout;
+#include <string>
+using std::string;
+using std::to_string;
+
+
+int main(int argc, char * argv[])
+{
+    const size_t n = tms_arg(argc, argv, 1, size_t(1) << 23);
+    const string dir = argc > 2 ? argv[2] : "/tmp";
+    const string path = dir + "/tmsarrow_bench.arrow";
+    const string tmsPath = dir + "/tmsarrow_bench.tms";
+    const size_t bytes = n * (sizeof(int64_t) + sizeof(double) + sizeof(float));
+
+    TMSArray<int64_t> ids(n);
+    TMSArray<double> prices(n);
+    TMSArray<float> scores(n);
+    TMSArray<bool> valid(n);
+    uint64_t x = 88172645463325252ull;
+    for (size_t i = 0; i < n; ++i)
+    {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        ids[i] = int64_t(i);
+        prices[i] = double(x >> 11) * 0x1p-53;
+        scores[i] = float(x & 0xFFFF);
+        valid[i] = (x >> 60) != 0;
+    }
+    cout << n << " rows of int64, double, float + validity (" << bytes
+         << " bytes), files in " << dir << ", page cache warm\n";
+
+    double secs = tms_time_best(3, [&]
+    {
+        tms_save(ids, tmsPath + "0");
+        tms_save(prices, tmsPath + "1");
+        tms_save(scores, tmsPath + "2");
+    });
+    tms_report("save tms_save x3 (baseline)", secs, bytes);
+    TMSArray<int64_t> ids2;
+    TMSArray<double> prices2;
+    TMSArray<float> scores2;
+    secs = tms_time_best(3, [&]
+    {
+        tms_load(tmsPath + "0", ids2);
+        tms_load(tmsPath + "1", prices2);
+        tms_load(tmsPath + "2", scores2);
+        tms_sink(scores2[n - 1]);
+    });
+    tms_report("load tms_load x3 (baseline)", secs, bytes);
+
+    // Batches refer to slices of the columns, copied once outside the
+    //  timing
+    for (size_t batchRows : { size_t(1) << 16, size_t(1) << 20, n })
+    {
+        const size_t batches = (n + batchRows - 1) / batchRows;
+        TMSArray<TMSArray<int64_t>> bi(batches);
+        TMSArray<TMSArray<double>> bp(batches);
+        TMSArray<TMSArray<float>> bs(batches);
+        TMSArray<TMSArray<bool>> bv(batches);
+        for (size_t k = 0; k < batches; ++k)
+        {
+            const size_t lo = k * batchRows, m = min(batchRows, n - lo);
+            bi[k].resize(m), bp[k].resize(m), bs[k].resize(m), bv[k].resize(m);
+            for (size_t i = 0; i < m; ++i)
+            {
+                bi[k][i] = ids[lo + i];
+                bp[k][i] = prices[lo + i];
+                bs[k][i] = scores[lo + i];
+                bv[k][i] = valid[lo + i];
+            }
+        }
+        secs = tms_time_best(3, [&]
+        {
+            TMSArrowWriter w(path);
+            for (size_t k = 0; k < batches; ++k)
+            {
+                TMSArrowBatch b;
+                b.add("id", bi[k]);
+                b.add("price", bp[k]);
+                b.add("score", bs[k], &bv[k]);
+                w.write(b);
+            }
+            w.close();
+        });
+        tms_report("write arrow, " + to_string(batches) + " batches", secs,
+                   bytes);
+    }
+
+    secs = tms_time_best(5, [&]
+    {
+        TMSArrowReader r(path);
+        tms_sink(r.rows());
+    });
+    tms_report("reader open (footer + metadata)", secs);
+    TMSArrowReader r(path);
+    secs = tms_time_best(3, [&]
+    {
+        TMSArray<bool> v;
+        r.load_column(0, ids2);
+        r.load_column(1, prices2);
+        r.load_column(2, scores2, &v);
+        tms_sink(v.count());
+    });
+    tms_report("load_column x3 (copy)", secs, bytes);
+    secs = tms_time_best(5, [&]
+    {
+        TMSArrayView<double> view = r.view<double>(0, 1);
+        tms_sink(view.size());
+    });
+    tms_report("view open+close", secs);
+    secs = tms_time_best(3, [&]
+    {
+        TMSArrayView<double> view = r.view<double>(0, 1);
+        double sum = 0;
+        for (double v : view)
+            sum += v;
+        tms_sink(sum);
+    });
+    tms_report("view open+first scan (double)", secs, n * sizeof(double));
+
+    remove(path.c_str());
+    for (char k : { '0', '1', '2' })
+        remove((tmsPath + k).c_str());
+    return 0;
+}
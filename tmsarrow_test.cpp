@@ -0,0 +1,610 @@
+// tmsarrow_test.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Test program for class TMSArrowWriter, class TMSArrowReader and the
+//  flatbuffer helpers TMSFlatBuilder and TMSFlatTable
+// Uses the "doctest" unit-testing framework, version 2
+// Requires doctest.h, tmsarrow.hpp, tmsserial.hpp, tmscrc32.hpp,
+//  tmssimd.hpp, tmsarray.hpp
+
+// Includes for code to be tested
+#include "tmsarrow.hpp"      // For TMSArrowWriter, TMSArrowReader
+#include "tmsarrow.hpp"      // Double-inclusion check, for testing only
+
+// Includes for the "doctest" unit-testing framework
+#define DOCTEST_CONFIG_IMPLEMENT
+                             // We write our own main
+#define DOCTEST_CONFIG_SUPER_FAST_ASSERTS
+                             // Reduce compile time
+#include "doctest.h"         // For doctest
+
+// Includes for all test programs
+#include <iostream>
+using std::cout;
+using std::endl;
+using std::cin;
+#include <string>
+using std::string;
+
+// Additional includes for this test program
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::int8_t;
+using std::int16_t;
+using std::int32_t;
+using std::int64_t;
+using std::uint8_t;
+using std::uint16_t;
+using std::uint32_t;
+using std::uint64_t;
+using std::uintptr_t;
+#include <cstdio>
+using std::remove;
+#include <algorithm>
+using std::equal;
+#include <stdexcept>
+using std::runtime_error;
+using std::invalid_argument;
+#include <system_error>
+using std::system_error;
+#include <unistd.h>          // For getpid
+
+// Printable name for this test suite
+const string test_suite_name =
+    "TMSArrowWriter, TMSArrowReader, TMSFlatBuilder and TMSFlatTable";
+
+
+// *********************************************************************
+// Golden Files
+// *********************************************************************
+
+
+// Written by pyarrow 26.0 (pyarrow.ipc.new_file), two record batches:
+//  a: int32     [1, null, 3]          [4, 5]
+//  d: double    [0.5, 1.5, 2.5]       [3.5, 4.5]
+//  f: bool      [true, false, true]   [false, true]
+//  s: string    ["x", "yy", "z"]      ["p", null]
+// pyarrow pads buffers to 8 bytes and writes no validity buffer for a
+//  column without nulls.
+const char goldenPyarrow[] =
+    "4152524f57310000ffffffff000100001000000000000a000c00060005000800"
+    "0a000000000104000c0000000800080000000400080000000400000004000000"
+    "98000000580000002c0000000400000088ffffff000001051000000014000000"
+    "04000000000000000100000073000000dcffffffacffffff0000010610000000"
+    "18000000040000000000000001000000660000000400040004000000d4ffffff"
+    "0000010310000000180000000400000000000000010000006400060008000600"
+    "0600000000000200100014000800060007000c00000010001000000000000102"
+    "100000001c0000000400000000000000010000006100000008000c0008000700"
+    "08000000000000012000000000000000ffffffff280100001400000000000000"
+    "0c0016000600050008000c000c00000000030400180000005000000000000000"
+    "00000a0018000c00040008000a000000ac000000100000000300000000000000"
+    "0000000009000000000000000000000001000000000000000800000000000000"
+    "0c00000000000000180000000000000000000000000000001800000000000000"
+    "1800000000000000300000000000000000000000000000003000000000000000"
+    "0100000000000000380000000000000000000000000000003800000000000000"
+    "1000000000000000480000000000000004000000000000000000000004000000"
+    "0300000000000000010000000000000003000000000000000000000000000000"
+    "0300000000000000000000000000000003000000000000000000000000000000"
+    "050000000000000001000000000000000300000000000000000000000000e03f"
+    "000000000000f83f000000000000044005000000000000000000000001000000"
+    "03000000040000007879797a00000000ffffffff280100001400000000000000"
+    "0c0016000600050008000c000c00000000030400180000004000000000000000"
+    "00000a0018000c00040008000a000000ac000000100000000200000000000000"
+    "0000000009000000000000000000000000000000000000000000000000000000"
+    "0800000000000000080000000000000000000000000000000800000000000000"
+    "1000000000000000180000000000000000000000000000001800000000000000"
+    "0100000000000000200000000000000001000000000000002800000000000000"
+    "0c00000000000000380000000000000001000000000000000000000004000000"
+    "0200000000000000000000000000000002000000000000000000000000000000"
+    "0200000000000000000000000000000002000000000000000100000000000000"
+    "04000000050000000000000000000c4000000000000012400200000000000000"
+    "0100000000000000000000000100000001000000000000007000000000000000"
+    "ffffffff00000000100000000c001400060008000c0010000c00000000000400"
+    "5000000040000000040000000200000010010000000000003001000000000000"
+    "5000000000000000900200000000000030010000000000004000000000000000"
+    "0000000000000000080008000000040008000000040000000400000098000000"
+    "580000002c0000000400000088ffffff00000105100000001400000004000000"
+    "000000000100000073000000dcffffffacffffff000001061000000018000000"
+    "040000000000000001000000660000000400040004000000d4ffffff00000103"
+    "1000000018000000040000000000000001000000640006000800060006000000"
+    "00000200100014000800060007000c0000001000100000000000010210000000"
+    "1c0000000400000000000000010000006100000008000c000800070008000000"
+    "0000000120000000400100004152524f5731";
+
+
+// Expected output of TMSArrowWriter for one batch of one column,
+//  x: int16 [1, null, 3]; checked with pyarrow's full validation.
+const char goldenWriter[] =
+    "4152524f57310000ffffffff8800000014000000000000000c00140006000500"
+    "08000c000c0000000001040014000000000000000000000008000c000a000400"
+    "08000000080000000000000001000000140000001000140010000f000e000800"
+    "00000400100000002400000014000000000002011c00000008000c0008000700"
+    "080000000000000110000000000000000100000078000000ffffffffa0000000"
+    "14000000000000000c0016000600050008000c000c0000000003040018000000"
+    "800000000000000000000a0018000c00080004000a0000001400000038000000"
+    "0300000000000000000000000200000000000000000000000100000000000000"
+    "4000000000000000060000000000000000000000010000000300000000000000"
+    "0100000000000000000000000000000000000000000000000000000000000000"
+    "0500000000000000000000000000000000000000000000000000000000000000"
+    "0000000000000000000000000000000000000000000000000000000000000000"
+    "0100feff03000000000000000000000000000000000000000000000000000000"
+    "0000000000000000000000000000000000000000000000000000000000000000"
+    "ffffffff00000000100000000c00140012000c00080004000c00000078000000"
+    "6c000000100000000000040008000c000a000400080000000800000000000000"
+    "01000000140000001000140010000f000e000800000004001000000024000000"
+    "14000000000002011c00000008000c0008000700080000000000000110000000"
+    "0000000001000000780000000000000000000000010000009800000000000000"
+    "a8000000000000008000000000000000a80000004152524f5731";
+
+
+// *********************************************************************
+// Helper Functions for This Test Program
+// *********************************************************************
+
+
+// tempPath
+// A per-process scratch file name under /tmp
+string tempPath(const string & tag)
+{
+    return "/tmp/tmsarrow_test_" + std::to_string(getpid()) + "_" + tag;
+}
+
+
+// unhex
+// Bytes of a string of hex digit pairs
+string unhex(const char * hex)
+{
+    string out;
+    for (; hex[0] != '\0' && hex[1] != '\0'; hex += 2)
+    {
+        auto digit = [](char c) { return c <= '9' ? c - '0' : c - 'a' + 10; };
+        out += char(digit(hex[0]) * 16 + digit(hex[1]));
+    }
+    return out;
+}
+
+
+// writeFile
+// Creates path holding exactly the given bytes
+void writeFile(const string & path, const string & bytes)
+{
+    TMSFd file(::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644));
+    REQUIRE( file.fd >= 0 );
+    REQUIRE( ::pwrite(file.fd, bytes.data(), bytes.size(), 0)
+             == ssize_t(bytes.size()) );
+}
+
+
+// readFile
+// Whole contents of path
+string readFile(const string & path)
+{
+    TMSFd file(::open(path.c_str(), O_RDONLY));
+    REQUIRE( file.fd >= 0 );
+    struct stat st;
+    REQUIRE( ::fstat(file.fd, &st) == 0 );
+    string bytes(size_t(st.st_size), '\0');
+    REQUIRE( ::pread(file.fd, &bytes[0], bytes.size(), 0)
+             == ssize_t(bytes.size()) );
+    return bytes;
+}
+
+
+// fillRandom
+// Deterministic pseudo-random values
+template <typename T>
+void fillRandom(TMSArray<T> & ta, uint64_t seed)
+{
+    uint64_t x = seed * 0x9E3779B97F4A7C15ull + 1;
+    for (size_t i = 0; i < ta.size(); ++i)
+    {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        ta[i] = T(x);
+    }
+}
+
+
+// *********************************************************************
+// Test Cases
+// *********************************************************************
+
+
+TEST_CASE( "Flatbuffer build and read back" )
+{
+    TMSFlatBuilder fb;
+    const int64_t pairs[4] = { 10, 20, 30, 40 };
+    const auto vec = fb.create_struct_vector(pairs, 16, 2, 8);
+    const auto name = fb.create_string("hello");
+    fb.start_table();
+    fb.add<int32_t>(0, 7);
+    const auto inner = fb.end_table();
+    const TMSFlatBuilder::offset list[2] = { inner, inner };
+    const auto tables = fb.create_offset_vector(list, 2);
+    fb.start_table();
+    fb.add<int64_t>(4, -5);
+    fb.add_offset(1, name);
+    fb.add<uint8_t>(0, 1);
+    fb.add_offset(2, vec);
+    fb.add_offset(6, tables);
+    fb.finish(fb.end_table());
+    REQUIRE( fb.size() % 8 == 0 );
+
+    const string buf(fb.data(), fb.size());
+    const TMSFlatTable t(reinterpret_cast<const unsigned char *>(buf.data()),
+                         buf.size(), "buf");
+    REQUIRE( t.scalar<uint8_t>(0, 0) == 1 );
+    REQUIRE( t.string(1) == "hello" );
+    REQUIRE( t.scalar<int64_t>(4, 0) == -5 );
+    REQUIRE( !t.has(3) );
+    REQUIRE( t.scalar<int16_t>(3, 99) == 99 );
+    REQUIRE( t.scalar<int16_t>(40, 98) == 98 );
+    size_t n;
+    const size_t at = t.vector(2, 16, n);
+    REQUIRE( n == 2 );
+    REQUIRE( at % 8 == 0 );
+    REQUIRE( t.get<int64_t>(at + 24) == 40 );
+    const size_t tv = t.vector(6, 4, n);
+    REQUIRE( n == 2 );
+    REQUIRE( t.element(tv, 1).scalar<int32_t>(0, 0) == 7 );
+    REQUIRE_THROWS_AS( t.table(3), runtime_error );
+    REQUIRE_THROWS_AS( TMSFlatTable(reinterpret_cast<const unsigned char *>(
+                           buf.data()), 3, "short"), runtime_error );
+}
+
+
+TEST_CASE( "Bitmap helpers" )
+{
+    uint64_t words[3] = {};
+    tms_arrow_bits_set(words, 60, 70);
+    REQUIRE( words[0] == 0xF000000000000000ull );
+    REQUIRE( words[1] == ~0ull );
+    REQUIRE( words[2] == 0x3ull );
+    uint64_t out[3] = {};
+    const unsigned char src[9] = { 0xA5, 0xFF, 0x00, 0x0F, 0xF0, 0x5A, 0x3C,
+                                   0xC3, 0xFF };
+    tms_arrow_bits_copy(src, 68, out, 61);
+    for (size_t i = 0; i < 68; ++i)
+        REQUIRE( ((out[(61 + i) / 64] >> ((61 + i) % 64)) & 1)
+                 == unsigned((src[i / 8] >> (i % 8)) & 1) );
+    REQUIRE( (out[0] & ((1ull << 61) - 1)) == 0 );
+    REQUIRE( (out[2] >> 1) == 0 );
+}
+
+
+TEST_CASE( "Reading a file written by pyarrow" )
+{
+    const string path = tempPath("py");
+    writeFile(path, unhex(goldenPyarrow));
+    TMSArrowReader r(path);
+    REQUIRE( r.columns() == 4 );
+    REQUIRE( r.batches() == 2 );
+    REQUIRE( r.rows(0) == 3 );
+    REQUIRE( r.rows() == 5 );
+    REQUIRE( r.name(3) == "s" );
+    REQUIRE( r.column("f") == 2 );
+    REQUIRE( tms_arrow_type_name(r.type(0)) == "int32" );
+    REQUIRE( tms_arrow_type_name(r.type(1)) == "double" );
+    REQUIRE( r.null_count(0, 0) == 1 );
+    REQUIRE( r.null_count(1, 3) == 1 );
+    REQUIRE_THROWS_AS( r.column("zz"), runtime_error );
+
+    TMSArray<int32_t> a;
+    TMSArray<bool> valid;
+    r.load_column(0, a, &valid);
+    REQUIRE( a.size() == 5 );
+    REQUIRE( valid.count() == 4 );
+    REQUIRE( !valid[1] );
+    REQUIRE( a[0] == 1 );
+    REQUIRE( a[2] == 3 );
+    REQUIRE( a[4] == 5 );
+
+    TMSArrayView<double> d = r.view<double>(1, 1);
+    REQUIRE( d.size() == 2 );
+    REQUIRE( d[0] == 3.5 );
+    REQUIRE( d[1] == 4.5 );
+
+    TMSArray<bool> f;
+    r.load(0, 2, f, &valid);
+    REQUIRE( f.size() == 3 );
+    REQUIRE( f.count() == 2 );
+    REQUIRE( !f[1] );
+    REQUIRE( valid.count() == 3 );
+
+    SUBCASE( "Type mismatches and unreadable columns" )
+    {
+        TMSArray<int64_t> wide;
+        REQUIRE_THROWS_AS( r.load(0, 0, wide), runtime_error );
+        REQUIRE_THROWS_AS( r.view<float>(0, 1), runtime_error );
+        TMSArray<uint8_t> bytes;
+        REQUIRE_THROWS_AS( r.load_column(3, bytes), runtime_error );
+        REQUIRE( wide.size() == 0 );
+    }
+    remove(path.c_str());
+}
+
+
+TEST_CASE( "Writer output matches the golden file" )
+{
+    const string path = tempPath("gold");
+    TMSArray<int16_t> x(static_cast<size_t>(3));
+    x[0] = 1, x[1] = -2, x[2] = 3;
+    TMSArray<bool> valid(static_cast<size_t>(3));
+    valid[0] = true, valid[2] = true;
+    {
+        TMSArrowWriter w(path);
+        TMSArrowBatch b;
+        b.add("x", x, &valid);
+        w.write(b);
+    }
+    const string bytes = readFile(path);
+    REQUIRE( bytes == unhex(goldenWriter) );
+    REQUIRE( bytes.compare(0, 6, "ARROW1") == 0 );
+    REQUIRE( bytes.compare(bytes.size() - 6, 6, "ARROW1") == 0 );
+    remove(path.c_str());
+}
+
+
+TEST_CASE( "Round trips" )
+{
+    const string path = tempPath("rt");
+    const size_t sizes[3] = { 100, 37, 1000 };
+    TMSArray<double> d[3];
+    TMSArray<float> f[3];
+    TMSArray<int64_t> l[3];
+    TMSArray<uint16_t> s[3];
+    TMSArray<int8_t> c[3];
+    TMSArray<bool> b[3];
+    TMSArray<bool> v[3];
+    {
+        TMSArrowWriter w(path);
+        for (size_t k = 0; k < 3; ++k)
+        {
+            const size_t n = sizes[k];
+            d[k].resize(n), f[k].resize(n), l[k].resize(n), s[k].resize(n);
+            c[k].resize(n), b[k].resize(n), v[k].resize(n);
+            fillRandom(d[k], k + 1);
+            fillRandom(f[k], k + 2);
+            fillRandom(l[k], k + 3);
+            fillRandom(s[k], k + 4);
+            fillRandom(c[k], k + 5);
+            for (size_t i = 0; i < n; ++i)
+            {
+                b[k][i] = (i * 7 + k) % 3 == 0;
+                v[k][i] = (i + k) % 5 != 0;
+            }
+            TMSArrowBatch batch;
+            batch.add("d", d[k]);
+            batch.add("f", f[k], &v[k]);
+            batch.add("l", l[k]);
+            batch.add("s", s[k], &v[k]);
+            batch.add("c", c[k]);
+            batch.add("b", b[k], &v[k]);
+            REQUIRE( batch.rows() == n );
+            REQUIRE( batch.columns() == 6 );
+            w.write(batch);
+        }
+        REQUIRE( w.batches() == 3 );
+    }
+
+    TMSArrowReader r(path);
+    REQUIRE( r.columns() == 6 );
+    REQUIRE( r.batches() == 3 );
+    REQUIRE( r.rows() == 1137 );
+    for (size_t k = 0; k < 3; ++k)
+    {
+        TMSArray<double> d2;
+        r.load(k, 0, d2);
+        REQUIRE( equal(d2.begin(), d2.end(), d[k].begin()) );
+        TMSArray<float> f2;
+        TMSArray<bool> v2;
+        r.load(k, 1, f2, &v2);
+        REQUIRE( equal(f2.begin(), f2.end(), f[k].begin()) );
+        REQUIRE( equal(v2.begin(), v2.end(), v[k].begin()) );
+        TMSArrayView<int64_t> l2 = r.view<int64_t>(k, 2);
+        REQUIRE( equal(l2.begin(), l2.end(), l[k].begin()) );
+        REQUIRE( reinterpret_cast<uintptr_t>(l2.begin()) % TMS_ARROW_ALIGN == 0 );
+        TMSArrayView<uint16_t> s2 = r.view<uint16_t>(k, 3);
+        REQUIRE( equal(s2.begin(), s2.end(), s[k].begin()) );
+        REQUIRE( reinterpret_cast<uintptr_t>(s2.begin()) % TMS_ARROW_ALIGN == 0 );
+        TMSArray<bool> b2;
+        r.load(k, 5, b2);
+        REQUIRE( equal(b2.begin(), b2.end(), b[k].begin()) );
+        REQUIRE( r.null_count(k, 0) == 0 );
+        REQUIRE( r.null_count(k, 5) == v[k].size() - v[k].count() );
+    }
+
+    // Across batches: bitmaps land at bit offsets 100 and 137
+    TMSArray<bool> all, valid;
+    r.load_column(5, all, &valid);
+    REQUIRE( all.size() == 1137 );
+    size_t at = 0;
+    for (size_t k = 0; k < 3; ++k)
+        for (size_t i = 0; i < sizes[k]; ++i, ++at)
+        {
+            REQUIRE( all[at] == b[k][i] );
+            REQUIRE( valid[at] == v[k][i] );
+        }
+    TMSArray<int8_t> chars;
+    r.load_column(4, chars, &valid);
+    REQUIRE( chars[136] == c[1][36] );
+    REQUIRE( valid.count() == 1137 );
+    remove(path.c_str());
+}
+
+
+TEST_CASE( "Writer misuse" )
+{
+    const string path = tempPath("misuse");
+    TMSArray<int32_t> a(static_cast<size_t>(4));
+    TMSArray<int32_t> b(static_cast<size_t>(5));
+    TMSArray<float> f(static_cast<size_t>(4));
+    TMSArray<bool> v(static_cast<size_t>(5));
+
+    TMSArrowBatch batch;
+    batch.add("a", a);
+    REQUIRE_THROWS_AS( batch.add("b", b), invalid_argument );
+    REQUIRE_THROWS_AS( batch.add("a", a), invalid_argument );
+    REQUIRE_THROWS_AS( batch.add("c", a, &v), invalid_argument );
+    REQUIRE( batch.columns() == 1 );
+
+    TMSArrowWriter w(path);
+    w.write(batch);
+    TMSArrowBatch other;
+    other.add("a", f);
+    REQUIRE_THROWS_AS( w.write(other), invalid_argument );
+    TMSArrowBatch renamed;
+    renamed.add("z", a);
+    REQUIRE_THROWS_AS( w.write(renamed), invalid_argument );
+    w.close();
+    REQUIRE_THROWS_AS( w.write(batch), runtime_error );
+
+    TMSArrowReader r(path);
+    REQUIRE( r.batches() == 1 );
+    remove(path.c_str());
+}
+
+
+TEST_CASE( "Files with no batches" )
+{
+    const string path = tempPath("empty");
+    {
+        TMSArrowWriter w(path);
+    }
+    {
+        TMSArrowReader r(path);
+        REQUIRE( r.columns() == 0 );
+        REQUIRE( r.batches() == 0 );
+        REQUIRE( r.rows() == 0 );
+    }
+    TMSArray<double> none;
+    {
+        TMSArrowWriter w(path);
+        TMSArrowBatch batch;
+        batch.add("x", none);
+        w.write(batch);
+    }
+    TMSArrowReader r(path);
+    REQUIRE( r.columns() == 1 );
+    REQUIRE( r.rows(0) == 0 );
+    REQUIRE( r.view<double>(0, 0).size() == 0 );
+    remove(path.c_str());
+}
+
+
+TEST_CASE( "Reader rejects bad files" )
+{
+    const string path = tempPath("bad");
+    SUBCASE( "Not Arrow" )
+    {
+        writeFile(path, string(100, 'x'));
+        REQUIRE_THROWS_AS( TMSArrowReader r(path), runtime_error );
+    }
+    SUBCASE( "Too short" )
+    {
+        writeFile(path, "ARROW1");
+        REQUIRE_THROWS_AS( TMSArrowReader r(path), runtime_error );
+    }
+    SUBCASE( "Truncated" )
+    {
+        const string bytes = unhex(goldenPyarrow);
+        writeFile(path, bytes.substr(0, 600) + bytes.substr(bytes.size() - 10));
+        REQUIRE_THROWS_AS( TMSArrowReader r(path), runtime_error );
+    }
+    SUBCASE( "Corrupt footer" )
+    {
+        string bytes = unhex(goldenPyarrow);
+        for (size_t i = bytes.size() - 200; i < bytes.size() - 10; ++i)
+            bytes[i] = '\x7F';
+        writeFile(path, bytes);
+        REQUIRE_THROWS_AS( TMSArrowReader r(path), runtime_error );
+    }
+    SUBCASE( "Row counts whose byte sizes overflow" )
+    {
+        // 8 one-row batches; every row count and node length (the only
+        //  aligned int64s equal to 1) patched to 2^61 + 1, so 8 bytes a
+        //  row wraps to 8 and the total row count wraps to 8
+        TMSArray<int64_t> x(static_cast<size_t>(1));
+        x[0] = 5;
+        {
+            TMSArrowWriter w(path);
+            for (int i = 0; i < 8; ++i)
+            {
+                TMSArrowBatch b;
+                b.add("x", x);
+                w.write(b);
+            }
+        }
+        string bytes = readFile(path);
+        const uint64_t one = 1, huge = (uint64_t(1) << 61) + 1;
+        int patched = 0;
+        for (size_t i = 0; i + 8 <= bytes.size(); i += 8)
+            if (bytes.compare(i, 8, reinterpret_cast<const char *>(&one), 8) == 0)
+            {
+                bytes.replace(i, 8, reinterpret_cast<const char *>(&huge), 8);
+                ++patched;
+            }
+        REQUIRE( patched == 16 );
+        writeFile(path, bytes);
+        REQUIRE_THROWS_AS( [&]
+        {
+            TMSArrowReader r(path);
+            TMSArray<int64_t> out;
+            TMSArray<bool> valid;
+            r.load_column(0, out, &valid);
+        }(), runtime_error );
+    }
+    SUBCASE( "Missing" )
+    {
+        REQUIRE_THROWS_AS( TMSArrowReader r(path + "_none"), system_error );
+    }
+    remove(path.c_str());
+}
+
+
+// *********************************************************************
+// Main Program
+// *********************************************************************
+
+
+// userPause
+// Wait for user to press ENTER: read all chars through first newline.
+void userPause()
+{
+    std::cout.flush();
+    while (std::cin.get() != '\n') ;
+}
+
+
+// Main program
+// Run all tests. Prompt for ENTER before exiting.
+int main(int argc,
+         char *argv[])
+{
+    doctest::Context dtcontext;
+                             // Primary doctest object
+    int dtresult;            // doctest return code; for return by main
+
+    // Handle command line
+    dtcontext.applyCommandLine(argc, argv);
+    dtresult = 0;            // doctest flags no command-line errors
+                             //  (strange but true)
+
+    if (!dtresult)           // Continue only if no command-line error
+    {
+        // Run test suites
+        cout << "BEGIN tests for " << test_suite_name << "\n" << endl;
+        dtresult = dtcontext.run();
+        cout << "END tests for " << test_suite_name << "\n" << endl;
+    }
+
+    // Wait for user
+    std::cout << "Press ENTER to quit ";
+    userPause();
+
+    // Program return value is return code from doctest
+    return dtresult;
+}
@@ -0,0 +1,111 @@
+// tmsbench.hpp
+// Matthew Johnson
+// 10/17/2026
+// small timing and reporting helpers shared by the *_bench.cpp programs
+
+#pragma once
+// for single inclusion
+
+#include <cstddef>
+// For std::size_t
+
+#include <cstdlib>
+// For std::strtoull
+
+#include <chrono>
+// For std::chrono::steady_clock
+
+#include <iostream>
+// For std::cout
+
+#include <iomanip>
+// For std::setw
+// For std::setprecision
+
+#include <string>
+// For std::string
+
+
+
+// tms_seconds_since
+// No-Throw Guarantee
+// Pre: None
+// Post:
+//      Returns seconds elapsed since start
+inline double tms_seconds_since(std::chrono::steady_clock::time_point start)
+    noexcept
+{
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+
+// tms_time_best
+// Basic Guarantee
+// Exception-Neutral
+// Pre:
+//      reps > 0
+//      func callable with no arguments
+// Post:
+//      Returns fastest of reps timed calls of func, in seconds
+template <typename Func>
+double tms_time_best(int reps, Func && func)
+{
+    double best = 0.0;
+    for (int rep = 0; rep < reps; ++rep)
+    {
+        auto start = std::chrono::steady_clock::now();
+        func();
+        double secs = tms_seconds_since(start);
+        if (rep == 0 || secs < best)
+            best = secs;
+    }
+    return best;
+}
+
+
+// tms_arg
+// No-Throw Guarantee
+// Pre:
+//      argv has argc entries
+// Post:
+//      Returns argv[index] parsed as an unsigned number, or fallback if
+//      there is no such argument
+inline std::size_t tms_arg(int argc, char * argv[], int index,
+                           std::size_t fallback) noexcept
+{
+    if (index >= argc)
+        return fallback;
+    return std::size_t(std::strtoull(argv[index], nullptr, 10));
+}
+
+
+// tms_report
+// Basic Guarantee
+// Pre: None
+// Post:
+//      One aligned row printed: label, time in us, and GB/s for bytes
+//      moved in that time (GB/s column omitted when bytes == 0)
+inline void tms_report(const std::string & label, double secs,
+                       std::size_t bytes = 0)
+{
+    std::cout << std::left << std::setw(36) << label << std::right
+              << std::fixed << std::setprecision(3)
+              << std::setw(14) << secs * 1e6 << " us";
+    if (bytes != 0)
+        std::cout << std::setw(10) << double(bytes) / secs / 1e9 << " GB/s";
+    std::cout << "\n";
+}
+
+
+// tms_sink
+// No-Throw Guarantee
+// Pre: None
+// Post:
+//      value is treated as used, so the computation producing it is not
+//      optimized away
+template <typename T>
+inline void tms_sink(const T & value) noexcept
+{
+    asm volatile("" : : "g"(&value) : "memory");
+}
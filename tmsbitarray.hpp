@@ -0,0 +1,803 @@
+// tmsbitarray.hpp
+// Matthew Johnson
+// 10/17/2026
+// bit-packed specialization TMSArray<bool>: one bit per flag, word-level
+//  insert/erase, popcount, find-first-set and AND/OR/XOR/ANDNOT
+// Included by tmsarray.hpp; include that header, not this one.
+
+#pragma once
+// for single inclusion
+
+#include "tmsarray.hpp"
+// For class template TMSArray (primary template)
+
+#include "tmssimd.hpp"
+// For tms_isa_limit
+// For TMS_SIMD_X86
+
+#include <cstddef>
+// For std::size_t
+// For std::ptrdiff_t
+
+#include <cstdint>
+// For std::uint64_t
+
+#include <algorithm>
+// For std::max
+// For std::copy
+// For std::fill
+// For std::swap
+
+#include <iterator>
+// For std::random_access_iterator_tag
+
+#include <type_traits>
+// For std::conditional
+// For std::enable_if
+// For std::integral_constant
+
+
+
+// tms_popcount_words
+// No-Throw Guarantee
+// Pre:
+//      words[0..n) valid
+// Post:
+//      Returns total set bits. Uses the POPCNT instruction when
+//      tms_isa_limit() allows AVX2 (every AVX2 CPU has POPCNT); a plain
+//      build otherwise gets the compiler's bit-twiddling fallback.
+#ifdef TMS_SIMD_X86
+__attribute__((target("popcnt")))
+inline std::size_t tms_popcount_words_hw(const std::uint64_t * words,
+                                         std::size_t n) noexcept
+{
+    std::size_t total = 0;
+    for (std::size_t w = 0; w < n; ++w)
+        total += std::size_t(__builtin_popcountll(words[w]));
+    return total;
+}
+#endif
+
+inline std::size_t tms_popcount_words(const std::uint64_t * words,
+                                      std::size_t n) noexcept
+{
+#ifdef TMS_SIMD_X86
+    if (tms_isa_limit() >= TMS_ISA_AVX2)
+        return tms_popcount_words_hw(words, n);
+#endif
+    std::size_t total = 0;
+    for (std::size_t w = 0; w < n; ++w)
+        total += std::size_t(__builtin_popcountll(words[w]));
+    return total;
+}
+
+
+
+// *********************************************************************
+// class TMSArray<bool> - Class definition
+// *********************************************************************
+
+
+// class TMSArray<bool>
+// Same interface as TMSArray, but flags are packed 64 to a word, so a
+//  bitmap costs 1/8 of the byte-per-bool memory and bandwidth. Element
+//  access goes through proxy references and iterators (as with
+//  std::vector<bool>, there are no bool* into the array).
+//  insert/erase shift whole words; count/find use popcount and
+//  count-trailing-zeros; &=, |=, ^= and and_not combine bitsets one word
+//  at a time.
+// Invariants:
+//     0 <= _size <= _capacity, _capacity a multiple of WORD_BITS.
+//     _words points to _capacity / WORD_BITS words allocated with new [],
+//      owned by *this -- UNLESS _capacity == 0, when it may be nullptr.
+//     Every bit at position >= _size is 0 (so whole-word popcounts and
+//      word-wise combines need no masking).
+template <>
+class TMSArray<bool>
+{
+
+public:
+
+
+    using value_type = bool;
+
+    using size_type  = std::size_t;
+
+    using word_type  = std::uint64_t;
+
+    enum { WORD_BITS = 64 };
+
+
+// ***** TMSArray<bool>: proxy reference and iterators *****
+public:
+
+
+    // class reference
+    // Stands in for bool& : reads and writes one bit of a word
+    class reference
+    {
+    public:
+
+        reference(word_type * word, word_type mask) noexcept
+            :_word(word),
+             _mask(mask)
+        {}
+
+        operator bool() const noexcept
+        {
+            return (*_word & _mask) != 0;
+        }
+
+        reference(const reference & other) noexcept = default;
+
+        reference & operator=(bool value) noexcept
+        {
+            *_word = (*_word & ~_mask) | (_mask & (word_type(0) - value));
+            return *this;
+        }
+
+        reference & operator=(const reference & other) noexcept
+        {
+            return *this = bool(other);
+        }
+
+        void flip() noexcept
+        {
+            *_word ^= _mask;
+        }
+
+    private:
+
+        word_type * _word;
+        word_type   _mask;
+
+    };
+
+
+    // class BitIterator
+    // Random-access iterator over bit positions; Const selects the
+    //  read-only flavor, whose operator* yields bool
+    template <bool Const>
+    class BitIterator
+    {
+    public:
+
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type        = bool;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = void;
+        using reference         = typename std::conditional<Const, bool,
+                                      TMSArray<bool>::reference>::type;
+        using word_pointer      = typename std::conditional<Const,
+                                      const word_type *, word_type *>::type;
+
+        BitIterator() noexcept
+            :_words(nullptr),
+             _pos(0)
+        {}
+
+        BitIterator(word_pointer words, size_type pos) noexcept
+            :_words(words),
+             _pos(pos)
+        {}
+
+        // non-const converts to const
+        template <bool C, typename = typename std::enable_if<Const && !C>::type>
+        BitIterator(const BitIterator<C> & other) noexcept
+            :_words(other.words()),
+             _pos(other.index())
+        {}
+
+        // words
+        // Returns the packed storage this iterator walks
+        word_pointer words() const noexcept
+        {
+            return _words;
+        }
+
+        // index
+        // Returns the bit position this iterator refers to
+        size_type index() const noexcept
+        {
+            return _pos;
+        }
+
+        reference operator*() const noexcept
+        {
+            return deref(std::integral_constant<bool, Const>());
+        }
+
+        reference operator[](difference_type n) const noexcept
+        {
+            return *(*this + n);
+        }
+
+        BitIterator & operator++() noexcept { ++_pos; return *this; }
+        BitIterator & operator--() noexcept { --_pos; return *this; }
+        BitIterator operator++(int) noexcept { auto t = *this; ++_pos; return t; }
+        BitIterator operator--(int) noexcept { auto t = *this; --_pos; return t; }
+
+        BitIterator & operator+=(difference_type n) noexcept
+        {
+            _pos = size_type(difference_type(_pos) + n);
+            return *this;
+        }
+        BitIterator & operator-=(difference_type n) noexcept
+        {
+            return *this += -n;
+        }
+        friend BitIterator operator+(BitIterator it, difference_type n) noexcept
+        {
+            return it += n;
+        }
+        friend BitIterator operator+(difference_type n, BitIterator it) noexcept
+        {
+            return it += n;
+        }
+        friend BitIterator operator-(BitIterator it, difference_type n) noexcept
+        {
+            return it -= n;
+        }
+        friend difference_type operator-(const BitIterator & a,
+                                         const BitIterator & b) noexcept
+        {
+            return difference_type(a._pos) - difference_type(b._pos);
+        }
+
+        friend bool operator==(const BitIterator & a, const BitIterator & b) noexcept
+        {
+            return a._pos == b._pos;
+        }
+        friend bool operator!=(const BitIterator & a, const BitIterator & b) noexcept
+        {
+            return a._pos != b._pos;
+        }
+        friend bool operator<(const BitIterator & a, const BitIterator & b) noexcept
+        {
+            return a._pos < b._pos;
+        }
+        friend bool operator>(const BitIterator & a, const BitIterator & b) noexcept
+        {
+            return b < a;
+        }
+        friend bool operator<=(const BitIterator & a, const BitIterator & b) noexcept
+        {
+            return !(b < a);
+        }
+        friend bool operator>=(const BitIterator & a, const BitIterator & b) noexcept
+        {
+            return !(a < b);
+        }
+
+    private:
+
+        bool deref(std::true_type) const noexcept
+        {
+            return (_words[_pos / WORD_BITS] >> (_pos % WORD_BITS)) & 1;
+        }
+
+        TMSArray<bool>::reference deref(std::false_type) const noexcept
+        {
+            return TMSArray<bool>::reference(_words + _pos / WORD_BITS,
+                                             word_type(1) << (_pos % WORD_BITS));
+        }
+
+        word_pointer _words;
+        size_type    _pos;
+
+    };
+
+
+    using iterator = BitIterator<false>;
+
+    using const_iterator = BitIterator<true>;
+
+    using const_reference = bool;
+
+
+private:
+
+
+    // Capacity of default-constructed object (bits; rounded up to a word)
+    enum { DEFAULT_CAP = 42 };
+
+
+    // wordsFor
+    // Words needed to hold bits
+    static size_type wordsFor(size_type bits) noexcept
+    {
+        return (bits + WORD_BITS - 1) / WORD_BITS;
+    }
+
+
+// ***** TMSArray<bool>: ctors, op=, dctor *****
+public:
+
+
+    // Default ctor & ctor from size
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      size() == thesize, every flag false
+    explicit TMSArray(size_type thesize=0)
+        :_capacity(wordsFor(std::max(thesize, size_type(DEFAULT_CAP)))
+                   * WORD_BITS),
+         _size(thesize),
+         _words(new word_type[_capacity / WORD_BITS]())
+    {}
+
+
+    // Copy ctor
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      *this is a copy of other
+    TMSArray(const TMSArray & other)
+        :_capacity(other._capacity),
+         _size(other._size),
+         _words(other._capacity == 0 ? nullptr
+                : new word_type[other._capacity / WORD_BITS])
+    {
+        std::copy(other._words, other._words + _capacity / WORD_BITS, _words);
+    }
+
+
+    // Move ctor
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      *this holds other's bits; other is empty with no storage
+    TMSArray(TMSArray && other) noexcept
+        :_capacity(other._capacity),
+         _size(other._size),
+         _words(other._words)
+    {
+        other._capacity = 0;
+        other._size = 0;
+        other._words = nullptr;
+    }
+
+
+    // Copy assignment operator
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      *this is a copy of other
+    TMSArray & operator=(const TMSArray & other)
+    {
+        TMSArray copy(other);
+        swap(copy);
+        return *this;
+    }
+
+
+    // Move assignment operator
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      *this holds other's bits; other holds the old ones
+    TMSArray & operator=(TMSArray && other) noexcept
+    {
+        swap(other);
+        return *this;
+    }
+
+
+    // Dctor
+    // No-Throw Guarantee
+    // Pre: None
+    // Post: None
+    ~TMSArray()
+    {
+        delete [] _words;
+    }
+
+
+
+// ***** TMSArray<bool>: general public operators *****
+public:
+
+
+    // operator[] - non-const & const
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      0 <= index < size
+    // Post:
+    //      Returns proxy for (non-const) or value of (const) flag index
+    reference operator[](size_type index) noexcept
+    {
+        return reference(_words + index / WORD_BITS,
+                         word_type(1) << (index % WORD_BITS));
+    }
+    bool operator[](size_type index) const noexcept
+    {
+        return (_words[index / WORD_BITS] >> (index % WORD_BITS)) & 1;
+    }
+
+
+    // operator&=, operator|=, operator^=
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      other.size() == size()
+    // Post:
+    //      Each flag combined with other's, one word at a time
+    TMSArray & operator&=(const TMSArray & other) noexcept
+    {
+        const size_type n = wordsFor(_size);
+        for (size_type w = 0; w < n; ++w)
+            _words[w] &= other._words[w];
+        return *this;
+    }
+    TMSArray & operator|=(const TMSArray & other) noexcept
+    {
+        const size_type n = wordsFor(_size);
+        for (size_type w = 0; w < n; ++w)
+            _words[w] |= other._words[w];
+        return *this;
+    }
+    TMSArray & operator^=(const TMSArray & other) noexcept
+    {
+        const size_type n = wordsFor(_size);
+        for (size_type w = 0; w < n; ++w)
+            _words[w] ^= other._words[w];
+        return *this;
+    }
+
+
+// ***** TMSArray<bool>: general public functions *****
+public:
+
+
+    // size
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns number of flags
+    size_type size() const noexcept
+    {
+        return _size;
+    }
+
+
+    // empty
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns size() == 0
+    bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+
+    // begin, end - non-const & const
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns iterator to first / one past last flag
+    iterator begin() noexcept
+    {
+        return iterator(_words, 0);
+    }
+    const_iterator begin() const noexcept
+    {
+        return const_iterator(_words, 0);
+    }
+    iterator end() noexcept
+    {
+        return iterator(_words, _size);
+    }
+    const_iterator end() const noexcept
+    {
+        return const_iterator(_words, _size);
+    }
+
+
+    // words, word_count
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Packed storage: flag i is bit i % 64 of words()[i / 64];
+    //      word_count() words hold all size() flags. Writers through the
+    //      non-const overload must leave bits at or past size() clear.
+    word_type * words() noexcept
+    {
+        return _words;
+    }
+    const word_type * words() const noexcept
+    {
+        return _words;
+    }
+    size_type word_count() const noexcept
+    {
+        return wordsFor(_size);
+    }
+
+
+    // resize
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      size() == newsize; flags below the old size are kept, new
+    //      flags are false
+    void resize(size_type newsize)
+    {
+        if (newsize > _capacity)
+        {
+            size_type newCapacity = wordsFor(std::max(_capacity * 2, newsize))
+                                    * WORD_BITS;
+            word_type * newWords = new word_type[newCapacity / WORD_BITS]();
+            std::copy(_words, _words + wordsFor(_size), newWords);
+            delete [] _words;
+            _words = newWords;
+            _capacity = newCapacity;
+        }
+        else if (newsize < _size)
+            clearFrom(newsize);
+        _size = newsize;
+    }
+
+
+    // insert
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre:
+    //     begin() <= pos <= end()
+    // Post:
+    //      item inserted before pos, later flags shifted up one place,
+    //      a word at a time; returns iterator to the new flag
+    iterator insert(const_iterator pos, bool item)
+    {
+        const size_type at = pos.index();
+        resize(_size + 1);
+        const size_type first = at / WORD_BITS;
+        const size_type last = (_size - 1) / WORD_BITS;
+        for (size_type w = last; w > first; --w)
+            _words[w] = (_words[w] << 1) | (_words[w - 1] >> (WORD_BITS - 1));
+        const word_type low = lowMask(at % WORD_BITS);
+        word_type & word = _words[first];
+        word = (word & low) | ((word & ~low) << 1);
+        (*this)[at] = item;
+        return iterator(_words, at);
+    }
+
+
+    // erase
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre:
+    //     begin() <= pos < end()
+    // Post:
+    //      flag at pos removed, later flags shifted down one place, a
+    //      word at a time; returns iterator to the flag now at pos
+    iterator erase(const_iterator pos) noexcept
+    {
+        const size_type at = pos.index();
+        const size_type first = at / WORD_BITS;
+        const size_type last = (_size - 1) / WORD_BITS;
+        const word_type low = lowMask(at % WORD_BITS);
+        word_type & word = _words[first];
+        word = (word & low) | ((word >> 1) & ~low);
+        for (size_type w = first; w < last; ++w)
+        {
+            _words[w] |= _words[w + 1] << (WORD_BITS - 1);
+            _words[w + 1] >>= 1;
+        }
+        --_size;    // old top bit already shifted down, so it is clear
+        return iterator(_words, at);
+    }
+
+
+    // push_back
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      item appended
+    void push_back(bool item)
+    {
+        resize(_size + 1);
+        (*this)[_size - 1] = item;
+    }
+
+
+    // pop_back
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre:
+    //     size() > 0
+    // Post:
+    //      last flag removed
+    void pop_back() noexcept
+    {
+        (*this)[_size - 1] = false;
+        --_size;
+    }
+
+
+    // swap
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post: None
+    void swap(TMSArray & other) noexcept
+    {
+        std::swap(this->_capacity, other._capacity);
+        std::swap(this->_size, other._size);
+        std::swap(this->_words, other._words);
+    }
+
+
+    // and_not
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      other.size() == size()
+    // Post:
+    //      Each flag cleared where other's is set (*this &= ~other)
+    TMSArray & and_not(const TMSArray & other) noexcept
+    {
+        const size_type n = wordsFor(_size);
+        for (size_type w = 0; w < n; ++w)
+            _words[w] &= ~other._words[w];
+        return *this;
+    }
+
+
+// ***** TMSArray<bool>: search functions *****
+public:
+
+
+    // count
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      count() returns number of true flags (popcount per word);
+    //      count(item) number of flags == item
+    size_type count() const noexcept
+    {
+        return tms_popcount_words(_words, wordsFor(_size));
+    }
+    size_type count(bool item) const noexcept
+    {
+        return item ? count() : _size - count();
+    }
+
+
+    // find_first_set, find_next_set
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      from <= size()
+    // Post:
+    //      Returns position of first true flag (at or after from), or
+    //      size() if none; skips whole zero words
+    size_type find_first_set() const noexcept
+    {
+        return find_next_set(0);
+    }
+    size_type find_next_set(size_type from) const noexcept
+    {
+        return scan(from, 0);
+    }
+
+
+    // find - non-const & const
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns iterator to first flag == item, or end() if none
+    iterator find(bool item) noexcept
+    {
+        return iterator(_words, scan(0, item ? 0 : ~word_type(0)));
+    }
+    const_iterator find(bool item) const noexcept
+    {
+        return const_iterator(_words, scan(0, item ? 0 : ~word_type(0)));
+    }
+
+
+    // contains
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns true if some flag == item
+    bool contains(bool item) const noexcept
+    {
+        return find(item) != end();
+    }
+
+
+    // find_if_less, find_if_greater - non-const & const
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns iterator to first flag < bound (> bound), or end();
+    //      false < true
+    iterator find_if_less(bool bound) noexcept
+    {
+        return bound ? find(false) : end();
+    }
+    const_iterator find_if_less(bool bound) const noexcept
+    {
+        return bound ? find(false) : end();
+    }
+    iterator find_if_greater(bool bound) noexcept
+    {
+        return bound ? end() : find(true);
+    }
+    const_iterator find_if_greater(bool bound) const noexcept
+    {
+        return bound ? end() : find(true);
+    }
+
+
+// ***** TMSArray<bool>: private helpers *****
+private:
+
+
+    // lowMask
+    // Word with bits [0, bits) set; bits < WORD_BITS
+    static word_type lowMask(size_type bits) noexcept
+    {
+        return (word_type(1) << bits) - 1;
+    }
+
+
+    // scan
+    // First position >= from whose bit, XORed with invert, is 1; size()
+    //  if none. invert == 0 finds true flags, all-ones finds false ones.
+    size_type scan(size_type from, word_type invert) const noexcept
+    {
+        if (from >= _size)
+            return _size;
+        size_type w = from / WORD_BITS;
+        const size_type n = wordsFor(_size);
+        word_type bits = (_words[w] ^ invert) & ~lowMask(from % WORD_BITS);
+        while (bits == 0)
+        {
+            if (++w == n)
+                return _size;
+            bits = _words[w] ^ invert;
+        }
+        const size_type pos = w * WORD_BITS + size_type(__builtin_ctzll(bits));
+        return pos < _size ? pos : _size;   // inverted padding reads as hits
+    }
+
+
+    // clearFrom
+    // Zeroes every bit at positions [from, _size), restoring the
+    //  invariant before _size shrinks
+    void clearFrom(size_type from) noexcept
+    {
+        size_type w = from / WORD_BITS;
+        if (from % WORD_BITS != 0)
+            _words[w++] &= lowMask(from % WORD_BITS);
+        std::fill(_words + w, _words + wordsFor(_size), word_type(0));
+    }
+
+
+// ***** TMSArray<bool>: data members *****
+private:
+
+    size_type   _capacity;  // in bits
+    size_type   _size;      // in bits
+    word_type * _words;
+
+}; // end of class
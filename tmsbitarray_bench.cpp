@@ -0,0 +1,143 @@
+// tmsbitarray_bench.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Benchmark: bit-packed TMSArray<bool> vs. a byte-per-flag
+//  TMSArray<unsigned char> (the old TMSArray<bool> layout): fill, random
+//  reads, popcount, find-first-set, AND/ANDNOT, push_back, and insert
+//  near the front.
+// Usage: tmsbitarray_bench [flags=67108864]
+// Requires tmsarray.hpp, tmsbitarray.hpp, tmssimd.hpp, tmsbench.hpp
+
+#include "tmsarray.hpp"
+#include "tmsbench.hpp"
+
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::uint64_t;
+#include <iostream>
+using std::cout;
+
+
+int main(int argc, char * argv[])
+{
+    const size_t n = tms_arg(argc, argv, 1, size_t(1) << 26);
+    const int reps = 5;
+    using Bytes = TMSArray<unsigned char>;
+
+    TMSArray<bool> bitsA(n), bitsB(n);
+    Bytes bytesA(n), bytesB(n);
+
+    cout << "== " << n << " flags: " << n / 8 << " bytes packed, " << n
+         << " bytes as bytes ==\n";
+
+    double secs = tms_time_best(reps, [&]
+    {
+        for (size_t i = 0; i < n; ++i)
+            bytesA[i] = (i % 3 == 0);
+    });
+    tms_report("fill  bytes", secs, n);
+    secs = tms_time_best(reps, [&]
+    {
+        for (size_t i = 0; i < n; ++i)
+            bitsA[i] = (i % 3 == 0);
+    });
+    tms_report("fill  bits", secs, n / 8);
+    for (size_t i = 0; i < n; ++i)
+    {
+        bytesB[i] = (i % 5 == 0);
+        bitsB[i] = (i % 5 == 0);
+    }
+
+    secs = tms_time_best(reps, [&]
+    {
+        uint64_t x = 1, hits = 0;
+        for (size_t k = 0; k < (size_t(1) << 22); ++k)
+        {
+            x = x * 6364136223846793005ull + 1442695040888963407ull;
+            hits += bytesA[(x >> 20) % n];
+        }
+        tms_sink(hits);
+    });
+    tms_report("4M random reads bytes", secs);
+    secs = tms_time_best(reps, [&]
+    {
+        uint64_t x = 1, hits = 0;
+        for (size_t k = 0; k < (size_t(1) << 22); ++k)
+        {
+            x = x * 6364136223846793005ull + 1442695040888963407ull;
+            hits += bitsA[(x >> 20) % n];
+        }
+        tms_sink(hits);
+    });
+    tms_report("4M random reads bits", secs);
+
+    secs = tms_time_best(reps, [&]{ tms_sink(bytesA.count(1)); });
+    tms_report("count bytes (SIMD count)", secs, n);
+    secs = tms_time_best(reps, [&]{ tms_sink(bitsA.count()); });
+    tms_report("count bits (popcount)", secs, n / 8);
+
+    Bytes sparseBytes(n);
+    TMSArray<bool> sparseBits(n);
+    for (size_t i = 0; i < n; ++i)
+        sparseBytes[i] = 0;
+    sparseBytes[n - 1] = 1;
+    sparseBits[n - 1] = true;
+    secs = tms_time_best(reps, [&]{ tms_sink(sparseBytes.find(1)); });
+    tms_report("find last set bytes (SIMD find)", secs, n);
+    secs = tms_time_best(reps, [&]{ tms_sink(sparseBits.find_first_set()); });
+    tms_report("find last set bits", secs, n / 8);
+
+    secs = tms_time_best(reps, [&]
+    {
+        for (size_t i = 0; i < n; ++i)
+            bytesA[i] &= bytesB[i];
+    });
+    tms_report("AND bytes", secs, 3 * n);
+    secs = tms_time_best(reps, [&]{ bitsA &= bitsB; });
+    tms_report("AND bits", secs, 3 * (n / 8));
+    secs = tms_time_best(reps, [&]
+    {
+        for (size_t i = 0; i < n; ++i)
+            bytesA[i] &= !bytesB[i];
+    });
+    tms_report("ANDNOT bytes", secs, 3 * n);
+    secs = tms_time_best(reps, [&]{ bitsA.and_not(bitsB); });
+    tms_report("ANDNOT bits", secs, 3 * (n / 8));
+
+    const size_t pushes = std::min(n, size_t(1) << 24);
+    secs = tms_time_best(reps, [&]
+    {
+        Bytes grow;
+        for (size_t i = 0; i < pushes; ++i)
+            grow.push_back(i & 1);
+        tms_sink(grow[0]);
+    });
+    tms_report("push_back bytes", secs);
+    secs = tms_time_best(reps, [&]
+    {
+        TMSArray<bool> grow;
+        for (size_t i = 0; i < pushes; ++i)
+            grow.push_back(i & 1);
+        tms_sink(grow[0]);
+    });
+    tms_report("push_back bits", secs);
+
+    const size_t small = std::min(n, size_t(1) << 20);
+    Bytes insBytes(small);
+    TMSArray<bool> insBits(small);
+    secs = tms_time_best(reps, [&]
+    {
+        for (int k = 0; k < 100; ++k)
+            insBytes.insert(insBytes.begin() + 3, 1);
+    });
+    tms_report("100 inserts near front bytes", secs);
+    secs = tms_time_best(reps, [&]
+    {
+        for (int k = 0; k < 100; ++k)
+            insBits.insert(insBits.begin() + 3, true);
+    });
+    tms_report("100 inserts near front bits", secs);
+    return 0;
+}
@@ -0,0 +1,338 @@
+// tmsbitarray_test.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Test program for the bit-packed specialization TMSArray<bool>
+// Uses the "doctest" unit-testing framework, version 2
+// Requires doctest.h, tmsarray.hpp, tmsbitarray.hpp, tmssimd.hpp
+
+// Includes for code to be tested
+#include "tmsarray.hpp"      // For TMSArray<bool>
+#include "tmsbitarray.hpp"   // Double-inclusion check, for testing only
+
+// Includes for the "doctest" unit-testing framework
+#define DOCTEST_CONFIG_IMPLEMENT
+                             // We write our own main
+#define DOCTEST_CONFIG_SUPER_FAST_ASSERTS
+                             // Reduce compile time
+#include "doctest.h"         // For doctest
+
+// Includes for all test programs
+#include <iostream>
+using std::cout;
+using std::endl;
+using std::cin;
+#include <string>
+using std::string;
+
+// Additional includes for this test program
+#include <cstddef>
+using std::size_t;
+#include <algorithm>
+using std::count;
+using std::equal;
+using std::fill;
+#include <vector>
+using std::vector;
+
+// Printable name for this test suite
+const string test_suite_name =
+    "bit-packed TMSArray<bool>";
+
+
+// *********************************************************************
+// Helper Functions for This Test Program
+// *********************************************************************
+
+
+// pattern
+// Deterministic flag for position i under seed
+bool pattern(size_t i, unsigned seed)
+{
+    return ((i * 2654435761u + seed * 40503u) >> 7) % 3 == 0;
+}
+
+
+// sameAs
+// tb holds exactly the flags of ref, and no bit past size() is set
+bool sameAs(const TMSArray<bool> & tb, const vector<bool> & ref)
+{
+    if (tb.size() != ref.size())
+        return false;
+    for (size_t i = 0; i < ref.size(); ++i)
+        if (tb[i] != ref[i])
+            return false;
+    const size_t bits = tb.word_count() * 64;
+    for (size_t i = tb.size(); i < bits; ++i)
+        if ((tb.words()[i / 64] >> (i % 64)) & 1)
+            return false;
+    return true;
+}
+
+
+// makeBoth
+// TMSArray<bool> and vector<bool> with the same n flags
+void makeBoth(size_t n, unsigned seed, TMSArray<bool> & tb,
+              vector<bool> & ref)
+{
+    tb = TMSArray<bool>(n);
+    ref.assign(n, false);
+    for (size_t i = 0; i < n; ++i)
+    {
+        tb[i] = pattern(i, seed);
+        ref[i] = pattern(i, seed);
+    }
+}
+
+
+// *********************************************************************
+// Test Cases
+// *********************************************************************
+
+
+TEST_CASE( "TMSArray<bool> basics" )
+{
+    SUBCASE( "Storage is packed and starts false" )
+    {
+        TMSArray<bool> tb(1000);
+        REQUIRE( tb.size() == 1000 );
+        REQUIRE( tb.word_count() == 16 );
+        REQUIRE( tb.count() == 0 );
+        REQUIRE( !tb.contains(true) );
+        TMSArray<bool> empty;
+        REQUIRE( empty.empty() );
+        REQUIRE( empty.find_first_set() == 0 );
+    }
+
+    SUBCASE( "Proxy references and iterators" )
+    {
+        TMSArray<bool> tb(130);
+        tb[0] = true;
+        tb[64] = true;
+        tb[129] = tb[0];
+        tb[1].flip();
+        REQUIRE( tb[0] );
+        REQUIRE( tb[1] );
+        REQUIRE( tb[64] );
+        REQUIRE( tb[129] );
+        REQUIRE( !tb[2] );
+        REQUIRE( count(tb.begin(), tb.end(), true) == 4 );
+        REQUIRE( tb.end() - tb.begin() == 130 );
+        *(tb.begin() + 2) = true;
+        const TMSArray<bool> & ctb = tb;
+        REQUIRE( ctb.begin()[2] );
+        size_t seen = 0;
+        for (bool b : ctb)
+            seen += b ? 1 : 0;
+        REQUIRE( seen == 5 );
+        fill(tb.begin(), tb.end(), true);
+        REQUIRE( tb.count() == 130 );
+    }
+
+    SUBCASE( "Copy, move, swap" )
+    {
+        TMSArray<bool> a;
+        vector<bool> ref;
+        makeBoth(300, 1, a, ref);
+        TMSArray<bool> b(a);
+        REQUIRE( sameAs(b, ref) );
+        TMSArray<bool> c(std::move(b));
+        REQUIRE( sameAs(c, ref) );
+        REQUIRE( b.size() == 0 );
+        TMSArray<bool> d(5);
+        d = c;
+        REQUIRE( sameAs(d, ref) );
+        d.swap(b);
+        REQUIRE( sameAs(b, ref) );
+        REQUIRE( d.size() == 0 );
+        d.push_back(true);      // moved-from object is still usable
+        REQUIRE( d.size() == 1 );
+        REQUIRE( d[0] );
+    }
+}
+
+
+TEST_CASE( "TMSArray<bool> word-level modifiers" )
+{
+    SUBCASE( "push_back and pop_back across word boundaries" )
+    {
+        TMSArray<bool> tb;
+        vector<bool> ref;
+        for (size_t i = 0; i < 1000; ++i)
+        {
+            tb.push_back(pattern(i, 2));
+            ref.push_back(pattern(i, 2));
+        }
+        REQUIRE( sameAs(tb, ref) );
+        for (size_t i = 0; i < 437; ++i)
+        {
+            tb.pop_back();
+            ref.pop_back();
+        }
+        REQUIRE( sameAs(tb, ref) );
+    }
+
+    SUBCASE( "insert and erase at every offset" )
+    {
+        bool allMatch = true;
+        for (size_t n : { 0, 1, 63, 64, 65, 200 })
+            for (size_t at = 0; at <= n; ++at)
+            {
+                TMSArray<bool> tb;
+                vector<bool> ref;
+                makeBoth(n, unsigned(n), tb, ref);
+                auto it = tb.insert(tb.begin() + at, true);
+                ref.insert(ref.begin() + at, true);
+                allMatch = allMatch && it.index() == at && sameAs(tb, ref);
+                tb.insert(tb.begin() + at, false);
+                ref.insert(ref.begin() + at, false);
+                allMatch = allMatch && sameAs(tb, ref);
+                tb.erase(tb.begin() + at);
+                ref.erase(ref.begin() + at);
+                tb.erase(tb.begin() + at);
+                ref.erase(ref.begin() + at);
+                allMatch = allMatch && sameAs(tb, ref);
+                if (n != 0 && at < n)
+                {
+                    tb.erase(tb.begin() + at);
+                    ref.erase(ref.begin() + at);
+                    allMatch = allMatch && sameAs(tb, ref);
+                }
+            }
+        REQUIRE( allMatch );
+    }
+
+    SUBCASE( "resize keeps old flags, new ones false" )
+    {
+        TMSArray<bool> tb(100);
+        fill(tb.begin(), tb.end(), true);
+        tb.resize(37);
+        REQUIRE( tb.count() == 37 );
+        tb.resize(5000);
+        REQUIRE( tb.count() == 37 );
+        REQUIRE( !tb[37] );
+        REQUIRE( !tb[99] );
+        tb.resize(64);
+        tb.resize(128);
+        REQUIRE( tb.count() == 37 );
+    }
+}
+
+
+TEST_CASE( "TMSArray<bool> counting and searching" )
+{
+    TMSArray<bool> tb;
+    vector<bool> ref;
+    makeBoth(1000, 3, tb, ref);
+    size_t trues = size_t(count(ref.begin(), ref.end(), true));
+    REQUIRE( tb.count() == trues );
+    REQUIRE( tb.count(true) == trues );
+    REQUIRE( tb.count(false) == 1000 - trues );
+    const TMSIsa best = tms_isa_limit();
+    tms_isa_limit() = TMS_ISA_SCALAR;       // portable popcount path
+    REQUIRE( tb.count() == trues );
+    tms_isa_limit() = best;
+
+    bool allMatch = true;
+    for (size_t from = 0; from <= 1000; ++from)
+    {
+        size_t expect = from;
+        while (expect < 1000 && !ref[expect])
+            ++expect;
+        allMatch = allMatch && tb.find_next_set(from) == expect;
+    }
+    REQUIRE( allMatch );
+
+    TMSArray<bool> sparse(777);
+    REQUIRE( sparse.find_first_set() == 777 );
+    REQUIRE( sparse.find(false).index() == 0 );
+    sparse[700] = true;
+    REQUIRE( sparse.find_first_set() == 700 );
+    REQUIRE( sparse.find(true).index() == 700 );
+    REQUIRE( sparse.find_if_greater(false).index() == 700 );
+    REQUIRE( sparse.find_if_greater(true) == sparse.end() );
+    REQUIRE( sparse.find_if_less(false) == sparse.end() );
+
+    TMSArray<bool> full(130);
+    fill(full.begin(), full.end(), true);
+    REQUIRE( full.find(false) == full.end() );     // padding is not a hit
+    REQUIRE( !full.contains(false) );
+    full[129] = false;
+    REQUIRE( full.find_if_less(true).index() == 129 );
+}
+
+
+TEST_CASE( "TMSArray<bool> bitwise combines" )
+{
+    TMSArray<bool> a, b;
+    vector<bool> ra, rb;
+    makeBoth(1001, 4, a, ra);
+    makeBoth(1001, 5, b, rb);
+
+    vector<bool> rAnd(1001), rOr(1001), rXor(1001), rAndNot(1001);
+    for (size_t i = 0; i < 1001; ++i)
+    {
+        rAnd[i] = ra[i] && rb[i];
+        rOr[i] = ra[i] || rb[i];
+        rXor[i] = ra[i] != rb[i];
+        rAndNot[i] = ra[i] && !rb[i];
+    }
+
+    TMSArray<bool> t(a);
+    t &= b;
+    REQUIRE( sameAs(t, rAnd) );
+    t = a;
+    t |= b;
+    REQUIRE( sameAs(t, rOr) );
+    t = a;
+    t ^= b;
+    REQUIRE( sameAs(t, rXor) );
+    t = a;
+    t.and_not(b);
+    REQUIRE( sameAs(t, rAndNot) );
+}
+
+
+// *********************************************************************
+// Main Program
+// *********************************************************************
+
+
+// userPause
+// Wait for user to press ENTER: read all chars through first newline.
+void userPause()
+{
+    std::cout.flush();
+    while (std::cin.get() != '\n') ;
+}
+
+
+// Main program
+// Run all tests. Prompt for ENTER before exiting.
+int main(int argc,
+         char *argv[])
+{
+    doctest::Context dtcontext;
+                             // Primary doctest object
+    int dtresult;            // doctest return code; for return by main
+
+    // Handle command line
+    dtcontext.applyCommandLine(argc, argv);
+    dtresult = 0;            // doctest flags no command-line errors
+                             //  (strange but true)
+
+    if (!dtresult)           // Continue only if no command-line error
+    {
+        // Run test suites
+        cout << "BEGIN tests for " << test_suite_name << "\n" << endl;
+        dtresult = dtcontext.run();
+        cout << "END tests for " << test_suite_name << "\n" << endl;
+    }
+
+    // Wait for user
+    std::cout << "Press ENTER to quit ";
+    userPause();
+
+    // Program return value is return code from doctest
+    return dtresult;
+}
@@ -0,0 +1,231 @@
+// tmscollector.hpp
+// Matthew Johnson
+// 10/17/2026
+// per-producer append buffers with one-shot parallel merge into TMSArray
+
+#pragma once
+// for single inclusion
+
+#include "tmsarray.hpp"
+// For class template TMSArray
+
+#include "tmsparallel.hpp"
+// For TMSThreadPool
+// For tms_parallel_for
+// For tms_default_pool
+
+#include <cstddef>
+// For std::size_t
+
+#include <algorithm>
+// For std::upper_bound
+// For std::min
+// For std::move
+
+#include <vector>
+// For std::vector
+
+
+
+// *********************************************************************
+// class TMSCollector - Class definition
+// *********************************************************************
+
+
+// class TMSCollector
+// One TMSArray buffer per producer slot. Producer k appends only to slot
+//  k, so no locking is needed while producing. merge_into() then sizes
+//  the destination once (prefix sum of buffer sizes) and moves every
+//  buffer into place in parallel.
+// Slots are cache-line aligned so producers do not false-share the
+//  buffers' size fields.
+// Invariants:
+//     _slots.size() == producer count > 0.
+template <typename Valtype>
+class TMSCollector
+{
+
+public:
+
+
+    using value_type = Valtype;
+
+    using size_type  = std::size_t;
+
+    using buffer_type = TMSArray<value_type>;
+
+
+private:
+
+
+    struct alignas(64) Slot
+    {
+        buffer_type buf = buffer_type(0);
+    };
+
+
+// ***** TMSCollector: ctors, dctor *****
+public:
+
+
+    // Ctor from producer count
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      producers > 0
+    // Post:
+    //      producers() == producers, every buffer empty
+    explicit TMSCollector(size_type producers)
+        :_slots(producers)
+    {}
+
+
+    // Compiler-generated copy/move/dctor are used
+
+
+// ***** TMSCollector: general public functions *****
+public:
+
+
+    // producers
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns number of producer slots
+    size_type producers() const noexcept
+    {
+        return _slots.size();
+    }
+
+
+    // size
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      no producer is appending concurrently
+    // Post:
+    //      Returns total elements buffered over all slots
+    size_type size() const noexcept
+    {
+        size_type total = 0;
+        for (const auto & slot : _slots)
+            total += slot.buf.size();
+        return total;
+    }
+
+
+    // buffer - non-const & const
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      0 <= slot < producers
+    // Post:
+    //      Returns slot's buffer; only one thread may use it at a time
+    buffer_type & buffer(size_type slot) noexcept
+    {
+        return _slots[slot].buf;
+    }
+    const buffer_type & buffer(size_type slot) const noexcept
+    {
+        return _slots[slot].buf;
+    }
+
+
+    // push_back
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      0 <= slot < producers
+    //      no other thread uses slot concurrently
+    // Post:
+    //      item appended to slot's buffer
+    void push_back(size_type slot, const value_type & item)
+    {
+        _slots[slot].buf.push_back(item);
+    }
+
+
+    // merge_into
+    // Basic Guarantee (Strong if the one resize of dest throws)
+    // Exception-Neutral
+    // Pre:
+    //      no producer is appending concurrently
+    //      &dest is not one of the buffers
+    // Post:
+    //      dest holds its old contents followed by every buffered
+    //       element; all buffers are empty
+    //      preserveOrder: buffers appear in slot order, each in append
+    //       order. Otherwise only per-slot order is kept, which lets an
+    //       empty dest take the largest buffer by swap instead of a copy
+    void merge_into(TMSArray<value_type> & dest,
+                    bool preserveOrder = true,
+                    TMSThreadPool & pool = tms_default_pool())
+    {
+        std::vector<buffer_type *> order;
+        order.reserve(_slots.size());
+        for (auto & slot : _slots)
+            order.push_back(&slot.buf);
+
+        if (!preserveOrder && dest.empty())
+        {
+            // Largest buffer becomes dest outright; the rest follow it
+            size_type largest = 0;
+            for (size_type k = 1; k < order.size(); ++k)
+                if (order[k]->size() > order[largest]->size())
+                    largest = k;
+            dest.swap(*order[largest]);
+            order[largest]->resize(0);
+            order.erase(order.begin() + largest);
+        }
+
+        // Exclusive prefix sum: offsets[k] is where buffer k starts
+        std::vector<size_type> offsets(order.size() + 1);
+        offsets[0] = dest.size();
+        for (size_type k = 0; k < order.size(); ++k)
+            offsets[k + 1] = offsets[k] + order[k]->size();
+
+        const size_type base = dest.size();
+        const size_type total = offsets.back() - base;
+        dest.resize(base + total);  // the one and only reallocation
+
+        value_type * out = dest.begin();
+        auto moveRange = [&](size_type first, size_type last, size_type)
+        {
+            // [first, last) is a range of the concatenation; walk the
+            // buffers that overlap it
+            first += base;
+            last += base;
+            size_type k = size_type(std::upper_bound(offsets.begin(),
+                                                     offsets.end(), first)
+                                    - offsets.begin()) - 1;
+            while (first < last)
+            {
+                size_type stop = std::min(last, offsets[k + 1]);
+                value_type * src = order[k]->begin() + (first - offsets[k]);
+                std::move(src, src + (stop - first), out + first);
+                first = stop;
+                ++k;
+            }
+        };
+
+        if (total * sizeof(value_type) < TMS_PARALLEL_THRESHOLD
+            || pool.size() == 1)
+        {
+            if (total != 0)
+                moveRange(0, total, 0);
+        }
+        else
+            tms_parallel_for(total, moveRange, pool);
+
+        for (auto * buf : order)
+            buf->resize(0);
+    }
+
+
+// ***** TMSCollector: data members *****
+private:
+
+    std::vector<Slot> _slots;
+
+}; // end of class
@@ -0,0 +1,94 @@
+// tmscollector_bench.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Benchmark: gathering results from several producer threads into one
+//  TMSArray<long> -- mutex + push_back, per-slot buffers merged by
+//  repeated insert, and TMSCollector::merge_into.
+// Usage: tmscollector_bench [elements=20000000] [threads=hardware]
+// Requires tmscollector.hpp, tmsparallel.hpp, tmsarray.hpp, tmsbench.hpp
+
+#include "tmscollector.hpp"
+#include "tmsparallel.hpp"
+#include "tmsbench.hpp"
+
+#include <cstddef>
+using std::size_t;
+#include <iostream>
+using std::cout;
+#include <mutex>
+using std::mutex;
+using std::lock_guard;
+#include <string>
+using std::to_string;
+
+
+int main(int argc, char * argv[])
+{
+    const size_t n = tms_arg(argc, argv, 1, 20000000);
+    TMSThreadPool pool(tms_arg(argc, argv, 2, 0));
+    const size_t bytes = n * sizeof(long);
+
+    cout << "Collect " << n << " longs from " << pool.size()
+         << " producers\n\n";
+
+    double secs = tms_time_best(3, [&]
+    {
+        TMSArray<long> dest(0);
+        mutex lock;
+        tms_parallel_for(n, [&](size_t first, size_t last, size_t)
+        {
+            for (size_t i = first; i < last; ++i)
+            {
+                lock_guard<mutex> guard(lock);
+                dest.push_back(long(i));
+            }
+        }, pool);
+        tms_sink(dest[n / 2]);
+    });
+    tms_report("mutex + push_back", secs, bytes);
+
+    // Repeated insert is quadratic; only time it on a small prefix
+    const size_t small = n < 20000 ? n : 20000;
+    secs = tms_time_best(3, [&]
+    {
+        TMSCollector<long> tc(pool.size());
+        tms_parallel_for(small, [&](size_t first, size_t last, size_t tid)
+        {
+            for (size_t i = first; i < last; ++i)
+                tc.push_back(tid, long(i));
+        }, pool);
+        TMSArray<long> dest(0);
+        for (size_t k = 0; k < tc.producers(); ++k)
+            for (long value : tc.buffer(k))
+                dest.insert(dest.begin() + (dest.size() / 2), value);
+        tms_sink(dest[0]);
+    });
+    tms_report("buffers + repeated insert (" + to_string(small) + ")",
+               secs, small * sizeof(long));
+
+    for (bool ordered : { true, false })
+    {
+        double mergeSecs = 0.0;
+        secs = tms_time_best(3, [&]
+        {
+            TMSCollector<long> tc(pool.size());
+            tms_parallel_for(n, [&](size_t first, size_t last, size_t tid)
+            {
+                for (size_t i = first; i < last; ++i)
+                    tc.push_back(tid, long(i));
+            }, pool);
+            TMSArray<long> dest(0);
+            mergeSecs = tms_time_best(1, [&]
+            {
+                tc.merge_into(dest, ordered, pool);
+            });
+            tms_sink(dest[n / 2]);
+        });
+        tms_report(ordered ? "TMSCollector (ordered) total"
+                           : "TMSCollector (unordered) total", secs, bytes);
+        tms_report("  merge_into only", mergeSecs, bytes);
+    }
+
+    return 0;
+}
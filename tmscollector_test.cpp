@@ -0,0 +1,159 @@
+// tmscollector_test.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Test program for class template TMSCollector
+// Uses the "doctest" unit-testing framework, version 2
+// Requires doctest.h, tmscollector.hpp, tmsparallel.hpp, tmsarray.hpp
+
+// Includes for code to be tested
+#include "tmscollector.hpp"  // For class template TMSCollector
+#include "tmscollector.hpp"  // Double-inclusion check, for testing only
+
+// Includes for the "doctest" unit-testing framework
+#define DOCTEST_CONFIG_IMPLEMENT
+                             // We write our own main
+#define DOCTEST_CONFIG_SUPER_FAST_ASSERTS
+                             // Reduce compile time
+#include "doctest.h"         // For doctest
+
+// Includes for all test programs
+#include <iostream>
+using std::cout;
+using std::endl;
+using std::cin;
+#include <string>
+using std::string;
+
+// Additional includes for this test program
+#include <cstddef>
+using std::size_t;
+
+// Printable name for this test suite
+const string test_suite_name =
+    "class template TMSCollector";
+
+
+// *********************************************************************
+// Test Cases
+// *********************************************************************
+
+
+TEST_CASE( "TMSCollector merge_into" )
+{
+    TMSThreadPool pool(4);
+
+    SUBCASE( "Concurrent producers, ordered merge after existing data" )
+    {
+        TMSCollector<int> tc(pool.size());
+        const size_t PER = 300000;   // large enough for the parallel path
+        pool.run([&](size_t tid, size_t)
+        {
+            for (size_t i = 0; i < PER; ++i)
+                tc.push_back(tid, int(tid * PER + i));
+        });
+        REQUIRE( tc.size() == PER * pool.size() );
+
+        TMSArray<int> dest(2);
+        dest[0] = -2;
+        dest[1] = -1;
+        tc.merge_into(dest, true, pool);
+
+        REQUIRE( dest.size() == 2 + PER * pool.size() );
+        REQUIRE( dest[0] == -2 );
+        REQUIRE( dest[1] == -1 );
+        bool inOrder = true;
+        for (size_t i = 2; i < dest.size(); ++i)
+            inOrder = inOrder && dest[i] == int(i - 2);
+        REQUIRE( inOrder );
+        REQUIRE( tc.size() == 0 );
+    }
+
+    SUBCASE( "Empty and uneven buffers, non-trivial type" )
+    {
+        TMSCollector<string> tc(5);
+        tc.push_back(1, "a");
+        tc.push_back(1, "b");
+        tc.push_back(3, "c");
+        TMSArray<string> dest(0);
+        tc.merge_into(dest, true, pool);
+        REQUIRE( dest.size() == 3 );
+        REQUIRE( dest[0] == "a" );
+        REQUIRE( dest[1] == "b" );
+        REQUIRE( dest[2] == "c" );
+    }
+
+    SUBCASE( "Unordered merge keeps per-slot order" )
+    {
+        TMSCollector<int> tc(3);
+        for (int i = 0; i < 5; ++i)
+            tc.push_back(0, i);
+        for (int i = 0; i < 50; ++i)
+            tc.push_back(2, 100 + i);
+        TMSArray<int> dest(0);
+        tc.merge_into(dest, false, pool);
+        REQUIRE( dest.size() == 55 );
+        REQUIRE( dest[0] == 100 );    // largest buffer taken by swap
+        REQUIRE( dest[49] == 149 );
+        REQUIRE( dest[50] == 0 );
+        REQUIRE( dest[54] == 4 );
+        REQUIRE( tc.size() == 0 );
+    }
+
+    SUBCASE( "Collector reusable after merge" )
+    {
+        TMSCollector<int> tc(2);
+        TMSArray<int> dest(0);
+        tc.push_back(0, 1);
+        tc.merge_into(dest, true, pool);
+        tc.push_back(1, 2);
+        tc.merge_into(dest, true, pool);
+        REQUIRE( dest.size() == 2 );
+        REQUIRE( dest[1] == 2 );
+    }
+}
+
+
+// *********************************************************************
+// Main Program
+// *********************************************************************
+
+
+// userPause
+// Wait for user to press ENTER: read all chars through first newline.
+void userPause()
+{
+    std::cout.flush();
+    while (std::cin.get() != '\n') ;
+}
+
+
+// Main program
+// Run all tests. Prompt for ENTER before exiting.
+int main(int argc,
+         char *argv[])
+{
+    doctest::Context dtcontext;
+                             // Primary doctest object
+    int dtresult;            // doctest return code; for return by main
+
+    // Handle command line
+    dtcontext.applyCommandLine(argc, argv);
+    dtresult = 0;            // doctest flags no command-line errors
+                             //  (strange but true)
+
+    if (!dtresult)           // Continue only if no command-line error
+    {
+        // Run test suites
+        cout << "BEGIN tests for " << test_suite_name << "\n" << endl;
+        dtresult = dtcontext.run();
+        cout << "END tests for " << test_suite_name << "\n" << endl;
+    }
+
+    // Wait for user
+    std::cout << "Press ENTER to quit ";
+    userPause();
+
+    // Program return value is return code from doctest
+    return dtresult;
+}
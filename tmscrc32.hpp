@@ -0,0 +1,230 @@
+// tmscrc32.hpp
+// Matthew Johnson
+// 10/17/2026
+// CRC-32C (Castagnoli) checksum: SSE4.2 crc32 instruction, three
+//  interleaved streams, with a slicing-by-8 table fallback; and the
+//  zip/gzip CRC-32, by slicing-by-8
+
+#pragma once
+// for single inclusion
+
+#include "tmssimd.hpp"
+// For tms_isa_limit
+// For TMS_SIMD_X86
+
+#include <cstddef>
+// For std::size_t
+
+#include <cstdint>
+// For std::uint32_t
+// For std::uint64_t
+
+#include <cstring>
+// For std::memcpy
+
+
+
+// Reflected CRC-32C polynomial
+constexpr std::uint32_t TMS_CRC32C_POLY = 0x82F63B78u;
+
+// Reflected CRC-32 polynomial (zip, gzip, PNG)
+constexpr std::uint32_t TMS_CRC32_POLY = 0xEDB88320u;
+
+// Bytes per stream in one round of the interleaved hardware kernel
+constexpr std::size_t TMS_CRC32C_BLOCK = 4096;
+
+
+// TMSCrcTables
+// Slicing-by-8 lookup for reflected polynomial Poly: t[k][b] is the CRC
+//  of byte b followed by k zero bytes
+template <std::uint32_t Poly>
+struct TMSCrcTables
+{
+    std::uint32_t t[8][256];
+
+    TMSCrcTables() noexcept
+    {
+        for (std::uint32_t b = 0; b < 256; ++b)
+        {
+            std::uint32_t c = b;
+            for (int k = 0; k < 8; ++k)
+                c = (c >> 1) ^ (Poly & (0 - (c & 1)));
+            t[0][b] = c;
+        }
+        for (std::uint32_t b = 0; b < 256; ++b)
+            for (int k = 1; k < 8; ++k)
+                t[k][b] = (t[k - 1][b] >> 8) ^ t[0][t[k - 1][b] & 0xFF];
+    }
+
+    // Built once, on first use
+    static const TMSCrcTables & get() noexcept
+    {
+        static const TMSCrcTables tables;
+        return tables;
+    }
+};
+
+using TMSCrc32cTables = TMSCrcTables<TMS_CRC32C_POLY>;
+
+
+// tms_crc32c_tables
+// Built once, on first use
+inline const TMSCrc32cTables & tms_crc32c_tables() noexcept
+{
+    return TMSCrc32cTables::get();
+}
+
+
+// tms_crc_sw
+// Raw (no pre/post inversion) CRC register for Poly after feeding
+//  [p, p + n)
+template <std::uint32_t Poly>
+inline std::uint32_t tms_crc_sw(std::uint32_t crc, const unsigned char * p,
+                                std::size_t n) noexcept
+{
+    const TMSCrcTables<Poly> & tb = TMSCrcTables<Poly>::get();
+    for (; n >= 8; n -= 8, p += 8)
+    {
+        std::uint64_t w;
+        std::memcpy(&w, p, sizeof w);
+        w ^= crc;
+        crc = tb.t[7][w & 0xFF] ^ tb.t[6][(w >> 8) & 0xFF]
+            ^ tb.t[5][(w >> 16) & 0xFF] ^ tb.t[4][(w >> 24) & 0xFF]
+            ^ tb.t[3][(w >> 32) & 0xFF] ^ tb.t[2][(w >> 40) & 0xFF]
+            ^ tb.t[1][(w >> 48) & 0xFF] ^ tb.t[0][w >> 56];
+    }
+    for (; n > 0; --n)
+        crc = (crc >> 8) ^ tb.t[0][(crc ^ *p++) & 0xFF];
+    return crc;
+}
+
+
+// tms_crc32c_sw
+// Raw CRC-32C register after feeding [p, p + n)
+inline std::uint32_t tms_crc32c_sw(std::uint32_t crc, const unsigned char * p,
+                                   std::size_t n) noexcept
+{
+    return tms_crc_sw<TMS_CRC32C_POLY>(crc, p, n);
+}
+
+
+// tms_crc32c_mulmod
+// a * b modulo the polynomial, both in reflected form (bit 31 is x^0)
+inline std::uint32_t tms_crc32c_mulmod(std::uint32_t a, std::uint32_t b) noexcept
+{
+    std::uint32_t prod = 0;
+    for (std::uint32_t m = 1u << 31; m != 0; m >>= 1)
+    {
+        if (a & m)
+            prod ^= b;
+        b = (b >> 1) ^ (TMS_CRC32C_POLY & (0 - (b & 1)));
+    }
+    return prod;
+}
+
+
+// tms_crc32c_block_shift
+// x^(8 * TMS_CRC32C_BLOCK) mod P: multiplying a raw CRC by this appends
+//  TMS_CRC32C_BLOCK zero bytes to its message
+inline std::uint32_t tms_crc32c_block_shift() noexcept
+{
+    static const std::uint32_t shift = []
+    {
+        std::uint32_t result = 1u << 31;        // x^0
+        std::uint32_t power = 1u << 30;         // x^1
+        for (std::uint64_t e = 8 * TMS_CRC32C_BLOCK; e != 0; e >>= 1)
+        {
+            if (e & 1)
+                result = tms_crc32c_mulmod(result, power);
+            power = tms_crc32c_mulmod(power, power);
+        }
+        return result;
+    }();
+    return shift;
+}
+
+
+#ifdef TMS_SIMD_X86
+
+// tms_crc32c_hw
+// Same result as tms_crc32c_sw. The crc32 instruction has 3-cycle
+//  latency and 1-cycle throughput, so three blocks are fed as
+//  independent streams and joined: crc(A B) = crc(A) * x^(8|B|) ^ crc(B).
+__attribute__((target("sse4.2")))
+inline std::uint32_t tms_crc32c_hw(std::uint32_t crc, const unsigned char * p,
+                                   std::size_t n) noexcept
+{
+    if (n >= 3 * TMS_CRC32C_BLOCK)
+    {
+        const std::uint32_t shift = tms_crc32c_block_shift();
+        for (; n >= 3 * TMS_CRC32C_BLOCK; n -= 3 * TMS_CRC32C_BLOCK,
+                                          p += 3 * TMS_CRC32C_BLOCK)
+        {
+            std::uint64_t a = crc, b = 0, c = 0;
+            for (std::size_t k = 0; k < TMS_CRC32C_BLOCK; k += 8)
+            {
+                std::uint64_t wa, wb, wc;
+                std::memcpy(&wa, p + k, 8);
+                std::memcpy(&wb, p + TMS_CRC32C_BLOCK + k, 8);
+                std::memcpy(&wc, p + 2 * TMS_CRC32C_BLOCK + k, 8);
+                a = _mm_crc32_u64(a, wa);
+                b = _mm_crc32_u64(b, wb);
+                c = _mm_crc32_u64(c, wc);
+            }
+            crc = tms_crc32c_mulmod(shift, std::uint32_t(a)) ^ std::uint32_t(b);
+            crc = tms_crc32c_mulmod(shift, crc) ^ std::uint32_t(c);
+        }
+    }
+    std::uint64_t c64 = crc;
+    for (; n >= 8; n -= 8, p += 8)
+    {
+        std::uint64_t w;
+        std::memcpy(&w, p, 8);
+        c64 = _mm_crc32_u64(c64, w);
+    }
+    crc = std::uint32_t(c64);
+    for (; n > 0; --n)
+        crc = _mm_crc32_u8(crc, *p++);
+    return crc;
+}
+
+#endif // TMS_SIMD_X86
+
+
+// tms_crc32c
+// No-Throw Guarantee
+// Pre:
+//      [data, data + n) readable
+// Post:
+//      Returns CRC-32C of the bytes, continuing from crc (the result of
+//      an earlier call over the preceding bytes; 0 to start). Uses the
+//      crc32 instruction when tms_isa_limit() allows AVX2 (every AVX2 CPU
+//      has SSE4.2); tables otherwise.
+inline std::uint32_t tms_crc32c(const void * data, std::size_t n,
+                                std::uint32_t crc = 0) noexcept
+{
+    const unsigned char * p = static_cast<const unsigned char *>(data);
+    crc = ~crc;
+#ifdef TMS_SIMD_X86
+    if (tms_isa_limit() >= TMS_ISA_AVX2)
+        return ~tms_crc32c_hw(crc, p, n);
+#endif
+    return ~tms_crc32c_sw(crc, p, n);
+}
+
+
+// tms_crc32
+// No-Throw Guarantee
+// Pre:
+//      [data, data + n) readable
+// Post:
+//      Returns the zip/gzip CRC-32 of the bytes, continuing from crc as
+//      tms_crc32c does. Tables only: the crc32 instruction computes
+//      CRC-32C, not this polynomial.
+inline std::uint32_t tms_crc32(const void * data, std::size_t n,
+                               std::uint32_t crc = 0) noexcept
+{
+    return ~tms_crc_sw<TMS_CRC32_POLY>(~crc,
+                                       static_cast<const unsigned char *>(data),
+                                       n);
+}
@@ -0,0 +1,596 @@
+// tmsdelta.hpp
+// Matthew Johnson
+// 10/17/2026
+// delta-of-delta + zigzag varint integer array for nearly monotonic
+//  sequences (timestamps): streaming append, block seek, SIMD decode
+
+#pragma once
+// for single inclusion
+
+#include "tmsarray.hpp"
+// For class template TMSArray
+
+#include "tmssimd.hpp"
+// For tms_isa_limit
+// For TMS_SIMD_X86
+
+#include <cstddef>
+// For std::size_t
+
+#include <cstdint>
+// For std::uint64_t
+
+#include <cstring>
+// For std::memcpy
+
+#include <type_traits>
+// For std::is_integral
+
+
+
+// Values per block; each block header holds its first value and the
+//  byte offset of its code stream, so decoding any value touches one
+//  block
+constexpr std::size_t TMS_DELTA_BLOCK = 128;
+
+
+// tms_zigzag
+// Maps signed to unsigned so small magnitudes get small codes:
+//  0, -1, 1, -2, 2 ... -> 0, 1, 2, 3, 4 ...
+constexpr std::uint64_t tms_zigzag(std::uint64_t x) noexcept
+{
+    return (x << 1) ^ (0 - (x >> 63));
+}
+
+
+// tms_unzigzag
+// Inverse of tms_zigzag
+constexpr std::uint64_t tms_unzigzag(std::uint64_t u) noexcept
+{
+    return (u >> 1) ^ (0 - (u & 1));
+}
+
+
+// tms_varint_put
+// No-Throw Guarantee
+// Pre:
+//      dst has room for 10 bytes
+// Post:
+//      u written as LEB128 (7 bits per byte, high bit = more follow);
+//      returns bytes written, 1..10
+inline std::size_t tms_varint_put(std::uint64_t u, unsigned char * dst) noexcept
+{
+    std::size_t n = 0;
+    while (u >= 0x80)
+    {
+        dst[n++] = static_cast<unsigned char>(u | 0x80);
+        u >>= 7;
+    }
+    dst[n++] = static_cast<unsigned char>(u);
+    return n;
+}
+
+
+// tms_varint_squeeze
+// Joins the 7-bit groups of a LEB128 code held in the low bytes of x
+//  (continuation bits and bytes past the code already cleared)
+constexpr std::uint64_t tms_varint_squeeze(std::uint64_t x) noexcept
+{
+    x = ((x & 0x7F007F007F007F00ull) >> 1) | (x & 0x007F007F007F007Full);
+    x = ((x & 0x3FFF00003FFF0000ull) >> 2) | (x & 0x00003FFF00003FFFull);
+    return ((x & 0x0FFFFFFF00000000ull) >> 4) | (x & 0x000000000FFFFFFFull);
+}
+
+
+// tms_varint_decode
+// No-Throw Guarantee
+// Pre:
+//      src holds at least n LEB128 codes, followed by 7 readable bytes
+// Post:
+//      out[k] = tms_unzigzag(code k) for k in [0, n); returns bytes
+//      consumed. Works a word at a time: one 8-byte load, then every
+//      code that ends inside it is cut out at the clear high bits, so
+//      consecutive codes do not wait on each other's loads. Eight
+//      one-byte codes in a row (steady streams) are taken as a group.
+inline std::size_t tms_varint_decode(const unsigned char * src,
+                                     std::uint64_t * out,
+                                     std::size_t n) noexcept
+{
+    const unsigned char * p = src;
+    std::size_t k = 0;
+    while (k < n)
+    {
+        std::uint64_t w;
+        std::memcpy(&w, p, sizeof w);
+        std::uint64_t ends = ~w & 0x8080808080808080ull;
+        if (ends == 0x8080808080808080ull && k + 8 <= n)
+        {
+            for (unsigned b = 0; b < 8; ++b)
+                out[k + b] = tms_unzigzag((w >> (8 * b)) & 0xFF);
+            p += 8;
+            k += 8;
+            continue;
+        }
+        if (ends == 0)
+        {
+            // 9- or 10-byte code: values of 57 bits or more
+            std::uint64_t u = 0;
+            unsigned shift = 0;
+            unsigned char c;
+            do
+            {
+                c = *p++;
+                u |= std::uint64_t(c & 0x7F) << shift;
+                shift += 7;
+            } while (c & 0x80);
+            out[k++] = tms_unzigzag(u);
+            continue;
+        }
+        w &= 0x7F7F7F7F7F7F7F7Full;
+        unsigned start = 0;                     // bit where the code begins
+        do
+        {
+            const unsigned stop = unsigned(__builtin_ctzll(ends)) + 1;
+            const std::uint64_t field = stop == 64 ? w
+                : w & ((std::uint64_t(1) << stop) - 1);
+            out[k++] = tms_unzigzag(tms_varint_squeeze(field >> start));
+            start = stop;
+            ends &= ends - 1;
+        } while (ends != 0 && k < n);
+        p += start / 8;
+    }
+    return std::size_t(p - src);
+}
+
+
+
+// *********************************************************************
+// Second-order prefix-sum kernels
+// *********************************************************************
+
+
+// tms_delta_scan_scalar
+// d = d0 + running sum of dod; out[k] = v0 + running sum of d
+//  (all mod 2^64), for k in [0, n)
+inline void tms_delta_scan_scalar(const std::uint64_t * dod, std::size_t n,
+                                  std::uint64_t v0, std::uint64_t d0,
+                                  std::uint64_t * out) noexcept
+{
+    for (std::size_t k = 0; k < n; ++k)
+    {
+        d0 += dod[k];
+        v0 += d0;
+        out[k] = v0;
+    }
+}
+
+
+#ifdef TMS_SIMD_X86
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+
+// tms_scan4_avx2
+// In-register inclusive prefix sum of 4 int64 lanes
+__attribute__((target("avx2"), always_inline))
+inline __m256i tms_scan4_avx2(__m256i x) noexcept
+{
+    // [a b c d] + [0 a b c]
+    x = _mm256_add_epi64(x, _mm256_blend_epi32(
+            _mm256_permute4x64_epi64(x, 0x90), _mm256_setzero_si256(), 0x03));
+    // + the same moved up by 2 lanes
+    return _mm256_add_epi64(x, _mm256_permute2x128_si256(x, x, 0x08));
+}
+
+
+// tms_delta_scan_avx2
+// Same result as tms_delta_scan_scalar, 4 values per step: two
+//  in-register scans, each offset by the last lane of the step before
+__attribute__((target("avx2")))
+inline void tms_delta_scan_avx2(const std::uint64_t * dod, std::size_t n,
+                                std::uint64_t v0, std::uint64_t d0,
+                                std::uint64_t * out) noexcept
+{
+    __m256i cd = _mm256_set1_epi64x((long long)d0);
+    __m256i cv = _mm256_set1_epi64x((long long)v0);
+    std::size_t k = 0;
+    for (; k + 4 <= n; k += 4)
+    {
+        __m256i d = _mm256_add_epi64(tms_scan4_avx2(
+            _mm256_loadu_si256((const __m256i *)(dod + k))), cd);
+        __m256i v = _mm256_add_epi64(tms_scan4_avx2(d), cv);
+        _mm256_storeu_si256((__m256i *)(out + k), v);
+        cd = _mm256_permute4x64_epi64(d, 0xFF);
+        cv = _mm256_permute4x64_epi64(v, 0xFF);
+    }
+    if (k < n)
+    {
+        d0 = std::uint64_t(_mm256_extract_epi64(cd, 0));
+        v0 = std::uint64_t(_mm256_extract_epi64(cv, 0));
+        tms_delta_scan_scalar(dod + k, n - k, v0, d0, out + k);
+    }
+}
+
+
+// tms_scan8_avx512
+// In-register inclusive prefix sum of 8 int64 lanes: lanes moved up by
+//  1, 2, 4 (alignr against zero) and added
+__attribute__((target("avx512f"), always_inline))
+inline __m512i tms_scan8_avx512(__m512i x) noexcept
+{
+    const __m512i z = _mm512_setzero_si512();
+    x = _mm512_add_epi64(x, _mm512_alignr_epi64(x, z, 7));
+    x = _mm512_add_epi64(x, _mm512_alignr_epi64(x, z, 6));
+    return _mm512_add_epi64(x, _mm512_alignr_epi64(x, z, 4));
+}
+
+
+// tms_delta_scan_avx512
+// As tms_delta_scan_avx2, 8 values per step
+__attribute__((target("avx512f")))
+inline void tms_delta_scan_avx512(const std::uint64_t * dod, std::size_t n,
+                                  std::uint64_t v0, std::uint64_t d0,
+                                  std::uint64_t * out) noexcept
+{
+    const __m512i last = _mm512_set1_epi64(7);
+    __m512i cd = _mm512_set1_epi64((long long)d0);
+    __m512i cv = _mm512_set1_epi64((long long)v0);
+    std::size_t k = 0;
+    for (; k + 8 <= n; k += 8)
+    {
+        __m512i d = _mm512_add_epi64(tms_scan8_avx512(
+            _mm512_loadu_si512(dod + k)), cd);
+        __m512i v = _mm512_add_epi64(tms_scan8_avx512(d), cv);
+        _mm512_storeu_si512(out + k, v);
+        cd = _mm512_permutexvar_epi64(last, d);
+        cv = _mm512_permutexvar_epi64(last, v);
+    }
+    if (k < n)
+    {
+        d0 = std::uint64_t(_mm_cvtsi128_si64(_mm512_castsi512_si128(cd)));
+        v0 = std::uint64_t(_mm_cvtsi128_si64(_mm512_castsi512_si128(cv)));
+        tms_delta_scan_scalar(dod + k, n - k, v0, d0, out + k);
+    }
+}
+
+
+#pragma GCC diagnostic pop
+
+#endif // TMS_SIMD_X86
+
+
+// tms_delta_scan
+// No-Throw Guarantee
+// Pre:
+//      dod and out hold n values (they may be the same array)
+// Post:
+//      out[k] = v0 + sum over i <= k of (d0 + sum over l <= i of
+//      dod[l]), mod 2^64; best kernel allowed by tms_isa_limit()
+inline void tms_delta_scan(const std::uint64_t * dod, std::size_t n,
+                           std::uint64_t v0, std::uint64_t d0,
+                           std::uint64_t * out) noexcept
+{
+#ifdef TMS_SIMD_X86
+    const TMSIsa level = tms_isa_limit();
+    if (level >= TMS_ISA_AVX512)
+        return tms_delta_scan_avx512(dod, n, v0, d0, out);
+    if (level >= TMS_ISA_AVX2)
+        return tms_delta_scan_avx2(dod, n, v0, d0, out);
+#endif
+    tms_delta_scan_scalar(dod, n, v0, d0, out);
+}
+
+
+
+// *********************************************************************
+// class TMSDeltaArray - Class definition
+// *********************************************************************
+
+
+// class TMSDeltaArray
+// Append-only integer array compressed for nearly monotonic sequences.
+//  Values are grouped in blocks of TMS_DELTA_BLOCK. A block header keeps
+//  the first value and where the block's codes start; the rest of the
+//  block is one LEB128 varint per value, holding the zigzagged change in
+//  delta (v[k] - v[k-1]) - (v[k-1] - v[k-2]), the delta before the
+//  block's second value taken as 0. A regular stream (fixed sampling
+//  interval with jitter) costs about one byte per value.
+// Requirements on Types:
+//     Valtype is an integral type of at most 64 bits.
+// Invariants:
+//     _blocks.size() == ceil(_size / TMS_DELTA_BLOCK).
+//     _bytes[0, _used) holds the codes of every block, in order;
+//      _bytes.size() >= _used + 7 once any code is written.
+//     When _size % TMS_DELTA_BLOCK != 0, _last and _delta are the last
+//      value and the last delta of the open block.
+template <typename Valtype>
+class TMSDeltaArray
+{
+
+    static_assert(std::is_integral<Valtype>::value && sizeof(Valtype) <= 8,
+                  "TMSDeltaArray holds integers of at most 64 bits");
+
+public:
+
+
+    using value_type = Valtype;
+
+    using size_type  = std::size_t;
+
+
+private:
+
+
+    // Per-block header
+    struct Block
+    {
+        std::uint64_t first;    // value 0 of the block, as uint64 bits
+        std::uint64_t offset;   // first code byte in _bytes
+    };
+
+
+// ***** TMSDeltaArray: ctors *****
+public:
+
+
+    // Default ctor
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      empty()
+    TMSDeltaArray()
+        :_blocks(0),
+         _bytes(0),
+         _used(0),
+         _size(0),
+         _last(0),
+         _delta(0)
+    {}
+
+
+    // Ctor from plain array
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      holds values, in order
+    explicit TMSDeltaArray(const TMSArray<value_type> & values)
+        :TMSDeltaArray()
+    {
+        append(values.begin(), values.size());
+    }
+
+
+// ***** TMSDeltaArray: general public functions *****
+public:
+
+
+    // size
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns number of values
+    size_type size() const noexcept
+    {
+        return _size;
+    }
+
+
+    // empty
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns size() == 0
+    bool empty() const noexcept
+    {
+        return _size == 0;
+    }
+
+
+    // operator[]
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      0 <= index < size()
+    // Post:
+    //      Returns value index (by value: there is no stored object).
+    //      Decodes at most index % TMS_DELTA_BLOCK codes of one block.
+    value_type operator[](size_type index) const noexcept
+    {
+        const Block & blk = _blocks[index / TMS_DELTA_BLOCK];
+        const unsigned char * p = _bytes.begin() + blk.offset;
+        std::uint64_t v = blk.first, d = 0;
+        for (size_type j = index % TMS_DELTA_BLOCK; j > 0; --j)
+        {
+            std::uint64_t u = 0;
+            unsigned shift = 0;
+            unsigned char c;
+            do
+            {
+                c = *p++;
+                u |= std::uint64_t(c & 0x7F) << shift;
+                shift += 7;
+            } while (c & 0x80);
+            d += tms_unzigzag(u);
+            v += d;
+        }
+        return value_type(v);
+    }
+
+
+    // block_count
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns number of blocks, counting a partly filled last one
+    size_type block_count() const noexcept
+    {
+        return _blocks.size();
+    }
+
+
+    // block_first
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      block < block_count()
+    // Post:
+    //      Returns first value of block, without decoding
+    value_type block_first(size_type block) const noexcept
+    {
+        return value_type(_blocks[block].first);
+    }
+
+
+    // seek
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      Values are nondecreasing
+    // Post:
+    //      Returns index of the first value >= key, or size() if none:
+    //      binary search over block headers, then a scan of one block
+    size_type seek(value_type key) const noexcept
+    {
+        // First block whose first value is >= key; the answer is in the
+        //  block before it, or is that block's first value
+        size_type lo = 0, hi = _blocks.size();
+        while (lo < hi)
+        {
+            const size_type mid = lo + (hi - lo) / 2;
+            if (value_type(_blocks[mid].first) < key)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        if (lo == 0)
+            return 0;
+        const size_type block = lo - 1;
+        value_type buf[TMS_DELTA_BLOCK];
+        const size_type got = decode_block(block, buf);
+        size_type j = 0;
+        while (j < got && buf[j] < key)
+            ++j;
+        return block * TMS_DELTA_BLOCK + j;
+    }
+
+
+    // memory_bytes
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns bytes of codes and block headers in use
+    size_type memory_bytes() const noexcept
+    {
+        return _used + _blocks.size() * sizeof(Block);
+    }
+
+
+    // push_back
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      value appended; a new block opens every TMS_DELTA_BLOCK values
+    void push_back(value_type value)
+    {
+        const std::uint64_t v = std::uint64_t(value);
+        if (_size % TMS_DELTA_BLOCK == 0)
+        {
+            _blocks.resize(_blocks.size() + 1);     // may throw: no change
+            _blocks[_blocks.size() - 1] = Block{ v, _used };
+            _delta = 0;
+        }
+        else
+        {
+            const std::uint64_t d = v - _last;
+            const std::uint64_t code = tms_zigzag(d - _delta);
+            // Room for the longest code plus the 7 bytes of read slack
+            //  tms_varint_decode needs; TMSArray::resize doubles capacity,
+            //  so this is amortized
+            if (_bytes.size() < _used + 17)
+                _bytes.resize(_used + 17);          // may throw: no change
+            _used += tms_varint_put(code, _bytes.begin() + _used);
+            _delta = d;
+        }
+        _last = v;
+        ++_size;
+    }
+
+
+    // append
+    // Basic Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      [values, values + n) valid
+    // Post:
+    //      values appended, in order
+    void append(const value_type * values, size_type n)
+    {
+        for (size_type i = 0; i < n; ++i)
+            push_back(values[i]);
+    }
+
+
+    // decode_block
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      block < block_count(); out has room for TMS_DELTA_BLOCK values
+    // Post:
+    //      Writes block's values to out; returns how many (TMS_DELTA_BLOCK
+    //      except for a partly filled last block). Codes are parsed to
+    //      second differences, then both running sums are taken in one
+    //      SIMD pass.
+    size_type decode_block(size_type block, value_type * out) const noexcept
+    {
+        const Block & blk = _blocks[block];
+        const size_type n = block + 1 < _blocks.size()
+                            ? TMS_DELTA_BLOCK
+                            : _size - block * TMS_DELTA_BLOCK;
+        std::uint64_t buf[TMS_DELTA_BLOCK];
+        std::uint64_t * dst = sizeof(value_type) == sizeof(std::uint64_t)
+                              ? reinterpret_cast<std::uint64_t *>(out)
+                              : buf;
+        dst[0] = blk.first;
+        tms_varint_decode(_bytes.begin() + blk.offset, dst + 1, n - 1);
+        tms_delta_scan(dst + 1, n - 1, blk.first, 0, dst + 1);
+        if (dst == buf)
+            for (size_type j = 0; j < n; ++j)
+                out[j] = value_type(buf[j]);
+        return n;
+    }
+
+
+    // decode
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      out holds all values, in order
+    void decode(TMSArray<value_type> & out) const
+    {
+        out.resize(_size);
+        value_type * dst = out.begin();
+        for (size_type b = 0; b < _blocks.size(); ++b)
+            dst += decode_block(b, dst);
+    }
+
+
+// ***** TMSDeltaArray: data members *****
+private:
+
+    TMSArray<Block>         _blocks;
+    TMSArray<unsigned char> _bytes;
+    size_type               _used;      // code bytes in use
+    size_type               _size;      // values held
+    std::uint64_t           _last;      // last value appended
+    std::uint64_t           _delta;     // last delta in the open block
+
+}; // end of class
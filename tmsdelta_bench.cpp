@@ -0,0 +1,120 @@
+// tmsdelta_bench.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Benchmark: TMSDeltaArray<int64_t> vs. plain TMSArray<int64_t> on
+//  timestamp streams (ns clock): regular 1 ms sampling, 1 ms with
+//  jitter, and bursty event arrivals. Memory, append, decode GB/s at
+//  each ISA level, and seek.
+// Usage: tmsdelta_bench [values=16777216]
+// Requires tmsdelta.hpp, tmssimd.hpp, tmsarray.hpp, tmsbench.hpp
+
+#include "tmsdelta.hpp"
+#include "tmsbench.hpp"
+
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::int64_t;
+using std::uint64_t;
+#include <iostream>
+using std::cout;
+#include <string>
+using std::string;
+
+
+// makeStream
+// kind 0: every 1 ms exactly; 1: 1 ms +- 20 us jitter; 2: bursts of
+//  close events (~1-100 us apart) separated by idle gaps
+void makeStream(TMSArray<int64_t> & ta, int kind)
+{
+    uint64_t x = 88172645463325252ull;
+    int64_t t = 1700000000000000000;
+    int64_t planned = t;
+    for (size_t i = 0; i < ta.size(); ++i)
+    {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        if (kind == 0)
+            t += 1000000;
+        else if (kind == 1)
+        {
+            planned += 1000000;
+            t = planned + int64_t(x % 40000) - 20000;
+        }
+        else
+            t += x % 64 == 0 ? int64_t(x % 50000000)
+                             : int64_t(1000 + x % 99000);
+        ta[i] = t;
+    }
+}
+
+
+// benchStream
+void benchStream(size_t n, int kind, const char * name)
+{
+    TMSArray<int64_t> plain(n);
+    makeStream(plain, kind);
+    const size_t plainBytes = n * sizeof(int64_t);
+
+    cout << "\n== " << n << " timestamps, " << name << " ==\n";
+    double secs = tms_time_best(3, [&]
+    {
+        TMSDeltaArray<int64_t> td(plain);
+        tms_sink(td.size());
+    });
+    tms_report("append (encode)", secs, plainBytes);
+
+    TMSDeltaArray<int64_t> td(plain);
+    cout << "memory plain  " << plainBytes << " bytes\n"
+         << "memory delta  " << td.memory_bytes() << " bytes ("
+         << double(plainBytes) / double(td.memory_bytes()) << "x, "
+         << 8.0 * double(td.memory_bytes()) / double(n) << " bits/value)\n";
+
+    secs = tms_time_best(5, [&]
+    {
+        int64_t sum = 0;
+        for (int64_t v : plain)
+            sum += v;
+        tms_sink(sum);
+    });
+    tms_report("scan plain", secs, plainBytes);
+
+    TMSArray<int64_t> out(n);
+    const TMSIsa best = tms_detect_isa();
+    for (int level = TMS_ISA_SCALAR; level <= best; ++level)
+    {
+        tms_isa_limit() = TMSIsa(level);
+        secs = tms_time_best(5, [&]{ td.decode(out); tms_sink(out[n - 1]); });
+        // GB/s of decoded values delivered
+        tms_report(string("decode ") + tms_isa_name(TMSIsa(level)),
+                   secs, plainBytes);
+    }
+    tms_isa_limit() = best;
+
+    const size_t probes = size_t(1) << 18;
+    const int64_t lo = plain[0], span = plain[n - 1] - plain[0];
+    secs = tms_time_best(3, [&]
+    {
+        uint64_t y = 1;
+        size_t sum = 0;
+        for (size_t k = 0; k < probes; ++k)
+        {
+            y = y * 6364136223846793005ull + 1442695040888963407ull;
+            sum += td.seek(lo + int64_t((y >> 11) % uint64_t(span)));
+        }
+        tms_sink(sum);
+    });
+    tms_report("256K seeks", secs);
+}
+
+
+int main(int argc, char * argv[])
+{
+    const size_t n = tms_arg(argc, argv, 1, size_t(1) << 24);
+    benchStream(n, 0, "regular 1 ms");
+    benchStream(n, 1, "1 ms with 20 us jitter");
+    benchStream(n, 2, "bursty events");
+    return 0;
+}
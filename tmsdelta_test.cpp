@@ -0,0 +1,312 @@
+// tmsdelta_test.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Test program for class template TMSDeltaArray, tms_delta_scan,
+//  tms_varint_decode
+// Uses the "doctest" unit-testing framework, version 2
+// Requires doctest.h, tmsdelta.hpp, tmssimd.hpp, tmsarray.hpp
+
+// Includes for code to be tested
+#include "tmsdelta.hpp"      // For class template TMSDeltaArray
+#include "tmsdelta.hpp"      // Double-inclusion check, for testing only
+
+// Includes for the "doctest" unit-testing framework
+#define DOCTEST_CONFIG_IMPLEMENT
+                             // We write our own main
+#define DOCTEST_CONFIG_SUPER_FAST_ASSERTS
+                             // Reduce compile time
+#include "doctest.h"         // For doctest
+
+// Includes for all test programs
+#include <iostream>
+using std::cout;
+using std::endl;
+using std::cin;
+#include <string>
+using std::string;
+
+// Additional includes for this test program
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::int32_t;
+using std::int64_t;
+using std::uint64_t;
+#include <algorithm>
+using std::equal;
+using std::lower_bound;
+#include <limits>
+using std::numeric_limits;
+
+// Printable name for this test suite
+const string test_suite_name =
+    "class template TMSDeltaArray";
+
+
+// *********************************************************************
+// Helper Functions for This Test Program
+// *********************************************************************
+
+
+// fillStamps
+// Nondecreasing timestamps from start, step apart, with jitter in
+//  [0, jitter) and an occasional gap
+void fillStamps(TMSArray<int64_t> & ta, int64_t start, int64_t step,
+                uint64_t jitter, uint64_t seed)
+{
+    uint64_t x = seed * 0x9E3779B97F4A7C15ull + 3;
+    int64_t t = start;
+    for (size_t i = 0; i < ta.size(); ++i)
+    {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        t += step + int64_t(jitter ? x % jitter : 0);
+        if (x % 1000 == 0)
+            t += 1000 * step;
+        ta[i] = t;
+    }
+}
+
+
+// checkRoundTrip
+// Encoded copy of ta reads back element-wise and by decode, at each ISA
+//  level
+template <typename T>
+void checkRoundTrip(const TMSArray<T> & ta)
+{
+    TMSDeltaArray<T> td(ta);
+    REQUIRE( td.size() == ta.size() );
+    bool allMatch = true;
+    for (size_t i = 0; i < ta.size(); ++i)
+        allMatch = allMatch && td[i] == ta[i];
+    REQUIRE( allMatch );
+
+    const TMSIsa best = tms_detect_isa();
+    for (int level = TMS_ISA_SCALAR; level <= best; ++level)
+    {
+        INFO( "ISA " << tms_isa_name(TMSIsa(level)) );
+        tms_isa_limit() = TMSIsa(level);
+        TMSArray<T> out;
+        td.decode(out);
+        REQUIRE( out.size() == ta.size() );
+        REQUIRE( equal(out.begin(), out.end(), ta.begin()) );
+    }
+    tms_isa_limit() = best;
+}
+
+
+// *********************************************************************
+// Test Cases
+// *********************************************************************
+
+
+TEST_CASE( "Zigzag and varint coding" )
+{
+    SUBCASE( "zigzag maps small magnitudes to small codes" )
+    {
+        REQUIRE( tms_zigzag(0) == 0 );
+        REQUIRE( tms_zigzag(uint64_t(-1)) == 1 );
+        REQUIRE( tms_zigzag(1) == 2 );
+        REQUIRE( tms_zigzag(uint64_t(-2)) == 3 );
+        REQUIRE( tms_unzigzag(tms_zigzag(uint64_t(
+            numeric_limits<int64_t>::min()))) ==
+            uint64_t(numeric_limits<int64_t>::min()) );
+    }
+
+    SUBCASE( "varint round trip, short and long codes mixed" )
+    {
+        const uint64_t values[] = { 0, 1, 2, 3, 63, 64, 127, 128,
+                                    300, 1, 0, 5, 7, 9, 11, 13, 15,
+                                    ~uint64_t(0), 2, 4, 6, 8, 10, 12,
+                                    14, 16, 18, 1ull << 35 };
+        const size_t n = sizeof values / sizeof values[0];
+        unsigned char buf[10 * n];
+        size_t used = 0;
+        for (size_t k = 0; k < n; ++k)
+            used += tms_varint_put(tms_zigzag(values[k]), buf + used);
+        REQUIRE( tms_varint_put(~uint64_t(0), buf + used) == 10 );
+        uint64_t out[n];
+        REQUIRE( tms_varint_decode(buf, out, n) == used );
+        REQUIRE( equal(out, out + n, values) );
+    }
+}
+
+
+TEST_CASE( "tms_delta_scan matches the scalar kernel" )
+{
+    for (size_t n : { 0, 1, 3, 4, 7, 8, 9, 127, 300 })
+    {
+        INFO( "n " << n );
+        TMSArray<uint64_t> dod(n), want(n), got(n);
+        uint64_t x = 7;
+        for (size_t k = 0; k < n; ++k)
+        {
+            x = x * 6364136223846793005ull + 1442695040888963407ull;
+            dod[k] = (x >> 60) - 8;
+        }
+        tms_delta_scan_scalar(dod.begin(), n, 1000, 5, want.begin());
+        const TMSIsa best = tms_detect_isa();
+        for (int level = TMS_ISA_SCALAR; level <= best; ++level)
+        {
+            INFO( "ISA " << tms_isa_name(TMSIsa(level)) );
+            tms_isa_limit() = TMSIsa(level);
+            tms_delta_scan(dod.begin(), n, 1000, 5, got.begin());
+            REQUIRE( equal(got.begin(), got.end(), want.begin()) );
+        }
+        tms_isa_limit() = best;
+    }
+}
+
+
+TEST_CASE( "Round trips" )
+{
+    SUBCASE( "Regular timestamps with jitter and gaps" )
+    {
+        TMSArray<int64_t> ta(5000);
+        fillStamps(ta, 1700000000000000000, 1000000, 50, 1);
+        checkRoundTrip(ta);
+    }
+
+    SUBCASE( "Perfectly regular, one byte per value" )
+    {
+        TMSArray<int64_t> ta(TMS_DELTA_BLOCK * 20);
+        fillStamps(ta, 0, 10, 0, 0);
+        checkRoundTrip(ta);
+        TMSDeltaArray<int64_t> td(ta);
+        // 127 one-byte codes per block, plus headers
+        REQUIRE( td.memory_bytes() < ta.size() * 2 );
+    }
+
+    SUBCASE( "Unordered values and extremes" )
+    {
+        TMSArray<int64_t> ta(1000);
+        fillStamps(ta, -5000, -3, 1000000, 2);
+        ta[1] = numeric_limits<int64_t>::min();
+        ta[2] = numeric_limits<int64_t>::max();
+        ta[129] = 0;
+        checkRoundTrip(ta);
+    }
+
+    SUBCASE( "int32_t and partial last block" )
+    {
+        TMSArray<int32_t> ta(TMS_DELTA_BLOCK * 3 + 5);
+        for (size_t i = 0; i < ta.size(); ++i)
+            ta[i] = int32_t(i * 17 - 3000);
+        checkRoundTrip(ta);
+    }
+
+    SUBCASE( "Block boundary sizes" )
+    {
+        for (size_t n : { 0, 1, 2, 127, 128, 129, 256 })
+        {
+            INFO( "n " << n );
+            TMSArray<int64_t> ta(n);
+            fillStamps(ta, 99, 7, 3, n);
+            checkRoundTrip(ta);
+        }
+    }
+}
+
+
+TEST_CASE( "Streaming append and seek" )
+{
+    TMSArray<int64_t> ta(3000);
+    fillStamps(ta, 1000, 100, 20, 3);
+
+    SUBCASE( "push_back and append interleave" )
+    {
+        TMSDeltaArray<int64_t> td;
+        REQUIRE( td.empty() );
+        REQUIRE( td.block_count() == 0 );
+        td.push_back(ta[0]);
+        td.append(ta.begin() + 1, 2000);
+        for (size_t i = 2001; i < ta.size(); ++i)
+        {
+            td.push_back(ta[i]);
+            REQUIRE( td[i] == ta[i] );
+        }
+        REQUIRE( td.size() == ta.size() );
+        REQUIRE( td.block_count() ==
+                 (ta.size() + TMS_DELTA_BLOCK - 1) / TMS_DELTA_BLOCK );
+        REQUIRE( td.block_first(3) == ta[3 * TMS_DELTA_BLOCK] );
+        int64_t out[TMS_DELTA_BLOCK];
+        const size_t last = td.block_count() - 1;
+        REQUIRE( td.decode_block(last, out) ==
+                 ta.size() - last * TMS_DELTA_BLOCK );
+        REQUIRE( out[0] == ta[last * TMS_DELTA_BLOCK] );
+    }
+
+    SUBCASE( "seek agrees with lower_bound" )
+    {
+        TMSDeltaArray<int64_t> td(ta);
+        REQUIRE( td.seek(ta[0] - 1) == 0 );
+        REQUIRE( td.seek(ta[0]) == 0 );
+        REQUIRE( td.seek(ta[ta.size() - 1] + 1) == ta.size() );
+        bool allMatch = true;
+        for (int64_t key = ta[0] - 50; key < ta[ta.size() - 1] + 50; key += 37)
+        {
+            const size_t want = size_t(
+                lower_bound(ta.begin(), ta.end(), key) - ta.begin());
+            allMatch = allMatch && td.seek(key) == want;
+        }
+        REQUIRE( allMatch );
+    }
+
+    SUBCASE( "seek finds the first of a run that crosses blocks" )
+    {
+        TMSArray<int64_t> dup(600);
+        for (size_t i = 0; i < dup.size(); ++i)
+            dup[i] = i < 100 ? int64_t(i) : i < 400 ? 100 : int64_t(i);
+        TMSDeltaArray<int64_t> td(dup);
+        REQUIRE( td.seek(100) == 100 );
+        REQUIRE( td.seek(101) == 400 );
+        REQUIRE( td.seek(599) == 599 );
+    }
+}
+
+
+// *********************************************************************
+// Main Program
+// *********************************************************************
+
+
+// userPause
+// Wait for user to press ENTER: read all chars through first newline.
+void userPause()
+{
+    std::cout.flush();
+    while (std::cin.get() != '\n') ;
+}
+
+
+// Main program
+// Run all tests. Prompt for ENTER before exiting.
+int main(int argc,
+         char *argv[])
+{
+    doctest::Context dtcontext;
+                             // Primary doctest object
+    int dtresult;            // doctest return code; for return by main
+
+    // Handle command line
+    dtcontext.applyCommandLine(argc, argv);
+    dtresult = 0;            // doctest flags no command-line errors
+                             //  (strange but true)
+
+    if (!dtresult)           // Continue only if no command-line error
+    {
+        // Run test suites
+        cout << "BEGIN tests for " << test_suite_name << "\n" << endl;
+        dtresult = dtcontext.run();
+        cout << "END tests for " << test_suite_name << "\n" << endl;
+    }
+
+    // Wait for user
+    std::cout << "Press ENTER to quit ";
+    userPause();
+
+    // Program return value is return code from doctest
+    return dtresult;
+}
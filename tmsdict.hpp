@@ -0,0 +1,677 @@
+// tmsdict.hpp
+// Matthew Johnson
+// 10/17/2026
+// dictionary-encoded array for low-cardinality values: hash-deduplicated
+//  dictionary, 8/16/32-bit codes that widen as it grows, SIMD equality
+//  filters on codes
+
+#pragma once
+// for single inclusion
+
+#include "tmsarray.hpp"
+// For class template TMSArray
+// For TMSArray<bool>
+
+#include "tmssimd.hpp"
+// For tms_isa_limit
+// For TMS_SIMD_X86
+
+#include <cstddef>
+// For std::size_t
+
+#include <cstdint>
+// For std::uint8_t
+// For std::uint16_t
+// For std::uint32_t
+// For std::uint64_t
+
+#include <functional>
+// For std::hash
+// For std::equal_to
+
+#include <algorithm>
+// For std::fill
+// For std::copy
+
+
+
+// *********************************************************************
+// Code match kernels
+// *********************************************************************
+
+
+// Each kernel compares n codes of type C with key and writes bit j of
+//  words[j / 64] = (codes[j] == key), the bits of the last word past n
+//  cleared; words may be nullptr to only count. Returns the number of
+//  matches.
+
+
+// tms_code_match_scalar
+template <typename C>
+std::size_t tms_code_match_scalar(const C * codes, std::size_t n, C key,
+                                  std::uint64_t * words) noexcept
+{
+    std::size_t total = 0;
+    for (std::size_t base = 0; base < n; base += 64)
+    {
+        const std::size_t m = n - base < 64 ? n - base : 64;
+        std::uint64_t bits = 0;
+        for (std::size_t j = 0; j < m; ++j)
+            bits |= std::uint64_t(codes[base + j] == key) << j;
+        if (words)
+            words[base / 64] = bits;
+        total += std::size_t(__builtin_popcountll(bits));
+    }
+    return total;
+}
+
+
+#ifdef TMS_SIMD_X86
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+
+// tms_match64_avx2
+// Match mask of 64 codes: 8-bit codes give 32 bits per compare; 16-bit
+//  compares are packed to bytes first (packs works per 128-bit half,
+//  so the quadwords are put back in order); 32-bit ones 8 bits each
+template <typename C>
+__attribute__((target("avx2"), always_inline))
+inline std::uint64_t tms_match64_avx2(const C * codes, __m256i vkey) noexcept
+{
+    const __m256i * p = reinterpret_cast<const __m256i *>(codes);
+    if constexpr (sizeof(C) == 1)
+    {
+        const std::uint32_t lo = std::uint32_t(_mm256_movemask_epi8(
+            _mm256_cmpeq_epi8(_mm256_loadu_si256(p), vkey)));
+        const std::uint32_t hi = std::uint32_t(_mm256_movemask_epi8(
+            _mm256_cmpeq_epi8(_mm256_loadu_si256(p + 1), vkey)));
+        return std::uint64_t(lo) | (std::uint64_t(hi) << 32);
+    }
+    else if constexpr (sizeof(C) == 2)
+    {
+        std::uint64_t bits = 0;
+        for (unsigned h = 0; h < 2; ++h)
+        {
+            const __m256i a = _mm256_cmpeq_epi16(
+                _mm256_loadu_si256(p + 2 * h), vkey);
+            const __m256i b = _mm256_cmpeq_epi16(
+                _mm256_loadu_si256(p + 2 * h + 1), vkey);
+            const __m256i ab = _mm256_permute4x64_epi64(
+                _mm256_packs_epi16(a, b), 0xD8);
+            bits |= std::uint64_t(std::uint32_t(_mm256_movemask_epi8(ab)))
+                    << (32 * h);
+        }
+        return bits;
+    }
+    else
+    {
+        std::uint64_t bits = 0;
+        for (unsigned q = 0; q < 8; ++q)
+            bits |= std::uint64_t(_mm256_movemask_ps(_mm256_castsi256_ps(
+                        _mm256_cmpeq_epi32(_mm256_loadu_si256(p + q), vkey))))
+                    << (8 * q);
+        return bits;
+    }
+}
+
+
+// tms_code_match_avx2
+template <typename C>
+__attribute__((target("avx2,popcnt")))
+std::size_t tms_code_match_avx2(const C * codes, std::size_t n, C key,
+                                std::uint64_t * words) noexcept
+{
+    const __m256i vkey = sizeof(C) == 1 ? _mm256_set1_epi8(char(key))
+                       : sizeof(C) == 2 ? _mm256_set1_epi16(short(key))
+                                        : _mm256_set1_epi32(int(key));
+    std::size_t total = 0, base = 0;
+    for (; base + 64 <= n; base += 64)
+    {
+        const std::uint64_t bits = tms_match64_avx2(codes + base, vkey);
+        if (words)
+            words[base / 64] = bits;
+        total += std::size_t(_mm_popcnt_u64(bits));
+    }
+    return total + tms_code_match_scalar(codes + base, n - base, key,
+                                         words ? words + base / 64 : nullptr);
+}
+
+
+// tms_match64_avx512
+// Match mask of 64 codes straight from mask-register compares
+template <typename C>
+__attribute__((target("avx512f,avx512bw"), always_inline))
+inline std::uint64_t tms_match64_avx512(const C * codes, __m512i vkey) noexcept
+{
+    if constexpr (sizeof(C) == 1)
+        return _mm512_cmpeq_epi8_mask(_mm512_loadu_si512(codes), vkey);
+    else if constexpr (sizeof(C) == 2)
+    {
+        // Explicit mask-to-integer moves: GCC 12 at -O1 can spill a
+        //  __mmask32 as 4 bytes and reload it as 8 when widened directly
+        const std::uint32_t lo = _cvtmask32_u32(_mm512_cmpeq_epi16_mask(
+            _mm512_loadu_si512(codes), vkey));
+        const std::uint32_t hi = _cvtmask32_u32(_mm512_cmpeq_epi16_mask(
+            _mm512_loadu_si512(codes + 32), vkey));
+        return std::uint64_t(lo) | (std::uint64_t(hi) << 32);
+    }
+    else
+    {
+        std::uint64_t bits = 0;
+        for (unsigned q = 0; q < 4; ++q)
+            bits |= std::uint64_t(_cvtmask16_u32(_mm512_cmpeq_epi32_mask(
+                        _mm512_loadu_si512(codes + 16 * q), vkey)))
+                    << (16 * q);
+        return bits;
+    }
+}
+
+
+// tms_code_match_avx512
+template <typename C>
+__attribute__((target("avx512f,avx512bw,popcnt")))
+std::size_t tms_code_match_avx512(const C * codes, std::size_t n, C key,
+                                  std::uint64_t * words) noexcept
+{
+    const __m512i vkey = sizeof(C) == 1 ? _mm512_set1_epi8(char(key))
+                       : sizeof(C) == 2 ? _mm512_set1_epi16(short(key))
+                                        : _mm512_set1_epi32(int(key));
+    std::size_t total = 0, base = 0;
+    for (; base + 64 <= n; base += 64)
+    {
+        const std::uint64_t bits = tms_match64_avx512(codes + base, vkey);
+        if (words)
+            words[base / 64] = bits;
+        total += std::size_t(_mm_popcnt_u64(bits));
+    }
+    return total + tms_code_match_scalar(codes + base, n - base, key,
+                                         words ? words + base / 64 : nullptr);
+}
+
+
+#pragma GCC diagnostic pop
+
+#endif // TMS_SIMD_X86
+
+
+// tms_code_match
+// No-Throw Guarantee
+// Pre:
+//      [codes, codes + n) valid; words, if not nullptr, has room for
+//      ceil(n / 64) words
+// Post:
+//      See above; best kernel allowed by tms_isa_limit()
+template <typename C>
+std::size_t tms_code_match(const C * codes, std::size_t n, C key,
+                           std::uint64_t * words) noexcept
+{
+#ifdef TMS_SIMD_X86
+    const TMSIsa level = tms_isa_limit();
+    if (level >= TMS_ISA_AVX512)
+        return tms_code_match_avx512(codes, n, key, words);
+    if (level >= TMS_ISA_AVX2)
+        return tms_code_match_avx2(codes, n, key, words);
+#endif
+    return tms_code_match_scalar(codes, n, key, words);
+}
+
+
+
+// *********************************************************************
+// class TMSDictArray - Class definition
+// *********************************************************************
+
+
+// class TMSDictArray
+// Array of values drawn from a small set, stored as one copy of each
+//  distinct value (the dictionary) plus an integer code per element.
+//  Codes are 1 byte while there are at most 256 distinct values, then 2,
+//  then 4; the code array is rewritten once at each widening. A linear-
+//  probing hash table over the dictionary finds the code for a value,
+//  so an equality filter is one lookup then a SIMD scan of the codes,
+//  and the stored values are never compared or copied.
+// Requirements on Types:
+//     Valtype is copy-assignable and default-constructible; Hash and
+//      Equal are function objects consistent with each other.
+// Invariants:
+//     _dict holds distinct values; code c means _dict[c].
+//     _width (1, 2 or 4) is the narrowest code width that holds
+//      _dict.size() - 1; the code array of that width (_codes8, _codes16
+//      or _codes32) holds _size codes and the other two are empty.
+//     _slots.size() is 0 or a power of two at least 2 * _dict.size();
+//      a slot holds code + 1, or 0 if empty.
+template <typename Valtype,
+          typename Hash = std::hash<Valtype>,
+          typename Equal = std::equal_to<Valtype>>
+class TMSDictArray
+{
+
+public:
+
+
+    using value_type = Valtype;
+
+    using size_type  = std::size_t;
+
+    using code_type  = std::uint32_t;
+
+    // Returned by find_code for a value not in the dictionary
+    static constexpr code_type npos = ~code_type(0);
+
+
+// ***** TMSDictArray: ctors *****
+public:
+
+
+    // Default ctor
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      empty(); cardinality() == 0
+    TMSDictArray()
+        :_dict(0),
+         _slots(0),
+         _codes8(0),
+         _codes16(0),
+         _codes32(0),
+         _width(1),
+         _size(0)
+    {}
+
+
+    // Ctor from plain array
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      holds values, in order
+    explicit TMSDictArray(const TMSArray<value_type> & values)
+        :TMSDictArray()
+    {
+        append(values.begin(), values.size());
+    }
+
+
+// ***** TMSDictArray: general public functions *****
+public:
+
+
+    // size
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns number of elements
+    size_type size() const noexcept
+    {
+        return _size;
+    }
+
+
+    // empty
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns size() == 0
+    bool empty() const noexcept
+    {
+        return _size == 0;
+    }
+
+
+    // cardinality
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns number of distinct values
+    size_type cardinality() const noexcept
+    {
+        return _dict.size();
+    }
+
+
+    // code_width
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns bytes per code: 1, 2 or 4
+    unsigned code_width() const noexcept
+    {
+        return _width;
+    }
+
+
+    // dictionary
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns the distinct values; code c is dictionary()[c]
+    const TMSArray<value_type> & dictionary() const noexcept
+    {
+        return _dict;
+    }
+
+
+    // code
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      0 <= index < size()
+    // Post:
+    //      Returns code of element index
+    code_type code(size_type index) const noexcept
+    {
+        if (_width == 1)
+            return _codes8[index];
+        if (_width == 2)
+            return _codes16[index];
+        return _codes32[index];
+    }
+
+
+    // operator[]
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      0 <= index < size()
+    // Post:
+    //      Returns the dictionary entry for element index
+    const value_type & operator[](size_type index) const noexcept
+    {
+        return _dict[code(index)];
+    }
+
+
+    // find_code
+    // No-Throw Guarantee (Basic if Hash or Equal throws)
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns code of value, or npos if value is not in the
+    //      dictionary
+    code_type find_code(const value_type & value) const
+    {
+        if (_slots.size() == 0)
+            return npos;
+        const size_type mask = _slots.size() - 1;
+        for (size_type s = slotOf(value); ; s = (s + 1) & mask)
+        {
+            const code_type c = _slots[s];
+            if (c == 0)
+                return npos;
+            if (_eq(_dict[c - 1], value))
+                return c - 1;
+        }
+    }
+
+
+    // memory_bytes
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns bytes of codes, hash table and dictionary elements in
+    //      use (not counting storage a value owns, such as a long
+    //      string's heap buffer)
+    size_type memory_bytes() const noexcept
+    {
+        return _size * _width + _slots.size() * sizeof(code_type)
+               + _dict.size() * sizeof(value_type);
+    }
+
+
+    // push_back
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      value appended; a value not seen before is added to the
+    //      dictionary, widening the codes if the new code needs it
+    void push_back(const value_type & value)
+    {
+        code_type c = find_code(value);
+        if (c == npos)
+            c = addValue(value);
+        else
+            growCodes(_size + 1);                   // may throw: no change
+        storeCode(_size, c);
+        ++_size;
+    }
+
+
+    // append
+    // Basic Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      [values, values + n) valid
+    // Post:
+    //      values appended, in order
+    void append(const value_type * values, size_type n)
+    {
+        for (size_type i = 0; i < n; ++i)
+            push_back(values[i]);
+    }
+
+
+    // filter_equal
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      out.size() == size(); out[i] == (element i == value). Returns
+    //      the number of matches. Takes one dictionary lookup, then
+    //      compares codes 64 at a time with SIMD.
+    size_type filter_equal(const value_type & value, TMSArray<bool> & out) const
+    {
+        TMSArray<bool> bits(_size);
+        const code_type c = find_code(value);
+        size_type total = 0;
+        if (c != npos)
+            total = matchCodes(c, bits.words());
+        out.swap(bits);
+        return total;
+    }
+
+
+    // count_equal
+    // No-Throw Guarantee (Basic if Hash or Equal throws)
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns number of elements equal to value
+    size_type count_equal(const value_type & value) const
+    {
+        const code_type c = find_code(value);
+        return c == npos ? 0 : matchCodes(c, nullptr);
+    }
+
+
+    // decode
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      out holds all values, in order
+    void decode(TMSArray<value_type> & out) const
+    {
+        TMSArray<value_type> values(_size);
+        if (_width == 1)
+            decodeFrom(_codes8.begin(), values.begin());
+        else if (_width == 2)
+            decodeFrom(_codes16.begin(), values.begin());
+        else
+            decodeFrom(_codes32.begin(), values.begin());
+        out.swap(values);
+    }
+
+
+// ***** TMSDictArray: private helpers *****
+private:
+
+
+    // slotOf
+    // Home slot of value: the hash spread by a Fibonacci multiply, top
+    //  bits kept (std::hash of an integer is often the integer itself)
+    size_type slotOf(const value_type & value) const
+    {
+        const std::uint64_t h = std::uint64_t(_hash(value))
+                                * 0x9E3779B97F4A7C15ull;
+        const unsigned bits = unsigned(__builtin_ctzll(_slots.size()));
+        return size_type(h >> (64 - bits));
+    }
+
+
+    // storeCode
+    // Writes c as code index at the current width
+    void storeCode(size_type index, code_type c) noexcept
+    {
+        if (_width == 1)
+            _codes8[index] = std::uint8_t(c);
+        else if (_width == 2)
+            _codes16[index] = std::uint16_t(c);
+        else
+            _codes32[index] = c;
+    }
+
+
+    // growCodes
+    // Resizes the code array in use to n codes
+    void growCodes(size_type n)
+    {
+        if (_width == 1)
+            _codes8.resize(n);
+        else if (_width == 2)
+            _codes16.resize(n);
+        else
+            _codes32.resize(n);
+    }
+
+
+    // addValue
+    // Adds value (not present) to the dictionary, with room for one more
+    //  code; returns its code. Strong: the new table and any widened code
+    //  array are built aside, and the dictionary append is the last step
+    //  that may throw.
+    code_type addValue(const value_type & value)
+    {
+        const code_type c = code_type(_dict.size());
+        const unsigned width = c <= 0xFF ? 1 : c <= 0xFFFF ? 2 : 4;
+
+        // Widening happens at c == 256 (1 -> 2) and c == 65536 (2 -> 4)
+        TMSArray<std::uint16_t> codes16(0);
+        TMSArray<std::uint32_t> codes32(0);
+        if (width == _width)
+            growCodes(_size + 1);
+        else if (width == 2)
+        {
+            codes16.resize(_size + 1);
+            std::copy(_codes8.begin(), _codes8.begin() + _size,
+                      codes16.begin());
+        }
+        else
+        {
+            codes32.resize(_size + 1);
+            std::copy(_codes16.begin(), _codes16.begin() + _size,
+                      codes32.begin());
+        }
+
+        TMSArray<code_type> slots(0);
+        const bool grow = 2 * (_dict.size() + 1) > _slots.size();
+        if (grow)
+        {
+            slots.resize(_slots.size() == 0 ? 16 : 2 * _slots.size());
+            std::fill(slots.begin(), slots.end(), code_type(0));
+        }
+
+        _dict.resize(_dict.size() + 1);
+        try
+        {
+            _dict[c] = value;
+        }
+        catch (...)
+        {
+            _dict.resize(c);
+            throw;
+        }
+
+        // No-throw from here, except Hash: a throwing Hash leaves the
+        //  table to be rebuilt, so it is only Basic then
+        if (grow)
+        {
+            _slots.swap(slots);
+            for (code_type k = 0; k < c; ++k)
+                placeCode(k);
+        }
+        placeCode(c);
+        if (width == 2 && _width == 1)
+        {
+            _codes16.swap(codes16);
+            _codes8.resize(0);
+        }
+        else if (width == 4 && _width == 2)
+        {
+            _codes32.swap(codes32);
+            _codes16.resize(0);
+        }
+        _width = width;
+        return c;
+    }
+
+
+    // placeCode
+    // Puts code k into the first free slot on its probe path
+    void placeCode(code_type k)
+    {
+        const size_type mask = _slots.size() - 1;
+        size_type s = slotOf(_dict[k]);
+        while (_slots[s] != 0)
+            s = (s + 1) & mask;
+        _slots[s] = k + 1;
+    }
+
+
+    // matchCodes
+    // Runs the code match kernel at the current width
+    size_type matchCodes(code_type c, std::uint64_t * words) const noexcept
+    {
+        if (_width == 1)
+            return tms_code_match(_codes8.begin(), _size, std::uint8_t(c),
+                                  words);
+        if (_width == 2)
+            return tms_code_match(_codes16.begin(), _size, std::uint16_t(c),
+                                  words);
+        return tms_code_match(_codes32.begin(), _size, c, words);
+    }
+
+
+    // decodeFrom
+    // out[i] = _dict[codes[i]]
+    template <typename C>
+    void decodeFrom(const C * codes, value_type * out) const
+    {
+        for (size_type i = 0; i < _size; ++i)
+            out[i] = _dict[codes[i]];
+    }
+
+
+// ***** TMSDictArray: data members *****
+private:
+
+    TMSArray<value_type>    _dict;
+    TMSArray<code_type>     _slots;
+    TMSArray<std::uint8_t>  _codes8;
+    TMSArray<std::uint16_t> _codes16;
+    TMSArray<std::uint32_t> _codes32;
+    unsigned                _width;     // bytes per code
+    size_type               _size;
+    Hash                    _hash;
+    Equal                   _eq;
+
+}; // end of class
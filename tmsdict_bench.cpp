@@ -0,0 +1,136 @@
+// tmsdict_bench.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Benchmark: TMSDictArray<std::string> vs. plain TMSArray<std::string>
+//  for low-cardinality columns (HTTP status codes, hostnames): memory,
+//  build, copy, equality count and bitmap filter at each ISA level,
+//  and decode.
+// Usage: tmsdict_bench [values=4194304]
+// Requires tmsdict.hpp, tmssimd.hpp, tmsarray.hpp, tmsbitarray.hpp,
+//  tmsbench.hpp
+
+#include "tmsdict.hpp"
+#include "tmsbench.hpp"
+
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::uint64_t;
+#include <iostream>
+using std::cout;
+#include <string>
+using std::string;
+using std::to_string;
+
+
+// heapBytes
+// Bytes of a string array including each string's own heap buffer
+//  (libstdc++ keeps up to 15 chars inline)
+size_t heapBytes(const string * first, size_t n)
+{
+    size_t total = n * sizeof(string);
+    for (size_t i = 0; i < n; ++i)
+        if (first[i].capacity() > 15)
+            total += first[i].capacity() + 1;
+    return total;
+}
+
+
+// benchColumn
+void benchColumn(const TMSArray<string> & names, size_t n, const char * label)
+{
+    TMSArray<string> plain(n);
+    uint64_t x = 88172645463325252ull;
+    for (size_t i = 0; i < n; ++i)
+    {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        // Skewed: low names far more frequent
+        const size_t k = size_t((x % names.size()) * (x % names.size()))
+                         / names.size();
+        plain[i] = names[k];
+    }
+    const string key = names[1];
+
+    cout << "\n== " << n << " values, " << names.size() << " distinct "
+         << label << " ==\n";
+
+    double secs = tms_time_best(3, [&]
+    {
+        TMSDictArray<string> td(plain);
+        tms_sink(td.size());
+    });
+    tms_report("build dict (encode)", secs);
+    secs = tms_time_best(3, [&]
+    {
+        TMSArray<string> copy(plain);
+        tms_sink(copy.size());
+    });
+    tms_report("copy plain", secs);
+
+    TMSDictArray<string> td(plain);
+    secs = tms_time_best(3, [&]
+    {
+        TMSDictArray<string> copy(td);
+        tms_sink(copy.size());
+    });
+    tms_report("copy dict", secs);
+
+    const size_t plainBytes = heapBytes(plain.begin(), n);
+    const size_t dictBytes = td.memory_bytes()
+                             + heapBytes(td.dictionary().begin(), td.cardinality())
+                             - td.cardinality() * sizeof(string);
+    cout << "memory plain  " << plainBytes << " bytes\n"
+         << "memory dict   " << dictBytes << " bytes ("
+         << double(plainBytes) / double(dictBytes) << "x, "
+         << td.code_width() << "-byte codes)\n";
+
+    secs = tms_time_best(5, [&]
+    {
+        size_t hits = 0;
+        for (const string & s : plain)
+            hits += s == key;
+        tms_sink(hits);
+    });
+    tms_report("count == plain", secs, n * sizeof(string));
+
+    TMSArray<bool> bits(n);
+    const TMSIsa best = tms_detect_isa();
+    for (int level = TMS_ISA_SCALAR; level <= best; ++level)
+    {
+        tms_isa_limit() = TMSIsa(level);
+        secs = tms_time_best(5, [&]{ tms_sink(td.count_equal(key)); });
+        // GB/s of codes scanned
+        tms_report(string("count == dict ") + tms_isa_name(TMSIsa(level)),
+                   secs, n * td.code_width());
+        secs = tms_time_best(5, [&]{ tms_sink(td.filter_equal(key, bits)); });
+        tms_report(string("filter bitmap ") + tms_isa_name(TMSIsa(level)),
+                   secs, n * td.code_width());
+    }
+    tms_isa_limit() = best;
+
+    TMSArray<string> out;
+    secs = tms_time_best(3, [&]{ td.decode(out); tms_sink(out.size()); });
+    tms_report("decode to strings", secs);
+}
+
+
+int main(int argc, char * argv[])
+{
+    const size_t n = tms_arg(argc, argv, 1, size_t(1) << 22);
+
+    const char * codes[] = { "200", "404", "304", "500", "301", "302",
+                             "401", "403", "503", "502", "201", "204" };
+    TMSArray<string> status(12);
+    for (size_t k = 0; k < 12; ++k)
+        status[k] = codes[k];
+    benchColumn(status, n, "status codes");
+
+    TMSArray<string> hosts(2000);
+    for (size_t k = 0; k < hosts.size(); ++k)
+        hosts[k] = "api-" + to_string(k) + ".us-east-1.prod.example.com";
+    benchColumn(hosts, n, "hostnames");
+    return 0;
+}
@@ -0,0 +1,305 @@
+// tmsdict_test.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Test program for class template TMSDictArray, tms_code_match
+// Uses the "doctest" unit-testing framework, version 2
+// Requires doctest.h, tmsdict.hpp, tmssimd.hpp, tmsarray.hpp,
+//  tmsbitarray.hpp
+
+// Includes for code to be tested
+#include "tmsdict.hpp"       // For class template TMSDictArray
+#include "tmsdict.hpp"       // Double-inclusion check, for testing only
+
+// Includes for the "doctest" unit-testing framework
+#define DOCTEST_CONFIG_IMPLEMENT
+                             // We write our own main
+#define DOCTEST_CONFIG_SUPER_FAST_ASSERTS
+                             // Reduce compile time
+#include "doctest.h"         // For doctest
+
+// Includes for all test programs
+#include <iostream>
+using std::cout;
+using std::endl;
+using std::cin;
+#include <string>
+using std::string;
+using std::to_string;
+
+// Additional includes for this test program
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::uint8_t;
+using std::uint16_t;
+using std::uint32_t;
+using std::uint64_t;
+#include <algorithm>
+using std::equal;
+using std::count;
+#include <stdexcept>
+using std::runtime_error;
+
+// Printable name for this test suite
+const string test_suite_name =
+    "class template TMSDictArray";
+
+
+// *********************************************************************
+// Helper Functions for This Test Program
+// *********************************************************************
+
+
+// fillNames
+// n strings drawn from distinct names of the form "host-<k>.example"
+void fillNames(TMSArray<string> & ta, size_t distinct, uint64_t seed)
+{
+    uint64_t x = seed * 0x9E3779B97F4A7C15ull + 3;
+    for (size_t i = 0; i < ta.size(); ++i)
+    {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        ta[i] = "host-" + to_string(x % distinct) + ".example";
+    }
+}
+
+
+// checkCodeMatch
+// tms_code_match at each ISA level agrees with a scalar loop
+template <typename C>
+void checkCodeMatch(size_t n, C key)
+{
+    TMSArray<C> codes(n);
+    for (size_t i = 0; i < n; ++i)
+        codes[i] = C(i % 7 == 3 ? key : (i * 31) % 5 + key + 1);
+    size_t want = 0;
+    for (size_t i = 0; i < n; ++i)
+        want += codes[i] == key;
+
+    const TMSIsa best = tms_detect_isa();
+    for (int level = TMS_ISA_SCALAR; level <= best; ++level)
+    {
+        INFO( "ISA " << tms_isa_name(TMSIsa(level)) << ", n " << n );
+        tms_isa_limit() = TMSIsa(level);
+        TMSArray<bool> bits(n);
+        REQUIRE( tms_code_match(codes.begin(), n, key, bits.words()) == want );
+        REQUIRE( tms_code_match(codes.begin(), n, key,
+                                (uint64_t *)nullptr) == want );
+        bool allMatch = true;
+        for (size_t i = 0; i < n; ++i)
+            allMatch = allMatch && bits[i] == (codes[i] == key);
+        REQUIRE( allMatch );
+        REQUIRE( bits.count() == want );    // no stray bits past n
+    }
+    tms_isa_limit() = best;
+}
+
+
+// Throws when assigned a value equal to poison
+struct Touchy
+{
+    static int poison;
+    int v = 0;
+
+    Touchy() = default;
+    Touchy(int x) : v(x) {}
+    Touchy(const Touchy & other) : v(other.v) {}
+    Touchy & operator=(const Touchy & other)
+    {
+        if (other.v == poison)
+            throw runtime_error("Touchy");
+        v = other.v;
+        return *this;
+    }
+    bool operator==(const Touchy & other) const { return v == other.v; }
+};
+int Touchy::poison = -1;
+
+struct TouchyHash
+{
+    size_t operator()(const Touchy & t) const { return size_t(t.v); }
+};
+
+
+// *********************************************************************
+// Test Cases
+// *********************************************************************
+
+
+TEST_CASE( "tms_code_match at each code width" )
+{
+    for (size_t n : { 0, 1, 63, 64, 65, 200, 1000 })
+    {
+        checkCodeMatch<uint8_t>(n, 200);
+        checkCodeMatch<uint16_t>(n, 40000);
+        checkCodeMatch<uint32_t>(n, 3000000000u);
+    }
+}
+
+
+TEST_CASE( "Strings round trip and dedupe" )
+{
+    TMSArray<string> ta(5000);
+    fillNames(ta, 40, 1);
+    TMSDictArray<string> td(ta);
+    REQUIRE( td.size() == ta.size() );
+    REQUIRE( td.cardinality() == 40 );
+    REQUIRE( td.code_width() == 1 );
+
+    bool allMatch = true;
+    for (size_t i = 0; i < ta.size(); ++i)
+        allMatch = allMatch && td[i] == ta[i]
+                   && td.dictionary()[td.code(i)] == ta[i];
+    REQUIRE( allMatch );
+
+    TMSArray<string> out;
+    td.decode(out);
+    REQUIRE( out.size() == ta.size() );
+    REQUIRE( equal(out.begin(), out.end(), ta.begin()) );
+
+    REQUIRE( td.find_code(ta[0]) == td.code(0) );
+    REQUIRE( td.find_code("missing") == TMSDictArray<string>::npos );
+}
+
+
+TEST_CASE( "Filters on codes" )
+{
+    TMSArray<string> ta(3001);
+    fillNames(ta, 12, 2);
+    TMSDictArray<string> td(ta);
+    const string key = ta[17];
+    const size_t want = size_t(count(ta.begin(), ta.end(), key));
+
+    const TMSIsa best = tms_detect_isa();
+    for (int level = TMS_ISA_SCALAR; level <= best; ++level)
+    {
+        INFO( "ISA " << tms_isa_name(TMSIsa(level)) );
+        tms_isa_limit() = TMSIsa(level);
+        REQUIRE( td.count_equal(key) == want );
+        TMSArray<bool> hits;
+        REQUIRE( td.filter_equal(key, hits) == want );
+        REQUIRE( hits.size() == ta.size() );
+        bool allMatch = true;
+        for (size_t i = 0; i < ta.size(); ++i)
+            allMatch = allMatch && hits[i] == (ta[i] == key);
+        REQUIRE( allMatch );
+    }
+    tms_isa_limit() = best;
+
+    TMSArray<bool> hits(5);
+    REQUIRE( td.count_equal("missing") == 0 );
+    REQUIRE( td.filter_equal("missing", hits) == 0 );
+    REQUIRE( hits.size() == ta.size() );
+    REQUIRE( hits.count() == 0 );
+}
+
+
+TEST_CASE( "Codes widen as the dictionary grows" )
+{
+    TMSDictArray<uint64_t> td;
+    REQUIRE( td.empty() );
+    REQUIRE( td.code_width() == 1 );
+    for (uint64_t v = 0; v < 256; ++v)
+        td.push_back(v * 1000);
+    REQUIRE( td.code_width() == 1 );
+    td.push_back(256000);
+    REQUIRE( td.code_width() == 2 );
+    REQUIRE( td.cardinality() == 257 );
+    for (uint64_t v = 0; v < 70000; ++v)
+        td.push_back(v % 300 * 1000);
+    REQUIRE( td.code_width() == 2 );
+    for (uint64_t v = 0; v < 66000; ++v)
+        td.push_back(v * 1000);
+    REQUIRE( td.code_width() == 4 );
+    REQUIRE( td.cardinality() == 66000 );
+
+    bool allMatch = true;
+    for (size_t i = 0; i < 257; ++i)
+        allMatch = allMatch && td[i] == i * 1000;
+    for (size_t i = 0; i < 70000; ++i)
+        allMatch = allMatch && td[257 + i] == i % 300 * 1000;
+    for (size_t i = 0; i < 66000; ++i)
+        allMatch = allMatch && td[70257 + i] == i * 1000;
+    REQUIRE( allMatch );
+    // 5000 occurs once in the first run, 234 times at i % 300 == 5 in the
+    //  second, once in the third
+    REQUIRE( td.count_equal(5000) == 1 + (70000 - 5 + 299) / 300 + 1 );
+}
+
+
+TEST_CASE( "Memory versus plain strings" )
+{
+    TMSArray<string> ta(10000);
+    fillNames(ta, 100, 3);
+    TMSDictArray<string> td(ta);
+    // One code byte per element plus 100 strings and a small table
+    REQUIRE( td.memory_bytes() < ta.size() * 2 + 100 * sizeof(string) + 4096 );
+}
+
+
+TEST_CASE( "push_back is strong when the value copy throws" )
+{
+    TMSDictArray<Touchy, TouchyHash> td;
+    for (int v = 0; v < 300; ++v)
+        td.push_back(Touchy(v % 20));
+    REQUIRE( td.cardinality() == 20 );
+
+    Touchy::poison = 77;
+    REQUIRE_THROWS( td.push_back(Touchy(77)) );
+    Touchy::poison = -1;
+    REQUIRE( td.size() == 300 );
+    REQUIRE( td.cardinality() == 20 );
+    REQUIRE( td.find_code(Touchy(77)) == TMSDictArray<Touchy, TouchyHash>::npos );
+    REQUIRE( td.count_equal(Touchy(3)) == 15 );
+
+    td.push_back(Touchy(77));
+    REQUIRE( td.size() == 301 );
+    REQUIRE( td[300].v == 77 );
+}
+
+
+// *********************************************************************
+// Main Program
+// *********************************************************************
+
+
+// userPause
+// Wait for user to press ENTER: read all chars through first newline.
+void userPause()
+{
+    std::cout.flush();
+    while (std::cin.get() != '\n') ;
+}
+
+
+// Main program
+// Run all tests. Prompt for ENTER before exiting.
+int main(int argc,
+         char *argv[])
+{
+    doctest::Context dtcontext;
+                             // Primary doctest object
+    int dtresult;            // doctest return code; for return by main
+
+    // Handle command line
+    dtcontext.applyCommandLine(argc, argv);
+    dtresult = 0;            // doctest flags no command-line errors
+                             //  (strange but true)
+
+    if (!dtresult)           // Continue only if no command-line error
+    {
+        // Run test suites
+        cout << "BEGIN tests for " << test_suite_name << "\n" << endl;
+        dtresult = dtcontext.run();
+        cout << "END tests for " << test_suite_name << "\n" << endl;
+    }
+
+    // Wait for user
+    std::cout << "Press ENTER to quit ";
+    userPause();
+
+    // Program return value is return code from doctest
+    return dtresult;
+}
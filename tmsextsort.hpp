@@ -0,0 +1,941 @@
+// tmsextsort.hpp
+// Matthew Johnson
+// 10/17/2026
+// external merge sort for TMSArray files larger than memory: sorted
+//  runs, loser-tree k-way merge, background double-buffered I/O (POSIX)
+
+#pragma once
+// for single inclusion
+
+#include "tmsarray.hpp"
+// For class template TMSArray
+
+#include "tmssort.hpp"
+// For tms_sort
+// For tms_merge_sort
+
+#include "tmsparallel.hpp"
+// For TMSThreadPool
+// For tms_default_pool
+
+#include "tmsserial.hpp"
+// For TMSFileHeader
+// For tms_file_header
+// For tms_check_header
+// For tms_save
+// For TMSFd
+// For tms_throw_errno
+// For tms_pread_all
+// For tms_pwritev_all
+// For tms_bswap
+
+#include "tmscrc32.hpp"
+// For tms_crc32c
+
+#include <cstddef>
+// For std::size_t
+
+#include <cstdint>
+// For std::uint32_t
+// For std::uint64_t
+
+#include <cstdio>
+// For std::rename
+
+#include <cstdlib>
+// For mkostemp
+
+#include <string>
+// For std::string
+
+#include <functional>
+// For std::less
+
+#include <type_traits>
+// For std::is_trivially_copyable
+// For std::is_arithmetic
+// For std::is_same
+
+#include <algorithm>
+// For std::min
+// For std::max
+
+#include <utility>
+// For std::swap
+// For std::move
+// For std::forward
+
+#include <deque>
+// For std::deque
+
+#include <thread>
+// For std::thread
+
+#include <mutex>
+// For std::mutex
+// For std::unique_lock
+
+#include <condition_variable>
+// For std::condition_variable
+
+#include <future>
+// For std::future
+// For std::packaged_task
+
+#include <fcntl.h>
+// For open
+
+#include <unistd.h>
+// For close
+// For unlink
+// For fsync
+
+#include <sys/stat.h>
+// For fstat
+
+#include <sys/uio.h>
+// For struct iovec
+
+
+
+// Default memory budget of tms_external_sort
+constexpr std::size_t TMS_EXTSORT_MEM_BYTES = std::size_t(256) << 20;
+
+// Smallest merge read block: the merge fan-in is limited so that every
+//  input keeps two blocks of at least this size
+constexpr std::size_t TMS_EXTSORT_BLOCK_BYTES = std::size_t(1) << 20;
+
+
+
+// *********************************************************************
+// class TMSIoThread - Class definition
+// *********************************************************************
+
+
+// class TMSIoThread
+// One background thread running submitted jobs in submission order.
+//  submit returns a future that completes, or rethrows, when the job
+//  has run.
+// Invariants:
+//     _thread runs loop() until _stop is set and _jobs is drained.
+class TMSIoThread
+{
+
+// ***** TMSIoThread: ctors, dctor *****
+public:
+
+
+    // Default ctor
+    // Strong Guarantee
+    // Pre: None
+    // Post:
+    //      Worker thread started. Throws std::system_error if the thread
+    //      cannot be created.
+    TMSIoThread()
+        :_stop(false)
+    {
+        _thread = std::thread([this]{ loop(); });
+    }
+
+
+    // No copying: owns a thread
+    TMSIoThread(const TMSIoThread &) = delete;
+    TMSIoThread & operator=(const TMSIoThread &) = delete;
+
+
+    // Dctor
+    // No-Throw Guarantee
+    // Pre: None
+    // Post:
+    //      Queued jobs have run; thread joined
+    ~TMSIoThread()
+    {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _wake.notify_one();
+        _thread.join();
+    }
+
+
+// ***** TMSIoThread: general public functions *****
+public:
+
+
+    // submit
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      func callable as void(); everything it uses outlives the job
+    // Post:
+    //      func queued; the returned future becomes ready when it has
+    //      run, and get() rethrows anything it threw
+    template <typename Func>
+    std::future<void> submit(Func && func)
+    {
+        std::packaged_task<void()> task(std::forward<Func>(func));
+        std::future<void> result = task.get_future();
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _jobs.push_back(std::move(task));
+        }
+        _wake.notify_one();
+        return result;
+    }
+
+
+// ***** TMSIoThread: private helper functions *****
+private:
+
+
+    // loop
+    // Worker: runs jobs until stopped and idle
+    void loop()
+    {
+        for (;;)
+        {
+            std::packaged_task<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _wake.wait(lock, [this]{ return _stop || !_jobs.empty(); });
+                if (_jobs.empty())
+                    return;
+                task = std::move(_jobs.front());
+                _jobs.pop_front();
+            }
+            task();             // exceptions are stored in the future
+        }
+    }
+
+
+// ***** TMSIoThread: data members *****
+private:
+
+    std::mutex                              _mutex;
+    std::condition_variable                 _wake;
+    std::deque<std::packaged_task<void()>>  _jobs;
+    bool                                    _stop;
+    std::thread                             _thread;
+
+}; // end of class
+
+
+
+// *********************************************************************
+// class TMSLoserTree - Class definition
+// *********************************************************************
+
+
+// class TMSLoserTree
+// Tournament tree over k sources for k-way merging. Each internal node
+//  holds the loser of the match played there and node 0 the overall
+//  winner, so replacing the winner's key replays only its path to the
+//  root: ceil(log2 k) comparisons against stored losers, with no
+//  sibling lookups. Exhausted sources lose every match.
+// Requirements on Types:
+//     Valtype copy-assignable; comp is a strict weak order.
+// Invariants:
+//     After build(): _tree[0] is the source with the smallest live key
+//      (a dead source only if all are dead); _tree[1.._k) are losers.
+template <typename Valtype, typename Compare = std::less<Valtype>>
+class TMSLoserTree
+{
+
+public:
+
+
+    using value_type = Valtype;
+
+    using size_type  = std::size_t;
+
+
+// ***** TMSLoserTree: ctors *****
+public:
+
+
+    // Ctor from source count
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      k sources, all exhausted until set
+    explicit TMSLoserTree(size_type k, Compare comp = Compare())
+        :_k(k),
+         _comp(comp),
+         _keys(k),
+         _live(k),
+         _tree(std::max(k, size_type(1)))
+    {
+        for (size_type i = 0; i < k; ++i)
+            _live[i] = 0;
+        _tree[0] = 0;
+    }
+
+
+// ***** TMSLoserTree: general public functions *****
+public:
+
+
+    // set
+    // Source i's first key; call before build()
+    void set(size_type i, const value_type & key)
+    {
+        _keys[i] = key;
+        _live[i] = 1;
+    }
+
+
+    // build
+    // Basic Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Tree played from the current keys
+    void build()
+    {
+        if (_k <= 1)
+            return;
+        TMSArray<size_type> win(2 * _k);
+        for (size_type i = 0; i < _k; ++i)
+            win[_k + i] = i;
+        for (size_type node = _k - 1; node > 0; --node)
+        {
+            size_type a = win[2 * node];
+            size_type b = win[2 * node + 1];
+            if (beats(b, a))
+                std::swap(a, b);
+            _tree[node] = b;
+            win[node] = a;
+        }
+        _tree[0] = win[1];
+    }
+
+
+    // empty
+    // No-Throw Guarantee
+    // True when every source is exhausted
+    bool empty() const noexcept
+    {
+        return _k == 0 || !_live[_tree[0]];
+    }
+
+
+    // winner
+    // No-Throw Guarantee
+    // Pre:
+    //      !empty()
+    // Post:
+    //      Source holding the smallest key
+    size_type winner() const noexcept
+    {
+        return _tree[0];
+    }
+
+
+    // top
+    // No-Throw Guarantee
+    // Pre:
+    //      !empty()
+    // Post:
+    //      The smallest key
+    const value_type & top() const noexcept
+    {
+        return _keys[_tree[0]];
+    }
+
+
+    // replace
+    // Pre:
+    //      !empty(); key is the winner's next key
+    // Post:
+    //      Winner's key replaced and its path replayed
+    void replace(const value_type & key)
+    {
+        const size_type w = _tree[0];
+        _keys[w] = key;
+        replay(w);
+    }
+
+
+    // pop
+    // Pre:
+    //      !empty()
+    // Post:
+    //      Winner marked exhausted and its path replayed
+    void pop()
+    {
+        const size_type w = _tree[0];
+        _live[w] = 0;
+        replay(w);
+    }
+
+
+// ***** TMSLoserTree: private helper functions *****
+private:
+
+
+    // beats
+    // True if source a wins against source b
+    bool beats(size_type a, size_type b) const
+    {
+        return _live[a] && (!_live[b] || _comp(_keys[a], _keys[b]));
+    }
+
+
+    // replay
+    // Plays leaf's path to the root after its key changed
+    void replay(size_type leaf)
+    {
+        size_type w = leaf;
+        for (size_type node = (leaf + _k) / 2; node > 0; node /= 2)
+            if (beats(_tree[node], w))
+                std::swap(_tree[node], w);
+        _tree[0] = w;
+    }
+
+
+// ***** TMSLoserTree: data members *****
+private:
+
+    size_type                _k;
+    Compare                  _comp;
+    TMSArray<value_type>     _keys;
+    TMSArray<unsigned char>  _live;
+    TMSArray<size_type>      _tree;
+
+}; // end of class
+
+
+
+// *********************************************************************
+// Block I/O
+// *********************************************************************
+
+
+// class TMSBlockReader
+// Sequential reader of count elements at offset in fd, one block at a
+//  time: while one block is consumed, the next is read by the
+//  TMSIoThread. Optionally byte-swaps each block.
+// Requirements on Types:
+//     Valtype is trivially copyable.
+template <typename Valtype>
+class TMSBlockReader
+{
+
+public:
+
+    using size_type = std::size_t;
+
+
+    // Ctor
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      fd readable for the whole range; block > 0
+    // Post:
+    //      First block requested
+    TMSBlockReader(int fd, std::uint64_t offset, std::uint64_t count,
+                   size_type block, TMSIoThread & io,
+                   const std::string & path, bool swapped = false)
+        :_fd(fd), _offset(offset), _left(count), _block(block),
+         _io(io), _path(path), _swapped(swapped),
+         _cur(block), _ahead(block), _pos(0), _len(0), _aheadLen(0)
+    {
+        prefetch();
+    }
+
+    TMSBlockReader(const TMSBlockReader &) = delete;
+    TMSBlockReader & operator=(const TMSBlockReader &) = delete;
+
+    // Dctor waits for a read in flight into this reader's buffer
+    ~TMSBlockReader()
+    {
+        if (_pending.valid())
+            _pending.wait();
+    }
+
+
+    // next
+    // Pointer to the next element, valid until the following call;
+    //  nullptr at the end. Rethrows read errors.
+    const Valtype * next()
+    {
+        if (_pos == _len && !refill())
+            return nullptr;
+        return _cur.begin() + _pos++;
+    }
+
+private:
+
+    bool refill()
+    {
+        if (!_pending.valid())
+            return false;
+        _pending.get();
+        _cur.swap(_ahead);
+        _pos = 0;
+        _len = _aheadLen;
+        prefetch();
+        return _len > 0;
+    }
+
+    void prefetch()
+    {
+        if (_left == 0)
+            return;
+        const size_type n = size_type(std::min(std::uint64_t(_block), _left));
+        Valtype * dst = _ahead.begin();
+        const int fd = _fd;
+        const std::uint64_t offset = _offset;
+        const bool swapped = _swapped;
+        const std::string * path = &_path;
+        _pending = _io.submit([=]
+        {
+            tms_pread_all(fd, dst, n * sizeof(Valtype), offset, *path);
+            if (swapped)
+                tms_bswap(dst, sizeof(Valtype), n);
+        });
+        _aheadLen = n;
+        _offset += n * sizeof(Valtype);
+        _left -= n;
+    }
+
+    int                 _fd;
+    std::uint64_t       _offset;        // next block to request
+    std::uint64_t       _left;          // elements not yet requested
+    size_type           _block;
+    TMSIoThread &       _io;
+    std::string         _path;
+    bool                _swapped;
+    TMSArray<Valtype>   _cur;
+    TMSArray<Valtype>   _ahead;
+    size_type           _pos;
+    size_type           _len;
+    size_type           _aheadLen;
+    std::future<void>   _pending;
+
+}; // end of class
+
+
+// class TMSBlockWriter
+// Sequential writer of elements from offset in fd: pushes fill one
+//  block while the previous one is written, and checksummed, by the
+//  TMSIoThread.
+// Requirements on Types:
+//     Valtype is trivially copyable.
+template <typename Valtype>
+class TMSBlockWriter
+{
+
+public:
+
+    using size_type = std::size_t;
+
+
+    // Ctor
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      fd writable; block > 0
+    TMSBlockWriter(int fd, std::uint64_t offset, size_type block,
+                   TMSIoThread & io, const std::string & path)
+        :_fd(fd), _offset(offset), _block(block), _io(io), _path(path),
+         _fill(block), _out(block), _len(0), _crc(0)
+    {}
+
+    TMSBlockWriter(const TMSBlockWriter &) = delete;
+    TMSBlockWriter & operator=(const TMSBlockWriter &) = delete;
+
+    // Dctor waits for a write in flight from this writer's buffer
+    ~TMSBlockWriter()
+    {
+        if (_pending.valid())
+            _pending.wait();
+    }
+
+
+    // push
+    // Appends value; rethrows errors of earlier writes
+    void push(const Valtype & value)
+    {
+        _fill[_len] = value;
+        if (++_len == _block)
+            flushBlock();
+    }
+
+
+    // finish
+    // Writes what is buffered and waits for it; returns the CRC-32C of
+    //  every byte written
+    std::uint32_t finish()
+    {
+        flushBlock();
+        if (_pending.valid())
+            _pending.get();
+        return _crc;
+    }
+
+private:
+
+    void flushBlock()
+    {
+        if (_len == 0)
+            return;
+        if (_pending.valid())
+            _pending.get();
+        _fill.swap(_out);
+        const size_type bytes = _len * sizeof(Valtype);
+        Valtype * src = _out.begin();
+        const std::uint64_t offset = _offset;
+        _pending = _io.submit([this, src, bytes, offset]
+        {
+            struct iovec iov;
+            iov.iov_base = src;
+            iov.iov_len = bytes;
+            tms_pwritev_all(_fd, &iov, 1, offset, _path);
+            _crc = tms_crc32c(src, bytes, _crc);
+        });
+        _offset += bytes;
+        _len = 0;
+    }
+
+    int                 _fd;
+    std::uint64_t       _offset;        // next block to write
+    size_type           _block;
+    TMSIoThread &       _io;
+    std::string         _path;
+    TMSArray<Valtype>   _fill;
+    TMSArray<Valtype>   _out;           // being written
+    size_type           _len;
+    std::uint32_t       _crc;           // updated by the I/O thread
+    std::future<void>   _pending;
+
+}; // end of class
+
+
+
+// *********************************************************************
+// External sort
+// *********************************************************************
+
+
+// TMSSortStats
+// What tms_external_sort did: initial runs formed and merge passes made
+//  (0 when the input fit in one run)
+struct TMSSortStats
+{
+    std::size_t runs;
+    std::size_t passes;
+};
+
+
+// tms_temp_fd
+// Opens a new temporary file in dir and unlinks it at once, so it
+//  disappears with its descriptor even after a crash
+inline int tms_temp_fd(const std::string & dir)
+{
+    std::string name = dir + "/tmsextsort.XXXXXX";
+    const int fd = ::mkostemp(&name[0], O_CLOEXEC);
+    if (fd < 0)
+        tms_throw_errno(name + ": mkostemp");
+    ::unlink(name.c_str());
+    return fd;
+}
+
+
+// tms_fsync_path
+// Opens path read-only (a directory when dir) and fsyncs it
+inline void tms_fsync_path(const std::string & path, bool dir)
+{
+    TMSFd fd(::open(path.c_str(), O_RDONLY | O_CLOEXEC
+                                  | (dir ? O_DIRECTORY : 0)));
+    if (fd.fd < 0)
+        tms_throw_errno(path + ": open");
+    if (::fsync(fd.fd) != 0)
+        tms_throw_errno(path + ": fsync");
+}
+
+
+// tms_replace_file
+// Makes tmpPath durable, renames it over outPath, then makes the rename
+//  durable: after a crash outPath is either its old contents or all of
+//  the new ones, never an empty or partial file
+inline void tms_replace_file(const std::string & tmpPath,
+                             const std::string & outPath)
+{
+    tms_fsync_path(tmpPath, false);
+    if (std::rename(tmpPath.c_str(), outPath.c_str()) != 0)
+        tms_throw_errno(outPath + ": rename");
+    const std::string::size_type slash = outPath.rfind('/');
+    tms_fsync_path(slash == std::string::npos ? std::string(".")
+                   : slash == 0 ? std::string("/")
+                   : outPath.substr(0, slash), true);
+}
+
+
+// tms_sort_run
+// Sorts one run in memory: radix sort for arithmetic types in ascending
+//  order, parallel merge sort otherwise
+template <typename Valtype, typename Compare>
+void tms_sort_run(TMSArray<Valtype> & arr, Compare comp, TMSThreadPool & pool)
+{
+    if constexpr (std::is_arithmetic<Valtype>::value
+                  && std::is_same<Compare, std::less<Valtype>>::value)
+        tms_sort(arr, pool);
+    else
+        tms_merge_sort(arr, comp, pool);
+}
+
+
+// TMSSortRun
+// A sorted run in an unlinked temporary file, from offset 0
+struct TMSSortRun
+{
+    int           fd;
+    std::uint64_t count;
+};
+
+
+// TMSRunList
+// Owns the descriptors of the runs it holds
+struct TMSRunList
+{
+    TMSArray<TMSSortRun> runs;
+
+    TMSRunList() = default;
+    TMSRunList(const TMSRunList &) = delete;
+    TMSRunList & operator=(const TMSRunList &) = delete;
+    ~TMSRunList()
+    {
+        for (const TMSSortRun & r : runs)
+            if (r.fd >= 0)
+                ::close(r.fd);
+    }
+};
+
+
+// tms_merge_runs
+// Basic Guarantee
+// Exception-Neutral
+// Pre:
+//      runs[first, last) sorted by comp; outFd writable
+// Post:
+//      Their merge written to outFd from outOffset through a loser tree,
+//      reading and writing blocks of block elements in the background.
+//      Returns the CRC-32C of the bytes written.
+template <typename Valtype, typename Compare>
+std::uint32_t tms_merge_runs(const TMSSortRun * runs, std::size_t k,
+                             int outFd, std::uint64_t outOffset,
+                             std::size_t block, Compare comp,
+                             TMSIoThread & io, const std::string & path)
+{
+    std::deque<TMSBlockReader<Valtype>> readers;
+    for (std::size_t i = 0; i < k; ++i)
+        readers.emplace_back(runs[i].fd, 0, runs[i].count, block, io,
+                             path + " (run)");
+    TMSLoserTree<Valtype, Compare> tree(k, comp);
+    for (std::size_t i = 0; i < k; ++i)
+        if (const Valtype * p = readers[i].next())
+            tree.set(i, *p);
+    tree.build();
+
+    TMSBlockWriter<Valtype> out(outFd, outOffset, block, io, path);
+    while (!tree.empty())
+    {
+        out.push(tree.top());
+        if (const Valtype * p = readers[tree.winner()].next())
+            tree.replace(*p);
+        else
+            tree.pop();
+    }
+    return out.finish();
+}
+
+
+// tms_external_sort
+// Basic Guarantee (outPath is replaced only on success)
+// Exception-Neutral
+// Pre:
+//      inPath is a TMSArray file of Valtype (tms_save format); comp is a
+//      strict weak order; Valtype trivially copyable
+// Post:
+//      outPath holds the elements sorted by comp (not stable), in the
+//      same format with a data checksum; outPath may equal inPath.
+//      Working memory stays near memBytes:
+//       - runs of memBytes / 3 bytes are read, sorted in memory
+//         (tms_sort for arithmetic types under std::less, tms_merge_sort
+//         otherwise) and written to unlinked files in tmpDir, each
+//         write overlapping the next run's read and sort;
+//       - runs are merged by a loser tree, fan-in limited so every input
+//         has two blocks of at least TMS_EXTSORT_BLOCK_BYTES; more runs
+//         than that take extra passes through tmpDir;
+//       - merge reads and writes go through a background thread, one
+//         block ahead of the merge.
+//      Input in the other byte order is converted. Throws
+//      std::system_error on I/O errors, std::runtime_error if inPath is
+//      not a matching TMSArray file.
+template <typename Valtype, typename Compare = std::less<Valtype>>
+TMSSortStats tms_external_sort(const std::string & inPath,
+                               const std::string & outPath,
+                               std::size_t memBytes = TMS_EXTSORT_MEM_BYTES,
+                               const std::string & tmpDir = "/tmp",
+                               Compare comp = Compare(),
+                               TMSThreadPool & pool = tms_default_pool())
+{
+    static_assert(std::is_trivially_copyable<Valtype>::value,
+                  "tms_external_sort moves raw bytes");
+    constexpr std::size_t SIZE = sizeof(Valtype);
+
+    TMSFd in(::open(inPath.c_str(), O_RDONLY | O_CLOEXEC));
+    if (in.fd < 0)
+        tms_throw_errno(inPath + ": open");
+    struct stat st;
+    if (::fstat(in.fd, &st) != 0)
+        tms_throw_errno(inPath + ": stat");
+    TMSFileHeader h;
+    if (std::uint64_t(st.st_size) < sizeof h)
+        throw std::runtime_error(inPath + ": not a TMSArray file");
+    tms_pread_all(in.fd, &h, sizeof h, 0, inPath);
+    const bool swapped = tms_check_header<Valtype>(h, std::uint64_t(st.st_size),
+                                                   inPath);
+    const std::uint64_t n = h.count;
+    const std::size_t runElems = std::max(std::size_t(1), memBytes / (3 * SIZE));
+
+    TMSSortStats stats = { std::size_t((n + runElems - 1) / runElems), 0 };
+    const std::string tmpOut = outPath + ".sorting";
+
+    // One run: an in-memory sort
+    if (stats.runs <= 1)
+    {
+        TMSArray<Valtype> arr(static_cast<std::size_t>(n));
+        tms_pread_all(in.fd, arr.begin(), std::size_t(n) * SIZE,
+                      h.data_offset, inPath);
+        if (swapped)
+            tms_bswap(arr.begin(), SIZE, arr.size());
+        tms_sort_run(arr, comp, pool);
+        try
+        {
+            tms_save(arr, tmpOut);
+            tms_replace_file(tmpOut, outPath);
+        }
+        catch (...)
+        {
+            ::unlink(tmpOut.c_str());
+            throw;
+        }
+        return stats;
+    }
+
+    TMSIoThread io;
+    TMSRunList list;
+
+    // Phase 1: sorted runs. Run r is written in the background from
+    //  bufs[r % 2] while run r + 1 is read and sorted in the other.
+    {
+        TMSArray<Valtype> bufs[2];
+        std::future<void> writes[2];
+        try
+        {
+            for (std::uint64_t first = 0; first < n; )
+            {
+                const std::size_t r = list.runs.size();
+                TMSArray<Valtype> & buf = bufs[r % 2];
+                if (writes[r % 2].valid())
+                    writes[r % 2].get();
+                const std::size_t len = std::size_t(std::min(
+                    std::uint64_t(runElems), n - first));
+                buf.resize(len);
+                tms_pread_all(in.fd, buf.begin(), len * SIZE,
+                              h.data_offset + first * SIZE, inPath);
+                if (swapped)
+                    tms_bswap(buf.begin(), SIZE, len);
+                tms_sort_run(buf, comp, pool);
+
+                const int fd = tms_temp_fd(tmpDir);
+                list.runs.push_back(TMSSortRun{ fd, len });
+                const Valtype * src = buf.begin();
+                writes[r % 2] = io.submit([fd, src, len, &tmpDir]
+                {
+                    struct iovec iov;
+                    iov.iov_base = const_cast<Valtype *>(src);
+                    iov.iov_len = len * SIZE;
+                    tms_pwritev_all(fd, &iov, 1, 0, tmpDir + " (run)");
+                });
+                first += len;
+            }
+        }
+        catch (...)
+        {
+            for (std::future<void> & w : writes)
+                if (w.valid())
+                    w.wait();
+            throw;
+        }
+        for (std::future<void> & w : writes)
+            if (w.valid())
+                w.get();
+    }
+
+    // Phase 2: intermediate passes until one merge can take every run
+    const std::size_t fanIn = std::max(std::size_t(3),
+        memBytes / (2 * TMS_EXTSORT_BLOCK_BYTES)) - 1;
+    auto blockFor = [&](std::size_t k)
+    {
+        return std::max(std::size_t(1), memBytes / SIZE / (2 * k + 2));
+    };
+    while (list.runs.size() > fanIn)
+    {
+        TMSRunList next;
+        for (std::size_t first = 0; first < list.runs.size(); first += fanIn)
+        {
+            const std::size_t k = std::min(fanIn, list.runs.size() - first);
+            std::uint64_t count = 0;
+            for (std::size_t i = first; i < first + k; ++i)
+                count += list.runs[i].count;
+            next.runs.push_back(TMSSortRun{ tms_temp_fd(tmpDir), count });
+            const int fd = next.runs[next.runs.size() - 1].fd;
+            tms_merge_runs<Valtype>(list.runs.begin() + first, k, fd,
+                                    0, blockFor(k), comp, io,
+                                    tmpDir + " (run)");
+            for (std::size_t i = first; i < first + k; ++i)
+            {
+                ::close(list.runs[i].fd);
+                list.runs[i].fd = -1;
+            }
+        }
+        list.runs.swap(next.runs);
+        ++stats.passes;
+    }
+
+    // Final pass: merge into the output file, then its header
+    TMSFd out(::open(tmpOut.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                     0644));
+    if (out.fd < 0)
+        tms_throw_errno(tmpOut + ": open");
+    try
+    {
+        TMSFileHeader oh = tms_file_header<Valtype>(std::size_t(n), 0);
+        const std::size_t k = list.runs.size();
+        const std::uint32_t crc = tms_merge_runs<Valtype>(
+            list.runs.begin(), k, out.fd, oh.data_offset, blockFor(k), comp,
+            io, tmpOut);
+        ++stats.passes;
+        oh = tms_file_header<Valtype>(std::size_t(n), crc);
+        unsigned char pad[TMS_FILE_ALIGN] = {};
+        struct iovec iov[2];
+        iov[0].iov_base = &oh;
+        iov[0].iov_len = sizeof oh;
+        iov[1].iov_base = pad;
+        iov[1].iov_len = std::size_t(oh.data_offset - sizeof oh);
+        tms_pwritev_all(out.fd, iov, 2, 0, tmpOut);
+        tms_replace_file(tmpOut, outPath);
+    }
+    catch (...)
+    {
+        ::unlink(tmpOut.c_str());
+        throw;
+    }
+    return stats;
+}
+
@@ -0,0 +1,391 @@
+// tmsextsort_test.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Test program for tms_external_sort, TMSLoserTree, TMSIoThread
+// Uses the "doctest" unit-testing framework, version 2
+// Requires doctest.h, tmsextsort.hpp, tmssort.hpp, tmsparallel.hpp,
+//  tmsserial.hpp, tmscrc32.hpp, tmssimd.hpp, tmsarray.hpp
+
+// Includes for code to be tested
+#include "tmsextsort.hpp"    // For tms_external_sort, TMSLoserTree, ...
+#include "tmsextsort.hpp"    // Double-inclusion check, for testing only
+
+// Includes for the "doctest" unit-testing framework
+#define DOCTEST_CONFIG_IMPLEMENT
+                             // We write our own main
+#define DOCTEST_CONFIG_SUPER_FAST_ASSERTS
+                             // Reduce compile time
+#include "doctest.h"         // For doctest
+
+// Includes for all test programs
+#include <iostream>
+using std::cout;
+using std::endl;
+using std::cin;
+#include <string>
+using std::string;
+
+// Additional includes for this test program
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::int64_t;
+using std::uint32_t;
+using std::uint64_t;
+#include <cstdio>
+using std::remove;
+#include <algorithm>
+using std::sort;
+using std::equal;
+#include <functional>
+using std::greater;
+#include <future>
+using std::future;
+#include <stdexcept>
+using std::runtime_error;
+#include <system_error>
+using std::system_error;
+#include <unistd.h>          // For getpid, pwrite
+
+// Printable name for this test suite
+const string test_suite_name =
+    "tms_external_sort, TMSLoserTree and TMSIoThread";
+
+
+// *********************************************************************
+// Helper Functions for This Test Program
+// *********************************************************************
+
+
+// tempPath
+// A per-process scratch file name under /tmp, removed first
+string tempPath(const string & tag)
+{
+    string path = "/tmp/tmsextsort_test_" + std::to_string(getpid()) + "_"
+                  + tag;
+    remove(path.c_str());
+    return path;
+}
+
+
+// fillRandom
+// Pseudo-random values from seed
+template <typename T>
+void fillRandom(TMSArray<T> & arr, uint64_t seed)
+{
+    uint64_t x = seed;
+    for (T & v : arr)
+    {
+        x = x * 6364136223846793005ull + 1442695040888963407ull;
+        v = T(x >> 33);
+    }
+}
+
+
+// sortedCopyMatches
+// Loads path (checking its CRC) and compares it with a std::sort of in
+template <typename T, typename Compare = std::less<T>>
+bool sortedCopyMatches(const string & path, TMSArray<T> in,
+                       Compare comp = Compare())
+{
+    sort(in.begin(), in.end(), comp);
+    TMSArray<T> out;
+    tms_load(path, out, true);
+    return out.size() == in.size()
+        && equal(out.begin(), out.end(), in.begin(),
+                 [&](const T & a, const T & b)
+                 { return !comp(a, b) && !comp(b, a); });
+}
+
+
+// Record
+// A keyed struct sorted by a comparator
+struct Record
+{
+    uint32_t key;
+    uint32_t tag;
+    double   payload;
+};
+
+
+// *********************************************************************
+// Test Cases
+// *********************************************************************
+
+
+TEST_CASE( "TMSIoThread runs jobs in order" )
+{
+    TMSIoThread io;
+    TMSArray<int> seen;
+    future<void> last;
+    for (int i = 0; i < 100; ++i)
+        last = io.submit([&seen, i]{ seen.push_back(i); });
+    last.get();
+    REQUIRE( seen.size() == 100 );
+    for (int i = 0; i < 100; ++i)
+        REQUIRE( seen[i] == i );
+
+    future<void> bad = io.submit([]{ throw runtime_error("job"); });
+    REQUIRE_THROWS_AS( bad.get(), runtime_error );
+    future<void> after = io.submit([]{});
+    after.get();
+}
+
+
+TEST_CASE( "TMSLoserTree merges k sorted sources" )
+{
+    for (size_t k : { 1, 2, 3, 5, 8, 13 })
+    {
+        TMSArray<TMSArray<int>> src(k);
+        TMSArray<int> all;
+        for (size_t i = 0; i < k; ++i)
+        {
+            src[i].resize(i % 4 == 1 ? 0 : 20 + 7 * i);
+            fillRandom(src[i], i + 1);
+            for (int & v : src[i])
+                v %= 50;
+            sort(src[i].begin(), src[i].end());
+            for (int v : src[i])
+                all.push_back(v);
+        }
+        sort(all.begin(), all.end());
+
+        TMSLoserTree<int> tree(k);
+        TMSArray<size_t> pos(k);
+        for (size_t i = 0; i < k; ++i)
+        {
+            pos[i] = 0;
+            if (!src[i].empty())
+                tree.set(i, src[i][pos[i]++]);
+        }
+        tree.build();
+        TMSArray<int> merged;
+        while (!tree.empty())
+        {
+            merged.push_back(tree.top());
+            const size_t w = tree.winner();
+            if (pos[w] < src[w].size())
+                tree.replace(src[w][pos[w]++]);
+            else
+                tree.pop();
+        }
+        REQUIRE( merged.size() == all.size() );
+        REQUIRE( equal(merged.begin(), merged.end(), all.begin()) );
+    }
+
+    TMSLoserTree<int> none(0);
+    none.build();
+    REQUIRE( none.empty() );
+}
+
+
+TEST_CASE( "Input that fits in one run" )
+{
+    const string in = tempPath("one_in");
+    const string out = tempPath("one_out");
+    TMSArray<int64_t> ta(10000);
+    fillRandom(ta, 5);
+    tms_save(ta, in);
+    const TMSSortStats stats = tms_external_sort<int64_t>(in, out);
+    REQUIRE( stats.runs == 1 );
+    REQUIRE( stats.passes == 0 );
+    REQUIRE( sortedCopyMatches(out, ta) );
+
+    TMSArray<int64_t> empty;
+    tms_save(empty, in);
+    REQUIRE( tms_external_sort<int64_t>(in, out).runs == 0 );
+    TMSArray<int64_t> tb(3);
+    tms_load(out, tb, true);
+    REQUIRE( tb.empty() );
+    remove(in.c_str());
+    remove(out.c_str());
+}
+
+
+TEST_CASE( "One merge pass" )
+{
+    const string in = tempPath("pass_in");
+    const string out = tempPath("pass_out");
+    TMSArray<uint32_t> ta(2000000);
+    fillRandom(ta, 9);
+    tms_save(ta, in);
+    // 8 MB: runs of 699050 elements, fan-in 3
+    const TMSSortStats stats = tms_external_sort<uint32_t>(in, out, 8 << 20);
+    REQUIRE( stats.runs == 3 );
+    REQUIRE( stats.passes == 1 );
+    REQUIRE( sortedCopyMatches(out, ta) );
+    remove(in.c_str());
+    remove(out.c_str());
+}
+
+
+TEST_CASE( "Several merge passes" )
+{
+    const string in = tempPath("multi_in");
+    const string out = tempPath("multi_out");
+    TMSArray<int> ta(100000);
+    fillRandom(ta, 11);
+    tms_save(ta, in);
+    // 64 KB: runs of 5461 elements, fan-in 2: 19 -> 10 -> 5 -> 3 -> 2 -> 1
+    const TMSSortStats stats = tms_external_sort<int>(in, out, 64 << 10);
+    REQUIRE( stats.runs == 19 );
+    REQUIRE( stats.passes == 5 );
+    REQUIRE( sortedCopyMatches(out, ta) );
+    remove(in.c_str());
+    remove(out.c_str());
+}
+
+
+TEST_CASE( "Comparator and struct elements" )
+{
+    const string in = tempPath("rec_in");
+    const string out = tempPath("rec_out");
+    TMSArray<Record> ta(30000);
+    for (size_t i = 0; i < ta.size(); ++i)
+        ta[i] = Record{ uint32_t(i * 7919 % 1000), uint32_t(i), double(i) };
+    tms_save(ta, in);
+    auto byKey = [](const Record & a, const Record & b)
+                 { return a.key < b.key; };
+    const TMSSortStats stats =
+        tms_external_sort<Record>(in, out, 100 << 10, "/tmp", byKey);
+    REQUIRE( stats.runs > 1 );
+    REQUIRE( sortedCopyMatches(out, ta, byKey) );
+
+    // Every record kept exactly once
+    TMSArray<Record> tb;
+    tms_load(out, tb);
+    TMSArray<unsigned char> seen(ta.size());
+    for (unsigned char & s : seen)
+        s = 0;
+    for (const Record & r : tb)
+        ++seen[r.tag];
+    for (unsigned char s : seen)
+        REQUIRE( s == 1 );
+
+    // Descending integers through a comparator other than std::less
+    TMSArray<int> tc(20000);
+    fillRandom(tc, 3);
+    tms_save(tc, in);
+    tms_external_sort<int>(in, out, 64 << 10, "/tmp", greater<int>());
+    REQUIRE( sortedCopyMatches(out, tc, greater<int>()) );
+    remove(in.c_str());
+    remove(out.c_str());
+}
+
+
+TEST_CASE( "Sorting a file in place" )
+{
+    const string path = tempPath("inplace");
+    TMSArray<double> ta(50000);
+    fillRandom(ta, 21);
+    tms_save(ta, path);
+    tms_external_sort<double>(path, path, 128 << 10);
+    REQUIRE( sortedCopyMatches(path, ta) );
+    remove(path.c_str());
+}
+
+
+TEST_CASE( "Input in the other byte order" )
+{
+    const string in = tempPath("swap_in");
+    const string out = tempPath("swap_out");
+    TMSArray<uint32_t> ta(20000);
+    fillRandom(ta, 4);
+    TMSArray<uint32_t> sw(ta);
+    tms_bswap(sw.begin(), 4, sw.size());
+
+    // Header as a big-endian writer would produce it
+    TMSFileHeader h = tms_file_header<uint32_t>(ta.size(),
+                          tms_crc32c(sw.begin(), sw.size() * 4));
+    h.endian = __builtin_bswap32(h.endian);
+    h.version = __builtin_bswap16(h.version);
+    h.type = __builtin_bswap16(h.type);
+    h.elem_size = __builtin_bswap32(h.elem_size);
+    h.align = __builtin_bswap32(h.align);
+    h.count = __builtin_bswap64(h.count);
+    h.data_offset = __builtin_bswap64(h.data_offset);
+    h.data_crc = __builtin_bswap32(h.data_crc);
+    h.header_crc = __builtin_bswap32(tms_header_crc(h));
+    tms_save(sw, in);
+    {
+        TMSFd file(::open(in.c_str(), O_WRONLY));
+        REQUIRE( file.fd >= 0 );
+        REQUIRE( ::pwrite(file.fd, &h, sizeof h, 0) == ssize_t(sizeof h) );
+    }
+
+    for (size_t mem : { size_t(1) << 20, size_t(16) << 10 })
+    {
+        tms_external_sort<uint32_t>(in, out, mem);
+        REQUIRE( sortedCopyMatches(out, ta) );
+    }
+    remove(in.c_str());
+    remove(out.c_str());
+}
+
+
+TEST_CASE( "Errors" )
+{
+    const string in = tempPath("err_in");
+    const string out = tempPath("err_out");
+    REQUIRE_THROWS_AS( tms_external_sort<int>(in, out), system_error );
+
+    TMSArray<float> ta(100);
+    tms_save(ta, in);
+    REQUIRE_THROWS_AS( tms_external_sort<int>(in, out), runtime_error );
+
+    TMSArray<int> tb(100000);
+    fillRandom(tb, 1);
+    tms_save(tb, in);
+    REQUIRE_THROWS_AS( tms_external_sort<int>(in, out, 64 << 10,
+                                              "/nonexistent/dir"),
+                       system_error );
+    REQUIRE( ::access(out.c_str(), F_OK) != 0 );
+    REQUIRE( ::access((out + ".sorting").c_str(), F_OK) != 0 );
+    remove(in.c_str());
+}
+
+
+// *********************************************************************
+// Main Program
+// *********************************************************************
+
+
+// userPause
+// Wait for user to press ENTER: read all chars through first newline.
+void userPause()
+{
+    std::cout.flush();
+    while (std::cin.get() != '\n') ;
+}
+
+
+// Main program
+// Run all tests. Prompt for ENTER before exiting.
+int main(int argc,
+         char *argv[])
+{
+    doctest::Context dtcontext;
+                             // Primary doctest object
+    int dtresult;            // doctest return code; for return by main
+
+    // Handle command line
+    dtcontext.applyCommandLine(argc, argv);
+    dtresult = 0;            // doctest flags no command-line errors
+                             //  (strange but true)
+
+    if (!dtresult)           // Continue only if no command-line error
+    {
+        // Run test suites
+        cout << "BEGIN tests for " << test_suite_name << "\n" << endl;
+        dtresult = dtcontext.run();
+        cout << "END tests for " << test_suite_name << "\n" << endl;
+    }
+
+    // Wait for user
+    std::cout << "Press ENTER to quit ";
+    userPause();
+
+    // Program return value is return code from doctest
+    return dtresult;
+}
@@ -0,0 +1,840 @@
+// tmslog.hpp
+// Matthew Johnson
+// 10/17/2026
+// durable append-only array: fixed-size segment files of CRC-checked
+//  records, group-commit fdatasync, torn-tail recovery (POSIX)
+
+#pragma once
+// for single inclusion
+
+#include "tmsarray.hpp"
+// For class template TMSArray
+
+#include "tmsserial.hpp"
+// For tms_type_tag
+// For tms_throw_errno
+// For tms_pread_all
+// For TMS_FILE_ENDIAN
+
+#include "tmscrc32.hpp"
+// For tms_crc32c
+
+#include <cstddef>
+// For std::size_t
+// For std::ptrdiff_t
+
+#include <cstdint>
+// For std::uint16_t
+// For std::uint32_t
+// For std::uint64_t
+
+#include <cstring>
+// For std::memcpy
+// For std::memcmp
+// For std::memset
+
+#include <cerrno>
+// For errno
+// For EEXIST
+// For ENOENT
+// For EINTR
+
+#include <cstdio>
+// For std::snprintf
+
+#include <string>
+// For std::string
+
+#include <stdexcept>
+// For std::runtime_error
+// For std::invalid_argument
+
+#include <type_traits>
+// For std::is_trivially_copyable
+
+#include <iterator>
+// For std::forward_iterator_tag
+
+#include <algorithm>
+// For std::min
+// For std::max
+// For std::copy
+
+#include <fcntl.h>
+// For open
+
+#include <unistd.h>
+// For close
+// For pwrite
+// For fdatasync
+// For fsync
+// For ftruncate
+// For access
+// For unlink
+
+#include <sys/mman.h>
+// For mmap
+// For munmap
+
+#include <sys/stat.h>
+// For fstat
+// For mkdir
+
+
+
+// *********************************************************************
+// Segment format
+// *********************************************************************
+
+
+// A log is a directory of segment files 0000000000000000.tlog, ...,
+//  numbered without gaps. Each holds a TMSLogSegmentHeader and then up
+//  to segment_records records of record_size bytes: the element, then
+//  the CRC-32C of its 8-byte log index followed by the element. Every
+//  segment but the last is full; the last may end in a torn record,
+//  which recovery cuts off.
+
+constexpr char          TMS_LOG_MAGIC[8]  = { 'T', 'M', 'S', 'L',
+                                              'O', 'G', 'S', 'G' };
+constexpr std::uint16_t TMS_LOG_VERSION   = 1;
+
+// Default segment size, in bytes of records
+constexpr std::size_t   TMS_LOG_SEGMENT_BYTES = std::size_t(64) << 20;
+
+
+// TMSLogSegmentHeader
+// Fixed 64-byte segment header; header_crc covers the first 60 bytes
+struct TMSLogSegmentHeader
+{
+    char          magic[8];
+    std::uint32_t endian;
+    std::uint16_t version;
+    std::uint16_t type;
+    std::uint32_t elem_size;
+    std::uint32_t record_size;
+    std::uint64_t segment_records;
+    std::uint64_t first_index;
+    unsigned char reserved[20];
+    std::uint32_t header_crc;
+};
+
+static_assert(sizeof(TMSLogSegmentHeader) == 64,
+              "TMSLogSegmentHeader is 64 bytes");
+
+
+
+// *********************************************************************
+// class TMSLogArray - Class definition
+// *********************************************************************
+
+
+// class TMSLogArray
+// Durable, append-only sequence with TMSArray-style reads. Appends go to
+//  an in-memory tail (a TMSArray); once it holds batch() records, or on
+//  sync(), the tail is written to the current segment with one pwrite
+//  per segment touched and made durable with one fdatasync: a group
+//  commit, so the cost of a disk flush is shared by the whole batch.
+//  A new segment is created (and the directory synced) when the last
+//  one fills.
+//
+// Reads of durable records come from a read-only mapping of their
+//  segment; reads of the tail from memory. operator[] returns by value,
+//  since records are not aligned in the file.
+//
+// Opening an existing log trusts the full segments and scans the last
+//  one, keeping records up to the first bad CRC and truncating the file
+//  there: everything acknowledged by sync() survives a crash, and a
+//  torn write never becomes visible.
+// Requirements on Types:
+//     Valtype is trivially copyable.
+// Invariants:
+//     _durable records are synced, in _segs.size() segments (the last
+//      possibly partial, and _fd is open on it); _tail holds the rest.
+template <typename Valtype>
+class TMSLogArray
+{
+
+    static_assert(std::is_trivially_copyable<Valtype>::value,
+                  "TMSLogArray stores raw bytes");
+
+public:
+
+
+    using value_type = Valtype;
+
+    using size_type  = std::size_t;
+
+
+    // const_iterator
+    // Forward iterator over all records, durable then tail; yields
+    //  values
+    class const_iterator
+    {
+    public:
+
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = Valtype;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const Valtype *;
+        using reference         = Valtype;
+
+        const_iterator() = default;
+
+        const_iterator(const TMSLogArray * log, size_type pos) noexcept
+            :_log(log), _pos(pos)
+        {}
+
+        reference operator*() const noexcept
+        {
+            return (*_log)[_pos];
+        }
+
+        const_iterator & operator++() noexcept
+        {
+            ++_pos;
+            return *this;
+        }
+
+        const_iterator operator++(int) noexcept
+        {
+            const_iterator save = *this;
+            ++_pos;
+            return save;
+        }
+
+        // index
+        // Position of this record in the log
+        size_type index() const noexcept
+        {
+            return _pos;
+        }
+
+        friend bool operator==(const const_iterator & a,
+                               const const_iterator & b) noexcept
+        {
+            return a._pos == b._pos;
+        }
+
+        friend bool operator!=(const const_iterator & a,
+                               const const_iterator & b) noexcept
+        {
+            return a._pos != b._pos;
+        }
+
+    private:
+
+        const TMSLogArray * _log = nullptr;
+        size_type           _pos = 0;
+
+    };
+
+    using iterator = const_iterator;
+
+
+// ***** TMSLogArray: ctors, dctor *****
+public:
+
+
+    // Ctor from directory
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      batch > 0
+    // Post:
+    //      Opens the log in dir, creating dir and an empty log if needed,
+    //      and recovers it as described above. segmentRecords sets the
+    //      segment size of a new log (0: about TMS_LOG_SEGMENT_BYTES);
+    //      an existing log keeps its own. Throws std::system_error on I/O
+    //      errors, std::runtime_error if the log is for another type or
+    //      is damaged other than at its tail.
+    explicit TMSLogArray(const std::string & dir, size_type batch = 1024,
+                         size_type segmentRecords = 0)
+        :_dir(dir),
+         _batch(batch),
+         _segRecords(segmentRecords),
+         _fd(-1),
+         _durable(0),
+         _segs(0),
+         _tail(0),
+         _buf(0)
+    {
+        if (_batch == 0)
+            throw std::invalid_argument("TMSLogArray: batch must be > 0");
+        if (_segRecords == 0)
+            _segRecords = std::max(size_type(1),
+                                   TMS_LOG_SEGMENT_BYTES / RECORD);
+        try
+        {
+            recover();
+        }
+        catch (...)
+        {
+            release();
+            throw;
+        }
+    }
+
+
+    // No copying: a log owns its files
+    TMSLogArray(const TMSLogArray &) = delete;
+    TMSLogArray & operator=(const TMSLogArray &) = delete;
+
+
+    // Dctor
+    // No-Throw Guarantee
+    // Pre: None
+    // Post:
+    //      Tail synced (errors ignored: records not synced by an explicit
+    //      sync() may be lost), files released
+    ~TMSLogArray()
+    {
+        try
+        {
+            sync();
+        }
+        catch (...)
+        {}
+        release();
+    }
+
+
+// ***** TMSLogArray: general public operators *****
+public:
+
+
+    // operator[]
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      0 <= index < size()
+    // Post:
+    //      Returns record index
+    value_type operator[](size_type index) const noexcept
+    {
+        if (index >= _durable)
+            return _tail[index - _durable];
+        value_type value;
+        std::memcpy(&value, recordAt(index), sizeof value);
+        return value;
+    }
+
+
+// ***** TMSLogArray: general public functions *****
+public:
+
+
+    // size
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns number of records, durable and in the tail
+    size_type size() const noexcept
+    {
+        return _durable + _tail.size();
+    }
+
+
+    // empty
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns size() == 0
+    bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+
+    // durable_size
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns number of records synced to disk
+    size_type durable_size() const noexcept
+    {
+        return _durable;
+    }
+
+
+    // batch
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns the tail length that triggers a commit
+    size_type batch() const noexcept
+    {
+        return _batch;
+    }
+
+
+    // tail
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns the records not yet synced: records durable_size() on
+    const TMSArray<value_type> & tail() const noexcept
+    {
+        return _tail;
+    }
+
+
+    // segment_count, segment_records
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns number of segment files; records per segment
+    size_type segment_count() const noexcept
+    {
+        return _segs.size();
+    }
+    size_type segment_records() const noexcept
+    {
+        return _segRecords;
+    }
+
+
+    // begin, end
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns iterator to first record; iterator past the last
+    const_iterator begin() const noexcept
+    {
+        return const_iterator(this, 0);
+    }
+    const_iterator end() const noexcept
+    {
+        return const_iterator(this, size());
+    }
+
+
+    // read
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      first + n <= size()
+    //      [out, out + n) valid
+    // Post:
+    //      out holds records [first, first + n)
+    void read(size_type first, size_type n, value_type * out) const noexcept
+    {
+        for (; n > 0 && first < _durable; --n, ++first, ++out)
+            std::memcpy(out, recordAt(first), sizeof(value_type));
+        for (; n > 0; --n, ++first, ++out)
+            *out = _tail[first - _durable];
+    }
+
+
+    // append
+    // Basic Guarantee (the record stays in the tail if its batch's
+    //  commit fails)
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      value is record size() - 1; committed with its batch when the
+    //      tail reaches batch() records. Throws std::system_error if that
+    //      commit fails.
+    void append(const value_type & value)
+    {
+        _tail.push_back(value);
+        if (_tail.size() >= _batch)
+            sync();
+    }
+
+
+    // append
+    // Basic Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      [values, values + n) valid
+    // Post:
+    //      values appended, in order, committing whole batches as the
+    //      tail fills
+    void append(const value_type * values, size_type n)
+    {
+        while (n > 0)
+        {
+            const size_type room = _batch - std::min(_batch, _tail.size());
+            const size_type k = std::min(n, std::max(room, size_type(1)));
+            const size_type old = _tail.size();
+            _tail.resize(old + k);
+            std::copy(values, values + k, _tail.begin() + old);
+            values += k;
+            n -= k;
+            if (_tail.size() >= _batch)
+                sync();
+        }
+    }
+
+
+    // sync
+    // Basic Guarantee (records already written stay durable; the rest
+    //  stay in the tail, to be retried)
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      All records durable; tail empty. Throws std::system_error on
+    //      write or flush failure.
+    void sync()
+    {
+        size_type done = 0;
+        try
+        {
+            syncFrom(done);
+        }
+        catch (...)
+        {
+            dropTail(done);
+            throw;
+        }
+        dropTail(done);
+    }
+
+
+    // verify
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      first <= last <= durable_size()
+    // Post:
+    //      Returns whether every durable record in [first, last) passes
+    //      its CRC
+    bool verify(size_type first, size_type last) const noexcept
+    {
+        for (; first < last; ++first)
+            if (!recordValid(first, recordAt(first)))
+                return false;
+        return true;
+    }
+
+
+// ***** TMSLogArray: private constants *****
+private:
+
+    static constexpr size_type HEADER = sizeof(TMSLogSegmentHeader);
+    static constexpr size_type RECORD = sizeof(value_type) + sizeof(std::uint32_t);
+
+
+// ***** TMSLogArray: private helper functions *****
+private:
+
+
+    // Segment
+    // Read-only mapping of a whole segment (its length is the full
+    //  segment even while the file is shorter; only synced records,
+    //  which lie within the file, are read through it)
+    struct Segment
+    {
+        const unsigned char * map;
+    };
+
+
+    // segmentPath
+    std::string segmentPath(size_type seg) const
+    {
+        char name[32];
+        std::snprintf(name, sizeof name, "/%016llu.tlog",
+                      static_cast<unsigned long long>(seg));
+        return _dir + name;
+    }
+
+
+    // segmentBytes
+    size_type segmentBytes() const noexcept
+    {
+        return HEADER + _segRecords * RECORD;
+    }
+
+
+    // recordAt
+    const unsigned char * recordAt(size_type index) const noexcept
+    {
+        return _segs[index / _segRecords].map + HEADER
+               + (index % _segRecords) * RECORD;
+    }
+
+
+    // recordCrc
+    static std::uint32_t recordCrc(std::uint64_t index,
+                                   const unsigned char * payload) noexcept
+    {
+        return tms_crc32c(payload, sizeof(value_type),
+                          tms_crc32c(&index, sizeof index));
+    }
+
+
+    // recordValid
+    static bool recordValid(std::uint64_t index, const unsigned char * rec) noexcept
+    {
+        std::uint32_t crc;
+        std::memcpy(&crc, rec + sizeof(value_type), sizeof crc);
+        return crc == recordCrc(index, rec);
+    }
+
+
+    // encode
+    static void encode(std::uint64_t index, const value_type & value,
+                       unsigned char * out) noexcept
+    {
+        std::memcpy(out, &value, sizeof value);
+        const std::uint32_t crc = recordCrc(index, out);
+        std::memcpy(out + sizeof value, &crc, sizeof crc);
+    }
+
+
+    // makeHeader
+    TMSLogSegmentHeader makeHeader(size_type seg) const noexcept
+    {
+        TMSLogSegmentHeader h;
+        std::memset(&h, 0, sizeof h);
+        std::memcpy(h.magic, TMS_LOG_MAGIC, sizeof h.magic);
+        h.endian = TMS_FILE_ENDIAN;
+        h.version = TMS_LOG_VERSION;
+        h.type = tms_type_tag<value_type>();
+        h.elem_size = sizeof(value_type);
+        h.record_size = RECORD;
+        h.segment_records = _segRecords;
+        h.first_index = seg * _segRecords;
+        h.header_crc = tms_crc32c(&h, sizeof h - sizeof h.header_crc);
+        return h;
+    }
+
+
+    // headerValid
+    // Whether h is an intact header of segment seg of this log type; a
+    //  first segment also sets _segRecords
+    bool headerValid(TMSLogSegmentHeader & h, size_type seg)
+    {
+        if (std::memcmp(h.magic, TMS_LOG_MAGIC, sizeof h.magic) != 0
+            || h.header_crc != tms_crc32c(&h, sizeof h - sizeof h.header_crc))
+            return false;
+        if (h.endian != TMS_FILE_ENDIAN || h.version != TMS_LOG_VERSION
+            || h.type != tms_type_tag<value_type>()
+            || h.elem_size != sizeof(value_type) || h.record_size != RECORD
+            || h.segment_records == 0)
+            throw std::runtime_error(segmentPath(seg)
+                                     + ": log is for another record type");
+        if (seg == 0)
+            _segRecords = size_type(h.segment_records);
+        if (h.segment_records != _segRecords || h.first_index != seg * _segRecords)
+            throw std::runtime_error(segmentPath(seg) + ": segment out of place");
+        return true;
+    }
+
+
+    // writeAll
+    // pwrite of n bytes at offset to the current segment
+    void writeAll(const unsigned char * p, size_type n, size_type offset)
+    {
+        while (n > 0)
+        {
+            const ssize_t got = ::pwrite(_fd, p, n, off_t(offset));
+            if (got < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                tms_throw_errno(segmentPath(_segs.size() - 1) + ": write");
+            }
+            p += got;
+            n -= size_type(got);
+            offset += size_type(got);
+        }
+    }
+
+
+    // mapSegment
+    void mapSegment(int fd, size_type seg)
+    {
+        void * map = ::mmap(nullptr, segmentBytes(), PROT_READ, MAP_SHARED, fd, 0);
+        if (map == MAP_FAILED)
+            tms_throw_errno(segmentPath(seg) + ": mmap");
+        _segs.push_back(Segment{ static_cast<const unsigned char *>(map) });
+    }
+
+
+    // syncDir
+    // Makes a created segment's directory entry durable
+    void syncDir() const
+    {
+        const int dfd = ::open(_dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (dfd < 0)
+            tms_throw_errno(_dir + ": open");
+        const int rc = ::fsync(dfd);
+        ::close(dfd);
+        if (rc != 0)
+            tms_throw_errno(_dir + ": fsync");
+    }
+
+
+    // addSegment
+    // Closes the full last segment and starts the next one
+    void addSegment()
+    {
+        const size_type seg = _segs.size();
+        const std::string path = segmentPath(seg);
+        const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC,
+                              0644);
+        if (fd < 0)
+            tms_throw_errno(path + ": open");
+        try
+        {
+            const TMSLogSegmentHeader h = makeHeader(seg);
+            if (::pwrite(fd, &h, sizeof h, 0) != ssize_t(sizeof h)
+                || ::fdatasync(fd) != 0)
+                tms_throw_errno(path + ": write header");
+            syncDir();
+            mapSegment(fd, seg);
+        }
+        catch (...)
+        {
+            ::close(fd);
+            throw;
+        }
+        if (_fd >= 0)
+            ::close(_fd);
+        _fd = fd;
+    }
+
+
+    // recover
+    // Opens every segment; scans and truncates the last
+    void recover()
+    {
+        if (::mkdir(_dir.c_str(), 0755) != 0 && errno != EEXIST)
+            tms_throw_errno(_dir + ": mkdir");
+        for (size_type seg = 0; ; ++seg)
+        {
+            const std::string path = segmentPath(seg);
+            const int fd = ::open(path.c_str(), O_RDWR | O_CLOEXEC);
+            if (fd < 0)
+            {
+                if (errno != ENOENT)
+                    tms_throw_errno(path + ": open");
+                break;
+            }
+            struct stat st;
+            TMSLogSegmentHeader h;
+            bool intact = ::fstat(fd, &st) == 0
+                          && size_type(st.st_size) >= HEADER;
+            if (intact)
+            {
+                tms_pread_all(fd, &h, sizeof h, 0, path);
+                intact = headerValid(h, seg);
+            }
+            const bool last = ::access(segmentPath(seg + 1).c_str(), F_OK) != 0;
+            if (!intact)
+            {
+                ::close(fd);
+                if (!last)
+                    throw std::runtime_error(path + ": damaged segment header");
+                // Torn while being created: it never held a record
+                if (::unlink(path.c_str()) != 0)
+                    tms_throw_errno(path + ": unlink");
+                break;
+            }
+            const size_type fileRecords = (size_type(st.st_size) - HEADER) / RECORD;
+            try
+            {
+                mapSegment(fd, seg);
+            }
+            catch (...)
+            {
+                ::close(fd);
+                throw;
+            }
+            if (!last)
+            {
+                ::close(fd);
+                if (fileRecords < _segRecords)
+                    throw std::runtime_error(path + ": segment short of full");
+                _durable += _segRecords;
+                continue;
+            }
+            _fd = fd;
+            size_type valid = 0;
+            const size_type first = seg * _segRecords;
+            const size_type limit = std::min(fileRecords, _segRecords);
+            while (valid < limit && recordValid(first + valid, recordAt(first + valid)))
+                ++valid;
+            _durable += valid;
+            const size_type keep = HEADER + valid * RECORD;
+            if (size_type(st.st_size) != keep)
+            {
+                if (::ftruncate(fd, off_t(keep)) != 0 || ::fdatasync(fd) != 0)
+                    tms_throw_errno(path + ": truncate torn tail");
+            }
+            break;
+        }
+        if (_segs.empty())
+            addSegment();
+    }
+
+
+    // syncFrom
+    // Writes and flushes the tail, segment by segment; done counts the
+    //  records made durable so far
+    void syncFrom(size_type & done)
+    {
+        while (done < _tail.size())
+        {
+            if (_durable == _segs.size() * _segRecords)
+                addSegment();
+            const size_type slot = _durable % _segRecords;
+            const size_type k = std::min(_segRecords - slot,
+                                         _tail.size() - done);
+            _buf.resize(std::max(size_type(1), k * RECORD));
+            for (size_type j = 0; j < k; ++j)
+                encode(_durable + j, _tail[done + j], &_buf[j * RECORD]);
+            writeAll(_buf.begin(), k * RECORD, HEADER + slot * RECORD);
+            if (::fdatasync(_fd) != 0)
+                tms_throw_errno(segmentPath(_segs.size() - 1) + ": fdatasync");
+            _durable += k;
+            done += k;
+        }
+    }
+
+
+    // dropTail
+    // Removes the first n (now durable) records from the tail
+    void dropTail(size_type n) noexcept
+    {
+        if (n == 0)
+            return;
+        std::copy(_tail.begin() + n, _tail.end(), _tail.begin());
+        _tail.resize(_tail.size() - n);
+    }
+
+
+    // release
+    // Unmaps segments and closes the current one
+    void release() noexcept
+    {
+        for (const Segment & s : _segs)
+            ::munmap(const_cast<unsigned char *>(s.map), segmentBytes());
+        _segs.resize(0);
+        if (_fd >= 0)
+            ::close(_fd);
+        _fd = -1;
+    }
+
+
+// ***** TMSLogArray: data members *****
+private:
+
+    std::string              _dir;
+    size_type                _batch;
+    size_type                _segRecords;
+    int                      _fd;           // last segment, read-write
+    size_type                _durable;      // records synced
+    TMSArray<Segment>        _segs;
+    TMSArray<value_type>     _tail;         // records not yet synced
+    TMSArray<unsigned char>  _buf;          // encoded batch
+
+}; // end of class
@@ -0,0 +1,123 @@
+// tmslog_bench.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Benchmark: TMSLogArray<Event> (24-byte records) append throughput for
+//  group-commit batch sizes 1 to 65536 (one fdatasync per batch), then
+//  reopen/recovery time, sequential iteration and random reads.
+// Usage: tmslog_bench [records=4194304] [dir=/tmp/tmslog_bench]
+// Requires tmslog.hpp, tmsserial.hpp, tmscrc32.hpp, tmssimd.hpp,
+//  tmsarray.hpp, tmsbench.hpp
+
+#include "tmslog.hpp"
+#include "tmsbench.hpp"
+
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::int64_t;
+using std::uint32_t;
+using std::uint64_t;
+#include <cstdlib>
+using std::system;
+#include <algorithm>
+using std::min;
+#include <iostream>
+using std::cout;
+#include <string>
+using std::string;
+using std::to_string;
+
+
+// Event
+struct Event
+{
+    int64_t  time;
+    uint32_t id;
+    float    value;
+    int64_t  flags;
+};
+
+
+int main(int argc, char * argv[])
+{
+    const size_t n = tms_arg(argc, argv, 1, size_t(1) << 22);
+    const string dir = argc > 2 ? argv[2] : "/tmp/tmslog_bench";
+    cout << "records of " << sizeof(Event) << " bytes (+4 CRC), log in "
+         << dir << "\n";
+
+    // Small batches are bounded by the fdatasync rate: cap them at
+    //  2000 syncs each
+    for (size_t batch : { 1, 16, 256, 4096, 65536 })
+    {
+        const size_t count = min(n, batch * 2000);
+        const double secs = tms_time_best(1, [&]
+        {
+            if (system(("rm -rf " + dir).c_str()) != 0)
+                return;
+            TMSLogArray<Event> log(dir, batch);
+            for (size_t i = 0; i < count; ++i)
+                log.append(Event{ int64_t(i), uint32_t(i), float(i), 0 });
+            log.sync();
+        });
+        tms_report("append batch " + to_string(batch) + " ("
+                   + to_string(count) + " recs)", secs,
+                   count * sizeof(Event));
+        cout << "    " << double(count) / secs / 1e6 << " M records/s, "
+             << secs / double((count + batch - 1) / batch) * 1e6
+             << " us per commit\n";
+    }
+
+    // Full-size log for the read side
+    if (system(("rm -rf " + dir).c_str()) != 0)
+        return 1;
+    {
+        TMSLogArray<Event> log(dir, 65536);
+        for (size_t i = 0; i < n; ++i)
+            log.append(Event{ int64_t(i), uint32_t(i), float(i), 0 });
+    }
+
+    double secs = tms_time_best(3, [&]
+    {
+        TMSLogArray<Event> log(dir);
+        tms_sink(log.size());
+    });
+    tms_report("reopen + tail recovery scan", secs);
+
+    TMSLogArray<Event> log(dir);
+    secs = tms_time_best(3, [&]
+    {
+        int64_t sum = 0;
+        for (const Event & e : log)
+            sum += e.time;
+        tms_sink(sum);
+    });
+    tms_report("iterate", secs, n * sizeof(Event));
+
+    secs = tms_time_best(3, [&]
+    {
+        TMSArray<Event> out(n);
+        log.read(0, n, out.begin());
+        tms_sink(out[n - 1].time);
+    });
+    tms_report("read into TMSArray", secs, n * sizeof(Event));
+
+    const size_t probes = size_t(1) << 22;
+    secs = tms_time_best(3, [&]
+    {
+        uint64_t y = 1;
+        int64_t sum = 0;
+        for (size_t k = 0; k < probes; ++k)
+        {
+            y = y * 6364136223846793005ull + 1442695040888963407ull;
+            sum += log[(y >> 20) % n].time;
+        }
+        tms_sink(sum);
+    });
+    tms_report("4M random reads", secs);
+
+    secs = tms_time_best(3, [&]{ tms_sink(log.verify(0, n)); });
+    tms_report("verify all CRCs", secs, n * (sizeof(Event) + 4));
+
+    return system(("rm -rf " + dir).c_str()) == 0 ? 0 : 1;
+}
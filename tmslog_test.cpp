@@ -0,0 +1,336 @@
+// tmslog_test.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Test program for class template TMSLogArray
+// Uses the "doctest" unit-testing framework, version 2
+// Requires doctest.h, tmslog.hpp, tmsserial.hpp, tmscrc32.hpp,
+//  tmssimd.hpp, tmsarray.hpp
+
+// Includes for code to be tested
+#include "tmslog.hpp"        // For class template TMSLogArray
+#include "tmslog.hpp"        // Double-inclusion check, for testing only
+
+// Includes for the "doctest" unit-testing framework
+#define DOCTEST_CONFIG_IMPLEMENT
+                             // We write our own main
+#define DOCTEST_CONFIG_SUPER_FAST_ASSERTS
+                             // Reduce compile time
+#include "doctest.h"         // For doctest
+
+// Includes for all test programs
+#include <iostream>
+using std::cout;
+using std::endl;
+using std::cin;
+#include <string>
+using std::string;
+
+// Additional includes for this test program
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::int64_t;
+using std::uint32_t;
+using std::uint64_t;
+#include <cstdlib>
+using std::system;
+#include <stdexcept>
+using std::runtime_error;
+#include <unistd.h>          // For getpid, fork, _exit, truncate
+#include <sys/wait.h>        // For waitpid
+
+// Printable name for this test suite
+const string test_suite_name =
+    "class template TMSLogArray";
+
+
+// *********************************************************************
+// Helper Functions for This Test Program
+// *********************************************************************
+
+
+// Event
+// A typical fixed-size log record
+struct Event
+{
+    int64_t  time;
+    uint32_t id;
+    float    value;
+};
+
+
+// event
+// Record i of the test logs
+Event event(size_t i)
+{
+    return Event{ int64_t(i) * 1000, uint32_t(i * 7), float(i) / 2 };
+}
+
+
+// sameEvent
+bool sameEvent(const Event & a, const Event & b)
+{
+    return a.time == b.time && a.id == b.id && a.value == b.value;
+}
+
+
+// tempDir
+// A per-process scratch directory name under /tmp, removed first
+string tempDir(const string & tag)
+{
+    const string dir = "/tmp/tmslog_test_" + std::to_string(getpid()) + "_" + tag;
+    REQUIRE( system(("rm -rf " + dir).c_str()) == 0 );
+    return dir;
+}
+
+
+// removeDir
+void removeDir(const string & dir)
+{
+    REQUIRE( system(("rm -rf " + dir).c_str()) == 0 );
+}
+
+
+// segFile
+// Path of segment seg in dir
+string segFile(const string & dir, int seg)
+{
+    char name[32];
+    std::snprintf(name, sizeof name, "/%016d.tlog", seg);
+    return dir + name;
+}
+
+
+// fileSize
+size_t fileSize(const string & path)
+{
+    struct stat st;
+    REQUIRE( ::stat(path.c_str(), &st) == 0 );
+    return size_t(st.st_size);
+}
+
+
+// *********************************************************************
+// Test Cases
+// *********************************************************************
+
+
+TEST_CASE( "Append, read and reopen" )
+{
+    const string dir = tempDir("basic");
+    {
+        TMSLogArray<Event> tl(dir, 100);
+        REQUIRE( tl.empty() );
+        REQUIRE( tl.segment_count() == 1 );
+        for (size_t i = 0; i < 250; ++i)
+            tl.append(event(i));
+        REQUIRE( tl.size() == 250 );
+        REQUIRE( tl.durable_size() == 200 );
+        REQUIRE( tl.tail().size() == 50 );
+        REQUIRE( sameEvent(tl.tail()[0], event(200)) );
+        for (size_t i = 0; i < 250; ++i)
+            REQUIRE( sameEvent(tl[i], event(i)) );
+        tl.sync();
+        REQUIRE( tl.durable_size() == 250 );
+        REQUIRE( tl.tail().empty() );
+        REQUIRE( tl.verify(0, 250) );
+    }
+    TMSLogArray<Event> tl(dir);
+    REQUIRE( tl.size() == 250 );
+    REQUIRE( tl.durable_size() == 250 );
+    size_t i = 0;
+    for (const Event & e : tl)
+        REQUIRE( sameEvent(e, event(i++)) );
+    REQUIRE( i == 250 );
+    removeDir(dir);
+}
+
+
+TEST_CASE( "Segments roll over" )
+{
+    const string dir = tempDir("roll");
+    {
+        TMSLogArray<uint64_t> tl(dir, 7, 10);
+        REQUIRE( tl.segment_records() == 10 );
+        TMSArray<uint64_t> ta(95);
+        for (size_t i = 0; i < ta.size(); ++i)
+            ta[i] = i * i;
+        tl.append(ta.begin(), ta.size());
+        REQUIRE( tl.durable_size() == 91 );
+        tl.sync();
+        REQUIRE( tl.segment_count() == 10 );
+        REQUIRE( fileSize(segFile(dir, 0)) == 64 + 10 * 12 );
+        REQUIRE( fileSize(segFile(dir, 9)) == 64 + 5 * 12 );
+        TMSArray<uint64_t> tb(30);
+        tl.read(40, 30, tb.begin());
+        for (size_t i = 0; i < tb.size(); ++i)
+            REQUIRE( tb[i] == (40 + i) * (40 + i) );
+    }
+    {
+        // The segment size of an existing log wins
+        TMSLogArray<uint64_t> tl(dir, 4, 1000);
+        REQUIRE( tl.segment_records() == 10 );
+        REQUIRE( tl.size() == 95 );
+        for (uint64_t v = 0; v < 10; ++v)
+            tl.append(v);
+    }
+    TMSLogArray<uint64_t> tl(dir);
+    REQUIRE( tl.size() == 105 );
+    REQUIRE( tl.segment_count() == 11 );
+    REQUIRE( tl[104] == 9 );
+    REQUIRE( tl[94] == 94 * 94 );
+    REQUIRE( tl.verify(0, 105) );
+    removeDir(dir);
+}
+
+
+TEST_CASE( "Unsynced records are lost in a crash, synced ones kept" )
+{
+    const string dir = tempDir("crash");
+    const pid_t pid = fork();
+    REQUIRE( pid >= 0 );
+    if (pid == 0)
+    {
+        TMSLogArray<Event> tl(dir, 1000);
+        for (size_t i = 0; i < 1500; ++i)
+            tl.append(event(i));
+        _exit(0);               // no destructor: simulated crash
+    }
+    int status = 0;
+    REQUIRE( waitpid(pid, &status, 0) == pid );
+    TMSLogArray<Event> tl(dir);
+    REQUIRE( tl.size() == 1000 );
+    REQUIRE( sameEvent(tl[999], event(999)) );
+    removeDir(dir);
+}
+
+
+TEST_CASE( "Recovery truncates a torn tail" )
+{
+    const string dir = tempDir("torn");
+    {
+        TMSLogArray<uint64_t> tl(dir, 1, 100);
+        for (uint64_t v = 0; v < 50; ++v)
+            tl.append(v);
+    }
+    const string seg = segFile(dir, 0);
+
+    SUBCASE( "Partial record" )
+    {
+        REQUIRE( ::truncate(seg.c_str(), 64 + 49 * 12 + 5) == 0 );
+        TMSLogArray<uint64_t> tl(dir);
+        REQUIRE( tl.size() == 49 );
+        REQUIRE( fileSize(seg) == 64 + 49 * 12 );
+    }
+    SUBCASE( "Corrupt record" )
+    {
+        TMSFd file(::open(seg.c_str(), O_WRONLY));
+        const unsigned char junk = 0xEE;
+        REQUIRE( ::pwrite(file.fd, &junk, 1, 64 + 40 * 12 + 3) == 1 );
+        TMSLogArray<uint64_t> tl(dir);
+        REQUIRE( tl.size() == 40 );
+        REQUIRE( fileSize(seg) == 64 + 40 * 12 );
+        // Appends continue from the cut
+        tl.append(777);
+        REQUIRE( tl[40] == 777 );
+    }
+    SUBCASE( "Stale record left from an earlier crash" )
+    {
+        // Record 45 valid for index 45, but appended after a hole
+        REQUIRE( ::truncate(seg.c_str(), 64 + 50 * 12) == 0 );
+        TMSFd file(::open(seg.c_str(), O_WRONLY));
+        const unsigned char zeros[12] = {};
+        REQUIRE( ::pwrite(file.fd, zeros, 12, 64 + 44 * 12) == 12 );
+        TMSLogArray<uint64_t> tl(dir);
+        REQUIRE( tl.size() == 44 );
+    }
+    removeDir(dir);
+}
+
+
+TEST_CASE( "Recovery handles a torn new segment" )
+{
+    const string dir = tempDir("newseg");
+    {
+        TMSLogArray<int> tl(dir, 5, 5);
+        for (int v = 0; v < 10; ++v)
+            tl.append(v);
+        REQUIRE( tl.segment_count() == 2 );
+    }
+    // Segment 2 was being created when the crash hit
+    {
+        TMSFd file(::open(segFile(dir, 2).c_str(), O_WRONLY | O_CREAT, 0644));
+        REQUIRE( ::write(file.fd, "TMSLO", 5) == 5 );
+    }
+    TMSLogArray<int> tl(dir);
+    REQUIRE( tl.size() == 10 );
+    tl.append(10);
+    tl.sync();
+    REQUIRE( tl.segment_count() == 3 );
+    REQUIRE( tl[10] == 10 );
+    removeDir(dir);
+}
+
+
+TEST_CASE( "Rejects damage before the tail and other types" )
+{
+    const string dir = tempDir("bad");
+    {
+        TMSLogArray<int> tl(dir, 5, 5);
+        for (int v = 0; v < 12; ++v)
+            tl.append(v);
+        tl.sync();
+    }
+    REQUIRE_THROWS_AS( TMSLogArray<float>(dir, 16), runtime_error );
+    REQUIRE_THROWS_AS( TMSLogArray<int64_t>(dir, 16), runtime_error );
+    REQUIRE( ::truncate(segFile(dir, 1).c_str(), 64 + 3 * 8) == 0 );
+    REQUIRE_THROWS_AS( TMSLogArray<int>(dir, 16), runtime_error );
+    REQUIRE_THROWS( TMSLogArray<int>(dir, 0) );
+    removeDir(dir);
+}
+
+
+// *********************************************************************
+// Main Program
+// *********************************************************************
+
+
+// userPause
+// Wait for user to press ENTER: read all chars through first newline.
+void userPause()
+{
+    std::cout.flush();
+    while (std::cin.get() != '\n') ;
+}
+
+
+// Main program
+// Run all tests. Prompt for ENTER before exiting.
+int main(int argc,
+         char *argv[])
+{
+    doctest::Context dtcontext;
+                             // Primary doctest object
+    int dtresult;            // doctest return code; for return by main
+
+    // Handle command line
+    dtcontext.applyCommandLine(argc, argv);
+    dtresult = 0;            // doctest flags no command-line errors
+                             //  (strange but true)
+
+    if (!dtresult)           // Continue only if no command-line error
+    {
+        // Run test suites
+        cout << "BEGIN tests for " << test_suite_name << "\n" << endl;
+        dtresult = dtcontext.run();
+        cout << "END tests for " << test_suite_name << "\n" << endl;
+    }
+
+    // Wait for user
+    std::cout << "Press ENTER to quit ";
+    userPause();
+
+    // Program return value is return code from doctest
+    return dtresult;
+}
@@ -0,0 +1,630 @@
+// tmsmapped.hpp
+// Matthew Johnson
+// 10/17/2026
+// persistent TMSArray whose storage is a shared mmap of a file: grows
+//  by ftruncate and remap, commits a checksummed header (POSIX)
+
+#pragma once
+// for single inclusion
+
+#include "tmsserial.hpp"
+// For TMSFileHeader
+// For tms_file_header
+// For tms_check_header
+// For tms_throw_errno
+// For TMSAdvice
+
+#include "tmscrc32.hpp"
+// For tms_crc32c
+
+#include "tmssimd.hpp"
+// For tms_search
+
+#include <cstddef>
+// For std::size_t
+
+#include <cstdint>
+// For std::uint32_t
+// For std::uint64_t
+
+#include <cstring>
+// For std::memcpy
+
+#include <string>
+// For std::string
+
+#include <stdexcept>
+// For std::runtime_error
+// For std::length_error
+
+#include <type_traits>
+// For std::is_trivially_copyable
+
+#include <algorithm>
+// For std::max
+// For std::min
+
+#include <utility>
+// For std::swap
+
+#include <fcntl.h>
+// For open
+
+#include <unistd.h>
+// For close
+// For ftruncate
+// For sysconf
+
+#include <sys/mman.h>
+// For mmap
+// For munmap
+// For msync
+// For madvise
+
+#include <sys/stat.h>
+// For fstat
+
+
+
+// *********************************************************************
+// class TMSMappedArray - Class definition
+// *********************************************************************
+
+
+// class TMSMappedArray
+// Array stored in a file in the tmsserial.hpp format and mapped shared
+//  read-write, so its contents outlive the process and reopening costs
+//  one header check instead of a rebuild. Capacity is the file size past
+//  the header; growing doubles it with ftruncate and maps the file again.
+//
+// Durability: the header's count and data_crc are what a reopen trusts.
+//  commit() rewrites the header in the mapping (survives a process crash,
+//  since the page cache is shared); flush() first msyncs the elements,
+//  then writes and msyncs the header, so after flush() returns the file
+//  holds exactly those elements even across power loss. The header lies
+//  in the first disk sector and carries its own CRC, so a torn header
+//  write is detected on open. Elements appended after the last commit
+//  are dropped on reopen.
+//
+// The data CRC is extended incrementally over appended elements; any
+//  non-const access to already checksummed elements makes the next
+//  commit recompute it over the whole array. Staleness is marked when
+//  the reference or iterator is handed out, so one kept across a
+//  commit() and written through afterwards goes unnoticed by the next
+//  commit(): the header would hold a stale CRC that a verifying reopen
+//  rejects. flush() always recomputes the CRC over the whole array, so
+//  such writes are safe if a flush() follows them.
+// Requirements on Types:
+//     Valtype is trivially copyable.
+// Invariants:
+//     _size <= _capacity; the file is _dataOffset + _capacity elements.
+//     _crc is the CRC-32C of the first _crcCount elements.
+template <typename Valtype>
+class TMSMappedArray
+{
+
+    static_assert(std::is_trivially_copyable<Valtype>::value,
+                  "TMSMappedArray stores raw bytes");
+
+public:
+
+
+    using value_type = Valtype;
+
+    using size_type  = std::size_t;
+
+    using iterator = value_type*;
+
+    using const_iterator = const value_type*;
+
+
+// ***** TMSMappedArray: ctors, op=, dctor *****
+public:
+
+
+    // Ctor from path
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Opens path, creating an empty array file if it does not exist
+    //      or is empty; otherwise the array holds the committed elements.
+    //      With verify, checks them against the stored data CRC. Throws
+    //      std::system_error on I/O errors, std::runtime_error if the file
+    //      is not a matching TMSArray file in native byte order.
+    explicit TMSMappedArray(const std::string & path, bool verify = false)
+        :_fd(-1),
+         _map(nullptr),
+         _mapLen(0),
+         _data(nullptr),
+         _dataOffset(0),
+         _capacity(0),
+         _size(0),
+         _crc(0),
+         _crcCount(0),
+         _committed(0),
+         _path(path)
+    {
+        _fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (_fd < 0)
+            tms_throw_errno(path + ": open");
+        try
+        {
+            openFile(verify);
+        }
+        catch (...)
+        {
+            release();
+            throw;
+        }
+    }
+
+
+    // No copying: a mapped array owns its file
+    TMSMappedArray(const TMSMappedArray &) = delete;
+    TMSMappedArray & operator=(const TMSMappedArray &) = delete;
+
+
+    // Move ctor
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      *this owns other's file and mapping; other is closed
+    TMSMappedArray(TMSMappedArray && other) noexcept
+        :_fd(-1),
+         _map(nullptr),
+         _mapLen(0),
+         _data(nullptr),
+         _dataOffset(0),
+         _capacity(0),
+         _size(0),
+         _crc(0),
+         _crcCount(0),
+         _committed(0)
+    {
+        swap(other);
+    }
+
+
+    // Move assignment operator
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      *this owns other's file; other gets the old one
+    TMSMappedArray & operator=(TMSMappedArray && other) noexcept
+    {
+        swap(other);
+        return *this;
+    }
+
+
+    // Dctor
+    // No-Throw Guarantee
+    // Pre: None
+    // Post:
+    //      Header committed (not synced; call flush() for that), mapping
+    //      and file released. Commit errors are ignored here.
+    ~TMSMappedArray()
+    {
+        if (_map)
+            writeHeader();
+        release();
+    }
+
+
+// ***** TMSMappedArray: general public operators *****
+public:
+
+
+    // operator[]
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      0 <= index < size()
+    // Post:
+    //      Returns element index. The non-const form marks the data CRC
+    //      stale if index is already checksummed.
+    value_type & operator[](size_type index) noexcept
+    {
+        if (index < _crcCount)
+            _crcCount = 0;
+        return _data[index];
+    }
+    const value_type & operator[](size_type index) const noexcept
+    {
+        return _data[index];
+    }
+
+
+// ***** TMSMappedArray: general public functions *****
+public:
+
+
+    // size
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns number of elements
+    size_type size() const noexcept
+    {
+        return _size;
+    }
+
+
+    // empty
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns size() == 0
+    bool empty() const noexcept
+    {
+        return _size == 0;
+    }
+
+
+    // capacity
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns number of elements the file holds room for
+    size_type capacity() const noexcept
+    {
+        return _capacity;
+    }
+
+
+    // committed_size
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns the element count in the file header: what a reopen
+    //      would see
+    size_type committed_size() const noexcept
+    {
+        return _committed;
+    }
+
+
+    // begin, end
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns iterator to first element; past the last. The
+    //      non-const forms mark the data CRC stale.
+    iterator begin() noexcept
+    {
+        _crcCount = 0;
+        return _data;
+    }
+    iterator end() noexcept
+    {
+        return begin() + size();
+    }
+    const_iterator begin() const noexcept
+    {
+        return _data;
+    }
+    const_iterator end() const noexcept
+    {
+        return _data + _size;
+    }
+
+
+    // reserve
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      capacity() >= newcap. Growing extends the file and remaps it,
+    //      invalidating iterators and references. Throws
+    //      std::system_error if the file cannot grow or be mapped.
+    void reserve(size_type newcap)
+    {
+        if (newcap > _capacity)
+            remap(newcap);
+    }
+
+
+    // resize
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      size() == newsize; new elements have unspecified values (zero
+    //      if the file never held them). Capacity at least doubles when
+    //      it must grow.
+    void resize(size_type newsize)
+    {
+        if (newsize > _capacity)
+            remap(std::max(_capacity * 2, newsize));
+        if (newsize < _crcCount)
+            _crcCount = 0;
+        _size = newsize;
+    }
+
+
+    // push_back
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      item appended; amortized O(1)
+    void push_back(const value_type & item)
+    {
+        if (_size == _capacity)
+            remap(std::max(_capacity * 2, size_type(1)));
+        _data[_size++] = item;
+    }
+
+
+    // append
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      [values, values + n) valid and not inside this array
+    // Post:
+    //      values appended, in order
+    void append(const value_type * values, size_type n)
+    {
+        if (n > _capacity - _size)
+            remap(std::max(_capacity * 2, _size + n));
+        if (n != 0)
+            std::memcpy(_data + _size, values, n * sizeof(value_type));
+        _size += n;
+    }
+
+
+    // pop_back
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      !empty()
+    // Post:
+    //      Last element removed
+    void pop_back() noexcept
+    {
+        if (--_size < _crcCount)
+            _crcCount = 0;
+    }
+
+
+    // commit
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Header records size() and the data CRC; visible to any later
+    //      open, but not yet forced to disk
+    void commit() noexcept
+    {
+        writeHeader();
+    }
+
+
+    // flush
+    // Basic Guarantee (the header is not updated if the data sync fails)
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Elements synced to disk, then the header committed with the
+    //      data CRC recomputed over all elements, and synced: the file
+    //      holds exactly the current elements durably. Throws
+    //      std::system_error if msync fails.
+    void flush()
+    {
+        if (_size != 0 && ::msync(_map, _dataOffset + _size * sizeof(value_type),
+                                  MS_SYNC) != 0)
+            tms_throw_errno(_path + ": msync");
+        _crcCount = 0;
+        writeHeader();
+        if (::msync(_map, sizeof(TMSFileHeader), MS_SYNC) != 0)
+            tms_throw_errno(_path + ": msync");
+    }
+
+
+    // advise
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Passes the access pattern to the kernel (madvise); returns
+    //      false if rejected
+    bool advise(TMSAdvice advice) const noexcept
+    {
+        const int how = advice == TMS_ADVISE_SEQUENTIAL ? MADV_SEQUENTIAL
+                      : advice == TMS_ADVISE_RANDOM     ? MADV_RANDOM
+                      : advice == TMS_ADVISE_WILLNEED   ? MADV_WILLNEED
+                                                        : MADV_NORMAL;
+        return ::madvise(_map, _mapLen, how) == 0;
+    }
+
+
+    // swap
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      *this and other exchange files and mappings
+    void swap(TMSMappedArray & other) noexcept
+    {
+        std::swap(_fd, other._fd);
+        std::swap(_map, other._map);
+        std::swap(_mapLen, other._mapLen);
+        std::swap(_data, other._data);
+        std::swap(_dataOffset, other._dataOffset);
+        std::swap(_capacity, other._capacity);
+        std::swap(_size, other._size);
+        std::swap(_crc, other._crc);
+        std::swap(_crcCount, other._crcCount);
+        std::swap(_committed, other._committed);
+        _path.swap(other._path);
+    }
+
+
+// ***** TMSMappedArray: search functions *****
+public:
+
+
+    // find
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns iterator to first element == item, or end() if none
+    const_iterator find(const value_type & item) const
+    {
+        return begin() + tms_search<false>(begin(), size(), item, TMS_CMP_EQ);
+    }
+
+
+    // count
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns number of elements == item
+    size_type count(const value_type & item) const
+    {
+        return tms_search<true>(begin(), size(), item, TMS_CMP_EQ);
+    }
+
+
+    // contains
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns whether some element == item
+    bool contains(const value_type & item) const
+    {
+        return find(item) != end();
+    }
+
+
+// ***** TMSMappedArray: private helper functions *****
+private:
+
+
+    // openFile
+    // Maps an existing array file, or initializes an empty one with one
+    //  page of capacity
+    void openFile(bool verify)
+    {
+        struct stat st;
+        if (::fstat(_fd, &st) != 0)
+            tms_throw_errno(_path + ": stat");
+        const std::uint64_t fileSize = std::uint64_t(st.st_size);
+        if (fileSize == 0)
+        {
+            const TMSFileHeader h = tms_file_header<value_type>(0, 0);
+            _dataOffset = size_type(h.data_offset);
+            const size_type page = size_type(::sysconf(_SC_PAGESIZE));
+            remap(std::max(size_type(1),
+                           (page - _dataOffset) / sizeof(value_type)));
+            std::memcpy(_map, &h, sizeof h);
+            return;
+        }
+
+        TMSFileHeader h;
+        tms_pread_all(_fd, &h, std::min(fileSize, std::uint64_t(sizeof h)), 0,
+                      _path);
+        if (tms_check_header<value_type>(h, fileSize, _path))
+            throw std::runtime_error(_path + ": opposite byte order; "
+                                     "use tms_load to convert");
+        _dataOffset = size_type(h.data_offset);
+        _capacity = size_type((fileSize - h.data_offset) / sizeof(value_type));
+        _mapLen = size_type(fileSize);
+        void * map = ::mmap(nullptr, _mapLen, PROT_READ | PROT_WRITE,
+                            MAP_SHARED, _fd, 0);
+        if (map == MAP_FAILED)
+            tms_throw_errno(_path + ": mmap");
+        _map = map;
+        _data = reinterpret_cast<value_type *>(
+            static_cast<char *>(map) + _dataOffset);
+        _size = _committed = size_type(h.count);
+        _crc = h.data_crc;
+        _crcCount = _size;
+        if (verify && tms_crc32c(_data, _size * sizeof(value_type)) != _crc)
+            throw std::runtime_error(_path + ": data checksum mismatch");
+    }
+
+
+    // remap
+    // Extends the file to newcap elements and maps it again; on failure
+    //  the old mapping stays in place
+    void remap(size_type newcap)
+    {
+        if (newcap > (size_type(-1) - _dataOffset) / sizeof(value_type))
+            throw std::length_error(_path + ": capacity overflow");
+        const size_type newLen = _dataOffset + newcap * sizeof(value_type);
+        if (::ftruncate(_fd, off_t(newLen)) != 0)
+            tms_throw_errno(_path + ": ftruncate");
+        void * map = ::mmap(nullptr, newLen, PROT_READ | PROT_WRITE,
+                            MAP_SHARED, _fd, 0);
+        if (map == MAP_FAILED)
+            tms_throw_errno(_path + ": mmap");
+        if (_map)
+            ::munmap(_map, _mapLen);
+        _map = map;
+        _mapLen = newLen;
+        _data = reinterpret_cast<value_type *>(
+            static_cast<char *>(map) + _dataOffset);
+        _capacity = newcap;
+    }
+
+
+    // writeHeader
+    // Extends the data CRC to size() elements and stores the header
+    void writeHeader() noexcept
+    {
+        if (_crcCount > _size)
+            _crcCount = 0;
+        if (_crcCount == 0)
+            _crc = 0;
+        _crc = tms_crc32c(_data + _crcCount,
+                          (_size - _crcCount) * sizeof(value_type), _crc);
+        _crcCount = _size;
+        TMSFileHeader h = tms_file_header<value_type>(_size, _crc);
+        h.data_offset = _dataOffset;
+        h.header_crc = tms_header_crc(h);
+        std::memcpy(_map, &h, sizeof h);
+        _committed = _size;
+    }
+
+
+    // release
+    // Unmaps and closes
+    void release() noexcept
+    {
+        if (_map)
+            ::munmap(_map, _mapLen);
+        if (_fd >= 0)
+            ::close(_fd);
+        _map = nullptr;
+        _fd = -1;
+    }
+
+
+// ***** TMSMappedArray: data members *****
+private:
+
+    int          _fd;
+    void *       _map;
+    size_type    _mapLen;
+    value_type * _data;
+    size_type    _dataOffset;
+    size_type    _capacity;
+    size_type    _size;
+    std::uint32_t _crc;         // CRC-32C of the first _crcCount elements
+    size_type    _crcCount;
+    size_type    _committed;    // count in the header
+    std::string  _path;
+
+}; // end of class
@@ -0,0 +1,201 @@
+// tmsmapped_bench.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Benchmark: TMSMappedArray<int64_t> vs. TMSArray<int64_t>.
+//  Append throughput (plain, mapped, mapped with a commit or a flush
+//  every 1M values) and cold-start time: rebuilding from a text file,
+//  tms_load, and reopening the mapped file, with and without a full
+//  scan. Cold runs evict the file from the page cache first.
+// Usage: tmsmapped_bench [values=8388608] [dir=/tmp]
+// Requires tmsmapped.hpp, tmsserial.hpp, tmscrc32.hpp, tmssimd.hpp,
+//  tmsarray.hpp, tmsbench.hpp
+
+#include "tmsmapped.hpp"
+#include "tmsbench.hpp"
+
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::int64_t;
+using std::uint64_t;
+#include <cstdio>
+using std::remove;
+using std::FILE;
+using std::fopen;
+using std::fclose;
+using std::fprintf;
+using std::fgets;
+#include <cstdlib>
+using std::strtoll;
+#include <iostream>
+using std::cout;
+#include <string>
+using std::string;
+#include <fcntl.h>           // For posix_fadvise
+#include <unistd.h>          // For fsync
+
+
+// dropCache
+// Writes back and evicts the file's pages, so the next read is cold
+void dropCache(const string & path)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return;
+    ::fsync(fd);
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(fd);
+}
+
+
+// nextValue
+int64_t nextValue(uint64_t & x)
+{
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return int64_t(x >> 20);
+}
+
+
+int main(int argc, char * argv[])
+{
+    const size_t n = tms_arg(argc, argv, 1, size_t(1) << 23);
+    const string dir = argc > 2 ? argv[2] : "/tmp";
+    const string mapPath = dir + "/tmsmapped_bench.tms";
+    const string textPath = dir + "/tmsmapped_bench.txt";
+    const string savePath = dir + "/tmsmapped_bench.save";
+    const size_t bytes = n * sizeof(int64_t);
+    const size_t batch = size_t(1) << 20;
+    cout << n << " int64 values (" << bytes << " bytes), files in " << dir
+         << "\n";
+
+    double secs = tms_time_best(3, [&]
+    {
+        TMSArray<int64_t> ta(0);
+        uint64_t x = 88172645463325252ull;
+        for (size_t i = 0; i < n; ++i)
+            ta.push_back(nextValue(x));
+        tms_sink(ta[n - 1]);
+    });
+    tms_report("append TMSArray", secs, bytes);
+
+    secs = tms_time_best(3, [&]
+    {
+        remove(mapPath.c_str());
+        TMSMappedArray<int64_t> tm(mapPath);
+        uint64_t x = 88172645463325252ull;
+        for (size_t i = 0; i < n; ++i)
+            tm.push_back(nextValue(x));
+        tm.commit();
+    });
+    tms_report("append mapped, commit at end", secs, bytes);
+
+    secs = tms_time_best(3, [&]
+    {
+        remove(mapPath.c_str());
+        TMSMappedArray<int64_t> tm(mapPath);
+        tm.reserve(n);
+        uint64_t x = 88172645463325252ull;
+        for (size_t i = 0; i < n; ++i)
+            tm.push_back(nextValue(x));
+        tm.commit();
+    });
+    tms_report("append mapped, reserved", secs, bytes);
+
+    secs = tms_time_best(3, [&]
+    {
+        remove(mapPath.c_str());
+        TMSMappedArray<int64_t> tm(mapPath);
+        uint64_t x = 88172645463325252ull;
+        for (size_t i = 0; i < n; ++i)
+        {
+            tm.push_back(nextValue(x));
+            if ((i + 1) % batch == 0)
+                tm.commit();
+        }
+        tm.commit();
+    });
+    tms_report("append mapped, commit per 1M", secs, bytes);
+
+    secs = tms_time_best(3, [&]
+    {
+        remove(mapPath.c_str());
+        TMSMappedArray<int64_t> tm(mapPath);
+        uint64_t x = 88172645463325252ull;
+        for (size_t i = 0; i < n; ++i)
+        {
+            tm.push_back(nextValue(x));
+            if ((i + 1) % batch == 0)
+                tm.flush();
+        }
+        tm.flush();
+    });
+    tms_report("append mapped, flush per 1M", secs, bytes);
+
+    // Inputs for the cold starts: text (the rebuild source), a saved
+    //  file, and the mapped file from the last run above
+    {
+        FILE * text = fopen(textPath.c_str(), "w");
+        if (!text)
+            return 1;
+        uint64_t x = 88172645463325252ull;
+        TMSArray<int64_t> ta(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            ta[i] = nextValue(x);
+            fprintf(text, "%lld\n", static_cast<long long>(ta[i]));
+        }
+        fclose(text);
+        tms_save(ta, savePath);
+    }
+
+    secs = tms_time_best(3, [&]
+    {
+        dropCache(textPath);
+        FILE * text = fopen(textPath.c_str(), "r");
+        TMSArray<int64_t> ta(0);
+        char line[32];
+        while (fgets(line, sizeof line, text))
+            ta.push_back(strtoll(line, nullptr, 10));
+        fclose(text);
+        tms_sink(ta.size());
+    });
+    tms_report("cold start: rebuild from text", secs, bytes);
+
+    secs = tms_time_best(3, [&]
+    {
+        dropCache(savePath);
+        TMSArray<int64_t> ta;
+        tms_load(savePath, ta);
+        tms_sink(ta[n - 1]);
+    });
+    tms_report("cold start: tms_load", secs, bytes);
+
+    secs = tms_time_best(3, [&]
+    {
+        dropCache(mapPath);
+        TMSMappedArray<int64_t> tm(mapPath);
+        tms_sink(tm.size());
+    });
+    tms_report("cold start: mapped open", secs);
+
+    secs = tms_time_best(3, [&]
+    {
+        dropCache(mapPath);
+        TMSMappedArray<int64_t> tm(mapPath);
+        tm.advise(TMS_ADVISE_SEQUENTIAL);
+        const TMSMappedArray<int64_t> & ctm = tm;
+        int64_t sum = 0;
+        for (int64_t v : ctm)
+            sum += v;
+        tms_sink(sum);
+    });
+    tms_report("cold start: mapped open+scan", secs, bytes);
+
+    remove(mapPath.c_str());
+    remove(textPath.c_str());
+    remove(savePath.c_str());
+    return 0;
+}
@@ -0,0 +1,360 @@
+// tmsmapped_test.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Test program for class template TMSMappedArray
+// Uses the "doctest" unit-testing framework, version 2
+// Requires doctest.h, tmsmapped.hpp, tmsserial.hpp, tmscrc32.hpp,
+//  tmssimd.hpp, tmsarray.hpp
+
+// Includes for code to be tested
+#include "tmsmapped.hpp"     // For class template TMSMappedArray
+#include "tmsmapped.hpp"     // Double-inclusion check, for testing only
+
+// Includes for the "doctest" unit-testing framework
+#define DOCTEST_CONFIG_IMPLEMENT
+                             // We write our own main
+#define DOCTEST_CONFIG_SUPER_FAST_ASSERTS
+                             // Reduce compile time
+#include "doctest.h"         // For doctest
+
+// Includes for all test programs
+#include <iostream>
+using std::cout;
+using std::endl;
+using std::cin;
+#include <string>
+using std::string;
+
+// Additional includes for this test program
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::int64_t;
+using std::uint64_t;
+#include <cstdio>
+using std::remove;
+#include <stdexcept>
+using std::runtime_error;
+#include <utility>
+using std::move;
+#include <unistd.h>          // For getpid, fork, _exit
+#include <sys/wait.h>        // For waitpid
+
+// Printable name for this test suite
+const string test_suite_name =
+    "class template TMSMappedArray";
+
+
+// *********************************************************************
+// Helper Functions for This Test Program
+// *********************************************************************
+
+
+// tempPath
+// A per-process scratch file name under /tmp
+string tempPath(const string & tag)
+{
+    string path = "/tmp/tmsmapped_test_" + std::to_string(getpid()) + "_" + tag;
+    remove(path.c_str());
+    return path;
+}
+
+
+// fileSize
+// Size of the file at path in bytes
+size_t fileSize(const string & path)
+{
+    struct stat st;
+    REQUIRE( ::stat(path.c_str(), &st) == 0 );
+    return size_t(st.st_size);
+}
+
+
+// *********************************************************************
+// Test Cases
+// *********************************************************************
+
+
+TEST_CASE( "New file" )
+{
+    const string path = tempPath("new");
+    {
+        TMSMappedArray<int64_t> tm(path);
+        REQUIRE( tm.empty() );
+        REQUIRE( tm.size() == 0 );
+        REQUIRE( tm.capacity() > 0 );
+        REQUIRE( tm.committed_size() == 0 );
+        REQUIRE( tm.begin() == tm.end() );
+        REQUIRE( fileSize(path) == 64 + tm.capacity() * sizeof(int64_t) );
+    }
+    TMSMappedArray<int64_t> tm(path, true);
+    REQUIRE( tm.empty() );
+    remove(path.c_str());
+}
+
+
+TEST_CASE( "Contents survive reopen" )
+{
+    const string path = tempPath("reopen");
+    const size_t n = 100000;
+    {
+        TMSMappedArray<int64_t> tm(path);
+        for (size_t i = 0; i < n; ++i)
+            tm.push_back(int64_t(i * i));
+        REQUIRE( tm.size() == n );
+        REQUIRE( tm.capacity() >= n );
+        REQUIRE( tm[n - 1] == int64_t((n - 1) * (n - 1)) );
+    }
+    {
+        TMSMappedArray<int64_t> tm(path, true);
+        REQUIRE( tm.size() == n );
+        REQUIRE( tm.committed_size() == n );
+        for (size_t i = 0; i < n; ++i)
+            REQUIRE( tm[i] == int64_t(i * i) );
+        REQUIRE( tm.contains(int64_t(4)) );
+        REQUIRE( tm.find(int64_t(9)) - tm.begin() == 3 );
+        REQUIRE( tm.count(int64_t(2)) == 0 );
+
+        // Keep appending to an existing file
+        const int64_t more[3] = { -1, -2, -3 };
+        tm.append(more, 3);
+        tm.flush();
+    }
+    TMSMappedArray<int64_t> tm(path, true);
+    REQUIRE( tm.size() == n + 3 );
+    REQUIRE( tm[n + 2] == -3 );
+    remove(path.c_str());
+}
+
+
+TEST_CASE( "Readable by tms_load and TMSArrayView" )
+{
+    const string path = tempPath("compat");
+    {
+        TMSMappedArray<double> tm(path);
+        for (int i = 0; i < 1000; ++i)
+            tm.push_back(i * 0.25);
+        tm.flush();
+        REQUIRE( tm.capacity() > tm.size() );
+    }
+    TMSArray<double> ta;
+    tms_load(path, ta);
+    REQUIRE( ta.size() == 1000 );
+    REQUIRE( ta[999] == 249.75 );
+    TMSArrayView<double> tv(path, true);
+    REQUIRE( tv.size() == 1000 );
+    REQUIRE( tv[4] == 1.0 );
+
+    // And a file written by tms_save opens as a mapped array
+    tms_save(ta, path);
+    TMSMappedArray<double> tm(path, true);
+    REQUIRE( tm.size() == 1000 );
+    REQUIRE( tm.capacity() == 1000 );
+    tm.push_back(-1.0);
+    REQUIRE( tm.capacity() == 2000 );
+    REQUIRE( tm[1000] == -1.0 );
+    remove(path.c_str());
+}
+
+
+TEST_CASE( "An empty tms_save file opens and grows" )
+{
+    const string path = tempPath("empty");
+    tms_save(TMSArray<double>(0), path);
+    {
+        TMSMappedArray<double> tm(path, true);
+        REQUIRE( tm.empty() );
+        REQUIRE( tm.capacity() == 0 );
+        tm.push_back(2.5);
+        REQUIRE( tm.capacity() >= 1 );
+        tm.push_back(3.5);
+        tm.flush();
+    }
+    TMSArray<double> ta;
+    tms_load(path, ta);
+    REQUIRE( ta.size() == 2 );
+    REQUIRE( ta[1] == 3.5 );
+    remove(path.c_str());
+}
+
+
+TEST_CASE( "Uncommitted appends are dropped after a crash" )
+{
+    const string path = tempPath("crash");
+    const pid_t pid = fork();
+    REQUIRE( pid >= 0 );
+    if (pid == 0)
+    {
+        TMSMappedArray<int> tm(path);
+        for (int i = 0; i < 5000; ++i)
+            tm.push_back(i);
+        tm.flush();
+        for (int i = 0; i < 5000; ++i)
+            tm.push_back(-i);
+        tm[0] = 99;             // uncommitted overwrite of committed data
+        _exit(0);               // no destructor: simulated crash
+    }
+    int status = 0;
+    REQUIRE( waitpid(pid, &status, 0) == pid );
+    REQUIRE( WIFEXITED(status) );
+
+    TMSMappedArray<int> tm(path);
+    REQUIRE( tm.size() == 5000 );
+    REQUIRE( tm[4999] == 4999 );
+    // The overwrite reached the shared page cache but not the header
+    REQUIRE( tm[0] == 99 );
+    REQUIRE_THROWS_AS( TMSMappedArray<int>(path, true), runtime_error );
+    tm[0] = 0;
+    tm.commit();
+    REQUIRE_NOTHROW( TMSMappedArray<int>(path, true) );
+    remove(path.c_str());
+}
+
+
+TEST_CASE( "Data CRC tracks every kind of change" )
+{
+    const string path = tempPath("crc");
+    TMSMappedArray<unsigned> tm(path);
+    for (unsigned i = 0; i < 3000; ++i)
+        tm.push_back(i);
+    tm.commit();
+    for (unsigned i = 0; i < 10; ++i)
+        tm.push_back(i);
+    tm.commit();
+    REQUIRE_NOTHROW( TMSMappedArray<unsigned>(path, true) );
+
+    tm[5] = 7;
+    tm.commit();
+    REQUIRE_NOTHROW( TMSMappedArray<unsigned>(path, true) );
+
+    tm.pop_back();
+    tm.resize(tm.size() - 100);
+    tm.commit();
+    REQUIRE_NOTHROW( TMSMappedArray<unsigned>(path, true) );
+
+    for (unsigned & v : tm)
+        v *= 3;
+    tm.resize(tm.size() + 50);
+    tm.commit();
+    REQUIRE( tm.committed_size() == 2959 );
+    TMSArray<unsigned> ta;
+    tms_load(path, ta);
+    REQUIRE( ta.size() == 2959 );
+    REQUIRE( ta[6] == 18 );
+    REQUIRE( ta[5] == 21 );
+    remove(path.c_str());
+}
+
+
+TEST_CASE( "flush recomputes the CRC after writes through old references" )
+{
+    const string path = tempPath("staleref");
+    TMSMappedArray<int> tm(path);
+    for (int i = 0; i < 100; ++i)
+        tm.push_back(i);
+    int & first = tm[0];
+    TMSMappedArray<int>::iterator it = tm.begin();
+    tm.commit();
+    first = -1;                 // not seen by commit()'s CRC tracking
+    it[1] = -2;
+    tm.commit();
+    REQUIRE_THROWS_AS( TMSMappedArray<int>(path, true), runtime_error );
+    tm.flush();
+    REQUIRE_NOTHROW( TMSMappedArray<int>(path, true) );
+    TMSArray<int> ta;
+    tms_load(path, ta);
+    REQUIRE( ta[0] == -1 );
+    REQUIRE( ta[1] == -2 );
+    remove(path.c_str());
+}
+
+
+TEST_CASE( "Growth and reserve" )
+{
+    const string path = tempPath("grow");
+    TMSMappedArray<char> tm(path);
+    const size_t cap0 = tm.capacity();
+    tm.resize(cap0 + 1);
+    REQUIRE( tm.capacity() == 2 * cap0 );
+    REQUIRE( tm[cap0] == 0 );
+    tm.reserve(1 << 20);
+    REQUIRE( tm.capacity() == size_t(1) << 20 );
+    REQUIRE( fileSize(path) == 64 + (size_t(1) << 20) );
+    tm.reserve(10);
+    REQUIRE( tm.capacity() == size_t(1) << 20 );
+    REQUIRE( tm.size() == cap0 + 1 );
+    remove(path.c_str());
+}
+
+
+TEST_CASE( "Rejects a file of another type" )
+{
+    const string path = tempPath("type");
+    TMSArray<float> ta(10);
+    tms_save(ta, path);
+    REQUIRE_THROWS_AS( TMSMappedArray<int>(path, false), runtime_error );
+    remove(path.c_str());
+}
+
+
+TEST_CASE( "Move" )
+{
+    const string path = tempPath("move");
+    TMSMappedArray<int> tm(path);
+    tm.push_back(42);
+    TMSMappedArray<int> tn(move(tm));
+    REQUIRE( tn.size() == 1 );
+    REQUIRE( tn[0] == 42 );
+    REQUIRE( tm.size() == 0 );
+    tm = move(tn);
+    REQUIRE( tm[0] == 42 );
+    tm.flush();
+    REQUIRE( TMSMappedArray<int>(path, false).size() == 1 );
+    remove(path.c_str());
+}
+
+
+// *********************************************************************
+// Main Program
+// *********************************************************************
+
+
+// userPause
+// Wait for user to press ENTER: read all chars through first newline.
+void userPause()
+{
+    std::cout.flush();
+    while (std::cin.get() != '\n') ;
+}
+
+
+// Main program
+// Run all tests. Prompt for ENTER before exiting.
+int main(int argc,
+         char *argv[])
+{
+    doctest::Context dtcontext;
+                             // Primary doctest object
+    int dtresult;            // doctest return code; for return by main
+
+    // Handle command line
+    dtcontext.applyCommandLine(argc, argv);
+    dtresult = 0;            // doctest flags no command-line errors
+                             //  (strange but true)
+
+    if (!dtresult)           // Continue only if no command-line error
+    {
+        // Run test suites
+        cout << "BEGIN tests for " << test_suite_name << "\n" << endl;
+        dtresult = dtcontext.run();
+        cout << "END tests for " << test_suite_name << "\n" << endl;
+    }
+
+    // Wait for user
+    std::cout << "Press ENTER to quit ";
+    userPause();
+
+    // Program return value is return code from doctest
+    return dtresult;
+}
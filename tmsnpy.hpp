@@ -0,0 +1,1158 @@
+// tmsnpy.hpp
+// Matthew Johnson
+// 10/17/2026
+// NumPy .npy read/write for arithmetic TMSArrays, zero-copy mmap view,
+//  and uncompressed .npz archives of several arrays (POSIX)
+
+#pragma once
+// for single inclusion
+
+#include "tmsarray.hpp"
+// For class template TMSArray
+
+#include "tmsserial.hpp"
+// For class template TMSArrayView
+// For TMSFd
+// For tms_throw_errno
+// For tms_pread_all
+// For tms_pwritev_all
+// For tms_bswap
+
+#include "tmscrc32.hpp"
+// For tms_crc32
+
+#include <cstddef>
+// For std::size_t
+
+#include <cstdint>
+// For std::uint16_t
+// For std::uint32_t
+// For std::uint64_t
+
+#include <cstring>
+// For std::memcpy
+// For std::memcmp
+
+#include <string>
+// For std::string
+// For std::to_string
+
+#include <stdexcept>
+// For std::runtime_error
+// For std::invalid_argument
+
+#include <type_traits>
+// For std::is_arithmetic
+// For std::is_same
+// For std::is_floating_point
+// For std::is_signed
+
+#include <utility>
+// For std::swap
+
+#include <fcntl.h>
+// For open
+
+#include <unistd.h>
+// For close
+
+#include <sys/mman.h>
+// For mmap
+// For munmap
+
+#include <sys/stat.h>
+// For fstat
+
+#include <sys/uio.h>
+// For struct iovec
+
+
+
+// *********************************************************************
+// .npy format
+// *********************************************************************
+
+
+// Layout: "\x93NUMPY", major and minor version bytes, the header length
+//  (2 bytes little-endian in version 1.0, 4 in 2.0 and 3.0), then the
+//  header: a Python dict literal with keys 'descr', 'fortran_order' and
+//  'shape', space-padded and ending in '\n' so that the data starts at
+//  a multiple of TMS_NPY_ALIGN. The data follows in C order.
+
+constexpr char        TMS_NPY_MAGIC[6] = { '\x93', 'N', 'U', 'M', 'P', 'Y' };
+constexpr std::size_t TMS_NPY_ALIGN    = 64;
+
+
+// TMSNpyHeader
+// A parsed .npy header; dataOffset is from the start of the .npy stream
+struct TMSNpyHeader
+{
+    std::string           descr;
+    bool                  fortran;
+    TMSArray<std::size_t> shape;
+    std::uint64_t         count;
+    std::uint64_t         dataOffset;
+};
+
+
+// tms_le16, tms_le32, tms_le64
+// Little-endian fields, on any host
+inline std::uint16_t tms_le16(const unsigned char * p) noexcept
+{
+    return std::uint16_t(p[0] | (p[1] << 8));
+}
+
+inline std::uint32_t tms_le32(const unsigned char * p) noexcept
+{
+    return std::uint32_t(p[0]) | (std::uint32_t(p[1]) << 8)
+         | (std::uint32_t(p[2]) << 16) | (std::uint32_t(p[3]) << 24);
+}
+
+inline std::uint64_t tms_le64(const unsigned char * p) noexcept
+{
+    return std::uint64_t(tms_le32(p)) | (std::uint64_t(tms_le32(p + 4)) << 32);
+}
+
+
+// tms_put_le
+// Appends the low bytes bytes of v to out, little-endian
+inline void tms_put_le(std::string & out, std::uint64_t v, int bytes)
+{
+    for (int k = 0; k < bytes; ++k)
+        out += char((v >> (8 * k)) & 0xFF);
+}
+
+
+// tms_npy_native
+// Byte-order character of this host
+constexpr char tms_npy_native() noexcept
+{
+    return __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ ? '<' : '>';
+}
+
+
+// tms_npy_descr
+// NumPy dtype string of T in native byte order, e.g. "<f8", "|u1"
+template <typename T>
+std::string tms_npy_descr()
+{
+    static_assert(std::is_arithmetic<T>::value && !std::is_same<T, bool>::value,
+                  ".npy support is for arithmetic types other than bool");
+    const char kind = std::is_floating_point<T>::value ? 'f'
+                    : std::is_signed<T>::value ? 'i' : 'u';
+    return std::string(1, sizeof(T) == 1 ? '|' : tms_npy_native())
+           + kind + std::to_string(sizeof(T));
+}
+
+
+// tms_npy_header
+// The complete header (magic through '\n') for an array of dtype descr
+//  and the given shape, padded so that data starts at TMS_NPY_ALIGN.
+//  Version 1.0 unless the header needs more than 65535 bytes.
+inline std::string tms_npy_header(const std::string & descr,
+                                  const std::size_t * shape, std::size_t ndim)
+{
+    std::string dict = "{'descr': '" + descr
+                       + "', 'fortran_order': False, 'shape': (";
+    for (std::size_t i = 0; i < ndim; ++i)
+    {
+        if (i > 0)
+            dict += ", ";
+        dict += std::to_string(shape[i]);
+    }
+    if (ndim == 1)
+        dict += ",";
+    dict += "), }";
+
+    std::size_t prefix = 10;
+    std::size_t total = prefix + dict.size() + 1;
+    total = (total + TMS_NPY_ALIGN - 1) / TMS_NPY_ALIGN * TMS_NPY_ALIGN;
+    if (total - prefix > 0xFFFF)
+    {
+        prefix = 12;
+        total = (prefix + dict.size() + 1 + TMS_NPY_ALIGN - 1)
+                / TMS_NPY_ALIGN * TMS_NPY_ALIGN;
+    }
+
+    std::string out(TMS_NPY_MAGIC, sizeof TMS_NPY_MAGIC);
+    out += char(prefix == 10 ? 1 : 2);
+    out += char(0);
+    tms_put_le(out, total - prefix, prefix == 10 ? 2 : 4);
+    out += dict;
+    out.append(total - out.size() - 1, ' ');
+    out += '\n';
+    return out;
+}
+
+
+// tms_npy_prefix
+// Given at least 12 bytes of a .npy stream, the size of its whole
+//  header (where the data starts). Throws std::runtime_error if the
+//  bytes are not a .npy header.
+inline std::uint64_t tms_npy_prefix(const unsigned char * p, std::size_t n,
+                                    const std::string & path)
+{
+    if (n < 10 || std::memcmp(p, TMS_NPY_MAGIC, sizeof TMS_NPY_MAGIC) != 0)
+        throw std::runtime_error(path + ": not a .npy file");
+    const unsigned major = p[6];
+    if (major == 1)
+        return 10 + std::uint64_t(tms_le16(p + 8));
+    if ((major == 2 || major == 3) && n >= 12)
+        return 12 + std::uint64_t(tms_le32(p + 8));
+    throw std::runtime_error(path + ": unsupported .npy version "
+                             + std::to_string(major));
+}
+
+
+// tms_npy_parse
+// Basic Guarantee
+// Exception-Neutral
+// Pre:
+//      [p, p + n) holds at least the whole header
+// Post:
+//      The parsed header. Only the literal forms NumPy writes are
+//      accepted: quoted strings, True/False and a tuple of integers.
+//      Throws std::runtime_error naming what is wrong.
+inline TMSNpyHeader tms_npy_parse(const unsigned char * p, std::size_t n,
+                                  const std::string & path)
+{
+    const std::uint64_t total = tms_npy_prefix(p, n, path);
+    if (total > n)
+        throw std::runtime_error(path + ": truncated .npy header");
+    const std::size_t start = p[6] == 1 ? 10 : 12;
+    const std::string text(reinterpret_cast<const char *>(p) + start,
+                           std::size_t(total) - start);
+    std::size_t i = 0;
+    auto fail = [&](const std::string & what)
+    {
+        throw std::runtime_error(path + ": bad .npy header (" + what + ")");
+    };
+    auto skip = [&]
+    {
+        while (i < text.size() && (text[i] == ' ' || text[i] == '\t'
+                                   || text[i] == '\n' || text[i] == '\r'))
+            ++i;
+    };
+    auto expect = [&](char c)
+    {
+        skip();
+        if (i >= text.size() || text[i] != c)
+            fail(std::string("expected '") + c + "'");
+        ++i;
+    };
+    auto quoted = [&]
+    {
+        skip();
+        if (i >= text.size() || (text[i] != '\'' && text[i] != '"'))
+            fail("expected a string");
+        const char q = text[i++];
+        const std::size_t end = text.find(q, i);
+        if (end == std::string::npos)
+            fail("unterminated string");
+        std::string s = text.substr(i, end - i);
+        i = end + 1;
+        return s;
+    };
+
+    TMSNpyHeader h;
+    h.fortran = false;
+    h.count = 1;
+    h.dataOffset = total;
+    bool haveDescr = false, haveOrder = false, haveShape = false;
+    expect('{');
+    for (;;)
+    {
+        skip();
+        if (i < text.size() && text[i] == '}')
+            break;
+        const std::string key = quoted();
+        expect(':');
+        skip();
+        if (key == "descr")
+        {
+            if (i < text.size() && text[i] == '[')
+                fail("structured dtypes are not supported");
+            h.descr = quoted();
+            haveDescr = true;
+        }
+        else if (key == "fortran_order")
+        {
+            if (text.compare(i, 4, "True") == 0)
+                h.fortran = true, i += 4;
+            else if (text.compare(i, 5, "False") == 0)
+                i += 5;
+            else
+                fail("fortran_order");
+            haveOrder = true;
+        }
+        else if (key == "shape")
+        {
+            expect('(');
+            for (;;)
+            {
+                skip();
+                if (i < text.size() && text[i] == ')')
+                    break;
+                if (i >= text.size() || text[i] < '0' || text[i] > '9')
+                    fail("shape");
+                std::uint64_t d = 0;
+                for (; i < text.size() && text[i] >= '0' && text[i] <= '9'; ++i)
+                {
+                    if (d > (~std::uint64_t(0) - 9) / 10)
+                        fail("shape overflows");
+                    d = d * 10 + std::uint64_t(text[i] - '0');
+                }
+                if (i < text.size() && text[i] == 'L')
+                    ++i;                        // Python 2 long
+                if (d != 0 && h.count > ~std::uint64_t(0) / d)
+                    fail("shape overflows");
+                h.count *= d;
+                h.shape.push_back(std::size_t(d));
+                skip();
+                if (i < text.size() && text[i] == ',')
+                    ++i;
+            }
+            ++i;
+            haveShape = true;
+        }
+        else
+            fail("unexpected key '" + key + "'");
+        skip();
+        if (i < text.size() && text[i] == ',')
+            ++i;
+    }
+    if (!haveDescr || !haveOrder || !haveShape)
+        fail("missing key");
+    return h;
+}
+
+
+// tms_npy_check
+// Validates h for element type T; returns true if the data is in the
+//  opposite byte order. Throws std::runtime_error if the dtype does not
+//  match T exactly, or for a Fortran-order array of more than one
+//  dimension.
+template <typename T>
+bool tms_npy_check(const TMSNpyHeader & h, const std::string & path)
+{
+    const std::string want = tms_npy_descr<T>();
+    const std::string & d = h.descr;
+    if (d.size() < 3 || d.compare(1, std::string::npos, want, 1,
+                                  std::string::npos) != 0)
+        throw std::runtime_error(path + ": dtype '" + d
+                                 + "' does not match '" + want + "'");
+    const char order = d[0];
+    bool swapped = false;
+    if (order == '<' || order == '>')
+        swapped = order != tms_npy_native() && sizeof(T) > 1;
+    else if (order != '|' && order != '=')
+        throw std::runtime_error(path + ": bad byte order in dtype '" + d + "'");
+    if (h.fortran && h.shape.size() > 1)
+        throw std::runtime_error(path + ": Fortran-order arrays are not "
+                                 "supported");
+    return swapped;
+}
+
+
+// tms_npy_shape
+// Checks that shape describes n elements; its product when given,
+//  otherwise the one-dimensional (n,)
+inline void tms_npy_shape(const TMSArray<std::size_t> * shape, std::size_t n,
+                          TMSArray<std::size_t> & out)
+{
+    if (shape == nullptr)
+    {
+        out.resize(1);
+        out[0] = n;
+        return;
+    }
+    std::size_t product = 1;
+    for (std::size_t d : *shape)
+        product *= d;
+    if (product != n)
+        throw std::invalid_argument("tms_npy: shape does not match size");
+    out = *shape;
+}
+
+
+
+// *********************************************************************
+// .npy files
+// *********************************************************************
+
+
+// tms_npy_save
+// Basic Guarantee (the file may be partly written if a write fails)
+// Exception-Neutral
+// Pre:
+//      T arithmetic, not bool
+// Post:
+//      path holds arr as a .npy file in native byte order, written by
+//      one pwritev, with shape (size,) or *shape. Throws
+//      std::invalid_argument if *shape does not multiply to size,
+//      std::system_error if the file cannot be created or written.
+template <typename T>
+void tms_npy_save(const TMSArray<T> & arr, const std::string & path,
+                  const TMSArray<std::size_t> * shape = nullptr)
+{
+    TMSArray<std::size_t> dims;
+    tms_npy_shape(shape, arr.size(), dims);
+    std::string head = tms_npy_header(tms_npy_descr<T>(), dims.begin(),
+                                      dims.size());
+    TMSFd file(::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                      0644));
+    if (file.fd < 0)
+        tms_throw_errno(path + ": open");
+    struct iovec iov[2];
+    iov[0].iov_base = &head[0];
+    iov[0].iov_len = head.size();
+    iov[1].iov_base = const_cast<T *>(arr.begin());
+    iov[1].iov_len = arr.size() * sizeof(T);
+    tms_pwritev_all(file.fd, iov, 2, 0, path);
+}
+
+
+// tms_npy_read_header
+// Reads and parses the header of the .npy file open as fd
+inline TMSNpyHeader tms_npy_read_header(int fd, std::uint64_t fileSize,
+                                        const std::string & path)
+{
+    unsigned char prefix[12];
+    if (fileSize < 12)
+        throw std::runtime_error(path + ": not a .npy file");
+    tms_pread_all(fd, prefix, sizeof prefix, 0, path);
+    const std::uint64_t total = tms_npy_prefix(prefix, sizeof prefix, path);
+    if (total > fileSize)
+        throw std::runtime_error(path + ": truncated .npy header");
+    TMSArray<unsigned char> head(static_cast<std::size_t>(total));
+    tms_pread_all(fd, head.begin(), head.size(), 0, path);
+    return tms_npy_parse(head.begin(), head.size(), path);
+}
+
+
+// tms_npy_load
+// Strong Guarantee
+// Exception-Neutral
+// Pre:
+//      T arithmetic, not bool
+// Post:
+//      out holds the elements of the .npy file at path in C order, read
+//      with one pread and converted if the file has the other byte
+//      order; *shape, when given, its shape. Throws std::system_error
+//      on I/O errors, std::runtime_error if the file is not .npy, its
+//      dtype is not exactly T's, or it is truncated.
+template <typename T>
+void tms_npy_load(const std::string & path, TMSArray<T> & out,
+                  TMSArray<std::size_t> * shape = nullptr)
+{
+    TMSFd file(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+    if (file.fd < 0)
+        tms_throw_errno(path + ": open");
+    struct stat st;
+    if (::fstat(file.fd, &st) != 0)
+        tms_throw_errno(path + ": stat");
+    const std::uint64_t fileSize = std::uint64_t(st.st_size);
+    TMSNpyHeader h = tms_npy_read_header(file.fd, fileSize, path);
+    const bool swapped = tms_npy_check<T>(h, path);
+    if (h.count > (fileSize - h.dataOffset) / sizeof(T))
+        throw std::runtime_error(path + ": truncated");
+
+    TMSArray<T> values(static_cast<std::size_t>(h.count));
+    tms_pread_all(file.fd, values.begin(), values.size() * sizeof(T),
+                  h.dataOffset, path);
+    if (swapped)
+        tms_bswap(values.begin(), sizeof(T), values.size());
+    if (shape != nullptr)
+        shape->swap(h.shape);
+    out.swap(values);
+}
+
+
+// tms_npy_view
+// Strong Guarantee
+// Exception-Neutral
+// Pre:
+//      T arithmetic, not bool
+// Post:
+//      Read-only mmap view of the data of the .npy file at path: no copy
+//      and no read beyond the header. *shape, when given, its shape.
+//      Throws as tms_npy_load, and std::runtime_error if the data is in
+//      the other byte order (use tms_npy_load to convert).
+template <typename T>
+TMSArrayView<T> tms_npy_view(const std::string & path,
+                             TMSArray<std::size_t> * shape = nullptr)
+{
+    TMSNpyHeader h;
+    {
+        TMSFd file(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+        if (file.fd < 0)
+            tms_throw_errno(path + ": open");
+        struct stat st;
+        if (::fstat(file.fd, &st) != 0)
+            tms_throw_errno(path + ": stat");
+        h = tms_npy_read_header(file.fd, std::uint64_t(st.st_size), path);
+    }
+    if (tms_npy_check<T>(h, path))
+        throw std::runtime_error(path + ": opposite byte order; "
+                                 "use tms_npy_load to convert");
+    TMSArrayView<T> view = TMSArrayView<T>::map_range(path, h.dataOffset,
+        static_cast<std::size_t>(h.count));
+    if (shape != nullptr)
+        shape->swap(h.shape);
+    return view;
+}
+
+
+
+// *********************************************************************
+// .npz archives
+// *********************************************************************
+
+
+// An .npz file is a zip archive with one member "name.npy" per array.
+//  np.savez stores members uncompressed (method 0); np.savez_compressed
+//  deflates them, which is not supported here. Zip64 records are read
+//  and written when sizes or offsets need them.
+
+constexpr std::uint32_t TMS_ZIP_LOCAL   = 0x04034b50;
+constexpr std::uint32_t TMS_ZIP_CENTRAL = 0x02014b50;
+constexpr std::uint32_t TMS_ZIP_END     = 0x06054b50;
+constexpr std::uint32_t TMS_ZIP64_END   = 0x06064b50;
+constexpr std::uint32_t TMS_ZIP64_LOC   = 0x07064b50;
+constexpr std::uint16_t TMS_ZIP_DATE    = 0x0021;        // 1980-01-01
+
+
+
+// *********************************************************************
+// class TMSNpzWriter - Class definition
+// *********************************************************************
+
+
+// class TMSNpzWriter
+// Writes an uncompressed .npz archive, one array at a time, straight to
+//  the file; close() adds the central directory. Each member's local
+//  header is padded with an extra field so that its array data starts
+//  at a multiple of TMS_NPY_ALIGN in the file, which lets
+//  TMSNpzReader::view map it.
+// Invariants:
+//     _fd open until close(); _offset is the end of what is written;
+//      _entries lists the members in order.
+class TMSNpzWriter
+{
+
+public:
+
+    using size_type = std::size_t;
+
+
+// ***** TMSNpzWriter: ctors, dctor *****
+public:
+
+
+    // Ctor from path
+    // Strong Guarantee
+    // Pre: None
+    // Post:
+    //      path created (or truncated), empty. Throws std::system_error
+    //      if it cannot be.
+    explicit TMSNpzWriter(const std::string & path)
+        :_path(path),
+         _fd(::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                    0644)),
+         _offset(0)
+    {
+        if (_fd < 0)
+            tms_throw_errno(path + ": open");
+    }
+
+
+    // No copying: owns the file
+    TMSNpzWriter(const TMSNpzWriter &) = delete;
+    TMSNpzWriter & operator=(const TMSNpzWriter &) = delete;
+
+
+    // Dctor
+    // No-Throw Guarantee
+    // Pre: None
+    // Post:
+    //      Closed as by close(); errors ignored (the archive may then be
+    //      unreadable)
+    ~TMSNpzWriter()
+    {
+        try
+        {
+            close();
+        }
+        catch (...)
+        {}
+        if (_fd >= 0)
+            ::close(_fd);
+    }
+
+
+// ***** TMSNpzWriter: general public functions *****
+public:
+
+
+    // add
+    // Basic Guarantee (a failed write leaves the archive unusable)
+    // Exception-Neutral
+    // Pre:
+    //      T arithmetic, not bool; not closed
+    // Post:
+    //      arr appended as member name + ".npy", shape (size,) or
+    //      *shape, with its CRC-32. Throws std::invalid_argument for a
+    //      repeated name or a shape that does not match,
+    //      std::runtime_error after close(), std::system_error on I/O
+    //      errors.
+    template <typename T>
+    void add(const std::string & name, const TMSArray<T> & arr,
+             const TMSArray<std::size_t> * shape = nullptr)
+    {
+        if (_fd < 0)
+            throw std::runtime_error(_path + ": archive already closed");
+        const std::string member = name + ".npy";
+        for (const Entry & e : _entries)
+            if (e.name == member)
+                throw std::invalid_argument(_path + ": duplicate member "
+                                            + member);
+        TMSArray<std::size_t> dims;
+        tms_npy_shape(shape, arr.size(), dims);
+        const std::string head = tms_npy_header(tms_npy_descr<T>(),
+                                                dims.begin(), dims.size());
+        addMember(member, head, arr.begin(), arr.size() * sizeof(T));
+    }
+
+
+    // size
+    // No-Throw Guarantee
+    // Members added
+    size_type size() const noexcept
+    {
+        return _entries.size();
+    }
+
+
+    // close
+    // Basic Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Central directory and end records written, file closed; does
+    //      nothing if already closed. Throws std::system_error on I/O
+    //      errors.
+    void close()
+    {
+        if (_fd < 0)
+            return;
+        const std::uint64_t cdStart = _offset;
+        std::string cd;
+        for (const Entry & e : _entries)
+        {
+            const bool bigSize = e.size >= 0xFFFFFFFFu;
+            const bool bigOff = e.offset >= 0xFFFFFFFFu;
+            std::string extra;
+            if (bigSize || bigOff)
+            {
+                tms_put_le(extra, 0x0001, 2);
+                tms_put_le(extra, (bigSize ? 16 : 0) + (bigOff ? 8 : 0), 2);
+                if (bigSize)
+                {
+                    tms_put_le(extra, e.size, 8);
+                    tms_put_le(extra, e.size, 8);
+                }
+                if (bigOff)
+                    tms_put_le(extra, e.offset, 8);
+            }
+            const unsigned version = extra.empty() ? 20 : 45;
+            tms_put_le(cd, TMS_ZIP_CENTRAL, 4);
+            tms_put_le(cd, version, 2);             // made by
+            tms_put_le(cd, version, 2);             // needed
+            tms_put_le(cd, 0, 2);                   // flags
+            tms_put_le(cd, 0, 2);                   // stored
+            tms_put_le(cd, 0, 2);                   // time
+            tms_put_le(cd, TMS_ZIP_DATE, 2);
+            tms_put_le(cd, e.crc, 4);
+            tms_put_le(cd, bigSize ? 0xFFFFFFFFu : e.size, 4);
+            tms_put_le(cd, bigSize ? 0xFFFFFFFFu : e.size, 4);
+            tms_put_le(cd, e.name.size(), 2);
+            tms_put_le(cd, extra.size(), 2);
+            tms_put_le(cd, 0, 2);                   // comment
+            tms_put_le(cd, 0, 2);                   // disk
+            tms_put_le(cd, 0, 2);                   // internal attributes
+            tms_put_le(cd, 0, 4);                   // external attributes
+            tms_put_le(cd, bigOff ? 0xFFFFFFFFu : e.offset, 4);
+            cd += e.name;
+            cd += extra;
+        }
+        const std::uint64_t cdSize = cd.size();
+        const std::uint64_t count = _entries.size();
+        if (count >= 0xFFFF || cdStart >= 0xFFFFFFFFu || cdSize >= 0xFFFFFFFFu)
+        {
+            const std::uint64_t end64 = cdStart + cdSize;
+            tms_put_le(cd, TMS_ZIP64_END, 4);
+            tms_put_le(cd, 44, 8);
+            tms_put_le(cd, 45, 2);
+            tms_put_le(cd, 45, 2);
+            tms_put_le(cd, 0, 4);
+            tms_put_le(cd, 0, 4);
+            tms_put_le(cd, count, 8);
+            tms_put_le(cd, count, 8);
+            tms_put_le(cd, cdSize, 8);
+            tms_put_le(cd, cdStart, 8);
+            tms_put_le(cd, TMS_ZIP64_LOC, 4);
+            tms_put_le(cd, 0, 4);
+            tms_put_le(cd, end64, 8);
+            tms_put_le(cd, 1, 4);
+        }
+        tms_put_le(cd, TMS_ZIP_END, 4);
+        tms_put_le(cd, 0, 2);
+        tms_put_le(cd, 0, 2);
+        tms_put_le(cd, count >= 0xFFFF ? 0xFFFF : count, 2);
+        tms_put_le(cd, count >= 0xFFFF ? 0xFFFF : count, 2);
+        tms_put_le(cd, cdSize >= 0xFFFFFFFFu ? 0xFFFFFFFFu : cdSize, 4);
+        tms_put_le(cd, cdStart >= 0xFFFFFFFFu ? 0xFFFFFFFFu : cdStart, 4);
+        tms_put_le(cd, 0, 2);
+
+        struct iovec iov;
+        iov.iov_base = &cd[0];
+        iov.iov_len = cd.size();
+        tms_pwritev_all(_fd, &iov, 1, _offset, _path);
+        _offset += cd.size();
+        const int fd = _fd;
+        _fd = -1;
+        if (::close(fd) != 0)
+            tms_throw_errno(_path + ": close");
+    }
+
+
+// ***** TMSNpzWriter: private types *****
+private:
+
+
+    struct Entry
+    {
+        std::string   name;
+        std::uint32_t crc;
+        std::uint64_t size;
+        std::uint64_t offset;       // of the local header
+    };
+
+
+// ***** TMSNpzWriter: private helper functions *****
+private:
+
+
+    // addMember
+    // Local header (with zip64 sizes if needed and alignment padding),
+    //  .npy header and data, in one pwritev
+    void addMember(const std::string & member, const std::string & head,
+                   const void * data, std::size_t bytes)
+    {
+        const std::uint64_t size = head.size() + bytes;
+        const std::uint32_t crc = tms_crc32(data, bytes,
+                                            tms_crc32(head.data(), head.size()));
+        const bool big = size >= 0xFFFFFFFFu;
+
+        std::string extra;
+        if (big)
+        {
+            tms_put_le(extra, 0x0001, 2);
+            tms_put_le(extra, 16, 2);
+            tms_put_le(extra, size, 8);
+            tms_put_le(extra, size, 8);
+        }
+        // Padding field: the array data must land on TMS_NPY_ALIGN
+        const std::uint64_t base = _offset + 30 + member.size() + extra.size()
+                                   + head.size();
+        std::size_t pad = std::size_t((TMS_NPY_ALIGN - base % TMS_NPY_ALIGN)
+                                      % TMS_NPY_ALIGN);
+        if (pad > 0 && pad < 4)
+            pad += TMS_NPY_ALIGN;
+        if (pad > 0)
+        {
+            tms_put_le(extra, 0xD935, 2);       // as written by zipalign
+            tms_put_le(extra, pad - 4, 2);
+            extra.append(pad - 4, '\0');
+        }
+
+        std::string local;
+        tms_put_le(local, TMS_ZIP_LOCAL, 4);
+        tms_put_le(local, big ? 45 : 20, 2);
+        tms_put_le(local, 0, 2);
+        tms_put_le(local, 0, 2);
+        tms_put_le(local, 0, 2);
+        tms_put_le(local, TMS_ZIP_DATE, 2);
+        tms_put_le(local, crc, 4);
+        tms_put_le(local, big ? 0xFFFFFFFFu : size, 4);
+        tms_put_le(local, big ? 0xFFFFFFFFu : size, 4);
+        tms_put_le(local, member.size(), 2);
+        tms_put_le(local, extra.size(), 2);
+        local += member;
+        local += extra;
+
+        _entries.push_back(Entry{ member, crc, size, _offset });
+        struct iovec iov[3];
+        iov[0].iov_base = &local[0];
+        iov[0].iov_len = local.size();
+        iov[1].iov_base = const_cast<char *>(head.data());
+        iov[1].iov_len = head.size();
+        iov[2].iov_base = const_cast<void *>(data);
+        iov[2].iov_len = bytes;
+        tms_pwritev_all(_fd, iov, 3, _offset, _path);
+        _offset += local.size() + size;
+    }
+
+
+// ***** TMSNpzWriter: data members *****
+private:
+
+    std::string      _path;
+    int              _fd;           // -1 once closed
+    std::uint64_t    _offset;
+    TMSArray<Entry>  _entries;
+
+}; // end of class
+
+
+
+// *********************************************************************
+// class TMSNpzReader - Class definition
+// *********************************************************************
+
+
+// class TMSNpzReader
+// Reads .npz archives: the central directory is parsed on opening, from
+//  a read-only mapping of the file; arrays are copied out with load or
+//  mapped without copying with view.
+// Invariants:
+//     _map, _mapLen map the file (nullptr, 0 when moved from); _members
+//      lists its members in directory order.
+class TMSNpzReader
+{
+
+public:
+
+    using size_type = std::size_t;
+
+
+// ***** TMSNpzReader: ctors, op=, dctor *****
+public:
+
+
+    // Ctor from path
+    // Strong Guarantee
+    // Pre: None
+    // Post:
+    //      Archive at path opened and its directory read. Throws
+    //      std::system_error on I/O errors, std::runtime_error if the
+    //      file is not a zip archive.
+    explicit TMSNpzReader(const std::string & path)
+        :_path(path),
+         _map(nullptr),
+         _mapLen(0)
+    {
+        TMSFd file(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+        if (file.fd < 0)
+            tms_throw_errno(path + ": open");
+        struct stat st;
+        if (::fstat(file.fd, &st) != 0)
+            tms_throw_errno(path + ": stat");
+        if (st.st_size < 22)
+            throw std::runtime_error(path + ": not a zip archive");
+        void * map = ::mmap(nullptr, std::size_t(st.st_size), PROT_READ,
+                            MAP_PRIVATE, file.fd, 0);
+        if (map == MAP_FAILED)
+            tms_throw_errno(path + ": mmap");
+        _map = map;
+        _mapLen = std::size_t(st.st_size);
+        try
+        {
+            readDirectory();
+        }
+        catch (...)
+        {
+            ::munmap(_map, _mapLen);
+            throw;
+        }
+    }
+
+
+    // No copying: owns its mapping
+    TMSNpzReader(const TMSNpzReader &) = delete;
+    TMSNpzReader & operator=(const TMSNpzReader &) = delete;
+
+
+    // Move ctor
+    // No-Throw Guarantee
+    TMSNpzReader(TMSNpzReader && other) noexcept
+        :_path(std::move(other._path)),
+         _map(other._map),
+         _mapLen(other._mapLen),
+         _members(0)
+    {
+        _members.swap(other._members);
+        other._map = nullptr;
+        other._mapLen = 0;
+    }
+
+
+    // Dctor
+    // No-Throw Guarantee
+    ~TMSNpzReader()
+    {
+        if (_map != nullptr)
+            ::munmap(_map, _mapLen);
+    }
+
+
+// ***** TMSNpzReader: general public functions *****
+public:
+
+
+    // size
+    // No-Throw Guarantee
+    // Number of members
+    size_type size() const noexcept
+    {
+        return _members.size();
+    }
+
+
+    // name
+    // No-Throw Guarantee
+    // Pre:
+    //      i < size()
+    // Post:
+    //      Member i's array name (".npy" removed)
+    const std::string & name(size_type i) const noexcept
+    {
+        return _members[i].name;
+    }
+
+
+    // contains
+    // No-Throw Guarantee
+    bool contains(const std::string & name) const noexcept
+    {
+        for (const Member & m : _members)
+            if (m.name == name)
+                return true;
+        return false;
+    }
+
+
+    // load
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      T arithmetic, not bool
+    // Post:
+    //      out holds array name, converted if in the other byte order;
+    //      *shape, when given, its shape. With verify the member's
+    //      CRC-32 is checked. Throws std::runtime_error if there is no
+    //      such array, it is compressed, corrupt or of another dtype.
+    template <typename T>
+    void load(const std::string & name, TMSArray<T> & out,
+              TMSArray<std::size_t> * shape = nullptr, bool verify = true) const
+    {
+        const Member & m = find(name);
+        const unsigned char * p = base() + m.offset;
+        if (verify && tms_crc32(p, std::size_t(m.size)) != m.crc)
+            throw std::runtime_error(where(m) + ": CRC mismatch");
+        TMSNpyHeader h = tms_npy_parse(p, std::size_t(m.size), where(m));
+        const bool swapped = tms_npy_check<T>(h, where(m));
+        if (h.count > (m.size - h.dataOffset) / sizeof(T))
+            throw std::runtime_error(where(m) + ": truncated");
+
+        TMSArray<T> values(static_cast<std::size_t>(h.count));
+        std::memcpy(values.begin(), p + h.dataOffset, values.size() * sizeof(T));
+        if (swapped)
+            tms_bswap(values.begin(), sizeof(T), values.size());
+        if (shape != nullptr)
+            shape->swap(h.shape);
+        out.swap(values);
+    }
+
+
+    // view
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      T arithmetic, not bool
+    // Post:
+    //      Read-only mmap view of array name, independent of this
+    //      reader's lifetime; *shape, when given, its shape. Throws as
+    //      load, and std::runtime_error if the data is in the other
+    //      byte order or not aligned for T in the file (archives from
+    //      np.savez may not be; TMSNpzWriter's always are).
+    template <typename T>
+    TMSArrayView<T> view(const std::string & name,
+                         TMSArray<std::size_t> * shape = nullptr) const
+    {
+        const Member & m = find(name);
+        TMSNpyHeader h = tms_npy_parse(base() + m.offset, std::size_t(m.size),
+                                       where(m));
+        if (tms_npy_check<T>(h, where(m)))
+            throw std::runtime_error(where(m) + ": opposite byte order; "
+                                     "use load to convert");
+        if (h.count > (m.size - h.dataOffset) / sizeof(T))
+            throw std::runtime_error(where(m) + ": truncated");
+        TMSArrayView<T> v = TMSArrayView<T>::map_range(_path,
+            m.offset + h.dataOffset, static_cast<std::size_t>(h.count));
+        if (shape != nullptr)
+            shape->swap(h.shape);
+        return v;
+    }
+
+
+// ***** TMSNpzReader: private types *****
+private:
+
+
+    struct Member
+    {
+        std::string   name;         // without ".npy"
+        std::uint64_t offset;       // of the .npy stream in the file
+        std::uint64_t size;
+        std::uint32_t crc;
+        bool          stored;       // uncompressed
+    };
+
+
+// ***** TMSNpzReader: private helper functions *****
+private:
+
+
+    const unsigned char * base() const noexcept
+    {
+        return static_cast<const unsigned char *>(_map);
+    }
+
+
+    std::string where(const Member & m) const
+    {
+        return _path + "[" + m.name + "]";
+    }
+
+
+    void bad(const std::string & what) const
+    {
+        throw std::runtime_error(_path + ": bad zip archive (" + what + ")");
+    }
+
+
+    // find
+    // Member name, which must be uncompressed
+    const Member & find(const std::string & name) const
+    {
+        for (const Member & m : _members)
+            if (m.name == name)
+            {
+                if (!m.stored)
+                    throw std::runtime_error(where(m) + ": compressed "
+                        "members (np.savez_compressed) are not supported");
+                return m;
+            }
+        throw std::runtime_error(_path + ": no array named '" + name + "'");
+    }
+
+
+    // readDirectory
+    // Finds the end record (zip64 if present) and reads every central
+    //  directory entry and its local header
+    void readDirectory()
+    {
+        const unsigned char * p = base();
+        const std::uint64_t n = _mapLen;
+
+        // End of central directory: last signature within the maximum
+        //  comment length of the end
+        std::uint64_t eocd = n - 22;
+        const std::uint64_t stop = n > 22 + 0xFFFF ? n - 22 - 0xFFFF : 0;
+        while (tms_le32(p + eocd) != TMS_ZIP_END)
+        {
+            if (eocd == stop)
+                bad("no end of central directory");
+            --eocd;
+        }
+        std::uint64_t count = tms_le16(p + eocd + 10);
+        std::uint64_t cdSize = tms_le32(p + eocd + 12);
+        std::uint64_t cdStart = tms_le32(p + eocd + 16);
+        if (eocd >= 20 && tms_le32(p + eocd - 20) == TMS_ZIP64_LOC)
+        {
+            const std::uint64_t z = tms_le64(p + eocd - 20 + 8);
+            if (n < 56 || z > n - 56 || tms_le32(p + z) != TMS_ZIP64_END)
+                bad("zip64 end record");
+            count = tms_le64(p + z + 32);
+            cdSize = tms_le64(p + z + 40);
+            cdStart = tms_le64(p + z + 48);
+        }
+        if (cdStart > n || cdSize > n - cdStart)
+            bad("central directory out of range");
+
+        std::uint64_t at = cdStart;
+        for (std::uint64_t k = 0; k < count; ++k)
+        {
+            if (at + 46 > cdStart + cdSize || tms_le32(p + at) != TMS_ZIP_CENTRAL)
+                bad("central directory entry");
+            const unsigned method = tms_le16(p + at + 10);
+            const std::uint32_t crc = tms_le32(p + at + 16);
+            std::uint64_t csize = tms_le32(p + at + 20);
+            std::uint64_t usize = tms_le32(p + at + 24);
+            const std::size_t nameLen = tms_le16(p + at + 28);
+            const std::size_t extraLen = tms_le16(p + at + 30);
+            const std::size_t commentLen = tms_le16(p + at + 32);
+            std::uint64_t local = tms_le32(p + at + 42);
+            if (at + 46 + nameLen + extraLen + commentLen > cdStart + cdSize)
+                bad("central directory entry");
+            std::string member(reinterpret_cast<const char *>(p + at + 46),
+                               nameLen);
+
+            // Zip64 extra: only the fields saturated above, in order
+            for (std::size_t e = 0; e + 4 <= extraLen; )
+            {
+                const unsigned char * x = p + at + 46 + nameLen + e;
+                const std::size_t len = tms_le16(x + 2);
+                if (e + 4 + len > extraLen)
+                    bad("extra field of " + member);
+                if (tms_le16(x) == 0x0001)
+                {
+                    std::size_t f = 4;
+                    if (usize == 0xFFFFFFFFu && f + 8 <= len + 4)
+                        usize = tms_le64(x + f), f += 8;
+                    if (csize == 0xFFFFFFFFu && f + 8 <= len + 4)
+                        csize = tms_le64(x + f), f += 8;
+                    if (local == 0xFFFFFFFFu && f + 8 <= len + 4)
+                        local = tms_le64(x + f), f += 8;
+                }
+                e += 4 + len;
+            }
+
+            if (n < 30 || local > n - 30 || tms_le32(p + local) != TMS_ZIP_LOCAL)
+                bad("local header of " + member);
+            const std::uint64_t data = local + 30 + tms_le16(p + local + 26)
+                                       + tms_le16(p + local + 28);
+            if (data > n || csize > n - data)
+                bad("member " + member + " out of range");
+
+            if (member.size() > 4
+                && member.compare(member.size() - 4, 4, ".npy") == 0)
+                member.resize(member.size() - 4);
+            _members.push_back(Member{ member, data, usize, crc,
+                                       method == 0 && csize == usize });
+            at += 46 + nameLen + extraLen + commentLen;
+        }
+    }
+
+
+// ***** TMSNpzReader: data members *****
+private:
+
+    std::string       _path;
+    void *            _map;
+    size_type         _mapLen;
+    TMSArray<Member>  _members;
+
+}; // end of class
+
@@ -0,0 +1,141 @@
+// tmsnpy_bench.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Benchmark: .npy save/load/view and .npz write/read of a
+//  TMSArray<double>, against CSV text (one value per line, written with
+//  std::ofstream and parsed with std::ifstream >>) of the same values.
+//  Throughput is of the binary size of the array in each case.
+// Usage: tmsnpy_bench [values=8388608] [dir=/tmp]
+// Requires tmsnpy.hpp, tmsserial.hpp, tmscrc32.hpp, tmssimd.hpp,
+//  tmsarray.hpp, tmsbench.hpp
+
+#include "tmsnpy.hpp"
+#include "tmsbench.hpp"
+
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::int64_t;
+using std::uint64_t;
+#include <cstdio>
+using std::remove;
+#include <fstream>
+using std::ofstream;
+using std::ifstream;
+#include <iostream>
+using std::cout;
+#include <limits>
+using std::numeric_limits;
+#include <string>
+using std::string;
+
+
+int main(int argc, char * argv[])
+{
+    const size_t n = tms_arg(argc, argv, 1, size_t(1) << 23);
+    const string dir = argc > 2 ? argv[2] : "/tmp";
+    const string npyPath = dir + "/tmsnpy_bench.npy";
+    const string npzPath = dir + "/tmsnpy_bench.npz";
+    const string csvPath = dir + "/tmsnpy_bench.csv";
+    const size_t bytes = n * sizeof(double);
+
+    TMSArray<double> ta(n);
+    TMSArray<int64_t> tb(n);
+    uint64_t x = 88172645463325252ull;
+    for (size_t i = 0; i < n; ++i)
+    {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        ta[i] = double(x >> 11) * 0x1p-53;
+        tb[i] = int64_t(x);
+    }
+    cout << n << " doubles (" << bytes << " bytes), files in " << dir
+         << ", page cache warm after the first pass\n";
+
+    // The CSV baseline is slow: one pass each
+    double secs = tms_time_best(1, [&]
+    {
+        ofstream out(csvPath);
+        out.precision(numeric_limits<double>::max_digits10);
+        for (double v : ta)
+            out << v << '\n';
+    });
+    tms_report("save csv", secs, bytes);
+    TMSArray<double> back;
+    secs = tms_time_best(1, [&]
+    {
+        ifstream in(csvPath);
+        TMSArray<double> vals;
+        double v;
+        while (in >> v)
+            vals.push_back(v);
+        back.swap(vals);
+        tms_sink(back.size());
+    });
+    tms_report("load csv", secs, bytes);
+
+    secs = tms_time_best(3, [&]{ tms_npy_save(ta, npyPath); });
+    tms_report("save npy", secs, bytes);
+    secs = tms_time_best(3, [&]
+    {
+        tms_npy_load(npyPath, back);
+        tms_sink(back[n - 1]);
+    });
+    tms_report("load npy", secs, bytes);
+    secs = tms_time_best(5, [&]
+    {
+        TMSArrayView<double> view = tms_npy_view<double>(npyPath);
+        tms_sink(view.size());
+    });
+    tms_report("view npy open+close", secs);
+    secs = tms_time_best(3, [&]
+    {
+        TMSArrayView<double> view = tms_npy_view<double>(npyPath);
+        double sum = 0;
+        for (double v : view)
+            sum += v;
+        tms_sink(sum);
+    });
+    tms_report("view npy open+first scan", secs, bytes);
+
+    secs = tms_time_best(3, [&]
+    {
+        TMSNpzWriter w(npzPath);
+        w.add("values", ta);
+        w.add("keys", tb);
+        w.close();
+    });
+    tms_report("save npz (2 arrays)", secs, 2 * bytes);
+    {
+        TMSNpzReader r(npzPath);
+        TMSArray<int64_t> keys;
+        secs = tms_time_best(3, [&]
+        {
+            r.load("values", back);
+            r.load("keys", keys);
+            tms_sink(keys[n - 1]);
+        });
+        tms_report("load npz (CRC checked)", secs, 2 * bytes);
+        secs = tms_time_best(3, [&]
+        {
+            r.load("values", back, nullptr, false);
+            r.load("keys", keys, nullptr, false);
+            tms_sink(keys[n - 1]);
+        });
+        tms_report("load npz (unchecked)", secs, 2 * bytes);
+    }
+    secs = tms_time_best(5, [&]
+    {
+        TMSNpzReader r(npzPath);
+        TMSArrayView<double> view = r.view<double>("values");
+        tms_sink(view.size());
+    });
+    tms_report("view npz open+close", secs);
+
+    remove(npyPath.c_str());
+    remove(npzPath.c_str());
+    remove(csvPath.c_str());
+    return 0;
+}
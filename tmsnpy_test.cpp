@@ -0,0 +1,537 @@
+// tmsnpy_test.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Test program for tms_npy_save, tms_npy_load, tms_npy_view,
+//  class TMSNpzWriter and class TMSNpzReader
+// Uses the "doctest" unit-testing framework, version 2
+// Requires doctest.h, tmsnpy.hpp, tmsserial.hpp, tmscrc32.hpp,
+//  tmssimd.hpp, tmsarray.hpp
+
+// Includes for code to be tested
+#include "tmsnpy.hpp"        // For tms_npy_save, tms_npy_load, TMSNpzWriter
+#include "tmsnpy.hpp"        // Double-inclusion check, for testing only
+
+// Includes for the "doctest" unit-testing framework
+#define DOCTEST_CONFIG_IMPLEMENT
+                             // We write our own main
+#define DOCTEST_CONFIG_SUPER_FAST_ASSERTS
+                             // Reduce compile time
+#include "doctest.h"         // For doctest
+
+// Includes for all test programs
+#include <iostream>
+using std::cout;
+using std::endl;
+using std::cin;
+#include <string>
+using std::string;
+
+// Additional includes for this test program
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::int8_t;
+using std::int16_t;
+using std::int32_t;
+using std::uint8_t;
+using std::uint16_t;
+using std::uint32_t;
+using std::uint64_t;
+#include <cstdio>
+using std::remove;
+#include <cstring>
+using std::memcpy;
+#include <algorithm>
+using std::equal;
+#include <stdexcept>
+using std::runtime_error;
+using std::invalid_argument;
+#include <system_error>
+using std::system_error;
+#include <unistd.h>          // For getpid
+
+// Printable name for this test suite
+const string test_suite_name =
+    "tms_npy_save, tms_npy_load, tms_npy_view, TMSNpzWriter and TMSNpzReader";
+
+
+// *********************************************************************
+// Helper Functions for This Test Program
+// *********************************************************************
+
+
+// tempPath
+// A per-process scratch file name under /tmp
+string tempPath(const string & tag)
+{
+    return "/tmp/tmsnpy_test_" + std::to_string(getpid()) + "_" + tag;
+}
+
+
+// fillRandom
+// Deterministic pseudo-random values
+template <typename T>
+void fillRandom(TMSArray<T> & ta, uint64_t seed)
+{
+    uint64_t x = seed * 0x9E3779B97F4A7C15ull + 1;
+    for (size_t i = 0; i < ta.size(); ++i)
+    {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        ta[i] = T(x);
+    }
+}
+
+
+// writeFile
+// Creates path holding exactly the given bytes
+void writeFile(const string & path, const string & bytes)
+{
+    TMSFd file(::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644));
+    REQUIRE( file.fd >= 0 );
+    REQUIRE( ::pwrite(file.fd, bytes.data(), bytes.size(), 0)
+             == ssize_t(bytes.size()) );
+}
+
+
+// readFile
+// Whole contents of path
+string readFile(const string & path)
+{
+    TMSFd file(::open(path.c_str(), O_RDONLY));
+    REQUIRE( file.fd >= 0 );
+    struct stat st;
+    REQUIRE( ::fstat(file.fd, &st) == 0 );
+    string bytes(size_t(st.st_size), '\0');
+    REQUIRE( ::pread(file.fd, &bytes[0], bytes.size(), 0)
+             == ssize_t(bytes.size()) );
+    return bytes;
+}
+
+
+// npyFile
+// A .npy file with the given header dict, padded as NumPy does, then
+//  the given data bytes
+string npyFile(const string & dict, const string & data)
+{
+    string head = dict;
+    while ((10 + head.size() + 1) % 64 != 0)
+        head += ' ';
+    head += '\n';
+    string out("\x93NUMPY\x01\x00", 8);
+    out += char(head.size() & 0xFF);
+    out += char(head.size() >> 8);
+    return out + head + data;
+}
+
+
+// roundTrip
+// Saves and loads a random TMSArray<T> of size n
+template <typename T>
+void roundTrip(size_t n)
+{
+    const string path = tempPath("rt");
+    TMSArray<T> ta(n);
+    fillRandom(ta, n + sizeof(T));
+    tms_npy_save(ta, path);
+    TMSArray<T> back;
+    TMSArray<size_t> shape;
+    tms_npy_load(path, back, &shape);
+    REQUIRE( back.size() == n );
+    REQUIRE( equal(back.begin(), back.end(), ta.begin()) );
+    REQUIRE( shape.size() == 1 );
+    REQUIRE( shape[0] == n );
+    remove(path.c_str());
+}
+
+
+// *********************************************************************
+// Test Cases
+// *********************************************************************
+
+
+TEST_CASE( "npy header layout" )
+{
+    SUBCASE( "Descriptors" )
+    {
+        REQUIRE( tms_npy_descr<double>() == "<f8" );
+        REQUIRE( tms_npy_descr<float>() == "<f4" );
+        REQUIRE( tms_npy_descr<int32_t>() == "<i4" );
+        REQUIRE( tms_npy_descr<uint16_t>() == "<u2" );
+        REQUIRE( tms_npy_descr<int8_t>() == "|i1" );
+        REQUIRE( tms_npy_descr<uint8_t>() == "|u1" );
+    }
+    SUBCASE( "Dict as NumPy writes it" )
+    {
+        size_t one[1] = { 5 };
+        const string h = tms_npy_header("<f8", one, 1);
+        REQUIRE( h.size() % 64 == 0 );
+        REQUIRE( h.compare(0, 6, "\x93NUMPY") == 0 );
+        REQUIRE( h[6] == 1 );
+        REQUIRE( h.back() == '\n' );
+        REQUIRE( h.find("{'descr': '<f8', 'fortran_order': False, "
+                        "'shape': (5,), }") == 10 );
+        size_t two[2] = { 2, 3 };
+        REQUIRE( tms_npy_header("<i4", two, 2).find("'shape': (2, 3), }")
+                 != string::npos );
+        REQUIRE( tms_npy_header("<i4", two, 0).find("'shape': (), }")
+                 != string::npos );
+    }
+    SUBCASE( "Long headers switch to version 2.0" )
+    {
+        TMSArray<size_t> dims(static_cast<size_t>(30000));
+        for (auto & d : dims)
+            d = 1;
+        const string h = tms_npy_header("<f8", dims.begin(), dims.size());
+        REQUIRE( h[6] == 2 );
+        REQUIRE( h.size() % 64 == 0 );
+        const TMSNpyHeader p = tms_npy_parse(
+            reinterpret_cast<const unsigned char *>(h.data()), h.size(), "h");
+        REQUIRE( p.shape.size() == 30000 );
+        REQUIRE( p.count == 1 );
+        REQUIRE( p.dataOffset == h.size() );
+    }
+}
+
+
+TEST_CASE( "npy round trips" )
+{
+    roundTrip<double>(10000);
+    roundTrip<float>(777);
+    roundTrip<int64_t>(4096);
+    roundTrip<uint32_t>(3);
+    roundTrip<int16_t>(1);
+    roundTrip<uint8_t>(1001);
+    roundTrip<int8_t>(65);
+    roundTrip<double>(0);
+}
+
+
+TEST_CASE( "npy shapes" )
+{
+    const string path = tempPath("shape");
+    TMSArray<float> ta(static_cast<size_t>(24));
+    fillRandom(ta, 3);
+
+    SUBCASE( "Multi-dimensional" )
+    {
+        TMSArray<size_t> dims(static_cast<size_t>(3));
+        dims[0] = 2, dims[1] = 3, dims[2] = 4;
+        tms_npy_save(ta, path, &dims);
+        REQUIRE( readFile(path).find("'shape': (2, 3, 4), }") != string::npos );
+        TMSArray<float> back;
+        TMSArray<size_t> shape;
+        tms_npy_load(path, back, &shape);
+        REQUIRE( shape.size() == 3 );
+        REQUIRE( shape[0] == 2 );
+        REQUIRE( shape[2] == 4 );
+        REQUIRE( equal(back.begin(), back.end(), ta.begin()) );
+    }
+    SUBCASE( "Scalar: shape ()" )
+    {
+        TMSArray<float> one(static_cast<size_t>(1));
+        one[0] = 2.5f;
+        TMSArray<size_t> none;
+        tms_npy_save(one, path, &none);
+        TMSArray<float> back;
+        TMSArray<size_t> shape(static_cast<size_t>(4));
+        tms_npy_load(path, back, &shape);
+        REQUIRE( shape.size() == 0 );
+        REQUIRE( back.size() == 1 );
+        REQUIRE( back[0] == 2.5f );
+    }
+    SUBCASE( "Shape must match size" )
+    {
+        TMSArray<size_t> dims(static_cast<size_t>(2));
+        dims[0] = 5, dims[1] = 5;
+        REQUIRE_THROWS_AS( tms_npy_save(ta, path, &dims), invalid_argument );
+    }
+    remove(path.c_str());
+}
+
+
+TEST_CASE( "npy files written by NumPy" )
+{
+    const string path = tempPath("numpy");
+
+    SUBCASE( "Big-endian data is converted on load" )
+    {
+        const string data("\x00\x01\x00\x02\xFF\xFE", 6);
+        writeFile(path, npyFile("{'descr': '>i2', 'fortran_order': False, "
+                                "'shape': (3,), }", data));
+        TMSArray<int16_t> back;
+        tms_npy_load(path, back);
+        REQUIRE( back.size() == 3 );
+        REQUIRE( back[0] == 1 );
+        REQUIRE( back[1] == 2 );
+        REQUIRE( back[2] == -2 );
+        REQUIRE_THROWS_AS( tms_npy_view<int16_t>(path), runtime_error );
+    }
+    SUBCASE( "Key order, quoting and spacing are free" )
+    {
+        const uint32_t vals[2] = { 7, 9 };
+        const string data(reinterpret_cast<const char *>(vals), 8);
+        TMSArray<uint32_t> back;
+        TMSArray<size_t> shape;
+        writeFile(path, npyFile("{\"shape\":(1,2),'fortran_order':False,"
+                                "'descr':'<u4'}", data));
+        tms_npy_load(path, back, &shape);
+        REQUIRE( shape.size() == 2 );
+        REQUIRE( back[1] == 9 );
+        writeFile(path, npyFile("{\"shape\":(1,2),'fortran_order':True,"
+                                "'descr':'<u4'}", data));
+        REQUIRE_THROWS_AS( tms_npy_load(path, back), runtime_error );
+    }
+    SUBCASE( "Fortran order is fine in one dimension" )
+    {
+        const uint32_t vals[2] = { 7, 9 };
+        writeFile(path, npyFile("{'descr': '<u4', 'fortran_order': True, "
+                                "'shape': (2L,), }",
+                                string(reinterpret_cast<const char *>(vals), 8)));
+        TMSArrayView<uint32_t> v = tms_npy_view<uint32_t>(path);
+        REQUIRE( v.size() == 2 );
+        REQUIRE( v[1] == 9 );
+    }
+    remove(path.c_str());
+}
+
+
+TEST_CASE( "npy rejects what it cannot represent" )
+{
+    const string path = tempPath("bad");
+    TMSArray<double> out(static_cast<size_t>(2));
+
+    SUBCASE( "Wrong dtype" )
+    {
+        TMSArray<float> f(static_cast<size_t>(4));
+        tms_npy_save(f, path);
+        REQUIRE_THROWS_AS( tms_npy_load(path, out), runtime_error );
+        TMSArray<int32_t> i;
+        REQUIRE_THROWS_AS( tms_npy_load(path, i), runtime_error );
+        REQUIRE( out.size() == 2 );         // strong guarantee
+    }
+    SUBCASE( "Structured dtype" )
+    {
+        writeFile(path, npyFile("{'descr': [('a', '<f8')], 'fortran_order': "
+                                "False, 'shape': (1,), }", string(8, '\0')));
+        REQUIRE_THROWS_AS( tms_npy_load(path, out), runtime_error );
+    }
+    SUBCASE( "Truncated data" )
+    {
+        writeFile(path, npyFile("{'descr': '<f8', 'fortran_order': False, "
+                                "'shape': (3,), }", string(16, '\0')));
+        REQUIRE_THROWS_AS( tms_npy_load(path, out), runtime_error );
+        REQUIRE_THROWS_AS( tms_npy_view<double>(path), runtime_error );
+    }
+    SUBCASE( "Not .npy" )
+    {
+        writeFile(path, "just some text, long enough");
+        REQUIRE_THROWS_AS( tms_npy_load(path, out), runtime_error );
+    }
+    SUBCASE( "Missing file" )
+    {
+        REQUIRE_THROWS_AS( tms_npy_load(path + "_none", out), system_error );
+    }
+    REQUIRE( out.size() == 2 );
+    remove(path.c_str());
+}
+
+
+TEST_CASE( "npy zero-copy view" )
+{
+    const string path = tempPath("view");
+    TMSArray<double> ta(static_cast<size_t>(100000));
+    fillRandom(ta, 11);
+    tms_npy_save(ta, path);
+    TMSArray<size_t> shape;
+    TMSArrayView<double> v = tms_npy_view<double>(path, &shape);
+    REQUIRE( v.size() == ta.size() );
+    REQUIRE( shape.size() == 1 );
+    REQUIRE( equal(v.begin(), v.end(), ta.begin()) );
+    REQUIRE( reinterpret_cast<uintptr_t>(v.begin()) % TMS_NPY_ALIGN == 0 );
+    remove(path.c_str());
+}
+
+
+TEST_CASE( "npz archives" )
+{
+    const string path = tempPath("npz");
+    TMSArray<double> a(static_cast<size_t>(1000));
+    TMSArray<int32_t> b(static_cast<size_t>(6));
+    TMSArray<uint8_t> c(static_cast<size_t>(13));
+    fillRandom(a, 1);
+    fillRandom(b, 2);
+    fillRandom(c, 3);
+    TMSArray<size_t> dims(static_cast<size_t>(2));
+    dims[0] = 2, dims[1] = 3;
+    {
+        TMSNpzWriter w(path);
+        w.add("c", c);
+        w.add("a", a);
+        w.add("b", b, &dims);
+        REQUIRE( w.size() == 3 );
+        REQUIRE_THROWS_AS( w.add("a", a), invalid_argument );
+        w.close();
+        REQUIRE_THROWS_AS( w.add("d", a), runtime_error );
+    }
+
+    SUBCASE( "Directory" )
+    {
+        TMSNpzReader r(path);
+        REQUIRE( r.size() == 3 );
+        REQUIRE( r.name(0) == "c" );
+        REQUIRE( r.name(1) == "a" );
+        REQUIRE( r.contains("b") );
+        REQUIRE( !r.contains("b.npy") );
+    }
+    SUBCASE( "Load and view" )
+    {
+        TMSNpzReader r(path);
+        TMSArray<double> a2;
+        r.load("a", a2);
+        REQUIRE( equal(a2.begin(), a2.end(), a.begin()) );
+        TMSArray<int32_t> b2;
+        TMSArray<size_t> shape;
+        r.load("b", b2, &shape);
+        REQUIRE( equal(b2.begin(), b2.end(), b.begin()) );
+        REQUIRE( shape.size() == 2 );
+        REQUIRE( shape[1] == 3 );
+        TMSArray<uint8_t> c2;
+        r.load("c", c2);
+        REQUIRE( equal(c2.begin(), c2.end(), c.begin()) );
+
+        TMSArrayView<double> va = r.view<double>("a");
+        REQUIRE( equal(va.begin(), va.end(), a.begin()) );
+        REQUIRE( reinterpret_cast<uintptr_t>(va.begin()) % TMS_NPY_ALIGN == 0 );
+        TMSArrayView<int32_t> vb = r.view<int32_t>("b");
+        REQUIRE( vb[5] == b[5] );
+
+        REQUIRE_THROWS_AS( r.load("zz", a2), runtime_error );
+        REQUIRE_THROWS_AS( r.load("b", a2), runtime_error );
+    }
+    SUBCASE( "Standard zip layout" )
+    {
+        const string bytes = readFile(path);
+        REQUIRE( bytes.compare(0, 4, "PK\x03\x04") == 0 );
+        REQUIRE( bytes.compare(bytes.size() - 22, 4, "PK\x05\x06") == 0 );
+        REQUIRE( bytes.find("c.npy") == 30 );
+    }
+    SUBCASE( "Corruption is caught by the CRC" )
+    {
+        string bytes = readFile(path);
+        const size_t at = bytes.find("a.npy") + 300;
+        bytes[at] = char(bytes[at] ^ 1);
+        writeFile(path, bytes);
+        TMSNpzReader r(path);
+        TMSArray<double> a2;
+        REQUIRE_THROWS_AS( r.load("a", a2), runtime_error );
+        r.load("a", a2, nullptr, false);
+        REQUIRE( a2.size() == a.size() );
+    }
+    SUBCASE( "Extra field longer than the entry's extra area" )
+    {
+        // Last central entry: name "b.npy" becomes "b" plus a 4-byte
+        //  zip64 extra header claiming 16 bytes of data that are not
+        //  there, with the size saturated so the field would be read
+        string bytes = readFile(path);
+        const size_t at = bytes.rfind("b.npy") - 46;
+        REQUIRE( bytes.compare(at, 4, "PK\x01\x02") == 0 );
+        bytes.replace(at + 24, 4, "\xFF\xFF\xFF\xFF");
+        bytes.replace(at + 28, 4, string("\x01\x00\x04\x00", 4));
+        bytes.replace(at + 47, 4, string("\x01\x00\x10\x00", 4));
+        writeFile(path, bytes);
+        REQUIRE_THROWS_AS( TMSNpzReader r(path), runtime_error );
+    }
+    SUBCASE( "Not a zip" )
+    {
+        writeFile(path, string(100, 'x'));
+        REQUIRE_THROWS_AS( TMSNpzReader r(path), runtime_error );
+    }
+    SUBCASE( "Zip64 locator in an archive shorter than a zip64 end record" )
+    {
+        // 42 bytes: a zip64 locator pointing at offset 16, where its own
+        //  last field spells the zip64 end signature, then an empty end
+        //  record. A 56-byte record cannot start anywhere in the file.
+        string bytes(42, '\0');
+        const uint32_t loc = 0x07064b50, z64 = 0x06064b50, end = 0x06054b50;
+        const uint64_t at = 16;
+        bytes.replace(0, 4, reinterpret_cast<const char *>(&loc), 4);
+        bytes.replace(8, 8, reinterpret_cast<const char *>(&at), 8);
+        bytes.replace(16, 4, reinterpret_cast<const char *>(&z64), 4);
+        bytes.replace(20, 4, reinterpret_cast<const char *>(&end), 4);
+        writeFile(path, bytes);
+        REQUIRE_THROWS_AS( TMSNpzReader r(path), runtime_error );
+    }
+    remove(path.c_str());
+}
+
+
+TEST_CASE( "npz empty archive and empty arrays" )
+{
+    const string path = tempPath("npz0");
+    {
+        TMSNpzWriter w(path);
+    }
+    REQUIRE( readFile(path).size() == 22 );
+    {
+        TMSNpzReader r(path);
+        REQUIRE( r.size() == 0 );
+    }
+    {
+        TMSNpzWriter w(path);
+        w.add("e", TMSArray<float>());
+    }
+    TMSNpzReader r(path);
+    TMSArray<float> e(static_cast<size_t>(3));
+    r.load("e", e);
+    REQUIRE( e.size() == 0 );
+    REQUIRE( r.view<float>("e").size() == 0 );
+    remove(path.c_str());
+}
+
+
+// *********************************************************************
+// Main Program
+// *********************************************************************
+
+
+// userPause
+// Wait for user to press ENTER: read all chars through first newline.
+void userPause()
+{
+    std::cout.flush();
+    while (std::cin.get() != '\n') ;
+}
+
+
+// Main program
+// Run all tests. Prompt for ENTER before exiting.
+int main(int argc,
+         char *argv[])
+{
+    doctest::Context dtcontext;
+                             // Primary doctest object
+    int dtresult;            // doctest return code; for return by main
+
+    // Handle command line
+    dtcontext.applyCommandLine(argc, argv);
+    dtresult = 0;            // doctest flags no command-line errors
+                             //  (strange but true)
+
+    if (!dtresult)           // Continue only if no command-line error
+    {
+        // Run test suites
+        cout << "BEGIN tests for " << test_suite_name << "\n" << endl;
+        dtresult = dtcontext.run();
+        cout << "END tests for " << test_suite_name << "\n" << endl;
+    }
+
+    // Wait for user
+    std::cout << "Press ENTER to quit ";
+    userPause();
+
+    // Program return value is return code from doctest
+    return dtresult;
+}
@@ -0,0 +1,485 @@
+// tmsnumaarray.hpp
+// Matthew Johnson
+// 10/17/2026
+// NUMA-partitioned array: one TMSArray shard per memory node, one
+//  global index space
+
+#pragma once
+// for single inclusion
+
+#include "tmsarray.hpp"
+// For class template TMSArray
+
+#include "tmsparallel.hpp"
+// For TMSThreadPool
+// For tms_chunk
+// For tms_page_elems
+// For tms_page_offset
+
+#include <cstddef>
+// For std::size_t
+
+#include <cstdint>
+// For std::uintptr_t
+
+#include <algorithm>
+// For std::fill
+// For std::min
+
+#include <fstream>
+// For std::ifstream
+
+#include <string>
+// For std::string
+// For std::to_string
+
+#include <vector>
+// For std::vector
+
+#include <stdexcept>
+// For std::logic_error
+
+#ifdef __linux__
+#include <sched.h>
+// For sched_setaffinity
+// For sched_getaffinity
+// For cpu_set_t
+
+#include <unistd.h>
+// For syscall
+
+#include <sys/syscall.h>
+// For SYS_mbind
+#endif
+
+
+
+// *********************************************************************
+// NUMA topology helpers - free functions
+// *********************************************************************
+
+
+// tms_parse_cpulist
+// Strong Guarantee
+// Exception-Neutral
+// Pre: None
+// Post:
+//      Returns ids listed in a sysfs list string such as "0-3,8,10-11"
+inline std::vector<int> tms_parse_cpulist(const std::string & text)
+{
+    std::vector<int> ids;
+    std::size_t pos = 0;
+    while (pos < text.size())
+    {
+        std::size_t comma = text.find(',', pos);
+        if (comma == std::string::npos)
+            comma = text.size();
+        std::string item = text.substr(pos, comma - pos);
+        std::size_t dash = item.find('-');
+        try
+        {
+            int first = std::stoi(item.substr(0, dash));
+            int last = dash == std::string::npos ? first
+                                                 : std::stoi(item.substr(dash + 1));
+            for (int id = first; id <= last; ++id)
+                ids.push_back(id);
+        }
+        catch (std::logic_error &)
+        {
+            // blank or trailing-newline item: nothing to add
+        }
+        pos = comma + 1;
+    }
+    return ids;
+}
+
+
+// tms_read_sysfs_list
+// Strong Guarantee
+// Exception-Neutral
+// Pre: None
+// Post:
+//      Returns parsed contents of the sysfs list file at path; empty if
+//      the file cannot be read
+inline std::vector<int> tms_read_sysfs_list(const std::string & path)
+{
+    std::ifstream in(path);
+    std::string text;
+    if (!in || !std::getline(in, text))
+        return {};
+    return tms_parse_cpulist(text);
+}
+
+
+// tms_numa_nodes
+// Strong Guarantee
+// Exception-Neutral
+// Pre: None
+// Post:
+//      Returns ids of NUMA nodes that have memory; {0} when the machine
+//      is not NUMA or topology is unavailable
+inline std::vector<int> tms_numa_nodes()
+{
+    std::vector<int> nodes =
+        tms_read_sysfs_list("/sys/devices/system/node/has_memory");
+    if (nodes.empty())
+        nodes = tms_read_sysfs_list("/sys/devices/system/node/online");
+    if (nodes.empty())
+        nodes.push_back(0);
+    return nodes;
+}
+
+
+// tms_pin_to_node
+// No-Throw Guarantee
+// Pre: None
+// Post:
+//      Calling thread may only run on CPUs of node. Returns false (and
+//      changes nothing) when that is not possible
+inline bool tms_pin_to_node(int node) noexcept
+{
+#ifdef __linux__
+    try
+    {
+        std::vector<int> cpus = tms_read_sysfs_list(
+            "/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        if (cpus.empty())
+            return false;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : cpus)
+            if (cpu >= 0 && cpu < CPU_SETSIZE)
+                CPU_SET(cpu, &set);
+        return sched_setaffinity(0, sizeof(set), &set) == 0;
+    }
+    catch(...)
+    {
+        return false;
+    }
+#else
+    (void)node;
+    return false;
+#endif
+}
+
+
+// tms_bind_to_node
+// No-Throw Guarantee
+// Pre: None
+// Post:
+//      Whole pages inside [addr, addr+bytes) prefer node, and pages
+//      already touched are migrated there. Returns false when mbind is
+//      unavailable or refused; first-touch placement then still applies
+inline bool tms_bind_to_node(void * addr, std::size_t bytes, int node) noexcept
+{
+#if defined(__linux__) && defined(SYS_mbind)
+    const std::uintptr_t page = TMS_PAGE_BYTES;
+    std::uintptr_t first = (reinterpret_cast<std::uintptr_t>(addr) + page - 1)
+                           & ~(page - 1);
+    std::uintptr_t last = (reinterpret_cast<std::uintptr_t>(addr) + bytes)
+                          & ~(page - 1);
+    if (node < 0 || node >= 1024 || last <= first)
+        return false;
+
+    const unsigned long MPOL_PREFERRED_ = 1;
+    const unsigned long MPOL_MF_MOVE_ = 1UL << 1;
+    const std::size_t BITS = 8 * sizeof(unsigned long);
+    unsigned long mask[1024 / BITS] = {};
+    mask[node / BITS] = 1UL << (node % BITS);
+    return syscall(SYS_mbind, first, last - first, MPOL_PREFERRED_, mask,
+                   1024 + 1, MPOL_MF_MOVE_) == 0;
+#else
+    (void)addr; (void)bytes; (void)node;
+    return false;
+#endif
+}
+
+
+
+// *********************************************************************
+// class TMSNumaArray - Class definition
+// *********************************************************************
+
+
+// class TMSNumaArray
+// Fixed-size array split into contiguous shards, one TMSArray per
+//  partition, each placed on one memory node. Element i lives in shard
+//  i / _shardSize. On a single-node machine there is one partition and
+//  this behaves as a plain TMSArray.
+// Invariants:
+//     _shards.size() == _nodes.size() == partition count > 0.
+//     Every shard but the last holds _shardSize elements; the total is
+//      _size.
+template <typename Valtype>
+class TMSNumaArray
+{
+
+public:
+
+
+    using value_type = Valtype;
+
+    using size_type  = std::size_t;
+
+    using shard_type = TMSArray<value_type>;
+
+
+// ***** TMSNumaArray: ctors, dctor *****
+public:
+
+
+    // Ctor from size
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      size() == thesize, every element value-initialized
+    //      partitions == 0 means one per NUMA node; more partitions than
+    //       nodes are assigned to nodes round-robin
+    //      each shard is bound to its node and first-touched by pool
+    //       threads pinned to that node
+    explicit TMSNumaArray(size_type thesize,
+                          size_type partitions = 0,
+                          TMSThreadPool & pool = tms_default_pool())
+        :_size(thesize),
+         _shardSize(0),
+         _pin(false)
+    {
+        std::vector<int> online = tms_numa_nodes();
+        _pin = online.size() > 1;
+        if (partitions == 0)
+            partitions = online.size();
+
+        _shardSize = (_size + partitions - 1) / partitions;
+        for (size_type p = 0; p < partitions; ++p)
+        {
+            size_type first = std::min(p * _shardSize, _size);
+            size_type last = std::min(first + _shardSize, _size);
+            _nodes.push_back(online[p % online.size()]);
+            _shards.emplace_back(last - first);
+            if (_pin)
+                tms_bind_to_node(_shards.back().begin(),
+                                 _shards.back().size() * sizeof(value_type),
+                                 _nodes.back());
+        }
+
+        run_local([](size_type, value_type * first, value_type * last)
+        {
+            std::fill(first, last, value_type());
+        }, pool);
+    }
+
+
+    // Compiler-generated copy/move/dctor are used; copies are NOT
+    // re-bound and land wherever the copying thread touches them.
+
+
+// ***** TMSNumaArray: general public operators *****
+public:
+
+
+    // operator[] - non-const & const
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      0 <= index < size
+    // Post:
+    //      Returns element at global index
+    value_type & operator[](size_type index)
+    {
+        return _shards[index / _shardSize][index % _shardSize];
+    }
+    const value_type & operator[](size_type index) const
+    {
+        return _shards[index / _shardSize][index % _shardSize];
+    }
+
+
+// ***** TMSNumaArray: general public functions *****
+public:
+
+
+    // size
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns total element count
+    size_type size() const noexcept
+    {
+        return _size;
+    }
+
+
+    // empty
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns size() == 0
+    bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+
+    // partitions
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns number of shards
+    size_type partitions() const noexcept
+    {
+        return _shards.size();
+    }
+
+
+    // partition_of
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      0 <= index < size
+    // Post:
+    //      Returns shard number holding global index
+    size_type partition_of(size_type index) const noexcept
+    {
+        return index / _shardSize;
+    }
+
+
+    // offset_of
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      0 <= p < partitions
+    // Post:
+    //      Returns global index of first element of shard p
+    size_type offset_of(size_type p) const noexcept
+    {
+        return std::min(p * _shardSize, _size);
+    }
+
+
+    // node - shard - non-const & const
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      0 <= p < partitions
+    // Post:
+    //      node: Returns NUMA node shard p is placed on
+    //      shard: Returns shard p; its begin()/end() is node-local
+    //       iteration for a worker pinned to node(p)
+    int node(size_type p) const noexcept
+    {
+        return _nodes[p];
+    }
+    shard_type & shard(size_type p) noexcept
+    {
+        return _shards[p];
+    }
+    const shard_type & shard(size_type p) const noexcept
+    {
+        return _shards[p];
+    }
+
+
+    // run_local - non-const & const
+    // Basic Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      func callable as func(size_type p, Ptr first, Ptr last) where
+    //       Ptr is (const) value_type *
+    // Post:
+    //      pool threads are divided among partitions round-robin; each
+    //      pins itself to its partition's node and is handed a
+    //      page-aligned slice of that shard. Every thread that pinned
+    //      itself, pool worker or caller, gets its previous CPU affinity
+    //      back when its part is done (or throws), so later work on the
+    //      pool is not confined to the nodes of this array.
+    template <typename Func>
+    void run_local(Func && func, TMSThreadPool & pool = tms_default_pool())
+    {
+        runPinned(pool, [&](size_type p, size_type first, size_type last)
+        {
+            func(p, _shards[p].begin() + first, _shards[p].begin() + last);
+        });
+    }
+    template <typename Func>
+    void run_local(Func && func,
+                   TMSThreadPool & pool = tms_default_pool()) const
+    {
+        runPinned(pool,
+            [&](size_type p, size_type first, size_type last)
+        {
+            const value_type * base = _shards[p].begin();
+            func(p, base + first, base + last);
+        });
+    }
+
+
+// ***** TMSNumaArray: internal functions *****
+private:
+
+
+    template <typename Func>
+    void runPinned(TMSThreadPool & pool, Func && func) const
+    {
+        const size_type parts = _shards.size();
+        const bool pin = _pin;
+        pool.run([&](size_type tid, size_type count)
+        {
+            // With fewer threads than partitions, threads take several
+            // partitions each; otherwise several threads share one.
+            auto work = [&]
+            {
+                for (size_type p = tid % parts; p < parts; p += count)
+                {
+                    if (pin)
+                        tms_pin_to_node(_nodes[p]);
+                    size_type sharers = count / parts
+                                        + (p < count % parts ? 1 : 0);
+                    if (sharers == 0)
+                        sharers = 1;
+                    size_type local = count >= parts ? tid / parts : 0;
+                    auto range = tms_chunk(_shards[p].size(), local, sharers,
+                                           tms_page_elems<value_type>(),
+                                           tms_page_offset(_shards[p].begin()));
+                    if (range.first < range.second)
+                        func(p, range.first, range.second);
+                }
+            };
+#ifdef __linux__
+            cpu_set_t saved;
+            if (!pin || sched_getaffinity(0, sizeof(saved), &saved) != 0)
+            {
+                work();
+                return;
+            }
+            try
+            {
+                work();
+            }
+            catch (...)
+            {
+                sched_setaffinity(0, sizeof(saved), &saved);
+                throw;
+            }
+            sched_setaffinity(0, sizeof(saved), &saved);
+#else
+            work();
+#endif
+        });
+    }
+
+
+// ***** TMSNumaArray: data members *****
+private:
+
+    size_type               _size;
+    size_type               _shardSize;
+    bool                    _pin;       // more than one node online
+    std::vector<int>        _nodes;
+    std::vector<shard_type> _shards;
+
+}; // end of class
@@ -0,0 +1,80 @@
+// tmsnumaarray_bench.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Benchmark: aggregate scan bandwidth of one TMSArray<double> scanned by
+//  all threads vs. a TMSNumaArray<double> scanned node-locally.
+// Usage: tmsnumaarray_bench [megabytes=512] [threads=hardware]
+// Requires tmsnumaarray.hpp, tmsparallel.hpp, tmsarray.hpp, tmsbench.hpp
+
+#include "tmsnumaarray.hpp"
+#include "tmsparallel.hpp"
+#include "tmsbench.hpp"
+
+#include <cstddef>
+using std::size_t;
+#include <iostream>
+using std::cout;
+#include <atomic>
+using std::atomic;
+
+
+int main(int argc, char * argv[])
+{
+    const size_t megabytes = tms_arg(argc, argv, 1, 512);
+    TMSThreadPool pool(tms_arg(argc, argv, 2, 0));
+    const size_t n = megabytes * (size_t(1) << 20) / sizeof(double);
+    const size_t bytes = n * sizeof(double);
+
+    cout << "TMSArray<double> vs TMSNumaArray<double>, " << megabytes
+         << " MB, " << pool.size() << " threads, "
+         << tms_numa_nodes().size() << " NUMA node(s)\n\n";
+
+    // Single array, all pages first-touched by the main thread
+    {
+        TMSArray<double> flat(n);
+        for (size_t i = 0; i < n; ++i)
+            flat[i] = 1.0;
+        const double * data = flat.begin();
+        double secs = tms_time_best(5, [&]
+        {
+            atomic<long> total(0);
+            tms_parallel_for(n, [&](size_t first, size_t last, size_t)
+            {
+                double acc = 0.0;
+                for (size_t i = first; i < last; ++i)
+                    acc += data[i];
+                total += long(acc);
+            }, pool);
+            tms_sink(total);
+        });
+        tms_report("TMSArray, serial touch, all threads", secs, bytes);
+    }
+
+    // Partitioned: one shard per node, scanned by threads on that node
+    {
+        TMSNumaArray<double> parted(n, 0, pool);
+        parted.run_local([](size_t, double * first, double * last)
+        {
+            for (; first != last; ++first)
+                *first = 1.0;
+        }, pool);
+        double secs = tms_time_best(5, [&]
+        {
+            atomic<long> total(0);
+            parted.run_local([&](size_t, const double * first,
+                                 const double * last)
+            {
+                double acc = 0.0;
+                for (; first != last; ++first)
+                    acc += *first;
+                total += long(acc);
+            }, pool);
+            tms_sink(total);
+        });
+        tms_report("TMSNumaArray, node-local scan", secs, bytes);
+        cout << "  partitions: " << parted.partitions() << "\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,195 @@
+// tmsnumaarray_test.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Test program for class template TMSNumaArray
+// Uses the "doctest" unit-testing framework, version 2
+// Requires doctest.h, tmsnumaarray.hpp, tmsparallel.hpp, tmsarray.hpp
+
+// Includes for code to be tested
+#include "tmsnumaarray.hpp"  // For class template TMSNumaArray
+#include "tmsnumaarray.hpp"  // Double-inclusion check, for testing only
+
+// Includes for the "doctest" unit-testing framework
+#define DOCTEST_CONFIG_IMPLEMENT
+                             // We write our own main
+#define DOCTEST_CONFIG_SUPER_FAST_ASSERTS
+                             // Reduce compile time
+#include "doctest.h"         // For doctest
+
+// Includes for all test programs
+#include <iostream>
+using std::cout;
+using std::endl;
+using std::cin;
+#include <string>
+using std::string;
+
+// Additional includes for this test program
+#include <cstddef>
+using std::size_t;
+#include <vector>
+using std::vector;
+#include <atomic>
+using std::atomic;
+
+// Printable name for this test suite
+const string test_suite_name =
+    "class template TMSNumaArray";
+
+
+// *********************************************************************
+// Test Cases
+// *********************************************************************
+
+
+TEST_CASE( "tms_parse_cpulist" )
+{
+    SUBCASE( "Ranges and singles" )
+    {
+        vector<int> ids = tms_parse_cpulist("0-2,5,7-8\n");
+        REQUIRE( ids == vector<int>({ 0, 1, 2, 5, 7, 8 }) );
+    }
+
+    SUBCASE( "Empty" )
+    {
+        REQUIRE( tms_parse_cpulist("").empty() );
+    }
+
+    SUBCASE( "Topology always reports a node" )
+    {
+        REQUIRE_FALSE( tms_numa_nodes().empty() );
+    }
+}
+
+
+TEST_CASE( "TMSNumaArray global index space" )
+{
+    TMSThreadPool pool(3);
+
+    SUBCASE( "Default partitions follow node count" )
+    {
+        TMSNumaArray<int> tn(1000, 0, pool);
+        REQUIRE( tn.size() == 1000 );
+        REQUIRE( tn.partitions() == tms_numa_nodes().size() );
+    }
+
+    SUBCASE( "Forced partitions, uneven split" )
+    {
+        const size_t SIZE = 10007;
+        TMSNumaArray<long> tn(SIZE, 4, pool);
+        REQUIRE( tn.partitions() == 4 );
+
+        size_t total = 0;
+        for (size_t p = 0; p < tn.partitions(); ++p)
+        {
+            REQUIRE( tn.offset_of(p) == total );
+            total += tn.shard(p).size();
+        }
+        REQUIRE( total == SIZE );
+
+        for (size_t i = 0; i < SIZE; ++i)
+        {
+            REQUIRE( tn[i] == 0 );
+            tn[i] = long(i);
+        }
+        for (size_t p = 0; p < tn.partitions(); ++p)
+            REQUIRE( tn.shard(p)[0] == long(tn.offset_of(p)) );
+        REQUIRE( tn.partition_of(SIZE - 1) == 3 );
+    }
+
+    SUBCASE( "run_local visits every element once" )
+    {
+        const size_t SIZE = 50000;
+        TMSNumaArray<int> tn(SIZE, 2, pool);
+        tn.run_local([](size_t, int * first, int * last)
+        {
+            for (; first != last; ++first)
+                *first += 1;
+        }, pool);
+
+        atomic<long> sum(0);
+        const TMSNumaArray<int> & ctn = tn;
+        ctn.run_local([&](size_t, const int * first, const int * last)
+        {
+            long acc = 0;
+            for (; first != last; ++first)
+                acc += *first;
+            sum += acc;
+        }, pool);
+        REQUIRE( sum == long(SIZE) );
+    }
+
+    SUBCASE( "More partitions than threads" )
+    {
+        TMSThreadPool one(1);
+        TMSNumaArray<int> tn(100, 5, one);
+        atomic<int> parts(0);
+        tn.run_local([&](size_t, int *, int *) { ++parts; }, one);
+        REQUIRE( parts == 5 );
+    }
+
+#ifdef __linux__
+    SUBCASE( "run_local leaves every pool thread's affinity as it was" )
+    {
+        cpu_set_t before;
+        REQUIRE( sched_getaffinity(0, sizeof before, &before) == 0 );
+        TMSNumaArray<int> tn(50000, 2, pool);
+        tn.run_local([](size_t, int *, int *) {}, pool);
+        atomic<int> same(0);
+        pool.run([&](size_t, size_t)
+        {
+            cpu_set_t now;
+            if (sched_getaffinity(0, sizeof now, &now) == 0
+                && CPU_EQUAL(&now, &before))
+                ++same;
+        });
+        REQUIRE( same == int(pool.size()) );
+    }
+#endif
+}
+
+
+// *********************************************************************
+// Main Program
+// *********************************************************************
+
+
+// userPause
+// Wait for user to press ENTER: read all chars through first newline.
+void userPause()
+{
+    std::cout.flush();
+    while (std::cin.get() != '\n') ;
+}
+
+
+// Main program
+// Run all tests. Prompt for ENTER before exiting.
+int main(int argc,
+         char *argv[])
+{
+    doctest::Context dtcontext;
+                             // Primary doctest object
+    int dtresult;            // doctest return code; for return by main
+
+    // Handle command line
+    dtcontext.applyCommandLine(argc, argv);
+    dtresult = 0;            // doctest flags no command-line errors
+                             //  (strange but true)
+
+    if (!dtresult)           // Continue only if no command-line error
+    {
+        // Run test suites
+        cout << "BEGIN tests for " << test_suite_name << "\n" << endl;
+        dtresult = dtcontext.run();
+        cout << "END tests for " << test_suite_name << "\n" << endl;
+    }
+
+    // Wait for user
+    std::cout << "Press ENTER to quit ";
+    userPause();
+
+    // Program return value is return code from doctest
+    return dtresult;
+}
@@ -0,0 +1,504 @@
+// tmspacked.hpp
+// Matthew Johnson
+// 10/17/2026
+// frame-of-reference + bit-packed integer array: fixed bit width per
+//  128-value block, O(1) access, append, SIMD bulk decode
+
+#pragma once
+// for single inclusion
+
+#include "tmsarray.hpp"
+// For class template TMSArray
+
+#include "tmssimd.hpp"
+// For tms_isa_limit
+// For TMS_SIMD_X86
+
+#include <cstddef>
+// For std::size_t
+
+#include <cstdint>
+// For std::uint64_t
+// For std::uint32_t
+
+#include <algorithm>
+// For std::min
+// For std::max
+// For std::fill
+// For std::copy
+
+#include <type_traits>
+// For std::is_integral
+
+
+
+// Values per block; every block of TMS_PACK_BLOCK values at width w
+//  occupies exactly 2 * w words
+constexpr std::size_t TMS_PACK_BLOCK = 128;
+
+
+// tms_pack_mask
+// Low width bits set (width 0..64)
+constexpr std::uint64_t tms_pack_mask(unsigned width) noexcept
+{
+    return width >= 64 ? ~std::uint64_t(0)
+                       : (std::uint64_t(1) << width) - 1;
+}
+
+
+// tms_pack_extract
+// No-Throw Guarantee
+// Pre:
+//      words[bit / 64 + 1] readable
+// Post:
+//      Returns the width-bit field starting at bit of words
+inline std::uint64_t tms_pack_extract(const std::uint64_t * words,
+                                      std::size_t bit, unsigned width) noexcept
+{
+    const std::uint64_t * p = words + bit / 64;
+    const unsigned shift = unsigned(bit % 64);
+    // (p[1] << 1) << (63 - shift) is p[1] << (64 - shift), without the
+    //  undefined shift by 64 when shift == 0
+    const std::uint64_t v = (p[0] >> shift) | ((p[1] << 1) << (63 - shift));
+    return v & tms_pack_mask(width);
+}
+
+
+
+// *********************************************************************
+// Bulk unpack kernels
+// *********************************************************************
+
+
+// tms_unpack_scalar
+// out[j] = base + field j of width bits, for j in [0, n)
+inline void tms_unpack_scalar(const std::uint64_t * words, unsigned width,
+                              std::uint64_t base, std::uint64_t * out,
+                              std::size_t n) noexcept
+{
+    for (std::size_t j = 0; j < n; ++j)
+        out[j] = base + tms_pack_extract(words, j * width, width);
+}
+
+
+#ifdef TMS_SIMD_X86
+
+TMS_AVX512_DIAG_PUSH
+
+
+// tms_unpack_avx2
+// Same result as tms_unpack_scalar, 4 fields per step: gather the two
+//  words each field straddles, shift both by per-lane counts (a count of
+//  64 yields 0, so aligned fields need no special case), mask, add base
+__attribute__((target("avx2")))
+inline void tms_unpack_avx2(const std::uint64_t * words, unsigned width,
+                            std::uint64_t base, std::uint64_t * out,
+                            std::size_t n) noexcept
+{
+    const long long * src = reinterpret_cast<const long long *>(words);
+    const __m256i vw = _mm256_set1_epi64x((long long)width);
+    const __m256i mask = _mm256_set1_epi64x((long long)tms_pack_mask(width));
+    const __m256i vbase = _mm256_set1_epi64x((long long)base);
+    const __m256i six3 = _mm256_set1_epi64x(63);
+    const __m256i s64 = _mm256_set1_epi64x(64);
+    const __m256i one = _mm256_set1_epi64x(1);
+    __m256i j = _mm256_setr_epi64x(0, 1, 2, 3);
+    const __m256i step = _mm256_set1_epi64x(4);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256i bit = _mm256_mul_epu32(j, vw);
+        __m256i idx = _mm256_srli_epi64(bit, 6);
+        __m256i sh = _mm256_and_si256(bit, six3);
+        __m256i lo = _mm256_i64gather_epi64(src, idx, 8);
+        __m256i hi = _mm256_i64gather_epi64(src, _mm256_add_epi64(idx, one), 8);
+        __m256i v = _mm256_or_si256(_mm256_srlv_epi64(lo, sh),
+                                    _mm256_sllv_epi64(hi, _mm256_sub_epi64(s64, sh)));
+        v = _mm256_add_epi64(_mm256_and_si256(v, mask), vbase);
+        _mm256_storeu_si256((__m256i *)(out + i), v);
+        j = _mm256_add_epi64(j, step);
+    }
+    for (; i < n; ++i)
+        out[i] = base + tms_pack_extract(words, i * width, width);
+}
+
+
+// tms_unpack_avx512
+// As tms_unpack_avx2, 8 fields per step
+__attribute__((target("avx512f")))
+inline void tms_unpack_avx512(const std::uint64_t * words, unsigned width,
+                              std::uint64_t base, std::uint64_t * out,
+                              std::size_t n) noexcept
+{
+    const __m512i vw = _mm512_set1_epi64((long long)width);
+    const __m512i mask = _mm512_set1_epi64((long long)tms_pack_mask(width));
+    const __m512i vbase = _mm512_set1_epi64((long long)base);
+    const __m512i six3 = _mm512_set1_epi64(63);
+    const __m512i s64 = _mm512_set1_epi64(64);
+    const __m512i one = _mm512_set1_epi64(1);
+    __m512i j = _mm512_setr_epi64(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m512i step = _mm512_set1_epi64(8);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m512i bit = _mm512_mul_epu32(j, vw);
+        __m512i idx = _mm512_srli_epi64(bit, 6);
+        __m512i sh = _mm512_and_si512(bit, six3);
+        __m512i lo = _mm512_i64gather_epi64(idx, words, 8);
+        __m512i hi = _mm512_i64gather_epi64(_mm512_add_epi64(idx, one), words, 8);
+        __m512i v = _mm512_or_si512(_mm512_srlv_epi64(lo, sh),
+                                    _mm512_sllv_epi64(hi, _mm512_sub_epi64(s64, sh)));
+        v = _mm512_add_epi64(_mm512_and_si512(v, mask), vbase);
+        _mm512_storeu_si512(out + i, v);
+        j = _mm512_add_epi64(j, step);
+    }
+    for (; i < n; ++i)
+        out[i] = base + tms_pack_extract(words, i * width, width);
+}
+
+
+TMS_AVX512_DIAG_POP
+
+#endif // TMS_SIMD_X86
+
+
+// tms_unpack
+// No-Throw Guarantee
+// Pre:
+//      words holds n fields of width bits, plus one readable word past
+//      the last field
+// Post:
+//      out[j] = base + field j (mod 2^64); best kernel allowed by
+//      tms_isa_limit()
+inline void tms_unpack(const std::uint64_t * words, unsigned width,
+                       std::uint64_t base, std::uint64_t * out,
+                       std::size_t n) noexcept
+{
+#ifdef TMS_SIMD_X86
+    const TMSIsa level = tms_isa_limit();
+    if (level >= TMS_ISA_AVX512)
+        return tms_unpack_avx512(words, width, base, out, n);
+    if (level >= TMS_ISA_AVX2)
+        return tms_unpack_avx2(words, width, base, out, n);
+#endif
+    tms_unpack_scalar(words, width, base, out, n);
+}
+
+
+
+// *********************************************************************
+// class TMSPackedArray - Class definition
+// *********************************************************************
+
+
+// class TMSPackedArray
+// Append-only integer array compressed by frame of reference and bit
+//  packing. Values are grouped in blocks of TMS_PACK_BLOCK; a sealed
+//  block stores its minimum (base) and the bit width of max - min, then
+//  every value as (value - base) in that many bits. Element i is one
+//  header lookup and a two-word extract, so access stays O(1). The last,
+//  partly filled block is kept uncompressed in _tail and sealed when it
+//  fills.
+// Requirements on Types:
+//     Valtype is an integral type of at most 64 bits.
+// Invariants:
+//     _blocks.size() == number of sealed blocks; _tail.size() <
+//      TMS_PACK_BLOCK; size() == _blocks.size() * TMS_PACK_BLOCK +
+//      _tail.size().
+//     _used == sum of 2 * width over sealed blocks; _words.size() ==
+//      _used + 2, the last two words a zero pad. Extracts read the word
+//      after a field's first word; a width-0 block holds no words, so
+//      its offset may be _used and that read lands on the second pad.
+template <typename Valtype>
+class TMSPackedArray
+{
+
+    static_assert(std::is_integral<Valtype>::value && sizeof(Valtype) <= 8,
+                  "TMSPackedArray holds integers of at most 64 bits");
+
+public:
+
+
+    using value_type = Valtype;
+
+    using size_type  = std::size_t;
+
+
+private:
+
+
+    // Per-block header
+    struct Block
+    {
+        std::uint64_t base;     // minimum value, as uint64 bits
+        std::uint64_t offset;   // first word in _words
+        unsigned      width;    // bits per value, 0..64
+    };
+
+
+// ***** TMSPackedArray: ctors *****
+public:
+
+
+    // Default ctor
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      empty()
+    TMSPackedArray()
+        :_blocks(0),
+         _words(2),
+         _used(0),
+         _tail(0)
+    {
+        _words[0] = _words[1] = 0;
+    }
+
+
+    // Ctor from plain array
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      holds values, in order
+    explicit TMSPackedArray(const TMSArray<value_type> & values)
+        :TMSPackedArray()
+    {
+        append(values.begin(), values.size());
+    }
+
+
+// ***** TMSPackedArray: general public functions *****
+public:
+
+
+    // size
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns number of values
+    size_type size() const noexcept
+    {
+        return _blocks.size() * TMS_PACK_BLOCK + _tail.size();
+    }
+
+
+    // empty
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns size() == 0
+    bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+
+    // operator[]
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      0 <= index < size()
+    // Post:
+    //      Returns value index (by value: there is no stored object)
+    value_type operator[](size_type index) const noexcept
+    {
+        const size_type b = index / TMS_PACK_BLOCK;
+        const size_type j = index % TMS_PACK_BLOCK;
+        if (b == _blocks.size())
+            return _tail[j];
+        const Block & blk = _blocks[b];
+        return value_type(blk.base + tms_pack_extract(
+            _words.begin() + blk.offset, j * blk.width, blk.width));
+    }
+
+
+    // block_count
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns number of blocks, counting a partly filled last one
+    size_type block_count() const noexcept
+    {
+        return _blocks.size() + (_tail.empty() ? 0 : 1);
+    }
+
+
+    // block_width
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      block < block_count()
+    // Post:
+    //      Returns bits per value in block (full width for the unsealed
+    //      last block)
+    unsigned block_width(size_type block) const noexcept
+    {
+        return block < _blocks.size() ? _blocks[block].width
+                                      : unsigned(8 * sizeof(value_type));
+    }
+
+
+    // memory_bytes
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns bytes of packed data, block headers and tail in use
+    size_type memory_bytes() const noexcept
+    {
+        return _words.size() * sizeof(std::uint64_t)
+               + _blocks.size() * sizeof(Block)
+               + _tail.size() * sizeof(value_type);
+    }
+
+
+    // push_back
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      value appended; a block is sealed when it fills
+    void push_back(value_type value)
+    {
+        _tail.push_back(value);
+        if (_tail.size() == TMS_PACK_BLOCK)
+        {
+            try
+            {
+                seal(_tail.begin());
+            }
+            catch (...)
+            {
+                _tail.pop_back();
+                throw;
+            }
+            _tail.resize(0);
+        }
+    }
+
+
+    // append
+    // Basic Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      [values, values + n) valid
+    // Post:
+    //      values appended, in order; whole blocks are packed straight
+    //      from the source without passing through _tail
+    void append(const value_type * values, size_type n)
+    {
+        size_type i = 0;
+        while (i < n && !_tail.empty())
+            push_back(values[i++]);
+        for (; i + TMS_PACK_BLOCK <= n; i += TMS_PACK_BLOCK)
+            seal(values + i);
+        for (; i < n; ++i)
+            push_back(values[i]);
+    }
+
+
+    // decode_block
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      block < block_count(); out has room for TMS_PACK_BLOCK values
+    // Post:
+    //      Writes block's values to out; returns how many (TMS_PACK_BLOCK
+    //      except for a partly filled last block)
+    size_type decode_block(size_type block, value_type * out) const noexcept
+    {
+        if (block == _blocks.size())
+        {
+            std::copy(_tail.begin(), _tail.end(), out);
+            return _tail.size();
+        }
+        const Block & blk = _blocks[block];
+        const std::uint64_t * src = _words.begin() + blk.offset;
+        if (sizeof(value_type) == sizeof(std::uint64_t))
+            tms_unpack(src, blk.width, blk.base,
+                       reinterpret_cast<std::uint64_t *>(out), TMS_PACK_BLOCK);
+        else
+            for (size_type j = 0; j < TMS_PACK_BLOCK; ++j)
+                out[j] = value_type(blk.base + tms_pack_extract(
+                    src, j * blk.width, blk.width));
+        return TMS_PACK_BLOCK;
+    }
+
+
+    // decode
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      out holds all values, in order. 64-bit value types use the
+    //      SIMD unpack kernels; narrower ones a scalar loop.
+    void decode(TMSArray<value_type> & out) const
+    {
+        out.resize(size());
+        value_type * dst = out.begin();
+        for (size_type b = 0; b < block_count(); ++b)
+            dst += decode_block(b, dst);
+    }
+
+
+// ***** TMSPackedArray: private helpers *****
+private:
+
+
+    // seal
+    // Packs TMS_PACK_BLOCK values as a new sealed block (Strong: all
+    //  allocation happens before any member changes)
+    void seal(const value_type * values)
+    {
+        value_type minV = values[0], maxV = values[0];
+        for (size_type j = 1; j < TMS_PACK_BLOCK; ++j)
+        {
+            minV = std::min(minV, values[j]);
+            maxV = std::max(maxV, values[j]);
+        }
+        const std::uint64_t lo = std::uint64_t(minV);
+        const std::uint64_t range = std::uint64_t(maxV) - lo;
+        const unsigned width = range == 0 ? 0
+                               : unsigned(64 - __builtin_clzll(range));
+        const size_type words = 2 * width;
+
+        _blocks.resize(_blocks.size() + 1);     // may throw: nothing changed
+        try
+        {
+            _words.resize(_used + words + 2);
+        }
+        catch (...)
+        {
+            _blocks.resize(_blocks.size() - 1);
+            throw;
+        }
+        std::uint64_t * dst = _words.begin() + _used;
+        std::fill(dst, dst + words + 2, std::uint64_t(0));
+        for (size_type j = 0; j < TMS_PACK_BLOCK; ++j)
+        {
+            const std::uint64_t d = std::uint64_t(values[j]) - lo;
+            const size_type bit = j * width;
+            const unsigned shift = unsigned(bit % 64);
+            dst[bit / 64] |= d << shift;
+            if (shift + width > 64)
+                dst[bit / 64 + 1] |= d >> (64 - shift);
+        }
+        _blocks[_blocks.size() - 1] = Block{ lo, _used, width };
+        _used += words;
+    }
+
+
+// ***** TMSPackedArray: data members *****
+private:
+
+    TMSArray<Block>         _blocks;
+    TMSArray<std::uint64_t> _words;
+    size_type               _used;      // words holding sealed blocks
+    TMSArray<value_type>    _tail;      // unsealed last block
+
+}; // end of class
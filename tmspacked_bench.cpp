@@ -0,0 +1,111 @@
+// tmspacked_bench.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Benchmark: TMSPackedArray<uint64_t> vs. plain TMSArray<uint64_t> for
+//  columns of 10-, 16- and 20-bit values: memory, full scan (sum) via
+//  block decode at each ISA level, bulk decode, and random access.
+// Usage: tmspacked_bench [values=16777216]
+// Requires tmspacked.hpp, tmssimd.hpp, tmsarray.hpp, tmsbench.hpp
+
+#include "tmspacked.hpp"
+#include "tmsbench.hpp"
+
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::uint64_t;
+#include <iostream>
+using std::cout;
+#include <string>
+using std::string;
+
+
+// benchWidth
+// One table for values of the given bit width
+void benchWidth(size_t n, unsigned bits)
+{
+    TMSArray<uint64_t> plain(n);
+    uint64_t x = 88172645463325252ull;
+    for (size_t i = 0; i < n; ++i)
+    {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        plain[i] = 5000000 + (x & tms_pack_mask(bits));
+    }
+    TMSPackedArray<uint64_t> packed(plain);
+    const size_t plainBytes = n * sizeof(uint64_t);
+
+    cout << "\n== " << n << " values, " << bits << "-bit spread ==\n"
+         << "memory plain  " << plainBytes << " bytes\n"
+         << "memory packed " << packed.memory_bytes() << " bytes ("
+         << double(plainBytes) / double(packed.memory_bytes()) << "x)\n";
+
+    double secs = tms_time_best(5, [&]
+    {
+        uint64_t sum = 0;
+        for (uint64_t v : plain)
+            sum += v;
+        tms_sink(sum);
+    });
+    tms_report("scan plain", secs, plainBytes);
+
+    const TMSIsa best = tms_detect_isa();
+    for (int level = TMS_ISA_SCALAR; level <= best; ++level)
+    {
+        tms_isa_limit() = TMSIsa(level);
+        secs = tms_time_best(5, [&]
+        {
+            uint64_t sum = 0, buf[TMS_PACK_BLOCK];
+            for (size_t b = 0; b < packed.block_count(); ++b)
+            {
+                size_t got = packed.decode_block(b, buf);
+                for (size_t j = 0; j < got; ++j)
+                    sum += buf[j];
+            }
+            tms_sink(sum);
+        });
+        // GB/s of logical (decoded) values delivered
+        tms_report(string("scan packed ") + tms_isa_name(TMSIsa(level)),
+                   secs, plainBytes);
+    }
+    tms_isa_limit() = best;
+
+    TMSArray<uint64_t> out(n);
+    secs = tms_time_best(3, [&]{ packed.decode(out); tms_sink(out[0]); });
+    tms_report("decode into TMSArray", secs, plainBytes);
+
+    const size_t probes = size_t(1) << 22;
+    secs = tms_time_best(3, [&]
+    {
+        uint64_t y = 1, sum = 0;
+        for (size_t k = 0; k < probes; ++k)
+        {
+            y = y * 6364136223846793005ull + 1442695040888963407ull;
+            sum += plain[(y >> 20) % n];
+        }
+        tms_sink(sum);
+    });
+    tms_report("4M random reads plain", secs);
+    secs = tms_time_best(3, [&]
+    {
+        uint64_t y = 1, sum = 0;
+        for (size_t k = 0; k < probes; ++k)
+        {
+            y = y * 6364136223846793005ull + 1442695040888963407ull;
+            sum += packed[(y >> 20) % n];
+        }
+        tms_sink(sum);
+    });
+    tms_report("4M random reads packed", secs);
+}
+
+
+int main(int argc, char * argv[])
+{
+    const size_t n = tms_arg(argc, argv, 1, size_t(1) << 24);
+    for (unsigned bits : { 10u, 16u, 20u })
+        benchWidth(n, bits);
+    return 0;
+}
@@ -0,0 +1,258 @@
+// tmspacked_test.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Test program for class template TMSPackedArray, tms_unpack
+// Uses the "doctest" unit-testing framework, version 2
+// Requires doctest.h, tmspacked.hpp, tmssimd.hpp, tmsarray.hpp
+
+// Includes for code to be tested
+#include "tmspacked.hpp"     // For class template TMSPackedArray
+#include "tmspacked.hpp"     // Double-inclusion check, for testing only
+
+// Includes for the "doctest" unit-testing framework
+#define DOCTEST_CONFIG_IMPLEMENT
+                             // We write our own main
+#define DOCTEST_CONFIG_SUPER_FAST_ASSERTS
+                             // Reduce compile time
+#include "doctest.h"         // For doctest
+
+// Includes for all test programs
+#include <iostream>
+using std::cout;
+using std::endl;
+using std::cin;
+#include <string>
+using std::string;
+
+// Additional includes for this test program
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::int32_t;
+using std::int64_t;
+using std::uint16_t;
+using std::uint64_t;
+#include <algorithm>
+using std::equal;
+#include <limits>
+using std::numeric_limits;
+
+// Printable name for this test suite
+const string test_suite_name =
+    "class template TMSPackedArray";
+
+
+// *********************************************************************
+// Helper Functions for This Test Program
+// *********************************************************************
+
+
+// fillBits
+// Values near offset whose spread needs about bits bits
+template <typename T>
+void fillBits(TMSArray<T> & ta, unsigned bits, T offset, uint64_t seed)
+{
+    uint64_t x = seed * 0x9E3779B97F4A7C15ull + 3;
+    for (size_t i = 0; i < ta.size(); ++i)
+    {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        ta[i] = T(uint64_t(offset) + (x & tms_pack_mask(bits)));
+    }
+}
+
+
+// checkRoundTrip
+// Packed copy of ta reads back element-wise and by decode, at each ISA
+//  level
+template <typename T>
+void checkRoundTrip(const TMSArray<T> & ta)
+{
+    TMSPackedArray<T> tp(ta);
+    REQUIRE( tp.size() == ta.size() );
+    bool allMatch = true;
+    for (size_t i = 0; i < ta.size(); ++i)
+        allMatch = allMatch && tp[i] == ta[i];
+    REQUIRE( allMatch );
+
+    const TMSIsa best = tms_detect_isa();
+    for (int level = TMS_ISA_SCALAR; level <= best; ++level)
+    {
+        INFO( "ISA " << tms_isa_name(TMSIsa(level)) );
+        tms_isa_limit() = TMSIsa(level);
+        TMSArray<T> out;
+        tp.decode(out);
+        REQUIRE( out.size() == ta.size() );
+        REQUIRE( equal(out.begin(), out.end(), ta.begin()) );
+    }
+    tms_isa_limit() = best;
+}
+
+
+// *********************************************************************
+// Test Cases
+// *********************************************************************
+
+
+TEST_CASE( "Round trip at every bit width" )
+{
+    for (unsigned bits = 0; bits <= 64; ++bits)
+    {
+        INFO( "bits " << bits );
+        TMSArray<uint64_t> ta(1000);
+        fillBits<uint64_t>(ta, bits, 12345, bits);
+        checkRoundTrip(ta);
+    }
+}
+
+
+TEST_CASE( "Signed and narrow value types" )
+{
+    SUBCASE( "int64_t spanning zero and the full range" )
+    {
+        TMSArray<int64_t> ta(700);
+        fillBits<int64_t>(ta, 12, -2000, 1);
+        checkRoundTrip(ta);
+        ta[5] = numeric_limits<int64_t>::min();
+        ta[600] = numeric_limits<int64_t>::max();
+        checkRoundTrip(ta);
+    }
+
+    SUBCASE( "int32_t" )
+    {
+        TMSArray<int32_t> ta(513);
+        fillBits<int32_t>(ta, 20, -500000, 2);
+        checkRoundTrip(ta);
+    }
+
+    SUBCASE( "uint16_t" )
+    {
+        TMSArray<uint16_t> ta(300);
+        fillBits<uint16_t>(ta, 9, 100, 3);
+        checkRoundTrip(ta);
+    }
+}
+
+
+TEST_CASE( "Append and blocks" )
+{
+    SUBCASE( "push_back seals full blocks" )
+    {
+        TMSPackedArray<uint64_t> tp;
+        REQUIRE( tp.empty() );
+        REQUIRE( tp.block_count() == 0 );
+        for (uint64_t v = 0; v < 300; ++v)
+            tp.push_back(1000000 + v % 200);
+        REQUIRE( tp.size() == 300 );
+        REQUIRE( tp.block_count() == 3 );
+        REQUIRE( tp.block_width(0) == 7 );      // spread 0..127
+        REQUIRE( tp.block_width(1) == 8 );      // spread 0..199
+        REQUIRE( tp.block_width(2) == 64 );     // unsealed tail
+        REQUIRE( tp[0] == 1000000 );
+        REQUIRE( tp[299] == 1000000 + 299 % 200 );
+        uint64_t out[TMS_PACK_BLOCK];
+        REQUIRE( tp.decode_block(1, out) == TMS_PACK_BLOCK );
+        REQUIRE( out[0] == 1000000 + 128 % 200 );
+        REQUIRE( tp.decode_block(2, out) == 300 - 256 );
+        REQUIRE( out[0] == 1000000 + 256 % 200 );
+    }
+
+    SUBCASE( "append mixes with push_back" )
+    {
+        TMSArray<uint64_t> ta(1000);
+        fillBits<uint64_t>(ta, 17, 7, 9);
+        TMSPackedArray<uint64_t> tp;
+        tp.push_back(ta[0]);
+        tp.push_back(ta[1]);
+        tp.append(ta.begin() + 2, 900);
+        for (size_t i = 902; i < 1000; ++i)
+            tp.push_back(ta[i]);
+        TMSArray<uint64_t> out;
+        tp.decode(out);
+        REQUIRE( equal(out.begin(), out.end(), ta.begin()) );
+    }
+
+    SUBCASE( "Constant blocks take no data words" )
+    {
+        TMSArray<uint64_t> ta(TMS_PACK_BLOCK * 10);
+        for (auto & v : ta)
+            v = 42;
+        TMSPackedArray<uint64_t> tp(ta);
+        REQUIRE( tp.block_width(3) == 0 );
+        REQUIRE( tp[777] == 42 );
+        REQUIRE( tp.memory_bytes() < ta.size() );
+    }
+
+    SUBCASE( "Constant block sealed last after a full-width block" )
+    {
+        // Its offset is the end of the packed words, past the first pad
+        TMSPackedArray<uint64_t> tp;
+        for (size_t i = 0; i < TMS_PACK_BLOCK; ++i)
+            tp.push_back(i % 2 ? ~uint64_t(0) : 0);
+        for (size_t i = 0; i < TMS_PACK_BLOCK; ++i)
+            tp.push_back(7);
+        REQUIRE( tp.block_width(0) == 64 );
+        REQUIRE( tp.block_width(1) == 0 );
+        REQUIRE( tp[130] == 7 );
+        TMSArray<uint64_t> out;
+        tp.decode(out);
+        REQUIRE( out[TMS_PACK_BLOCK - 1] == ~uint64_t(0) );
+        REQUIRE( out[2 * TMS_PACK_BLOCK - 1] == 7 );
+    }
+
+    SUBCASE( "Memory shrinks with the value spread" )
+    {
+        TMSArray<uint64_t> ta(TMS_PACK_BLOCK * 100);
+        fillBits<uint64_t>(ta, 12, 1ull << 40, 4);
+        TMSPackedArray<uint64_t> tp(ta);
+        // 12 of 64 bits, plus headers
+        REQUIRE( tp.memory_bytes() * 4 < ta.size() * sizeof(uint64_t) );
+    }
+}
+
+
+// *********************************************************************
+// Main Program
+// *********************************************************************
+
+
+// userPause
+// Wait for user to press ENTER: read all chars through first newline.
+void userPause()
+{
+    std::cout.flush();
+    while (std::cin.get() != '\n') ;
+}
+
+
+// Main program
+// Run all tests. Prompt for ENTER before exiting.
+int main(int argc,
+         char *argv[])
+{
+    doctest::Context dtcontext;
+                             // Primary doctest object
+    int dtresult;            // doctest return code; for return by main
+
+    // Handle command line
+    dtcontext.applyCommandLine(argc, argv);
+    dtresult = 0;            // doctest flags no command-line errors
+                             //  (strange but true)
+
+    if (!dtresult)           // Continue only if no command-line error
+    {
+        // Run test suites
+        cout << "BEGIN tests for " << test_suite_name << "\n" << endl;
+        dtresult = dtcontext.run();
+        cout << "END tests for " << test_suite_name << "\n" << endl;
+    }
+
+    // Wait for user
+    std::cout << "Press ENTER to quit ";
+    userPause();
+
+    // Program return value is return code from doctest
+    return dtresult;
+}
@@ -0,0 +1,770 @@
+// tmspaged.hpp
+// Matthew Johnson
+// 10/17/2026
+// out-of-core TMSArray: elements in a backing file, a bounded CLOCK
+//  cache of fixed-size pages in memory, dirty write-back, readahead
+
+#pragma once
+// for single inclusion
+
+#include "tmsarray.hpp"
+// For class template TMSArray
+
+#include "tmsserial.hpp"
+// For TMSFileHeader
+// For tms_file_header
+// For tms_check_header
+// For tms_header_crc
+// For tms_throw_errno
+
+#include <cstddef>
+// For std::size_t
+// For std::ptrdiff_t
+
+#include <cstdint>
+// For std::uint32_t
+// For std::uint64_t
+
+#include <cstring>
+// For std::memset
+
+#include <cerrno>
+// For errno
+// For EINTR
+
+#include <string>
+// For std::string
+
+#include <stdexcept>
+// For std::runtime_error
+
+#include <type_traits>
+// For std::is_trivially_copyable
+
+#include <iterator>
+// For std::forward_iterator_tag
+
+#include <algorithm>
+// For std::min
+// For std::max
+// For std::fill
+
+#include <fcntl.h>
+// For open
+// For posix_fadvise
+
+#include <unistd.h>
+// For close
+// For pread
+// For pwrite
+// For ftruncate
+// For fdatasync
+
+#include <sys/stat.h>
+// For fstat
+
+
+
+// Default cache budget and page size, in bytes
+constexpr std::size_t TMS_PAGED_CACHE_BYTES = std::size_t(64) << 20;
+constexpr std::size_t TMS_PAGED_PAGE_BYTES  = std::size_t(64) << 10;
+
+// Sequential scans ask the kernel to read this far ahead
+constexpr std::size_t TMS_PAGED_READAHEAD_BYTES = std::size_t(2) << 20;
+
+// Element data starts one disk page into the file, so pages of a
+//  multiple of 4 KB are block-aligned
+constexpr std::size_t TMS_PAGED_DATA_OFFSET = 4096;
+
+
+
+// *********************************************************************
+// class TMSPagedArray - Class definition
+// *********************************************************************
+
+
+// class TMSPagedArray
+// Array larger than memory. Elements live in a backing file in the
+//  tmsserial.hpp layout (data_crc not maintained: load or view such a
+//  file without verification); page_elements() consecutive elements
+//  form a page, and at most cache_pages() pages are held in memory.
+//  A miss reads the page with one pread into a frame chosen by CLOCK
+//  (second chance: an approximation of LRU that costs one bit per
+//  frame), writing the frame's old page back first if it is dirty.
+//
+// Element access goes through get/set (operator[] gives a value, or a
+//  proxy on a non-const array), so no reference into a frame escapes
+//  to be invalidated by a later eviction; the last page touched is
+//  remembered, so runs of accesses within a page skip the lookup.
+//  for_each_page hands out whole pages for scans, with kernel readahead
+//  of the pages ahead.
+//
+// The page size is a cache parameter, not part of the file format: a
+//  file may be reopened with any page size.
+// Requirements on Types:
+//     Valtype is trivially copyable.
+// Invariants:
+//     _frameOf[p] is the frame holding page p, or NONE;
+//      _frames[f].page is the page in frame f, or NPAGE.
+//     A frame not dirty matches the file (or zeros past its end).
+template <typename Valtype>
+class TMSPagedArray
+{
+
+    static_assert(std::is_trivially_copyable<Valtype>::value,
+                  "TMSPagedArray pages raw bytes");
+
+public:
+
+
+    using value_type = Valtype;
+
+    using size_type  = std::size_t;
+
+
+    // Ref
+    // Proxy for a writable element: reads with get, writes with set
+    class Ref
+    {
+    public:
+
+        Ref(TMSPagedArray & arr, size_type index) noexcept
+            :_arr(arr), _index(index)
+        {}
+
+        Ref(const Ref & other) = default;
+
+        operator value_type() const
+        {
+            return _arr.get(_index);
+        }
+
+        Ref & operator=(const value_type & value)
+        {
+            _arr.set(_index, value);
+            return *this;
+        }
+
+        Ref & operator=(const Ref & other)
+        {
+            _arr.set(_index, value_type(other));
+            return *this;
+        }
+
+    private:
+
+        TMSPagedArray & _arr;
+        size_type       _index;
+
+    };
+
+
+    // const_iterator
+    // Forward iterator over elements; yields values
+    class const_iterator
+    {
+    public:
+
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = Valtype;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const Valtype *;
+        using reference         = Valtype;
+
+        const_iterator() = default;
+
+        const_iterator(const TMSPagedArray * arr, size_type pos) noexcept
+            :_arr(arr), _pos(pos)
+        {}
+
+        reference operator*() const
+        {
+            return _arr->get(_pos);
+        }
+
+        const_iterator & operator++() noexcept
+        {
+            ++_pos;
+            return *this;
+        }
+
+        const_iterator operator++(int) noexcept
+        {
+            const_iterator save = *this;
+            ++_pos;
+            return save;
+        }
+
+        // index
+        // Position of this element in the array
+        size_type index() const noexcept
+        {
+            return _pos;
+        }
+
+        friend bool operator==(const const_iterator & a,
+                               const const_iterator & b) noexcept
+        {
+            return a._pos == b._pos;
+        }
+
+        friend bool operator!=(const const_iterator & a,
+                               const const_iterator & b) noexcept
+        {
+            return a._pos != b._pos;
+        }
+
+    private:
+
+        const TMSPagedArray * _arr = nullptr;
+        size_type             _pos = 0;
+
+    };
+
+    using iterator = const_iterator;
+
+
+// ***** TMSPagedArray: ctors, dctor *****
+public:
+
+
+    // Ctor from path
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Opens the array file at path, creating an empty one if it does
+    //      not exist or is empty. Caches cacheBytes / pageBytes pages (at
+    //      least 2) of pageBytes / sizeof(value_type) elements (at least
+    //      1). Throws std::system_error on I/O errors, std::runtime_error
+    //      if the file is not a matching TMSArray file in native order.
+    explicit TMSPagedArray(const std::string & path,
+                           size_type cacheBytes = TMS_PAGED_CACHE_BYTES,
+                           size_type pageBytes = TMS_PAGED_PAGE_BYTES)
+        :_path(path),
+         _fd(-1),
+         _dataOffset(TMS_PAGED_DATA_OFFSET),
+         _size(0),
+         _pageElems(std::max(size_type(1), pageBytes / sizeof(value_type))),
+         _frames(std::max(size_type(2), cacheBytes / (_pageElems * sizeof(value_type)))),
+         _frameOf(0),
+         _mem(_frames.size() * _pageElems),
+         _hand(0),
+         _hotPage(NPAGE),
+         _hotFrame(0),
+         _hits(0),
+         _misses(0),
+         _writebacks(0)
+    {
+        for (Frame & f : _frames)
+            f = Frame{ NPAGE, false, false };
+        _fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (_fd < 0)
+            tms_throw_errno(path + ": open");
+        try
+        {
+            openFile();
+        }
+        catch (...)
+        {
+            ::close(_fd);
+            throw;
+        }
+    }
+
+
+    // No copying: a paged array owns its file and cache
+    TMSPagedArray(const TMSPagedArray &) = delete;
+    TMSPagedArray & operator=(const TMSPagedArray &) = delete;
+
+
+    // Dctor
+    // No-Throw Guarantee
+    // Pre: None
+    // Post:
+    //      Dirty pages and header written (errors ignored; call flush()
+    //      to see them), file closed
+    ~TMSPagedArray()
+    {
+        try
+        {
+            writeDirty();
+            writeHeader();
+        }
+        catch (...)
+        {}
+        ::close(_fd);
+    }
+
+
+// ***** TMSPagedArray: general public operators *****
+public:
+
+
+    // operator[]
+    // Basic Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      0 <= index < size()
+    // Post:
+    //      Returns element index (const), or a proxy that reads and
+    //      writes it. Throws std::system_error if a page cannot be read
+    //      or an evicted one written.
+    value_type operator[](size_type index) const
+    {
+        return get(index);
+    }
+    Ref operator[](size_type index) noexcept
+    {
+        return Ref(*this, index);
+    }
+
+
+// ***** TMSPagedArray: general public functions *****
+public:
+
+
+    // size
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns number of elements
+    size_type size() const noexcept
+    {
+        return _size;
+    }
+
+
+    // empty
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns size() == 0
+    bool empty() const noexcept
+    {
+        return _size == 0;
+    }
+
+
+    // page_elements, page_count, cache_pages
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns elements per page; pages spanned by the array; frames
+    //      in the cache
+    size_type page_elements() const noexcept
+    {
+        return _pageElems;
+    }
+    size_type page_count() const noexcept
+    {
+        return _frameOf.size();
+    }
+    size_type cache_pages() const noexcept
+    {
+        return _frames.size();
+    }
+
+
+    // hits, misses, writebacks
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns page lookups served from the cache; pages read;
+    //      dirty pages written, so far
+    std::uint64_t hits() const noexcept
+    {
+        return _hits;
+    }
+    std::uint64_t misses() const noexcept
+    {
+        return _misses;
+    }
+    std::uint64_t writebacks() const noexcept
+    {
+        return _writebacks;
+    }
+
+
+    // get
+    // Basic Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      0 <= index < size()
+    // Post:
+    //      Returns element index, faulting its page in if needed
+    value_type get(size_type index) const
+    {
+        const size_type page = index / _pageElems;
+        const size_type f = page == _hotPage ? _hotFrame : fault(page);
+        return _mem[f * _pageElems + index % _pageElems];
+    }
+
+
+    // set
+    // Basic Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      0 <= index < size()
+    // Post:
+    //      Element index == value; its page is dirty
+    void set(size_type index, const value_type & value)
+    {
+        const size_type page = index / _pageElems;
+        const size_type f = page == _hotPage ? _hotFrame : fault(page);
+        _frames[f].dirty = true;
+        _mem[f * _pageElems + index % _pageElems] = value;
+    }
+
+
+    // begin, end
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns iterator to first element; iterator past the last
+    const_iterator begin() const noexcept
+    {
+        return const_iterator(this, 0);
+    }
+    const_iterator end() const noexcept
+    {
+        return const_iterator(this, _size);
+    }
+
+
+    // resize
+    // Basic Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      size() == newsize; new elements are zero. Shrinking drops
+    //      cached pages past the new end unwritten and truncates the file
+    //      (with its header) at once, so regrowing cannot expose old data.
+    void resize(size_type newsize)
+    {
+        const size_type pages = (newsize + _pageElems - 1) / _pageElems;
+        const size_type oldPages = _frameOf.size();
+        if (newsize < _size)
+        {
+            for (size_type p = pages; p < oldPages; ++p)
+                if (_frameOf[p] != NONE)
+                    _frames[_frameOf[p]] = Frame{ NPAGE, false, false };
+            // Zero the rest of the new last page in the cache
+            if (newsize % _pageElems != 0)
+            {
+                const size_type f = fault(pages - 1);
+                _frames[f].dirty = true;
+                std::fill(&_mem[f * _pageElems + newsize % _pageElems],
+                          &_mem[f * _pageElems] + _pageElems, value_type());
+            }
+            _hotPage = NPAGE;
+            _frameOf.resize(pages);
+            _size = newsize;
+            writeHeader();
+            return;
+        }
+        _frameOf.resize(pages);
+        for (size_type p = oldPages; p < pages; ++p)
+            _frameOf[p] = NONE;
+        _size = newsize;
+    }
+
+
+    // push_back
+    // Basic Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      item appended
+    void push_back(const value_type & item)
+    {
+        if (_size % _pageElems == 0)
+            _frameOf.push_back(NONE);
+        ++_size;
+        set(_size - 1, item);
+    }
+
+
+    // for_each_page
+    // Basic Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      first <= last <= size()
+    //      func callable as func(const value_type * data, begin, end)
+    // Post:
+    //      func called once per page overlapping [first, last), in order,
+    //      with data[0] the element at begin and [begin, end) the part of
+    //      the page in range. data is valid only during the call. The
+    //      kernel is asked to read ahead TMS_PAGED_READAHEAD_BYTES.
+    template <typename Func>
+    void for_each_page(size_type first, size_type last, Func && func) const
+    {
+        scanPages(first, last, false,
+            [&](value_type * data, size_type b, size_type e)
+            {
+                func(static_cast<const value_type *>(data), b, e);
+            });
+    }
+
+
+    // update_pages
+    // Basic Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      first <= last <= size()
+    //      func callable as func(value_type * data, begin, end)
+    // Post:
+    //      As for_each_page, but func may modify the elements; each page
+    //      visited is marked dirty
+    template <typename Func>
+    void update_pages(size_type first, size_type last, Func && func)
+    {
+        scanPages(first, last, true, func);
+    }
+
+
+    // flush
+    // Basic Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Dirty pages written, file sized to the array, header updated,
+    //      all synced. Throws std::system_error on failure.
+    void flush()
+    {
+        writeDirty();
+        writeHeader();
+        if (::fdatasync(_fd) != 0)
+            tms_throw_errno(_path + ": fdatasync");
+    }
+
+
+// ***** TMSPagedArray: private types and constants *****
+private:
+
+    static constexpr std::uint32_t NONE  = std::uint32_t(-1);
+    static constexpr size_type     NPAGE = size_type(-1);
+
+    struct Frame
+    {
+        size_type page;
+        bool      dirty;
+        bool      ref;              // CLOCK reference bit
+    };
+
+
+// ***** TMSPagedArray: private helper functions *****
+private:
+
+
+    // openFile
+    void openFile()
+    {
+        struct stat st;
+        if (::fstat(_fd, &st) != 0)
+            tms_throw_errno(_path + ": stat");
+        if (st.st_size == 0)
+        {
+            writeHeader();
+            return;
+        }
+        TMSFileHeader h;
+        if (std::uint64_t(st.st_size) >= sizeof h)
+            tms_pread_all(_fd, &h, sizeof h, 0, _path);
+        if (tms_check_header<value_type>(h, std::uint64_t(st.st_size), _path))
+            throw std::runtime_error(_path + ": opposite byte order; "
+                                     "use tms_load to convert");
+        _dataOffset = size_type(h.data_offset);
+        resize(size_type(h.count));
+    }
+
+
+    // writeHeader
+    // Sizes the file to the array and stores the header
+    void writeHeader()
+    {
+        TMSFileHeader h = tms_file_header<value_type>(_size, 0);
+        h.data_offset = _dataOffset;
+        h.header_crc = tms_header_crc(h);
+        if (::ftruncate(_fd, off_t(_dataOffset + _size * sizeof(value_type))) != 0)
+            tms_throw_errno(_path + ": ftruncate");
+        if (::pwrite(_fd, &h, sizeof h, 0) != ssize_t(sizeof h))
+            tms_throw_errno(_path + ": write header");
+    }
+
+
+    // pageOffset, pageBytes
+    // File position and length of page p's elements
+    size_type pageOffset(size_type page) const noexcept
+    {
+        return _dataOffset + page * _pageElems * sizeof(value_type);
+    }
+    size_type pageBytes(size_type page) const noexcept
+    {
+        return (std::min(_size, (page + 1) * _pageElems) - page * _pageElems)
+               * sizeof(value_type);
+    }
+
+
+    // writeBack
+    // Writes frame f's page to the file
+    void writeBack(size_type f) const
+    {
+        const size_type page = _frames[f].page;
+        const unsigned char * p = reinterpret_cast<const unsigned char *>(
+            &_mem[f * _pageElems]);
+        size_type n = pageBytes(page);
+        size_type off = pageOffset(page);
+        while (n > 0)
+        {
+            const ssize_t got = ::pwrite(_fd, p, n, off_t(off));
+            if (got < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                tms_throw_errno(_path + ": write");
+            }
+            p += got;
+            n -= size_type(got);
+            off += size_type(got);
+        }
+        _frames[f].dirty = false;
+        ++_writebacks;
+    }
+
+
+    // readPage
+    // Reads page into frame f; bytes past the end of the file read as 0
+    void readPage(size_type page, size_type f) const
+    {
+        unsigned char * p = reinterpret_cast<unsigned char *>(&_mem[f * _pageElems]);
+        const size_type want = _pageElems * sizeof(value_type);
+        size_type n = 0;
+        const size_type avail = pageBytes(page);
+        while (n < avail)
+        {
+            const ssize_t got = ::pread(_fd, p + n, avail - n,
+                                        off_t(pageOffset(page) + n));
+            if (got < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                tms_throw_errno(_path + ": read");
+            }
+            if (got == 0)
+                break;
+            n += size_type(got);
+        }
+        std::memset(p + n, 0, want - n);
+    }
+
+
+    // fault
+    // Frame holding page, reading it in (and evicting) on a miss
+    size_type fault(size_type page) const
+    {
+        std::uint32_t f = _frameOf[page];
+        if (f != NONE)
+        {
+            ++_hits;
+            _frames[f].ref = true;
+        }
+        else
+        {
+            ++_misses;
+            // CLOCK: skip (and clear) referenced frames
+            while (_frames[_hand].page != NPAGE && _frames[_hand].ref)
+            {
+                _frames[_hand].ref = false;
+                _hand = (_hand + 1) % _frames.size();
+            }
+            f = std::uint32_t(_hand);
+            Frame & fr = _frames[f];
+            if (fr.page != NPAGE)
+            {
+                if (fr.dirty)
+                    writeBack(f);
+                // The victim may be the hot page; if readPage throws, the
+                //  fast path must not lead into this frame
+                if (fr.page == _hotPage)
+                    _hotPage = NPAGE;
+                _frameOf[fr.page] = NONE;
+                fr.page = NPAGE;
+            }
+            readPage(page, f);
+            fr = Frame{ page, false, true };
+            _frameOf[page] = f;
+            _hand = (_hand + 1) % _frames.size();
+        }
+        _hotPage = page;
+        _hotFrame = f;
+        return f;
+    }
+
+
+    // writeDirty
+    // Writes every dirty frame
+    void writeDirty()
+    {
+        for (size_type f = 0; f < _frames.size(); ++f)
+            if (_frames[f].page != NPAGE && _frames[f].dirty)
+                writeBack(f);
+    }
+
+
+    // scanPages
+    // Page-at-a-time loop for for_each_page and update_pages
+    template <typename Func>
+    void scanPages(size_type first, size_type last, bool dirty, Func && func) const
+    {
+        if (first >= last)
+            return;
+        const size_type ahead = std::max(size_type(1),
+            TMS_PAGED_READAHEAD_BYTES / (_pageElems * sizeof(value_type)));
+        const size_type lastPage = (last - 1) / _pageElems;
+        size_type begin = first;
+        for (size_type page = first / _pageElems; page <= lastPage; ++page)
+        {
+            // One hint per window, covering the window after this one
+            if ((page - first / _pageElems) % ahead == 0 && page + 1 <= lastPage)
+            {
+                const size_type from = page + 1;
+                const size_type to = std::min(lastPage + 1, from + ahead);
+                ::posix_fadvise(_fd, off_t(pageOffset(from)),
+                                off_t(pageOffset(to) - pageOffset(from)),
+                                POSIX_FADV_WILLNEED);
+            }
+            const size_type f = fault(page);
+            if (dirty)
+                _frames[f].dirty = true;
+            const size_type end = std::min(last, (page + 1) * _pageElems);
+            func(&_mem[f * _pageElems + begin % _pageElems], begin, end);
+            begin = end;
+        }
+    }
+
+
+// ***** TMSPagedArray: data members *****
+private:
+
+    std::string                     _path;
+    int                             _fd;
+    size_type                       _dataOffset;
+    size_type                       _size;
+    size_type                       _pageElems;
+    mutable TMSArray<Frame>         _frames;
+    mutable TMSArray<std::uint32_t> _frameOf;     // page -> frame
+    mutable TMSArray<value_type>    _mem;         // frames' elements
+    mutable size_type               _hand;        // CLOCK hand
+    mutable size_type               _hotPage;     // last page touched
+    mutable size_type               _hotFrame;
+    mutable std::uint64_t           _hits;
+    mutable std::uint64_t           _misses;
+    mutable std::uint64_t           _writebacks;
+
+}; // end of class
@@ -0,0 +1,135 @@
+// tmspaged_bench.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Benchmark: TMSPagedArray<uint64_t> with a fixed page cache, datasets
+//  of 2x and 10x the cache. Random get and random set (dirty write-back)
+//  with 4 KB and default 64 KB pages, sequential iterator and
+//  for_each_page scans, against an in-memory TMSArray of the same size.
+// Usage: tmspaged_bench [cache_bytes=33554432] [file=/tmp/tmspaged_bench]
+// Requires tmspaged.hpp, tmsserial.hpp, tmscrc32.hpp, tmssimd.hpp,
+//  tmsarray.hpp, tmsbench.hpp
+
+#include "tmspaged.hpp"
+#include "tmsbench.hpp"
+
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::uint64_t;
+#include <cstdio>
+using std::remove;
+#include <iostream>
+using std::cout;
+#include <string>
+using std::string;
+using std::to_string;
+
+
+int main(int argc, char * argv[])
+{
+    const size_t cacheBytes = tms_arg(argc, argv, 1, size_t(32) << 20);
+    const string path = argc > 2 ? argv[2] : "/tmp/tmspaged_bench";
+    const size_t probes = size_t(1) << 18;
+
+    for (size_t factor : { 2, 10 })
+    {
+        const size_t n = factor * cacheBytes / sizeof(uint64_t);
+        cout << "\n== dataset " << factor << "x cache ("
+             << (n * sizeof(uint64_t) >> 20) << " MB, cache "
+             << (cacheBytes >> 20) << " MB, pages "
+             << (TMS_PAGED_PAGE_BYTES >> 10) << " KB) ==\n";
+        remove(path.c_str());
+
+        TMSArray<uint64_t> mem(n);
+        for (size_t i = 0; i < n; ++i)
+            mem[i] = i;
+        double secs = tms_time_best(1, [&]
+        {
+            TMSPagedArray<uint64_t> paged(path, cacheBytes);
+            paged.resize(n);
+            paged.update_pages(0, n, [](uint64_t * data, size_t b, size_t e)
+            {
+                for (size_t i = b; i < e; ++i)
+                    data[i - b] = i;
+            });
+            paged.flush();
+        });
+        tms_report("fill + flush", secs, n * sizeof(uint64_t));
+
+        auto randomGet = [&](auto & arr)
+        {
+            uint64_t y = 1;
+            uint64_t sum = 0;
+            for (size_t k = 0; k < probes; ++k)
+            {
+                y = y * 6364136223846793005ull + 1442695040888963407ull;
+                sum += arr[(y >> 20) % n];
+            }
+            tms_sink(sum);
+        };
+        secs = tms_time_best(3, [&]{ randomGet(mem); });
+        tms_report("256K random get TMSArray", secs);
+
+        // Random access by page size: the same file through small pages
+        //  moves 16x less per miss
+        for (size_t pageBytes : { size_t(4) << 10, TMS_PAGED_PAGE_BYTES })
+        {
+            TMSPagedArray<uint64_t> arr(path, cacheBytes, pageBytes);
+            const string tag = " (" + to_string(pageBytes >> 10) + " KB pages)";
+            const size_t missBefore = arr.misses();
+            secs = tms_time_best(3, [&]{ randomGet(arr); });
+            tms_report("256K random get" + tag, secs);
+            cout << "    miss rate "
+                 << double(arr.misses() - missBefore) / double(3 * probes)
+                 << "\n";
+
+            secs = tms_time_best(3, [&]
+            {
+                uint64_t y = 7;
+                for (size_t k = 0; k < probes; ++k)
+                {
+                    y = y * 6364136223846793005ull + 1442695040888963407ull;
+                    arr.set((y >> 20) % n, k);
+                }
+                arr.flush();
+            });
+            tms_report("256K random set + flush" + tag, secs);
+        }
+
+        TMSPagedArray<uint64_t> paged(path, cacheBytes);
+        secs = tms_time_best(3, [&]
+        {
+            uint64_t sum = 0;
+            for (uint64_t v : mem)
+                sum += v;
+            tms_sink(sum);
+        });
+        tms_report("scan TMSArray", secs, n * sizeof(uint64_t));
+
+        secs = tms_time_best(3, [&]
+        {
+            uint64_t sum = 0;
+            for (uint64_t v : paged)
+                sum += v;
+            tms_sink(sum);
+        });
+        tms_report("scan iterator", secs, n * sizeof(uint64_t));
+
+        secs = tms_time_best(3, [&]
+        {
+            uint64_t sum = 0;
+            paged.for_each_page(0, n,
+                [&](const uint64_t * data, size_t b, size_t e)
+                {
+                    for (size_t i = 0; i < e - b; ++i)
+                        sum += data[i];
+                });
+            tms_sink(sum);
+        });
+        tms_report("scan for_each_page", secs, n * sizeof(uint64_t));
+    }
+
+    remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,346 @@
+// tmspaged_test.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Test program for class template TMSPagedArray
+// Uses the "doctest" unit-testing framework, version 2
+// Requires doctest.h, tmspaged.hpp, tmsserial.hpp, tmscrc32.hpp,
+//  tmssimd.hpp, tmsarray.hpp
+
+// Includes for code to be tested
+#include "tmspaged.hpp"      // For class template TMSPagedArray
+#include "tmspaged.hpp"      // Double-inclusion check, for testing only
+
+// Includes for the "doctest" unit-testing framework
+#define DOCTEST_CONFIG_IMPLEMENT
+                             // We write our own main
+#define DOCTEST_CONFIG_SUPER_FAST_ASSERTS
+                             // Reduce compile time
+#include "doctest.h"         // For doctest
+
+// Includes for all test programs
+#include <iostream>
+using std::cout;
+using std::endl;
+using std::cin;
+#include <string>
+using std::string;
+
+// Additional includes for this test program
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::int64_t;
+using std::uint64_t;
+#include <cstdio>
+using std::remove;
+#include <stdexcept>
+using std::runtime_error;
+#include <system_error>
+using std::system_error;
+#include <unistd.h>          // For getpid, readlink, dup, dup2, close
+#include <fcntl.h>           // For open
+
+// Printable name for this test suite
+const string test_suite_name =
+    "class template TMSPagedArray";
+
+
+// *********************************************************************
+// Helper Functions for This Test Program
+// *********************************************************************
+
+
+// tempPath
+// A per-process scratch file name under /tmp, removed first
+string tempPath(const string & tag)
+{
+    string path = "/tmp/tmspaged_test_" + std::to_string(getpid()) + "_" + tag;
+    remove(path.c_str());
+    return path;
+}
+
+
+// fdOf
+// This process's descriptor open on path, or -1
+int fdOf(const string & path)
+{
+    for (int fd = 0; fd < 1024; ++fd)
+    {
+        char link[4096];
+        const string proc = "/proc/self/fd/" + std::to_string(fd);
+        const ssize_t n = ::readlink(proc.c_str(), link, sizeof link);
+        if (n > 0 && string(link, size_t(n)) == path)
+            return fd;
+    }
+    return -1;
+}
+
+
+// value
+// Test value for index i
+int64_t value(size_t i)
+{
+    return int64_t(i * 2654435761u % 1000003);
+}
+
+
+// *********************************************************************
+// Test Cases
+// *********************************************************************
+
+
+TEST_CASE( "Geometry" )
+{
+    const string path = tempPath("geom");
+    TMSPagedArray<int64_t> tp(path, 4096 * 8, 4096);
+    REQUIRE( tp.empty() );
+    REQUIRE( tp.page_elements() == 512 );
+    REQUIRE( tp.cache_pages() == 8 );
+    REQUIRE( tp.page_count() == 0 );
+    tp.resize(513);
+    REQUIRE( tp.size() == 513 );
+    REQUIRE( tp.page_count() == 2 );
+    REQUIRE( tp[512] == 0 );
+
+    TMSPagedArray<int64_t> tiny(tempPath("tiny"), 1, 1);
+    REQUIRE( tiny.page_elements() == 1 );
+    REQUIRE( tiny.cache_pages() == 2 );
+    remove(path.c_str());
+    remove(tempPath("tiny").c_str());
+}
+
+
+TEST_CASE( "Larger than the cache" )
+{
+    const string path = tempPath("big");
+    const size_t n = 100000;                  // 800 KB through a 32 KB cache
+    {
+        TMSPagedArray<int64_t> tp(path, 32 << 10, 4 << 10);
+        for (size_t i = 0; i < n; ++i)
+            tp.push_back(value(i));
+        REQUIRE( tp.size() == n );
+        REQUIRE( tp.writebacks() > 0 );
+        for (size_t i = 0; i < n; ++i)
+            REQUIRE( tp[i] == value(i) );
+
+        // Random writes, then random reads
+        uint64_t x = 1;
+        for (size_t k = 0; k < 20000; ++k)
+        {
+            x = x * 6364136223846793005ull + 1442695040888963407ull;
+            const size_t i = (x >> 20) % n;
+            tp[i] = -value(i);
+        }
+        x = 1;
+        for (size_t k = 0; k < 20000; ++k)
+        {
+            x = x * 6364136223846793005ull + 1442695040888963407ull;
+            const size_t i = (x >> 20) % n;
+            REQUIRE( tp[i] == -value(i) );
+        }
+        REQUIRE( tp.misses() > tp.page_count() );
+    }
+    // Reopened with another page size
+    TMSPagedArray<int64_t> tp(path, 64 << 10, 12000);
+    REQUIRE( tp.size() == n );
+    REQUIRE( tp.page_elements() == 1500 );
+    uint64_t x = 1;
+    for (size_t k = 0; k < 20000; ++k)
+    {
+        x = x * 6364136223846793005ull + 1442695040888963407ull;
+        const size_t i = (x >> 20) % n;
+        REQUIRE( tp[i] == -value(i) );
+    }
+    remove(path.c_str());
+}
+
+
+TEST_CASE( "Page scans" )
+{
+    const string path = tempPath("scan");
+    TMSPagedArray<int64_t> tp(path, 16 << 10, 1 << 10);
+    for (size_t i = 0; i < 10000; ++i)
+        tp.push_back(int64_t(i));
+
+    int64_t sum = 0;
+    size_t calls = 0;
+    size_t next = 1000;
+    tp.for_each_page(1000, 9001,
+        [&](const int64_t * data, size_t b, size_t e)
+        {
+            REQUIRE( b == next );
+            REQUIRE( data[0] == int64_t(b) );
+            for (size_t i = b; i < e; ++i)
+                sum += data[i - b];
+            next = e;
+            ++calls;
+        });
+    REQUIRE( next == 9001 );
+    REQUIRE( sum == (1000 + 9000) * 8001 / 2 );
+    REQUIRE( calls == 9001 / 128 - 1000 / 128 + 1 );
+
+    tp.update_pages(0, 10000,
+        [](int64_t * data, size_t b, size_t e)
+        {
+            for (size_t i = b; i < e; ++i)
+                data[i - b] *= 2;
+        });
+    size_t i = 0;
+    for (int64_t v : tp)
+        REQUIRE( v == int64_t(2 * i++) );
+    REQUIRE( i == 10000 );
+
+    tp.for_each_page(5, 5, [](const int64_t *, size_t, size_t) { REQUIRE( false ); });
+    remove(path.c_str());
+}
+
+
+TEST_CASE( "Flush writes a loadable file" )
+{
+    const string path = tempPath("flush");
+    TMSPagedArray<int> tp(path, 8 << 10, 1 << 10);
+    for (int i = 0; i < 5000; ++i)
+        tp.push_back(i * 3);
+    tp.flush();
+    TMSArray<int> ta;
+    tms_load(path, ta, false);
+    REQUIRE( ta.size() == 5000 );
+    REQUIRE( ta[4999] == 4999 * 3 );
+    TMSArrayView<int> tv(path, false);
+    REQUIRE( tv[1234] == 1234 * 3 );
+    remove(path.c_str());
+}
+
+
+TEST_CASE( "A failed page read does not leave a stale hot page" )
+{
+    const string path = tempPath("readfail");
+    TMSArray<int> ta(static_cast<size_t>(3 * 256));
+    for (size_t i = 0; i < ta.size(); ++i)
+        ta[i] = int(i);
+    tms_save(ta, path);
+    {
+        // Two frames of one 256-int page each
+        TMSPagedArray<int> tp(path, 2 << 10, 1 << 10);
+        REQUIRE( tp.get(0) == 0 );
+        REQUIRE( tp.get(256) == 256 );
+        REQUIRE( tp.get(1) == 1 );      // page 0 hot, and next victim
+
+        // Reading page 2 evicts page 0, then fails: the file descriptor
+        //  is swapped for a directory's
+        const int fd = fdOf(path);
+        REQUIRE( fd >= 0 );
+        const int saved = ::dup(fd);
+        const int dir = ::open("/tmp", O_RDONLY | O_DIRECTORY);
+        REQUIRE( ::dup2(dir, fd) == fd );
+        REQUIRE_THROWS_AS( tp.get(512), system_error );
+        REQUIRE( ::dup2(saved, fd) == fd );
+        ::close(saved);
+        ::close(dir);
+
+        tp.set(2, -7);                  // page 0 again: must fault it in
+        REQUIRE( tp.get(3) == 3 );
+        tp.flush();
+    }
+    tms_load(path, ta, false);
+    REQUIRE( ta[2] == -7 );
+    REQUIRE( ta[3] == 3 );
+    REQUIRE( ta[600] == 600 );
+    remove(path.c_str());
+}
+
+
+TEST_CASE( "Shrink and regrow read zeros" )
+{
+    const string path = tempPath("shrink");
+    {
+        TMSPagedArray<int> tp(path, 8 << 10, 1 << 10);
+        for (int i = 0; i < 3000; ++i)
+            tp.push_back(i + 1);
+        tp.flush();
+        tp.resize(1000);
+        REQUIRE( tp.size() == 1000 );
+        REQUIRE( tp[999] == 1000 );
+        tp.resize(3000);
+        for (size_t i = 1000; i < 3000; ++i)
+            REQUIRE( tp[i] == 0 );
+        tp.resize(10);
+    }
+    TMSPagedArray<int> tp(path);
+    REQUIRE( tp.size() == 10 );
+    REQUIRE( tp[9] == 10 );
+    remove(path.c_str());
+}
+
+
+TEST_CASE( "Proxy references" )
+{
+    const string path = tempPath("proxy");
+    TMSPagedArray<double> tp(path, 8 << 10, 512);
+    tp.resize(1000);
+    tp[0] = 1.5;
+    tp[999] = tp[0];
+    const double d = tp[999];
+    REQUIRE( d == 1.5 );
+    tp.set(500, 2.5);
+    REQUIRE( tp.get(500) == 2.5 );
+    const TMSPagedArray<double> & ctp = tp;
+    REQUIRE( ctp[500] == 2.5 );
+    remove(path.c_str());
+}
+
+
+TEST_CASE( "Rejects a file of another type" )
+{
+    const string path = tempPath("type");
+    TMSArray<float> ta(10);
+    tms_save(ta, path);
+    REQUIRE_THROWS_AS( TMSPagedArray<int>(path, 1 << 20), runtime_error );
+    remove(path.c_str());
+}
+
+
+// *********************************************************************
+// Main Program
+// *********************************************************************
+
+
+// userPause
+// Wait for user to press ENTER: read all chars through first newline.
+void userPause()
+{
+    std::cout.flush();
+    while (std::cin.get() != '\n') ;
+}
+
+
+// Main program
+// Run all tests. Prompt for ENTER before exiting.
+int main(int argc,
+         char *argv[])
+{
+    doctest::Context dtcontext;
+                             // Primary doctest object
+    int dtresult;            // doctest return code; for return by main
+
+    // Handle command line
+    dtcontext.applyCommandLine(argc, argv);
+    dtresult = 0;            // doctest flags no command-line errors
+                             //  (strange but true)
+
+    if (!dtresult)           // Continue only if no command-line error
+    {
+        // Run test suites
+        cout << "BEGIN tests for " << test_suite_name << "\n" << endl;
+        dtresult = dtcontext.run();
+        cout << "END tests for " << test_suite_name << "\n" << endl;
+    }
+
+    // Wait for user
+    std::cout << "Press ENTER to quit ";
+    userPause();
+
+    // Program return value is return code from doctest
+    return dtresult;
+}
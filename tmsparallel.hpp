@@ -0,0 +1,447 @@
+// tmsparallel.hpp
+// Matthew Johnson
+// 10/17/2026
+// static-scheduled thread pool and parallel first-touch construction/copy
+//  for TMSArray
+
+#pragma once
+// for single inclusion
+
+#include "tmsarray.hpp"
+// For class template TMSArray
+
+#include <cstddef>
+// For std::size_t
+
+#include <cstdint>
+// For std::uintptr_t
+
+#include <algorithm>
+// For std::min
+// For std::copy
+// For std::fill
+
+#include <utility>
+// For std::pair
+
+#include <thread>
+// For std::thread
+
+#include <mutex>
+// For std::mutex
+// For std::unique_lock
+// For std::lock_guard
+
+#include <condition_variable>
+// For std::condition_variable
+
+#include <exception>
+// For std::exception_ptr
+// For std::current_exception
+// For std::rethrow_exception
+
+#include <vector>
+// For std::vector
+
+#include <type_traits>
+// For std::remove_reference
+
+
+
+// Arrays smaller than this many bytes are built/copied on the calling
+// thread; thread startup costs more than it saves below this point.
+constexpr std::size_t TMS_PARALLEL_THRESHOLD = std::size_t(1) << 22;
+
+// Page-aligned chunk boundaries fall on multiples of this many bytes in
+// memory (tms_page_elems with tms_page_offset), so that no page is
+// first-touched by two different threads. Exact when sizeof the element
+// divides it; larger or odd-sized elements may straddle a boundary.
+constexpr std::size_t TMS_PAGE_BYTES = 4096;
+
+
+
+// *********************************************************************
+// class TMSThreadPool - Class definition
+// *********************************************************************
+
+
+// class TMSThreadPool
+// Fixed set of worker threads with static scheduling: run(f) calls
+//  f(tid, count) exactly once for each tid in [0, count). The calling
+//  thread executes tid 0, worker k executes tid k, every time. So data
+//  first-touched by tid k in one run is scanned by the same thread in
+//  the next run -- which is what places pages on the right NUMA node.
+// Invariants:
+//     _workers.size() == _count - 1.
+//     _task/_invoke are non-null only while a run is in progress.
+class TMSThreadPool
+{
+
+public:
+
+
+    using size_type = std::size_t;
+
+
+// ***** TMSThreadPool: ctors, dctor *****
+public:
+
+
+    // Ctor from thread count
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      threadcount == 0 means one thread per hardware thread
+    //      size() threads (including the caller) take part in run()
+    explicit TMSThreadPool(size_type threadcount = 0)
+        :_count(threadcount != 0 ? threadcount
+                    : std::max(size_type(std::thread::hardware_concurrency()),
+                               size_type(1))),
+         _generation(0),
+         _pending(0),
+         _stop(false),
+         _task(nullptr),
+         _invoke(nullptr)
+    {
+        try
+        {
+            for (size_type tid = 1; tid < _count; ++tid)
+                _workers.emplace_back(&TMSThreadPool::workerLoop, this, tid);
+        }
+        catch(...)
+        {
+            shutdown(); // join whatever did start before rethrowing
+            throw;
+        }
+    }
+
+
+    // No copy/move: workers hold a pointer to *this
+    TMSThreadPool(const TMSThreadPool & other) = delete;
+    TMSThreadPool & operator=(const TMSThreadPool & other) = delete;
+
+
+    // Dctor
+    // No-Throw Guarantee
+    // Pre: None
+    // Post:
+    //      all workers joined
+    ~TMSThreadPool()
+    {
+        shutdown();
+    }
+
+
+// ***** TMSThreadPool: general public functions *****
+public:
+
+
+    // size
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns number of participating threads
+    size_type size() const noexcept
+    {
+        return _count;
+    }
+
+
+    // run
+    // Basic Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      func callable as func(size_type tid, size_type count)
+    //      func must not call run on this pool
+    // Post:
+    //      func has returned on every tid
+    //      if any call threw, the first exception caught is rethrown
+    template <typename Func>
+    void run(Func && func)
+    {
+        std::lock_guard<std::mutex> runLock(_runMutex); // one run at a time
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _task = &func;
+            _invoke = &invokeTask<Func>;
+            _error = nullptr;
+            _pending = _count - 1;
+            ++_generation;
+        }
+        _wake.notify_all();
+
+        try
+        {
+            func(size_type(0), _count);
+        }
+        catch(...)
+        {
+            recordError();
+        }
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        _done.wait(lock, [this]{ return _pending == 0; });
+        _task = nullptr;
+        _invoke = nullptr;
+
+        if (_error)
+        {
+            std::exception_ptr err = _error;
+            _error = nullptr;
+            std::rethrow_exception(err);
+        }
+    }
+
+
+// ***** TMSThreadPool: internal functions *****
+private:
+
+
+    template <typename Func>
+    static void invokeTask(void * task, size_type tid, size_type count)
+    {
+        (*static_cast<typename std::remove_reference<Func>::type *>(task))(
+            tid, count);
+    }
+
+
+    void recordError() noexcept
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_error)
+            _error = std::current_exception();
+    }
+
+
+    void workerLoop(size_type tid)
+    {
+        size_type seen = 0;
+        while (true)
+        {
+            void * task;
+            void (*invoke)(void *, size_type, size_type);
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _wake.wait(lock, [&]{ return _stop || _generation != seen; });
+                if (_stop)
+                    return;
+                seen = _generation;
+                task = _task;
+                invoke = _invoke;
+            }
+
+            try
+            {
+                invoke(task, tid, _count);
+            }
+            catch(...)
+            {
+                recordError();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                --_pending;
+            }
+            _done.notify_one();
+        }
+    }
+
+
+    void shutdown() noexcept
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _wake.notify_all();
+        for (auto & worker : _workers)
+            worker.join();
+        _workers.clear();
+    }
+
+
+// ***** TMSThreadPool: data members *****
+private:
+
+    size_type                _count;
+    std::vector<std::thread> _workers;
+    std::mutex               _runMutex;
+    std::mutex               _mutex;
+    std::condition_variable  _wake;
+    std::condition_variable  _done;
+    size_type                _generation;
+    size_type                _pending;
+    bool                     _stop;
+    void *                   _task;
+    void                  (* _invoke)(void *, size_type, size_type);
+    std::exception_ptr       _error;
+
+}; // end of class
+
+
+
+// *********************************************************************
+// Parallel helpers - free functions
+// *********************************************************************
+
+
+// tms_default_pool
+// Strong Guarantee
+// Exception-Neutral
+// Pre: None
+// Post:
+//      Returns process-wide pool with one thread per hardware thread,
+//      created on first use
+inline TMSThreadPool & tms_default_pool()
+{
+    static TMSThreadPool pool;
+    return pool;
+}
+
+
+// tms_chunk
+// No-Throw Guarantee
+// Pre:
+//      tid < count
+//      align > 0
+//      offset < align
+// Post:
+//      Returns [first, last) of tid's share of [0, n); shares are
+//      contiguous, cover [0, n), and interior boundaries are multiples
+//      of align less offset: element 0 is taken to sit offset elements
+//      past an align boundary. Same (n, count, align, offset) always
+//      gives the same split.
+inline std::pair<std::size_t, std::size_t>
+tms_chunk(std::size_t n, std::size_t tid, std::size_t count,
+          std::size_t align = 1, std::size_t offset = 0) noexcept
+{
+    std::size_t blocks = (n + offset + align - 1) / align;
+    std::size_t per = blocks / count;
+    std::size_t extra = blocks % count;
+    std::size_t first = (tid * per + std::min(tid, extra)) * align;
+    std::size_t last = first + (per + (tid < extra ? 1 : 0)) * align;
+    first = first > offset ? first - offset : 0;
+    last = last > offset ? last - offset : 0;
+    return { std::min(first, n), std::min(last, n) };
+}
+
+
+// tms_page_elems
+// No-Throw Guarantee
+// Pre: None
+// Post:
+//      Returns number of Valtype elements per page (at least 1);
+//      use as the align argument of tms_chunk / tms_parallel_for
+template <typename Valtype>
+constexpr std::size_t tms_page_elems() noexcept
+{
+    return sizeof(Valtype) >= TMS_PAGE_BYTES ? 1
+                                             : TMS_PAGE_BYTES / sizeof(Valtype);
+}
+
+
+// tms_page_offset
+// No-Throw Guarantee
+// Pre: None
+// Post:
+//      Returns how many elements data lies past the page boundary before
+//      it (0 for elements of a page or more); use as the offset argument
+//      of tms_chunk / tms_parallel_for with tms_page_elems, so chunk
+//      boundaries are page boundaries in memory, not just page-sized
+//      steps from data
+template <typename Valtype>
+std::size_t tms_page_offset(const Valtype * data) noexcept
+{
+    if (sizeof(Valtype) >= TMS_PAGE_BYTES)
+        return 0;
+    return std::size_t(reinterpret_cast<std::uintptr_t>(data)
+                       % TMS_PAGE_BYTES) / sizeof(Valtype);
+}
+
+
+// tms_parallel_for
+// Basic Guarantee
+// Exception-Neutral
+// Pre:
+//      func callable as func(size_type first, size_type last, size_type tid)
+// Post:
+//      func called on the tms_chunk split of [0, n) over pool; threads
+//      whose share is empty are not called
+template <typename Func>
+void tms_parallel_for(std::size_t n, Func && func,
+                      TMSThreadPool & pool = tms_default_pool(),
+                      std::size_t align = 1, std::size_t offset = 0)
+{
+    pool.run([&](std::size_t tid, std::size_t count)
+    {
+        auto range = tms_chunk(n, tid, count, align, offset);
+        if (range.first < range.second)
+            func(range.first, range.second, tid);
+    });
+}
+
+
+// tms_parallel_make
+// Strong Guarantee
+// Exception-Neutral
+// Pre: None
+// Post:
+//      Returns TMSArray of size n, every element value-initialized.
+//      Above TMS_PARALLEL_THRESHOLD bytes the fill is split over pool
+//      in page-aligned chunks, so each page is first-touched by the pool
+//      thread that owns that chunk in later tms_parallel_for scans with
+//      the same tms_page_elems / tms_page_offset split.
+//      (For trivial types new[] leaves pages untouched; for others the
+//      TMSArray ctor constructs serially and only the fill is parallel.)
+template <typename Valtype>
+TMSArray<Valtype> tms_parallel_make(std::size_t n,
+                                    TMSThreadPool & pool = tms_default_pool())
+{
+    TMSArray<Valtype> result(n);
+    if (n * sizeof(Valtype) < TMS_PARALLEL_THRESHOLD || pool.size() == 1)
+    {
+        std::fill(result.begin(), result.end(), Valtype());
+        return result;
+    }
+
+    Valtype * data = result.begin();
+    tms_parallel_for(n, [&](std::size_t first, std::size_t last, std::size_t)
+    {
+        std::fill(data + first, data + last, Valtype());
+    }, pool, tms_page_elems<Valtype>(), tms_page_offset(data));
+    return result;
+}
+
+
+// tms_parallel_copy
+// Strong Guarantee
+// Exception-Neutral
+// Pre:
+//      Valtype copy assignment on distinct objects is safe to run
+//      concurrently
+// Post:
+//      Returns copy of other, other unmodified. Above
+//      TMS_PARALLEL_THRESHOLD bytes the copy is split over pool in
+//      page-aligned chunks (first-touch as for tms_parallel_make).
+template <typename Valtype>
+TMSArray<Valtype> tms_parallel_copy(const TMSArray<Valtype> & other,
+                                    TMSThreadPool & pool = tms_default_pool())
+{
+    if (other.size() * sizeof(Valtype) < TMS_PARALLEL_THRESHOLD
+        || pool.size() == 1)
+        return TMSArray<Valtype>(other);
+
+    TMSArray<Valtype> result(other.size());
+    const Valtype * src = other.begin();
+    Valtype * dst = result.begin();
+    tms_parallel_for(other.size(),
+        [&](std::size_t first, std::size_t last, std::size_t)
+    {
+        std::copy(src + first, src + last, dst + first);
+    }, pool, tms_page_elems<Valtype>(), tms_page_offset(dst));
+    return result;
+}
@@ -0,0 +1,106 @@
+// tmsparallel_bench.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Benchmark: serial vs. parallel first-touch construction and copy of a
+//  large TMSArray<double>, then parallel scan bandwidth over each result.
+// Usage: tmsparallel_bench [megabytes=512] [threads=hardware]
+// Requires tmsparallel.hpp, tmsarray.hpp, tmsbench.hpp
+
+#include "tmsparallel.hpp"
+#include "tmsbench.hpp"
+
+#include <cstddef>
+using std::size_t;
+#include <iostream>
+using std::cout;
+#include <algorithm>
+using std::fill;
+
+
+// Partial
+// One thread's share of parallelSum, alone on its cache line
+struct Partial
+{
+    alignas(64) double sum;
+};
+
+
+// parallelSum
+// Sum of arr using the same static page-aligned split as
+//  tms_parallel_make, so each thread scans the pages it first-touched.
+double parallelSum(const TMSArray<double> & arr, TMSThreadPool & pool)
+{
+    TMSArray<Partial> partial(pool.size());
+    for (Partial & p : partial)
+        p.sum = 0.0;
+    const double * data = arr.begin();
+    tms_parallel_for(arr.size(), [&](size_t first, size_t last, size_t tid)
+    {
+        double acc = 0.0;
+        for (size_t i = first; i < last; ++i)
+            acc += data[i];
+        partial[tid].sum = acc;
+    }, pool, tms_page_elems<double>(), tms_page_offset(data));
+
+    double total = 0.0;
+    for (const Partial & p : partial)
+        total += p.sum;
+    return total;
+}
+
+
+int main(int argc, char * argv[])
+{
+    const size_t megabytes = tms_arg(argc, argv, 1, 512);
+    TMSThreadPool pool(tms_arg(argc, argv, 2, 0));
+    const size_t n = megabytes * (size_t(1) << 20) / sizeof(double);
+    const size_t bytes = n * sizeof(double);
+
+    cout << "TMSArray<double>, " << megabytes << " MB, "
+         << pool.size() << " threads\n\n";
+
+    // Serial: TMSArray ctor + fill on one thread (all first touches here)
+    double secs;
+    {
+        TMSArray<double> serial(0);
+        secs = tms_time_best(1, [&]
+        {
+            TMSArray<double> tmp(n);
+            fill(tmp.begin(), tmp.end(), 0.0);
+            serial.swap(tmp);
+        });
+        tms_report("construct + fill (serial)", secs, bytes);
+        secs = tms_time_best(3, [&]{ tms_sink(parallelSum(serial, pool)); });
+        tms_report("  parallel scan after serial", secs, bytes);
+
+        secs = tms_time_best(1, [&]
+        {
+            TMSArray<double> copy(serial);
+            tms_sink(copy[n / 2]);
+        });
+        tms_report("copy ctor (serial)", secs, 2 * bytes);
+    }
+
+    // Parallel first-touch
+    {
+        TMSArray<double> par(0);
+        secs = tms_time_best(1, [&]
+        {
+            TMSArray<double> tmp = tms_parallel_make<double>(n, pool);
+            par.swap(tmp);
+        });
+        tms_report("tms_parallel_make", secs, bytes);
+        secs = tms_time_best(3, [&]{ tms_sink(parallelSum(par, pool)); });
+        tms_report("  parallel scan after first-touch", secs, bytes);
+
+        secs = tms_time_best(1, [&]
+        {
+            TMSArray<double> copy = tms_parallel_copy(par, pool);
+            tms_sink(copy[n / 2]);
+        });
+        tms_report("tms_parallel_copy", secs, 2 * bytes);
+    }
+
+    return 0;
+}
@@ -0,0 +1,234 @@
+// tmsparallel_test.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Test program for TMSThreadPool and parallel TMSArray construction/copy
+// Uses the "doctest" unit-testing framework, version 2
+// Requires doctest.h, tmsparallel.hpp, tmsarray.hpp
+
+// Includes for code to be tested
+#include "tmsparallel.hpp"   // For TMSThreadPool, tms_parallel_*
+#include "tmsparallel.hpp"   // Double-inclusion check, for testing only
+
+// Includes for the "doctest" unit-testing framework
+#define DOCTEST_CONFIG_IMPLEMENT
+                             // We write our own main
+#define DOCTEST_CONFIG_SUPER_FAST_ASSERTS
+                             // Reduce compile time
+#include "doctest.h"         // For doctest
+
+// Includes for all test programs
+#include <iostream>
+using std::cout;
+using std::endl;
+using std::cin;
+#include <string>
+using std::string;
+
+// Additional includes for this test program
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::uintptr_t;
+#include <atomic>
+using std::atomic;
+#include <stdexcept>
+using std::runtime_error;
+
+// Printable name for this test suite
+const string test_suite_name =
+    "TMSThreadPool & parallel TMSArray construction";
+
+
+// *********************************************************************
+// Test Cases
+// *********************************************************************
+
+
+TEST_CASE( "TMSThreadPool run" )
+{
+    SUBCASE( "Every tid runs exactly once" )
+    {
+        TMSThreadPool pool(4);
+        atomic<size_t> hits[4] = { {0}, {0}, {0}, {0} };
+        for (int rep = 0; rep < 10; ++rep)
+        {
+            pool.run([&](size_t tid, size_t count)
+            {
+                REQUIRE( count == 4 );
+                ++hits[tid];
+            });
+        }
+        for (size_t tid = 0; tid < 4; ++tid)
+        {
+        INFO( "tid " << tid << " run count" );
+        REQUIRE( hits[tid] == 10 );
+        }
+    }
+
+    SUBCASE( "Exception is propagated and pool stays usable" )
+    {
+        TMSThreadPool pool(3);
+        bool threw = false;
+        try
+        {
+            pool.run([](size_t tid, size_t)
+            {
+                if (tid == 2)
+                    throw runtime_error("X");
+            });
+        }
+        catch (runtime_error & e)
+        {
+            threw = (string(e.what()) == "X");
+        }
+        REQUIRE( threw );
+
+        atomic<size_t> calls(0);
+        pool.run([&](size_t, size_t) { ++calls; });
+        REQUIRE( calls == 3 );
+    }
+}
+
+
+TEST_CASE( "tms_chunk" )
+{
+    SUBCASE( "Chunks cover range, aligned, in order" )
+    {
+        const size_t N = 100003;
+        const size_t COUNT = 7;
+        const size_t ALIGN = 1024;
+        size_t expect = 0;
+        for (size_t tid = 0; tid < COUNT; ++tid)
+        {
+            auto range = tms_chunk(N, tid, COUNT, ALIGN);
+            REQUIRE( range.first == expect );
+            if (range.second != N)
+                REQUIRE( range.second % ALIGN == 0 );
+            expect = range.second;
+        }
+        REQUIRE( expect == N );
+    }
+
+    SUBCASE( "More threads than blocks" )
+    {
+        size_t total = 0;
+        for (size_t tid = 0; tid < 8; ++tid)
+        {
+            auto range = tms_chunk(3, tid, 8);
+            total += range.second - range.first;
+        }
+        REQUIRE( total == 3 );
+    }
+
+    SUBCASE( "Offset puts boundaries on page boundaries in memory" )
+    {
+        TMSArray<double> ta(100003);
+        const double * data = ta.begin();
+        const size_t off = tms_page_offset(data);
+        REQUIRE( off < tms_page_elems<double>() );
+        size_t expect = 0;
+        for (size_t tid = 0; tid < 7; ++tid)
+        {
+            auto range = tms_chunk(ta.size(), tid, 7, tms_page_elems<double>(),
+                                   off);
+            REQUIRE( range.first == expect );
+            if (range.second != 0 && range.second != ta.size())
+                REQUIRE( reinterpret_cast<uintptr_t>(data + range.second)
+                         % TMS_PAGE_BYTES == 0 );
+            expect = range.second;
+        }
+        REQUIRE( expect == ta.size() );
+    }
+}
+
+
+TEST_CASE( "tms_parallel_make / tms_parallel_copy" )
+{
+    TMSThreadPool pool(4);
+
+    SUBCASE( "Small make is value-initialized" )
+    {
+        auto ti = tms_parallel_make<int>(100, pool);
+        REQUIRE( ti.size() == 100 );
+        for (size_t i = 0; i < ti.size(); ++i)
+            REQUIRE( ti[i] == 0 );
+    }
+
+    SUBCASE( "Large make and copy (parallel path)" )
+    {
+        const size_t SIZE = TMS_PARALLEL_THRESHOLD / sizeof(long) * 3 + 17;
+        auto tl = tms_parallel_make<long>(SIZE, pool);
+        REQUIRE( tl.size() == SIZE );
+        bool allZero = true;
+        for (size_t i = 0; i < SIZE; ++i)
+        {
+            allZero = allZero && tl[i] == 0;
+            tl[i] = long(i) * 3;
+        }
+        REQUIRE( allZero );
+
+        auto tl2 = tms_parallel_copy(tl, pool);
+        REQUIRE( tl2.size() == SIZE );
+        REQUIRE( tl2.begin() != tl.begin() );
+        bool same = true;
+        for (size_t i = 0; i < SIZE; ++i)
+            same = same && tl2[i] == long(i) * 3;
+        REQUIRE( same );
+    }
+
+    SUBCASE( "Copy of non-trivial type" )
+    {
+        TMSArray<string> ts(5);
+        for (size_t i = 0; i < ts.size(); ++i)
+            ts[i] = string(i + 1, 'a');
+        auto ts2 = tms_parallel_copy(ts, pool);
+        REQUIRE( ts2.size() == 5 );
+        REQUIRE( ts2[4] == "aaaaa" );
+    }
+}
+
+
+// *********************************************************************
+// Main Program
+// *********************************************************************
+
+
+// userPause
+// Wait for user to press ENTER: read all chars through first newline.
+void userPause()
+{
+    std::cout.flush();
+    while (std::cin.get() != '\n') ;
+}
+
+
+// Main program
+// Run all tests. Prompt for ENTER before exiting.
+int main(int argc,
+         char *argv[])
+{
+    doctest::Context dtcontext;
+                             // Primary doctest object
+    int dtresult;            // doctest return code; for return by main
+
+    // Handle command line
+    dtcontext.applyCommandLine(argc, argv);
+    dtresult = 0;            // doctest flags no command-line errors
+                             //  (strange but true)
+
+    if (!dtresult)           // Continue only if no command-line error
+    {
+        // Run test suites
+        cout << "BEGIN tests for " << test_suite_name << "\n" << endl;
+        dtresult = dtcontext.run();
+        cout << "END tests for " << test_suite_name << "\n" << endl;
+    }
+
+    // Wait for user
+    std::cout << "Press ENTER to quit ";
+    userPause();
+
+    // Program return value is return code from doctest
+    return dtresult;
+}
@@ -0,0 +1,937 @@
+// tmsreduce.hpp
+// Matthew Johnson
+// 10/17/2026
+// SIMD reductions over TMSArray: sum, min, max, minmax, dot product,
+//  with a deterministic pairwise mode and optional multithreading
+
+#pragma once
+// for single inclusion
+
+#include "tmsarray.hpp"
+// For class template TMSArray
+
+#include "tmssimd.hpp"
+// For tms_isa_limit
+// For TMSIsa
+
+#include "tmsparallel.hpp"
+// For TMSThreadPool
+// For tms_chunk
+// For TMS_PARALLEL_THRESHOLD
+// For tms_page_offset
+
+#include <cstddef>
+// For std::size_t
+
+#include <cstdint>
+// For std::int32_t
+// For std::int64_t
+// For std::uint64_t
+
+#include <utility>
+// For std::pair
+
+#include <type_traits>
+// For std::conditional
+// For std::is_floating_point
+// For std::is_integral
+// For std::is_signed
+// For std::is_same
+
+
+
+// Summation order for floating-point sum and dot.
+//  TMS_SUM_FAST: as many accumulators as the widest ISA allows; the
+//   result may differ in the last bits between machines and thread
+//   counts.
+//  TMS_SUM_PAIRWISE: fixed 8-lane, fixed-block, pairwise-tree order;
+//   bit-identical for a given input on every ISA and thread count, and
+//   error grows with log(n) rather than n.
+enum TMSSumMode
+{
+    TMS_SUM_FAST,
+    TMS_SUM_PAIRWISE
+};
+
+
+// Elements per leaf of the pairwise tree (multiple of every lane count)
+constexpr std::size_t TMS_PAIRWISE_BLOCK = 2048;
+
+
+// tms_sum_t
+// Result type of tms_sum/tms_dot: floating types sum in their own type,
+//  integers in 64 bits of the same signedness, anything else in Valtype
+template <typename Valtype>
+using tms_sum_t = typename std::conditional<
+    std::is_integral<Valtype>::value && !std::is_same<Valtype, bool>::value,
+    typename std::conditional<std::is_signed<Valtype>::value,
+                              std::int64_t, std::uint64_t>::type,
+    Valtype>::type;
+
+
+
+// *********************************************************************
+// Scalar kernels (reference order; also the non-x86 path)
+// *********************************************************************
+
+
+template <typename T>
+tms_sum_t<T> tms_red_sum_scalar(const T * data, std::size_t n)
+{
+    using A = tms_sum_t<T>;
+    A acc[4] = { A(), A(), A(), A() };
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        for (std::size_t j = 0; j < 4; ++j)
+            acc[j] = acc[j] + A(data[i + j]);
+    for (; i < n; ++i)
+        acc[0] = acc[0] + A(data[i]);
+    return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+}
+
+
+template <typename T>
+tms_sum_t<T> tms_red_dot_scalar(const T * a, const T * b, std::size_t n)
+{
+    using A = tms_sum_t<T>;
+    A acc[4] = { A(), A(), A(), A() };
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        for (std::size_t j = 0; j < 4; ++j)
+            acc[j] = acc[j] + A(a[i + j]) * A(b[i + j]);
+    for (; i < n; ++i)
+        acc[0] = acc[0] + A(a[i]) * A(b[i]);
+    return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+}
+
+
+template <typename T>
+void tms_red_minmax_scalar(const T * data, std::size_t n, T & lo, T & hi)
+{
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        if (data[i] < lo)
+            lo = data[i];
+        if (hi < data[i])
+            hi = data[i];
+    }
+}
+
+
+// Pairwise kernels must not have a*b+c fused into an FMA (which -march
+//  with FMA plus -std=gnu++ modes would otherwise allow), or results
+//  would depend on the build
+#if defined(__GNUC__) && !defined(__clang__)
+#define TMS_RED_NOCONTRACT __attribute__((optimize("fp-contract=off")))
+#else
+#define TMS_RED_NOCONTRACT
+#endif
+
+
+// tms_red_fold8
+// Canonical combine of 8 lane sums: ((0+1)+(2+3))+((4+5)+(6+7))
+template <typename A>
+TMS_RED_NOCONTRACT inline A tms_red_fold8(const A * lane)
+{
+    return ((lane[0] + lane[1]) + (lane[2] + lane[3]))
+         + ((lane[4] + lane[5]) + (lane[6] + lane[7]));
+}
+
+
+// Canonical 8-lane block sum/dot: lane j takes elements j, j+8, ...
+template <typename T>
+TMS_RED_NOCONTRACT T tms_red_sum8_scalar(const T * data, std::size_t n)
+{
+    T lane[8] = {};
+    for (std::size_t i = 0; i < n; ++i)
+        lane[i % 8] = lane[i % 8] + data[i];
+    return tms_red_fold8(lane);
+}
+
+template <typename T>
+TMS_RED_NOCONTRACT T tms_red_dot8_scalar(const T * a, const T * b,
+                                       std::size_t n)
+{
+    T lane[8] = {};
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        T prod = a[i] * b[i];
+        lane[i % 8] = lane[i % 8] + prod;
+    }
+    return tms_red_fold8(lane);
+}
+
+
+
+// *********************************************************************
+// SIMD policies and kernels
+// *********************************************************************
+
+
+#ifdef TMS_SIMD_X86
+
+TMS_AVX512_DIAG_PUSH
+
+#define TMS_RED_SSE2   __attribute__((target("sse2"), always_inline))
+#define TMS_RED_AVX2   __attribute__((target("avx2"), always_inline))
+#define TMS_RED_AVX512 __attribute__((target("avx512f,avx512dq"), always_inline))
+
+// Policies: T element, A scalar accumulator, V element vector (Lanes),
+//  VA accumulator vector (Step elements per loadAcc). Floating types
+//  have V == VA; int32 widens to int64 lanes for sum and dot. HasMinMax
+//  and HasDot are false where the ISA lacks the compare or multiply.
+
+// ---- SSE2 ----
+
+struct TMSRedSse2F32
+{
+    using T = float; using A = float; using V = __m128; using VA = __m128;
+    static constexpr std::size_t Lanes = 4, Step = 4;
+    static constexpr bool HasMinMax = true;
+    static constexpr bool HasDot = true;
+    TMS_RED_SSE2 static inline VA zero() { return _mm_setzero_ps(); }
+    TMS_RED_SSE2 static inline V load(const T * p) { return _mm_loadu_ps(p); }
+    TMS_RED_SSE2 static inline VA loadAcc(const T * p) { return _mm_loadu_ps(p); }
+    TMS_RED_SSE2 static inline VA add(VA a, VA b) { return _mm_add_ps(a, b); }
+    TMS_RED_SSE2 static inline VA mul(VA a, VA b) { return _mm_mul_ps(a, b); }
+    TMS_RED_SSE2 static inline V min(V a, V b) { return _mm_min_ps(a, b); }
+    TMS_RED_SSE2 static inline V max(V a, V b) { return _mm_max_ps(a, b); }
+    TMS_RED_SSE2 static inline void store(T * p, V v) { _mm_storeu_ps(p, v); }
+    TMS_RED_SSE2 static inline void storeAcc(A * p, VA v) { _mm_storeu_ps(p, v); }
+};
+
+struct TMSRedSse2F64
+{
+    using T = double; using A = double; using V = __m128d; using VA = __m128d;
+    static constexpr std::size_t Lanes = 2, Step = 2;
+    static constexpr bool HasMinMax = true;
+    static constexpr bool HasDot = true;
+    TMS_RED_SSE2 static inline VA zero() { return _mm_setzero_pd(); }
+    TMS_RED_SSE2 static inline V load(const T * p) { return _mm_loadu_pd(p); }
+    TMS_RED_SSE2 static inline VA loadAcc(const T * p) { return _mm_loadu_pd(p); }
+    TMS_RED_SSE2 static inline VA add(VA a, VA b) { return _mm_add_pd(a, b); }
+    TMS_RED_SSE2 static inline VA mul(VA a, VA b) { return _mm_mul_pd(a, b); }
+    TMS_RED_SSE2 static inline V min(V a, V b) { return _mm_min_pd(a, b); }
+    TMS_RED_SSE2 static inline V max(V a, V b) { return _mm_max_pd(a, b); }
+    TMS_RED_SSE2 static inline void store(T * p, V v) { _mm_storeu_pd(p, v); }
+    TMS_RED_SSE2 static inline void storeAcc(A * p, VA v) { _mm_storeu_pd(p, v); }
+};
+
+struct TMSRedSse2I32
+{
+    using T = std::int32_t; using A = std::int64_t;
+    using V = __m128i; using VA = __m128i;
+    static constexpr std::size_t Lanes = 4, Step = 2;
+    static constexpr bool HasMinMax = true;
+    static constexpr bool HasDot = false;    // no signed 32x32->64 multiply
+    TMS_RED_SSE2 static inline VA zero() { return _mm_setzero_si128(); }
+    TMS_RED_SSE2 static inline V load(const T * p)
+    { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+    TMS_RED_SSE2 static inline VA loadAcc(const T * p)
+    {
+        // sign-extend two int32 to two int64
+        __m128i x = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(p));
+        return _mm_unpacklo_epi32(x, _mm_srai_epi32(x, 31));
+    }
+    TMS_RED_SSE2 static inline VA add(VA a, VA b) { return _mm_add_epi64(a, b); }
+    TMS_RED_SSE2 static inline V min(V a, V b)
+    {
+        __m128i gt = _mm_cmpgt_epi32(a, b);
+        return _mm_or_si128(_mm_and_si128(gt, b), _mm_andnot_si128(gt, a));
+    }
+    TMS_RED_SSE2 static inline V max(V a, V b)
+    {
+        __m128i gt = _mm_cmpgt_epi32(a, b);
+        return _mm_or_si128(_mm_and_si128(gt, a), _mm_andnot_si128(gt, b));
+    }
+    TMS_RED_SSE2 static inline void store(T * p, V v)
+    { _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v); }
+    TMS_RED_SSE2 static inline void storeAcc(A * p, VA v)
+    { _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v); }
+};
+
+struct TMSRedSse2I64
+{
+    using T = std::int64_t; using A = std::int64_t;
+    using V = __m128i; using VA = __m128i;
+    static constexpr std::size_t Lanes = 2, Step = 2;
+    static constexpr bool HasMinMax = false;   // no 64-bit compare
+    static constexpr bool HasDot = false;    // no 64-bit multiply
+    TMS_RED_SSE2 static inline VA zero() { return _mm_setzero_si128(); }
+    TMS_RED_SSE2 static inline VA loadAcc(const T * p)
+    { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+    TMS_RED_SSE2 static inline VA add(VA a, VA b) { return _mm_add_epi64(a, b); }
+    TMS_RED_SSE2 static inline void storeAcc(A * p, VA v)
+    { _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v); }
+};
+
+// ---- AVX2 ----
+
+struct TMSRedAvx2F32
+{
+    using T = float; using A = float; using V = __m256; using VA = __m256;
+    static constexpr std::size_t Lanes = 8, Step = 8;
+    static constexpr bool HasMinMax = true;
+    static constexpr bool HasDot = true;
+    TMS_RED_AVX2 static inline VA zero() { return _mm256_setzero_ps(); }
+    TMS_RED_AVX2 static inline V load(const T * p) { return _mm256_loadu_ps(p); }
+    TMS_RED_AVX2 static inline VA loadAcc(const T * p) { return _mm256_loadu_ps(p); }
+    TMS_RED_AVX2 static inline VA add(VA a, VA b) { return _mm256_add_ps(a, b); }
+    TMS_RED_AVX2 static inline VA mul(VA a, VA b) { return _mm256_mul_ps(a, b); }
+    TMS_RED_AVX2 static inline V min(V a, V b) { return _mm256_min_ps(a, b); }
+    TMS_RED_AVX2 static inline V max(V a, V b) { return _mm256_max_ps(a, b); }
+    TMS_RED_AVX2 static inline void store(T * p, V v) { _mm256_storeu_ps(p, v); }
+    TMS_RED_AVX2 static inline void storeAcc(A * p, VA v) { _mm256_storeu_ps(p, v); }
+};
+
+struct TMSRedAvx2F64
+{
+    using T = double; using A = double; using V = __m256d; using VA = __m256d;
+    static constexpr std::size_t Lanes = 4, Step = 4;
+    static constexpr bool HasMinMax = true;
+    static constexpr bool HasDot = true;
+    TMS_RED_AVX2 static inline VA zero() { return _mm256_setzero_pd(); }
+    TMS_RED_AVX2 static inline V load(const T * p) { return _mm256_loadu_pd(p); }
+    TMS_RED_AVX2 static inline VA loadAcc(const T * p) { return _mm256_loadu_pd(p); }
+    TMS_RED_AVX2 static inline VA add(VA a, VA b) { return _mm256_add_pd(a, b); }
+    TMS_RED_AVX2 static inline VA mul(VA a, VA b) { return _mm256_mul_pd(a, b); }
+    TMS_RED_AVX2 static inline V min(V a, V b) { return _mm256_min_pd(a, b); }
+    TMS_RED_AVX2 static inline V max(V a, V b) { return _mm256_max_pd(a, b); }
+    TMS_RED_AVX2 static inline void store(T * p, V v) { _mm256_storeu_pd(p, v); }
+    TMS_RED_AVX2 static inline void storeAcc(A * p, VA v) { _mm256_storeu_pd(p, v); }
+};
+
+struct TMSRedAvx2I32
+{
+    using T = std::int32_t; using A = std::int64_t;
+    using V = __m256i; using VA = __m256i;
+    static constexpr std::size_t Lanes = 8, Step = 4;
+    static constexpr bool HasMinMax = true;
+    static constexpr bool HasDot = true;
+    TMS_RED_AVX2 static inline VA zero() { return _mm256_setzero_si256(); }
+    TMS_RED_AVX2 static inline V load(const T * p)
+    { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+    TMS_RED_AVX2 static inline VA loadAcc(const T * p)
+    {
+        return _mm256_cvtepi32_epi64(
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)));
+    }
+    TMS_RED_AVX2 static inline VA add(VA a, VA b) { return _mm256_add_epi64(a, b); }
+    TMS_RED_AVX2 static inline VA mul(VA a, VA b) { return _mm256_mul_epi32(a, b); }
+    TMS_RED_AVX2 static inline V min(V a, V b) { return _mm256_min_epi32(a, b); }
+    TMS_RED_AVX2 static inline V max(V a, V b) { return _mm256_max_epi32(a, b); }
+    TMS_RED_AVX2 static inline void store(T * p, V v)
+    { _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v); }
+    TMS_RED_AVX2 static inline void storeAcc(A * p, VA v)
+    { _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v); }
+};
+
+struct TMSRedAvx2I64
+{
+    using T = std::int64_t; using A = std::int64_t;
+    using V = __m256i; using VA = __m256i;
+    static constexpr std::size_t Lanes = 4, Step = 4;
+    static constexpr bool HasMinMax = true;
+    static constexpr bool HasDot = true;
+    TMS_RED_AVX2 static inline VA zero() { return _mm256_setzero_si256(); }
+    TMS_RED_AVX2 static inline V load(const T * p)
+    { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+    TMS_RED_AVX2 static inline VA loadAcc(const T * p) { return load(p); }
+    TMS_RED_AVX2 static inline VA add(VA a, VA b) { return _mm256_add_epi64(a, b); }
+    TMS_RED_AVX2 static inline VA mul(VA a, VA b)
+    {
+        // low 64 bits of a*b from 32x32 partial products
+        __m256i lo = _mm256_mul_epu32(a, b);
+        __m256i cross = _mm256_add_epi64(
+            _mm256_mul_epu32(_mm256_srli_epi64(a, 32), b),
+            _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)));
+        return _mm256_add_epi64(lo, _mm256_slli_epi64(cross, 32));
+    }
+    TMS_RED_AVX2 static inline V min(V a, V b)
+    { return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b)); }
+    TMS_RED_AVX2 static inline V max(V a, V b)
+    { return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b)); }
+    TMS_RED_AVX2 static inline void store(T * p, V v)
+    { _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v); }
+    TMS_RED_AVX2 static inline void storeAcc(A * p, VA v) { store(p, v); }
+};
+
+// ---- AVX-512 ----
+
+struct TMSRedAvx512F32
+{
+    using T = float; using A = float; using V = __m512; using VA = __m512;
+    static constexpr std::size_t Lanes = 16, Step = 16;
+    static constexpr bool HasMinMax = true;
+    static constexpr bool HasDot = true;
+    TMS_RED_AVX512 static inline VA zero() { return _mm512_setzero_ps(); }
+    TMS_RED_AVX512 static inline V load(const T * p) { return _mm512_loadu_ps(p); }
+    TMS_RED_AVX512 static inline VA loadAcc(const T * p) { return _mm512_loadu_ps(p); }
+    TMS_RED_AVX512 static inline VA add(VA a, VA b) { return _mm512_add_ps(a, b); }
+    TMS_RED_AVX512 static inline VA mul(VA a, VA b) { return _mm512_mul_ps(a, b); }
+    TMS_RED_AVX512 static inline V min(V a, V b) { return _mm512_min_ps(a, b); }
+    TMS_RED_AVX512 static inline V max(V a, V b) { return _mm512_max_ps(a, b); }
+    TMS_RED_AVX512 static inline void store(T * p, V v) { _mm512_storeu_ps(p, v); }
+    TMS_RED_AVX512 static inline void storeAcc(A * p, VA v) { _mm512_storeu_ps(p, v); }
+};
+
+struct TMSRedAvx512F64
+{
+    using T = double; using A = double; using V = __m512d; using VA = __m512d;
+    static constexpr std::size_t Lanes = 8, Step = 8;
+    static constexpr bool HasMinMax = true;
+    static constexpr bool HasDot = true;
+    TMS_RED_AVX512 static inline VA zero() { return _mm512_setzero_pd(); }
+    TMS_RED_AVX512 static inline V load(const T * p) { return _mm512_loadu_pd(p); }
+    TMS_RED_AVX512 static inline VA loadAcc(const T * p) { return _mm512_loadu_pd(p); }
+    TMS_RED_AVX512 static inline VA add(VA a, VA b) { return _mm512_add_pd(a, b); }
+    TMS_RED_AVX512 static inline VA mul(VA a, VA b) { return _mm512_mul_pd(a, b); }
+    TMS_RED_AVX512 static inline V min(V a, V b) { return _mm512_min_pd(a, b); }
+    TMS_RED_AVX512 static inline V max(V a, V b) { return _mm512_max_pd(a, b); }
+    TMS_RED_AVX512 static inline void store(T * p, V v) { _mm512_storeu_pd(p, v); }
+    TMS_RED_AVX512 static inline void storeAcc(A * p, VA v) { _mm512_storeu_pd(p, v); }
+};
+
+struct TMSRedAvx512I32
+{
+    using T = std::int32_t; using A = std::int64_t;
+    using V = __m512i; using VA = __m512i;
+    static constexpr std::size_t Lanes = 16, Step = 8;
+    static constexpr bool HasMinMax = true;
+    static constexpr bool HasDot = true;
+    TMS_RED_AVX512 static inline VA zero() { return _mm512_setzero_si512(); }
+    TMS_RED_AVX512 static inline V load(const T * p) { return _mm512_loadu_si512(p); }
+    TMS_RED_AVX512 static inline VA loadAcc(const T * p)
+    {
+        return _mm512_cvtepi32_epi64(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)));
+    }
+    TMS_RED_AVX512 static inline VA add(VA a, VA b) { return _mm512_add_epi64(a, b); }
+    TMS_RED_AVX512 static inline VA mul(VA a, VA b) { return _mm512_mul_epi32(a, b); }
+    TMS_RED_AVX512 static inline V min(V a, V b) { return _mm512_min_epi32(a, b); }
+    TMS_RED_AVX512 static inline V max(V a, V b) { return _mm512_max_epi32(a, b); }
+    TMS_RED_AVX512 static inline void store(T * p, V v) { _mm512_storeu_si512(p, v); }
+    TMS_RED_AVX512 static inline void storeAcc(A * p, VA v) { _mm512_storeu_si512(p, v); }
+};
+
+struct TMSRedAvx512I64
+{
+    using T = std::int64_t; using A = std::int64_t;
+    using V = __m512i; using VA = __m512i;
+    static constexpr std::size_t Lanes = 8, Step = 8;
+    static constexpr bool HasMinMax = true;
+    static constexpr bool HasDot = true;
+    TMS_RED_AVX512 static inline VA zero() { return _mm512_setzero_si512(); }
+    TMS_RED_AVX512 static inline V load(const T * p) { return _mm512_loadu_si512(p); }
+    TMS_RED_AVX512 static inline VA loadAcc(const T * p) { return load(p); }
+    TMS_RED_AVX512 static inline VA add(VA a, VA b) { return _mm512_add_epi64(a, b); }
+    TMS_RED_AVX512 static inline VA mul(VA a, VA b) { return _mm512_mullo_epi64(a, b); }
+    TMS_RED_AVX512 static inline V min(V a, V b) { return _mm512_min_epi64(a, b); }
+    TMS_RED_AVX512 static inline V max(V a, V b) { return _mm512_max_epi64(a, b); }
+    TMS_RED_AVX512 static inline void store(T * p, V v) { _mm512_storeu_si512(p, v); }
+    TMS_RED_AVX512 static inline void storeAcc(A * p, VA v) { store(p, v); }
+};
+
+
+// TMS_RED_KERNELS
+// Defines, for one ISA:
+//  tms_red_sum_<isa>    four independent accumulators
+//  tms_red_dot_<isa>    four accumulators of a*b
+//  tms_red_minmax_<isa> two min and two max registers
+//  tms_red_sum8_<isa>   canonical 8-lane order (Lanes divides 8)
+//  tms_red_dot8_<isa>   canonical 8-lane order, separate mul and add
+#define TMS_RED_KERNELS(isa, attr)                                           \
+template <typename P>                                                        \
+attr typename P::A tms_red_sum_##isa(const typename P::T * data,             \
+                                     std::size_t n)                          \
+{                                                                            \
+    const std::size_t S = P::Step;                                           \
+    auto a0 = P::zero(), a1 = P::zero(), a2 = P::zero(), a3 = P::zero();     \
+    std::size_t i = 0;                                                       \
+    for (; i + 4 * S <= n; i += 4 * S)                                       \
+    {                                                                        \
+        a0 = P::add(a0, P::loadAcc(data + i));                               \
+        a1 = P::add(a1, P::loadAcc(data + i + S));                           \
+        a2 = P::add(a2, P::loadAcc(data + i + 2 * S));                       \
+        a3 = P::add(a3, P::loadAcc(data + i + 3 * S));                       \
+    }                                                                        \
+    for (; i + S <= n; i += S)                                               \
+        a0 = P::add(a0, P::loadAcc(data + i));                               \
+    typename P::A lane[S];                                                   \
+    P::storeAcc(lane, P::add(P::add(a0, a1), P::add(a2, a3)));               \
+    typename P::A total = tms_red_sum_scalar(data + i, n - i);               \
+    for (std::size_t j = 0; j < S; ++j)                                      \
+        total += lane[j];                                                    \
+    return total;                                                            \
+}                                                                            \
+                                                                             \
+template <typename P>                                                        \
+attr typename P::A tms_red_dot_##isa(const typename P::T * a,                \
+                                     const typename P::T * b, std::size_t n) \
+{                                                                            \
+    const std::size_t S = P::Step;                                           \
+    auto a0 = P::zero(), a1 = P::zero(), a2 = P::zero(), a3 = P::zero();     \
+    std::size_t i = 0;                                                       \
+    for (; i + 4 * S <= n; i += 4 * S)                                       \
+    {                                                                        \
+        a0 = P::add(a0, P::mul(P::loadAcc(a + i), P::loadAcc(b + i)));       \
+        a1 = P::add(a1, P::mul(P::loadAcc(a + i + S),                        \
+                               P::loadAcc(b + i + S)));                      \
+        a2 = P::add(a2, P::mul(P::loadAcc(a + i + 2 * S),                    \
+                               P::loadAcc(b + i + 2 * S)));                  \
+        a3 = P::add(a3, P::mul(P::loadAcc(a + i + 3 * S),                    \
+                               P::loadAcc(b + i + 3 * S)));                  \
+    }                                                                        \
+    for (; i + S <= n; i += S)                                               \
+        a0 = P::add(a0, P::mul(P::loadAcc(a + i), P::loadAcc(b + i)));       \
+    typename P::A lane[S];                                                   \
+    P::storeAcc(lane, P::add(P::add(a0, a1), P::add(a2, a3)));               \
+    typename P::A total = tms_red_dot_scalar(a + i, b + i, n - i);           \
+    for (std::size_t j = 0; j < S; ++j)                                      \
+        total += lane[j];                                                    \
+    return total;                                                            \
+}                                                                            \
+                                                                             \
+template <typename P>                                                        \
+attr void tms_red_minmax_##isa(const typename P::T * data, std::size_t n,    \
+                               typename P::T & lo, typename P::T & hi)       \
+{                                                                            \
+    const std::size_t L = P::Lanes;                                          \
+    std::size_t i = 0;                                                       \
+    if (n >= 2 * L)                                                          \
+    {                                                                        \
+        auto mn0 = P::load(data), mn1 = P::load(data + L);                   \
+        auto mx0 = mn0, mx1 = mn1;                                           \
+        for (i = 2 * L; i + 2 * L <= n; i += 2 * L)                          \
+        {                                                                    \
+            auto v0 = P::load(data + i), v1 = P::load(data + i + L);         \
+            mn0 = P::min(mn0, v0); mx0 = P::max(mx0, v0);                    \
+            mn1 = P::min(mn1, v1); mx1 = P::max(mx1, v1);                    \
+        }                                                                    \
+        typename P::T lane[L];                                               \
+        P::store(lane, P::min(mn0, mn1));                                    \
+        tms_red_minmax_scalar(lane, L, lo, hi);                              \
+        P::store(lane, P::max(mx0, mx1));                                    \
+        tms_red_minmax_scalar(lane, L, lo, hi);                              \
+    }                                                                        \
+    tms_red_minmax_scalar(data + i, n - i, lo, hi);                          \
+}                                                                            \
+                                                                             \
+template <typename P>                                                        \
+attr TMS_RED_NOCONTRACT                                                      \
+typename P::A tms_red_sum8_##isa(const typename P::T * data,            \
+                                      std::size_t n)                         \
+{                                                                            \
+    const std::size_t L = P::Lanes, R = 8 / P::Lanes;                        \
+    typename P::VA acc[R];                                                   \
+    for (std::size_t r = 0; r < R; ++r)                                      \
+        acc[r] = P::zero();                                                  \
+    std::size_t i = 0;                                                       \
+    for (; i + 8 <= n; i += 8)                                               \
+        for (std::size_t r = 0; r < R; ++r)                                  \
+            acc[r] = P::add(acc[r], P::loadAcc(data + i + r * L));           \
+    typename P::A lane[8];                                                   \
+    for (std::size_t r = 0; r < R; ++r)                                      \
+        P::storeAcc(lane + r * L, acc[r]);                                   \
+    for (std::size_t j = 0; i < n; ++i, ++j)                                 \
+        lane[j] = lane[j] + data[i];                                         \
+    return tms_red_fold8(lane);                                              \
+}                                                                            \
+                                                                             \
+template <typename P>                                                        \
+attr TMS_RED_NOCONTRACT                                                      \
+typename P::A tms_red_dot8_##isa(const typename P::T * a,               \
+                                      const typename P::T * b,               \
+                                      std::size_t n)                         \
+{                                                                            \
+    const std::size_t L = P::Lanes, R = 8 / P::Lanes;                        \
+    typename P::VA acc[R];                                                   \
+    for (std::size_t r = 0; r < R; ++r)                                      \
+        acc[r] = P::zero();                                                  \
+    std::size_t i = 0;                                                       \
+    for (; i + 8 <= n; i += 8)                                               \
+        for (std::size_t r = 0; r < R; ++r)                                  \
+            acc[r] = P::add(acc[r], P::mul(P::loadAcc(a + i + r * L),        \
+                                           P::loadAcc(b + i + r * L)));      \
+    typename P::A lane[8];                                                   \
+    for (std::size_t r = 0; r < R; ++r)                                      \
+        P::storeAcc(lane + r * L, acc[r]);                                   \
+    for (std::size_t j = 0; i < n; ++i, ++j)                                 \
+    {                                                                        \
+        typename P::A prod = a[i] * b[i];                                    \
+        lane[j] = lane[j] + prod;                                            \
+    }                                                                        \
+    return tms_red_fold8(lane);                                              \
+}
+
+TMS_RED_KERNELS(sse2, __attribute__((target("sse2"))))
+TMS_RED_KERNELS(avx2, __attribute__((target("avx2"))))
+TMS_RED_KERNELS(avx512, __attribute__((target("avx512f,avx512dq"))))
+
+#undef TMS_RED_KERNELS
+#undef TMS_RED_SSE2
+#undef TMS_RED_AVX2
+#undef TMS_RED_AVX512
+
+
+// TMSRedPolicies
+// Policy triple (SSE2, AVX2, AVX-512) for an element type; void if none
+template <typename T> struct TMSRedPolicies
+{ using S = void; using A = void; using X = void; };
+template <> struct TMSRedPolicies<float>
+{ using S = TMSRedSse2F32; using A = TMSRedAvx2F32; using X = TMSRedAvx512F32; };
+template <> struct TMSRedPolicies<double>
+{ using S = TMSRedSse2F64; using A = TMSRedAvx2F64; using X = TMSRedAvx512F64; };
+template <> struct TMSRedPolicies<std::int32_t>
+{ using S = TMSRedSse2I32; using A = TMSRedAvx2I32; using X = TMSRedAvx512I32; };
+template <> struct TMSRedPolicies<std::int64_t>
+{ using S = TMSRedSse2I64; using A = TMSRedAvx2I64; using X = TMSRedAvx512I64; };
+
+TMS_AVX512_DIAG_POP
+
+#endif // TMS_SIMD_X86
+
+
+
+// *********************************************************************
+// Single-thread dispatch over a pointer range
+// *********************************************************************
+
+
+// tms_red_canonical
+// Maps T to the fixed-width type its kernels use (int -> int32_t, long
+//  -> int64_t on LP64), or T itself
+template <typename T>
+using tms_red_canonical = typename std::conditional<
+    std::is_integral<T>::value && std::is_signed<T>::value
+        && !std::is_same<T, bool>::value && sizeof(T) == 4,
+    std::int32_t,
+    typename std::conditional<
+        std::is_integral<T>::value && std::is_signed<T>::value
+            && !std::is_same<T, bool>::value && sizeof(T) == 8,
+        std::int64_t, T>::type>::type;
+
+
+template <typename T>
+tms_sum_t<T> tms_red_sum_range(const T * data, std::size_t n)
+{
+#ifdef TMS_SIMD_X86
+    using C = tms_red_canonical<T>;
+    using Pol = TMSRedPolicies<C>;
+    const C * d = reinterpret_cast<const C *>(data);
+    const TMSIsa level = tms_isa_limit();
+    if constexpr (!std::is_void<typename Pol::X>::value)
+    {
+        if (level >= TMS_ISA_AVX512)
+            return tms_red_sum_avx512<typename Pol::X>(d, n);
+        if (level >= TMS_ISA_AVX2)
+            return tms_red_sum_avx2<typename Pol::A>(d, n);
+        if (level >= TMS_ISA_SSE2)
+            return tms_red_sum_sse2<typename Pol::S>(d, n);
+    }
+#endif
+    return tms_red_sum_scalar(data, n);
+}
+
+
+template <typename T>
+tms_sum_t<T> tms_red_dot_range(const T * a, const T * b, std::size_t n)
+{
+#ifdef TMS_SIMD_X86
+    using C = tms_red_canonical<T>;
+    using Pol = TMSRedPolicies<C>;
+    if constexpr (!std::is_void<typename Pol::X>::value)
+    {
+        const C * x = reinterpret_cast<const C *>(a);
+        const C * y = reinterpret_cast<const C *>(b);
+        const TMSIsa level = tms_isa_limit();
+        if (level >= TMS_ISA_AVX512)
+            return tms_red_dot_avx512<typename Pol::X>(x, y, n);
+        if (level >= TMS_ISA_AVX2)
+            return tms_red_dot_avx2<typename Pol::A>(x, y, n);
+        if constexpr (Pol::S::HasDot)
+            if (level >= TMS_ISA_SSE2)
+                return tms_red_dot_sse2<typename Pol::S>(x, y, n);
+    }
+#endif
+    return tms_red_dot_scalar(a, b, n);
+}
+
+
+template <typename T>
+void tms_red_minmax_range(const T * data, std::size_t n, T & lo, T & hi)
+{
+#ifdef TMS_SIMD_X86
+    using C = tms_red_canonical<T>;
+    using Pol = TMSRedPolicies<C>;
+    if constexpr (!std::is_void<typename Pol::X>::value)
+    {
+        const C * d = reinterpret_cast<const C *>(data);
+        C & l = reinterpret_cast<C &>(lo);
+        C & h = reinterpret_cast<C &>(hi);
+        const TMSIsa level = tms_isa_limit();
+        if (level >= TMS_ISA_AVX512)
+            return tms_red_minmax_avx512<typename Pol::X>(d, n, l, h);
+        if (level >= TMS_ISA_AVX2)
+            return tms_red_minmax_avx2<typename Pol::A>(d, n, l, h);
+        if constexpr (Pol::S::HasMinMax)
+            if (level >= TMS_ISA_SSE2)
+                return tms_red_minmax_sse2<typename Pol::S>(d, n, l, h);
+    }
+#endif
+    tms_red_minmax_scalar(data, n, lo, hi);
+}
+
+
+// Canonical-order block sum/dot (floating types only). The widest ISA
+//  whose lane count divides 8 is used, so every path gives the same bits.
+template <typename T>
+T tms_red_sum8_range(const T * data, std::size_t n)
+{
+#ifdef TMS_SIMD_X86
+    using Pol = TMSRedPolicies<T>;
+    if constexpr (std::is_floating_point<T>::value
+                  && !std::is_void<typename Pol::X>::value)
+    {
+        const TMSIsa level = tms_isa_limit();
+        if constexpr (Pol::X::Lanes <= 8)
+            if (level >= TMS_ISA_AVX512)
+                return tms_red_sum8_avx512<typename Pol::X>(data, n);
+        if (level >= TMS_ISA_AVX2)
+            return tms_red_sum8_avx2<typename Pol::A>(data, n);
+        if (level >= TMS_ISA_SSE2)
+            return tms_red_sum8_sse2<typename Pol::S>(data, n);
+    }
+#endif
+    return tms_red_sum8_scalar(data, n);
+}
+
+template <typename T>
+T tms_red_dot8_range(const T * a, const T * b, std::size_t n)
+{
+#ifdef TMS_SIMD_X86
+    using Pol = TMSRedPolicies<T>;
+    if constexpr (std::is_floating_point<T>::value
+                  && !std::is_void<typename Pol::X>::value)
+    {
+        const TMSIsa level = tms_isa_limit();
+        if constexpr (Pol::X::Lanes <= 8)
+            if (level >= TMS_ISA_AVX512)
+                return tms_red_dot8_avx512<typename Pol::X>(a, b, n);
+        if (level >= TMS_ISA_AVX2)
+            return tms_red_dot8_avx2<typename Pol::A>(a, b, n);
+        if (level >= TMS_ISA_SSE2)
+            return tms_red_dot8_sse2<typename Pol::S>(a, b, n);
+    }
+#endif
+    return tms_red_dot8_scalar(a, b, n);
+}
+
+
+// tms_red_pairwise
+// Pairwise tree over block results [first, last): split at the midpoint
+//  of the index range, so the shape depends only on the block count
+template <typename A>
+A tms_red_pairwise(const A * blocks, std::size_t first, std::size_t last)
+{
+    if (last - first == 1)
+        return blocks[first];
+    std::size_t mid = first + (last - first) / 2;
+    return tms_red_pairwise(blocks, first, mid)
+         + tms_red_pairwise(blocks, mid, last);
+}
+
+
+
+// *********************************************************************
+// Public reductions
+// *********************************************************************
+
+
+// tms_red_driver
+// Shared driver for sum and dot. leaf(first, last) reduces one range;
+//  leaf8(first, last) reduces one pairwise block. Parallel above the
+//  threshold: FAST combines per-thread partials in tid order, PAIRWISE
+//  stores every block result then folds the fixed tree. The FAST split
+//  is in page-sized steps, offset as tms_chunk's offset argument.
+template <typename A, typename Leaf, typename Leaf8>
+A tms_red_driver(std::size_t n, std::size_t elemBytes, std::size_t offset,
+                 TMSSumMode mode, TMSThreadPool & pool, Leaf leaf,
+                 Leaf8 leaf8)
+{
+    const bool parallel = n * elemBytes >= TMS_PARALLEL_THRESHOLD
+                          && pool.size() > 1;
+
+    if (mode == TMS_SUM_PAIRWISE && std::is_floating_point<A>::value)
+    {
+        if (n == 0)
+            return A();
+        const std::size_t blocks = (n + TMS_PAIRWISE_BLOCK - 1)
+                                   / TMS_PAIRWISE_BLOCK;
+        TMSArray<A> results(blocks);
+        auto doBlocks = [&](std::size_t firstBlock, std::size_t lastBlock,
+                            std::size_t)
+        {
+            for (std::size_t k = firstBlock; k < lastBlock; ++k)
+            {
+                std::size_t first = k * TMS_PAIRWISE_BLOCK;
+                std::size_t last = first + TMS_PAIRWISE_BLOCK < n
+                                   ? first + TMS_PAIRWISE_BLOCK : n;
+                results[k] = leaf8(first, last);
+            }
+        };
+        if (parallel)
+            tms_parallel_for(blocks, doBlocks, pool);
+        else
+            doBlocks(0, blocks, 0);
+        return tms_red_pairwise(results.begin(), 0, blocks);
+    }
+
+    if (!parallel)
+        return leaf(0, n);
+
+    TMSArray<A> partial(pool.size());
+    for (std::size_t t = 0; t < partial.size(); ++t)
+        partial[t] = A();
+    tms_parallel_for(n, [&](std::size_t first, std::size_t last,
+                            std::size_t tid)
+    {
+        partial[tid] = leaf(first, last);
+    }, pool, elemBytes < TMS_PAGE_BYTES ? TMS_PAGE_BYTES / elemBytes : 1,
+       offset);
+    A total = A();
+    for (std::size_t t = 0; t < partial.size(); ++t)
+        total = total + partial[t];
+    return total;
+}
+
+
+// tms_sum
+// Basic Guarantee
+// Exception-Neutral
+// Pre: None
+// Post:
+//      Returns sum of arr as tms_sum_t<Valtype> (integers widen to 64
+//      bits); 0 for an empty array. mode chooses the floating-point
+//      summation order (integer sums are exact either way). Arrays above
+//      TMS_PARALLEL_THRESHOLD bytes are reduced on pool.
+template <typename Valtype>
+tms_sum_t<Valtype> tms_sum(const TMSArray<Valtype> & arr,
+                           TMSSumMode mode = TMS_SUM_FAST,
+                           TMSThreadPool & pool = tms_default_pool())
+{
+    using A = tms_sum_t<Valtype>;
+    const Valtype * data = arr.begin();
+    return tms_red_driver<A>(arr.size(), sizeof(Valtype),
+                             tms_page_offset(data), mode, pool,
+        [&](std::size_t first, std::size_t last)
+        { return tms_red_sum_range(data + first, last - first); },
+        [&](std::size_t first, std::size_t last)
+        {
+            if constexpr (std::is_floating_point<Valtype>::value)
+                return tms_red_sum8_range(data + first, last - first);
+            else
+                return tms_red_sum_range(data + first, last - first);
+        });
+}
+
+
+// tms_dot
+// Basic Guarantee
+// Exception-Neutral
+// Pre:
+//      a.size() == b.size()
+// Post:
+//      Returns sum of a[i]*b[i] as tms_sum_t<Valtype> (integer products
+//      are formed in 64 bits); mode and threading as for tms_sum
+template <typename Valtype>
+tms_sum_t<Valtype> tms_dot(const TMSArray<Valtype> & a,
+                           const TMSArray<Valtype> & b,
+                           TMSSumMode mode = TMS_SUM_FAST,
+                           TMSThreadPool & pool = tms_default_pool())
+{
+    using A = tms_sum_t<Valtype>;
+    const Valtype * x = a.begin();
+    const Valtype * y = b.begin();
+    return tms_red_driver<A>(a.size(), 2 * sizeof(Valtype), 0, mode, pool,
+        [&](std::size_t first, std::size_t last)
+        { return tms_red_dot_range(x + first, y + first, last - first); },
+        [&](std::size_t first, std::size_t last)
+        {
+            if constexpr (std::is_floating_point<Valtype>::value)
+                return tms_red_dot8_range(x + first, y + first, last - first);
+            else
+                return tms_red_dot_range(x + first, y + first, last - first);
+        });
+}
+
+
+// tms_minmax
+// Basic Guarantee
+// Exception-Neutral
+// Pre:
+//      !arr.empty()
+//      Valtype has operator<; floating data contains no NaN
+// Post:
+//      Returns { smallest, largest } element. Arrays above
+//      TMS_PARALLEL_THRESHOLD bytes are reduced on pool.
+template <typename Valtype>
+std::pair<Valtype, Valtype> tms_minmax(const TMSArray<Valtype> & arr,
+                                       TMSThreadPool & pool
+                                           = tms_default_pool())
+{
+    const Valtype * data = arr.begin();
+    std::pair<Valtype, Valtype> result(arr[0], arr[0]);
+    if (arr.size() * sizeof(Valtype) < TMS_PARALLEL_THRESHOLD
+        || pool.size() == 1)
+    {
+        tms_red_minmax_range(data, arr.size(), result.first, result.second);
+        return result;
+    }
+
+    TMSArray<std::pair<Valtype, Valtype>> partial(pool.size());
+    for (std::size_t t = 0; t < partial.size(); ++t)
+        partial[t] = result;
+    tms_parallel_for(arr.size(), [&](std::size_t first, std::size_t last,
+                                     std::size_t tid)
+    {
+        tms_red_minmax_range(data + first, last - first,
+                             partial[tid].first, partial[tid].second);
+    }, pool, tms_page_elems<Valtype>(), tms_page_offset(data));
+    for (std::size_t t = 0; t < partial.size(); ++t)
+    {
+        if (partial[t].first < result.first)
+            result.first = partial[t].first;
+        if (result.second < partial[t].second)
+            result.second = partial[t].second;
+    }
+    return result;
+}
+
+
+// tms_min
+// Basic Guarantee
+// Exception-Neutral
+// Pre: as for tms_minmax
+// Post:
+//      Returns smallest element
+template <typename Valtype>
+Valtype tms_min(const TMSArray<Valtype> & arr,
+                TMSThreadPool & pool = tms_default_pool())
+{
+    return tms_minmax(arr, pool).first;
+}
+
+
+// tms_max
+// Basic Guarantee
+// Exception-Neutral
+// Pre: as for tms_minmax
+// Post:
+//      Returns largest element
+template <typename Valtype>
+Valtype tms_max(const TMSArray<Valtype> & arr,
+                TMSThreadPool & pool = tms_default_pool())
+{
+    return tms_minmax(arr, pool).second;
+}
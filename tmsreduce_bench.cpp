@@ -0,0 +1,92 @@
+// tmsreduce_bench.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Benchmark: tms_sum (fast and pairwise), tms_minmax and tms_dot at each
+//  ISA level and with the thread pool, vs. a hand-written loop.
+// Usage: tmsreduce_bench [elements=33554432] [threads=hardware]
+// Requires tmsreduce.hpp, tmssimd.hpp, tmsparallel.hpp, tmsarray.hpp,
+//  tmsbench.hpp
+
+#include "tmsreduce.hpp"
+#include "tmsbench.hpp"
+
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::int64_t;
+#include <iostream>
+using std::cout;
+#include <string>
+using std::string;
+
+
+// benchType
+// One table per element type
+template <typename T>
+void benchType(const string & name, size_t n, TMSThreadPool & pool)
+{
+    TMSArray<T> a(n), b(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        a[i] = T(i % 1000) / T(7);
+        b[i] = T(i % 13);
+    }
+    const size_t bytes = n * sizeof(T);
+    const TMSIsa best = tms_detect_isa();
+    TMSThreadPool one(1);
+
+    cout << "\n== TMSArray<" << name << ">, " << n << " elements ==\n";
+
+    double secs = tms_time_best(5, [&]
+    {
+        T acc = T();
+        for (size_t i = 0; i < n; ++i)
+            acc += a[i];
+        tms_sink(acc);
+    });
+    tms_report("hand loop sum", secs, bytes);
+
+    for (int level = TMS_ISA_SCALAR; level <= best; ++level)
+    {
+        tms_isa_limit() = TMSIsa(level);
+        string isa = tms_isa_name(TMSIsa(level));
+        secs = tms_time_best(5, [&]{ tms_sink(tms_sum(a, TMS_SUM_FAST, one)); });
+        tms_report("sum fast " + isa, secs, bytes);
+        secs = tms_time_best(5, [&]
+        {
+            tms_sink(tms_sum(a, TMS_SUM_PAIRWISE, one));
+        });
+        tms_report("sum pairwise " + isa, secs, bytes);
+        secs = tms_time_best(5, [&]{ tms_sink(tms_minmax(a, one)); });
+        tms_report("minmax " + isa, secs, bytes);
+        secs = tms_time_best(5, [&]
+        {
+            tms_sink(tms_dot(a, b, TMS_SUM_FAST, one));
+        });
+        tms_report("dot fast " + isa, secs, 2 * bytes);
+    }
+    tms_isa_limit() = best;
+
+    string threads = std::to_string(pool.size()) + " threads";
+    secs = tms_time_best(5, [&]{ tms_sink(tms_sum(a, TMS_SUM_FAST, pool)); });
+    tms_report("sum fast, " + threads, secs, bytes);
+    secs = tms_time_best(5, [&]
+    {
+        tms_sink(tms_sum(a, TMS_SUM_PAIRWISE, pool));
+    });
+    tms_report("sum pairwise, " + threads, secs, bytes);
+    secs = tms_time_best(5, [&]{ tms_sink(tms_dot(a, b, TMS_SUM_FAST, pool)); });
+    tms_report("dot fast, " + threads, secs, 2 * bytes);
+}
+
+
+int main(int argc, char * argv[])
+{
+    const size_t n = tms_arg(argc, argv, 1, size_t(1) << 25);
+    TMSThreadPool pool(tms_arg(argc, argv, 2, 0));
+    benchType<float>("float", n, pool);
+    benchType<double>("double", n, pool);
+    benchType<int64_t>("int64_t", n, pool);
+    return 0;
+}
@@ -0,0 +1,256 @@
+// tmsreduce_test.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Test program for tms_sum, tms_dot, tms_min, tms_max, tms_minmax
+// Uses the "doctest" unit-testing framework, version 2
+// Requires doctest.h, tmsreduce.hpp, tmssimd.hpp, tmsparallel.hpp,
+//  tmsarray.hpp
+
+// Includes for code to be tested
+#include "tmsreduce.hpp"     // For tms_sum, tms_dot, tms_minmax, ...
+#include "tmsreduce.hpp"     // Double-inclusion check, for testing only
+
+// Includes for the "doctest" unit-testing framework
+#define DOCTEST_CONFIG_IMPLEMENT
+                             // We write our own main
+#define DOCTEST_CONFIG_SUPER_FAST_ASSERTS
+                             // Reduce compile time
+#include "doctest.h"         // For doctest
+
+// Includes for all test programs
+#include <iostream>
+using std::cout;
+using std::endl;
+using std::cin;
+#include <string>
+using std::string;
+
+// Additional includes for this test program
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::int32_t;
+using std::int64_t;
+using std::uint32_t;
+#include <cmath>
+using std::fabs;
+#include <cstring>
+using std::memcmp;
+#include <algorithm>
+using std::minmax_element;
+
+// Printable name for this test suite
+const string test_suite_name =
+    "TMSArray reductions";
+
+
+// *********************************************************************
+// Helper Functions for This Test Program
+// *********************************************************************
+
+
+// fillPattern
+// Deterministic pseudo-random contents, both signs, mixed magnitudes
+template <typename T>
+void fillPattern(TMSArray<T> & ta, unsigned seed)
+{
+    unsigned x = seed * 2654435761u + 1;
+    for (size_t i = 0; i < ta.size(); ++i)
+    {
+        x = x * 1103515245u + 12345u;
+        ta[i] = T(int((x >> 8) % 20001) - 10000);
+        if (i % 7 == 3)
+            ta[i] = T(ta[i] / T(3));
+    }
+}
+
+
+// checkAllLevels
+// Runs check() once for each ISA level this CPU has
+template <typename Func>
+void checkAllLevels(Func check)
+{
+    const TMSIsa best = tms_detect_isa();
+    for (int level = TMS_ISA_SCALAR; level <= best; ++level)
+    {
+        tms_isa_limit() = TMSIsa(level);
+        INFO( "ISA " << tms_isa_name(TMSIsa(level)) );
+        check();
+    }
+    tms_isa_limit() = best;
+}
+
+
+// checkExact
+// Integer sum, dot and minmax must equal a plain loop exactly
+template <typename T>
+void checkExact()
+{
+    TMSThreadPool pool(3);
+    for (size_t size : { 1, 3, 17, 64, 1001, 70001 })
+    {
+        TMSArray<T> a(size), b(size);
+        fillPattern(a, 1);
+        fillPattern(b, 2);
+        tms_sum_t<T> sum = 0, dot = 0;
+        for (size_t i = 0; i < size; ++i)
+        {
+            sum += tms_sum_t<T>(a[i]);
+            dot += tms_sum_t<T>(a[i]) * tms_sum_t<T>(b[i]);
+        }
+        auto mm = minmax_element(a.begin(), a.end());
+        checkAllLevels([&]
+        {
+            INFO( "size " << size );
+            REQUIRE( tms_sum(a, TMS_SUM_FAST, pool) == sum );
+            REQUIRE( tms_sum(a, TMS_SUM_PAIRWISE, pool) == sum );
+            REQUIRE( tms_dot(a, b, TMS_SUM_FAST, pool) == dot );
+            REQUIRE( tms_min(a, pool) == *mm.first );
+            REQUIRE( tms_max(a, pool) == *mm.second );
+        });
+    }
+}
+
+
+// checkFloating
+// Sum/dot close to a long double reference; pairwise bit-identical on
+//  every ISA level and thread count; minmax exact
+template <typename T>
+void checkFloating()
+{
+    TMSThreadPool one(1), four(4);
+    for (size_t size : { 1, 9, 100, 2048, 2049, 50000, 1100000 })
+    {
+        TMSArray<T> a(size), b(size);
+        fillPattern(a, 3);
+        fillPattern(b, 4);
+        long double sum = 0, dot = 0;
+        for (size_t i = 0; i < size; ++i)
+        {
+            sum += a[i];
+            dot += (long double)a[i] * b[i];
+        }
+        auto mm = minmax_element(a.begin(), a.end());
+        const T refSum = tms_sum(a, TMS_SUM_PAIRWISE, one);
+        const T refDot = tms_dot(a, b, TMS_SUM_PAIRWISE, one);
+        const long double tol = 1e-4L * (long double)size * 10000;
+
+        checkAllLevels([&]
+        {
+            INFO( "size " << size );
+            REQUIRE( fabs((long double)tms_sum(a, TMS_SUM_FAST, four) - sum)
+                     <= tol );
+            REQUIRE( fabs((long double)tms_dot(a, b, TMS_SUM_FAST, four)
+                          - dot) <= tol * 10000 );
+            T s1 = tms_sum(a, TMS_SUM_PAIRWISE, one);
+            T s4 = tms_sum(a, TMS_SUM_PAIRWISE, four);
+            T d4 = tms_dot(a, b, TMS_SUM_PAIRWISE, four);
+            REQUIRE( memcmp(&s1, &refSum, sizeof(T)) == 0 );
+            REQUIRE( memcmp(&s4, &refSum, sizeof(T)) == 0 );
+            REQUIRE( memcmp(&d4, &refDot, sizeof(T)) == 0 );
+            auto got = tms_minmax(a, four);
+            REQUIRE( got.first == *mm.first );
+            REQUIRE( got.second == *mm.second );
+        });
+    }
+}
+
+
+// *********************************************************************
+// Test Cases
+// *********************************************************************
+
+
+TEST_CASE( "Integer reductions are exact" )
+{
+    SUBCASE( "int" )      { checkExact<int32_t>(); }
+    SUBCASE( "int64_t" )  { checkExact<int64_t>(); }
+    SUBCASE( "uint32_t" ) { checkExact<uint32_t>(); }
+    SUBCASE( "short" )    { checkExact<short>(); }
+}
+
+
+TEST_CASE( "Floating reductions" )
+{
+    SUBCASE( "float" )  { checkFloating<float>(); }
+    SUBCASE( "double" ) { checkFloating<double>(); }
+}
+
+
+TEST_CASE( "Reduction edge cases" )
+{
+    SUBCASE( "Empty sum and dot are zero" )
+    {
+        TMSArray<double> td(0);
+        REQUIRE( tms_sum(td) == 0.0 );
+        REQUIRE( tms_sum(td, TMS_SUM_PAIRWISE) == 0.0 );
+        REQUIRE( tms_dot(td, td) == 0.0 );
+    }
+
+    SUBCASE( "int32 sum does not overflow" )
+    {
+        TMSArray<int32_t> ti(1000);
+        for (size_t i = 0; i < ti.size(); ++i)
+            ti[i] = 2000000000;
+        REQUIRE( tms_sum(ti) == int64_t(2000000000) * 1000 );
+    }
+
+    SUBCASE( "Pairwise beats naive float accumulation" )
+    {
+        TMSArray<float> tf(1 << 22);
+        for (size_t i = 0; i < tf.size(); ++i)
+            tf[i] = 0.1f;
+        float naive = 0.0f;
+        for (size_t i = 0; i < tf.size(); ++i)
+            naive += tf[i];
+        const double exact = double(0.1f) * double(tf.size());
+        REQUIRE( fabs(tms_sum(tf, TMS_SUM_PAIRWISE) - exact)
+                 < fabs(naive - exact) );
+    }
+}
+
+
+// *********************************************************************
+// Main Program
+// *********************************************************************
+
+
+// userPause
+// Wait for user to press ENTER: read all chars through first newline.
+void userPause()
+{
+    std::cout.flush();
+    while (std::cin.get() != '\n') ;
+}
+
+
+// Main program
+// Run all tests. Prompt for ENTER before exiting.
+int main(int argc,
+         char *argv[])
+{
+    doctest::Context dtcontext;
+                             // Primary doctest object
+    int dtresult;            // doctest return code; for return by main
+
+    // Handle command line
+    dtcontext.applyCommandLine(argc, argv);
+    dtresult = 0;            // doctest flags no command-line errors
+                             //  (strange but true)
+
+    if (!dtresult)           // Continue only if no command-line error
+    {
+        // Run test suites
+        cout << "BEGIN tests for " << test_suite_name << "\n" << endl;
+        dtresult = dtcontext.run();
+        cout << "END tests for " << test_suite_name << "\n" << endl;
+    }
+
+    // Wait for user
+    std::cout << "Press ENTER to quit ";
+    userPause();
+
+    // Program return value is return code from doctest
+    return dtresult;
+}
@@ -0,0 +1,380 @@
+// tmsring.hpp
+// Matthew Johnson
+// 10/17/2026
+// bounded lock-free ring buffers (SPSC and MPMC) on TMSArray storage
+
+#pragma once
+// for single inclusion
+
+#include "tmsarray.hpp"
+// For class template TMSArray
+
+#include <cstddef>
+// For std::size_t
+
+#include <atomic>
+// For std::atomic
+// For std::memory_order_*
+
+#include <type_traits>
+// For std::is_nothrow_copy_assignable
+// For std::is_nothrow_move_assignable
+
+#include <utility>
+// For std::move
+
+
+
+// Rounds up to a power of two (minimum 2) so slot = index & mask
+constexpr std::size_t tms_ring_capacity(std::size_t requested) noexcept
+{
+    std::size_t cap = 2;
+    while (cap < requested)
+        cap *= 2;
+    return cap;
+}
+
+
+
+// *********************************************************************
+// class TMSSpscRing - Class definition
+// *********************************************************************
+
+
+// class TMSSpscRing
+// Bounded single-producer/single-consumer queue. _head and _tail are
+//  free-running counters on their own cache lines; each side also keeps
+//  a private cached copy of the other side's counter so it only touches
+//  the shared line when the ring looks full/empty. The *_n functions
+//  move a whole batch and publish it with one release store.
+// Requirements on Types:
+//     Valtype must be default-constructible and move-assignable.
+// Invariants:
+//     _slots.size() == capacity(), a power of two.
+//     0 <= _tail - _head <= capacity().
+//     Only the producer writes _tail/_cachedHead; only the consumer
+//      writes _head/_cachedTail.
+template <typename Valtype>
+class TMSSpscRing
+{
+
+public:
+
+
+    using value_type = Valtype;
+
+    using size_type  = std::size_t;
+
+
+// ***** TMSSpscRing: ctors, dctor *****
+public:
+
+
+    // Ctor from capacity
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      capacity() == requested rounded up to a power of two
+    explicit TMSSpscRing(size_type requested)
+        :_slots(tms_ring_capacity(requested)),
+         _mask(_slots.size() - 1),
+         _head(0),
+         _cachedTail(0),
+         _tail(0),
+         _cachedHead(0)
+    {}
+
+
+    // No copy/move: other threads hold references to the counters
+    TMSSpscRing(const TMSSpscRing & other) = delete;
+    TMSSpscRing & operator=(const TMSSpscRing & other) = delete;
+
+
+// ***** TMSSpscRing: general public functions *****
+public:
+
+
+    // capacity
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns maximum number of queued items
+    size_type capacity() const noexcept
+    {
+        return _mask + 1;
+    }
+
+
+    // size_approx
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns number of queued items at some recent instant
+    size_type size_approx() const noexcept
+    {
+        size_type tail = _tail.load(std::memory_order_acquire);
+        size_type head = _head.load(std::memory_order_acquire);
+        return tail - head;
+    }
+
+
+    // try_push (producer only)
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns false if ring was full; else item is queued
+    bool try_push(const value_type & item)
+    {
+        return try_push_n(&item, 1) == 1;
+    }
+
+
+    // try_push_n (producer only)
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      [items, items + count) is a valid range
+    // Post:
+    //      Returns k, the number queued (a prefix of items); all k
+    //      become visible to the consumer at once
+    size_type try_push_n(const value_type * items, size_type count)
+    {
+        size_type tail = _tail.load(std::memory_order_relaxed);
+        if (capacity() - (tail - _cachedHead) < count)
+            _cachedHead = _head.load(std::memory_order_acquire);
+        size_type room = capacity() - (tail - _cachedHead);
+        if (count > room)
+            count = room;
+
+        for (size_type k = 0; k < count; ++k)
+            _slots[(tail + k) & _mask] = items[k];
+        _tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+
+    // try_pop (consumer only)
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns false if ring was empty; else oldest item moved into
+    //      out and removed
+    bool try_pop(value_type & out)
+    {
+        return try_pop_n(&out, 1) == 1;
+    }
+
+
+    // try_pop_n (consumer only)
+    // Basic Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      [out, out + count) is a valid range
+    // Post:
+    //      Returns k, the number moved into out[0..k) in queue order;
+    //      the k slots are released to the producer at once
+    size_type try_pop_n(value_type * out, size_type count)
+    {
+        size_type head = _head.load(std::memory_order_relaxed);
+        if (_cachedTail - head < count)
+            _cachedTail = _tail.load(std::memory_order_acquire);
+        size_type avail = _cachedTail - head;
+        if (count > avail)
+            count = avail;
+
+        for (size_type k = 0; k < count; ++k)
+            out[k] = std::move(_slots[(head + k) & _mask]);
+        _head.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+
+// ***** TMSSpscRing: data members *****
+private:
+
+    TMSArray<value_type> _slots;
+    size_type            _mask;
+
+    // Consumer's line
+    alignas(64) std::atomic<size_type> _head;
+    size_type                          _cachedTail;
+
+    // Producer's line
+    alignas(64) std::atomic<size_type> _tail;
+    size_type                          _cachedHead;
+
+    char _pad[64 - 2 * sizeof(size_type)];  // keep neighbours off _tail's line
+
+}; // end of class
+
+
+
+// *********************************************************************
+// class TMSMpmcRing - Class definition
+// *********************************************************************
+
+
+// class TMSMpmcRing
+// Bounded multi-producer/multi-consumer queue (per-slot sequence
+//  numbers). Slot i is writable for ticket t when its sequence equals t
+//  and readable when it equals t + 1; producers and consumers claim
+//  tickets with a CAS on their own cache-line-padded counter.
+// Requirements on Types:
+//     Valtype must be default-constructible, and its copy and move
+//      assignment must not throw: a ticket is claimed before the value
+//      is stored, and a slot left unpublished would stall every thread
+//      that reaches it.
+// Invariants:
+//     _slots.size() == capacity(), a power of two.
+//     For each slot, seq % capacity() == slot index at rest.
+template <typename Valtype>
+class TMSMpmcRing
+{
+
+    static_assert(std::is_nothrow_copy_assignable<Valtype>::value
+                  && std::is_nothrow_move_assignable<Valtype>::value,
+                  "TMSMpmcRing needs no-throw copy and move assignment");
+
+public:
+
+
+    using value_type = Valtype;
+
+    using size_type  = std::size_t;
+
+
+private:
+
+
+    struct Slot
+    {
+        std::atomic<size_type> seq;
+        value_type             value;
+    };
+
+
+// ***** TMSMpmcRing: ctors, dctor *****
+public:
+
+
+    // Ctor from capacity
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      capacity() == requested rounded up to a power of two
+    explicit TMSMpmcRing(size_type requested)
+        :_slots(tms_ring_capacity(requested)),
+         _mask(_slots.size() - 1),
+         _enqueue(0),
+         _dequeue(0)
+    {
+        for (size_type i = 0; i < _slots.size(); ++i)
+            _slots[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+
+    // No copy/move: other threads hold references to the counters
+    TMSMpmcRing(const TMSMpmcRing & other) = delete;
+    TMSMpmcRing & operator=(const TMSMpmcRing & other) = delete;
+
+
+// ***** TMSMpmcRing: general public functions *****
+public:
+
+
+    // capacity
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns maximum number of queued items
+    size_type capacity() const noexcept
+    {
+        return _mask + 1;
+    }
+
+
+    // try_push
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns false if ring was full; else item is queued
+    bool try_push(const value_type & item) noexcept
+    {
+        size_type pos = _enqueue.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Slot & slot = _slots[pos & _mask];
+            size_type seq = slot.seq.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+            if (diff == 0)
+            {
+                if (_enqueue.compare_exchange_weak(pos, pos + 1,
+                                                   std::memory_order_relaxed))
+                {
+                    slot.value = item;
+                    slot.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+                return false;   // slot still holds an unread item: full
+            else
+                pos = _enqueue.load(std::memory_order_relaxed);
+        }
+    }
+
+
+    // try_pop
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns false if ring was empty; else an item is moved into
+    //      out and removed
+    bool try_pop(value_type & out) noexcept
+    {
+        size_type pos = _dequeue.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Slot & slot = _slots[pos & _mask];
+            size_type seq = slot.seq.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+            if (diff == 0)
+            {
+                if (_dequeue.compare_exchange_weak(pos, pos + 1,
+                                                   std::memory_order_relaxed))
+                {
+                    out = std::move(slot.value);
+                    slot.seq.store(pos + capacity(),
+                                   std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+                return false;   // slot not yet written: empty
+            else
+                pos = _dequeue.load(std::memory_order_relaxed);
+        }
+    }
+
+
+// ***** TMSMpmcRing: data members *****
+private:
+
+    TMSArray<Slot> _slots;
+    size_type      _mask;
+
+    alignas(64) std::atomic<size_type> _enqueue;
+    alignas(64) std::atomic<size_type> _dequeue;
+
+    char _pad[64 - sizeof(std::atomic<size_type>)];
+
+}; // end of class
@@ -0,0 +1,203 @@
+// tmsring_bench.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Benchmark: throughput and enqueue-to-dequeue latency of TMSSpscRing
+//  (1P1C) and TMSMpmcRing (1P1C, 4P4C, 16P16C), against a mutex-guarded
+//  TMSArray queue.
+// Usage: tmsring_bench [items=2000000] [capacity=1024]
+// Requires tmsring.hpp, tmsarray.hpp, tmsbench.hpp
+
+#include "tmsring.hpp"
+#include "tmsbench.hpp"
+
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::uint64_t;
+#include <iostream>
+using std::cout;
+#include <string>
+using std::string;
+using std::to_string;
+#include <vector>
+using std::vector;
+#include <thread>
+using std::thread;
+#include <atomic>
+using std::atomic;
+#include <mutex>
+using std::mutex;
+using std::lock_guard;
+#include <algorithm>
+using std::sort;
+#include <chrono>
+
+
+// nowNs
+// Monotonic timestamp carried in each item for latency measurement
+uint64_t nowNs()
+{
+    return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+
+// class MutexQueue
+// Baseline: TMSArray used as a circular buffer under one mutex
+class MutexQueue
+{
+public:
+    explicit MutexQueue(size_t cap) : _data(cap), _head(0), _count(0) {}
+
+    bool try_push(const uint64_t & item)
+    {
+        lock_guard<mutex> guard(_lock);
+        if (_count == _data.size())
+            return false;
+        _data[(_head + _count++) % _data.size()] = item;
+        return true;
+    }
+
+    bool try_pop(uint64_t & out)
+    {
+        lock_guard<mutex> guard(_lock);
+        if (_count == 0)
+            return false;
+        out = _data[_head];
+        _head = (_head + 1) % _data.size();
+        --_count;
+        return true;
+    }
+
+private:
+    mutex              _lock;
+    TMSArray<uint64_t> _data;
+    size_t             _head;
+    size_t             _count;
+};
+
+
+// runQueue
+// producers x consumers threads move items through ring; prints
+//  throughput and latency percentiles
+template <typename Ring>
+void runQueue(const string & label, Ring & ring, size_t producers,
+              size_t consumers, size_t items)
+{
+    const size_t per = items / producers;
+    const size_t total = per * producers;
+    atomic<size_t> consumed(0);
+    vector<vector<uint64_t>> lat(consumers);
+
+    auto start = std::chrono::steady_clock::now();
+    vector<thread> threads;
+    for (size_t p = 0; p < producers; ++p)
+        threads.emplace_back([&]
+        {
+            for (size_t i = 0; i < per; )
+                if (ring.try_push(nowNs()))
+                    ++i;
+                else
+                    std::this_thread::yield();
+        });
+    for (size_t c = 0; c < consumers; ++c)
+        threads.emplace_back([&, c]
+        {
+            uint64_t stamp;
+            size_t mine = 0;
+            while (consumed.load(std::memory_order_relaxed) < total)
+            {
+                if (ring.try_pop(stamp))
+                {
+                    consumed.fetch_add(1, std::memory_order_relaxed);
+                    if ((mine++ & 63) == 0)   // sample 1 in 64
+                        lat[c].push_back(nowNs() - stamp);
+                }
+                else
+                    std::this_thread::yield();
+            }
+        });
+    for (auto & th : threads)
+        th.join();
+    double secs = tms_seconds_since(start);
+
+    vector<uint64_t> all;
+    for (auto & v : lat)
+        all.insert(all.end(), v.begin(), v.end());
+    sort(all.begin(), all.end());
+    tms_report(label, secs);
+    if (!all.empty())
+        cout << "    " << double(total) / secs / 1e6 << " Mitems/s, latency "
+             << "p50 " << all[all.size() / 2] << " ns, p99 "
+             << all[all.size() * 99 / 100] << " ns\n";
+}
+
+
+int main(int argc, char * argv[])
+{
+    const size_t items = tms_arg(argc, argv, 1, 2000000);
+    const size_t cap = tms_arg(argc, argv, 2, 1024);
+
+    cout << items << " items, capacity " << cap << ", "
+         << std::thread::hardware_concurrency() << " hardware threads\n\n";
+
+    {
+        TMSSpscRing<uint64_t> ring(cap);
+        runQueue("TMSSpscRing 1P1C", ring, 1, 1, items);
+    }
+
+    // Batched publish: producer stages 32 items per release store
+    {
+        TMSSpscRing<uint64_t> ring(cap);
+        const size_t BATCH = 32;
+        const size_t total = items / BATCH * BATCH;
+        auto start = std::chrono::steady_clock::now();
+        thread producer([&]
+        {
+            uint64_t batch[BATCH];
+            for (size_t i = 0; i < total; )
+            {
+                for (size_t k = 0; k < BATCH; ++k)
+                    batch[k] = i + k;
+                size_t off = 0;
+                while (off < BATCH)
+                {
+                    size_t pushed = ring.try_push_n(batch + off, BATCH - off);
+                    if (pushed == 0)
+                        std::this_thread::yield();
+                    off += pushed;
+                }
+                i += BATCH;
+            }
+        });
+        uint64_t out[BATCH];
+        for (size_t got = 0; got < total; )
+        {
+            size_t popped = ring.try_pop_n(out, BATCH);
+            if (popped == 0)
+                std::this_thread::yield();
+            got += popped;
+        }
+        producer.join();
+        double secs = tms_seconds_since(start);
+        tms_report("TMSSpscRing 1P1C, batch 32", secs);
+        cout << "    " << double(total) / secs / 1e6 << " Mitems/s\n";
+    }
+
+    for (size_t threads : { size_t(1), size_t(4), size_t(16) })
+    {
+        string tag = to_string(threads) + "P" + to_string(threads) + "C";
+        {
+            TMSMpmcRing<uint64_t> ring(cap);
+            runQueue("TMSMpmcRing " + tag, ring, threads, threads, items);
+        }
+        {
+            MutexQueue queue(cap);
+            runQueue("mutex + TMSArray " + tag, queue, threads, threads,
+                     items);
+        }
+    }
+
+    return 0;
+}
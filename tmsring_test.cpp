@@ -0,0 +1,223 @@
+// tmsring_test.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Test program for class templates TMSSpscRing, TMSMpmcRing
+// Uses the "doctest" unit-testing framework, version 2
+// Requires doctest.h, tmsring.hpp, tmsarray.hpp
+
+// Includes for code to be tested
+#include "tmsring.hpp"       // For TMSSpscRing, TMSMpmcRing
+#include "tmsring.hpp"       // Double-inclusion check, for testing only
+
+// Includes for the "doctest" unit-testing framework
+#define DOCTEST_CONFIG_IMPLEMENT
+                             // We write our own main
+#define DOCTEST_CONFIG_SUPER_FAST_ASSERTS
+                             // Reduce compile time
+#include "doctest.h"         // For doctest
+
+// Includes for all test programs
+#include <iostream>
+using std::cout;
+using std::endl;
+using std::cin;
+#include <string>
+using std::string;
+
+// Additional includes for this test program
+#include <cstddef>
+using std::size_t;
+#include <thread>
+using std::thread;
+#include <vector>
+using std::vector;
+#include <atomic>
+using std::atomic;
+
+// Printable name for this test suite
+const string test_suite_name =
+    "class templates TMSSpscRing, TMSMpmcRing";
+
+
+// *********************************************************************
+// Test Cases
+// *********************************************************************
+
+
+TEST_CASE( "TMSSpscRing" )
+{
+    SUBCASE( "Capacity rounds up to power of two" )
+    {
+        TMSSpscRing<int> tr(5);
+        REQUIRE( tr.capacity() == 8 );
+    }
+
+    SUBCASE( "Single-thread full/empty behaviour" )
+    {
+        TMSSpscRing<string> tr(4);
+        string s;
+        REQUIRE_FALSE( tr.try_pop(s) );
+        REQUIRE( tr.try_push("a") );
+        REQUIRE( tr.try_push("b") );
+        REQUIRE( tr.try_push("c") );
+        REQUIRE( tr.try_push("d") );
+        REQUIRE_FALSE( tr.try_push("e") );
+        REQUIRE( tr.size_approx() == 4 );
+        REQUIRE( tr.try_pop(s) );
+        REQUIRE( s == "a" );
+        REQUIRE( tr.try_push("e") );
+
+        string batch[8];
+        REQUIRE( tr.try_pop_n(batch, 8) == 4 );
+        REQUIRE( batch[0] == "b" );
+        REQUIRE( batch[3] == "e" );
+    }
+
+    SUBCASE( "Batch push is clipped to free space" )
+    {
+        TMSSpscRing<int> tr(4);
+        int items[6] = { 1, 2, 3, 4, 5, 6 };
+        REQUIRE( tr.try_push_n(items, 6) == 4 );
+        int out[6] = {};
+        REQUIRE( tr.try_pop_n(out, 6) == 4 );
+        REQUIRE( out[3] == 4 );
+    }
+
+    SUBCASE( "Two threads, FIFO order across wraparound" )
+    {
+        const size_t COUNT = 200000;
+        TMSSpscRing<size_t> tr(64);
+        thread producer([&]
+        {
+            for (size_t i = 0; i < COUNT; )
+                if (tr.try_push(i))
+                    ++i;
+                else
+                    std::this_thread::yield();
+        });
+        bool inOrder = true;
+        for (size_t expect = 0; expect < COUNT; )
+        {
+            size_t got;
+            if (tr.try_pop(got))
+            {
+                inOrder = inOrder && got == expect;
+                ++expect;
+            }
+            else
+                std::this_thread::yield();
+        }
+        producer.join();
+        REQUIRE( inOrder );
+    }
+}
+
+
+TEST_CASE( "TMSMpmcRing" )
+{
+    SUBCASE( "Single-thread full/empty behaviour" )
+    {
+        TMSMpmcRing<int> tr(2);
+        int out;
+        REQUIRE_FALSE( tr.try_pop(out) );
+        REQUIRE( tr.try_push(1) );
+        REQUIRE( tr.try_push(2) );
+        REQUIRE_FALSE( tr.try_push(3) );
+        REQUIRE( tr.try_pop(out) );
+        REQUIRE( out == 1 );
+        REQUIRE( tr.try_push(3) );
+        REQUIRE( tr.try_pop(out) );
+        REQUIRE( out == 2 );
+        REQUIRE( tr.try_pop(out) );
+        REQUIRE( out == 3 );
+    }
+
+    SUBCASE( "4 producers, 4 consumers: every item delivered once" )
+    {
+        const size_t PER = 50000;
+        const size_t THREADS = 4;
+        TMSMpmcRing<size_t> tr(128);
+        vector<atomic<int>> seen(PER * THREADS);
+        for (auto & s : seen)
+            s = 0;
+        atomic<size_t> consumed(0);
+
+        vector<thread> threads;
+        for (size_t t = 0; t < THREADS; ++t)
+        {
+            threads.emplace_back([&, t]
+            {
+                for (size_t i = 0; i < PER; )
+                    if (tr.try_push(t * PER + i))
+                        ++i;
+                    else
+                        std::this_thread::yield();
+            });
+            threads.emplace_back([&]
+            {
+                size_t item;
+                while (consumed < PER * THREADS)
+                    if (tr.try_pop(item))
+                    {
+                        ++seen[item];
+                        ++consumed;
+                    }
+                    else
+                        std::this_thread::yield();
+            });
+        }
+        for (auto & th : threads)
+            th.join();
+
+        bool once = true;
+        for (auto & s : seen)
+            once = once && s == 1;
+        REQUIRE( once );
+    }
+}
+
+
+// *********************************************************************
+// Main Program
+// *********************************************************************
+
+
+// userPause
+// Wait for user to press ENTER: read all chars through first newline.
+void userPause()
+{
+    std::cout.flush();
+    while (std::cin.get() != '\n') ;
+}
+
+
+// Main program
+// Run all tests. Prompt for ENTER before exiting.
+int main(int argc,
+         char *argv[])
+{
+    doctest::Context dtcontext;
+                             // Primary doctest object
+    int dtresult;            // doctest return code; for return by main
+
+    // Handle command line
+    dtcontext.applyCommandLine(argc, argv);
+    dtresult = 0;            // doctest flags no command-line errors
+                             //  (strange but true)
+
+    if (!dtresult)           // Continue only if no command-line error
+    {
+        // Run test suites
+        cout << "BEGIN tests for " << test_suite_name << "\n" << endl;
+        dtresult = dtcontext.run();
+        cout << "END tests for " << test_suite_name << "\n" << endl;
+    }
+
+    // Wait for user
+    std::cout << "Press ENTER to quit ";
+    userPause();
+
+    // Program return value is return code from doctest
+    return dtresult;
+}
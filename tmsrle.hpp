@@ -0,0 +1,443 @@
+// tmsrle.hpp
+// Matthew Johnson
+// 10/17/2026
+// run-length encoded array: value/end pairs, append, O(log runs)
+//  access, run-aware iteration and range aggregation without expansion
+
+#pragma once
+// for single inclusion
+
+#include "tmsarray.hpp"
+// For class template TMSArray
+
+#include "tmssorted.hpp"
+// For tms_partition_point
+
+#include <cstddef>
+// For std::size_t
+// For std::ptrdiff_t
+
+#include <iterator>
+// For std::forward_iterator_tag
+
+#include <algorithm>
+// For std::fill
+// For std::min
+
+
+
+// *********************************************************************
+// class TMSRleArray - Class definition
+// *********************************************************************
+
+
+// class TMSRleArray
+// Array stored as runs of equal values. Run r covers indices
+//  [run_begin(r), run_end(r)); only its value and end index are kept, so
+//  an array of long runs takes memory in proportion to its run count.
+//  Element access is a branchless binary search over run ends; range
+//  count and sum visit each run in the range once.
+// Requirements on Types:
+//     Valtype is copy-assignable, default-constructible and has ==.
+// Invariants:
+//     _runs[r].end strictly increases with r; the last end == size().
+//     Adjacent runs hold different values.
+template <typename Valtype>
+class TMSRleArray
+{
+
+public:
+
+
+    using value_type = Valtype;
+
+    using size_type  = std::size_t;
+
+
+    // One run: value repeated up to (not including) index end
+    struct Run
+    {
+        value_type value;
+        size_type  end;
+    };
+
+
+    // const_iterator
+    // Forward iterator over elements that steps run by run: ++ is O(1),
+    //  a compare of the position with the current run's end
+    class const_iterator
+    {
+    public:
+
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = Valtype;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const Valtype *;
+        using reference         = const Valtype &;
+
+        const_iterator() = default;
+
+        const_iterator(const Run * run, size_type pos) noexcept
+            :_run(run), _pos(pos)
+        {}
+
+        reference operator*() const noexcept
+        {
+            return _run->value;
+        }
+
+        pointer operator->() const noexcept
+        {
+            return &_run->value;
+        }
+
+        const_iterator & operator++() noexcept
+        {
+            if (++_pos == _run->end)
+                ++_run;
+            return *this;
+        }
+
+        const_iterator operator++(int) noexcept
+        {
+            const_iterator save = *this;
+            ++*this;
+            return save;
+        }
+
+        // index
+        // Position of this element in the array
+        size_type index() const noexcept
+        {
+            return _pos;
+        }
+
+        friend bool operator==(const const_iterator & a,
+                               const const_iterator & b) noexcept
+        {
+            return a._pos == b._pos;
+        }
+
+        friend bool operator!=(const const_iterator & a,
+                               const const_iterator & b) noexcept
+        {
+            return a._pos != b._pos;
+        }
+
+    private:
+
+        const Run * _run = nullptr;
+        size_type   _pos = 0;
+
+    };
+
+    using iterator = const_iterator;
+
+
+// ***** TMSRleArray: ctors *****
+public:
+
+
+    // Default ctor
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      empty()
+    TMSRleArray()
+        :_runs(0)
+    {}
+
+
+    // Ctor from plain array
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      holds values, in order
+    explicit TMSRleArray(const TMSArray<value_type> & values)
+        :TMSRleArray()
+    {
+        append(values.begin(), values.size());
+    }
+
+
+// ***** TMSRleArray: general public functions *****
+public:
+
+
+    // size
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns number of elements
+    size_type size() const noexcept
+    {
+        return _runs.empty() ? 0 : _runs[_runs.size() - 1].end;
+    }
+
+
+    // empty
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns size() == 0
+    bool empty() const noexcept
+    {
+        return _runs.empty();
+    }
+
+
+    // run_count
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns number of runs
+    size_type run_count() const noexcept
+    {
+        return _runs.size();
+    }
+
+
+    // run, run_begin, run_end
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      r < run_count()
+    // Post:
+    //      Returns run r; its first index; one past its last index
+    const Run & run(size_type r) const noexcept
+    {
+        return _runs[r];
+    }
+    size_type run_begin(size_type r) const noexcept
+    {
+        return r == 0 ? 0 : _runs[r - 1].end;
+    }
+    size_type run_end(size_type r) const noexcept
+    {
+        return _runs[r].end;
+    }
+
+
+    // find_run
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      index < size()
+    // Post:
+    //      Returns the run holding element index, in O(log run_count())
+    size_type find_run(size_type index) const noexcept
+    {
+        return tms_partition_point(_runs.begin(), _runs.size(),
+            [index](const Run & r) { return r.end <= index; });
+    }
+
+
+    // operator[]
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      index < size()
+    // Post:
+    //      Returns element index
+    const value_type & operator[](size_type index) const noexcept
+    {
+        return _runs[find_run(index)].value;
+    }
+
+
+    // begin, end
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns iterator to first element; iterator past the last
+    const_iterator begin() const noexcept
+    {
+        return const_iterator(_runs.begin(), 0);
+    }
+    const_iterator end() const noexcept
+    {
+        return const_iterator(_runs.end(), size());
+    }
+
+
+    // iterator_at
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      index <= size()
+    // Post:
+    //      Returns iterator to element index, found in O(log run_count())
+    const_iterator iterator_at(size_type index) const noexcept
+    {
+        return index == size() ? end()
+                               : const_iterator(_runs.begin() + find_run(index),
+                                                index);
+    }
+
+
+    // memory_bytes
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns bytes of runs in use
+    size_type memory_bytes() const noexcept
+    {
+        return _runs.size() * sizeof(Run);
+    }
+
+
+    // push_back
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      value appended: the last run grows if it holds value, else a
+    //      new run starts
+    void push_back(const value_type & value)
+    {
+        append_run(value, 1);
+    }
+
+
+    // append_run
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      count copies of value appended, in O(1) amortized
+    void append_run(const value_type & value, size_type count)
+    {
+        if (count == 0)
+            return;
+        const size_type n = size();
+        if (!_runs.empty() && _runs[_runs.size() - 1].value == value)
+        {
+            _runs[_runs.size() - 1].end = n + count;
+            return;
+        }
+        _runs.push_back(Run{ value, n + count });
+    }
+
+
+    // append
+    // Basic Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      [values, values + n) valid
+    // Post:
+    //      values appended, in order; each run of equal input values is
+    //      one append_run
+    void append(const value_type * values, size_type n)
+    {
+        size_type i = 0;
+        while (i < n)
+        {
+            size_type j = i + 1;
+            while (j < n && values[j] == values[i])
+                ++j;
+            append_run(values[i], j - i);
+            i = j;
+        }
+    }
+
+
+    // for_each_run
+    // Basic Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      first <= last <= size()
+    //      func callable as func(value, begin, end)
+    // Post:
+    //      func called once per run overlapping [first, last), in order,
+    //      with the run clipped to that range
+    template <typename Func>
+    void for_each_run(size_type first, size_type last, Func && func) const
+    {
+        if (first >= last)
+            return;
+        size_type begin = first;
+        for (size_type r = find_run(first); begin < last; ++r)
+        {
+            const size_type end = std::min(_runs[r].end, last);
+            func(_runs[r].value, begin, end);
+            begin = end;
+        }
+    }
+
+
+    // count
+    // No-Throw Guarantee (Basic if value_type == throws)
+    // Exception-Neutral
+    // Pre:
+    //      first <= last <= size()
+    // Post:
+    //      Returns number of elements in [first, last) equal to value;
+    //      O(log run_count() + runs in range)
+    size_type count(size_type first, size_type last,
+                    const value_type & value) const
+    {
+        size_type total = 0;
+        for_each_run(first, last,
+            [&](const value_type & v, size_type b, size_type e)
+            {
+                if (v == value)
+                    total += e - b;
+            });
+        return total;
+    }
+
+
+    // sum
+    // Basic Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      first <= last <= size()
+    //      Acc constructible from value_type and size_type, with + and *
+    // Post:
+    //      Returns sum of elements in [first, last) as Acc, each run
+    //      taken as value * length; O(log run_count() + runs in range)
+    template <typename Acc = value_type>
+    Acc sum(size_type first, size_type last) const
+    {
+        Acc total = Acc();
+        for_each_run(first, last,
+            [&](const value_type & v, size_type b, size_type e)
+            {
+                total = total + Acc(v) * Acc(e - b);
+            });
+        return total;
+    }
+
+
+    // decode
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      out holds all elements, in order
+    void decode(TMSArray<value_type> & out) const
+    {
+        TMSArray<value_type> values(size());
+        size_type begin = 0;
+        for (const Run & r : _runs)
+        {
+            std::fill(values.begin() + begin, values.begin() + r.end, r.value);
+            begin = r.end;
+        }
+        out.swap(values);
+    }
+
+
+// ***** TMSRleArray: data members *****
+private:
+
+    TMSArray<Run> _runs;
+
+}; // end of class
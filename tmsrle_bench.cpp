@@ -0,0 +1,141 @@
+// tmsrle_bench.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Benchmark: TMSRleArray<int32_t> vs. plain TMSArray<int32_t> for
+//  sensor state columns with average run lengths of 16, 256 and 4096:
+//  memory, random access, full iteration, range sum and count, decode.
+// Usage: tmsrle_bench [values=16777216]
+// Requires tmsrle.hpp, tmssorted.hpp, tmsarray.hpp, tmsbench.hpp
+
+#include "tmsrle.hpp"
+#include "tmsbench.hpp"
+
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::int32_t;
+using std::int64_t;
+using std::uint64_t;
+#include <iostream>
+using std::cout;
+
+
+// benchRuns
+void benchRuns(size_t n, size_t meanRun)
+{
+    TMSArray<int32_t> plain(n);
+    uint64_t x = 88172645463325252ull;
+    int32_t state = 0;
+    for (size_t i = 0; i < n; )
+    {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        state = (state + 1 + int32_t(x >> 62)) % 8;
+        for (size_t len = 1 + x % (2 * meanRun); len > 0 && i < n; --len)
+            plain[i++] = state;
+    }
+    TMSRleArray<int32_t> rle(plain);
+
+    cout << "\n== " << n << " values, mean run " << meanRun << " ("
+         << rle.run_count() << " runs) ==\n"
+         << "memory plain  " << n * sizeof(int32_t) << " bytes\n"
+         << "memory rle    " << rle.memory_bytes() << " bytes ("
+         << double(n * sizeof(int32_t)) / double(rle.memory_bytes())
+         << "x)\n";
+
+    const size_t probes = size_t(1) << 22;
+    double secs = tms_time_best(3, [&]
+    {
+        uint64_t y = 1;
+        int64_t sum = 0;
+        for (size_t k = 0; k < probes; ++k)
+        {
+            y = y * 6364136223846793005ull + 1442695040888963407ull;
+            sum += plain[(y >> 20) % n];
+        }
+        tms_sink(sum);
+    });
+    tms_report("4M random reads plain", secs);
+    secs = tms_time_best(3, [&]
+    {
+        uint64_t y = 1;
+        int64_t sum = 0;
+        for (size_t k = 0; k < probes; ++k)
+        {
+            y = y * 6364136223846793005ull + 1442695040888963407ull;
+            sum += rle[(y >> 20) % n];
+        }
+        tms_sink(sum);
+    });
+    tms_report("4M random reads rle", secs);
+
+    secs = tms_time_best(3, [&]
+    {
+        int64_t sum = 0;
+        for (int32_t v : plain)
+            sum += v;
+        tms_sink(sum);
+    });
+    tms_report("iterate plain", secs, n * sizeof(int32_t));
+    secs = tms_time_best(3, [&]
+    {
+        int64_t sum = 0;
+        for (int32_t v : rle)
+            sum += v;
+        tms_sink(sum);
+    });
+    tms_report("iterate rle", secs, n * sizeof(int32_t));
+
+    // 1024 random ranges of up to n / 4 values
+    const size_t ranges = 1024;
+    secs = tms_time_best(3, [&]
+    {
+        uint64_t y = 7;
+        int64_t sum = 0;
+        size_t hits = 0;
+        for (size_t k = 0; k < ranges; ++k)
+        {
+            y = y * 6364136223846793005ull + 1442695040888963407ull;
+            const size_t first = (y >> 20) % n;
+            const size_t last = first + (y >> 40) % ((n - first) / 4 + 1);
+            for (size_t i = first; i < last; ++i)
+            {
+                sum += plain[i];
+                hits += plain[i] == 3;
+            }
+        }
+        tms_sink(sum + int64_t(hits));
+    });
+    tms_report("1K range sum+count plain", secs);
+    secs = tms_time_best(3, [&]
+    {
+        uint64_t y = 7;
+        int64_t sum = 0;
+        size_t hits = 0;
+        for (size_t k = 0; k < ranges; ++k)
+        {
+            y = y * 6364136223846793005ull + 1442695040888963407ull;
+            const size_t first = (y >> 20) % n;
+            const size_t last = first + (y >> 40) % ((n - first) / 4 + 1);
+            sum += rle.sum<int64_t>(first, last);
+            hits += rle.count(first, last, 3);
+        }
+        tms_sink(sum + int64_t(hits));
+    });
+    tms_report("1K range sum+count rle", secs);
+
+    TMSArray<int32_t> out;
+    secs = tms_time_best(3, [&]{ rle.decode(out); tms_sink(out[0]); });
+    tms_report("decode", secs, n * sizeof(int32_t));
+}
+
+
+int main(int argc, char * argv[])
+{
+    const size_t n = tms_arg(argc, argv, 1, size_t(1) << 24);
+    for (size_t meanRun : { 16, 256, 4096 })
+        benchRuns(n, meanRun);
+    return 0;
+}
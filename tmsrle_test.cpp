@@ -0,0 +1,250 @@
+// tmsrle_test.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Test program for class template TMSRleArray
+// Uses the "doctest" unit-testing framework, version 2
+// Requires doctest.h, tmsrle.hpp, tmssorted.hpp, tmsarray.hpp
+
+// Includes for code to be tested
+#include "tmsrle.hpp"        // For class template TMSRleArray
+#include "tmsrle.hpp"        // Double-inclusion check, for testing only
+
+// Includes for the "doctest" unit-testing framework
+#define DOCTEST_CONFIG_IMPLEMENT
+                             // We write our own main
+#define DOCTEST_CONFIG_SUPER_FAST_ASSERTS
+                             // Reduce compile time
+#include "doctest.h"         // For doctest
+
+// Includes for all test programs
+#include <iostream>
+using std::cout;
+using std::endl;
+using std::cin;
+#include <string>
+using std::string;
+
+// Additional includes for this test program
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::int64_t;
+using std::uint64_t;
+#include <algorithm>
+using std::equal;
+using std::count;
+
+// Printable name for this test suite
+const string test_suite_name =
+    "class template TMSRleArray";
+
+
+// *********************************************************************
+// Helper Functions for This Test Program
+// *********************************************************************
+
+
+// fillRuns
+// Runs of random length 1..maxRun over a few sensor states
+void fillRuns(TMSArray<int> & ta, size_t maxRun, uint64_t seed)
+{
+    uint64_t x = seed * 0x9E3779B97F4A7C15ull + 3;
+    size_t i = 0;
+    int state = 0;
+    while (i < ta.size())
+    {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        size_t len = 1 + x % maxRun;
+        state = (state + 1 + int(x >> 60) % 3) % 4;
+        for (; len > 0 && i < ta.size(); --len)
+            ta[i++] = state;
+    }
+}
+
+
+// *********************************************************************
+// Test Cases
+// *********************************************************************
+
+
+TEST_CASE( "Round trip and access" )
+{
+    TMSArray<int> ta(10000);
+    fillRuns(ta, 50, 1);
+    TMSRleArray<int> tr(ta);
+    REQUIRE( tr.size() == ta.size() );
+    REQUIRE( tr.run_count() < ta.size() / 10 );
+
+    bool allMatch = true;
+    for (size_t i = 0; i < ta.size(); ++i)
+        allMatch = allMatch && tr[i] == ta[i];
+    REQUIRE( allMatch );
+
+    TMSArray<int> out;
+    tr.decode(out);
+    REQUIRE( out.size() == ta.size() );
+    REQUIRE( equal(out.begin(), out.end(), ta.begin()) );
+
+    SUBCASE( "Runs are maximal and tile the array" )
+    {
+        size_t at = 0;
+        for (size_t r = 0; r < tr.run_count(); ++r)
+        {
+            REQUIRE( tr.run_begin(r) == at );
+            REQUIRE( tr.run_end(r) > at );
+            if (r > 0)
+                REQUIRE( tr.run(r).value != tr.run(r - 1).value );
+            for (size_t i = tr.run_begin(r); i < tr.run_end(r); ++i)
+                REQUIRE( tr.find_run(i) == r );
+            at = tr.run_end(r);
+        }
+        REQUIRE( at == ta.size() );
+    }
+
+    SUBCASE( "Iteration matches, from the start and from any index" )
+    {
+        REQUIRE( equal(tr.begin(), tr.end(), ta.begin(), ta.end()) );
+        for (size_t start : { size_t(0), size_t(1), size_t(4999),
+                              ta.size() - 1, ta.size() })
+        {
+            auto it = tr.iterator_at(start);
+            REQUIRE( it.index() == start );
+            REQUIRE( equal(it, tr.end(), ta.begin() + start, ta.end()) );
+        }
+    }
+}
+
+
+TEST_CASE( "Append" )
+{
+    TMSRleArray<int64_t> tr;
+    REQUIRE( tr.empty() );
+    REQUIRE( tr.begin() == tr.end() );
+    REQUIRE( tr.size() == 0 );
+
+    tr.push_back(5);
+    tr.push_back(5);
+    tr.append_run(5, 3);
+    REQUIRE( tr.run_count() == 1 );
+    REQUIRE( tr.size() == 5 );
+    tr.append_run(7, 0);
+    REQUIRE( tr.run_count() == 1 );
+    tr.append_run(7, 1000000);
+    tr.push_back(-1);
+    const int64_t more[] = { -1, -1, 2, 2, 5 };
+    tr.append(more, 5);
+    REQUIRE( tr.run_count() == 5 );
+    REQUIRE( tr.size() == 1000011 );
+    REQUIRE( tr[4] == 5 );
+    REQUIRE( tr[5] == 7 );
+    REQUIRE( tr[1000004] == 7 );
+    REQUIRE( tr[1000005] == -1 );
+    REQUIRE( tr[1000008] == 2 );
+    REQUIRE( tr[1000010] == 5 );
+    REQUIRE( tr.memory_bytes() == 5 * sizeof(TMSRleArray<int64_t>::Run) );
+}
+
+
+TEST_CASE( "Range count and sum without expansion" )
+{
+    TMSArray<int> ta(5000);
+    fillRuns(ta, 30, 2);
+    TMSRleArray<int> tr(ta);
+
+    bool allMatch = true;
+    for (size_t first = 0; first < ta.size(); first += 311)
+        for (size_t last = first; last <= ta.size(); last += 977)
+        {
+            int64_t wantSum = 0;
+            for (size_t i = first; i < last; ++i)
+                wantSum += ta[i];
+            allMatch = allMatch && tr.sum<int64_t>(first, last) == wantSum;
+            for (int v = 0; v < 4; ++v)
+                allMatch = allMatch && tr.count(first, last, v) == size_t(
+                    count(ta.begin() + first, ta.begin() + last, v));
+        }
+    REQUIRE( allMatch );
+    REQUIRE( tr.sum(0, 0) == 0 );
+    REQUIRE( tr.count(0, ta.size(), 9) == 0 );
+
+    SUBCASE( "for_each_run clips the end runs" )
+    {
+        TMSRleArray<int> small;
+        small.append_run(1, 10);
+        small.append_run(2, 10);
+        small.append_run(3, 10);
+        size_t calls = 0, covered = 0;
+        small.for_each_run(5, 25, [&](int v, size_t b, size_t e)
+        {
+            REQUIRE( v == int(calls) + 1 );
+            REQUIRE( b == (calls == 0 ? 5 : 10 * calls) );
+            REQUIRE( e == (calls == 2 ? 25 : 10 * (calls + 1)) );
+            covered += e - b;
+            ++calls;
+        });
+        REQUIRE( calls == 3 );
+        REQUIRE( covered == 20 );
+        REQUIRE( small.sum(5, 25) == 5 * 1 + 10 * 2 + 5 * 3 );
+    }
+}
+
+
+TEST_CASE( "Non-arithmetic values" )
+{
+    TMSRleArray<string> tr;
+    tr.append_run("idle", 100);
+    tr.append_run("running", 50);
+    tr.push_back("idle");
+    REQUIRE( tr.run_count() == 3 );
+    REQUIRE( tr[120] == "running" );
+    REQUIRE( tr.count(0, tr.size(), "idle") == 101 );
+    REQUIRE( tr.iterator_at(149)->size() == 7 );
+}
+
+
+// *********************************************************************
+// Main Program
+// *********************************************************************
+
+
+// userPause
+// Wait for user to press ENTER: read all chars through first newline.
+void userPause()
+{
+    std::cout.flush();
+    while (std::cin.get() != '\n') ;
+}
+
+
+// Main program
+// Run all tests. Prompt for ENTER before exiting.
+int main(int argc,
+         char *argv[])
+{
+    doctest::Context dtcontext;
+                             // Primary doctest object
+    int dtresult;            // doctest return code; for return by main
+
+    // Handle command line
+    dtcontext.applyCommandLine(argc, argv);
+    dtresult = 0;            // doctest flags no command-line errors
+                             //  (strange but true)
+
+    if (!dtresult)           // Continue only if no command-line error
+    {
+        // Run test suites
+        cout << "BEGIN tests for " << test_suite_name << "\n" << endl;
+        dtresult = dtcontext.run();
+        cout << "END tests for " << test_suite_name << "\n" << endl;
+    }
+
+    // Wait for user
+    std::cout << "Press ENTER to quit ";
+    userPause();
+
+    // Program return value is return code from doctest
+    return dtresult;
+}
@@ -0,0 +1,787 @@
+// tmsserial.hpp
+// Matthew Johnson
+// 10/17/2026
+// versioned binary file format for TMSArray: one-call save, checked
+//  load, and TMSArrayView, a read-only mmap of the file (POSIX)
+
+#pragma once
+// for single inclusion
+
+#include "tmsarray.hpp"
+// For class template TMSArray
+
+#include "tmscrc32.hpp"
+// For tms_crc32c
+
+#include "tmssimd.hpp"
+// For tms_search
+
+#include <cstddef>
+// For std::size_t
+
+#include <cstdint>
+// For std::uint16_t
+// For std::uint32_t
+// For std::uint64_t
+// For std::int8_t ... std::int64_t
+
+#include <cstring>
+// For std::memcpy
+// For std::memcmp
+// For std::memset
+
+#include <cerrno>
+// For errno
+// For EINTR
+
+#include <string>
+// For std::string
+
+#include <stdexcept>
+// For std::runtime_error
+
+#include <system_error>
+// For std::system_error
+// For std::generic_category
+
+#include <type_traits>
+// For std::is_trivially_copyable
+// For std::is_same
+
+#include <algorithm>
+// For std::reverse
+
+#include <utility>
+// For std::swap
+
+#include <fcntl.h>
+// For open
+
+#include <unistd.h>
+// For close
+// For pread
+
+#include <sys/mman.h>
+// For mmap
+// For munmap
+// For madvise
+
+#include <sys/stat.h>
+// For fstat
+
+#include <sys/uio.h>
+// For pwritev
+// For struct iovec
+
+
+
+// *********************************************************************
+// File format
+// *********************************************************************
+
+
+// Layout: a 64-byte TMSFileHeader, padding up to data_offset (a
+//  multiple of TMS_FILE_ALIGN), then count elements of elem_size bytes
+//  in the writer's byte order. An mmap of the file is page-aligned, so
+//  the data is TMS_FILE_ALIGN-aligned in memory.
+
+constexpr char          TMS_FILE_MAGIC[8] = { 'T', 'M', 'S', 'A',
+                                              'R', 'R', 'A', 'Y' };
+constexpr std::uint16_t TMS_FILE_VERSION  = 1;
+constexpr std::uint32_t TMS_FILE_ENDIAN   = 0x01020304;   // as written
+constexpr std::size_t   TMS_FILE_ALIGN    = 64;
+
+
+// Element type tags; TMS_TYPE_RAW is any other trivially copyable type,
+//  matched by element size only
+enum TMSTypeTag : std::uint16_t
+{
+    TMS_TYPE_RAW = 0,
+    TMS_TYPE_I8  = 1,
+    TMS_TYPE_I16 = 2,
+    TMS_TYPE_I32 = 3,
+    TMS_TYPE_I64 = 4,
+    TMS_TYPE_U8  = 5,
+    TMS_TYPE_U16 = 6,
+    TMS_TYPE_U32 = 7,
+    TMS_TYPE_U64 = 8,
+    TMS_TYPE_F32 = 9,
+    TMS_TYPE_F64 = 10
+};
+
+
+// TMSFileHeader
+// Fixed 64-byte header; header_crc covers the header with header_crc
+//  zero, data_crc the element bytes
+struct TMSFileHeader
+{
+    char          magic[8];
+    std::uint32_t endian;
+    std::uint16_t version;
+    std::uint16_t type;
+    std::uint32_t elem_size;
+    std::uint32_t align;
+    std::uint64_t count;
+    std::uint64_t data_offset;
+    std::uint32_t data_crc;
+    std::uint32_t header_crc;
+    unsigned char reserved[16];
+};
+
+static_assert(sizeof(TMSFileHeader) == 64, "TMSFileHeader is 64 bytes");
+
+
+// TMSAdvice
+// Access pattern hints for TMSArrayView::advise (madvise)
+enum TMSAdvice
+{
+    TMS_ADVISE_NORMAL,
+    TMS_ADVISE_SEQUENTIAL,
+    TMS_ADVISE_RANDOM,
+    TMS_ADVISE_WILLNEED
+};
+
+
+// tms_type_tag
+// Tag for element type T
+template <typename T>
+constexpr TMSTypeTag tms_type_tag() noexcept
+{
+    if constexpr (std::is_same<T, float>::value)
+        return TMS_TYPE_F32;
+    else if constexpr (std::is_same<T, double>::value)
+        return TMS_TYPE_F64;
+    else if constexpr (std::is_integral<T>::value && !std::is_same<T, bool>::value)
+    {
+        constexpr unsigned k = sizeof(T) == 1 ? 0 : sizeof(T) == 2 ? 1
+                             : sizeof(T) == 4 ? 2 : 3;
+        return TMSTypeTag((std::is_signed<T>::value ? TMS_TYPE_I8
+                                                    : TMS_TYPE_U8) + k);
+    }
+    else
+        return TMS_TYPE_RAW;
+}
+
+
+// tms_bswap
+// Reverses the bytes of each of n elements of size bytes, in place
+inline void tms_bswap(void * data, std::size_t size, std::size_t n) noexcept
+{
+    unsigned char * p = static_cast<unsigned char *>(data);
+    for (std::size_t i = 0; i < n; ++i, p += size)
+    {
+        if (size == 8)
+        {
+            std::uint64_t v;
+            std::memcpy(&v, p, 8);
+            v = __builtin_bswap64(v);
+            std::memcpy(p, &v, 8);
+        }
+        else if (size == 4)
+        {
+            std::uint32_t v;
+            std::memcpy(&v, p, 4);
+            v = __builtin_bswap32(v);
+            std::memcpy(p, &v, 4);
+        }
+        else
+            std::reverse(p, p + size);
+    }
+}
+
+
+// tms_header_crc
+// CRC-32C of h with its header_crc field taken as zero
+inline std::uint32_t tms_header_crc(TMSFileHeader h) noexcept
+{
+    h.header_crc = 0;
+    return tms_crc32c(&h, sizeof h);
+}
+
+
+// tms_file_header
+// Header for n elements of T whose bytes have CRC-32C dataCrc
+template <typename T>
+TMSFileHeader tms_file_header(std::size_t n, std::uint32_t dataCrc) noexcept
+{
+    TMSFileHeader h;
+    std::memset(&h, 0, sizeof h);
+    std::memcpy(h.magic, TMS_FILE_MAGIC, sizeof h.magic);
+    h.endian = TMS_FILE_ENDIAN;
+    h.version = TMS_FILE_VERSION;
+    h.type = tms_type_tag<T>();
+    h.elem_size = sizeof(T);
+    h.align = TMS_FILE_ALIGN;
+    h.count = n;
+    h.data_offset = (sizeof h + TMS_FILE_ALIGN - 1) / TMS_FILE_ALIGN
+                    * TMS_FILE_ALIGN;
+    h.data_crc = dataCrc;
+    h.header_crc = tms_header_crc(h);
+    return h;
+}
+
+
+// tms_make_header
+// Header for n elements of T at data (computes data_crc)
+template <typename T>
+TMSFileHeader tms_make_header(const T * data, std::size_t n) noexcept
+{
+    return tms_file_header<T>(n, tms_crc32c(data, n * sizeof(T)));
+}
+
+
+// tms_check_header
+// Validates h (as read from a file of fileSize bytes) for element type
+//  T. Returns true if the file is in the opposite byte order; the
+//  header itself is converted to native order first.
+// Throws std::runtime_error naming what does not match.
+template <typename T>
+bool tms_check_header(TMSFileHeader & h, std::uint64_t fileSize,
+                      const std::string & path)
+{
+    if (fileSize < sizeof h || std::memcmp(h.magic, TMS_FILE_MAGIC, 8) != 0)
+        throw std::runtime_error(path + ": not a TMSArray file");
+    bool swapped = false;
+    if (h.endian != TMS_FILE_ENDIAN)
+    {
+        if (h.endian != __builtin_bswap32(TMS_FILE_ENDIAN))
+            throw std::runtime_error(path + ": bad byte-order mark");
+        swapped = true;
+    }
+    // The header CRC is over the bytes as written; only the stored value
+    //  itself is in the writer's byte order
+    const std::uint32_t storedCrc = swapped ? __builtin_bswap32(h.header_crc)
+                                            : h.header_crc;
+    if (tms_header_crc(h) != storedCrc)
+        throw std::runtime_error(path + ": header checksum mismatch");
+    if (swapped)
+    {
+        h.endian = __builtin_bswap32(h.endian);
+        h.version = __builtin_bswap16(h.version);
+        h.type = __builtin_bswap16(h.type);
+        h.elem_size = __builtin_bswap32(h.elem_size);
+        h.align = __builtin_bswap32(h.align);
+        h.count = __builtin_bswap64(h.count);
+        h.data_offset = __builtin_bswap64(h.data_offset);
+        h.data_crc = __builtin_bswap32(h.data_crc);
+        h.header_crc = storedCrc;
+    }
+
+    if (h.version != TMS_FILE_VERSION)
+        throw std::runtime_error(path + ": unsupported version "
+                                 + std::to_string(h.version));
+    if (h.elem_size != sizeof(T) || h.type != tms_type_tag<T>())
+        throw std::runtime_error(path + ": element type does not match");
+    if (h.data_offset < sizeof h || h.data_offset % alignof(T) != 0)
+        throw std::runtime_error(path + ": bad data offset");
+    if (h.data_offset > fileSize
+        || h.count > (fileSize - h.data_offset) / sizeof(T))
+        throw std::runtime_error(path + ": truncated");
+    return swapped;
+}
+
+
+// TMSFd
+// Owns a file descriptor; closes it on destruction
+struct TMSFd
+{
+    int fd;
+
+    explicit TMSFd(int f) noexcept : fd(f) {}
+    TMSFd(const TMSFd &) = delete;
+    TMSFd & operator=(const TMSFd &) = delete;
+    ~TMSFd() { if (fd >= 0) ::close(fd); }
+};
+
+
+// tms_throw_errno
+// Throws std::system_error for errno, naming what failed
+[[noreturn]] inline void tms_throw_errno(const std::string & what)
+{
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+
+// tms_pwritev_all
+// Writes every iovec at offset, continuing after short writes and EINTR
+inline void tms_pwritev_all(int fd, struct iovec * iov, int cnt,
+                            std::uint64_t offset, const std::string & path)
+{
+    while (cnt > 0)
+    {
+        const ssize_t got = ::pwritev(fd, iov, cnt, off_t(offset));
+        if (got < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            tms_throw_errno(path + ": write");
+        }
+        offset += std::uint64_t(got);
+        std::size_t left = std::size_t(got);
+        while (cnt > 0 && left >= iov->iov_len)
+        {
+            left -= iov->iov_len;
+            ++iov;
+            --cnt;
+        }
+        if (cnt > 0)
+        {
+            iov->iov_base = static_cast<char *>(iov->iov_base) + left;
+            iov->iov_len -= left;
+        }
+    }
+}
+
+
+// tms_pread_all
+// Reads exactly n bytes at offset, continuing after short reads and
+//  EINTR; throws at end of file
+inline void tms_pread_all(int fd, void * buf, std::size_t n,
+                          std::uint64_t offset, const std::string & path)
+{
+    char * p = static_cast<char *>(buf);
+    while (n > 0)
+    {
+        const ssize_t got = ::pread(fd, p, n, off_t(offset));
+        if (got < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            tms_throw_errno(path + ": read");
+        }
+        if (got == 0)
+            throw std::runtime_error(path + ": unexpected end of file");
+        p += got;
+        n -= std::size_t(got);
+        offset += std::uint64_t(got);
+    }
+}
+
+
+
+// *********************************************************************
+// Save and load
+// *********************************************************************
+
+
+// tms_save
+// Basic Guarantee (the file may be partly written if a write fails)
+// Exception-Neutral
+// Pre:
+//      [data, data + n) valid; T trivially copyable
+// Post:
+//      path holds header, padding and the n elements, written by one
+//      pwritev (repeated only after a short write). Throws
+//      std::system_error if the file cannot be created or written.
+template <typename T>
+void tms_save(const T * data, std::size_t n, const std::string & path)
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "tms_save writes raw bytes");
+    TMSFileHeader h = tms_make_header(data, n);
+    TMSFd file(::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                      0644));
+    if (file.fd < 0)
+        tms_throw_errno(path + ": open");
+    unsigned char pad[TMS_FILE_ALIGN] = {};
+    struct iovec iov[3];
+    iov[0].iov_base = &h;
+    iov[0].iov_len = sizeof h;
+    iov[1].iov_base = pad;
+    iov[1].iov_len = std::size_t(h.data_offset - sizeof h);
+    iov[2].iov_base = const_cast<T *>(data);
+    iov[2].iov_len = n * sizeof(T);
+    tms_pwritev_all(file.fd, iov, 3, 0, path);
+}
+
+template <typename T>
+void tms_save(const TMSArray<T> & arr, const std::string & path)
+{
+    tms_save(arr.begin(), arr.size(), path);
+}
+
+
+// tms_load
+// Strong Guarantee
+// Exception-Neutral
+// Pre:
+//      T trivially copyable
+// Post:
+//      out holds the elements of the file at path, read with one pread
+//      straight into its storage; converted if the file has the other
+//      byte order. With verify, the data checksum is checked. Throws
+//      std::system_error on I/O errors, std::runtime_error if the file
+//      is not a matching TMSArray file or is corrupt.
+template <typename T>
+void tms_load(const std::string & path, TMSArray<T> & out, bool verify = true)
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "tms_load reads raw bytes");
+    TMSFd file(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+    if (file.fd < 0)
+        tms_throw_errno(path + ": open");
+    struct stat st;
+    if (::fstat(file.fd, &st) != 0)
+        tms_throw_errno(path + ": stat");
+    TMSFileHeader h;
+    if (std::uint64_t(st.st_size) < sizeof h)
+        throw std::runtime_error(path + ": not a TMSArray file");
+    tms_pread_all(file.fd, &h, sizeof h, 0, path);
+    const bool swapped = tms_check_header<T>(h, std::uint64_t(st.st_size), path);
+
+    TMSArray<T> values(std::size_t(h.count));
+    tms_pread_all(file.fd, values.begin(), std::size_t(h.count) * sizeof(T),
+                  h.data_offset, path);
+    if (verify && tms_crc32c(values.begin(), std::size_t(h.count) * sizeof(T))
+                  != h.data_crc)
+        throw std::runtime_error(path + ": data checksum mismatch");
+    if (swapped)
+        tms_bswap(values.begin(), sizeof(T), values.size());
+    out.swap(values);
+}
+
+
+
+// *********************************************************************
+// class TMSArrayView - Class definition
+// *********************************************************************
+
+
+// class TMSArrayView
+// Read-only TMSArray backed by a private read-only mmap of a file
+//  written by tms_save. Opening reads and checks only the header, so it
+//  costs the same for any size; element pages are faulted in by the
+//  kernel on first touch and shared with the page cache, never copied.
+// Requirements on Types:
+//     Valtype is trivially copyable.
+// Invariants:
+//     _map, _mapLen describe the mapping (nullptr, 0 when moved from);
+//      _data points count elements into it.
+template <typename Valtype>
+class TMSArrayView
+{
+
+    static_assert(std::is_trivially_copyable<Valtype>::value,
+                  "TMSArrayView maps raw bytes");
+
+public:
+
+
+    using value_type = Valtype;
+
+    using size_type  = std::size_t;
+
+    using iterator = const value_type*;
+
+    using const_iterator = const value_type*;
+
+
+// ***** TMSArrayView: ctors, op=, dctor *****
+public:
+
+
+    // Ctor from path
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Maps the file at path. With verify, checks the data checksum
+    //      (which reads every page). Throws std::system_error on I/O
+    //      errors; std::runtime_error if the file is not a matching
+    //      TMSArray file in native byte order.
+    explicit TMSArrayView(const std::string & path, bool verify = false)
+        :_map(nullptr),
+         _mapLen(0),
+         _data(nullptr),
+         _size(0)
+    {
+        TMSFd file(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+        if (file.fd < 0)
+            tms_throw_errno(path + ": open");
+        struct stat st;
+        if (::fstat(file.fd, &st) != 0)
+            tms_throw_errno(path + ": stat");
+        const std::uint64_t fileSize = std::uint64_t(st.st_size);
+        if (fileSize < sizeof(TMSFileHeader))
+            throw std::runtime_error(path + ": not a TMSArray file");
+
+        void * map = ::mmap(nullptr, std::size_t(fileSize), PROT_READ,
+                            MAP_PRIVATE, file.fd, 0);
+        if (map == MAP_FAILED)
+            tms_throw_errno(path + ": mmap");
+        try
+        {
+            TMSFileHeader h;
+            std::memcpy(&h, map, sizeof h);
+            if (tms_check_header<Valtype>(h, fileSize, path))
+                throw std::runtime_error(path + ": opposite byte order; "
+                                         "use tms_load to convert");
+            _data = reinterpret_cast<const value_type *>(
+                static_cast<const char *>(map) + h.data_offset);
+            _size = std::size_t(h.count);
+            if (verify && tms_crc32c(_data, _size * sizeof(value_type))
+                          != h.data_crc)
+                throw std::runtime_error(path + ": data checksum mismatch");
+        }
+        catch (...)
+        {
+            ::munmap(map, std::size_t(fileSize));
+            throw;
+        }
+        _map = map;
+        _mapLen = std::size_t(fileSize);
+    }
+
+
+    // map_range
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      View of count elements at byte offset of the file at path,
+    //      which can have any format; no header is read and the bytes
+    //      are taken in native order. Throws std::system_error on I/O
+    //      errors, std::runtime_error if the range is past the end of
+    //      the file or offset is misaligned for value_type.
+    static TMSArrayView map_range(const std::string & path,
+                                  std::uint64_t offset, size_type count)
+    {
+        TMSFd file(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+        if (file.fd < 0)
+            tms_throw_errno(path + ": open");
+        struct stat st;
+        if (::fstat(file.fd, &st) != 0)
+            tms_throw_errno(path + ": stat");
+        const std::uint64_t fileSize = std::uint64_t(st.st_size);
+        if (offset > fileSize || count > (fileSize - offset) / sizeof(value_type))
+            throw std::runtime_error(path + ": truncated");
+        if (offset % alignof(value_type) != 0)
+            throw std::runtime_error(path + ": data misaligned for mapping");
+
+        TMSArrayView view;
+        if (fileSize == 0)
+            return view;
+        void * map = ::mmap(nullptr, std::size_t(fileSize), PROT_READ,
+                            MAP_PRIVATE, file.fd, 0);
+        if (map == MAP_FAILED)
+            tms_throw_errno(path + ": mmap");
+        view._map = map;
+        view._mapLen = std::size_t(fileSize);
+        view._data = reinterpret_cast<const value_type *>(
+            static_cast<const char *>(map) + offset);
+        view._size = count;
+        return view;
+    }
+
+
+    // No copying: a view owns its mapping
+    TMSArrayView(const TMSArrayView &) = delete;
+    TMSArrayView & operator=(const TMSArrayView &) = delete;
+
+
+    // Move ctor
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      *this owns other's mapping; other is empty
+    TMSArrayView(TMSArrayView && other) noexcept
+        :_map(other._map),
+         _mapLen(other._mapLen),
+         _data(other._data),
+         _size(other._size)
+    {
+        other._map = nullptr;
+        other._mapLen = 0;
+        other._data = nullptr;
+        other._size = 0;
+    }
+
+
+    // Move assignment operator
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      *this owns other's mapping; other gets the old one
+    TMSArrayView & operator=(TMSArrayView && other) noexcept
+    {
+        swap(other);
+        return *this;
+    }
+
+
+    // Dctor
+    // No-Throw Guarantee
+    // Pre: None
+    // Post:
+    //      Mapping released
+    ~TMSArrayView()
+    {
+        if (_map)
+            ::munmap(_map, _mapLen);
+    }
+
+
+// ***** TMSArrayView: general public operators *****
+public:
+
+
+    // operator[]
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      0 <= index < size()
+    // Post:
+    //      Returns element index (may fault its page in)
+    const value_type & operator[](size_type index) const noexcept
+    {
+        return _data[index];
+    }
+
+
+// ***** TMSArrayView: general public functions *****
+public:
+
+
+    // size
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns number of elements
+    size_type size() const noexcept
+    {
+        return _size;
+    }
+
+
+    // empty
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns size() == 0
+    bool empty() const noexcept
+    {
+        return _size == 0;
+    }
+
+
+    // begin, end, data
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns pointer to first element; past the last; first
+    const_iterator begin() const noexcept
+    {
+        return _data;
+    }
+    const_iterator end() const noexcept
+    {
+        return _data + _size;
+    }
+    const value_type * data() const noexcept
+    {
+        return _data;
+    }
+
+
+    // advise
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Passes the access pattern to the kernel (madvise); WILLNEED
+    //      starts readahead of the whole file. Returns false if the
+    //      kernel rejected the hint.
+    bool advise(TMSAdvice advice) const noexcept
+    {
+        if (!_map)
+            return true;
+        const int how = advice == TMS_ADVISE_SEQUENTIAL ? MADV_SEQUENTIAL
+                      : advice == TMS_ADVISE_RANDOM     ? MADV_RANDOM
+                      : advice == TMS_ADVISE_WILLNEED   ? MADV_WILLNEED
+                                                        : MADV_NORMAL;
+        return ::madvise(_map, _mapLen, how) == 0;
+    }
+
+
+    // swap
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      *this and other exchange mappings
+    void swap(TMSArrayView & other) noexcept
+    {
+        std::swap(_map, other._map);
+        std::swap(_mapLen, other._mapLen);
+        std::swap(_data, other._data);
+        std::swap(_size, other._size);
+    }
+
+
+// ***** TMSArrayView: search functions *****
+public:
+
+
+    // find
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns iterator to first element == item, or end() if none
+    const_iterator find(const value_type & item) const
+    {
+        return begin() + tms_search<false>(begin(), size(), item, TMS_CMP_EQ);
+    }
+
+
+    // count
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns number of elements == item
+    size_type count(const value_type & item) const
+    {
+        return tms_search<true>(begin(), size(), item, TMS_CMP_EQ);
+    }
+
+
+    // contains
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns whether some element == item
+    bool contains(const value_type & item) const
+    {
+        return find(item) != end();
+    }
+
+
+// ***** TMSArrayView: private ctor *****
+private:
+
+
+    // Empty view, for map_range
+    TMSArrayView() noexcept
+        :_map(nullptr),
+         _mapLen(0),
+         _data(nullptr),
+         _size(0)
+    {}
+
+
+// ***** TMSArrayView: data members *****
+private:
+
+    void *             _map;
+    size_type          _mapLen;
+    const value_type * _data;
+    size_type          _size;
+
+}; // end of class
@@ -0,0 +1,128 @@
+// tmsserial_bench.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Benchmark: tms_save/tms_load vs. element-by-element std::fstream I/O
+//  for a TMSArray<int64_t>; TMSArrayView open time (independent of
+//  size) and first scan; CRC-32C throughput at each ISA level.
+// Usage: tmsserial_bench [values=8388608] [dir=/tmp]
+// Requires tmsserial.hpp, tmscrc32.hpp, tmssimd.hpp, tmsarray.hpp,
+//  tmsbench.hpp
+
+#include "tmsserial.hpp"
+#include "tmsbench.hpp"
+
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::int64_t;
+using std::uint64_t;
+#include <cstdio>
+using std::remove;
+#include <fstream>
+using std::ofstream;
+using std::ifstream;
+#include <iostream>
+using std::cout;
+#include <string>
+using std::string;
+
+
+int main(int argc, char * argv[])
+{
+    const size_t n = tms_arg(argc, argv, 1, size_t(1) << 23);
+    const string dir = argc > 2 ? argv[2] : "/tmp";
+    const string path = dir + "/tmsserial_bench.tms";
+    const string plainPath = dir + "/tmsserial_bench.raw";
+    const size_t bytes = n * sizeof(int64_t);
+
+    TMSArray<int64_t> ta(n);
+    uint64_t x = 88172645463325252ull;
+    for (size_t i = 0; i < n; ++i)
+    {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        ta[i] = int64_t(x);
+    }
+    cout << n << " int64 values (" << bytes << " bytes), files in " << dir
+         << ", page cache warm after the first pass\n";
+
+    double secs = tms_time_best(3, [&]
+    {
+        ofstream out(plainPath, std::ios::binary);
+        for (int64_t v : ta)
+            out.write(reinterpret_cast<const char *>(&v), sizeof v);
+    });
+    tms_report("save fstream per element", secs, bytes);
+    secs = tms_time_best(3, [&]{ tms_save(ta, path); });
+    tms_report("save tms_save", secs, bytes);
+
+    TMSArray<int64_t> tb(n);
+    secs = tms_time_best(3, [&]
+    {
+        ifstream in(plainPath, std::ios::binary);
+        for (int64_t & v : tb)
+            in.read(reinterpret_cast<char *>(&v), sizeof v);
+        tms_sink(tb[n - 1]);
+    });
+    tms_report("load fstream per element", secs, bytes);
+    secs = tms_time_best(3, [&]{ tms_load(path, tb); tms_sink(tb[n - 1]); });
+    tms_report("load tms_load (checked)", secs, bytes);
+    secs = tms_time_best(3, [&]{ tms_load(path, tb, false); tms_sink(tb[n - 1]); });
+    tms_report("load tms_load (unchecked)", secs, bytes);
+
+    secs = tms_time_best(5, [&]
+    {
+        TMSArrayView<int64_t> view(path);
+        tms_sink(view.size());
+    });
+    tms_report("view open+close", secs);
+
+    // Each rep maps afresh, so every page is faulted in again (from the
+    //  page cache)
+    secs = tms_time_best(3, [&]
+    {
+        TMSArrayView<int64_t> view(path);
+        int64_t sum = 0;
+        for (int64_t v : view)
+            sum += v;
+        tms_sink(sum);
+    });
+    tms_report("view open+first scan", secs, bytes);
+    secs = tms_time_best(3, [&]
+    {
+        TMSArrayView<int64_t> view(path);
+        view.advise(TMS_ADVISE_SEQUENTIAL);
+        int64_t sum = 0;
+        for (int64_t v : view)
+            sum += v;
+        tms_sink(sum);
+    });
+    tms_report("view open+first scan seq", secs, bytes);
+    {
+        TMSArrayView<int64_t> view(path);
+        secs = tms_time_best(3, [&]
+        {
+            int64_t sum = 0;
+            for (int64_t v : view)
+                sum += v;
+            tms_sink(sum);
+        });
+        tms_report("view warm scan", secs, bytes);
+    }
+
+    const TMSIsa best = tms_detect_isa();
+    // Two kernels only: tables, or the crc32 instruction from AVX2 up
+    for (TMSIsa level : { TMS_ISA_SCALAR, best })
+    {
+        tms_isa_limit() = level;
+        secs = tms_time_best(3, [&]{ tms_sink(tms_crc32c(ta.begin(), bytes)); });
+        tms_report(string("crc32c ") + tms_isa_name(level), secs, bytes);
+    }
+    tms_isa_limit() = best;
+
+    remove(path.c_str());
+    remove(plainPath.c_str());
+    return 0;
+}
@@ -0,0 +1,417 @@
+// tmsserial_test.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Test program for tms_save, tms_load, class template TMSArrayView and
+//  tms_crc32c
+// Uses the "doctest" unit-testing framework, version 2
+// Requires doctest.h, tmsserial.hpp, tmscrc32.hpp, tmssimd.hpp,
+//  tmsarray.hpp
+
+// Includes for code to be tested
+#include "tmsserial.hpp"     // For tms_save, tms_load, TMSArrayView
+#include "tmsserial.hpp"     // Double-inclusion check, for testing only
+
+// Includes for the "doctest" unit-testing framework
+#define DOCTEST_CONFIG_IMPLEMENT
+                             // We write our own main
+#define DOCTEST_CONFIG_SUPER_FAST_ASSERTS
+                             // Reduce compile time
+#include "doctest.h"         // For doctest
+
+// Includes for all test programs
+#include <iostream>
+using std::cout;
+using std::endl;
+using std::cin;
+#include <string>
+using std::string;
+
+// Additional includes for this test program
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::int16_t;
+using std::int64_t;
+using std::uint32_t;
+using std::uint64_t;
+#include <cstdio>
+using std::remove;
+#include <cstring>
+using std::memcpy;
+#include <algorithm>
+using std::equal;
+#include <stdexcept>
+using std::runtime_error;
+#include <system_error>
+using std::system_error;
+#include <utility>
+using std::move;
+#include <unistd.h>          // For getpid
+
+// Printable name for this test suite
+const string test_suite_name =
+    "tms_save, tms_load, TMSArrayView and tms_crc32c";
+
+
+// *********************************************************************
+// Helper Functions for This Test Program
+// *********************************************************************
+
+
+// tempPath
+// A per-process scratch file name under /tmp
+string tempPath(const string & tag)
+{
+    return "/tmp/tmsserial_test_" + std::to_string(getpid()) + "_" + tag;
+}
+
+
+// fillRandom
+// Deterministic pseudo-random values
+template <typename T>
+void fillRandom(TMSArray<T> & ta, uint64_t seed)
+{
+    uint64_t x = seed * 0x9E3779B97F4A7C15ull + 1;
+    for (size_t i = 0; i < ta.size(); ++i)
+    {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        ta[i] = T(x);
+    }
+}
+
+
+// patchFile
+// Overwrites bytes of a file at offset
+void patchFile(const string & path, size_t offset, const void * bytes, size_t n)
+{
+    TMSFd file(::open(path.c_str(), O_WRONLY));
+    REQUIRE( file.fd >= 0 );
+    REQUIRE( ::pwrite(file.fd, bytes, n, off_t(offset)) == ssize_t(n) );
+}
+
+
+// *********************************************************************
+// Test Cases
+// *********************************************************************
+
+
+TEST_CASE( "CRC-32C known values" )
+{
+    const TMSIsa best = tms_isa_limit();
+    for (int level = 0; level <= best; ++level)
+    {
+        tms_isa_limit() = TMSIsa(level);
+        INFO( "ISA: " << tms_isa_name(TMSIsa(level)) );
+        REQUIRE( tms_crc32c("", 0) == 0u );
+        REQUIRE( tms_crc32c("123456789", 9) == 0xE3069283u );
+        unsigned char zeros[32] = {};
+        REQUIRE( tms_crc32c(zeros, 32) == 0x8A9136AAu );
+        unsigned char ones[32];
+        for (auto & b : ones)
+            b = 0xFF;
+        REQUIRE( tms_crc32c(ones, 32) == 0x62A8AB43u );
+    }
+    tms_isa_limit() = best;
+}
+
+
+TEST_CASE( "CRC-32 (zip) known values" )
+{
+    REQUIRE( tms_crc32("", 0) == 0u );
+    REQUIRE( tms_crc32("123456789", 9) == 0xCBF43926u );
+    unsigned char zeros[32] = {};
+    REQUIRE( tms_crc32(zeros, 32) == 0x190A55ADu );
+    const char text[] = "The quick brown fox jumps over the lazy dog";
+    REQUIRE( tms_crc32(text, 43) == 0x414FA339u );
+    REQUIRE( tms_crc32(text + 10, 33, tms_crc32(text, 10)) == 0x414FA339u );
+}
+
+
+TEST_CASE( "CRC-32C paths agree and continue" )
+{
+    const TMSIsa best = tms_isa_limit();
+    TMSArray<unsigned char> bytes(3 * TMS_CRC32C_BLOCK * 2 + 77);
+    fillRandom(bytes, 5);
+    tms_isa_limit() = TMS_ISA_SCALAR;
+    const uint32_t whole = tms_crc32c(bytes.begin(), bytes.size());
+    for (int level = 0; level <= best; ++level)
+    {
+        tms_isa_limit() = TMSIsa(level);
+        INFO( "ISA: " << tms_isa_name(TMSIsa(level)) );
+        REQUIRE( tms_crc32c(bytes.begin(), bytes.size()) == whole );
+        for (size_t cut : { size_t(0), size_t(1), size_t(4095),
+                            3 * TMS_CRC32C_BLOCK + 3, bytes.size() })
+        {
+            uint32_t c = tms_crc32c(bytes.begin(), cut);
+            c = tms_crc32c(bytes.begin() + cut, bytes.size() - cut, c);
+            REQUIRE( c == whole );
+        }
+    }
+    tms_isa_limit() = best;
+}
+
+
+TEST_CASE( "Save and load round trip" )
+{
+    const string path = tempPath("rt");
+    for (size_t n : { size_t(0), size_t(1), size_t(63), size_t(100000) })
+    {
+        INFO( "n: " << n );
+        TMSArray<int64_t> ta(n);
+        fillRandom(ta, n);
+        tms_save(ta, path);
+        TMSArray<int64_t> tb;
+        tms_load(path, tb);
+        REQUIRE( tb.size() == n );
+        REQUIRE( equal(ta.begin(), ta.end(), tb.begin()) );
+    }
+
+    struct Point { float x, y, z; };
+    TMSArray<Point> tp(1000);
+    for (size_t i = 0; i < tp.size(); ++i)
+        tp[i] = Point{ float(i), float(i) * 2, -float(i) };
+    tms_save(tp, path);
+    TMSArray<Point> tq;
+    tms_load(path, tq);
+    REQUIRE( tq.size() == 1000 );
+    REQUIRE( tq[999].y == 1998.0f );
+    remove(path.c_str());
+}
+
+
+TEST_CASE( "File layout" )
+{
+    const string path = tempPath("layout");
+    TMSArray<uint32_t> ta(10);
+    for (size_t i = 0; i < ta.size(); ++i)
+        ta[i] = uint32_t(i);
+    tms_save(ta, path);
+
+    unsigned char bytes[64 + 40];
+    {
+        TMSFd file(::open(path.c_str(), O_RDONLY));
+        REQUIRE( file.fd >= 0 );
+        REQUIRE( ::pread(file.fd, bytes, sizeof bytes, 0) == ssize_t(sizeof bytes) );
+        REQUIRE( ::pread(file.fd, bytes, 1, sizeof bytes) == 0 );
+    }
+    TMSFileHeader h;
+    memcpy(&h, bytes, sizeof h);
+    REQUIRE( string(h.magic, 8) == "TMSARRAY" );
+    REQUIRE( h.endian == TMS_FILE_ENDIAN );
+    REQUIRE( h.version == TMS_FILE_VERSION );
+    REQUIRE( h.type == TMS_TYPE_U32 );
+    REQUIRE( h.elem_size == 4 );
+    REQUIRE( h.align == TMS_FILE_ALIGN );
+    REQUIRE( h.count == 10 );
+    REQUIRE( h.data_offset == 64 );
+    REQUIRE( h.data_crc == tms_crc32c(ta.begin(), 40) );
+    REQUIRE( h.header_crc == tms_header_crc(h) );
+    REQUIRE( memcmp(bytes + 64, ta.begin(), 40) == 0 );
+    remove(path.c_str());
+}
+
+
+TEST_CASE( "Type tags" )
+{
+    REQUIRE( tms_type_tag<signed char>() == TMS_TYPE_I8 );
+    REQUIRE( tms_type_tag<int16_t>() == TMS_TYPE_I16 );
+    REQUIRE( tms_type_tag<int>() == TMS_TYPE_I32 );
+    REQUIRE( tms_type_tag<int64_t>() == TMS_TYPE_I64 );
+    REQUIRE( tms_type_tag<unsigned char>() == TMS_TYPE_U8 );
+    REQUIRE( tms_type_tag<uint64_t>() == TMS_TYPE_U64 );
+    REQUIRE( tms_type_tag<float>() == TMS_TYPE_F32 );
+    REQUIRE( tms_type_tag<double>() == TMS_TYPE_F64 );
+    struct Pair { int a, b; };
+    REQUIRE( tms_type_tag<Pair>() == TMS_TYPE_RAW );
+}
+
+
+TEST_CASE( "Load rejects bad files" )
+{
+    const string path = tempPath("bad");
+    TMSArray<int> ta(100);
+    fillRandom(ta, 9);
+    TMSArray<int> keep(3);
+    keep[0] = 7;
+
+    SUBCASE( "Missing file" )
+    {
+        remove(path.c_str());
+        REQUIRE_THROWS_AS( tms_load(path, keep), system_error );
+        REQUIRE_THROWS_AS( TMSArrayView<int>(path, false), system_error );
+    }
+    SUBCASE( "Wrong type" )
+    {
+        tms_save(ta, path);
+        TMSArray<float> tf;
+        REQUIRE_THROWS_AS( tms_load(path, tf), runtime_error );
+        REQUIRE_THROWS_AS( TMSArrayView<unsigned>(path, false), runtime_error );
+    }
+    SUBCASE( "Corrupt header" )
+    {
+        tms_save(ta, path);
+        const uint64_t count = 99;
+        patchFile(path, offsetof(TMSFileHeader, count), &count, 8);
+        REQUIRE_THROWS_AS( tms_load(path, keep), runtime_error );
+        REQUIRE_THROWS_AS( TMSArrayView<int>(path, false), runtime_error );
+    }
+    SUBCASE( "Corrupt data" )
+    {
+        tms_save(ta, path);
+        const unsigned char junk = 0x5A;
+        patchFile(path, 64 + 17, &junk, 1);
+        REQUIRE_THROWS_AS( tms_load(path, keep), runtime_error );
+        REQUIRE_THROWS_AS( TMSArrayView<int>(path, true), runtime_error );
+        REQUIRE_NOTHROW( TMSArrayView<int>(path, false) );
+        TMSArray<int> tb;
+        REQUIRE_NOTHROW( tms_load(path, tb, false) );
+    }
+    SUBCASE( "Truncated" )
+    {
+        tms_save(ta, path);
+        REQUIRE( ::truncate(path.c_str(), 64 + 200) == 0 );
+        REQUIRE_THROWS_AS( tms_load(path, keep), runtime_error );
+        REQUIRE_THROWS_AS( TMSArrayView<int>(path, false), runtime_error );
+        REQUIRE( ::truncate(path.c_str(), 10) == 0 );
+        REQUIRE_THROWS_AS( tms_load(path, keep), runtime_error );
+    }
+    // Strong guarantee: a failed load leaves the target untouched
+    REQUIRE( keep.size() == 3 );
+    REQUIRE( keep[0] == 7 );
+    remove(path.c_str());
+}
+
+
+TEST_CASE( "Load converts byte order" )
+{
+    const string path = tempPath("swap");
+    TMSArray<uint32_t> ta(50);
+    fillRandom(ta, 3);
+    TMSArray<uint32_t> sw(ta);
+    tms_bswap(sw.begin(), 4, sw.size());
+
+    // Header as a big-endian writer would produce it
+    TMSFileHeader h = tms_make_header(ta.begin(), ta.size());
+    h.data_crc = tms_crc32c(sw.begin(), 200);
+    h.endian = __builtin_bswap32(h.endian);
+    h.version = __builtin_bswap16(h.version);
+    h.type = __builtin_bswap16(h.type);
+    h.elem_size = __builtin_bswap32(h.elem_size);
+    h.align = __builtin_bswap32(h.align);
+    h.count = __builtin_bswap64(h.count);
+    h.data_offset = __builtin_bswap64(h.data_offset);
+    h.data_crc = __builtin_bswap32(h.data_crc);
+    h.header_crc = __builtin_bswap32(tms_header_crc(h));
+    tms_save(ta, path);
+    patchFile(path, 0, &h, sizeof h);
+    patchFile(path, 64, sw.begin(), 200);
+
+    TMSArray<uint32_t> tb;
+    tms_load(path, tb);
+    REQUIRE( equal(ta.begin(), ta.end(), tb.begin()) );
+    REQUIRE_THROWS_AS( TMSArrayView<uint32_t>(path, false), runtime_error );
+    remove(path.c_str());
+}
+
+
+TEST_CASE( "View maps the file" )
+{
+    const string path = tempPath("view");
+    TMSArray<double> ta(5000);
+    for (size_t i = 0; i < ta.size(); ++i)
+        ta[i] = double(i) * 0.5;
+    tms_save(ta, path);
+
+    TMSArrayView<double> tv(path, true);
+    REQUIRE( tv.size() == 5000 );
+    REQUIRE( !tv.empty() );
+    REQUIRE( reinterpret_cast<uintptr_t>(tv.data()) % TMS_FILE_ALIGN == 0 );
+    REQUIRE( equal(tv.begin(), tv.end(), ta.begin()) );
+    REQUIRE( tv[4999] == 2499.5 );
+    REQUIRE( tv.advise(TMS_ADVISE_SEQUENTIAL) );
+    REQUIRE( tv.advise(TMS_ADVISE_WILLNEED) );
+
+    const TMSIsa best = tms_isa_limit();
+    for (int level = 0; level <= best; ++level)
+    {
+        tms_isa_limit() = TMSIsa(level);
+        INFO( "ISA: " << tms_isa_name(TMSIsa(level)) );
+        REQUIRE( tv.find(100.0) - tv.begin() == 200 );
+        REQUIRE( tv.count(100.0) == 1 );
+        REQUIRE( tv.contains(0.0) );
+        REQUIRE( !tv.contains(0.25) );
+    }
+    tms_isa_limit() = best;
+
+    // The mapping outlives the file name
+    remove(path.c_str());
+    REQUIRE( tv[1234] == 617.0 );
+
+    TMSArrayView<double> tw(move(tv));
+    REQUIRE( tv.empty() );
+    REQUIRE( tw.size() == 5000 );
+    tv = move(tw);
+    REQUIRE( tv.size() == 5000 );
+    REQUIRE( tw.empty() );
+}
+
+
+TEST_CASE( "Empty view" )
+{
+    const string path = tempPath("empty");
+    TMSArray<int> ta(0);
+    tms_save(ta, path);
+    TMSArrayView<int> tv(path, true);
+    REQUIRE( tv.empty() );
+    REQUIRE( tv.begin() == tv.end() );
+    REQUIRE( !tv.contains(0) );
+    remove(path.c_str());
+}
+
+
+// *********************************************************************
+// Main Program
+// *********************************************************************
+
+
+// userPause
+// Wait for user to press ENTER: read all chars through first newline.
+void userPause()
+{
+    std::cout.flush();
+    while (std::cin.get() != '\n') ;
+}
+
+
+// Main program
+// Run all tests. Prompt for ENTER before exiting.
+int main(int argc,
+         char *argv[])
+{
+    doctest::Context dtcontext;
+                             // Primary doctest object
+    int dtresult;            // doctest return code; for return by main
+
+    // Handle command line
+    dtcontext.applyCommandLine(argc, argv);
+    dtresult = 0;            // doctest flags no command-line errors
+                             //  (strange but true)
+
+    if (!dtresult)           // Continue only if no command-line error
+    {
+        // Run test suites
+        cout << "BEGIN tests for " << test_suite_name << "\n" << endl;
+        dtresult = dtcontext.run();
+        cout << "END tests for " << test_suite_name << "\n" << endl;
+    }
+
+    // Wait for user
+    std::cout << "Press ENTER to quit ";
+    userPause();
+
+    // Program return value is return code from doctest
+    return dtresult;
+}
@@ -0,0 +1,557 @@
+// tmssetops.hpp
+// Matthew Johnson
+// 10/17/2026
+// set intersection, union and difference of sorted TMSArray<uint32_t>
+//  (posting lists), with SIMD block compares and galloping
+
+#pragma once
+// for single inclusion
+
+#include "tmsarray.hpp"
+// For class template TMSArray
+
+#include "tmssimd.hpp"
+// For tms_isa_limit
+// For TMSIsa
+// For TMS_SIMD_X86
+
+#include "tmssorted.hpp"
+// For tms_partition_point
+
+#include <cstddef>
+// For std::size_t
+
+#include <cstdint>
+// For std::uint32_t
+
+#include <cstring>
+// For std::memcpy
+
+#include <algorithm>
+// For std::min
+// For std::max
+
+#include <utility>
+// For std::swap
+
+
+
+// Size ratio at which the small list is galloped through the large one
+//  instead of merging both
+constexpr std::size_t TMS_GALLOP_RATIO = 32;
+
+// Output elements a kernel may write past the result (whole-vector
+//  stores); the TMSArray front ends size for it
+constexpr std::size_t TMS_SET_SLACK = 16;
+
+
+// What a block kernel produces for each a element
+enum TMSSetMode
+{
+    TMS_SET_INTERSECT,      // write a elements found in b
+    TMS_SET_COUNT,          // only count them
+    TMS_SET_DIFFERENCE      // write a elements not found in b
+};
+
+
+// Merge position shared by the SIMD block loop and the scalar tail.
+//  found has bit l set if a[i + l] already matched an earlier b block
+//  (difference mode only).
+struct TMSSetCursor
+{
+    std::size_t i;
+    std::size_t j;
+    std::size_t k;
+    unsigned    found;
+};
+
+
+
+// *********************************************************************
+// Scalar kernels (reference results; tails of the SIMD kernels)
+// *********************************************************************
+
+
+// tms_gallop
+// No-Throw Guarantee
+// Pre:
+//      data[0..n) strictly increasing; from <= n
+// Post:
+//      Returns first index >= from with data[index] >= x (n if none).
+//      Probes from, from+1, from+2, from+4, ... then binary searches the
+//      last gap, so cost is O(log distance) rather than O(log n).
+inline std::size_t tms_gallop(const std::uint32_t * data, std::size_t n,
+                              std::size_t from, std::uint32_t x) noexcept
+{
+    if (from >= n || data[from] >= x)
+        return from;
+    std::size_t bound = 1;
+    while (from + bound < n && data[from + bound] < x)
+        bound *= 2;
+    // data[from + bound / 2] < x <= data[from + bound] (or end of data)
+    std::size_t lo = from + bound / 2 + 1;
+    std::size_t hi = std::min(from + bound + 1, n);
+    return lo + tms_partition_point(data + lo, hi - lo,
+                                    [x](std::uint32_t v) { return v < x; });
+}
+
+
+// tms_set_tail
+// Finishes a merge from cur in mode; branch-free per step
+template <TMSSetMode mode>
+std::size_t tms_set_tail(const std::uint32_t * a, std::size_t na,
+                         const std::uint32_t * b, std::size_t nb,
+                         std::uint32_t * out, TMSSetCursor cur)
+{
+    std::size_t i = cur.i, j = cur.j, k = cur.k;
+    const std::size_t blockEnd = i + 32;    // found covers a[i .. i+32)
+    while (i < na && j < nb)
+    {
+        const std::uint32_t x = a[i], y = b[j];
+        if (mode == TMS_SET_DIFFERENCE)
+        {
+            const bool seen = i < blockEnd && ((cur.found >> (i - cur.i)) & 1);
+            out[k] = x;
+            k += (x < y && !seen) ? 1 : 0;
+        }
+        else
+        {
+            if (mode == TMS_SET_INTERSECT)
+                out[k] = x;
+            k += (x == y) ? 1 : 0;
+        }
+        i += (x <= y) ? 1 : 0;
+        j += (y <= x) ? 1 : 0;
+    }
+    if (mode == TMS_SET_DIFFERENCE)
+        for (; i < na; ++i)
+            if (!(i < blockEnd && ((cur.found >> (i - cur.i)) & 1)))
+                out[k++] = a[i];
+    return k;
+}
+
+
+// tms_set_gallop
+// Intersection/count/difference when one list is much shorter: each
+//  element of the short list is galloped for in the long one, and for
+//  a long a the runs of a between b's elements are copied whole
+template <TMSSetMode mode>
+std::size_t tms_set_gallop(const std::uint32_t * a, std::size_t na,
+                           const std::uint32_t * b, std::size_t nb,
+                           std::uint32_t * out)
+{
+    std::size_t k = 0;
+    if (mode == TMS_SET_DIFFERENCE && nb < na)
+    {
+        std::size_t i = 0;
+        for (std::size_t j = 0; j < nb && i < na; ++j)
+        {
+            std::size_t p = tms_gallop(a, na, i, b[j]);
+            std::memcpy(out + k, a + i, (p - i) * sizeof(std::uint32_t));
+            k += p - i;
+            i = p + ((p < na && a[p] == b[j]) ? 1 : 0);
+        }
+        std::memcpy(out + k, a + i, (na - i) * sizeof(std::uint32_t));
+        return k + (na - i);
+    }
+
+    const bool aShort = na <= nb;
+    const std::uint32_t * s = aShort ? a : b;
+    const std::uint32_t * l = aShort ? b : a;
+    const std::size_t ns = aShort ? na : nb;
+    const std::size_t nl = aShort ? nb : na;
+    std::size_t j = 0;
+    for (std::size_t i = 0; i < ns; ++i)
+    {
+        j = tms_gallop(l, nl, j, s[i]);
+        const bool hit = j < nl && l[j] == s[i];
+        if (mode == TMS_SET_DIFFERENCE)
+        {
+            out[k] = s[i];
+            k += hit ? 0 : 1;
+        }
+        else
+        {
+            if (mode == TMS_SET_INTERSECT)
+                out[k] = s[i];
+            k += hit ? 1 : 0;
+        }
+    }
+    return k;
+}
+
+
+
+// *********************************************************************
+// SIMD policies and block kernels
+// *********************************************************************
+
+
+#ifdef TMS_SIMD_X86
+
+TMS_AVX512_DIAG_PUSH
+
+#define TMS_SET_SSE2   __attribute__((target("sse2"), always_inline))
+#define TMS_SET_AVX2   __attribute__((target("avx2"), always_inline))
+#define TMS_SET_AVX512 __attribute__((target("avx512f"), always_inline))
+
+
+// TMSCompressTable
+// For each 8-bit lane mask, the indices of its set lanes, packed to the
+//  front: the AVX2 permute that left-packs the selected lanes
+struct TMSCompressTable
+{
+    unsigned char idx[256][8];
+
+    constexpr TMSCompressTable()
+        :idx()
+    {
+        for (unsigned m = 0; m < 256; ++m)
+        {
+            unsigned k = 0;
+            for (unsigned l = 0; l < 8; ++l)
+                if ((m >> l) & 1)
+                    idx[m][k++] = (unsigned char)l;
+        }
+    }
+};
+
+inline const TMSCompressTable & tms_compress_table() noexcept
+{
+    static constexpr TMSCompressTable table;
+    return table;
+}
+
+
+// Policies: Lanes uint32 per block; match(a, b) returns the mask of a's
+//  lanes equal to some lane of b (all-pairs compare by rotating b);
+//  compress(out, a, mask) writes a's masked lanes in order and returns
+//  the new end. compress may store up to Lanes elements.
+
+// ---- SSE2 ----
+struct TMSSetSse2
+{
+    static constexpr std::size_t Lanes = 4;
+
+    TMS_SET_SSE2 static inline unsigned match(const std::uint32_t * a,
+                                              const std::uint32_t * b)
+    {
+        __m128i va = _mm_loadu_si128((const __m128i *)a);
+        __m128i vb = _mm_loadu_si128((const __m128i *)b);
+        __m128i m = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi32(va, vb),
+                         _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, 0x39))),
+            _mm_or_si128(_mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, 0x4E)),
+                         _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, 0x93))));
+        return unsigned(_mm_movemask_ps(_mm_castsi128_ps(m)));
+    }
+
+    TMS_SET_SSE2 static inline std::uint32_t * compress(
+        std::uint32_t * out, const std::uint32_t * a, unsigned mask)
+    {
+        for (unsigned l = 0; l < Lanes; ++l)
+        {
+            *out = a[l];
+            out += (mask >> l) & 1;
+        }
+        return out;
+    }
+};
+
+
+// ---- AVX2 ----
+struct TMSSetAvx2
+{
+    static constexpr std::size_t Lanes = 8;
+
+    TMS_SET_AVX2 static inline unsigned match(const std::uint32_t * a,
+                                              const std::uint32_t * b)
+    {
+        __m256i va = _mm256_loadu_si256((const __m256i *)a);
+        __m256i vb = _mm256_loadu_si256((const __m256i *)b);
+        __m256i vs = _mm256_permute2x128_si256(vb, vb, 1);  // swap halves
+        __m256i m0 = _mm256_or_si256(
+            _mm256_cmpeq_epi32(va, vb),
+            _mm256_cmpeq_epi32(va, _mm256_shuffle_epi32(vb, 0x39)));
+        __m256i m1 = _mm256_or_si256(
+            _mm256_cmpeq_epi32(va, _mm256_shuffle_epi32(vb, 0x4E)),
+            _mm256_cmpeq_epi32(va, _mm256_shuffle_epi32(vb, 0x93)));
+        __m256i m2 = _mm256_or_si256(
+            _mm256_cmpeq_epi32(va, vs),
+            _mm256_cmpeq_epi32(va, _mm256_shuffle_epi32(vs, 0x39)));
+        __m256i m3 = _mm256_or_si256(
+            _mm256_cmpeq_epi32(va, _mm256_shuffle_epi32(vs, 0x4E)),
+            _mm256_cmpeq_epi32(va, _mm256_shuffle_epi32(vs, 0x93)));
+        __m256i m = _mm256_or_si256(_mm256_or_si256(m0, m1),
+                                    _mm256_or_si256(m2, m3));
+        return unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(m)));
+    }
+
+    TMS_SET_AVX2 static inline std::uint32_t * compress(
+        std::uint32_t * out, const std::uint32_t * a, unsigned mask)
+    {
+        __m256i va = _mm256_loadu_si256((const __m256i *)a);
+        __m256i perm = _mm256_cvtepu8_epi32(_mm_loadl_epi64(
+            (const __m128i *)tms_compress_table().idx[mask]));
+        _mm256_storeu_si256((__m256i *)out,
+                            _mm256_permutevar8x32_epi32(va, perm));
+        return out + __builtin_popcount(mask);
+    }
+};
+
+
+// ---- AVX-512 ----
+struct TMSSetAvx512
+{
+    static constexpr std::size_t Lanes = 16;
+
+    TMS_SET_AVX512 static inline unsigned match(const std::uint32_t * a,
+                                                const std::uint32_t * b)
+    {
+        __m512i va = _mm512_loadu_si512(a);
+        __m512i vb = _mm512_loadu_si512(b);
+        __mmask16 m = _mm512_cmpeq_epi32_mask(va, vb);
+        m |= _mm512_cmpeq_epi32_mask(va, _mm512_alignr_epi32(vb, vb, 1));
+        m |= _mm512_cmpeq_epi32_mask(va, _mm512_alignr_epi32(vb, vb, 2));
+        m |= _mm512_cmpeq_epi32_mask(va, _mm512_alignr_epi32(vb, vb, 3));
+        m |= _mm512_cmpeq_epi32_mask(va, _mm512_alignr_epi32(vb, vb, 4));
+        m |= _mm512_cmpeq_epi32_mask(va, _mm512_alignr_epi32(vb, vb, 5));
+        m |= _mm512_cmpeq_epi32_mask(va, _mm512_alignr_epi32(vb, vb, 6));
+        m |= _mm512_cmpeq_epi32_mask(va, _mm512_alignr_epi32(vb, vb, 7));
+        m |= _mm512_cmpeq_epi32_mask(va, _mm512_alignr_epi32(vb, vb, 8));
+        m |= _mm512_cmpeq_epi32_mask(va, _mm512_alignr_epi32(vb, vb, 9));
+        m |= _mm512_cmpeq_epi32_mask(va, _mm512_alignr_epi32(vb, vb, 10));
+        m |= _mm512_cmpeq_epi32_mask(va, _mm512_alignr_epi32(vb, vb, 11));
+        m |= _mm512_cmpeq_epi32_mask(va, _mm512_alignr_epi32(vb, vb, 12));
+        m |= _mm512_cmpeq_epi32_mask(va, _mm512_alignr_epi32(vb, vb, 13));
+        m |= _mm512_cmpeq_epi32_mask(va, _mm512_alignr_epi32(vb, vb, 14));
+        m |= _mm512_cmpeq_epi32_mask(va, _mm512_alignr_epi32(vb, vb, 15));
+        return unsigned(m);
+    }
+
+    TMS_SET_AVX512 static inline std::uint32_t * compress(
+        std::uint32_t * out, const std::uint32_t * a, unsigned mask)
+    {
+        _mm512_mask_compressstoreu_epi32(out, __mmask16(mask),
+                                         _mm512_loadu_si512(a));
+        return out + __builtin_popcount(mask);
+    }
+};
+
+
+// TMS_SET_BLOCK_KERNEL
+// Defines tms_set_blocks_<isa>: compares one Lanes-block of a against
+//  one of b per step and advances whichever block has the smaller last
+//  element (both on a tie). Intersection writes matches at once (in a
+//  set each a element matches at most one b block); difference ORs the
+//  matches into found and writes the unmatched lanes when a's block is
+//  retired. Returns the cursor for tms_set_tail.
+#define TMS_SET_BLOCK_KERNEL(isa, attr)                                      \
+template <typename P, TMSSetMode mode>                                       \
+attr TMSSetCursor tms_set_blocks_##isa(const std::uint32_t * a,              \
+                                       std::size_t na,                       \
+                                       const std::uint32_t * b,              \
+                                       std::size_t nb, std::uint32_t * out)  \
+{                                                                            \
+    const std::size_t L = P::Lanes;                                          \
+    const unsigned all = (1u << L) - 1;                                      \
+    std::size_t i = 0, j = 0, count = 0;                                     \
+    std::uint32_t * o = out;                                                 \
+    unsigned found = 0;                                                      \
+    while (i + L <= na && j + L <= nb)                                       \
+    {                                                                        \
+        const unsigned m = P::match(a + i, b + j);                           \
+        const std::uint32_t amax = a[i + L - 1], bmax = b[j + L - 1];        \
+        if (mode == TMS_SET_INTERSECT)                                       \
+            o = P::compress(o, a + i, m);                                    \
+        else if (mode == TMS_SET_COUNT)                                      \
+            count += std::size_t(__builtin_popcount(m));                     \
+        else                                                                 \
+        {                                                                    \
+            found |= m;                                                      \
+            if (amax <= bmax)                                                \
+            {                                                                \
+                o = P::compress(o, a + i, ~found & all);                     \
+                found = 0;                                                   \
+            }                                                                \
+        }                                                                    \
+        i += amax <= bmax ? L : 0;                                           \
+        j += bmax <= amax ? L : 0;                                           \
+    }                                                                        \
+    const std::size_t k = mode == TMS_SET_COUNT ? count                      \
+                                                : std::size_t(o - out);      \
+    return TMSSetCursor{ i, j, k, found };                                   \
+}
+
+TMS_SET_BLOCK_KERNEL(sse2, __attribute__((target("sse2"))))
+TMS_SET_BLOCK_KERNEL(avx2, __attribute__((target("avx2"))))
+TMS_SET_BLOCK_KERNEL(avx512, __attribute__((target("avx512f"))))
+
+#undef TMS_SET_BLOCK_KERNEL
+#undef TMS_SET_SSE2
+#undef TMS_SET_AVX2
+#undef TMS_SET_AVX512
+
+TMS_AVX512_DIAG_POP
+
+#endif // TMS_SIMD_X86
+
+
+// tms_set_run
+// No-Throw Guarantee
+// Pre:
+//      a[0..na), b[0..nb) strictly increasing; out has room for the
+//      result + TMS_SET_SLACK (unused for TMS_SET_COUNT)
+// Post:
+//      Returns result size (written to out unless counting). Gallops
+//      when the sizes differ by TMS_GALLOP_RATIO or more; otherwise runs
+//      the best block kernel tms_isa_limit() allows, then the scalar tail
+template <TMSSetMode mode>
+std::size_t tms_set_run(const std::uint32_t * a, std::size_t na,
+                        const std::uint32_t * b, std::size_t nb,
+                        std::uint32_t * out)
+{
+    if (na == 0 || nb == 0)
+    {
+        if (mode == TMS_SET_DIFFERENCE && na != 0)
+            std::memcpy(out, a, na * sizeof(std::uint32_t));
+        return mode == TMS_SET_DIFFERENCE ? na : 0;
+    }
+    if (std::min(na, nb) * TMS_GALLOP_RATIO <= std::max(na, nb))
+        return tms_set_gallop<mode>(a, na, b, nb, out);
+
+    TMSSetCursor cur{ 0, 0, 0, 0 };
+#ifdef TMS_SIMD_X86
+    const TMSIsa level = tms_isa_limit();
+    if (level >= TMS_ISA_AVX512)
+        cur = tms_set_blocks_avx512<TMSSetAvx512, mode>(a, na, b, nb, out);
+    else if (level >= TMS_ISA_AVX2)
+        cur = tms_set_blocks_avx2<TMSSetAvx2, mode>(a, na, b, nb, out);
+    else if (level >= TMS_ISA_SSE2)
+        cur = tms_set_blocks_sse2<TMSSetSse2, mode>(a, na, b, nb, out);
+#endif
+    return tms_set_tail<mode>(a, na, b, nb, out, cur);
+}
+
+
+// tms_set_union_run
+// No-Throw Guarantee
+// Pre:
+//      a[0..na), b[0..nb) strictly increasing; out has room for na + nb
+// Post:
+//      Returns size of the union written to out. Skewed sizes gallop and
+//      copy the long list's runs whole; otherwise a branch-free merge.
+inline std::size_t tms_set_union_run(const std::uint32_t * a, std::size_t na,
+                                     const std::uint32_t * b, std::size_t nb,
+                                     std::uint32_t * out) noexcept
+{
+    std::size_t i = 0, j = 0, k = 0;
+    if (std::min(na, nb) * TMS_GALLOP_RATIO <= std::max(na, nb))
+    {
+        if (na > nb)
+        {
+            std::swap(a, b);
+            std::swap(na, nb);
+        }
+        for (; i < na; ++i)     // a short: copy b's run up to each a[i]
+        {
+            std::size_t p = tms_gallop(b, nb, j, a[i]);
+            std::memcpy(out + k, b + j, (p - j) * sizeof(std::uint32_t));
+            k += p - j;
+            out[k++] = a[i];
+            j = p + ((p < nb && b[p] == a[i]) ? 1 : 0);
+        }
+    }
+    else
+        while (i < na && j < nb)
+        {
+            const std::uint32_t x = a[i], y = b[j];
+            out[k++] = x < y ? x : y;
+            i += (x <= y) ? 1 : 0;
+            j += (y <= x) ? 1 : 0;
+        }
+    std::memcpy(out + k, a + i, (na - i) * sizeof(std::uint32_t));
+    k += na - i;
+    std::memcpy(out + k, b + j, (nb - j) * sizeof(std::uint32_t));
+    return k + (nb - j);
+}
+
+
+
+// *********************************************************************
+// TMSArray front ends
+// *********************************************************************
+
+
+// All of these take strictly increasing (duplicate-free) lists, and
+//  write into out, which must not alias a or b. out is resized to the
+//  result; its storage is reused when it is already large enough, so a
+//  preallocated out never reallocates.
+
+
+// tms_set_intersection
+// Strong Guarantee
+// Exception-Neutral
+// Pre:
+//      a, b strictly increasing
+// Post:
+//      out == elements in both a and b, increasing
+inline void tms_set_intersection(const TMSArray<std::uint32_t> & a,
+                                 const TMSArray<std::uint32_t> & b,
+                                 TMSArray<std::uint32_t> & out)
+{
+    out.resize(std::min(a.size(), b.size()) + TMS_SET_SLACK);
+    out.resize(tms_set_run<TMS_SET_INTERSECT>(a.begin(), a.size(),
+                                              b.begin(), b.size(),
+                                              out.begin()));
+}
+
+
+// tms_set_intersection_count
+// No-Throw Guarantee
+// Exception-Neutral
+// Pre:
+//      a, b strictly increasing
+// Post:
+//      Returns number of elements in both a and b
+inline std::size_t tms_set_intersection_count(
+    const TMSArray<std::uint32_t> & a, const TMSArray<std::uint32_t> & b)
+{
+    return tms_set_run<TMS_SET_COUNT>(a.begin(), a.size(), b.begin(),
+                                      b.size(), nullptr);
+}
+
+
+// tms_set_union
+// Strong Guarantee
+// Exception-Neutral
+// Pre:
+//      a, b strictly increasing
+// Post:
+//      out == elements in a or b, increasing, without duplicates
+inline void tms_set_union(const TMSArray<std::uint32_t> & a,
+                          const TMSArray<std::uint32_t> & b,
+                          TMSArray<std::uint32_t> & out)
+{
+    out.resize(a.size() + b.size() + TMS_SET_SLACK);
+    out.resize(tms_set_union_run(a.begin(), a.size(), b.begin(), b.size(),
+                                 out.begin()));
+}
+
+
+// tms_set_difference
+// Strong Guarantee
+// Exception-Neutral
+// Pre:
+//      a, b strictly increasing
+// Post:
+//      out == elements of a not in b, increasing
+inline void tms_set_difference(const TMSArray<std::uint32_t> & a,
+                               const TMSArray<std::uint32_t> & b,
+                               TMSArray<std::uint32_t> & out)
+{
+    out.resize(a.size() + TMS_SET_SLACK);
+    out.resize(tms_set_run<TMS_SET_DIFFERENCE>(a.begin(), a.size(),
+                                               b.begin(), b.size(),
+                                               out.begin()));
+}
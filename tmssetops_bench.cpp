@@ -0,0 +1,124 @@
+// tmssetops_bench.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Benchmark: tms_set_intersection (each ISA level), _count, _union and
+//  _difference vs. the std::set_* merges, for size ratios 1:1 to
+//  1:10000 against a fixed large posting list.
+// Usage: tmssetops_bench [large list elements=4000000]
+// Requires tmssetops.hpp, tmssorted.hpp, tmssimd.hpp, tmsarray.hpp,
+//  tmsbench.hpp
+
+#include "tmssetops.hpp"
+#include "tmsbench.hpp"
+
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::uint32_t;
+using std::uint64_t;
+#include <algorithm>
+#include <iostream>
+using std::cout;
+#include <string>
+using std::string;
+
+
+// makeSet
+// n strictly increasing values with mean gap spread + 1
+TMSArray<uint32_t> makeSet(size_t n, uint32_t spread, uint64_t seed)
+{
+    TMSArray<uint32_t> ta(n);
+    uint64_t x = seed * 0x9E3779B97F4A7C15ull + 7;
+    uint32_t v = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        v += 1 + uint32_t(x % (2 * spread + 1));
+        ta[i] = v;
+    }
+    return ta;
+}
+
+
+// benchRatio
+// One table: small list of large/ratio elements spread over the same
+//  value range as the large list
+void benchRatio(size_t ratio, const TMSArray<uint32_t> & large)
+{
+    const size_t ns = std::max<size_t>(1, large.size() / ratio);
+    TMSArray<uint32_t> small = makeSet(ns, uint32_t(ratio * 2), ratio + 1);
+    const size_t bytes = (ns + large.size()) * sizeof(uint32_t);
+    TMSArray<uint32_t> out(large.size() + ns + TMS_SET_SLACK);
+    const int reps = 5;
+
+    cout << "\n== 1:" << ratio << " (" << ns << " x " << large.size()
+         << ") ==\n";
+
+    double secs = tms_time_best(reps, [&]
+    {
+        tms_sink(std::set_intersection(small.begin(), small.end(),
+                                       large.begin(), large.end(),
+                                       out.begin()));
+    });
+    tms_report("std::set_intersection", secs, bytes);
+
+    const TMSIsa best = tms_detect_isa();
+    for (int level = TMS_ISA_SCALAR; level <= best; ++level)
+    {
+        tms_isa_limit() = TMSIsa(level);
+        secs = tms_time_best(reps, [&]
+        {
+            tms_set_intersection(small, large, out);
+            tms_sink(out[0]);
+        });
+        tms_report(string("intersection ") + tms_isa_name(TMSIsa(level)),
+                   secs, bytes);
+    }
+    tms_isa_limit() = best;
+
+    secs = tms_time_best(reps, [&]
+    {
+        tms_sink(tms_set_intersection_count(small, large));
+    });
+    tms_report("intersection count", secs, bytes);
+
+    secs = tms_time_best(reps, [&]
+    {
+        tms_sink(std::set_union(small.begin(), small.end(), large.begin(),
+                                large.end(), out.begin()));
+    });
+    tms_report("std::set_union", secs, bytes);
+    secs = tms_time_best(reps, [&]
+    {
+        tms_set_union(small, large, out);
+        tms_sink(out[0]);
+    });
+    tms_report("tms_set_union", secs, bytes);
+
+    secs = tms_time_best(reps, [&]
+    {
+        tms_sink(std::set_difference(large.begin(), large.end(),
+                                     small.begin(), small.end(),
+                                     out.begin()));
+    });
+    tms_report("std::set_difference large-small", secs, bytes);
+    secs = tms_time_best(reps, [&]
+    {
+        tms_set_difference(large, small, out);
+        tms_sink(out[0]);
+    });
+    tms_report("tms_set_difference large-small", secs, bytes);
+}
+
+
+int main(int argc, char * argv[])
+{
+    const size_t n = tms_arg(argc, argv, 1, 4000000);
+    TMSArray<uint32_t> large = makeSet(n, 2, 1);
+    for (size_t ratio : { 1, 10, 100, 1000, 10000 })
+        benchRatio(ratio, large);
+    return 0;
+}
@@ -0,0 +1,262 @@
+// tmssetops_test.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Test program for tms_set_intersection, tms_set_intersection_count,
+//  tms_set_union, tms_set_difference, tms_gallop
+// Uses the "doctest" unit-testing framework, version 2
+// Requires doctest.h, tmssetops.hpp, tmssorted.hpp, tmssimd.hpp,
+//  tmsarray.hpp
+
+// Includes for code to be tested
+#include "tmssetops.hpp"     // For tms_set_intersection, ...
+#include "tmssetops.hpp"     // Double-inclusion check, for testing only
+
+// Includes for the "doctest" unit-testing framework
+#define DOCTEST_CONFIG_IMPLEMENT
+                             // We write our own main
+#define DOCTEST_CONFIG_SUPER_FAST_ASSERTS
+                             // Reduce compile time
+#include "doctest.h"         // For doctest
+
+// Includes for all test programs
+#include <iostream>
+using std::cout;
+using std::endl;
+using std::cin;
+#include <string>
+using std::string;
+
+// Additional includes for this test program
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::uint32_t;
+using std::uint64_t;
+#include <algorithm>
+using std::equal;
+using std::set_intersection;
+using std::set_union;
+using std::set_difference;
+#include <iterator>
+using std::back_inserter;
+#include <vector>
+using std::vector;
+
+// Printable name for this test suite
+const string test_suite_name =
+    "sorted-set operations on TMSArray<uint32_t>";
+
+
+// *********************************************************************
+// Helper Functions for This Test Program
+// *********************************************************************
+
+
+// makeSet
+// n strictly increasing values; gaps drawn from [1, 2*spread] so two
+//  sets with the same spread overlap by roughly half
+TMSArray<uint32_t> makeSet(size_t n, uint32_t spread, uint64_t seed)
+{
+    TMSArray<uint32_t> ta(n);
+    uint64_t x = seed * 0x9E3779B97F4A7C15ull + 7;
+    uint32_t v = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        v += 1 + uint32_t(x % (2 * spread));
+        ta[i] = v;
+    }
+    return ta;
+}
+
+
+// sameAs
+// ta holds exactly the elements of ref
+bool sameAs(const TMSArray<uint32_t> & ta, const vector<uint32_t> & ref)
+{
+    return ta.size() == ref.size()
+           && equal(ta.begin(), ta.end(), ref.begin());
+}
+
+
+// checkPair
+// All four operations on (a, b) agree with the std:: algorithms
+void checkPair(const TMSArray<uint32_t> & a, const TMSArray<uint32_t> & b)
+{
+    vector<uint32_t> inter, uni, diff;
+    set_intersection(a.begin(), a.end(), b.begin(), b.end(),
+                     back_inserter(inter));
+    set_union(a.begin(), a.end(), b.begin(), b.end(), back_inserter(uni));
+    set_difference(a.begin(), a.end(), b.begin(), b.end(),
+                   back_inserter(diff));
+
+    TMSArray<uint32_t> out;
+    tms_set_intersection(a, b, out);
+    REQUIRE( sameAs(out, inter) );
+    REQUIRE( tms_set_intersection_count(a, b) == inter.size() );
+    tms_set_union(a, b, out);
+    REQUIRE( sameAs(out, uni) );
+    tms_set_difference(a, b, out);
+    REQUIRE( sameAs(out, diff) );
+}
+
+
+// checkAllLevels
+// Runs check() once for each ISA level this CPU has
+template <typename Func>
+void checkAllLevels(Func check)
+{
+    const TMSIsa best = tms_detect_isa();
+    for (int level = TMS_ISA_SCALAR; level <= best; ++level)
+    {
+        tms_isa_limit() = TMSIsa(level);
+        INFO( "ISA " << tms_isa_name(TMSIsa(level)) );
+        check();
+    }
+    tms_isa_limit() = best;
+}
+
+
+// *********************************************************************
+// Test Cases
+// *********************************************************************
+
+
+TEST_CASE( "tms_gallop" )
+{
+    TMSArray<uint32_t> ta = makeSet(1000, 4, 1);
+    bool allMatch = true;
+    for (size_t from : { 0, 1, 17, 500, 999, 1000 })
+        for (uint32_t x = 0; x < ta[999] + 3; x += 3)
+        {
+            size_t expect = std::lower_bound(ta.begin() + from, ta.end(), x)
+                            - ta.begin();
+            allMatch = allMatch && tms_gallop(ta.begin(), 1000, from, x)
+                                   == expect;
+        }
+    REQUIRE( allMatch );
+}
+
+
+TEST_CASE( "Similar sizes (block kernels)" )
+{
+    checkAllLevels([]
+    {
+        for (size_t na : { 0, 1, 3, 16, 17, 100, 1000, 5003 })
+            for (size_t nb : { 0, 2, 15, 64, 999, 4096 })
+                for (uint32_t spread : { 1, 3, 50 })
+                {
+                    if (na != 0 && nb != 0 && (na > 31 * nb || nb > 31 * na))
+                        continue;
+                    INFO( "na " << na << " nb " << nb << " spread "
+                          << spread );
+                    checkPair(makeSet(na, spread, na), makeSet(nb, spread, 3));
+                }
+    });
+}
+
+
+TEST_CASE( "Identical, disjoint and interleaved lists" )
+{
+    checkAllLevels([]
+    {
+        TMSArray<uint32_t> a = makeSet(777, 5, 9);
+        checkPair(a, a);
+
+        TMSArray<uint32_t> evens(500), odds(500);
+        for (size_t i = 0; i < 500; ++i)
+        {
+            evens[i] = uint32_t(2 * i);
+            odds[i] = uint32_t(2 * i + 1);
+        }
+        checkPair(evens, odds);
+
+        TMSArray<uint32_t> low(300), high(300);
+        for (size_t i = 0; i < 300; ++i)
+        {
+            low[i] = uint32_t(i);
+            high[i] = uint32_t(1000 + i);
+        }
+        checkPair(low, high);
+        checkPair(high, low);
+    });
+}
+
+
+TEST_CASE( "Skewed sizes (galloping)" )
+{
+    TMSArray<uint32_t> big = makeSet(200000, 4, 11);
+    for (size_t small : { 1, 5, 100, 6000 })
+    {
+        INFO( "small " << small );
+        // draw the small list partly from big, partly not
+        TMSArray<uint32_t> s = makeSet(small, 4 * 200000 / uint32_t(small),
+                                       5);
+        for (size_t i = 0; i < small; i += 2)
+            s[i] = big[(i * 200000) / small];
+        std::sort(s.begin(), s.end());
+        s.resize(size_t(std::unique(s.begin(), s.end()) - s.begin()));
+        checkPair(s, big);
+        checkPair(big, s);
+    }
+}
+
+
+TEST_CASE( "Preallocated output is reused" )
+{
+    TMSArray<uint32_t> a = makeSet(1000, 2, 1), b = makeSet(1000, 2, 2);
+    TMSArray<uint32_t> out(4096);
+    const uint32_t * storage = out.begin();
+    tms_set_intersection(a, b, out);
+    tms_set_union(a, b, out);
+    tms_set_difference(a, b, out);
+    REQUIRE( out.begin() == storage );
+}
+
+
+// *********************************************************************
+// Main Program
+// *********************************************************************
+
+
+// userPause
+// Wait for user to press ENTER: read all chars through first newline.
+void userPause()
+{
+    std::cout.flush();
+    while (std::cin.get() != '\n') ;
+}
+
+
+// Main program
+// Run all tests. Prompt for ENTER before exiting.
+int main(int argc,
+         char *argv[])
+{
+    doctest::Context dtcontext;
+                             // Primary doctest object
+    int dtresult;            // doctest return code; for return by main
+
+    // Handle command line
+    dtcontext.applyCommandLine(argc, argv);
+    dtresult = 0;            // doctest flags no command-line errors
+                             //  (strange but true)
+
+    if (!dtresult)           // Continue only if no command-line error
+    {
+        // Run test suites
+        cout << "BEGIN tests for " << test_suite_name << "\n" << endl;
+        dtresult = dtcontext.run();
+        cout << "END tests for " << test_suite_name << "\n" << endl;
+    }
+
+    // Wait for user
+    std::cout << "Press ENTER to quit ";
+    userPause();
+
+    // Program return value is return code from doctest
+    return dtresult;
+}
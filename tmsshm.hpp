@@ -0,0 +1,674 @@
+// tmsshm.hpp
+// Matthew Johnson
+// 10/17/2026
+// shared-memory TMSArray in an anonymous memfd (or shm_open) region,
+//  handed to another process as a file descriptor over a Unix socket
+
+#pragma once
+// for single inclusion
+
+#include "tmsserial.hpp"
+// For TMSFileHeader
+// For tms_file_header
+// For tms_check_header
+// For tms_throw_errno
+// For tms_pwritev_all
+
+#include "tmssimd.hpp"
+// For tms_search
+
+#include <cstddef>
+// For std::size_t
+
+#include <cstdint>
+// For std::uint64_t
+
+#include <cstring>
+// For std::memcpy
+// For std::memset
+
+#include <cerrno>
+// For errno
+// For EINTR
+
+#include <string>
+// For std::string
+// For std::to_string
+
+#include <stdexcept>
+// For std::runtime_error
+// For std::length_error
+
+#include <type_traits>
+// For std::is_trivially_copyable
+
+#include <utility>
+// For std::swap
+
+#include <fcntl.h>
+// For fcntl
+// For F_ADD_SEALS
+
+#include <unistd.h>
+// For close
+// For ftruncate
+// For getpid
+
+#include <sys/mman.h>
+// For mmap
+// For munmap
+// For memfd_create
+// For shm_open
+
+#include <sys/socket.h>
+// For sendmsg
+// For recvmsg
+// For SCM_RIGHTS
+
+#include <sys/stat.h>
+// For fstat
+
+
+
+// *********************************************************************
+// Descriptor handoff
+// *********************************************************************
+
+
+// tms_send_fd
+// Basic Guarantee
+// Pre:
+//      sock is a connected AF_UNIX socket
+// Post:
+//      A duplicate of fd is on its way to the peer (SCM_RIGHTS), with a
+//      one-byte payload. Throws std::system_error on failure.
+inline void tms_send_fd(int sock, int fd)
+{
+    char byte = 'F';
+    struct iovec iov;
+    iov.iov_base = &byte;
+    iov.iov_len = 1;
+    alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+    std::memset(control, 0, sizeof control);
+    struct msghdr msg;
+    std::memset(&msg, 0, sizeof msg);
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof control;
+    struct cmsghdr * cm = CMSG_FIRSTHDR(&msg);
+    cm->cmsg_level = SOL_SOCKET;
+    cm->cmsg_type = SCM_RIGHTS;
+    cm->cmsg_len = CMSG_LEN(sizeof(int));
+    std::memcpy(CMSG_DATA(cm), &fd, sizeof(int));
+    while (::sendmsg(sock, &msg, MSG_NOSIGNAL) < 0)
+        if (errno != EINTR)
+            tms_throw_errno("tms_send_fd: sendmsg");
+}
+
+
+// tms_recv_fd
+// Basic Guarantee
+// Pre:
+//      sock is a connected AF_UNIX socket
+// Post:
+//      Returns the descriptor sent by tms_send_fd, owned by the caller
+//      (close-on-exec). Throws std::system_error on failure,
+//      std::runtime_error if the peer closed or sent no descriptor.
+inline int tms_recv_fd(int sock)
+{
+    char byte;
+    struct iovec iov;
+    iov.iov_base = &byte;
+    iov.iov_len = 1;
+    alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+    struct msghdr msg;
+    std::memset(&msg, 0, sizeof msg);
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof control;
+    ssize_t got;
+    while ((got = ::recvmsg(sock, &msg, MSG_CMSG_CLOEXEC)) < 0)
+        if (errno != EINTR)
+            tms_throw_errno("tms_recv_fd: recvmsg");
+    if (got == 0)
+        throw std::runtime_error("tms_recv_fd: peer closed the socket");
+    struct cmsghdr * cm = CMSG_FIRSTHDR(&msg);
+    if (!cm || cm->cmsg_level != SOL_SOCKET || cm->cmsg_type != SCM_RIGHTS
+        || cm->cmsg_len != CMSG_LEN(sizeof(int)))
+        throw std::runtime_error("tms_recv_fd: message carries no descriptor");
+    int fd;
+    std::memcpy(&fd, CMSG_DATA(cm), sizeof(int));
+    return fd;
+}
+
+
+// TMSShareMode
+// How a received region is mapped
+enum TMSShareMode
+{
+    TMS_SHARE_READ,
+    TMS_SHARE_WRITE
+};
+
+
+
+// *********************************************************************
+// class TMSSharedArray - Class definition
+// *********************************************************************
+
+
+// class TMSSharedArray
+// Fixed-size array in an anonymous shared-memory region. The region is
+//  self-describing and holds no pointers: a TMSFileHeader (data_crc is
+//  not maintained and stays 0) whose data_offset locates the elements,
+//  so any process that maps the descriptor, at any address, sees the
+//  same array. Handing an array over costs one sendmsg and one mmap,
+//  whatever its size; the pages are shared, never copied.
+//
+// seal() makes the region immutable for everyone (memfd seals), after
+//  which receivers can read it without guarding against later writes.
+// Requirements on Types:
+//     Valtype is trivially copyable.
+// Invariants:
+//     _map, _mapLen describe the mapping of _fd (nullptr, 0, -1 when
+//      moved from); _data points _size elements into it.
+template <typename Valtype>
+class TMSSharedArray
+{
+
+    static_assert(std::is_trivially_copyable<Valtype>::value,
+                  "TMSSharedArray shares raw bytes");
+
+public:
+
+
+    using value_type = Valtype;
+
+    using size_type  = std::size_t;
+
+    using iterator = value_type*;
+
+    using const_iterator = const value_type*;
+
+
+// ***** TMSSharedArray: ctors, op=, dctor *****
+public:
+
+
+    // Ctor from size
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      A new writable region of thesize zero elements. Throws
+    //      std::system_error if it cannot be created or mapped.
+    explicit TMSSharedArray(size_type thesize)
+        :_fd(-1),
+         _map(nullptr),
+         _mapLen(0),
+         _data(nullptr),
+         _size(0),
+         _writable(true)
+    {
+        const TMSFileHeader h = tms_file_header<value_type>(thesize, 0);
+        if (thesize > (size_type(-1) - h.data_offset) / sizeof(value_type))
+            throw std::length_error("TMSSharedArray: size overflow");
+        _fd = createRegion();
+        try
+        {
+            const size_type len = size_type(h.data_offset)
+                                  + thesize * sizeof(value_type);
+            if (::ftruncate(_fd, off_t(len)) != 0)
+                tms_throw_errno("TMSSharedArray: ftruncate");
+            mapRegion(len, size_type(h.data_offset), thesize);
+            std::memcpy(_map, &h, sizeof h);
+        }
+        catch (...)
+        {
+            release();
+            throw;
+        }
+    }
+
+
+    // Ctor from plain array
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      A new writable region holding a copy of values. The copy goes
+    //      in with one pwritev before mapping, which allocates the pages
+    //      in bulk instead of taking a fault on each.
+    explicit TMSSharedArray(const TMSArray<value_type> & values)
+        :TMSSharedArray(-1, true)
+    {
+        TMSFileHeader h = tms_file_header<value_type>(values.size(), 0);
+        _fd = createRegion();
+        try
+        {
+            const size_type bytes = values.size() * sizeof(value_type);
+            unsigned char pad[TMS_FILE_ALIGN] = {};
+            struct iovec iov[3];
+            iov[0].iov_base = &h;
+            iov[0].iov_len = sizeof h;
+            iov[1].iov_base = pad;
+            iov[1].iov_len = size_type(h.data_offset) - sizeof h;
+            iov[2].iov_base = const_cast<value_type *>(values.begin());
+            iov[2].iov_len = bytes;
+            tms_pwritev_all(_fd, iov, 3, 0, "TMSSharedArray");
+            mapRegion(size_type(h.data_offset) + bytes,
+                      size_type(h.data_offset), values.size());
+        }
+        catch (...)
+        {
+            release();
+            throw;
+        }
+    }
+
+
+    // attach
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      fd refers to a region made by TMSSharedArray (normally from
+    //      tms_recv_fd); the result takes ownership of it
+    // Post:
+    //      Returns the array in that region, mapped read-only or
+    //      read-write. fd is closed if this throws: std::system_error if
+    //      it cannot be mapped (a sealed region refuses TMS_SHARE_WRITE),
+    //      std::runtime_error if the header does not match value_type.
+    static TMSSharedArray attach(int fd, TMSShareMode mode = TMS_SHARE_READ)
+    {
+        TMSSharedArray arr(fd, mode == TMS_SHARE_WRITE);
+        struct stat st;
+        if (::fstat(fd, &st) != 0)
+            tms_throw_errno("TMSSharedArray: fstat");
+        const std::uint64_t len = std::uint64_t(st.st_size);
+        if (len < sizeof(TMSFileHeader))
+            throw std::runtime_error("TMSSharedArray: not a shared array");
+        TMSFileHeader h;
+        tms_pread_all(fd, &h, sizeof h, 0, "TMSSharedArray");
+        if (tms_check_header<value_type>(h, len, "TMSSharedArray"))
+            throw std::runtime_error("TMSSharedArray: foreign byte order");
+        arr.mapRegion(size_type(len), size_type(h.data_offset),
+                      size_type(h.count));
+        return arr;
+    }
+
+
+    // No copying: an array owns its mapping and descriptor
+    TMSSharedArray(const TMSSharedArray &) = delete;
+    TMSSharedArray & operator=(const TMSSharedArray &) = delete;
+
+
+    // Move ctor
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      *this owns other's region; other is empty
+    TMSSharedArray(TMSSharedArray && other) noexcept
+        :TMSSharedArray(-1, false)
+    {
+        swap(other);
+    }
+
+
+    // Move assignment operator
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      *this owns other's region; other gets the old one
+    TMSSharedArray & operator=(TMSSharedArray && other) noexcept
+    {
+        swap(other);
+        return *this;
+    }
+
+
+    // Dctor
+    // No-Throw Guarantee
+    // Pre: None
+    // Post:
+    //      Mapping and descriptor released; the region itself lives on
+    //      while any other process maps it or holds a descriptor
+    ~TMSSharedArray()
+    {
+        release();
+    }
+
+
+// ***** TMSSharedArray: general public operators *****
+public:
+
+
+    // operator[]
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      0 <= index < size()
+    //      writable(), for the non-const form to be written through
+    // Post:
+    //      Returns element index
+    value_type & operator[](size_type index) noexcept
+    {
+        return _data[index];
+    }
+    const value_type & operator[](size_type index) const noexcept
+    {
+        return _data[index];
+    }
+
+
+// ***** TMSSharedArray: general public functions *****
+public:
+
+
+    // size
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns number of elements
+    size_type size() const noexcept
+    {
+        return _size;
+    }
+
+
+    // empty
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns size() == 0
+    bool empty() const noexcept
+    {
+        return _size == 0;
+    }
+
+
+    // writable
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns whether this mapping may be written
+    bool writable() const noexcept
+    {
+        return _writable;
+    }
+
+
+    // fd
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns the region's descriptor (still owned by *this), for
+    //      tms_send_fd
+    int fd() const noexcept
+    {
+        return _fd;
+    }
+
+
+    // begin, end
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns iterator to first element; past the last
+    iterator begin() noexcept
+    {
+        return _data;
+    }
+    iterator end() noexcept
+    {
+        return _data + _size;
+    }
+    const_iterator begin() const noexcept
+    {
+        return _data;
+    }
+    const_iterator end() const noexcept
+    {
+        return _data + _size;
+    }
+
+
+    // seal
+    // Strong Guarantee (Basic if the read-write mapping cannot be made
+    //  again after a refused seal: *this is then read-only and unsealed)
+    // Exception-Neutral
+    // Pre:
+    //      No other process holds a writable mapping of the region
+    // Post:
+    //      *this is remapped read-only and the region sealed against
+    //      writes and resizing, so every later attach sees these exact
+    //      contents. Throws std::system_error if the kernel refuses
+    //      (another writable mapping exists, or sealing is unsupported);
+    //      *this is then mapped read-write again. Either way iterators
+    //      and references are invalidated.
+    void seal()
+    {
+#ifdef F_SEAL_WRITE
+        // Our own shared writable mapping would make the kernel refuse
+        //  F_SEAL_WRITE, so it goes first
+        const bool wasWritable = _writable;
+        if (_writable)
+            remapAs(false);
+        if (::fcntl(_fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW
+                                      | F_SEAL_WRITE | F_SEAL_SEAL) != 0)
+        {
+            const int err = errno;
+            if (wasWritable)
+            {
+                try
+                {
+                    remapAs(true);
+                }
+                catch (...)
+                {}                      // left read-only; report the seal
+            }
+            errno = err;
+            tms_throw_errno("TMSSharedArray: seal");
+        }
+#else
+        errno = ENOTSUP;
+        tms_throw_errno("TMSSharedArray: seal");
+#endif
+    }
+
+
+    // send
+    // Basic Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      sock is a connected AF_UNIX socket
+    // Post:
+    //      The region's descriptor is sent to the peer, which gets the
+    //      array with receive. *this is unchanged and still usable.
+    void send(int sock) const
+    {
+        tms_send_fd(sock, _fd);
+    }
+
+
+    // receive
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      sock is a connected AF_UNIX socket
+    // Post:
+    //      Returns the array whose descriptor the peer sent, mapped as
+    //      mode; see attach
+    static TMSSharedArray receive(int sock, TMSShareMode mode = TMS_SHARE_READ)
+    {
+        return attach(tms_recv_fd(sock), mode);
+    }
+
+
+    // swap
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      *this and other exchange regions
+    void swap(TMSSharedArray & other) noexcept
+    {
+        std::swap(_fd, other._fd);
+        std::swap(_map, other._map);
+        std::swap(_mapLen, other._mapLen);
+        std::swap(_data, other._data);
+        std::swap(_size, other._size);
+        std::swap(_writable, other._writable);
+    }
+
+
+// ***** TMSSharedArray: search functions *****
+public:
+
+
+    // find
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns iterator to first element == item, or end() if none
+    const_iterator find(const value_type & item) const
+    {
+        return begin() + tms_search<false>(begin(), size(), item, TMS_CMP_EQ);
+    }
+
+
+    // count
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns number of elements == item
+    size_type count(const value_type & item) const
+    {
+        return tms_search<true>(begin(), size(), item, TMS_CMP_EQ);
+    }
+
+
+    // contains
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns whether some element == item
+    bool contains(const value_type & item) const
+    {
+        return find(item) != end();
+    }
+
+
+// ***** TMSSharedArray: private helper functions *****
+private:
+
+
+    // Ctor from owned descriptor, not yet mapped
+    TMSSharedArray(int fd, bool writable) noexcept
+        :_fd(fd),
+         _map(nullptr),
+         _mapLen(0),
+         _data(nullptr),
+         _size(0),
+         _writable(writable)
+    {}
+
+
+    // createRegion
+    // New anonymous, sealable shared-memory descriptor
+    static int createRegion()
+    {
+#ifdef MFD_CLOEXEC
+        const int fd = ::memfd_create("tmsarray", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+#else
+        // No memfd: a POSIX shm object, unlinked at once so it is as
+        //  anonymous as a memfd (but cannot be sealed)
+        static unsigned serial = 0;
+        const std::string name = "/tmsarray." + std::to_string(::getpid())
+                                 + "." + std::to_string(++serial);
+        const int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd >= 0)
+            ::shm_unlink(name.c_str());
+#endif
+        if (fd < 0)
+            tms_throw_errno("TMSSharedArray: create region");
+        return fd;
+    }
+
+
+    // mapRegion
+    // Maps len bytes of _fd; elements start at offset. Read-only maps are
+    //  MAP_PRIVATE: a shared one counts as writable (it could be
+    //  mprotected) and would block seal(). Never written, a private map
+    //  still shows the region's own pages, so others' writes appear.
+    void mapRegion(size_type len, size_type offset, size_type count)
+    {
+        void * map = ::mmap(nullptr, len,
+                            _writable ? PROT_READ | PROT_WRITE : PROT_READ,
+                            _writable ? MAP_SHARED : MAP_PRIVATE, _fd, 0);
+        if (map == MAP_FAILED)
+            tms_throw_errno("TMSSharedArray: mmap");
+        _map = map;
+        _mapLen = len;
+        _data = reinterpret_cast<value_type *>(static_cast<char *>(map) + offset);
+        _size = count;
+    }
+
+
+    // remapAs
+    // Replaces the mapping with a read-write (writable) or read-only
+    //  one of the same length; on failure the old mapping stays
+    void remapAs(bool writable)
+    {
+        void * map = ::mmap(nullptr, _mapLen,
+                            writable ? PROT_READ | PROT_WRITE : PROT_READ,
+                            writable ? MAP_SHARED : MAP_PRIVATE, _fd, 0);
+        if (map == MAP_FAILED)
+            tms_throw_errno("TMSSharedArray: mmap");
+        _data = reinterpret_cast<value_type *>(
+            static_cast<char *>(map) + (reinterpret_cast<char *>(_data)
+                                        - static_cast<char *>(_map)));
+        ::munmap(_map, _mapLen);
+        _map = map;
+        _writable = writable;
+    }
+
+
+    // release
+    // Unmaps and closes
+    void release() noexcept
+    {
+        if (_map)
+            ::munmap(_map, _mapLen);
+        if (_fd >= 0)
+            ::close(_fd);
+        _map = nullptr;
+        _mapLen = 0;
+        _data = nullptr;
+        _size = 0;
+        _fd = -1;
+    }
+
+
+// ***** TMSSharedArray: data members *****
+private:
+
+    int          _fd;
+    void *       _map;
+    size_type    _mapLen;
+    value_type * _data;
+    size_type    _size;
+    bool         _writable;
+
+}; // end of class
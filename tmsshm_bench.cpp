@@ -0,0 +1,182 @@
+// tmsshm_bench.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Benchmark: handing a uint64_t array to another process. Latency from
+//  the sender starting until the receiver acknowledges having the array
+//  usable, for a pipe (sender writes, receiver reads into a TMSArray),
+//  and TMSSharedArray descriptor handoff: already shared, copied into
+//  a new region first, and with the receiver scanning every element.
+// Usage: tmsshm_bench [max_bytes=268435456]   (sizes 1 MB, x16, to max)
+// Requires tmsshm.hpp, tmsserial.hpp, tmscrc32.hpp, tmssimd.hpp,
+//  tmsarray.hpp, tmsbench.hpp
+
+#include "tmsshm.hpp"
+#include "tmsbench.hpp"
+
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::uint64_t;
+#include <iostream>
+using std::cout;
+#include <string>
+using std::string;
+#include <fcntl.h>           // For F_SETPIPE_SZ
+#include <unistd.h>          // For fork, pipe, read, write
+#include <sys/socket.h>      // For socketpair
+#include <sys/wait.h>        // For waitpid
+
+
+// One request from sender to receiver
+struct Request
+{
+    char     op;                // 'P' pipe, 'S' shared, 'T' shared+scan, 'Q'
+    uint64_t count;             // elements
+};
+
+
+// readAll, writeAll
+// Full transfers over a pipe
+void readAll(int fd, void * buf, size_t n)
+{
+    char * p = static_cast<char *>(buf);
+    while (n > 0)
+    {
+        const ssize_t got = ::read(fd, p, n);
+        if (got <= 0)
+            _exit(2);
+        p += got;
+        n -= size_t(got);
+    }
+}
+void writeAll(int fd, const void * buf, size_t n)
+{
+    const char * p = static_cast<const char *>(buf);
+    while (n > 0)
+    {
+        const ssize_t got = ::write(fd, p, n);
+        if (got <= 0)
+            _exit(3);
+        p += got;
+        n -= size_t(got);
+    }
+}
+
+
+// serve
+// Receiver loop, in the child process
+void serve(int sock, int pipeIn)
+{
+    for (;;)
+    {
+        Request req;
+        if (::recv(sock, &req, sizeof req, 0) != ssize_t(sizeof req)
+            || req.op == 'Q')
+            return;
+        uint64_t check = 0;
+        if (req.op == 'P')
+        {
+            TMSArray<uint64_t> arr(req.count);
+            readAll(pipeIn, arr.begin(), req.count * sizeof(uint64_t));
+            check = arr[req.count - 1];
+        }
+        else
+        {
+            TMSSharedArray<uint64_t> arr = TMSSharedArray<uint64_t>::receive(sock);
+            if (req.op == 'T')
+                for (uint64_t v : arr)
+                    check += v;
+            else
+                check = arr[arr.size() - 1];
+        }
+        tms_sink(check);
+        const char ack = 'A';
+        ::send(sock, &ack, 1, 0);
+    }
+}
+
+
+int main(int argc, char * argv[])
+{
+    const size_t maxBytes = tms_arg(argc, argv, 1, size_t(1) << 28);
+    int sp[2];
+    int pp[2];
+    if (::socketpair(AF_UNIX, SOCK_SEQPACKET, 0, sp) != 0 || ::pipe(pp) != 0)
+        return 1;
+    // Give the pipe its best case: 1 MB of buffer instead of 64 KB
+    ::fcntl(pp[1], F_SETPIPE_SZ, 1 << 20);
+
+    const pid_t child = fork();
+    if (child == 0)
+    {
+        ::close(sp[0]);
+        ::close(pp[1]);
+        serve(sp[1], pp[0]);
+        _exit(0);
+    }
+    ::close(sp[1]);
+    ::close(pp[0]);
+    const int sock = sp[0];
+
+    auto await = [&]
+    {
+        char ack;
+        if (::recv(sock, &ack, 1, 0) != 1)
+            _exit(4);
+    };
+
+    for (size_t bytes = size_t(1) << 20; bytes <= maxBytes; bytes *= 16)
+    {
+        const uint64_t n = bytes / sizeof(uint64_t);
+        cout << "\n== " << (bytes >> 20) << " MB ==\n";
+        TMSArray<uint64_t> plain(n);
+        TMSSharedArray<uint64_t> shared(n);
+        for (uint64_t i = 0; i < n; ++i)
+            plain[i] = shared[i] = i * 0x9E3779B97F4A7C15ull;
+        const int reps = bytes >= (size_t(1) << 28) ? 3 : 5;
+
+        double secs = tms_time_best(reps, [&]
+        {
+            const Request req = { 'P', n };
+            ::send(sock, &req, sizeof req, 0);
+            writeAll(pp[1], plain.begin(), bytes);
+            await();
+        });
+        tms_report("pipe serialize", secs, bytes);
+
+        secs = tms_time_best(reps, [&]
+        {
+            const Request req = { 'S', n };
+            ::send(sock, &req, sizeof req, 0);
+            shared.send(sock);
+            await();
+        });
+        tms_report("shm handoff", secs, bytes);
+
+        secs = tms_time_best(reps, [&]
+        {
+            TMSSharedArray<uint64_t> fresh(plain);
+            const Request req = { 'S', n };
+            ::send(sock, &req, sizeof req, 0);
+            fresh.send(sock);
+            await();
+        });
+        tms_report("shm copy-in + handoff", secs, bytes);
+
+        secs = tms_time_best(reps, [&]
+        {
+            const Request req = { 'T', n };
+            ::send(sock, &req, sizeof req, 0);
+            shared.send(sock);
+            await();
+        });
+        tms_report("shm handoff + receiver scan", secs, bytes);
+    }
+
+    const Request quit = { 'Q', 0 };
+    ::send(sock, &quit, sizeof quit, 0);
+    int status = 0;
+    ::waitpid(child, &status, 0);
+    return 0;
+}
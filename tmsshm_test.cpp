@@ -0,0 +1,295 @@
+// tmsshm_test.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Test program for class template TMSSharedArray and descriptor handoff
+// Uses the "doctest" unit-testing framework, version 2
+// Requires doctest.h, tmsshm.hpp, tmsserial.hpp, tmscrc32.hpp,
+//  tmssimd.hpp, tmsarray.hpp
+
+// Includes for code to be tested
+#include "tmsshm.hpp"        // For class template TMSSharedArray
+#include "tmsshm.hpp"        // Double-inclusion check, for testing only
+
+// Includes for the "doctest" unit-testing framework
+#define DOCTEST_CONFIG_IMPLEMENT
+                             // We write our own main
+#define DOCTEST_CONFIG_SUPER_FAST_ASSERTS
+                             // Reduce compile time
+#include "doctest.h"         // For doctest
+
+// Includes for all test programs
+#include <iostream>
+using std::cout;
+using std::endl;
+using std::cin;
+#include <string>
+using std::string;
+
+// Additional includes for this test program
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::int64_t;
+using std::uint64_t;
+#include <stdexcept>
+using std::runtime_error;
+#include <system_error>
+using std::system_error;
+#include <utility>
+using std::move;
+#include <unistd.h>          // For fork, _exit, pipe, read, write
+#include <sys/socket.h>      // For socketpair
+#include <sys/wait.h>        // For waitpid
+#include <fcntl.h>           // For fcntl, F_GET_SEALS
+
+// Printable name for this test suite
+const string test_suite_name =
+    "class template TMSSharedArray";
+
+
+// *********************************************************************
+// Helper Functions for This Test Program
+// *********************************************************************
+
+
+// SocketPair
+// Connected AF_UNIX stream sockets, closed on destruction
+struct SocketPair
+{
+    int fds[2];
+
+    SocketPair()
+    {
+        REQUIRE( ::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0 );
+    }
+
+    ~SocketPair()
+    {
+        ::close(fds[0]);
+        ::close(fds[1]);
+    }
+};
+
+
+// runChild
+// Runs func in a forked child; returns its exit status (func's result)
+template <typename Func>
+int runChild(Func && func)
+{
+    const pid_t pid = fork();
+    REQUIRE( pid >= 0 );
+    if (pid == 0)
+    {
+        int result = 99;
+        try
+        {
+            result = func();
+        }
+        catch (...)
+        {
+            result = 98;
+        }
+        _exit(result);
+    }
+    int status = 0;
+    REQUIRE( waitpid(pid, &status, 0) == pid );
+    REQUIRE( WIFEXITED(status) );
+    return WEXITSTATUS(status);
+}
+
+
+// *********************************************************************
+// Test Cases
+// *********************************************************************
+
+
+TEST_CASE( "Create and access" )
+{
+    TMSSharedArray<int64_t> ts(1000);
+    REQUIRE( ts.size() == 1000 );
+    REQUIRE( !ts.empty() );
+    REQUIRE( ts.writable() );
+    REQUIRE( ts.fd() >= 0 );
+    for (size_t i = 0; i < ts.size(); ++i)
+        REQUIRE( ts[i] == 0 );
+    for (size_t i = 0; i < ts.size(); ++i)
+        ts[i] = int64_t(i) * 3;
+    REQUIRE( ts.end() - ts.begin() == 1000 );
+    REQUIRE( reinterpret_cast<uintptr_t>(ts.begin()) % TMS_FILE_ALIGN == 0 );
+    REQUIRE( ts.find(30) - ts.begin() == 10 );
+    REQUIRE( ts.count(3) == 1 );
+    REQUIRE( !ts.contains(1) );
+
+    TMSArray<int64_t> ta(5);
+    for (size_t i = 0; i < ta.size(); ++i)
+        ta[i] = -int64_t(i);
+    TMSSharedArray<int64_t> tc(ta);
+    REQUIRE( tc.size() == 5 );
+    REQUIRE( tc[4] == -4 );
+
+    TMSSharedArray<int64_t> te(0);
+    REQUIRE( te.empty() );
+    REQUIRE( te.begin() == te.end() );
+}
+
+
+TEST_CASE( "Handoff within a process" )
+{
+    SocketPair sp;
+    TMSSharedArray<double> ts(300);
+    for (size_t i = 0; i < ts.size(); ++i)
+        ts[i] = double(i) / 4;
+    ts.send(sp.fds[0]);
+    TMSSharedArray<double> tr = TMSSharedArray<double>::receive(sp.fds[1]);
+    REQUIRE( !tr.writable() );
+    REQUIRE( tr.size() == 300 );
+    REQUIRE( tr.begin() != ts.begin() );
+    REQUIRE( tr[299] == 74.75 );
+    // Same pages: writes through one mapping show in the other
+    ts[0] = 42.0;
+    REQUIRE( tr[0] == 42.0 );
+}
+
+
+TEST_CASE( "Handoff to another process" )
+{
+    SocketPair sp;
+    TMSSharedArray<uint64_t> ts(1 << 20);
+    for (size_t i = 0; i < ts.size(); ++i)
+        ts[i] = i;
+    ts.send(sp.fds[0]);
+
+    const int status = runChild([&]
+    {
+        TMSSharedArray<uint64_t> tr
+            = TMSSharedArray<uint64_t>::receive(sp.fds[1], TMS_SHARE_WRITE);
+        uint64_t sum = 0;
+        for (uint64_t v : tr)
+            sum += v;
+        if (sum != (uint64_t(1) << 20) * ((uint64_t(1) << 20) - 1) / 2)
+            return 1;
+        tr[7] = 777;            // seen by the parent
+        return 0;
+    });
+    REQUIRE( status == 0 );
+    REQUIRE( ts[7] == 777 );
+    // The parent's array outlives the child's mapping
+    REQUIRE( ts[(1 << 20) - 1] == (1 << 20) - 1 );
+}
+
+
+TEST_CASE( "Sealed regions are immutable" )
+{
+    SocketPair sp;
+    TMSSharedArray<int> ts(100);
+    ts[3] = 3;
+    ts.seal();
+    REQUIRE( !ts.writable() );
+    REQUIRE( ts[3] == 3 );
+
+    ts.send(sp.fds[0]);
+    REQUIRE_THROWS_AS( TMSSharedArray<int>::receive(sp.fds[1], TMS_SHARE_WRITE),
+                       system_error );
+    ts.send(sp.fds[0]);
+    TMSSharedArray<int> tr = TMSSharedArray<int>::receive(sp.fds[1]);
+    REQUIRE( tr[3] == 3 );
+    REQUIRE( ::ftruncate(tr.fd(), 0) != 0 );
+}
+
+
+TEST_CASE( "A refused seal leaves the array writable" )
+{
+    SocketPair sp;
+    TMSSharedArray<int> ts(100);
+    ts[3] = 3;
+    ts.send(sp.fds[0]);
+    TMSSharedArray<int> peer
+        = TMSSharedArray<int>::receive(sp.fds[1], TMS_SHARE_WRITE);
+    REQUIRE_THROWS_AS( ts.seal(), system_error );
+    REQUIRE( ts.writable() );
+    REQUIRE( ts[3] == 3 );
+    ts[4] = 4;
+    REQUIRE( peer[4] == 4 );
+    REQUIRE( (::fcntl(ts.fd(), F_GET_SEALS) & F_SEAL_WRITE) == 0 );
+}
+
+
+TEST_CASE( "Attach rejects other descriptors" )
+{
+    SocketPair sp;
+    TMSSharedArray<int> ts(10);
+    ts.send(sp.fds[0]);
+    REQUIRE_THROWS_AS( TMSSharedArray<float>::receive(sp.fds[1]), runtime_error );
+
+    int p[2];
+    REQUIRE( ::pipe(p) == 0 );
+    ::close(p[1]);
+    REQUIRE_THROWS( TMSSharedArray<int>::attach(p[0]) );
+
+    const char byte = 'x';
+    REQUIRE( ::write(sp.fds[0], &byte, 1) == 1 );
+    REQUIRE_THROWS_AS( tms_recv_fd(sp.fds[1]), runtime_error );
+    ::shutdown(sp.fds[0], SHUT_WR);
+    REQUIRE_THROWS_AS( tms_recv_fd(sp.fds[1]), runtime_error );
+}
+
+
+TEST_CASE( "Move" )
+{
+    TMSSharedArray<int> ts(10);
+    ts[9] = 9;
+    const int fd = ts.fd();
+    TMSSharedArray<int> tm(move(ts));
+    REQUIRE( tm.fd() == fd );
+    REQUIRE( tm[9] == 9 );
+    REQUIRE( ts.empty() );
+    REQUIRE( ts.fd() == -1 );
+    ts = move(tm);
+    REQUIRE( ts[9] == 9 );
+}
+
+
+// *********************************************************************
+// Main Program
+// *********************************************************************
+
+
+// userPause
+// Wait for user to press ENTER: read all chars through first newline.
+void userPause()
+{
+    std::cout.flush();
+    while (std::cin.get() != '\n') ;
+}
+
+
+// Main program
+// Run all tests. Prompt for ENTER before exiting.
+int main(int argc,
+         char *argv[])
+{
+    doctest::Context dtcontext;
+                             // Primary doctest object
+    int dtresult;            // doctest return code; for return by main
+
+    // Handle command line
+    dtcontext.applyCommandLine(argc, argv);
+    dtresult = 0;            // doctest flags no command-line errors
+                             //  (strange but true)
+
+    if (!dtresult)           // Continue only if no command-line error
+    {
+        // Run test suites
+        cout << "BEGIN tests for " << test_suite_name << "\n" << endl;
+        dtresult = dtcontext.run();
+        cout << "END tests for " << test_suite_name << "\n" << endl;
+    }
+
+    // Wait for user
+    std::cout << "Press ENTER to quit ";
+    userPause();
+
+    // Program return value is return code from doctest
+    return dtresult;
+}
@@ -0,0 +1,541 @@
+// tmssimd.hpp
+// Matthew Johnson
+// 10/17/2026
+// runtime ISA detection and SIMD search kernels (find/count by ==, <, >)
+//  used by TMSArray's search members
+
+#pragma once
+// for single inclusion
+
+#include <cstddef>
+// For std::size_t
+
+#include <cstdint>
+// For std::int32_t
+// For std::int64_t
+
+#include <cstring>
+// For std::memcpy
+
+#include <type_traits>
+// For std::is_integral
+// For std::is_signed
+// For std::is_same
+// For std::is_void
+// For std::conditional
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TMS_SIMD_X86 1
+#include <immintrin.h>
+// For SSE2/AVX2/AVX-512 intrinsics
+
+// TMS_AVX512_DIAG_PUSH / TMS_AVX512_DIAG_POP
+// Bracket kernels that inline AVX-512 intrinsics: GCC 12 reports the
+//  _mm512_undefined_* placeholders inside its own headers as
+//  maybe-uninitialized wherever they get inlined
+#define TMS_AVX512_DIAG_PUSH                                        \
+    _Pragma("GCC diagnostic push")                                  \
+    _Pragma("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+#define TMS_AVX512_DIAG_POP _Pragma("GCC diagnostic pop")
+#endif
+
+
+
+// *********************************************************************
+// ISA detection
+// *********************************************************************
+
+
+// Instruction-set levels, ordered: a level implies all below it.
+//  TMS_ISA_AVX512 means the F, BW and DQ subsets (Skylake-SP and later).
+enum TMSIsa
+{
+    TMS_ISA_SCALAR = 0,
+    TMS_ISA_SSE2   = 1,
+    TMS_ISA_AVX2   = 2,
+    TMS_ISA_AVX512 = 3
+};
+
+
+// tms_detect_isa
+// No-Throw Guarantee
+// Pre: None
+// Post:
+//      Returns best level this CPU (and OS) supports
+inline TMSIsa tms_detect_isa() noexcept
+{
+#ifdef TMS_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")
+        && __builtin_cpu_supports("avx512dq"))
+        return TMS_ISA_AVX512;
+    if (__builtin_cpu_supports("avx2"))
+        return TMS_ISA_AVX2;
+    if (__builtin_cpu_supports("sse2"))
+        return TMS_ISA_SSE2;
+#endif
+    return TMS_ISA_SCALAR;
+}
+
+
+// tms_isa_limit
+// No-Throw Guarantee
+// Pre: None
+// Post:
+//      Returns reference to the highest level kernels may use; starts as
+//      tms_detect_isa(). Lower it to force a slower path (tests, benches)
+inline TMSIsa & tms_isa_limit() noexcept
+{
+    static TMSIsa limit = tms_detect_isa();
+    return limit;
+}
+
+
+// tms_isa_name
+// No-Throw Guarantee
+// Pre: None
+// Post:
+//      Returns printable name of level
+inline const char * tms_isa_name(TMSIsa level) noexcept
+{
+    switch (level)
+    {
+    case TMS_ISA_AVX512: return "avx512";
+    case TMS_ISA_AVX2:   return "avx2";
+    case TMS_ISA_SSE2:   return "sse2";
+    default:             return "scalar";
+    }
+}
+
+
+
+// *********************************************************************
+// Search kernels
+// *********************************************************************
+
+
+// Comparison applied as (element OP key)
+enum TMSCmp
+{
+    TMS_CMP_EQ,
+    TMS_CMP_LT,
+    TMS_CMP_GT
+};
+
+
+// tms_scalar_match
+// Reference semantics for every kernel below
+template <typename T>
+inline bool tms_scalar_match(const T & elem, const T & key, TMSCmp op)
+{
+    switch (op)
+    {
+    case TMS_CMP_LT: return elem < key;
+    case TMS_CMP_GT: return key < elem;
+    default:         return elem == key;
+    }
+}
+
+
+template <typename T>
+std::size_t tms_scalar_find(const T * data, std::size_t n, const T & key,
+                            TMSCmp op)
+{
+    for (std::size_t i = 0; i < n; ++i)
+        if (tms_scalar_match(data[i], key, op))
+            return i;
+    return n;
+}
+
+
+template <typename T>
+std::size_t tms_scalar_count(const T * data, std::size_t n, const T & key,
+                             TMSCmp op)
+{
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < n; ++i)
+        total += tms_scalar_match(data[i], key, op) ? 1 : 0;
+    return total;
+}
+
+
+#ifdef TMS_SIMD_X86
+
+// Vector policies: for each (ISA, element type), Lanes, set1, load and
+//  a compare that returns one bit per lane. Kept tiny so the kernels
+//  below can be stamped out once per ISA with the matching target.
+
+#define TMS_SSE2   __attribute__((target("sse2"), always_inline))
+#define TMS_AVX2   __attribute__((target("avx2"), always_inline))
+#define TMS_AVX512 __attribute__((target("avx512f,avx512bw"), always_inline))
+
+struct TMSSse2I32
+{
+    using T = std::int32_t; using V = __m128i;
+    static constexpr std::size_t Lanes = 4;
+    TMS_SSE2 static inline V set1(T k) { return _mm_set1_epi32(k); }
+    TMS_SSE2 static inline V load(const T * p)
+    { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+    template <TMSCmp op>
+    TMS_SSE2 static inline unsigned cmp(V a, V k)
+    {
+        V r = op == TMS_CMP_EQ ? _mm_cmpeq_epi32(a, k)
+            : op == TMS_CMP_LT ? _mm_cmplt_epi32(a, k) : _mm_cmpgt_epi32(a, k);
+        return unsigned(_mm_movemask_ps(_mm_castsi128_ps(r)));
+    }
+};
+
+struct TMSSse2F32
+{
+    using T = float; using V = __m128;
+    static constexpr std::size_t Lanes = 4;
+    TMS_SSE2 static inline V set1(T k) { return _mm_set1_ps(k); }
+    TMS_SSE2 static inline V load(const T * p) { return _mm_loadu_ps(p); }
+    template <TMSCmp op>
+    TMS_SSE2 static inline unsigned cmp(V a, V k)
+    {
+        V r = op == TMS_CMP_EQ ? _mm_cmpeq_ps(a, k)
+            : op == TMS_CMP_LT ? _mm_cmplt_ps(a, k) : _mm_cmpgt_ps(a, k);
+        return unsigned(_mm_movemask_ps(r));
+    }
+};
+
+struct TMSSse2F64
+{
+    using T = double; using V = __m128d;
+    static constexpr std::size_t Lanes = 2;
+    TMS_SSE2 static inline V set1(T k) { return _mm_set1_pd(k); }
+    TMS_SSE2 static inline V load(const T * p) { return _mm_loadu_pd(p); }
+    template <TMSCmp op>
+    TMS_SSE2 static inline unsigned cmp(V a, V k)
+    {
+        V r = op == TMS_CMP_EQ ? _mm_cmpeq_pd(a, k)
+            : op == TMS_CMP_LT ? _mm_cmplt_pd(a, k) : _mm_cmpgt_pd(a, k);
+        return unsigned(_mm_movemask_pd(r));
+    }
+};
+
+struct TMSAvx2I32
+{
+    using T = std::int32_t; using V = __m256i;
+    static constexpr std::size_t Lanes = 8;
+    TMS_AVX2 static inline V set1(T k) { return _mm256_set1_epi32(k); }
+    TMS_AVX2 static inline V load(const T * p)
+    { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+    template <TMSCmp op>
+    TMS_AVX2 static inline unsigned cmp(V a, V k)
+    {
+        V r = op == TMS_CMP_EQ ? _mm256_cmpeq_epi32(a, k)
+            : op == TMS_CMP_LT ? _mm256_cmpgt_epi32(k, a)
+                               : _mm256_cmpgt_epi32(a, k);
+        return unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(r)));
+    }
+};
+
+struct TMSAvx2I64
+{
+    using T = std::int64_t; using V = __m256i;
+    static constexpr std::size_t Lanes = 4;
+    TMS_AVX2 static inline V set1(T k) { return _mm256_set1_epi64x(k); }
+    TMS_AVX2 static inline V load(const T * p)
+    { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+    template <TMSCmp op>
+    TMS_AVX2 static inline unsigned cmp(V a, V k)
+    {
+        V r = op == TMS_CMP_EQ ? _mm256_cmpeq_epi64(a, k)
+            : op == TMS_CMP_LT ? _mm256_cmpgt_epi64(k, a)
+                               : _mm256_cmpgt_epi64(a, k);
+        return unsigned(_mm256_movemask_pd(_mm256_castsi256_pd(r)));
+    }
+};
+
+struct TMSAvx2F32
+{
+    using T = float; using V = __m256;
+    static constexpr std::size_t Lanes = 8;
+    TMS_AVX2 static inline V set1(T k) { return _mm256_set1_ps(k); }
+    TMS_AVX2 static inline V load(const T * p) { return _mm256_loadu_ps(p); }
+    template <TMSCmp op>
+    TMS_AVX2 static inline unsigned cmp(V a, V k)
+    {
+        V r = op == TMS_CMP_EQ ? _mm256_cmp_ps(a, k, _CMP_EQ_OQ)
+            : op == TMS_CMP_LT ? _mm256_cmp_ps(a, k, _CMP_LT_OQ)
+                               : _mm256_cmp_ps(a, k, _CMP_GT_OQ);
+        return unsigned(_mm256_movemask_ps(r));
+    }
+};
+
+struct TMSAvx2F64
+{
+    using T = double; using V = __m256d;
+    static constexpr std::size_t Lanes = 4;
+    TMS_AVX2 static inline V set1(T k) { return _mm256_set1_pd(k); }
+    TMS_AVX2 static inline V load(const T * p) { return _mm256_loadu_pd(p); }
+    template <TMSCmp op>
+    TMS_AVX2 static inline unsigned cmp(V a, V k)
+    {
+        V r = op == TMS_CMP_EQ ? _mm256_cmp_pd(a, k, _CMP_EQ_OQ)
+            : op == TMS_CMP_LT ? _mm256_cmp_pd(a, k, _CMP_LT_OQ)
+                               : _mm256_cmp_pd(a, k, _CMP_GT_OQ);
+        return unsigned(_mm256_movemask_pd(r));
+    }
+};
+
+struct TMSAvx512I32
+{
+    using T = std::int32_t; using V = __m512i;
+    static constexpr std::size_t Lanes = 16;
+    TMS_AVX512 static inline V set1(T k) { return _mm512_set1_epi32(k); }
+    TMS_AVX512 static inline V load(const T * p)
+    { return _mm512_loadu_si512(p); }
+    template <TMSCmp op>
+    TMS_AVX512 static inline unsigned cmp(V a, V k)
+    {
+        return op == TMS_CMP_EQ ? _mm512_cmp_epi32_mask(a, k, _MM_CMPINT_EQ)
+             : op == TMS_CMP_LT ? _mm512_cmp_epi32_mask(a, k, _MM_CMPINT_LT)
+                                : _mm512_cmp_epi32_mask(a, k, _MM_CMPINT_NLE);
+    }
+};
+
+struct TMSAvx512I64
+{
+    using T = std::int64_t; using V = __m512i;
+    static constexpr std::size_t Lanes = 8;
+    TMS_AVX512 static inline V set1(T k) { return _mm512_set1_epi64(k); }
+    TMS_AVX512 static inline V load(const T * p)
+    { return _mm512_loadu_si512(p); }
+    template <TMSCmp op>
+    TMS_AVX512 static inline unsigned cmp(V a, V k)
+    {
+        return op == TMS_CMP_EQ ? _mm512_cmp_epi64_mask(a, k, _MM_CMPINT_EQ)
+             : op == TMS_CMP_LT ? _mm512_cmp_epi64_mask(a, k, _MM_CMPINT_LT)
+                                : _mm512_cmp_epi64_mask(a, k, _MM_CMPINT_NLE);
+    }
+};
+
+struct TMSAvx512F32
+{
+    using T = float; using V = __m512;
+    static constexpr std::size_t Lanes = 16;
+    TMS_AVX512 static inline V set1(T k) { return _mm512_set1_ps(k); }
+    TMS_AVX512 static inline V load(const T * p) { return _mm512_loadu_ps(p); }
+    template <TMSCmp op>
+    TMS_AVX512 static inline unsigned cmp(V a, V k)
+    {
+        return op == TMS_CMP_EQ ? _mm512_cmp_ps_mask(a, k, _CMP_EQ_OQ)
+             : op == TMS_CMP_LT ? _mm512_cmp_ps_mask(a, k, _CMP_LT_OQ)
+                                : _mm512_cmp_ps_mask(a, k, _CMP_GT_OQ);
+    }
+};
+
+struct TMSAvx512F64
+{
+    using T = double; using V = __m512d;
+    static constexpr std::size_t Lanes = 8;
+    TMS_AVX512 static inline V set1(T k) { return _mm512_set1_pd(k); }
+    TMS_AVX512 static inline V load(const T * p) { return _mm512_loadu_pd(p); }
+    template <TMSCmp op>
+    TMS_AVX512 static inline unsigned cmp(V a, V k)
+    {
+        return op == TMS_CMP_EQ ? _mm512_cmp_pd_mask(a, k, _CMP_EQ_OQ)
+             : op == TMS_CMP_LT ? _mm512_cmp_pd_mask(a, k, _CMP_LT_OQ)
+                                : _mm512_cmp_pd_mask(a, k, _CMP_GT_OQ);
+    }
+};
+
+
+// TMS_SIMD_SEARCH_KERNELS
+// Defines tms_find_<isa>/tms_count_<isa> over a policy P and comparison
+//  op, compiled for that ISA. find checks four vectors per step and only
+//  locates the lane once one of them hits; count sums lane masks.
+#define TMS_SIMD_SEARCH_KERNELS(isa, attr)                                   \
+template <typename P, TMSCmp op>                                             \
+attr std::size_t tms_find_##isa(const typename P::T * data, std::size_t n,   \
+                                typename P::T key)                           \
+{                                                                            \
+    const auto k = P::set1(key);                                             \
+    const std::size_t L = P::Lanes;                                          \
+    std::size_t i = 0;                                                       \
+    for (; i + 4 * L <= n; i += 4 * L)                                       \
+    {                                                                        \
+        unsigned m0 = P::template cmp<op>(P::load(data + i), k);             \
+        unsigned m1 = P::template cmp<op>(P::load(data + i + L), k);         \
+        unsigned m2 = P::template cmp<op>(P::load(data + i + 2 * L), k);     \
+        unsigned m3 = P::template cmp<op>(P::load(data + i + 3 * L), k);     \
+        if (m0 | m1 | m2 | m3)                                               \
+        {                                                                    \
+            if (m0) return i + std::size_t(__builtin_ctz(m0));               \
+            if (m1) return i + L + std::size_t(__builtin_ctz(m1));           \
+            if (m2) return i + 2 * L + std::size_t(__builtin_ctz(m2));       \
+            return i + 3 * L + std::size_t(__builtin_ctz(m3));               \
+        }                                                                    \
+    }                                                                        \
+    for (; i + L <= n; i += L)                                               \
+    {                                                                        \
+        unsigned m = P::template cmp<op>(P::load(data + i), k);              \
+        if (m)                                                               \
+            return i + std::size_t(__builtin_ctz(m));                        \
+    }                                                                        \
+    return i + tms_scalar_find(data + i, n - i, key, op);                    \
+}                                                                            \
+                                                                             \
+template <typename P, TMSCmp op>                                             \
+attr std::size_t tms_count_##isa(const typename P::T * data, std::size_t n,  \
+                                 typename P::T key)                          \
+{                                                                            \
+    const auto k = P::set1(key);                                             \
+    const std::size_t L = P::Lanes;                                          \
+    std::size_t c0 = 0, c1 = 0, i = 0;                                       \
+    for (; i + 2 * L <= n; i += 2 * L)                                       \
+    {                                                                        \
+        c0 += std::size_t(__builtin_popcount(                                \
+                  P::template cmp<op>(P::load(data + i), k)));               \
+        c1 += std::size_t(__builtin_popcount(                                \
+                  P::template cmp<op>(P::load(data + i + L), k)));           \
+    }                                                                        \
+    return c0 + c1 + tms_scalar_count(data + i, n - i, key, op);             \
+}
+
+TMS_SIMD_SEARCH_KERNELS(sse2, __attribute__((target("sse2"))))
+TMS_SIMD_SEARCH_KERNELS(avx2, __attribute__((target("avx2"))))
+TMS_SIMD_SEARCH_KERNELS(avx512, __attribute__((target("avx512f,avx512bw"))))
+
+#undef TMS_SIMD_SEARCH_KERNELS
+
+
+// tms_simd_run
+// Runs the find (Count false) or count (Count true) kernel for op using
+//  the best of policies S (SSE2), A (AVX2), X (AVX-512) allowed by
+//  tms_isa_limit(); void means no policy at that level. Returns false
+//  when no kernel applies.
+template <typename S, typename A, typename X, bool Count, TMSCmp op,
+          typename T>
+bool tms_simd_run(const T * data, std::size_t n, T key, std::size_t & result)
+{
+    const TMSIsa level = tms_isa_limit();
+    if constexpr (!std::is_void<X>::value)
+        if (level >= TMS_ISA_AVX512)
+        {
+            result = Count ? tms_count_avx512<X, op>(data, n, key)
+                           : tms_find_avx512<X, op>(data, n, key);
+            return true;
+        }
+    if constexpr (!std::is_void<A>::value)
+        if (level >= TMS_ISA_AVX2)
+        {
+            result = Count ? tms_count_avx2<A, op>(data, n, key)
+                           : tms_find_avx2<A, op>(data, n, key);
+            return true;
+        }
+    if constexpr (!std::is_void<S>::value)
+        if (level >= TMS_ISA_SSE2)
+        {
+            result = Count ? tms_count_sse2<S, op>(data, n, key)
+                           : tms_find_sse2<S, op>(data, n, key);
+            return true;
+        }
+    return false;
+}
+
+
+// tms_simd_ops
+// Turns the runtime op into a template argument
+template <typename S, typename A, typename X, bool Count, typename T>
+bool tms_simd_ops(const T * data, std::size_t n, T key, TMSCmp op,
+                  std::size_t & result)
+{
+    switch (op)
+    {
+    case TMS_CMP_LT:
+        return tms_simd_run<S, A, X, Count, TMS_CMP_LT>(data, n, key, result);
+    case TMS_CMP_GT:
+        return tms_simd_run<S, A, X, Count, TMS_CMP_GT>(data, n, key, result);
+    default:
+        return tms_simd_run<S, A, X, Count, TMS_CMP_EQ>(data, n, key, result);
+    }
+}
+
+// tms_simd_search
+// Selects the policies for T (int32, int64, float, double)
+template <bool Count, typename T>
+bool tms_simd_search(const T * data, std::size_t n, T key, TMSCmp op,
+                     std::size_t & result)
+{
+    if constexpr (std::is_same<T, std::int32_t>::value)
+        return tms_simd_ops<TMSSse2I32, TMSAvx2I32, TMSAvx512I32, Count>(
+            data, n, key, op, result);
+    else if constexpr (std::is_same<T, std::int64_t>::value)
+        // SSE2 has no 64-bit compare; AVX2 and up only
+        return tms_simd_ops<void, TMSAvx2I64, TMSAvx512I64, Count>(
+            data, n, key, op, result);
+    else if constexpr (std::is_same<T, float>::value)
+        return tms_simd_ops<TMSSse2F32, TMSAvx2F32, TMSAvx512F32, Count>(
+            data, n, key, op, result);
+    else if constexpr (std::is_same<T, double>::value)
+        return tms_simd_ops<TMSSse2F64, TMSAvx2F64, TMSAvx512F64, Count>(
+            data, n, key, op, result);
+    else
+        return false;
+}
+
+#undef TMS_SSE2
+#undef TMS_AVX2
+#undef TMS_AVX512
+
+#endif // TMS_SIMD_X86
+
+
+// tms_simd_dispatch
+// Routes T to a kernel by bit pattern: 32/64-bit integers (any
+//  signedness for ==, signed only for < and >), float, double. Returns
+//  false if T has no kernel at this ISA level.
+template <bool Count, typename T>
+bool tms_simd_dispatch(const T * data, std::size_t n, const T & key,
+                       TMSCmp op, std::size_t & result)
+{
+#ifdef TMS_SIMD_X86
+    if constexpr (std::is_same<T, float>::value
+                  || std::is_same<T, double>::value)
+        return tms_simd_search<Count>(data, n, key, op, result);
+    else if constexpr (std::is_integral<T>::value
+                       && !std::is_same<T, bool>::value
+                       && (sizeof(T) == 4 || sizeof(T) == 8))
+    {
+        if (op != TMS_CMP_EQ && !std::is_signed<T>::value)
+            return false;
+        using I = typename std::conditional<sizeof(T) == 4, std::int32_t,
+                                            std::int64_t>::type;
+        I ikey;
+        std::memcpy(&ikey, &key, sizeof(I));
+        return tms_simd_search<Count>(reinterpret_cast<const I *>(data), n,
+                                      ikey, op, result);
+    }
+#endif
+    (void)data; (void)n; (void)key; (void)op; (void)result;
+    return false;
+}
+
+
+// tms_search
+// Basic Guarantee
+// Exception-Neutral
+// Pre:
+//      [data, data + n) is a valid range
+//      T supports == (for TMS_CMP_EQ) or < (for TMS_CMP_LT/GT)
+// Post:
+//      Count false: returns index of first element with (elem OP key),
+//       or n if none
+//      Count true: returns number of such elements
+//      Arithmetic T of 4 or 8 bytes use the best SIMD kernel allowed by
+//       tms_isa_limit(); everything else uses a scalar loop. Results are
+//       identical either way (NaN never matches, -0.0 == 0.0).
+template <bool Count, typename T>
+std::size_t tms_search(const T * data, std::size_t n, const T & key,
+                       TMSCmp op)
+{
+    std::size_t result = 0;
+    if (!tms_simd_dispatch<Count>(data, n, key, op, result))
+        result = Count ? tms_scalar_count(data, n, key, op)
+                       : tms_scalar_find(data, n, key, op);
+    return result;
+}
@@ -0,0 +1,96 @@
+// tmssimd_bench.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Benchmark: TMSArray::find / count at each ISA level vs. std::find /
+//  std::count, over array sizes (L1 to DRAM) and hit positions.
+// Usage: tmssimd_bench [maxelements=16777216]
+// Requires tmsarray.hpp, tmssimd.hpp, tmsbench.hpp
+
+#include "tmsarray.hpp"
+#include "tmssimd.hpp"
+#include "tmsbench.hpp"
+
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::int32_t;
+#include <iostream>
+using std::cout;
+#include <string>
+using std::string;
+using std::to_string;
+#include <algorithm>
+using std::find;
+using std::count;
+
+
+// benchType
+// One table per element type: rows are size x hit position, columns
+//  std::find, then find at each ISA level, then count at best level
+template <typename T>
+void benchType(const string & name, size_t maxElems)
+{
+    cout << "\n== TMSArray<" << name << "> (best ISA "
+         << tms_isa_name(tms_detect_isa()) << ") ==\n";
+    const TMSIsa best = tms_detect_isa();
+
+    for (size_t n = 1024; n <= maxElems; n *= 16)
+    {
+        TMSArray<T> ta(n);
+        for (size_t i = 0; i < n; ++i)
+            ta[i] = T(i % 1000);
+        const T key = T(5000);      // not present unless planted
+
+        for (int pct : { 10, 50, 100 })
+        {
+            size_t hit = pct == 100 ? n : n * size_t(pct) / 100;
+            if (hit < n)
+                ta[hit] = key;
+            const size_t scanned = (hit < n ? hit + 1 : n) * sizeof(T);
+            const int reps = n < 100000 ? 2000 : 20;
+            string where = pct == 100 ? "miss" : "hit@" + to_string(pct) + "%";
+            string row = to_string(n) + " " + where;
+
+            double secs = tms_time_best(reps, [&]
+            {
+                tms_sink(find(ta.begin(), ta.end(), key));
+            });
+            tms_report(row + " std::find", secs, scanned);
+
+            for (int level = TMS_ISA_SCALAR; level <= best; ++level)
+            {
+                tms_isa_limit() = TMSIsa(level);
+                secs = tms_time_best(reps, [&]
+                {
+                    tms_sink(ta.find(key));
+                });
+                tms_report(row + " find " + tms_isa_name(TMSIsa(level)),
+                           secs, scanned);
+            }
+            tms_isa_limit() = best;
+
+            if (pct == 100)
+            {
+                secs = tms_time_best(reps, [&]
+                {
+                    tms_sink(count(ta.begin(), ta.end(), key));
+                });
+                tms_report(row + " std::count", secs, n * sizeof(T));
+                secs = tms_time_best(reps, [&]{ tms_sink(ta.count(key)); });
+                tms_report(row + " count", secs, n * sizeof(T));
+            }
+            if (hit < n)
+                ta[hit] = T(hit % 1000);
+        }
+    }
+}
+
+
+int main(int argc, char * argv[])
+{
+    const size_t maxElems = tms_arg(argc, argv, 1, size_t(1) << 24);
+    benchType<int32_t>("int", maxElems);
+    benchType<double>("double", maxElems);
+    return 0;
+}
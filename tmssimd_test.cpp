@@ -0,0 +1,202 @@
+// tmssimd_test.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Test program for SIMD search kernels and TMSArray find, count,
+//  contains, find_if_less, find_if_greater
+// Uses the "doctest" unit-testing framework, version 2
+// Requires doctest.h, tmssimd.hpp, tmsarray.hpp
+
+// Includes for code to be tested
+#include "tmsarray.hpp"      // For class template TMSArray
+#include "tmssimd.hpp"       // For tms_isa_limit, tms_detect_isa
+#include "tmssimd.hpp"       // Double-inclusion check, for testing only
+
+// Includes for the "doctest" unit-testing framework
+#define DOCTEST_CONFIG_IMPLEMENT
+                             // We write our own main
+#define DOCTEST_CONFIG_SUPER_FAST_ASSERTS
+                             // Reduce compile time
+#include "doctest.h"         // For doctest
+
+// Includes for all test programs
+#include <iostream>
+using std::cout;
+using std::endl;
+using std::cin;
+#include <string>
+using std::string;
+
+// Additional includes for this test program
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::int64_t;
+using std::uint32_t;
+#include <algorithm>
+using std::find;
+using std::find_if;
+using std::count;
+#include <limits>
+using std::numeric_limits;
+
+// Printable name for this test suite
+const string test_suite_name =
+    "TMSArray SIMD search members";
+
+
+// *********************************************************************
+// Helper Functions for This Test Program
+// *********************************************************************
+
+
+// checkSearch
+// Fills a TMSArray<T> of each size with a small repeating pattern and
+//  compares every search member against the std algorithm, at every ISA
+//  level this CPU supports.
+template <typename T>
+void checkSearch()
+{
+    const TMSIsa best = tms_detect_isa();
+    for (int level = TMS_ISA_SCALAR; level <= best; ++level)
+    {
+        tms_isa_limit() = TMSIsa(level);
+        for (size_t size : { 0, 1, 7, 16, 33, 100, 1000, 4099 })
+        {
+            TMSArray<T> ta(size);
+            for (size_t i = 0; i < size; ++i)
+                ta[i] = T((i * 7) % 13);
+            if (size > 50)
+                ta[size - 3] = T(20);   // lone hit near the tail
+
+            for (T key : { T(0), T(5), T(12), T(20), T(99) })
+            {
+                INFO( tms_isa_name(TMSIsa(level)) << " size " << size
+                      << " key " << key );
+                REQUIRE( ta.find(key) == find(ta.begin(), ta.end(), key) );
+                REQUIRE( ta.count(key)
+                         == size_t(count(ta.begin(), ta.end(), key)) );
+                REQUIRE( ta.contains(key)
+                         == (find(ta.begin(), ta.end(), key) != ta.end()) );
+                REQUIRE( ta.find_if_less(key)
+                         == find_if(ta.begin(), ta.end(),
+                                    [&](const T & v) { return v < key; }) );
+                REQUIRE( ta.find_if_greater(key)
+                         == find_if(ta.begin(), ta.end(),
+                                    [&](const T & v) { return key < v; }) );
+            }
+        }
+    }
+    tms_isa_limit() = best;
+}
+
+
+// *********************************************************************
+// Test Cases
+// *********************************************************************
+
+
+TEST_CASE( "TMSArray search members match std algorithms" )
+{
+    SUBCASE( "int" )      { checkSearch<int>(); }
+    SUBCASE( "int64_t" )  { checkSearch<int64_t>(); }
+    SUBCASE( "uint32_t" ) { checkSearch<uint32_t>(); }
+    SUBCASE( "float" )    { checkSearch<float>(); }
+    SUBCASE( "double" )   { checkSearch<double>(); }
+    SUBCASE( "short" )    { checkSearch<short>(); }
+}
+
+
+TEST_CASE( "TMSArray search edge cases" )
+{
+    SUBCASE( "NaN never matches, -0.0 == 0.0" )
+    {
+        TMSArray<double> td(64);
+        for (size_t i = 0; i < td.size(); ++i)
+            td[i] = numeric_limits<double>::quiet_NaN();
+        td[40] = -0.0;
+        REQUIRE( td.find(0.0) == td.begin() + 40 );
+        REQUIRE_FALSE( td.contains(numeric_limits<double>::quiet_NaN()) );
+        REQUIRE( td.find_if_greater(-1.0) == td.begin() + 40 );
+    }
+
+    SUBCASE( "Unsigned ordering above INT_MAX" )
+    {
+        TMSArray<uint32_t> tu(40);
+        for (size_t i = 0; i < tu.size(); ++i)
+            tu[i] = 1;
+        tu[30] = 0x80000000u;
+        REQUIRE( tu.find_if_greater(1u) == tu.begin() + 30 );
+        REQUIRE( tu.find_if_less(1u) == tu.end() );
+    }
+
+    SUBCASE( "Non-arithmetic type" )
+    {
+        TMSArray<string> ts(4);
+        ts[0] = "b";
+        ts[1] = "a";
+        ts[2] = "c";
+        ts[3] = "a";
+        REQUIRE( ts.find("a") == ts.begin() + 1 );
+        REQUIRE( ts.count("a") == 2 );
+        REQUIRE_FALSE( ts.contains("z") );
+        REQUIRE( ts.find_if_less("b") == ts.begin() + 1 );
+        REQUIRE( ts.find_if_greater("b") == ts.begin() + 2 );
+    }
+
+    SUBCASE( "Const array" )
+    {
+        TMSArray<int> ti(10);
+        for (size_t i = 0; i < ti.size(); ++i)
+            ti[i] = int(i);
+        const TMSArray<int> & cti = ti;
+        REQUIRE( cti.find(3) == cti.begin() + 3 );
+        REQUIRE( cti.find_if_less(0) == cti.end() );
+        REQUIRE( cti.find_if_greater(8) == cti.begin() + 9 );
+    }
+}
+
+
+// *********************************************************************
+// Main Program
+// *********************************************************************
+
+
+// userPause
+// Wait for user to press ENTER: read all chars through first newline.
+void userPause()
+{
+    std::cout.flush();
+    while (std::cin.get() != '\n') ;
+}
+
+
+// Main program
+// Run all tests. Prompt for ENTER before exiting.
+int main(int argc,
+         char *argv[])
+{
+    doctest::Context dtcontext;
+                             // Primary doctest object
+    int dtresult;            // doctest return code; for return by main
+
+    // Handle command line
+    dtcontext.applyCommandLine(argc, argv);
+    dtresult = 0;            // doctest flags no command-line errors
+                             //  (strange but true)
+
+    if (!dtresult)           // Continue only if no command-line error
+    {
+        // Run test suites
+        cout << "BEGIN tests for " << test_suite_name << "\n" << endl;
+        dtresult = dtcontext.run();
+        cout << "END tests for " << test_suite_name << "\n" << endl;
+    }
+
+    // Wait for user
+    std::cout << "Press ENTER to quit ";
+    userPause();
+
+    // Program return value is return code from doctest
+    return dtresult;
+}
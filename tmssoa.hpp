@@ -0,0 +1,671 @@
+// tmssoa.hpp
+// Matthew Johnson
+// 10/17/2026
+// struct-of-arrays container: one contiguous column per field type,
+//  shared size and capacity, proxy row references
+
+#pragma once
+// for single inclusion
+
+#include <cstddef>
+// For std::size_t
+// For std::ptrdiff_t
+
+#include <tuple>
+// For std::tuple
+// For std::get
+// For std::tuple_element_t
+// For std::apply
+
+#include <utility>
+// For std::index_sequence
+// For std::make_index_sequence
+// For std::swap
+
+#include <iterator>
+// For std::random_access_iterator_tag
+
+#include <type_traits>
+// For std::conditional_t
+
+#include <algorithm>
+// For std::max
+// For std::copy
+// For std::rotate
+
+
+
+// *********************************************************************
+// class TMSSoAArray - Class definition
+// *********************************************************************
+
+
+// class TMSSoAArray
+// Resizable array of rows (Fields...) stored column-wise: field I of
+//  every row lives in one contiguous array, so a loop over one field
+//  reads only that field's bytes and can run SIMD over column<I>().
+//  Size and capacity are kept once for all columns; every operation
+//  that changes the row count touches all columns together. Rows are
+//  read and written through proxy references (operator[], iterators).
+// Requirements on Types:
+//     Each field type is default-constructible and copy-assignable.
+// Invariants:
+//     0 <= _size <= _capacity.
+//     Each pointer in _cols owns an array of _capacity elements of its
+//      field type, allocated with new [] -- UNLESS _capacity == 0 (a
+//      moved-from object), in which case they are nullptr.
+template <typename... Fields>
+class TMSSoAArray
+{
+
+    static_assert(sizeof...(Fields) > 0, "TMSSoAArray needs a field");
+
+public:
+
+
+    using size_type  = std::size_t;
+
+    using row_type   = std::tuple<Fields...>;
+
+    // Number of fields (columns)
+    static constexpr size_type field_count = sizeof...(Fields);
+
+    // Type of field I
+    template <size_type I>
+    using field_type = std::tuple_element_t<I, row_type>;
+
+
+private:
+
+
+    // Capacity of default-constructed object
+    enum { DEFAULT_CAP = 42 };
+
+    using columns_type = std::tuple<Fields *...>;
+
+    using indices = std::make_index_sequence<sizeof...(Fields)>;
+
+
+public:
+
+
+    // ColumnSpan
+    // Contiguous view of one column: data(), size(), begin/end, []
+    template <typename T>
+    class ColumnSpan
+    {
+    public:
+
+        ColumnSpan(T * data, size_type size) noexcept
+            :_data(data), _size(size)
+        {}
+
+        T * data() const noexcept { return _data; }
+        size_type size() const noexcept { return _size; }
+        T * begin() const noexcept { return _data; }
+        T * end() const noexcept { return _data + _size; }
+        T & operator[](size_type i) const noexcept { return _data[i]; }
+
+    private:
+
+        T *       _data;
+        size_type _size;
+
+    };
+
+
+    // RowRef
+    // Proxy for row i: get<I>() is a reference into column I. Assigning
+    //  a row_type or another RowRef writes every field of row i.
+    template <bool Const>
+    class RowRef
+    {
+        using owner_type = std::conditional_t<Const, const TMSSoAArray,
+                                              TMSSoAArray>;
+
+    public:
+
+        RowRef(owner_type * owner, size_type index) noexcept
+            :_owner(owner), _index(index)
+        {}
+
+        RowRef(const RowRef &) = default;
+
+        template <size_type I>
+        decltype(auto) get() const noexcept
+        {
+            return _owner->template get<I>(_index);
+        }
+
+        size_type index() const noexcept
+        {
+            return _index;
+        }
+
+        operator row_type() const
+        {
+            return _owner->rowValue(_index, indices());
+        }
+
+        const RowRef & operator=(const row_type & row) const
+        {
+            _owner->assignRow(_index, row, indices());
+            return *this;
+        }
+
+        const RowRef & operator=(const RowRef & other) const
+        {
+            return *this = row_type(other);
+        }
+
+    private:
+
+        owner_type * _owner;
+        size_type    _index;
+
+    };
+
+    using reference       = RowRef<false>;
+
+    using const_reference = RowRef<true>;
+
+
+    // RowIterator
+    // Random-access iterator over rows; dereferences to a RowRef
+    template <bool Const>
+    class RowIterator
+    {
+        using owner_type = std::conditional_t<Const, const TMSSoAArray,
+                                              TMSSoAArray>;
+
+    public:
+
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type        = row_type;
+        using difference_type   = std::ptrdiff_t;
+        using reference         = RowRef<Const>;
+        using pointer           = void;
+
+        RowIterator(owner_type * owner, size_type index) noexcept
+            :_owner(owner), _index(index)
+        {}
+
+        reference operator*() const noexcept
+        {
+            return reference(_owner, _index);
+        }
+        reference operator[](difference_type k) const noexcept
+        {
+            return reference(_owner, _index + k);
+        }
+
+        RowIterator & operator++() noexcept { ++_index; return *this; }
+        RowIterator & operator--() noexcept { --_index; return *this; }
+        RowIterator operator++(int) noexcept { return RowIterator(_owner, _index++); }
+        RowIterator operator--(int) noexcept { return RowIterator(_owner, _index--); }
+        RowIterator & operator+=(difference_type k) noexcept { _index += k; return *this; }
+        RowIterator & operator-=(difference_type k) noexcept { _index -= k; return *this; }
+
+        friend RowIterator operator+(RowIterator it, difference_type k) noexcept
+        {
+            return it += k;
+        }
+        friend RowIterator operator+(difference_type k, RowIterator it) noexcept
+        {
+            return it += k;
+        }
+        friend RowIterator operator-(RowIterator it, difference_type k) noexcept
+        {
+            return it -= k;
+        }
+        friend difference_type operator-(const RowIterator & a,
+                                         const RowIterator & b) noexcept
+        {
+            return difference_type(a._index) - difference_type(b._index);
+        }
+        friend bool operator==(const RowIterator & a, const RowIterator & b) noexcept
+        {
+            return a._index == b._index;
+        }
+        friend bool operator!=(const RowIterator & a, const RowIterator & b) noexcept
+        {
+            return a._index != b._index;
+        }
+        friend bool operator<(const RowIterator & a, const RowIterator & b) noexcept
+        {
+            return a._index < b._index;
+        }
+        friend bool operator>(const RowIterator & a, const RowIterator & b) noexcept
+        {
+            return a._index > b._index;
+        }
+        friend bool operator<=(const RowIterator & a, const RowIterator & b) noexcept
+        {
+            return a._index <= b._index;
+        }
+        friend bool operator>=(const RowIterator & a, const RowIterator & b) noexcept
+        {
+            return a._index >= b._index;
+        }
+
+    private:
+
+        owner_type * _owner;
+        size_type    _index;
+
+    };
+
+    using iterator       = RowIterator<false>;
+
+    using const_iterator = RowIterator<true>;
+
+
+// ***** TMSSoAArray: ctors, op=, dctor *****
+public:
+
+
+    // Default ctor & ctor from size
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      size() == thesize; every column has room for
+    //      max(thesize, DEFAULT_CAP) rows
+    explicit TMSSoAArray(size_type thesize=0)
+        :_capacity(std::max(thesize, size_type(DEFAULT_CAP))),
+         _size(thesize),
+         _cols(allocate(_capacity))
+    {}
+
+
+    // Copy ctor
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      *this is a copy of other
+    TMSSoAArray(const TMSSoAArray & other)
+        :_capacity(other._capacity),
+         _size(other._size),
+         _cols(allocate(other._capacity))
+    {
+        try
+        {
+            copyColumns(other._cols, _cols, _size, indices());
+        }
+        catch (...)
+        {
+            release(_cols);
+            throw;
+        }
+    }
+
+
+    // Move ctor
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      *this holds other's rows; other is empty with no storage
+    TMSSoAArray(TMSSoAArray && other) noexcept
+        :_capacity(other._capacity),
+         _size(other._size),
+         _cols(other._cols)
+    {
+        other._capacity = 0;
+        other._size = 0;
+        other._cols = columns_type();
+    }
+
+
+    // Copy assignment operator
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      *this is a copy of other
+    TMSSoAArray & operator=(const TMSSoAArray & other)
+    {
+        TMSSoAArray copy(other);
+        swap(copy);
+        return *this;
+    }
+
+
+    // Move assignment operator
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      *this holds other's rows
+    TMSSoAArray & operator=(TMSSoAArray && other) noexcept
+    {
+        swap(other);
+        return *this;
+    }
+
+
+    // Dctor
+    // No-Throw Guarantee
+    // Pre: None
+    // Post: None
+    ~TMSSoAArray()
+    {
+        release(_cols);
+    }
+
+
+// ***** TMSSoAArray: general public operators *****
+public:
+
+
+    // operator[]
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      0 <= index < size()
+    // Post:
+    //      Returns proxy for row index
+    reference operator[](size_type index) noexcept
+    {
+        return reference(this, index);
+    }
+    const_reference operator[](size_type index) const noexcept
+    {
+        return const_reference(this, index);
+    }
+
+
+// ***** TMSSoAArray: general public functions *****
+public:
+
+
+    // size
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns number of rows
+    size_type size() const noexcept
+    {
+        return _size;
+    }
+
+
+    // empty
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns size() == 0
+    bool empty() const noexcept
+    {
+        return _size == 0;
+    }
+
+
+    // get - non-const & const
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      I < field_count; 0 <= index < size()
+    // Post:
+    //      Returns field I of row index
+    template <size_type I>
+    field_type<I> & get(size_type index) noexcept
+    {
+        return std::get<I>(_cols)[index];
+    }
+    template <size_type I>
+    const field_type<I> & get(size_type index) const noexcept
+    {
+        return std::get<I>(_cols)[index];
+    }
+
+
+    // column - non-const & const
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      I < field_count
+    // Post:
+    //      Returns contiguous span of field I for all size() rows; valid
+    //      until the next operation that changes size()
+    template <size_type I>
+    ColumnSpan<field_type<I>> column() noexcept
+    {
+        return ColumnSpan<field_type<I>>(std::get<I>(_cols), _size);
+    }
+    template <size_type I>
+    ColumnSpan<const field_type<I>> column() const noexcept
+    {
+        return ColumnSpan<const field_type<I>>(std::get<I>(_cols), _size);
+    }
+
+
+    // begin, end - non-const & const
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns row iterator to first row; past the last row
+    iterator begin() noexcept
+    {
+        return iterator(this, 0);
+    }
+    const_iterator begin() const noexcept
+    {
+        return const_iterator(this, 0);
+    }
+    iterator end() noexcept
+    {
+        return iterator(this, _size);
+    }
+    const_iterator end() const noexcept
+    {
+        return const_iterator(this, _size);
+    }
+
+
+    // resize
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      size() == newsize; rows below the old size are kept in every
+    //      column. Growing past capacity reallocates all columns at
+    //      max(2 * capacity, newsize), all-or-nothing.
+    void resize(size_type newsize)
+    {
+        if (newsize > _capacity)
+        {
+            const size_type newCapacity = std::max(_capacity * 2, newsize);
+            columns_type newCols = allocate(newCapacity);
+            try
+            {
+                copyColumns(_cols, newCols, _size, indices());
+            }
+            catch (...)
+            {
+                release(newCols);
+                throw;
+            }
+            release(_cols);
+            _cols = newCols;
+            _capacity = newCapacity;
+        }
+        _size = newsize;
+    }
+
+
+    // insert
+    // Strong Guarantee (Basic if a field's assignment throws during the
+    //  shift)
+    // Exception-Neutral
+    // Pre:
+    //      0 <= index <= size()
+    // Post:
+    //      row is at index in every column; later rows move back one
+    void insert(size_type index, const row_type & row)
+    {
+        const size_type old = _size;
+        resize(_size + 1);
+        try
+        {
+            assignRow(old, row, indices());
+        }
+        catch (...)
+        {
+            _size = old;
+            throw;
+        }
+        rotateColumns(index, old, _size, indices());
+    }
+
+
+    // erase
+    // No-Throw Guarantee (if field assignment does not throw)
+    // Exception-Neutral
+    // Pre:
+    //      0 <= index < size()
+    // Post:
+    //      row index removed from every column; later rows move up one
+    void erase(size_type index)
+    {
+        rotateColumns(index, index + 1, _size, indices());
+        --_size;
+    }
+
+
+    // push_back
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      row (or the row made of fields) appended to every column
+    void push_back(const row_type & row)
+    {
+        insert(_size, row);
+    }
+    void push_back(const Fields & ... fields)
+    {
+        insert(_size, row_type(fields...));
+    }
+
+
+    // pop_back
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      size() > 0
+    // Post:
+    //      last row removed
+    void pop_back() noexcept
+    {
+        --_size;
+    }
+
+
+    // swap
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      *this and other exchange contents
+    void swap(TMSSoAArray & other) noexcept
+    {
+        std::swap(_capacity, other._capacity);
+        std::swap(_size, other._size);
+        std::swap(_cols, other._cols);
+    }
+
+
+// ***** TMSSoAArray: private helpers *****
+private:
+
+
+    // allocate
+    // One new [] array of cap elements per field; all or nothing
+    static columns_type allocate(size_type cap)
+    {
+        columns_type cols;
+        allocateFrom<0>(cols, cap);
+        return cols;
+    }
+
+    template <size_type I>
+    static void allocateFrom(columns_type & cols, size_type cap)
+    {
+        if constexpr (I < sizeof...(Fields))
+        {
+            std::get<I>(cols) = new field_type<I>[cap];
+            try
+            {
+                allocateFrom<I + 1>(cols, cap);
+            }
+            catch (...)
+            {
+                delete [] std::get<I>(cols);
+                throw;
+            }
+        }
+    }
+
+
+    // release
+    // Frees every column (nullptr columns are fine)
+    static void release(columns_type & cols) noexcept
+    {
+        std::apply([](auto * ... p) { (delete [] p, ...); }, cols);
+    }
+
+
+    // copyColumns
+    // Copies the first n rows of every column of from into to
+    template <size_type... Is>
+    static void copyColumns(const columns_type & from, columns_type & to,
+                            size_type n, std::index_sequence<Is...>)
+    {
+        (std::copy(std::get<Is>(from), std::get<Is>(from) + n,
+                   std::get<Is>(to)), ...);
+    }
+
+
+    // rotateColumns
+    // std::rotate(first, middle, last) applied to every column
+    template <size_type... Is>
+    void rotateColumns(size_type first, size_type middle, size_type last,
+                       std::index_sequence<Is...>)
+    {
+        (std::rotate(std::get<Is>(_cols) + first, std::get<Is>(_cols) + middle,
+                     std::get<Is>(_cols) + last), ...);
+    }
+
+
+    // assignRow
+    // Writes every field of row into row index
+    template <size_type... Is>
+    void assignRow(size_type index, const row_type & row,
+                   std::index_sequence<Is...>)
+    {
+        ((std::get<Is>(_cols)[index] = std::get<Is>(row)), ...);
+    }
+
+
+    // rowValue
+    // Copy of row index as a tuple
+    template <size_type... Is>
+    row_type rowValue(size_type index, std::index_sequence<Is...>) const
+    {
+        return row_type(std::get<Is>(_cols)[index]...);
+    }
+
+
+// ***** TMSSoAArray: data members *****
+private:
+
+    size_type    _capacity;
+    size_type    _size;
+    columns_type _cols;     // one array per field
+
+}; // end of class
@@ -0,0 +1,163 @@
+// tmssoa_bench.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Benchmark: TMSSoAArray of a 10-field trade record vs. AoS
+//  TMSArray<Record>: scans that touch one field, two fields, and a
+//  filter on a small field, plus building by push_back.
+// Usage: tmssoa_bench [rows=4194304]
+// Requires tmssoa.hpp, tmsarray.hpp, tmsbench.hpp
+
+#include "tmssoa.hpp"
+#include "tmsarray.hpp"
+#include "tmsbench.hpp"
+
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::int32_t;
+using std::int64_t;
+using std::uint8_t;
+using std::uint64_t;
+
+
+// 10 fields, 64 bytes
+struct Record
+{
+    int64_t id;
+    int64_t time;
+    double  price;
+    double  qty;
+    double  fee;
+    int32_t account;
+    int32_t venue;
+    int32_t symbol;
+    int32_t trader;
+    uint8_t side;
+    uint8_t flags;
+};
+
+using Columns = TMSSoAArray<int64_t, int64_t, double, double, double,
+                            int32_t, int32_t, int32_t, int32_t,
+                            uint8_t, uint8_t>;
+enum { ID, TIME, PRICE, QTY, FEE, ACCOUNT, VENUE, SYMBOL, TRADER, SIDE, FLAGS };
+
+
+int main(int argc, char * argv[])
+{
+    const size_t n = tms_arg(argc, argv, 1, size_t(1) << 22);
+
+    TMSArray<Record> aos(n);
+    Columns soa(n);
+    uint64_t x = 88172645463325252ull;
+    for (size_t i = 0; i < n; ++i)
+    {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        const Record r = { int64_t(i), int64_t(i * 1000), double(x % 10000) / 100,
+                           double(x % 977), 0.25, int32_t(x % 5000), 3,
+                           int32_t(x % 800), 7, uint8_t(x & 1),
+                           uint8_t(x >> 61) };
+        aos[i] = r;
+        soa[i] = Columns::row_type(r.id, r.time, r.price, r.qty, r.fee,
+                                   r.account, r.venue, r.symbol, r.trader,
+                                   r.side, r.flags);
+    }
+
+    double secs = tms_time_best(3, [&]
+    {
+        TMSArray<Record> t;
+        for (size_t i = 0; i < n; ++i)
+            t.push_back(aos[i]);
+        tms_sink(t.size());
+    });
+    tms_report("build AoS push_back", secs, n * sizeof(Record));
+    secs = tms_time_best(3, [&]
+    {
+        Columns t;
+        for (size_t i = 0; i < n; ++i)
+        {
+            const Record & r = aos[i];
+            t.push_back(r.id, r.time, r.price, r.qty, r.fee, r.account,
+                        r.venue, r.symbol, r.trader, r.side, r.flags);
+        }
+        tms_sink(t.size());
+    });
+    tms_report("build SoA push_back", secs, n * sizeof(Record));
+
+    // One 8-byte field: AoS pulls the whole 64-byte line per row
+    secs = tms_time_best(5, [&]
+    {
+        double sum = 0;
+        for (const Record & r : aos)
+            sum += r.price;
+        tms_sink(sum);
+    });
+    tms_report("sum price AoS", secs, n * sizeof(double));
+    secs = tms_time_best(5, [&]
+    {
+        double sum = 0;
+        for (double p : soa.column<PRICE>())
+            sum += p;
+        tms_sink(sum);
+    });
+    tms_report("sum price SoA", secs, n * sizeof(double));
+
+    // Two fields
+    secs = tms_time_best(5, [&]
+    {
+        double notional = 0;
+        for (const Record & r : aos)
+            notional += r.price * r.qty;
+        tms_sink(notional);
+    });
+    tms_report("sum price*qty AoS", secs, 2 * n * sizeof(double));
+    secs = tms_time_best(5, [&]
+    {
+        const double * p = soa.column<PRICE>().data();
+        const double * q = soa.column<QTY>().data();
+        double notional = 0;
+        for (size_t i = 0; i < n; ++i)
+            notional += p[i] * q[i];
+        tms_sink(notional);
+    });
+    tms_report("sum price*qty SoA", secs, 2 * n * sizeof(double));
+
+    // Filter on a 1-byte field (vectorizes over the SoA column)
+    secs = tms_time_best(5, [&]
+    {
+        size_t hits = 0;
+        for (const Record & r : aos)
+            hits += r.flags == 5;
+        tms_sink(hits);
+    });
+    tms_report("count flags==5 AoS", secs, n);
+    secs = tms_time_best(5, [&]
+    {
+        size_t hits = 0;
+        for (uint8_t f : soa.column<FLAGS>())
+            hits += f == 5;
+        tms_sink(hits);
+    });
+    tms_report("count flags==5 SoA", secs, n);
+
+    // Whole-row access through the proxy, for comparison
+    secs = tms_time_best(3, [&]
+    {
+        int64_t sum = 0;
+        for (auto r : soa)
+            sum += r.get<ID>() + r.get<ACCOUNT>() + r.get<FLAGS>();
+        tms_sink(sum);
+    });
+    tms_report("3-field row loop SoA", secs);
+    secs = tms_time_best(3, [&]
+    {
+        int64_t sum = 0;
+        for (const Record & r : aos)
+            sum += r.id + r.account + r.flags;
+        tms_sink(sum);
+    });
+    tms_report("3-field row loop AoS", secs);
+    return 0;
+}
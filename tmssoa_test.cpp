@@ -0,0 +1,321 @@
+// tmssoa_test.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Test program for class template TMSSoAArray
+// Uses the "doctest" unit-testing framework, version 2
+// Requires doctest.h, tmssoa.hpp
+
+// Includes for code to be tested
+#include "tmssoa.hpp"        // For class template TMSSoAArray
+#include "tmssoa.hpp"        // Double-inclusion check, for testing only
+
+// Includes for the "doctest" unit-testing framework
+#define DOCTEST_CONFIG_IMPLEMENT
+                             // We write our own main
+#define DOCTEST_CONFIG_SUPER_FAST_ASSERTS
+                             // Reduce compile time
+#include "doctest.h"         // For doctest
+
+// Includes for all test programs
+#include <iostream>
+using std::cout;
+using std::endl;
+using std::cin;
+#include <string>
+using std::string;
+using std::to_string;
+
+// Additional includes for this test program
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::int32_t;
+using std::uint64_t;
+#include <tuple>
+using std::tuple;
+using std::make_tuple;
+using std::get;
+#include <utility>
+using std::move;
+#include <algorithm>
+using std::sort;
+#include <stdexcept>
+using std::runtime_error;
+#include <type_traits>
+using std::is_same;
+
+// Printable name for this test suite
+const string test_suite_name =
+    "class template TMSSoAArray";
+
+
+// *********************************************************************
+// Helper Functions for This Test Program
+// *********************************************************************
+
+
+using Soa = TMSSoAArray<int32_t, double, string>;
+
+
+// fillRows
+// Row i is (i, i / 2.0, "r<i>")
+void fillRows(Soa & ts, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        ts.push_back(int32_t(i), double(i) / 2.0, "r" + to_string(i));
+}
+
+
+// checkRow
+// Row at index holds the fields fillRows gave row k
+bool checkRow(const Soa & ts, size_t index, size_t k)
+{
+    return ts.get<0>(index) == int32_t(k)
+        && ts.get<1>(index) == double(k) / 2.0
+        && ts.get<2>(index) == "r" + to_string(k);
+}
+
+
+// Throws when assigned a value equal to poison
+struct Touchy
+{
+    static int poison;
+    int v = 0;
+
+    Touchy() = default;
+    Touchy(int x) : v(x) {}
+    Touchy(const Touchy & other) : v(other.v) {}
+    Touchy & operator=(const Touchy & other)
+    {
+        if (other.v == poison)
+            throw runtime_error("Touchy");
+        v = other.v;
+        return *this;
+    }
+};
+int Touchy::poison = -1;
+
+
+// *********************************************************************
+// Test Cases
+// *********************************************************************
+
+
+TEST_CASE( "Types and construction" )
+{
+    REQUIRE( Soa::field_count == 3 );
+    REQUIRE( is_same<Soa::field_type<1>, double>::value );
+
+    Soa empty;
+    REQUIRE( empty.size() == 0 );
+    REQUIRE( empty.empty() );
+    REQUIRE( empty.begin() == empty.end() );
+
+    Soa sized(10);
+    REQUIRE( sized.size() == 10 );
+    REQUIRE( sized.column<2>().size() == 10 );
+}
+
+
+TEST_CASE( "push_back, get, columns" )
+{
+    Soa ts;
+    fillRows(ts, 1000);                 // grows past the default capacity
+    REQUIRE( ts.size() == 1000 );
+    bool allMatch = true;
+    for (size_t i = 0; i < 1000; ++i)
+        allMatch = allMatch && checkRow(ts, i, i);
+    REQUIRE( allMatch );
+
+    SUBCASE( "Columns are contiguous spans" )
+    {
+        auto ids = ts.column<0>();
+        REQUIRE( ids.size() == 1000 );
+        REQUIRE( ids.data() + 999 == &ts.get<0>(999) );
+        int32_t sum = 0;
+        for (int32_t v : ids)
+            sum += v;
+        REQUIRE( sum == 999 * 1000 / 2 );
+        ts.column<1>()[3] = -1.0;
+        REQUIRE( ts.get<1>(3) == -1.0 );
+    }
+
+    SUBCASE( "push_back of a tuple" )
+    {
+        ts.push_back(make_tuple(int32_t(-5), 2.5, string("t")));
+        REQUIRE( ts.size() == 1001 );
+        REQUIRE( ts.get<2>(1000) == "t" );
+    }
+}
+
+
+TEST_CASE( "Row proxies and iterators" )
+{
+    Soa ts;
+    fillRows(ts, 10);
+
+    SUBCASE( "Read and write through a proxy" )
+    {
+        auto r = ts[4];
+        REQUIRE( r.index() == 4 );
+        REQUIRE( r.get<0>() == 4 );
+        r.get<2>() = "changed";
+        REQUIRE( ts.get<2>(4) == "changed" );
+        tuple<int32_t, double, string> row = ts[5];
+        REQUIRE( get<2>(row) == "r5" );
+        ts[6] = make_tuple(int32_t(60), 6.5, string("six"));
+        REQUIRE( ts.get<0>(6) == 60 );
+        REQUIRE( ts.get<2>(6) == "six" );
+    }
+
+    SUBCASE( "Proxy assignment copies the row, not the reference" )
+    {
+        ts[0] = ts[9];
+        REQUIRE( checkRow(ts, 0, 9) );
+        REQUIRE( checkRow(ts, 9, 9) );
+        REQUIRE( checkRow(ts, 1, 1) );
+    }
+
+    SUBCASE( "Range-for and random-access iterators" )
+    {
+        size_t k = 0;
+        for (auto r : ts)
+        {
+            REQUIRE( r.get<0>() == int32_t(k) );
+            ++k;
+        }
+        REQUIRE( k == 10 );
+        REQUIRE( ts.end() - ts.begin() == 10 );
+        REQUIRE( (*(ts.begin() + 3)).get<0>() == 3 );
+        REQUIRE( ts.begin()[7].get<2>() == "r7" );
+        REQUIRE( (*(2 + ts.begin())).get<0>() == 2 );
+        REQUIRE( ts.end() > ts.begin() );
+        REQUIRE( ts.begin() <= ts.begin() );
+        REQUIRE( ts.end() >= ts.begin() + 10 );
+        REQUIRE_FALSE( ts.begin() >= ts.end() );
+
+        const Soa & cts = ts;
+        int32_t sum = 0;
+        for (auto r : cts)
+            sum += r.get<0>();
+        REQUIRE( sum == 45 );
+    }
+}
+
+
+TEST_CASE( "insert and erase move every column together" )
+{
+    Soa ts;
+    fillRows(ts, 50);
+
+    ts.insert(0, make_tuple(int32_t(-1), -0.5, string("first")));
+    ts.insert(25, make_tuple(int32_t(-2), -1.0, string("mid")));
+    ts.insert(ts.size(), make_tuple(int32_t(-3), -1.5, string("last")));
+    REQUIRE( ts.size() == 53 );
+    REQUIRE( ts.get<2>(0) == "first" );
+    REQUIRE( ts.get<0>(25) == -2 );
+    REQUIRE( ts.get<1>(52) == -1.5 );
+    REQUIRE( checkRow(ts, 1, 0) );
+    REQUIRE( checkRow(ts, 24, 23) );
+    REQUIRE( checkRow(ts, 26, 24) );
+    REQUIRE( checkRow(ts, 51, 49) );
+
+    ts.erase(25);
+    ts.erase(0);
+    ts.pop_back();
+    REQUIRE( ts.size() == 50 );
+    bool allMatch = true;
+    for (size_t i = 0; i < 50; ++i)
+        allMatch = allMatch && checkRow(ts, i, i);
+    REQUIRE( allMatch );
+}
+
+
+TEST_CASE( "Copy, move, swap, resize" )
+{
+    Soa ts;
+    fillRows(ts, 100);
+
+    Soa copy(ts);
+    copy.get<2>(0) = "x";
+    REQUIRE( ts.get<2>(0) == "r0" );
+    REQUIRE( checkRow(copy, 99, 99) );
+
+    Soa moved(move(copy));
+    REQUIRE( moved.size() == 100 );
+    REQUIRE( copy.size() == 0 );
+    copy = ts;                          // moved-from object is reusable
+    REQUIRE( checkRow(copy, 50, 50) );
+
+    Soa other;
+    fillRows(other, 3);
+    other.swap(ts);
+    REQUIRE( other.size() == 100 );
+    REQUIRE( ts.size() == 3 );
+
+    ts.resize(500);
+    REQUIRE( ts.size() == 500 );
+    REQUIRE( checkRow(ts, 2, 2) );
+    ts.resize(1);
+    REQUIRE( ts.size() == 1 );
+    REQUIRE( checkRow(ts, 0, 0) );
+}
+
+
+TEST_CASE( "push_back is strong when a field copy throws" )
+{
+    TMSSoAArray<int, Touchy> ts;
+    for (int v = 0; v < 5; ++v)
+        ts.push_back(v, Touchy(v));
+    Touchy::poison = 99;
+    REQUIRE_THROWS( ts.push_back(7, Touchy(99)) );
+    Touchy::poison = -1;
+    REQUIRE( ts.size() == 5 );
+    REQUIRE( ts.get<1>(4).v == 4 );
+}
+
+
+// *********************************************************************
+// Main Program
+// *********************************************************************
+
+
+// userPause
+// Wait for user to press ENTER: read all chars through first newline.
+void userPause()
+{
+    std::cout.flush();
+    while (std::cin.get() != '\n') ;
+}
+
+
+// Main program
+// Run all tests. Prompt for ENTER before exiting.
+int main(int argc,
+         char *argv[])
+{
+    doctest::Context dtcontext;
+                             // Primary doctest object
+    int dtresult;            // doctest return code; for return by main
+
+    // Handle command line
+    dtcontext.applyCommandLine(argc, argv);
+    dtresult = 0;            // doctest flags no command-line errors
+                             //  (strange but true)
+
+    if (!dtresult)           // Continue only if no command-line error
+    {
+        // Run test suites
+        cout << "BEGIN tests for " << test_suite_name << "\n" << endl;
+        dtresult = dtcontext.run();
+        cout << "END tests for " << test_suite_name << "\n" << endl;
+    }
+
+    // Wait for user
+    std::cout << "Press ENTER to quit ";
+    userPause();
+
+    // Program return value is return code from doctest
+    return dtresult;
+}
@@ -0,0 +1,406 @@
+// tmssort.hpp
+// Matthew Johnson
+// 10/17/2026
+// sorting for TMSArray: LSD radix sort for arithmetic keys, sorting
+//  network for tiny inputs, parallel merge sort for any comparator
+
+#pragma once
+// for single inclusion
+
+#include "tmsarray.hpp"
+// For class template TMSArray
+
+#include "tmsparallel.hpp"
+// For TMSThreadPool
+// For tms_parallel_for
+// For tms_chunk
+
+#include <cstddef>
+// For std::size_t
+
+#include <cstdint>
+// For std::uint8_t ... std::uint64_t
+
+#include <cstring>
+// For std::memcpy
+
+#include <algorithm>
+// For std::sort
+// For std::min
+// For std::max
+// For std::move
+// For std::upper_bound
+
+#include <functional>
+// For std::less
+
+#include <limits>
+// For std::numeric_limits
+
+#include <type_traits>
+// For std::is_arithmetic
+// For std::is_floating_point
+// For std::is_signed
+// For std::conditional
+
+
+
+// Below this many elements radix sort's histogram passes cost more than
+// a comparison sort
+constexpr std::size_t TMS_RADIX_MIN = 256;
+
+// Inputs of at most this many elements are sorted by the sorting network
+// (tms_sort_small, reached from tms_radix_sort below TMS_RADIX_MIN)
+constexpr std::size_t TMS_NETWORK_SIZE = 16;
+
+
+
+// *********************************************************************
+// Radix keys
+// *********************************************************************
+
+
+// tms_radix_bits_t
+// Unsigned integer the same width as Valtype
+template <typename Valtype>
+using tms_radix_bits_t = typename std::conditional<sizeof(Valtype) == 1,
+    std::uint8_t, typename std::conditional<sizeof(Valtype) == 2,
+    std::uint16_t, typename std::conditional<sizeof(Valtype) == 4,
+    std::uint32_t, std::uint64_t>::type>::type>::type;
+
+
+// tms_radix_key
+// No-Throw Guarantee
+// Pre:
+//      Valtype is arithmetic of 1, 2, 4 or 8 bytes
+// Post:
+//      Returns unsigned key whose unsigned order is value's order:
+//       unsigned: bits as is; signed: sign bit flipped; floating: all
+//       bits flipped if negative, else sign bit flipped. (-0.0 sorts
+//       before +0.0; NaNs go to the ends by sign.)
+template <typename Valtype>
+inline tms_radix_bits_t<Valtype> tms_radix_key(Valtype value) noexcept
+{
+    using U = tms_radix_bits_t<Valtype>;
+    const U signBit = U(U(1) << (8 * sizeof(U) - 1));
+    U bits;
+    std::memcpy(&bits, &value, sizeof(U));
+    if (std::is_floating_point<Valtype>::value)
+        return (bits & signBit) ? U(~bits) : U(bits ^ signBit);
+    if (std::is_signed<Valtype>::value)
+        return U(bits ^ signBit);
+    return bits;
+}
+
+
+
+// *********************************************************************
+// Sorting network
+// *********************************************************************
+
+
+// tms_cmpswap
+// Branchless compare-exchange: afterwards a <= b. For arithmetic types
+//  this compiles to min/max (or cmov), with no data-dependent branch.
+template <typename Valtype, typename Compare>
+inline void tms_cmpswap(Valtype & a, Valtype & b, Compare comp)
+{
+    const bool swapIt = comp(b, a);
+    Valtype lo = swapIt ? b : a;
+    Valtype hi = swapIt ? a : b;
+    a = lo;
+    b = hi;
+}
+
+
+// tms_network16
+// No-Throw Guarantee (for arithmetic Valtype)
+// Pre:
+//      v points to 16 elements
+// Post:
+//      v[0..16) sorted by comp, using Batcher's odd-even merge network
+//      (63 compare-exchanges at fixed positions; the loops have constant
+//      bounds, so the compiler fully unrolls them)
+template <typename Valtype, typename Compare>
+void tms_network16(Valtype * v, Compare comp)
+{
+    constexpr std::size_t N = TMS_NETWORK_SIZE;
+    for (std::size_t p = 1; p < N; p *= 2)
+        for (std::size_t k = p; k >= 1; k /= 2)
+            for (std::size_t j = k % p; j + k < N; j += 2 * k)
+                for (std::size_t i = 0; i < k && i + j + k < N; ++i)
+                    if ((i + j) / (2 * p) == (i + j + k) / (2 * p))
+                        tms_cmpswap(v[i + j], v[i + j + k], comp);
+}
+
+
+// tms_sort_small
+// Basic Guarantee
+// Exception-Neutral
+// Pre:
+//      [first, first + n) valid
+// Post:
+//      range sorted by comp. n <= 16 uses the network (short inputs are
+//      padded with copies of their largest element); larger n uses
+//      std::sort
+template <typename Valtype, typename Compare>
+void tms_sort_small(Valtype * first, std::size_t n, Compare comp)
+{
+    if (n <= 1)
+        return;
+    if (n > TMS_NETWORK_SIZE)
+    {
+        std::sort(first, first + n, comp);
+        return;
+    }
+    Valtype buf[TMS_NETWORK_SIZE];
+    std::size_t top = 0;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        buf[i] = first[i];
+        if (comp(buf[top], buf[i]))
+            top = i;
+    }
+    for (std::size_t i = n; i < TMS_NETWORK_SIZE; ++i)
+        buf[i] = buf[top];
+    tms_network16(buf, comp);
+    std::move(buf, buf + n, first);
+}
+
+
+
+// *********************************************************************
+// LSD radix sort
+// *********************************************************************
+
+
+// tms_radix_sort
+// Strong Guarantee for arithmetic Valtype (only the scratch allocation
+//  can throw, before arr is touched)
+// Exception-Neutral
+// Pre:
+//      Valtype is arithmetic
+// Post:
+//      arr sorted ascending (floating: by tms_radix_key order, which
+//      agrees with < for all non-NaN values). One 8-bit digit per pass;
+//      all histograms come from a single read, which also detects input
+//      already in order; passes whose digit is the same for every
+//      element are skipped. Scratch is one TMSArray of
+//      the same size, and the final buffer is swapped in, not copied.
+template <typename Valtype>
+void tms_radix_sort(TMSArray<Valtype> & arr)
+{
+    static_assert(std::is_arithmetic<Valtype>::value,
+                  "tms_radix_sort needs an arithmetic element type");
+    const std::size_t n = arr.size();
+    if (n < TMS_RADIX_MIN)
+    {
+        tms_sort_small(arr.begin(), n, std::less<Valtype>());
+        return;
+    }
+
+    constexpr std::size_t DIGITS = sizeof(Valtype);
+    TMSArray<Valtype> scratch(n);
+    TMSArray<std::size_t> counts(DIGITS * 256);
+    std::fill(counts.begin(), counts.end(), std::size_t(0));
+
+    auto prevKey = tms_radix_key(arr[0]);
+    bool sorted = true;
+    for (const Valtype & v : arr)
+    {
+        auto key = tms_radix_key(v);
+        sorted = sorted && !(key < prevKey);
+        prevKey = key;
+        for (std::size_t d = 0; d < DIGITS; ++d)
+            ++counts[d * 256 + ((key >> (8 * d)) & 0xFF)];
+    }
+    if (sorted)
+        return;     // already in key order: no pass needed
+
+    Valtype * src = arr.begin();
+    Valtype * dst = scratch.begin();
+    bool inScratch = false;
+    for (std::size_t d = 0; d < DIGITS; ++d)
+    {
+        std::size_t * count = counts.begin() + d * 256;
+        if (count[(tms_radix_key(src[0]) >> (8 * d)) & 0xFF] == n)
+            continue;   // every key has this digit: pass is a no-op
+
+        std::size_t offset[256];
+        std::size_t sum = 0;
+        for (std::size_t b = 0; b < 256; ++b)
+        {
+            offset[b] = sum;
+            sum += count[b];
+        }
+        for (std::size_t i = 0; i < n; ++i)
+            dst[offset[(tms_radix_key(src[i]) >> (8 * d)) & 0xFF]++] = src[i];
+
+        std::swap(src, dst);
+        inScratch = !inScratch;
+    }
+
+    if (inScratch)
+        arr.swap(scratch);
+}
+
+
+
+// *********************************************************************
+// Parallel merge sort
+// *********************************************************************
+
+
+// tms_merge_split
+// No-Throw Guarantee (if comp does not throw)
+// Pre:
+//      a[0..na), b[0..nb) sorted by comp; 0 <= k <= na + nb
+// Post:
+//      Returns i such that the first k outputs of a stable merge are
+//      a[0..i) and b[0..k-i) (merge-path co-ranking)
+template <typename Valtype, typename Compare>
+std::size_t tms_merge_split(const Valtype * a, std::size_t na,
+                            const Valtype * b, std::size_t nb,
+                            std::size_t k, Compare comp)
+{
+    std::size_t lo = k > nb ? k - nb : 0;
+    std::size_t hi = std::min(k, na);
+    while (lo < hi)
+    {
+        std::size_t i = lo + (hi - lo) / 2;  // candidate: take a[0..i]
+        // a[i] belongs in the first k iff it is not after b[k-i-1]
+        if (!comp(b[k - i - 1], a[i]))
+            lo = i + 1;
+        else
+            hi = i;
+    }
+    return lo;
+}
+
+
+// tms_merge_into
+// Stable merge of a and b into out (ties taken from a first)
+template <typename Valtype, typename Compare>
+void tms_merge_into(Valtype * a, std::size_t na, Valtype * b,
+                    std::size_t nb, Valtype * out, Compare comp)
+{
+    std::size_t i = 0, j = 0, k = 0;
+    while (i < na && j < nb)
+        out[k++] = comp(b[j], a[i]) ? std::move(b[j++]) : std::move(a[i++]);
+    out = std::move(a + i, a + na, out + k);
+    std::move(b + j, b + nb, out);
+}
+
+
+// tms_parallel_merge
+// Merge of a and b into out, output split evenly over pool by co-rank.
+//  All splits are found before any element is moved, since a search
+//  must not read an element another thread has already moved from.
+template <typename Valtype, typename Compare>
+void tms_parallel_merge(Valtype * a, std::size_t na, Valtype * b,
+                        std::size_t nb, Valtype * out, Compare comp,
+                        TMSThreadPool & pool)
+{
+    const std::size_t total = na + nb;
+    const std::size_t parts = pool.size();
+    TMSArray<std::size_t> splits(parts + 1);
+    for (std::size_t t = 0; t < parts; ++t)
+        splits[t] = tms_merge_split(a, na, b, nb,
+                                    tms_chunk(total, t, parts).first, comp);
+    splits[parts] = na;
+
+    pool.run([&](std::size_t tid, std::size_t count)
+    {
+        auto range = tms_chunk(total, tid, count);
+        std::size_t i0 = splits[tid];
+        std::size_t i1 = splits[tid + 1];
+        std::size_t j0 = range.first - i0;
+        std::size_t j1 = range.second - i1;
+        tms_merge_into(a + i0, i1 - i0, b + j0, j1 - j0, out + range.first,
+                       comp);
+    });
+}
+
+
+// tms_merge_sort
+// Basic Guarantee
+// Exception-Neutral
+// Pre:
+//      comp is a strict weak order; Valtype move-assignable and safe to
+//      move concurrently on distinct objects
+// Post:
+//      arr sorted by comp (not stable). Each pool thread std::sorts one
+//      chunk; chunks are then merged pairwise, every merge split over
+//      all threads by merge-path co-ranking. One TMSArray of the same
+//      size is the ping-pong scratch.
+template <typename Valtype, typename Compare = std::less<Valtype>>
+void tms_merge_sort(TMSArray<Valtype> & arr, Compare comp = Compare(),
+                    TMSThreadPool & pool = tms_default_pool())
+{
+    const std::size_t n = arr.size();
+    const std::size_t parts = pool.size();
+    if (parts == 1 || n * sizeof(Valtype) < TMS_PARALLEL_THRESHOLD)
+    {
+        std::sort(arr.begin(), arr.end(), comp);
+        return;
+    }
+
+    // Phase 1: independent chunk sorts
+    TMSArray<std::size_t> bounds(parts + 1);
+    for (std::size_t t = 0; t < parts; ++t)
+        bounds[t] = tms_chunk(n, t, parts).first;
+    bounds[parts] = n;
+    Valtype * data = arr.begin();
+    pool.run([&](std::size_t tid, std::size_t)
+    {
+        std::sort(data + bounds[tid], data + bounds[tid + 1], comp);
+    });
+
+    // Phase 2: pairwise merge rounds, ping-ponging with scratch
+    TMSArray<Valtype> scratch(n);
+    Valtype * src = arr.begin();
+    Valtype * dst = scratch.begin();
+    bool inScratch = false;
+    for (std::size_t width = 1; width < parts; width *= 2)
+    {
+        for (std::size_t left = 0; left < parts; left += 2 * width)
+        {
+            std::size_t mid = std::min(left + width, parts);
+            std::size_t right = std::min(left + 2 * width, parts);
+            std::size_t a0 = bounds[left], a1 = bounds[mid],
+                        b1 = bounds[right];
+            if (mid == right)
+                std::move(src + a0, src + a1, dst + a0);  // odd one out
+            else
+                tms_parallel_merge(src + a0, a1 - a0, src + a1, b1 - a1,
+                                   dst + a0, comp, pool);
+        }
+        std::swap(src, dst);
+        inScratch = !inScratch;
+    }
+
+    if (inScratch)
+        arr.swap(scratch);
+}
+
+
+// tms_sort
+// Basic Guarantee
+// Exception-Neutral
+// Pre:
+//      Valtype has operator<
+// Post:
+//      arr sorted ascending: arithmetic types by tms_radix_sort, others
+//      by tms_merge_sort with std::less
+template <typename Valtype>
+void tms_sort(TMSArray<Valtype> & arr,
+              TMSThreadPool & pool = tms_default_pool())
+{
+    if constexpr (std::is_arithmetic<Valtype>::value)
+    {
+        (void)pool;
+        tms_radix_sort(arr);
+    }
+    else
+        tms_merge_sort(arr, std::less<Valtype>(), pool);
+}
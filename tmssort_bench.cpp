@@ -0,0 +1,125 @@
+// tmssort_bench.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Benchmark: tms_radix_sort and tms_merge_sort vs. std::sort, for sizes
+//  from 1K elements up to the given maximum (x32 steps), on uniform
+//  random, already sorted and few-distinct-values inputs.
+// Usage: tmssort_bench [max elements=16777216] [threads=hardware]
+//  (pass 1073741824 for the 1B-element row if memory allows)
+// Requires tmssort.hpp, tmsparallel.hpp, tmsarray.hpp, tmsbench.hpp
+
+#include "tmssort.hpp"
+#include "tmsbench.hpp"
+
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::uint32_t;
+using std::uint64_t;
+using std::int32_t;
+#include <algorithm>
+using std::sort;
+#include <chrono>
+#include <functional>
+using std::greater;
+#include <iostream>
+using std::cout;
+#include <string>
+using std::string;
+
+
+// timeSort
+// Best of reps runs of sorter on a fresh copy of input; only the sort
+//  itself is timed
+template <typename T, typename Sorter>
+double timeSort(const TMSArray<T> & input, int reps, Sorter sorter)
+{
+    double best = 0.0;
+    for (int rep = 0; rep < reps; ++rep)
+    {
+        TMSArray<T> work(input);
+        auto start = std::chrono::steady_clock::now();
+        sorter(work);
+        double secs = tms_seconds_since(start);
+        tms_sink(work[0]);
+        if (rep == 0 || secs < best)
+            best = secs;
+    }
+    return best;
+}
+
+
+// fillInput
+// "random", "sorted" or "few" (16 distinct values)
+template <typename T>
+void fillInput(TMSArray<T> & ta, const string & kind)
+{
+    uint64_t x = 88172645463325252ull;
+    for (size_t i = 0; i < ta.size(); ++i)
+    {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        if (kind == "sorted")
+            ta[i] = T(i);
+        else if (kind == "few")
+            ta[i] = T(x % 16);
+        else
+            ta[i] = T(int64_t(x >> 33) - (int64_t(1) << 30));
+    }
+}
+
+
+// benchType
+// One table per element type
+template <typename T>
+void benchType(const string & name, size_t maxN, TMSThreadPool & pool)
+{
+    for (const string kind : { "random", "sorted", "few" })
+    {
+        cout << "\n== TMSArray<" << name << ">, " << kind << " ==\n";
+        for (size_t n = 1024; n <= maxN; n *= 32)
+        {
+            TMSArray<T> input(n);
+            fillInput(input, kind);
+            const size_t bytes = n * sizeof(T);
+            const int reps = n <= (size_t(1) << 20) ? 5 : 2;
+            string size = std::to_string(n);
+
+            double secs = timeSort(input, reps, [](TMSArray<T> & ta)
+            {
+                sort(ta.begin(), ta.end());
+            });
+            tms_report("std::sort " + size, secs, bytes);
+            secs = timeSort(input, reps, [](TMSArray<T> & ta)
+            {
+                tms_radix_sort(ta);
+            });
+            tms_report("tms_radix_sort " + size, secs, bytes);
+            secs = timeSort(input, reps, [](TMSArray<T> & ta)
+            {
+                sort(ta.begin(), ta.end(), greater<T>());
+            });
+            tms_report("std::sort greater " + size, secs, bytes);
+            secs = timeSort(input, reps, [&](TMSArray<T> & ta)
+            {
+                tms_merge_sort(ta, greater<T>(), pool);
+            });
+            tms_report("tms_merge_sort greater " + size, secs, bytes);
+        }
+    }
+}
+
+
+int main(int argc, char * argv[])
+{
+    const size_t maxN = tms_arg(argc, argv, 1, size_t(1) << 24);
+    TMSThreadPool pool(tms_arg(argc, argv, 2, 0));
+    cout << "threads: " << pool.size() << "\n";
+    benchType<int32_t>("int", maxN, pool);
+    benchType<uint64_t>("uint64_t", maxN, pool);
+    benchType<float>("float", maxN, pool);
+    benchType<double>("double", maxN, pool);
+    return 0;
+}
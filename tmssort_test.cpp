@@ -0,0 +1,304 @@
+// tmssort_test.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Test program for tms_sort, tms_radix_sort, tms_merge_sort,
+//  tms_network16
+// Uses the "doctest" unit-testing framework, version 2
+// Requires doctest.h, tmssort.hpp, tmsparallel.hpp, tmsarray.hpp
+
+// Includes for code to be tested
+#include "tmssort.hpp"       // For tms_sort, tms_radix_sort, ...
+#include "tmssort.hpp"       // Double-inclusion check, for testing only
+
+// Includes for the "doctest" unit-testing framework
+#define DOCTEST_CONFIG_IMPLEMENT
+                             // We write our own main
+#define DOCTEST_CONFIG_SUPER_FAST_ASSERTS
+                             // Reduce compile time
+#include "doctest.h"         // For doctest
+
+// Includes for all test programs
+#include <iostream>
+using std::cout;
+using std::endl;
+using std::cin;
+#include <string>
+using std::string;
+
+// Additional includes for this test program
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::int8_t;
+using std::int32_t;
+using std::int64_t;
+using std::uint16_t;
+using std::uint32_t;
+using std::uint64_t;
+#include <algorithm>
+using std::sort;
+using std::equal;
+using std::is_sorted;
+#include <functional>
+using std::greater;
+#include <limits>
+using std::numeric_limits;
+
+// Printable name for this test suite
+const string test_suite_name =
+    "TMSArray sorting";
+
+
+// *********************************************************************
+// Helper Functions for This Test Program
+// *********************************************************************
+
+
+// fillPattern
+// Deterministic pseudo-random contents over the full range of T, both
+//  signs
+template <typename T>
+void fillPattern(TMSArray<T> & ta, unsigned seed)
+{
+    uint64_t x = seed * 0x9E3779B97F4A7C15ull + 1;
+    for (size_t i = 0; i < ta.size(); ++i)
+    {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        if (numeric_limits<T>::is_integer)
+            ta[i] = T(x);
+        else
+            ta[i] = T(double(int64_t(x >> 11) - (int64_t(1) << 52)) / 1e6);
+    }
+}
+
+
+// checkAgainstStd
+// sorter(ta) must agree with std::sort on the same data
+template <typename T, typename Sorter>
+void checkAgainstStd(Sorter sorter)
+{
+    for (size_t size : { 0, 1, 2, 15, 16, 17, 255, 256, 1000, 100001 })
+    {
+        INFO( "size " << size );
+        TMSArray<T> ta(size);
+        fillPattern(ta, unsigned(size));
+        TMSArray<T> expect(ta);
+        sort(expect.begin(), expect.end());
+        sorter(ta);
+        REQUIRE( ta.size() == size );
+        REQUIRE( equal(ta.begin(), ta.end(), expect.begin()) );
+    }
+}
+
+
+// *********************************************************************
+// Test Cases
+// *********************************************************************
+
+
+TEST_CASE( "Sorting network" )
+{
+    SUBCASE( "Sorts every 0-1 input of length 16" )
+    {
+        // 0-1 principle: a network sorting all 2^16 bit patterns sorts
+        //  everything
+        bool allSorted = true;
+        for (uint32_t bits = 0; bits < (1u << 16); ++bits)
+        {
+            int v[16];
+            for (int i = 0; i < 16; ++i)
+                v[i] = (bits >> i) & 1;
+            tms_network16(v, std::less<int>());
+            allSorted = allSorted && is_sorted(v, v + 16);
+        }
+        REQUIRE( allSorted );
+    }
+
+    SUBCASE( "tms_sort_small pads short inputs" )
+    {
+        for (size_t n = 0; n <= 20; ++n)
+        {
+            INFO( "n " << n );
+            int v[20];
+            for (size_t i = 0; i < n; ++i)
+                v[i] = int((i * 7919) % 13) - 6;
+            tms_sort_small(v, n, greater<int>());
+            REQUIRE( is_sorted(v, v + n, greater<int>()) );
+        }
+    }
+}
+
+
+TEST_CASE( "Radix sort" )
+{
+    auto radix = [](auto & ta) { tms_radix_sort(ta); };
+
+    SUBCASE( "int8_t" )   { checkAgainstStd<int8_t>(radix); }
+    SUBCASE( "uint16_t" ) { checkAgainstStd<uint16_t>(radix); }
+    SUBCASE( "int" )      { checkAgainstStd<int32_t>(radix); }
+    SUBCASE( "uint32_t" ) { checkAgainstStd<uint32_t>(radix); }
+    SUBCASE( "int64_t" )  { checkAgainstStd<int64_t>(radix); }
+    SUBCASE( "uint64_t" ) { checkAgainstStd<uint64_t>(radix); }
+    SUBCASE( "float" )    { checkAgainstStd<float>(radix); }
+    SUBCASE( "double" )   { checkAgainstStd<double>(radix); }
+
+    SUBCASE( "Float keys order negatives, zero, infinities" )
+    {
+        const float inf = numeric_limits<float>::infinity();
+        TMSArray<float> tf(300);
+        for (size_t i = 0; i < tf.size(); ++i)
+        {
+            const float vals[] = { 2.5f, -inf, -1.0f, 0.0f, inf, -3.5f,
+                                   1e-30f, -1e-30f };
+            tf[i] = vals[i % 8];
+        }
+        tms_radix_sort(tf);
+        REQUIRE( is_sorted(tf.begin(), tf.end()) );
+        REQUIRE( tf[0] == -inf );
+        REQUIRE( tf[tf.size() - 1] == inf );
+    }
+
+    SUBCASE( "Skipped passes: small values in wide type" )
+    {
+        TMSArray<uint64_t> tu(5000);
+        for (size_t i = 0; i < tu.size(); ++i)
+            tu[i] = (i * 37) % 251;
+        tms_radix_sort(tu);
+        REQUIRE( is_sorted(tu.begin(), tu.end()) );
+        REQUIRE( tu[0] == 0 );
+        REQUIRE( tu[tu.size() - 1] == 250 );
+    }
+
+    SUBCASE( "Sorted and nearly sorted input" )
+    {
+        TMSArray<int> ti(1000);
+        for (size_t i = 0; i < ti.size(); ++i)
+            ti[i] = int(i) - 500;
+        tms_radix_sort(ti);
+        REQUIRE( ti[0] == -500 );
+        REQUIRE( is_sorted(ti.begin(), ti.end()) );
+        std::swap(ti[10], ti[990]);
+        tms_radix_sort(ti);
+        REQUIRE( ti[10] == -490 );
+        REQUIRE( is_sorted(ti.begin(), ti.end()) );
+    }
+
+    SUBCASE( "All equal" )
+    {
+        TMSArray<int> ti(1000);
+        for (auto & x : ti)
+            x = -7;
+        tms_radix_sort(ti);
+        REQUIRE( ti[0] == -7 );
+        REQUIRE( ti[999] == -7 );
+    }
+}
+
+
+TEST_CASE( "Parallel merge sort" )
+{
+    SUBCASE( "Agrees with std::sort across thread counts" )
+    {
+        for (size_t threads : { 1, 2, 3, 4, 7 })
+        {
+            INFO( "threads " << threads );
+            TMSThreadPool pool(threads);
+            // 2M doubles: above TMS_PARALLEL_THRESHOLD
+            TMSArray<double> td(size_t(1) << 21);
+            fillPattern(td, unsigned(threads));
+            TMSArray<double> expect(td);
+            sort(expect.begin(), expect.end(), greater<double>());
+            tms_merge_sort(td, greater<double>(), pool);
+            REQUIRE( equal(td.begin(), td.end(), expect.begin()) );
+        }
+    }
+
+    SUBCASE( "Non-arithmetic elements, many duplicates" )
+    {
+        TMSThreadPool pool(4);
+        TMSArray<string> ts(300000);
+        for (size_t i = 0; i < ts.size(); ++i)
+            ts[i] = std::to_string((i * 7919) % 1000);
+        TMSArray<string> expect(ts);
+        sort(expect.begin(), expect.end());
+        tms_merge_sort(ts, std::less<string>(), pool);
+        REQUIRE( equal(ts.begin(), ts.end(), expect.begin()) );
+    }
+
+    SUBCASE( "Merge split co-ranks" )
+    {
+        const int a[] = { 1, 3, 3, 5 };
+        const int b[] = { 2, 3, 4 };
+        auto cmp = std::less<int>();
+        REQUIRE( tms_merge_split(a, 4, b, 3, 0, cmp) == 0 );
+        REQUIRE( tms_merge_split(a, 4, b, 3, 1, cmp) == 1 );
+        REQUIRE( tms_merge_split(a, 4, b, 3, 4, cmp) == 3 );  // 1 2 3 3
+        REQUIRE( tms_merge_split(a, 4, b, 3, 7, cmp) == 4 );
+    }
+}
+
+
+TEST_CASE( "tms_sort front end" )
+{
+    auto front = [](auto & ta) { tms_sort(ta); };
+
+    SUBCASE( "int" )    { checkAgainstStd<int32_t>(front); }
+    SUBCASE( "double" ) { checkAgainstStd<double>(front); }
+
+    SUBCASE( "string" )
+    {
+        TMSArray<string> ts(1000);
+        for (size_t i = 0; i < ts.size(); ++i)
+            ts[i] = std::to_string((i * 31) % 997);
+        tms_sort(ts);
+        REQUIRE( is_sorted(ts.begin(), ts.end()) );
+    }
+}
+
+
+// *********************************************************************
+// Main Program
+// *********************************************************************
+
+
+// userPause
+// Wait for user to press ENTER: read all chars through first newline.
+void userPause()
+{
+    std::cout.flush();
+    while (std::cin.get() != '\n') ;
+}
+
+
+// Main program
+// Run all tests. Prompt for ENTER before exiting.
+int main(int argc,
+         char *argv[])
+{
+    doctest::Context dtcontext;
+                             // Primary doctest object
+    int dtresult;            // doctest return code; for return by main
+
+    // Handle command line
+    dtcontext.applyCommandLine(argc, argv);
+    dtresult = 0;            // doctest flags no command-line errors
+                             //  (strange but true)
+
+    if (!dtresult)           // Continue only if no command-line error
+    {
+        // Run test suites
+        cout << "BEGIN tests for " << test_suite_name << "\n" << endl;
+        dtresult = dtcontext.run();
+        cout << "END tests for " << test_suite_name << "\n" << endl;
+    }
+
+    // Wait for user
+    std::cout << "Press ENTER to quit ";
+    userPause();
+
+    // Program return value is return code from doctest
+    return dtresult;
+}
@@ -0,0 +1,469 @@
+// tmssorted.hpp
+// Matthew Johnson
+// 10/17/2026
+// sorted TMSArray wrapper: bulk merge insert, branchless and Eytzinger
+//  binary search
+
+#pragma once
+// for single inclusion
+
+#include "tmsarray.hpp"
+// For class template TMSArray
+
+#include <cstddef>
+// For std::size_t
+
+#include <algorithm>
+// For std::sort
+// For std::min
+// For std::move_backward
+
+#include <functional>
+// For std::less
+
+
+
+// Cache line size assumed for search prefetching
+constexpr std::size_t TMS_CACHE_LINE = 64;
+
+
+// Layouts a TMSSortedArray can keep for its searches
+enum TMSSortedLayout
+{
+    TMS_LAYOUT_FLAT,        // search the sorted array directly
+    TMS_LAYOUT_EYTZINGER    // plus a BFS-order copy for read-mostly use
+};
+
+
+
+// *********************************************************************
+// Search kernels
+// *********************************************************************
+
+
+// tms_partition_point
+// No-Throw Guarantee (if pred does not throw)
+// Pre:
+//      pred is true on a (possibly empty) prefix of [first, first + n)
+//      and false on the rest
+// Post:
+//      Returns length of that prefix. The loop has a fixed trip count
+//      (ceil(log2 n)) and the step is a conditional move, so there is
+//      no mispredicted branch; both possible next probes are prefetched.
+template <typename Valtype, typename Pred>
+std::size_t tms_partition_point(const Valtype * first, std::size_t n,
+                                Pred pred)
+{
+    if (n == 0)
+        return 0;
+    const Valtype * base = first;
+    while (n > 1)
+    {
+        std::size_t half = n / 2;
+        __builtin_prefetch(base + half / 2);
+        __builtin_prefetch(base + half + half / 2);
+        base = pred(base[half]) ? base + half : base;
+        n -= half;
+    }
+    return std::size_t(base - first) + (pred(*base) ? 1 : 0);
+}
+
+
+// tms_eytzinger_fill
+// Writes sorted[next..] into eytz in BFS order of the implicit tree
+//  rooted at node k (children 2k, 2k+1)
+template <typename Valtype>
+void tms_eytzinger_fill(const Valtype * sorted, std::size_t n,
+                        Valtype * eytz, std::size_t & next, std::size_t k)
+{
+    if (k > n)
+        return;
+    tms_eytzinger_fill(sorted, n, eytz, next, 2 * k);
+    eytz[k] = sorted[next++];
+    tms_eytzinger_fill(sorted, n, eytz, next, 2 * k + 1);
+}
+
+
+// tms_eytzinger_rank
+// No-Throw Guarantee
+// Pre:
+//      1 <= k <= n
+// Post:
+//      Returns the sorted index of Eytzinger node k of n. Node k's
+//      in-order rank r in the perfect tree of the same height, minus
+//      the absent last-level leaves (which hold the even ranks) before r.
+//      Pure arithmetic, so it costs no memory access.
+inline std::size_t tms_eytzinger_rank(std::size_t k, std::size_t n) noexcept
+{
+    const int height = 64 - __builtin_clzll(n);     // levels in the tree
+    const int depth = 63 - __builtin_clzll(k);
+    const std::size_t pos = k - (std::size_t(1) << depth);
+    const std::size_t r = ((2 * pos + 1) << (height - 1 - depth)) - 1;
+    const std::size_t leaves = n - ((std::size_t(1) << (height - 1)) - 1);
+    const std::size_t evensBefore = (r + 1) / 2;
+    return evensBefore > leaves ? r - (evensBefore - leaves) : r;
+}
+
+
+// tms_eytzinger_partition_point
+// No-Throw Guarantee (if pred does not throw)
+// Pre:
+//      eytz[1..n] is the Eytzinger layout of a sorted range on which
+//      pred is true then false
+// Post:
+//      Returns the sorted-order partition point (n if pred always true).
+//      The descent is branch-free, and the node 4 levels down (one cache
+//      line of descendants for 4-byte keys) is prefetched every step.
+template <typename Valtype, typename Pred>
+std::size_t tms_eytzinger_partition_point(const Valtype * eytz,
+                                          std::size_t n, Pred pred)
+{
+    constexpr std::size_t LINE = sizeof(Valtype) >= TMS_CACHE_LINE ? 1
+                                 : TMS_CACHE_LINE / sizeof(Valtype);
+    std::size_t k = 1;
+    while (k <= n)
+    {
+        __builtin_prefetch(eytz + std::min(k * LINE, n));
+        k = 2 * k + (pred(eytz[k]) ? 1 : 0);
+    }
+    // Undo the trailing right turns (1 bits) and the final left turn
+    k >>= __builtin_ffsll(static_cast<long long>(~k));
+    return k == 0 ? n : tms_eytzinger_rank(k, n);
+}
+
+
+
+// *********************************************************************
+// class TMSSortedArray - Class definition
+// *********************************************************************
+
+
+// class TMSSortedArray
+// TMSArray kept in comp order. Searches are branchless; with
+//  TMS_LAYOUT_EYTZINGER a BFS-ordered copy is kept as well, so the top of the search tree shares a few hot cache lines.
+//  That copy is rebuilt after every mutation, so it suits read-mostly
+//  arrays. Bulk insert sorts the new items and merges them in from the
+//  back in one O(n + m) pass.
+// Requirements on Types:
+//     Valtype must be default-constructible and copy-assignable.
+//     Compare is a strict weak order on Valtype.
+// Invariants:
+//     _data is sorted by _comp.
+//     _layout == TMS_LAYOUT_EYTZINGER ==> _eytz.size() == _data.size()
+//      + 1 and holds the layout of _data.
+template <typename Valtype, typename Compare = std::less<Valtype>>
+class TMSSortedArray
+{
+
+public:
+
+
+    using value_type = Valtype;
+
+    using size_type  = std::size_t;
+
+    using const_iterator = const value_type *;
+
+
+// ***** TMSSortedArray: ctors, dctor *****
+public:
+
+
+    // Default ctor / ctor from comparator
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      empty(), layout() == TMS_LAYOUT_FLAT
+    explicit TMSSortedArray(Compare comp = Compare())
+        :_data(0),
+         _comp(comp),
+         _layout(TMS_LAYOUT_FLAT),
+         _eytz(0)
+    {}
+
+
+    // Ctor from unsorted items
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      holds a sorted copy of items
+    explicit TMSSortedArray(const TMSArray<value_type> & items,
+                            Compare comp = Compare())
+        :_data(items),
+         _comp(comp),
+         _layout(TMS_LAYOUT_FLAT),
+         _eytz(0)
+    {
+        std::sort(_data.begin(), _data.end(), _comp);
+    }
+
+
+// ***** TMSSortedArray: general public functions *****
+public:
+
+
+    // size
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns number of items
+    size_type size() const noexcept
+    {
+        return _data.size();
+    }
+
+
+    // empty
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns true if there are no items
+    bool empty() const noexcept
+    {
+        return _data.empty();
+    }
+
+
+    // operator[]
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre:
+    //      0 <= index < size()
+    // Post:
+    //      Returns the index-th smallest item
+    const value_type & operator[](size_type index) const
+    {
+        return _data[index];
+    }
+
+
+    // begin, end
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Iterators over the items in sorted order
+    const_iterator begin() const noexcept
+    {
+        return _data.begin();
+    }
+
+    const_iterator end() const noexcept
+    {
+        return _data.end();
+    }
+
+
+    // array
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns the underlying sorted TMSArray
+    const TMSArray<value_type> & array() const noexcept
+    {
+        return _data;
+    }
+
+
+    // layout
+    // No-Throw Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns the current search layout
+    TMSSortedLayout layout() const noexcept
+    {
+        return _layout;
+    }
+
+
+    // set_layout
+    // Strong Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      layout() == layout; for TMS_LAYOUT_EYTZINGER the BFS copy is
+    //      built now, for TMS_LAYOUT_FLAT it is freed
+    void set_layout(TMSSortedLayout layout)
+    {
+        if (layout == TMS_LAYOUT_EYTZINGER)
+            buildEytzinger();
+        else
+            TMSArray<value_type>(0).swap(_eytz);
+        _layout = layout;
+    }
+
+
+// ***** TMSSortedArray: search functions *****
+public:
+
+
+    // lower_bound
+    // No-Throw Guarantee (if _comp does not throw)
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns index of first item not less than key (size() if none)
+    size_type lower_bound(const value_type & key) const
+    {
+        auto before = [&](const value_type & x) { return _comp(x, key); };
+        return search(before);
+    }
+
+
+    // upper_bound
+    // No-Throw Guarantee (if _comp does not throw)
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns index of first item greater than key (size() if none)
+    size_type upper_bound(const value_type & key) const
+    {
+        auto before = [&](const value_type & x) { return !_comp(key, x); };
+        return search(before);
+    }
+
+
+    // contains
+    // No-Throw Guarantee (if _comp does not throw)
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns true if an item equivalent to key is present
+    bool contains(const value_type & key) const
+    {
+        size_type pos = lower_bound(key);
+        return pos != size() && !_comp(key, _data[pos]);
+    }
+
+
+    // count
+    // No-Throw Guarantee (if _comp does not throw)
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Returns number of items equivalent to key
+    size_type count(const value_type & key) const
+    {
+        return upper_bound(key) - lower_bound(key);
+    }
+
+
+// ***** TMSSortedArray: modifiers *****
+public:
+
+
+    // insert (single item)
+    // Strong Guarantee (flat layout); Basic Guarantee (Eytzinger)
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      item inserted after any equivalent items; returns its index
+    size_type insert(const value_type & item)
+    {
+        size_type pos = upper_bound(item);
+        _data.insert(_data.begin() + pos, item);
+        refresh();
+        return pos;
+    }
+
+
+    // insert (bulk)
+    // Basic Guarantee
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      every item of items inserted, in O(n + m log m): items are
+    //      sorted in a scratch copy, _data grows once, and the two runs
+    //      are merged from the back so nothing is moved twice
+    void insert(const TMSArray<value_type> & items)
+    {
+        if (items.empty())
+            return;
+        TMSArray<value_type> incoming(items);
+        std::sort(incoming.begin(), incoming.end(), _comp);
+
+        const size_type oldSize = _data.size();
+        _data.resize(oldSize + incoming.size());
+        value_type * out = _data.end();
+        value_type * a = _data.begin() + oldSize;  // one past old run
+        value_type * b = incoming.end();
+        while (b != incoming.begin())
+        {
+            if (a != _data.begin() && _comp(*(b - 1), *(a - 1)))
+                *--out = std::move(*--a);
+            else
+                *--out = std::move(*--b);
+            // old items at [begin, a) are already in place
+        }
+        refresh();
+    }
+
+
+    // erase
+    // Strong Guarantee (flat layout); Basic Guarantee (Eytzinger)
+    // Exception-Neutral
+    // Pre: None
+    // Post:
+    //      Removes one item equivalent to key; returns false if none
+    bool erase(const value_type & key)
+    {
+        size_type pos = lower_bound(key);
+        if (pos == size() || _comp(key, _data[pos]))
+            return false;
+        _data.erase(_data.begin() + pos);
+        refresh();
+        return true;
+    }
+
+
+// ***** TMSSortedArray: private helpers *****
+private:
+
+
+    // search
+    // Partition point of before over _data, by the current layout
+    template <typename Pred>
+    size_type search(Pred before) const
+    {
+        if (_layout == TMS_LAYOUT_EYTZINGER)
+            return tms_eytzinger_partition_point(_eytz.begin(), size(),
+                                                 before);
+        return tms_partition_point(_data.begin(), size(), before);
+    }
+
+
+    // buildEytzinger
+    // Strong Guarantee: builds into locals, then swaps in
+    void buildEytzinger()
+    {
+        TMSArray<value_type> eytz(size() + 1);
+        size_type next = 0;
+        tms_eytzinger_fill(_data.begin(), size(), eytz.begin(), next, 1);
+        _eytz.swap(eytz);
+    }
+
+
+    // refresh
+    // Rebuilds the Eytzinger copy after a mutation, if one is kept
+    void refresh()
+    {
+        if (_layout == TMS_LAYOUT_EYTZINGER)
+            buildEytzinger();
+    }
+
+
+// ***** TMSSortedArray: data members *****
+private:
+
+    TMSArray<value_type> _data;
+    Compare              _comp;
+    TMSSortedLayout      _layout;
+    TMSArray<value_type> _eytz;     // 1-based BFS order; [0] unused
+
+}; // end of class
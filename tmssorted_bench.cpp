@@ -0,0 +1,91 @@
+// tmssorted_bench.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Benchmark: random lower_bound queries on TMSSortedArray<int> (flat
+//  branchless and Eytzinger layouts) vs. std::lower_bound, at array
+//  sizes that fit L1, L2, L3 and only DRAM.
+// Usage: tmssorted_bench [queries=1000000] [DRAM elements=16777216]
+// Requires tmssorted.hpp, tmsarray.hpp, tmsbench.hpp
+
+#include "tmssorted.hpp"
+#include "tmsbench.hpp"
+
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::uint64_t;
+#include <algorithm>
+#include <iostream>
+using std::cout;
+#include <string>
+using std::string;
+
+
+// benchSize
+// One table: q queries against n elements
+void benchSize(const string & level, size_t n, size_t q)
+{
+    TMSArray<int> items(n);
+    for (size_t i = 0; i < n; ++i)
+        items[i] = int(2 * i);
+    TMSSortedArray<int> flat(items);
+    TMSSortedArray<int> eytz(items);
+    eytz.set_layout(TMS_LAYOUT_EYTZINGER);
+
+    TMSArray<int> keys(q);
+    uint64_t x = 0x2545F4914F6CDD1Dull;
+    for (size_t i = 0; i < q; ++i)
+    {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        keys[i] = int(x % (2 * n));
+    }
+
+    cout << "\n== " << level << ": " << n << " ints (" << n * sizeof(int) / 1024
+         << " KiB), " << q << " queries ==\n";
+
+    double secs = tms_time_best(3, [&]
+    {
+        size_t acc = 0;
+        for (int key : keys)
+            acc += std::lower_bound(items.begin(), items.end(), key)
+                   - items.begin();
+        tms_sink(acc);
+    });
+    tms_report("std::lower_bound", secs);
+    tms_report("  per query", secs / double(q));
+
+    secs = tms_time_best(3, [&]
+    {
+        size_t acc = 0;
+        for (int key : keys)
+            acc += flat.lower_bound(key);
+        tms_sink(acc);
+    });
+    tms_report("branchless + prefetch", secs);
+    tms_report("  per query", secs / double(q));
+
+    secs = tms_time_best(3, [&]
+    {
+        size_t acc = 0;
+        for (int key : keys)
+            acc += eytz.lower_bound(key);
+        tms_sink(acc);
+    });
+    tms_report("Eytzinger + prefetch", secs);
+    tms_report("  per query", secs / double(q));
+}
+
+
+int main(int argc, char * argv[])
+{
+    const size_t q = tms_arg(argc, argv, 1, 1000000);
+    const size_t dram = tms_arg(argc, argv, 2, size_t(1) << 24);
+    benchSize("L1", 4096, q);
+    benchSize("L2", 65536, q);
+    benchSize("L3", 1048576, q);
+    benchSize("DRAM", dram, q);
+    return 0;
+}
@@ -0,0 +1,260 @@
+// tmssorted_test.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Test program for class template TMSSortedArray, tms_partition_point,
+//  tms_eytzinger_fill, tms_eytzinger_rank
+// Uses the "doctest" unit-testing framework, version 2
+// Requires doctest.h, tmssorted.hpp, tmsarray.hpp
+
+// Includes for code to be tested
+#include "tmssorted.hpp"     // For class template TMSSortedArray
+#include "tmssorted.hpp"     // Double-inclusion check, for testing only
+
+// Includes for the "doctest" unit-testing framework
+#define DOCTEST_CONFIG_IMPLEMENT
+                             // We write our own main
+#define DOCTEST_CONFIG_SUPER_FAST_ASSERTS
+                             // Reduce compile time
+#include "doctest.h"         // For doctest
+
+// Includes for all test programs
+#include <iostream>
+using std::cout;
+using std::endl;
+using std::cin;
+#include <string>
+using std::string;
+
+// Additional includes for this test program
+#include <cstddef>
+using std::size_t;
+#include <algorithm>
+using std::is_sorted;
+using std::sort;
+#include <functional>
+using std::greater;
+#include <vector>
+using std::vector;
+
+// Printable name for this test suite
+const string test_suite_name =
+    "class template TMSSortedArray";
+
+
+// *********************************************************************
+// Helper Functions for This Test Program
+// *********************************************************************
+
+
+// checkSearches
+// Every lower_bound/upper_bound/contains/count on tsa matches the
+//  std:: algorithms on a sorted copy, for keys in and between the items
+void checkSearches(const TMSSortedArray<int> & tsa)
+{
+    vector<int> ref(tsa.begin(), tsa.end());
+    REQUIRE( is_sorted(ref.begin(), ref.end()) );
+    bool allMatch = true;
+    for (int key = -3; key <= 2 * int(ref.size()) + 3; ++key)
+    {
+        size_t lb = std::lower_bound(ref.begin(), ref.end(), key)
+                    - ref.begin();
+        size_t ub = std::upper_bound(ref.begin(), ref.end(), key)
+                    - ref.begin();
+        allMatch = allMatch
+                   && tsa.lower_bound(key) == lb
+                   && tsa.upper_bound(key) == ub
+                   && tsa.count(key) == ub - lb
+                   && tsa.contains(key) == (ub != lb);
+    }
+    REQUIRE( allMatch );
+}
+
+
+// makeEvens
+// TMSSortedArray holding 0, 2, 4, ..., 2(n-1), inserted in scrambled order
+TMSSortedArray<int> makeEvens(size_t n)
+{
+    TMSArray<int> items(n);
+    for (size_t i = 0; i < n; ++i)
+        items[i] = int(2 * ((i * 7919) % n));
+    return TMSSortedArray<int>(items);
+}
+
+
+// *********************************************************************
+// Test Cases
+// *********************************************************************
+
+
+TEST_CASE( "Search kernels" )
+{
+    SUBCASE( "tms_partition_point matches std::partition_point" )
+    {
+        vector<int> v(1000);
+        for (size_t i = 0; i < v.size(); ++i)
+            v[i] = int(i / 3);
+        for (size_t n : { 0, 1, 2, 3, 7, 64, 999, 1000 })
+            for (int key : { -1, 0, 5, 100, 333, 334 })
+            {
+                INFO( "n " << n << " key " << key );
+                auto pred = [key](int x) { return x < key; };
+                REQUIRE( tms_partition_point(v.data(), n, pred)
+                         == size_t(std::partition_point(v.begin(),
+                                                        v.begin() + n, pred)
+                                   - v.begin()) );
+            }
+    }
+}
+
+
+TEST_CASE( "Eytzinger layout" )
+{
+    SUBCASE( "tms_eytzinger_rank inverts tms_eytzinger_fill" )
+    {
+        bool allMatch = true;
+        for (size_t n = 1; n <= 300; ++n)
+        {
+            vector<size_t> sorted(n), eytz(n + 1);
+            for (size_t i = 0; i < n; ++i)
+                sorted[i] = i;
+            size_t next = 0;
+            tms_eytzinger_fill(sorted.data(), n, eytz.data(), next, 1);
+            allMatch = allMatch && next == n;
+            for (size_t k = 1; k <= n; ++k)
+                allMatch = allMatch && tms_eytzinger_rank(k, n) == eytz[k];
+        }
+        REQUIRE( allMatch );
+    }
+}
+
+
+TEST_CASE( "Flat and Eytzinger layouts agree with std::" )
+{
+    for (size_t n : { 0, 1, 2, 3, 4, 5, 7, 8, 15, 16, 17, 100, 1023, 1024,
+                      1025 })
+    {
+        INFO( "n " << n );
+        TMSSortedArray<int> tsa = makeEvens(n);
+        REQUIRE( tsa.size() == n );
+        REQUIRE( tsa.layout() == TMS_LAYOUT_FLAT );
+        checkSearches(tsa);
+        tsa.set_layout(TMS_LAYOUT_EYTZINGER);
+        REQUIRE( tsa.layout() == TMS_LAYOUT_EYTZINGER );
+        checkSearches(tsa);
+        tsa.set_layout(TMS_LAYOUT_FLAT);
+        checkSearches(tsa);
+    }
+}
+
+
+TEST_CASE( "Modifiers keep order" )
+{
+    for (TMSSortedLayout layout : { TMS_LAYOUT_FLAT, TMS_LAYOUT_EYTZINGER })
+    {
+        INFO( "layout " << layout );
+        SUBCASE( "Single insert and erase" )
+        {
+            TMSSortedArray<int> tsa = makeEvens(50);
+            tsa.set_layout(layout);
+            REQUIRE( tsa.insert(7) == 4 );
+            REQUIRE( tsa.insert(-5) == 0 );
+            REQUIRE( tsa.insert(1000) == 52 );
+            REQUIRE( tsa.insert(8) == 7 );      // after the existing 8
+            REQUIRE( tsa.size() == 54 );
+            checkSearches(tsa);
+            REQUIRE( tsa.count(8) == 2 );
+            REQUIRE( tsa.erase(8) );
+            REQUIRE( tsa.count(8) == 1 );
+            REQUIRE( !tsa.erase(9) );
+            REQUIRE( tsa.erase(-5) );
+            REQUIRE( tsa[0] == 0 );
+            checkSearches(tsa);
+        }
+
+        SUBCASE( "Bulk insert merges" )
+        {
+            TMSSortedArray<int> tsa = makeEvens(200);
+            tsa.set_layout(layout);
+            TMSArray<int> more(300);
+            for (size_t i = 0; i < more.size(); ++i)
+                more[i] = int((i * 37) % 450) - 20;
+            tsa.insert(more);
+            REQUIRE( tsa.size() == 500 );
+            checkSearches(tsa);
+
+            TMSSortedArray<int> empty;
+            empty.set_layout(layout);
+            empty.insert(more);
+            REQUIRE( empty.size() == 300 );
+            checkSearches(empty);
+            empty.insert(TMSArray<int>(0));
+            REQUIRE( empty.size() == 300 );
+        }
+    }
+}
+
+
+TEST_CASE( "Custom comparator" )
+{
+    TMSArray<string> items(5);
+    items[0] = "pear";
+    items[1] = "apple";
+    items[2] = "fig";
+    items[3] = "kiwi";
+    items[4] = "date";
+    TMSSortedArray<string, greater<string>> tsa(items);
+    REQUIRE( tsa[0] == "pear" );
+    REQUIRE( tsa[4] == "apple" );
+    tsa.set_layout(TMS_LAYOUT_EYTZINGER);
+    REQUIRE( tsa.lower_bound("grape") == 2 );   // pear kiwi | fig
+    REQUIRE( tsa.contains("fig") );
+    REQUIRE( !tsa.contains("plum") );
+    tsa.insert("zucchini");
+    REQUIRE( tsa.lower_bound("zucchini") == 0 );
+}
+
+
+// *********************************************************************
+// Main Program
+// *********************************************************************
+
+
+// userPause
+// Wait for user to press ENTER: read all chars through first newline.
+void userPause()
+{
+    std::cout.flush();
+    while (std::cin.get() != '\n') ;
+}
+
+
+// Main program
+// Run all tests. Prompt for ENTER before exiting.
+int main(int argc,
+         char *argv[])
+{
+    doctest::Context dtcontext;
+                             // Primary doctest object
+    int dtresult;            // doctest return code; for return by main
+
+    // Handle command line
+    dtcontext.applyCommandLine(argc, argv);
+    dtresult = 0;            // doctest flags no command-line errors
+                             //  (strange but true)
+
+    if (!dtresult)           // Continue only if no command-line error
+    {
+        // Run test suites
+        cout << "BEGIN tests for " << test_suite_name << "\n" << endl;
+        dtresult = dtcontext.run();
+        cout << "END tests for " << test_suite_name << "\n" << endl;
+    }
+
+    // Wait for user
+    std::cout << "Press ENTER to quit ";
+    userPause();
+
+    // Program return value is return code from doctest
+    return dtresult;
+}
@@ -0,0 +1,545 @@
+// tmstext.hpp
+// Matthew Johnson
+// 10/17/2026
+// fast text I/O of numbers for TMSArray: from_chars parsing of CSV or
+//  whitespace-separated text with SIMD delimiter scanning, in parallel
+//  chunks of an mmap'd file; to_chars writing (POSIX)
+
+#pragma once
+// for single inclusion
+
+#include "tmsarray.hpp"
+// For class template TMSArray
+
+#include "tmsparallel.hpp"
+// For class TMSThreadPool
+// For tms_default_pool
+// For tms_chunk
+
+#include "tmsserial.hpp"
+// For class template TMSArrayView
+// For TMSFd
+// For tms_throw_errno
+// For tms_pwritev_all
+
+#include "tmssimd.hpp"
+// For tms_isa_limit
+// For TMS_SIMD_X86
+
+#include <cstddef>
+// For std::size_t
+
+#include <cstdint>
+// For std::uint64_t
+
+#include <cstring>
+// For std::memcpy
+// For std::memset
+// For std::memchr
+
+#include <algorithm>
+// For std::min
+
+#include <charconv>
+// For std::from_chars
+// For std::to_chars
+
+#include <string>
+// For std::string
+// For std::to_string
+
+#include <stdexcept>
+// For std::runtime_error
+// For std::invalid_argument
+
+#include <system_error>
+// For std::errc
+
+#include <type_traits>
+// For std::is_arithmetic
+// For std::is_same
+
+#include <fcntl.h>
+// For open
+
+#include <sys/stat.h>
+// For fstat
+
+#include <sys/uio.h>
+// For struct iovec
+
+
+
+// Inputs smaller than this many bytes are parsed on the calling thread
+constexpr std::size_t TMS_TEXT_PARALLEL_BYTES = std::size_t(1) << 20;
+
+// tms_save_text formats this many values per thread per round
+constexpr std::size_t TMS_TEXT_WRITE_VALUES = std::size_t(1) << 18;
+
+
+
+// *********************************************************************
+// Delimiter scanning
+// *********************************************************************
+
+
+// Text is a sequence of tokens separated by runs of delimiters: space,
+//  tab, CR, LF and one separator character (',' by default). Runs
+//  collapse, so empty fields are skipped, not read as missing values.
+//  Each 64-byte block is turned into a bitmask of delimiter bytes;
+//  token starts are then the non-delimiter bytes whose predecessor is a
+//  delimiter, ~delim & (delim << 1 | carry), and are visited with
+//  count-trailing-zeros without touching the bytes between them.
+
+
+// TMSTextDelims
+// Delimiter set: a byte table for scalar code, sep for the SIMD kernels
+struct TMSTextDelims
+{
+    char sep;
+    bool table[256];
+
+    explicit TMSTextDelims(char separator) noexcept
+        :sep(separator),
+         table()
+    {
+        table[static_cast<unsigned char>(' ')] = true;
+        table[static_cast<unsigned char>('\t')] = true;
+        table[static_cast<unsigned char>('\r')] = true;
+        table[static_cast<unsigned char>('\n')] = true;
+        table[static_cast<unsigned char>(separator)] = true;
+    }
+
+    bool operator()(char c) const noexcept
+    {
+        return table[static_cast<unsigned char>(c)];
+    }
+};
+
+
+// tms_text_mask_scalar
+// Bit i set when p[i] is a delimiter, for i in [0, 64)
+inline std::uint64_t tms_text_mask_scalar(const char * p,
+                                          const TMSTextDelims & d) noexcept
+{
+    std::uint64_t m = 0;
+    for (int i = 0; i < 64; ++i)
+        m |= std::uint64_t(d(p[i])) << i;
+    return m;
+}
+
+
+#ifdef TMS_SIMD_X86
+
+__attribute__((target("sse2")))
+inline std::uint64_t tms_text_mask_sse2(const char * p,
+                                        const TMSTextDelims & d) noexcept
+{
+    const __m128i sp = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i lf = _mm_set1_epi8('\n');
+    const __m128i sep = _mm_set1_epi8(d.sep);
+    std::uint64_t m = 0;
+    for (int k = 0; k < 4; ++k)
+    {
+        const __m128i v = _mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(p + 16 * k));
+        const __m128i e = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(v, sp), _mm_cmpeq_epi8(v, tab)),
+            _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, cr),
+                                      _mm_cmpeq_epi8(v, lf)),
+                         _mm_cmpeq_epi8(v, sep)));
+        m |= std::uint64_t(unsigned(_mm_movemask_epi8(e)) & 0xFFFFu) << (16 * k);
+    }
+    return m;
+}
+
+
+__attribute__((target("avx2")))
+inline std::uint64_t tms_text_mask_avx2(const char * p,
+                                        const TMSTextDelims & d) noexcept
+{
+    const __m256i sp = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i cr = _mm256_set1_epi8('\r');
+    const __m256i lf = _mm256_set1_epi8('\n');
+    const __m256i sep = _mm256_set1_epi8(d.sep);
+    std::uint64_t m = 0;
+    for (int k = 0; k < 2; ++k)
+    {
+        const __m256i v = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i *>(p + 32 * k));
+        const __m256i e = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, sp), _mm256_cmpeq_epi8(v, tab)),
+            _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, cr),
+                                            _mm256_cmpeq_epi8(v, lf)),
+                            _mm256_cmpeq_epi8(v, sep)));
+        m |= std::uint64_t(unsigned(_mm256_movemask_epi8(e))) << (32 * k);
+    }
+    return m;
+}
+
+#endif // TMS_SIMD_X86
+
+
+using TMSTextMaskFn = std::uint64_t (*)(const char *, const TMSTextDelims &);
+
+
+// tms_text_mask_fn
+// No-Throw Guarantee
+// Pre: None
+// Post:
+//      Returns the best delimiter-mask kernel tms_isa_limit() allows
+//      (AVX-512 uses the AVX2 kernel)
+inline TMSTextMaskFn tms_text_mask_fn() noexcept
+{
+#ifdef TMS_SIMD_X86
+    if (tms_isa_limit() >= TMS_ISA_AVX2)
+        return tms_text_mask_avx2;
+    if (tms_isa_limit() >= TMS_ISA_SSE2)
+        return tms_text_mask_sse2;
+#endif
+    return tms_text_mask_scalar;
+}
+
+
+// tms_text_blocks
+// No-Throw Guarantee (if f is)
+// Pre:
+//      lo <= hi <= n
+// Post:
+//      f(pos, starts) called for each 64-byte block from lo on, where
+//      bit i of starts is set when a token starts at pos + i < hi. A
+//      token starts at lo if data[lo - 1] is a delimiter (or lo == 0).
+//      The block that crosses n is copied and padded with spaces, so
+//      nothing past data + n is read.
+template <typename Func>
+void tms_text_blocks(const char * data, std::size_t n, std::size_t lo,
+                     std::size_t hi, const TMSTextDelims & d,
+                     TMSTextMaskFn mask, Func && f)
+{
+    std::uint64_t carry = lo == 0 || d(data[lo - 1]);
+    char tail[64];
+    for (std::size_t pos = lo; pos < hi; pos += 64)
+    {
+        const char * block = data + pos;
+        if (n - pos < 64)
+        {
+            std::memcpy(tail, block, n - pos);
+            std::memset(tail + (n - pos), ' ', 64 - (n - pos));
+            block = tail;
+        }
+        const std::uint64_t delim = mask(block, d);
+        std::uint64_t starts = ~delim & ((delim << 1) | carry);
+        carry = delim >> 63;
+        if (hi - pos < 64)
+            starts &= (std::uint64_t(1) << (hi - pos)) - 1;
+        f(pos, starts);
+    }
+}
+
+
+// tms_text_count
+// No-Throw Guarantee
+// Number of tokens starting in [lo, hi)
+inline std::size_t tms_text_count(const char * data, std::size_t n,
+                                  std::size_t lo, std::size_t hi,
+                                  const TMSTextDelims & d, TMSTextMaskFn mask)
+{
+    std::size_t count = 0;
+    tms_text_blocks(data, n, lo, hi, d, mask,
+                    [&](std::size_t, std::uint64_t starts)
+    {
+        count += std::size_t(__builtin_popcountll(starts));
+    });
+    return count;
+}
+
+
+// tms_text_error
+// Throws std::runtime_error naming the line and the token at data + at
+[[noreturn]] inline void tms_text_error(const char * data, std::size_t n,
+                                        std::size_t at, const TMSTextDelims & d,
+                                        const std::string & what,
+                                        const char * problem)
+{
+    std::size_t line = 1;
+    for (std::size_t i = 0; i < at; ++i)
+        line += data[i] == '\n';
+    std::size_t end = at;
+    while (end < n && end - at < 40 && !d(data[end]))
+        ++end;
+    throw std::runtime_error(what + ":" + std::to_string(line) + ": " + problem
+                             + " '" + std::string(data + at, end - at) + "'");
+}
+
+
+// tms_text_parse
+// Basic Guarantee
+// Exception-Neutral
+// Pre:
+//      out has room for tms_text_count(data, n, lo, hi, ...) values
+// Post:
+//      Each token starting in [lo, hi) parsed with std::from_chars (a
+//      leading '+' allowed) into out, in order; a token may run past
+//      hi. Throws std::runtime_error if a token is not entirely a
+//      number of type T, or is out of range.
+template <typename T>
+void tms_text_parse(const char * data, std::size_t n, std::size_t lo,
+                    std::size_t hi, const TMSTextDelims & d,
+                    TMSTextMaskFn mask, T * out, const std::string & what)
+{
+    const char * const end = data + n;
+    tms_text_blocks(data, n, lo, hi, d, mask,
+                    [&](std::size_t pos, std::uint64_t starts)
+    {
+        while (starts != 0)
+        {
+            const std::size_t at = pos + std::size_t(__builtin_ctzll(starts));
+            starts &= starts - 1;
+            const char * p = data + at;
+            // from_chars takes no '+'; skip one, unless a sign follows
+            if (*p == '+' && p + 1 < end && !d(p[1]) && p[1] != '-'
+                && p[1] != '+')
+                ++p;
+            const std::from_chars_result r = std::from_chars(p, end, *out);
+            if (r.ec == std::errc::result_out_of_range)
+                tms_text_error(data, n, at, d, what, "number out of range");
+            if (r.ec != std::errc() || (r.ptr != end && !d(*r.ptr)))
+                tms_text_error(data, n, at, d, what, "not a number");
+            ++out;
+        }
+    });
+}
+
+
+// tms_text_skip_lines
+// Offset just past the first lines newlines of [data, data + n), or n
+inline std::size_t tms_text_skip_lines(const char * data, std::size_t n,
+                                       std::size_t lines) noexcept
+{
+    std::size_t at = 0;
+    for (std::size_t k = 0; k < lines && at < n; ++k)
+    {
+        const void * nl = std::memchr(data + at, '\n', n - at);
+        at = nl == nullptr ? n : std::size_t(static_cast<const char *>(nl)
+                                             - data) + 1;
+    }
+    return at;
+}
+
+
+// tms_text_append
+// Shared by tms_parse_text and tms_load_text; what names the input in
+//  error messages
+template <typename T>
+void tms_text_append(const char * data, std::size_t n, TMSArray<T> & out,
+                     char sep, std::size_t skipLines, TMSThreadPool & pool,
+                     const std::string & what)
+{
+    static_assert(std::is_arithmetic<T>::value && !std::is_same<T, bool>::value,
+                  "text parsing is for arithmetic types other than bool");
+    const TMSTextDelims d(sep);
+    const TMSTextMaskFn mask = tms_text_mask_fn();
+    const std::size_t begin = tms_text_skip_lines(data, n, skipLines);
+    const std::size_t len = n - begin;
+    const std::size_t chunks = len >= TMS_TEXT_PARALLEL_BYTES ? pool.size() : 1;
+    auto each = [&](auto && f)
+    {
+        if (chunks == 1)
+            f(std::size_t(0));
+        else
+            pool.run([&](std::size_t tid, std::size_t) { f(tid); });
+    };
+
+    // Pass 1: tokens per chunk, so every value goes straight to its
+    //  final place in out
+    TMSArray<std::size_t> first(chunks + 1);
+    each([&](std::size_t tid)
+    {
+        const auto r = tms_chunk(len, tid, chunks);
+        first[tid + 1] = tms_text_count(data, n, begin + r.first,
+                                        begin + r.second, d, mask);
+    });
+    first[0] = out.size();
+    for (std::size_t k = 0; k < chunks; ++k)
+        first[k + 1] += first[k];
+
+    // Pass 2: parse
+    const std::size_t old = out.size();
+    out.resize(first[chunks]);
+    try
+    {
+        each([&](std::size_t tid)
+        {
+            const auto r = tms_chunk(len, tid, chunks);
+            tms_text_parse(data, n, begin + r.first, begin + r.second, d, mask,
+                           out.begin() + first[tid], what);
+        });
+    }
+    catch (...)
+    {
+        out.resize(old);
+        throw;
+    }
+}
+
+
+
+// *********************************************************************
+// Parsing and writing
+// *********************************************************************
+
+
+// tms_parse_text
+// Strong Guarantee (out's values; its capacity may grow)
+// Exception-Neutral
+// Pre:
+//      T arithmetic, not bool
+//      [data, data + n) readable
+// Post:
+//      The numbers in the text appended to out, after skipping the
+//      first skipLines lines. Tokens are separated by runs of spaces,
+//      tabs, CRs, LFs and sep. Above TMS_TEXT_PARALLEL_BYTES the text
+//      is split over pool: one counting pass sizes out exactly (no
+//      regrowth if out has the capacity), then each chunk parses into
+//      its own slice. Throws std::runtime_error, naming the line, for a
+//      token that is not a number of type T.
+template <typename T>
+void tms_parse_text(const char * data, std::size_t n, TMSArray<T> & out,
+                    char sep = ',', std::size_t skipLines = 0,
+                    TMSThreadPool & pool = tms_default_pool())
+{
+    tms_text_append(data, n, out, sep, skipLines, pool, "text");
+}
+
+
+// tms_load_text
+// Strong Guarantee (out's values; its capacity may grow)
+// Exception-Neutral
+// Pre:
+//      T arithmetic, not bool
+// Post:
+//      As tms_parse_text over the file at path, read through a
+//      read-only mapping. Throws std::system_error if it cannot be
+//      opened or mapped.
+template <typename T>
+void tms_load_text(const std::string & path, TMSArray<T> & out,
+                   char sep = ',', std::size_t skipLines = 0,
+                   TMSThreadPool & pool = tms_default_pool())
+{
+    std::size_t size;
+    {
+        TMSFd file(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+        if (file.fd < 0)
+            tms_throw_errno(path + ": open");
+        struct stat st;
+        if (::fstat(file.fd, &st) != 0)
+            tms_throw_errno(path + ": stat");
+        size = std::size_t(st.st_size);
+    }
+    if (size == 0)
+        return;
+    TMSArrayView<char> text = TMSArrayView<char>::map_range(path, 0, size);
+    text.advise(TMS_ADVISE_SEQUENTIAL);
+    tms_text_append(text.begin(), text.size(), out, sep, skipLines, pool, path);
+}
+
+
+// tms_text_format
+// Strong Guarantee
+// Exception-Neutral
+// Pre:
+//      first <= last; data[first, last) valid; columns > 0
+// Post:
+//      Those values appended to out with std::to_chars (shortest form
+//      that reads back exactly), each followed by '\n' if its index + 1
+//      is a multiple of columns, by sep otherwise
+template <typename T>
+void tms_text_format(const T * data, std::size_t first, std::size_t last,
+                     std::size_t columns, char sep, std::string & out)
+{
+    constexpr std::size_t most = 48;            // long double needs 40s
+    const std::size_t was = out.size();
+    out.resize(was + (last - first) * most);
+    char * p = &out[0] + was;
+    std::size_t col = first % columns;
+    for (std::size_t i = first; i < last; ++i)
+    {
+        p = std::to_chars(p, p + most - 1, data[i]).ptr;
+        if (++col == columns)
+        {
+            *p++ = '\n';
+            col = 0;
+        }
+        else
+            *p++ = sep;
+    }
+    out.resize(std::size_t(p - out.data()));
+}
+
+
+// tms_save_text
+// Basic Guarantee (the file may be partly written if a write fails)
+// Exception-Neutral
+// Pre:
+//      T arithmetic, not bool
+// Post:
+//      path holds arr as text, columns values per line separated by
+//      sep, every line (a short last one too) ending in '\n'. Formatting
+//      is split over pool in rounds of TMS_TEXT_WRITE_VALUES values
+//      per thread; each round is written in order. Throws
+//      std::invalid_argument if columns == 0, std::system_error if the
+//      file cannot be created or written.
+template <typename T>
+void tms_save_text(const TMSArray<T> & arr, const std::string & path,
+                   std::size_t columns = 1, char sep = ',',
+                   TMSThreadPool & pool = tms_default_pool())
+{
+    static_assert(std::is_arithmetic<T>::value && !std::is_same<T, bool>::value,
+                  "text writing is for arithmetic types other than bool");
+    if (columns == 0)
+        throw std::invalid_argument("tms_save_text: columns must be > 0");
+    TMSFd file(::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                      0644));
+    if (file.fd < 0)
+        tms_throw_errno(path + ": open");
+
+    const std::size_t n = arr.size();
+    const std::size_t threads = n >= 2 * TMS_TEXT_WRITE_VALUES ? pool.size() : 1;
+    const std::size_t round = threads * TMS_TEXT_WRITE_VALUES;
+    TMSArray<std::string> text(threads);
+    std::uint64_t offset = 0;
+    for (std::size_t lo = 0; lo < n; lo += round)
+    {
+        const std::size_t len = std::min(round, n - lo);
+        auto format = [&](std::size_t tid)
+        {
+            const auto r = tms_chunk(len, tid, threads);
+            text[tid].clear();
+            tms_text_format(arr.begin(), lo + r.first, lo + r.second, columns,
+                            sep, text[tid]);
+        };
+        if (threads == 1)
+            format(0);
+        else
+            pool.run([&](std::size_t tid, std::size_t) { format(tid); });
+        if (lo + len == n && n % columns != 0)
+            for (std::size_t t = threads; t-- > 0; )
+                if (!text[t].empty())
+                {
+                    text[t].back() = '\n';
+                    break;
+                }
+        for (std::string & s : text)
+        {
+            struct iovec iov;
+            iov.iov_base = &s[0];
+            iov.iov_len = s.size();
+            tms_pwritev_all(file.fd, &iov, 1, offset, path);
+            offset += s.size();
+        }
+    }
+}
+
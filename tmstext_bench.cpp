@@ -0,0 +1,135 @@
+// tmstext_bench.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Benchmark: parsing CSV text of doubles and of int64s into TMSArray
+//  with std::ifstream >> (the baseline), with tms_load_text on one
+//  thread at each delimiter-kernel ISA level, and on the default pool;
+//  the counting (delimiter scan) pass alone; writing with
+//  std::ofstream << against tms_save_text. Throughput is of text bytes.
+// Usage: tmstext_bench [values=8388608] [dir=/tmp]
+// Requires tmstext.hpp, tmsparallel.hpp, tmsserial.hpp, tmscrc32.hpp,
+//  tmssimd.hpp, tmsarray.hpp, tmsbench.hpp
+
+#include "tmstext.hpp"
+#include "tmsbench.hpp"
+
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::int64_t;
+using std::uint64_t;
+#include <cstdio>
+using std::remove;
+#include <fstream>
+using std::ofstream;
+using std::ifstream;
+#include <iostream>
+using std::cout;
+#include <limits>
+using std::numeric_limits;
+#include <string>
+using std::string;
+
+
+// bench
+// Baseline and tms_load_text parse of the CSV file at path (8 values
+//  per line), which holds arr
+template <typename T>
+void bench(const string & label, const TMSArray<T> & arr, const string & path)
+{
+    const size_t n = arr.size();
+    double secs = tms_time_best(1, [&]
+    {
+        ofstream out(path);
+        out.precision(numeric_limits<T>::max_digits10);
+        for (size_t i = 0; i < n; ++i)
+            out << arr[i] << ((i + 1) % 8 == 0 ? '\n' : ',');
+    });
+    const size_t streamBytes = size_t(ifstream(path, std::ios::ate).tellg());
+    tms_report(label + " write ofstream <<", secs, streamBytes);
+    secs = tms_time_best(3, [&]{ tms_save_text(arr, path, 8); });
+    const size_t bytes = size_t(ifstream(path, std::ios::ate).tellg());
+    tms_report(label + " write tms_save_text", secs, bytes);
+
+    TMSArray<T> back;
+    secs = tms_time_best(1, [&]
+    {
+        ifstream in(path);
+        TMSArray<T> vals;
+        T v;
+        while (in >> v)
+        {
+            vals.push_back(v);
+            in.ignore();                    // the ',' or '\n'
+        }
+        back.swap(vals);
+        tms_sink(back.size());
+    });
+    tms_report(label + " parse ifstream >>", secs, bytes);
+    if (back.size() != n)
+        cout << "    (ifstream read " << back.size() << " of " << n << ")\n";
+
+    TMSThreadPool one(1);
+    const TMSIsa best = tms_isa_limit();
+    for (int level = 0; level <= best; ++level)
+    {
+        if (level == TMS_ISA_AVX512)
+            continue;                       // same kernel as AVX2
+        tms_isa_limit() = TMSIsa(level);
+        secs = tms_time_best(3, [&]
+        {
+            back.resize(0);
+            tms_load_text(path, back, ',', 0, one);
+            tms_sink(back[n - 1]);
+        });
+        tms_report(label + " parse 1 thread, " + tms_isa_name(TMSIsa(level)),
+                   secs, bytes);
+    }
+    tms_isa_limit() = best;
+    secs = tms_time_best(3, [&]
+    {
+        back.resize(0);
+        tms_load_text(path, back);
+        tms_sink(back[n - 1]);
+    });
+    tms_report(label + " parse pool of "
+               + std::to_string(tms_default_pool().size()), secs, bytes);
+
+    TMSArrayView<char> text = TMSArrayView<char>::map_range(path, 0, bytes);
+    const TMSTextDelims d(',');
+    secs = tms_time_best(3, [&]
+    {
+        tms_sink(tms_text_count(text.begin(), bytes, 0, bytes, d,
+                                tms_text_mask_fn()));
+    });
+    tms_report(label + " delimiter scan only", secs, bytes);
+}
+
+
+int main(int argc, char * argv[])
+{
+    const size_t n = tms_arg(argc, argv, 1, size_t(1) << 23);
+    const string dir = argc > 2 ? argv[2] : "/tmp";
+    const string path = dir + "/tmstext_bench.csv";
+
+    TMSArray<double> doubles(n);
+    TMSArray<int64_t> ints(n);
+    uint64_t x = 88172645463325252ull;
+    for (size_t i = 0; i < n; ++i)
+    {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        doubles[i] = double(int64_t(x % 2000000001) - 1000000000) / 4096.0;
+        ints[i] = int64_t(x) >> (x % 48);
+    }
+    cout << n << " values, 8 per line, file in " << dir << "; best ISA "
+         << tms_isa_name(tms_isa_limit()) << "\n";
+
+    bench("double", doubles, path);
+    bench("int64 ", ints, path);
+
+    remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,398 @@
+// tmstext_test.cpp
+// Matthew Johnson
+// 10/17/2026
+//
+// Test program for tms_parse_text, tms_load_text, tms_save_text and the
+//  delimiter-mask kernels
+// Uses the "doctest" unit-testing framework, version 2
+// Requires doctest.h, tmstext.hpp, tmsparallel.hpp, tmsserial.hpp,
+//  tmscrc32.hpp, tmssimd.hpp, tmsarray.hpp
+
+// Includes for code to be tested
+#include "tmstext.hpp"       // For tms_parse_text, tms_save_text
+#include "tmstext.hpp"       // Double-inclusion check, for testing only
+
+// Includes for the "doctest" unit-testing framework
+#define DOCTEST_CONFIG_IMPLEMENT
+                             // We write our own main
+#define DOCTEST_CONFIG_SUPER_FAST_ASSERTS
+                             // Reduce compile time
+#include "doctest.h"         // For doctest
+
+// Includes for all test programs
+#include <iostream>
+using std::cout;
+using std::endl;
+using std::cin;
+#include <string>
+using std::string;
+
+// Additional includes for this test program
+#include <cstddef>
+using std::size_t;
+#include <cstdint>
+using std::int32_t;
+using std::int64_t;
+using std::uint8_t;
+using std::uint64_t;
+#include <cstdio>
+using std::remove;
+#include <cstring>
+using std::memcpy;
+#include <algorithm>
+using std::equal;
+#include <limits>
+using std::numeric_limits;
+#include <stdexcept>
+using std::runtime_error;
+using std::invalid_argument;
+#include <system_error>
+using std::system_error;
+#include <unistd.h>          // For getpid
+
+// Printable name for this test suite
+const string test_suite_name =
+    "tms_parse_text, tms_load_text and tms_save_text";
+
+
+// *********************************************************************
+// Helper Functions for This Test Program
+// *********************************************************************
+
+
+// tempPath
+// A per-process scratch file name under /tmp
+string tempPath(const string & tag)
+{
+    return "/tmp/tmstext_test_" + std::to_string(getpid()) + "_" + tag;
+}
+
+
+// readFile
+// Whole contents of path
+string readFile(const string & path)
+{
+    TMSFd file(::open(path.c_str(), O_RDONLY));
+    REQUIRE( file.fd >= 0 );
+    struct stat st;
+    REQUIRE( ::fstat(file.fd, &st) == 0 );
+    string bytes(size_t(st.st_size), '\0');
+    REQUIRE( ::pread(file.fd, &bytes[0], bytes.size(), 0)
+             == ssize_t(bytes.size()) );
+    return bytes;
+}
+
+
+// parse
+// tms_parse_text of s into a fresh array
+template <typename T>
+TMSArray<T> parse(const string & s, char sep = ',', size_t skipLines = 0)
+{
+    TMSArray<T> out;
+    tms_parse_text(s.data(), s.size(), out, sep, skipLines);
+    return out;
+}
+
+
+// xorshift
+// Next pseudo-random value
+uint64_t xorshift(uint64_t & x)
+{
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return x;
+}
+
+
+// *********************************************************************
+// Test Cases
+// *********************************************************************
+
+
+TEST_CASE( "Delimiter masks agree at every ISA level" )
+{
+    const TMSTextDelims d(';');
+    const char alphabet[] = "0123456789.-e ;,\t\r\nx";
+    uint64_t x = 12345;
+    char block[64];
+    const TMSIsa best = tms_isa_limit();
+    for (int rep = 0; rep < 200; ++rep)
+    {
+        for (char & c : block)
+            c = alphabet[xorshift(x) % (sizeof alphabet - 1)];
+        const uint64_t want = tms_text_mask_scalar(block, d);
+        for (int level = 0; level <= best; ++level)
+        {
+            tms_isa_limit() = TMSIsa(level);
+            INFO( "ISA: " << tms_isa_name(TMSIsa(level)) );
+            REQUIRE( tms_text_mask_fn()(block, d) == want );
+        }
+    }
+    tms_isa_limit() = best;
+    REQUIRE( d(' ') );
+    REQUIRE( d(';') );
+    REQUIRE( !d(',') );
+}
+
+
+TEST_CASE( "Parsing doubles" )
+{
+    SUBCASE( "CSV" )
+    {
+        TMSArray<double> v = parse<double>("1.5,2,-3e2\n4.25,.5,6.\n");
+        REQUIRE( v.size() == 6 );
+        REQUIRE( v[0] == 1.5 );
+        REQUIRE( v[2] == -300.0 );
+        REQUIRE( v[4] == 0.5 );
+        REQUIRE( v[5] == 6.0 );
+    }
+    SUBCASE( "Whitespace, CRLF, runs and no final newline" )
+    {
+        TMSArray<double> v = parse<double>("  1\t 2\r\n\r\n3   +4\n\n 5e-1");
+        REQUIRE( v.size() == 5 );
+        REQUIRE( v[3] == 4.0 );
+        REQUIRE( v[4] == 0.5 );
+    }
+    SUBCASE( "Exact round trip of the shortest form" )
+    {
+        REQUIRE( parse<double>("0.1")[0] == 0.1 );
+        REQUIRE( parse<double>("2.2250738585072014e-308")[0]
+                 == numeric_limits<double>::min() );
+        REQUIRE( parse<double>("1.7976931348623157e308")[0]
+                 == numeric_limits<double>::max() );
+        REQUIRE( parse<float>("3.4028235e38")[0]
+                 == numeric_limits<float>::max() );
+    }
+    SUBCASE( "Empty and delimiter-only input" )
+    {
+        REQUIRE( parse<double>("").size() == 0 );
+        REQUIRE( parse<double>(" ,\n\n,, \t").size() == 0 );
+    }
+    SUBCASE( "Other separators" )
+    {
+        TMSArray<double> v = parse<double>("1;2;3\n4;5;6\n", ';');
+        REQUIRE( v.size() == 6 );
+        REQUIRE_THROWS_AS( parse<double>("1,2\n", ';'), runtime_error );
+    }
+}
+
+
+TEST_CASE( "Parsing integers" )
+{
+    TMSArray<int64_t> v = parse<int64_t>(
+        "9223372036854775807,-9223372036854775808,0,+17,-0\n");
+    REQUIRE( v.size() == 5 );
+    REQUIRE( v[0] == numeric_limits<int64_t>::max() );
+    REQUIRE( v[1] == numeric_limits<int64_t>::min() );
+    REQUIRE( v[3] == 17 );
+    REQUIRE( parse<uint8_t>("255 0 7")[0] == 255 );
+    REQUIRE( parse<int32_t>("-2147483648")[0] == numeric_limits<int32_t>::min() );
+}
+
+
+TEST_CASE( "Header lines" )
+{
+    TMSArray<int32_t> v = parse<int32_t>("a,b,c\nx y z\n1,2,3\n", ',', 2);
+    REQUIRE( v.size() == 3 );
+    REQUIRE( v[2] == 3 );
+    REQUIRE( parse<int32_t>("a,b\n", ',', 5).size() == 0 );
+    REQUIRE( parse<int32_t>("a,b", ',', 1).size() == 0 );
+}
+
+
+TEST_CASE( "Bad input" )
+{
+    auto message = [](const string & s)
+    {
+        try
+        {
+            parse<int64_t>(s);
+        }
+        catch (const runtime_error & e)
+        {
+            return string(e.what());
+        }
+        return string("no error");
+    };
+    REQUIRE( message("1,2\n3,4x,5\n") == "text:2: not a number '4x'" );
+    REQUIRE( message("1.5") == "text:1: not a number '1.5'" );
+    REQUIRE( message("\n\n\nabc") == "text:4: not a number 'abc'" );
+    REQUIRE( message("+") == "text:1: not a number '+'" );
+    REQUIRE( message("++1") == "text:1: not a number '++1'" );
+    REQUIRE( message("1 +-5 +7") == "text:1: not a number '+-5'" );
+    REQUIRE_THROWS_AS( parse<double>("+-5"), runtime_error );
+    REQUIRE( message("1 99999999999999999999")
+             == "text:1: number out of range '99999999999999999999'" );
+    REQUIRE_THROWS_AS( parse<uint8_t>("256"), runtime_error );
+    REQUIRE_THROWS_AS( parse<double>("1e999"), runtime_error );
+    REQUIRE_THROWS_AS( parse<double>("1.0.0"), runtime_error );
+
+    // Strong guarantee: earlier contents survive a failed append
+    TMSArray<int64_t> out;
+    out.push_back(42);
+    const string bad = "1 2 3 x";
+    REQUIRE_THROWS_AS( tms_parse_text(bad.data(), bad.size(), out),
+                       runtime_error );
+    REQUIRE( out.size() == 1 );
+    REQUIRE( out[0] == 42 );
+}
+
+
+TEST_CASE( "Appending into a preallocated array" )
+{
+    TMSArray<double> out(static_cast<size_t>(1000));
+    out.resize(1);                          // keeps the capacity
+    out[0] = -1.0;
+    const double * before = out.begin();
+    const string s = "1 2 3";
+    tms_parse_text(s.data(), s.size(), out);
+    tms_parse_text(s.data(), s.size(), out);
+    REQUIRE( out.size() == 7 );
+    REQUIRE( out[0] == -1.0 );
+    REQUIRE( out[6] == 3.0 );
+    REQUIRE( out.begin() == before );
+}
+
+
+TEST_CASE( "Parallel chunks match a serial parse" )
+{
+    // Irregular tokens and delimiter runs, so chunk boundaries fall
+    //  inside tokens and inside runs
+    string text;
+    uint64_t x = 99;
+    TMSArray<int64_t> want;
+    while (text.size() < 3 * TMS_TEXT_PARALLEL_BYTES)
+    {
+        const int64_t v = int64_t(xorshift(x) >> (xorshift(x) % 64));
+        want.push_back(v % 2 == 0 ? v : -v);
+        text += std::to_string(want[want.size() - 1]);
+        const char * seps[] = { ",", " ", "\n", ",  ", "\r\n", "\t\t\t" };
+        text += seps[xorshift(x) % 6];
+    }
+    for (size_t threads : { 1, 2, 3, 7 })
+    {
+        TMSThreadPool pool(threads);
+        TMSArray<int64_t> got;
+        tms_parse_text(text.data(), text.size(), got, ',', 0, pool);
+        INFO( "threads: " << threads );
+        REQUIRE( got.size() == want.size() );
+        REQUIRE( equal(got.begin(), got.end(), want.begin()) );
+    }
+
+    // Error in a later chunk: reported with its line, nothing appended
+    text[text.size() - 200] = 'Q';
+    TMSThreadPool pool(4);
+    TMSArray<int64_t> got;
+    REQUIRE_THROWS_AS( tms_parse_text(text.data(), text.size(), got, ',', 0,
+                                      pool), runtime_error );
+    REQUIRE( got.size() == 0 );
+}
+
+
+TEST_CASE( "Writing and reading files" )
+{
+    const string path = tempPath("rw");
+
+    SUBCASE( "Doubles round trip exactly" )
+    {
+        TMSArray<double> a(static_cast<size_t>(100000));
+        uint64_t x = 5;
+        for (double & v : a)
+        {
+            uint64_t bits = xorshift(x);
+            memcpy(&v, &bits, 8);
+            if (v != v || v - v != 0)       // no NaN or infinity
+                v = double(bits >> 12);
+        }
+        tms_save_text(a, path);
+        TMSArray<double> b;
+        tms_load_text(path, b);
+        REQUIRE( b.size() == a.size() );
+        REQUIRE( equal(b.begin(), b.end(), a.begin()) );
+    }
+    SUBCASE( "Layout" )
+    {
+        TMSArray<int32_t> a(static_cast<size_t>(7));
+        for (size_t i = 0; i < 7; ++i)
+            a[i] = int32_t(i) - 3;
+        tms_save_text(a, path, 3);
+        REQUIRE( readFile(path) == "-3,-2,-1\n0,1,2\n3\n" );
+        tms_save_text(a, path, 7, ' ');
+        REQUIRE( readFile(path) == "-3 -2 -1 0 1 2 3\n" );
+        tms_save_text(a, path);
+        REQUIRE( readFile(path) == "-3\n-2\n-1\n0\n1\n2\n3\n" );
+        tms_save_text(TMSArray<int32_t>(), path);
+        REQUIRE( readFile(path).empty() );
+        REQUIRE_THROWS_AS( tms_save_text(a, path, 0), invalid_argument );
+    }
+    SUBCASE( "Parallel writer output is identical" )
+    {
+        TMSArray<float> a(3 * TMS_TEXT_WRITE_VALUES + 11);
+        uint64_t x = 8;
+        for (float & v : a)
+            v = float(int64_t(xorshift(x) % 2000001) - 1000000) / 64.0f;
+        TMSThreadPool one(1), four(4);
+        tms_save_text(a, path, 5, ',', one);
+        const string serial = readFile(path);
+        tms_save_text(a, path, 5, ',', four);
+        REQUIRE( readFile(path) == serial );
+        TMSArray<float> b;
+        tms_load_text(path, b, ',', 0, four);
+        REQUIRE( equal(b.begin(), b.end(), a.begin()) );
+    }
+    SUBCASE( "Files" )
+    {
+        TMSArray<int64_t> out;
+        REQUIRE_THROWS_AS( tms_load_text(path + "_none", out), system_error );
+        tms_save_text(TMSArray<int64_t>(), path);
+        tms_load_text(path, out);
+        REQUIRE( out.size() == 0 );
+    }
+    remove(path.c_str());
+}
+
+
+// *********************************************************************
+// Main Program
+// *********************************************************************
+
+
+// userPause
+// Wait for user to press ENTER: read all chars through first newline.
+void userPause()
+{
+    std::cout.flush();
+    while (std::cin.get() != '\n') ;
+}
+
+
+// Main program
+// Run all tests. Prompt for ENTER before exiting.
+int main(int argc,
+         char *argv[])
+{
+    doctest::Context dtcontext;
+                             // Primary doctest object
+    int dtresult;            // doctest return code; for return by main
+
+    // Handle command line
+    dtcontext.applyCommandLine(argc, argv);
+    dtresult = 0;            // doctest flags no command-line errors
+                             //  (strange but true)
+
+    if (!dtresult)           // Continue only if no command-line error
+    {
+        // Run test suites
+        cout << "BEGIN tests for " << test_suite_name << "\n" << endl;
+        dtresult = dtcontext.run();
+        cout << "END tests for " << test_suite_name << "\n" << endl;
+    }
+
+    // Wait for user
+    std::cout << "Press ENTER to quit ";
+    userPause();
+
+    // Program return value is return code from doctest
+    return dtresult;
+}